@@ -27,17 +27,30 @@ extern "C" {
 #endif
 
 
-#ifdef __STDC_VERSION__
-	#if __STDC_VERSION__ < 199901L
-		#error "Compiler doesn't seem C99-compliant."
+/* C++ compilers do not define __STDC_VERSION__; see Zitatespucker.hpp for what they need */
+#ifndef __cplusplus
+	#ifdef __STDC_VERSION__
+		#if __STDC_VERSION__ < 199901L
+			#error "Compiler doesn't seem C99-compliant."
+		#endif
+	#else
+		#error "Cannot determine C standard compliance."
 	#endif
-#else
-	#error "Cannot determine C standard compliance."
 #endif
 
 
 /* Required headers */
 #include "Zitatespucker_common.h"
+#include "Zitatespucker_source.h"
+#include "Zitatespucker_snapshot.h"
+#include "Zitatespucker_compact.h"
+#include "Zitatespucker_export.h"
+#include "Zitatespucker_count.h"
+#include "Zitatespucker_authors.h"
+#include "Zitatespucker_rotation.h"
+#include "Zitatespucker_embed.h"
+#include "Zitatespucker_diag.h"
+#include "Zitatespucker_neardup.h"
 
 
 /* json related things to read from .json files */
@@ -50,6 +63,31 @@ extern "C" {
     #include "Zitatespucker_sqlite.h"
 #endif
 
+/* Newline-delimited JSON (JSON Lines) backend */
+#ifdef ZITATESPUCKER_NDJSON
+	#include "Zitatespucker_ndjson.h"
+#endif
+
+/* CSV and TSV backend */
+#ifdef ZITATESPUCKER_CSV
+	#include "Zitatespucker_csv.h"
+#endif
+
+/* Process-wide cache of parsed sources */
+#ifdef ZITATESPUCKER_CACHE
+	#include "Zitatespucker_cache.h"
+#endif
+
+/* Loading sources in the background */
+#ifdef ZITATESPUCKER_ASYNC
+	#include "Zitatespucker_async.h"
+#endif
+
+/* Client for the zitatespuckerd quote server */
+#ifdef ZITATESPUCKER_CLIENT
+	#include "Zitatespucker_client.h"
+#endif
+
 
 #ifdef __cplusplus
 }
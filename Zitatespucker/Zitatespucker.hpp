@@ -0,0 +1,382 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	C++ interface (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_HPP
+#define ZITATESPUCKER_HPP
+
+
+#if __cplusplus < 201703L
+	#error "Zitatespucker.hpp needs C++17."
+#endif
+
+
+/* Standard headers */
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+/* Internal headers */
+#include "Zitatespucker.h"
+
+
+/*
+	Thin C++17 wrappers around the C interface, header only.
+
+	Nothing here copies a quote or adds a layer the compiler cannot see through:
+	the owning types hold a single pointer and free it on destruction (and can only be moved),
+	the views hold a single pointer to an element owned by something else,
+	and the filters are templates, so the predicates are inlined into the loops walking the list.
+	The C functions stay available for everything not wrapped here; get() hands out the pointer they take.
+
+	Errors are reported the way the C functions report them: a returned List or handle that is empty
+	(i.e. converts to false) is what the C function returning NULL would have been. No exceptions are thrown.
+*/
+namespace Zitatespucker {
+
+
+/*
+	A read-only view of a single ZitatespuckerZitat, valid as long as whatever owns the element.
+	The strings are views of the element's own text; missing ones (NULL in C) are empty.
+*/
+class Zitat {
+public:
+	explicit Zitat(const ZitatespuckerZitat *element) noexcept : z(element) {}
+
+	std::string_view author() const noexcept { return View(z->author, ZitatespuckerZitatGetAuthorLen(z)); }
+	std::string_view zitat() const noexcept { return View(z->zitat, ZitatespuckerZitatGetZitatLen(z)); }
+	std::string_view comment() const noexcept { return View(z->comment, ZitatespuckerZitatGetCommentLen(z)); }
+
+	/* Tell missing text apart from empty text */
+	bool hasAuthor() const noexcept { return z->author != nullptr; }
+	bool hasZitat() const noexcept { return z->zitat != nullptr; }
+	bool hasComment() const noexcept { return z->comment != nullptr; }
+
+	uint8_t day() const noexcept { return z->day; }
+	uint8_t month() const noexcept { return z->month; }
+	uint16_t year() const noexcept { return z->year; }
+	bool annodomini() const noexcept { return z->annodomini; }
+
+	/* See ZitatespuckerZitatHash() */
+	uint64_t hash() const noexcept { return ZitatespuckerZitatHash(z); }
+
+	const ZitatespuckerZitat *get() const noexcept { return z; }
+
+private:
+	static std::string_view View(const char *str, size_t len) noexcept { return (str != nullptr ? std::string_view(str, len) : std::string_view()); }
+
+	const ZitatespuckerZitat *z;
+};
+
+
+/*
+	Walks a list along nextZitat, handing out a Zitat for each element.
+*/
+class ZitatIterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = Zitat;
+	using difference_type = std::ptrdiff_t;
+	using pointer = void;
+	using reference = Zitat;
+
+	ZitatIterator() noexcept : z(nullptr) {}
+	explicit ZitatIterator(const ZitatespuckerZitat *element) noexcept : z(element) {}
+
+	Zitat operator*() const noexcept { return Zitat(z); }
+	ZitatIterator &operator++() noexcept { z = z->nextZitat; return *this; }
+	ZitatIterator operator++(int) noexcept { ZitatIterator tmp = *this; z = z->nextZitat; return tmp; }
+
+	bool operator==(const ZitatIterator &other) const noexcept { return z == other.z; }
+	bool operator!=(const ZitatIterator &other) const noexcept { return z != other.z; }
+
+private:
+	const ZitatespuckerZitat *z;
+};
+
+
+/*
+	Owns a ZitatespuckerZitat list (as returned by the backends) and frees it with ZitatespuckerZitatFree().
+	Can be moved, but not copied.
+*/
+class List {
+public:
+	List() noexcept : head(nullptr) {}
+
+	/* Take over the whole list ZitatList is part of */
+	explicit List(ZitatespuckerZitat *ZitatList) noexcept : head(First(ZitatList)) {}
+
+	List(const List &) = delete;
+	List &operator=(const List &) = delete;
+
+	List(List &&other) noexcept : head(std::exchange(other.head, nullptr)) {}
+	List &operator=(List &&other) noexcept
+	{
+		if (this != &other)
+			reset(other.release());
+		return *this;
+	}
+
+	~List() { ZitatespuckerZitatFree(head); }
+
+	/* See ZitatespuckerSourceGetZitatAllFromFileFields() */
+	static List fromFile(const char *filename, ZitatespuckerSource source = ZITATESPUCKER_SOURCE_UNKNOWN, ZitatespuckerFields fields = ZITATESPUCKER_FIELD_ALL) noexcept
+	{
+		return List(ZitatespuckerSourceGetZitatAllFromFileFields(filename, source, fields));
+	}
+
+	/* See ZitatespuckerSourceGetZitatAllFromFileByAuthorFields() */
+	static List byAuthor(const char *filename, const char *authorname, ZitatespuckerSource source = ZITATESPUCKER_SOURCE_UNKNOWN, ZitatespuckerFields fields = ZITATESPUCKER_FIELD_ALL) noexcept
+	{
+		return List(ZitatespuckerSourceGetZitatAllFromFileByAuthorFields(filename, source, authorname, fields));
+	}
+
+	/* See ZitatespuckerSourceGetZitatAllFromFileByDateFields() */
+	static List byDate(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerSource source = ZITATESPUCKER_SOURCE_UNKNOWN, ZitatespuckerFields fields = ZITATESPUCKER_FIELD_ALL) noexcept
+	{
+		return List(ZitatespuckerSourceGetZitatAllFromFileByDateFields(filename, source, annodomini, year, month, day, fields));
+	}
+
+	ZitatIterator begin() const noexcept { return ZitatIterator(head); }
+	ZitatIterator end() const noexcept { return ZitatIterator(); }
+
+	bool empty() const noexcept { return head == nullptr; }
+	explicit operator bool() const noexcept { return head != nullptr; }
+
+	/* Walks the whole list, see ZitatespuckerZitatListLen() */
+	size_t size() const noexcept { return ZitatespuckerZitatListLen(head); }
+
+	Zitat front() const noexcept { return Zitat(head); }
+
+	/* The first element, for the C functions; still owned by the list */
+	ZitatespuckerZitat *get() const noexcept { return head; }
+
+	/* Give up ownership; the caller has to free the returned list */
+	ZitatespuckerZitat *release() noexcept { return std::exchange(head, nullptr); }
+
+	void reset(ZitatespuckerZitat *ZitatList = nullptr) noexcept
+	{
+		ZitatespuckerZitatFree(std::exchange(head, First(ZitatList)));
+	}
+
+	/*
+		Free every element for which pred (called with a Zitat) returns true, keeping the order of the others.
+		Returns the number of elements removed.
+	*/
+	template <typename Predicate>
+	size_t removeIf(Predicate pred)
+	{
+		size_t removed = 0;
+		ZitatespuckerZitat *tmp = head;
+		while (tmp != nullptr) {
+			ZitatespuckerZitat *next = tmp->nextZitat;
+			if (pred(Zitat(tmp))) {
+				if (tmp->prevZitat != nullptr)
+					tmp->prevZitat->nextZitat = next;
+				else
+					head = next;
+				if (next != nullptr)
+					next->prevZitat = tmp->prevZitat;
+				tmp->nextZitat = nullptr;
+				tmp->prevZitat = nullptr;
+				ZitatespuckerZitatFree(tmp);
+				removed++;
+			}
+			tmp = next;
+		}
+
+		return removed;
+	}
+
+	/* The opposite of removeIf(): keep only the elements for which pred returns true */
+	template <typename Predicate>
+	size_t keepIf(Predicate pred)
+	{
+		return removeIf([&pred](Zitat element) { return !pred(element); });
+	}
+
+	/* Returns the number of elements for which pred returns true */
+	template <typename Predicate>
+	size_t countIf(Predicate pred) const
+	{
+		size_t count = 0;
+		for (const ZitatespuckerZitat *tmp = head; tmp != nullptr; tmp = tmp->nextZitat)
+			count += (pred(Zitat(tmp)) ? 1 : 0);
+
+		return count;
+	}
+
+	/*
+		Sort the list with compare, called with two Zitat like ZitatespuckerZitatCompare
+		(less than, equal to or greater than 0 if a is to go before, next to or after b).
+		The sort is stable, see ZitatespuckerZitatSort().
+	*/
+	template <typename Compare>
+	void sort(Compare compare)
+	{
+		head = ZitatespuckerZitatSort(head, &List::Trampoline<Compare>, static_cast<void *>(&compare));
+	}
+
+	/* See ZitatespuckerZitatSortByDate() and ZitatespuckerZitatSortByAuthor() */
+	void sortByDate() noexcept { head = ZitatespuckerZitatSortByDate(head); }
+	void sortByAuthor() noexcept { head = ZitatespuckerZitatSortByAuthor(head); }
+
+	/* See ZitatespuckerZitatDedup(); returns the number of duplicates removed */
+	size_t dedup(ZitatespuckerDuplicates keep) noexcept
+	{
+		size_t duplicates = 0;
+		ZitatespuckerZitat *tmp;
+		if ((tmp = ZitatespuckerZitatDedup(head, keep, nullptr, nullptr, &duplicates)) != nullptr)
+			head = tmp;
+		return duplicates;
+	}
+
+private:
+	static ZitatespuckerZitat *First(ZitatespuckerZitat *ZitatList) noexcept
+	{
+		while (ZitatList != nullptr && ZitatList->prevZitat != nullptr)
+			ZitatList = ZitatList->prevZitat;
+		return ZitatList;
+	}
+
+	template <typename Compare>
+	static int Trampoline(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b, void *userdata)
+	{
+		return (*static_cast<Compare *>(userdata))(Zitat(a), Zitat(b));
+	}
+
+	ZitatespuckerZitat *head;
+};
+
+
+/*
+	Owns an object of the C interface that is freed (or closed) with Free.
+	Can be moved, but not copied; holds nothing but the pointer.
+*/
+template <typename T, void (*Free)(T *)>
+class Handle {
+public:
+	Handle() noexcept : ptr(nullptr) {}
+	explicit Handle(T *ptr) noexcept : ptr(ptr) {}
+
+	Handle(const Handle &) = delete;
+	Handle &operator=(const Handle &) = delete;
+
+	Handle(Handle &&other) noexcept : ptr(std::exchange(other.ptr, nullptr)) {}
+	Handle &operator=(Handle &&other) noexcept
+	{
+		if (this != &other)
+			reset(other.release());
+		return *this;
+	}
+
+	~Handle() { if (ptr != nullptr) Free(ptr); }
+
+	explicit operator bool() const noexcept { return ptr != nullptr; }
+	T *get() const noexcept { return ptr; }
+	T *release() noexcept { return std::exchange(ptr, nullptr); }
+
+	void reset(T *newPtr = nullptr) noexcept
+	{
+		T *old = std::exchange(ptr, newPtr);
+		if (old != nullptr)
+			Free(old);
+	}
+
+private:
+	T *ptr;
+};
+
+using Compact = Handle<ZitatespuckerCompact, ZitatespuckerCompactFree>;
+using Counts = Handle<ZitatespuckerCounts, ZitatespuckerCountsFree>;
+using AuthorIndex = Handle<ZitatespuckerAuthorIndex, ZitatespuckerAuthorIndexFree>;
+using Rotation = Handle<ZitatespuckerRotation, ZitatespuckerRotationClose>;
+#ifdef ZITATESPUCKER_SQL
+using SQLPool = Handle<ZitatespuckerSQLPool, ZitatespuckerSQLPoolClose>;
+#endif
+
+
+/*
+	Holds a reference to a ZitatespuckerSnapshot. Snapshots are reference counted,
+	so unlike the other handles this one can be copied (which takes another reference).
+*/
+class Snapshot {
+public:
+	Snapshot() noexcept : snapshot(nullptr) {}
+
+	/* Take over a reference the caller holds */
+	explicit Snapshot(ZitatespuckerSnapshot *snapshot) noexcept : snapshot(snapshot) {}
+
+	Snapshot(const Snapshot &other) noexcept : snapshot(ZitatespuckerSnapshotRetain(other.snapshot)) {}
+	Snapshot &operator=(const Snapshot &other) noexcept
+	{
+		if (this != &other)
+			ZitatespuckerSnapshotRelease(std::exchange(snapshot, ZitatespuckerSnapshotRetain(other.snapshot)));
+		return *this;
+	}
+
+	Snapshot(Snapshot &&other) noexcept : snapshot(std::exchange(other.snapshot, nullptr)) {}
+	Snapshot &operator=(Snapshot &&other) noexcept
+	{
+		if (this != &other)
+			ZitatespuckerSnapshotRelease(std::exchange(snapshot, std::exchange(other.snapshot, nullptr)));
+		return *this;
+	}
+
+	~Snapshot() { ZitatespuckerSnapshotRelease(snapshot); }
+
+	/* See ZitatespuckerSnapshotFromFile() and ZitatespuckerSnapshotFromList() */
+	static Snapshot fromFile(const char *filename, ZitatespuckerSource source = ZITATESPUCKER_SOURCE_UNKNOWN) noexcept
+	{
+		return Snapshot(ZitatespuckerSnapshotFromFile(filename, source));
+	}
+	static Snapshot fromList(const List &list) noexcept
+	{
+		return Snapshot(ZitatespuckerSnapshotFromList(list.get()));
+	}
+
+	explicit operator bool() const noexcept { return snapshot != nullptr; }
+	size_t size() const noexcept { return ZitatespuckerSnapshotLen(snapshot); }
+
+	/* idx has to be less than size() */
+	Zitat operator[](size_t idx) const noexcept { return Zitat(ZitatespuckerSnapshotGet(snapshot, idx)); }
+
+	ZitatespuckerSnapshot *get() const noexcept { return snapshot; }
+
+private:
+	ZitatespuckerSnapshot *snapshot;
+};
+
+
+/* None of the wrappers may cost more than the pointer they wrap */
+static_assert(sizeof(Zitat) == sizeof(const ZitatespuckerZitat *) && std::is_trivially_copyable_v<Zitat>);
+static_assert(sizeof(ZitatIterator) == sizeof(const ZitatespuckerZitat *) && std::is_trivially_copyable_v<ZitatIterator>);
+static_assert(sizeof(List) == sizeof(ZitatespuckerZitat *) && std::is_nothrow_move_constructible_v<List>);
+static_assert(sizeof(Compact) == sizeof(ZitatespuckerCompact *) && !std::is_copy_constructible_v<Compact>);
+static_assert(sizeof(Snapshot) == sizeof(ZitatespuckerSnapshot *));
+
+
+}
+
+
+#endif
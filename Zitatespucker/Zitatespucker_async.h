@@ -0,0 +1,102 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Loading sources in the background (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_ASYNC_H
+#define ZITATESPUCKER_ASYNC_H
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_source.h"
+#include "Zitatespucker_snapshot.h"
+
+
+/* Where a background load is at, as returned by ZitatespuckerAsyncPoll() and ZitatespuckerAsyncWait() */
+typedef enum ZitatespuckerAsyncState {
+	ZITATESPUCKER_ASYNC_RUNNING = 0, /* Still loading */
+	ZITATESPUCKER_ASYNC_DONE, /* Loaded; the result can be taken */
+	ZITATESPUCKER_ASYNC_FAILED /* Loading failed (or the handle was NULL) */
+} ZitatespuckerAsyncState;
+
+/*
+	A load running on a thread of its own.
+	See ZitatespuckerAsyncLoad().
+*/
+typedef struct ZitatespuckerAsync ZitatespuckerAsync;
+
+
+/* Externally callable */
+
+/*
+	Start loading all elements within filename on a new thread, like ZitatespuckerSourceGetZitatAllFromFileFields() would
+	(ZITATESPUCKER_FIELD_ALL for everything). filename is copied, so it does not have to stay around.
+	NULL on error (including the thread not being started).
+
+	The returned handle must be finished with ZitatespuckerAsyncTakeList() or ZitatespuckerAsyncCancel().
+*/
+ZitatespuckerAsync *ZitatespuckerAsyncLoad(const char *filename, ZitatespuckerSource source, ZitatespuckerFields fields);
+
+/*
+	Same as ZitatespuckerAsyncLoad(), but the thread goes on to turn the list into a snapshot, like ZitatespuckerSnapshotFromFile().
+
+	The returned handle must be finished with ZitatespuckerAsyncTakeSnapshot() or ZitatespuckerAsyncCancel().
+*/
+ZitatespuckerAsync *ZitatespuckerAsyncLoadSnapshot(const char *filename, ZitatespuckerSource source);
+
+/*
+	Returns the state of handle without blocking.
+*/
+ZitatespuckerAsyncState ZitatespuckerAsyncPoll(ZitatespuckerAsync *handle);
+
+/*
+	Block until handle is done loading or timeoutMs milliseconds have passed (negative to wait for as long as it takes),
+	then return its state.
+*/
+ZitatespuckerAsyncState ZitatespuckerAsyncWait(ZitatespuckerAsync *handle, long timeoutMs);
+
+/*
+	Wait for handle to be done, free it and hand over the list it loaded.
+	The list is the very one the backend built, nothing is copied.
+	NULL if loading failed or handle was started by ZitatespuckerAsyncLoadSnapshot().
+	The warnings counted by the thread are added to those of the calling thread (see Zitatespucker_diag.h),
+	and if loading failed, so is the error it failed with.
+
+	The returned list must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerAsyncTakeList(ZitatespuckerAsync *handle);
+
+/*
+	Wait for handle to be done, free it and hand over the snapshot it created.
+	NULL if loading failed or handle was started by ZitatespuckerAsyncLoad().
+
+	The returned snapshot holds the only reference and must be released with ZitatespuckerSnapshotRelease().
+*/
+ZitatespuckerSnapshot *ZitatespuckerAsyncTakeSnapshot(ZitatespuckerAsync *handle);
+
+/*
+	Give up on handle without waiting; handle must not be used afterwards.
+	A load that has not started yet is skipped. One that is already parsing runs to its end on its thread,
+	which then frees whatever it loaded.
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerAsyncCancel(ZitatespuckerAsync *handle);
+
+
+#endif
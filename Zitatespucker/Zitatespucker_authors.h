@@ -0,0 +1,121 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Prefix and fuzzy author lookup (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_AUTHORS_H
+#define ZITATESPUCKER_AUTHORS_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_source.h"
+
+
+/* Upper limit for the maxDistance of ZitatespuckerAuthorIndexFuzzy() */
+#define ZITATESPUCKER_AUTHORS_MAX_DISTANCE	8
+
+
+/*
+	An index of the distinct authors of a source, for finding them by what a user typed so far.
+
+	Every word of a name can be looked up, not just the first one: "goe" finds "Johann Wolfgang von Goethe".
+	Words start at the beginning of the name and after every ASCII space or punctuation character.
+	Names are compared case-folded (ASCII only; other bytes are compared as they are), and distances are counted in bytes.
+
+	The index keeps every word start of every name in one sorted array, so a prefix is a range within it,
+	found by binary search. Fuzzy queries walk that array like a trie, sharing the rows of the edit distance table
+	between names with a common beginning and skipping every name below a beginning that is too far off already.
+
+	Indexes of SQLite databases are built by the first query (or ZitatespuckerAuthorIndexBuild()), all others right away.
+	Any number of threads may query an index at the same time: building it lazily is done under a lock,
+	and once built, nothing within it changes.
+*/
+typedef struct ZitatespuckerAuthorIndex ZitatespuckerAuthorIndex;
+
+/* A single author found by a query */
+typedef struct ZitatespuckerAuthorMatch {
+	const char *author; /* The name as the source has it; owned by the index */
+	size_t amount; /* Number of elements by this author */
+	unsigned int distance; /* Edits needed to turn the query into the beginning of a word of the name; 0 for prefix queries */
+} ZitatespuckerAuthorMatch;
+
+
+/* Externally callable */
+
+/*
+	Create an index of the authors within the whole list ZitatList is part of (both directions are followed).
+	Nothing of the list is referenced afterwards.
+	NULL on error (an empty list yields an empty index).
+
+	The returned object must be freed with ZitatespuckerAuthorIndexFree().
+*/
+ZitatespuckerAuthorIndex *ZitatespuckerAuthorIndexFromList(const ZitatespuckerZitat *ZitatList);
+
+/*
+	Create an index of the authors within filename, read using the backend for source
+	(see ZitatespuckerSourceCountFromFile(); no quote text is loaded).
+	If source is ZITATESPUCKER_SOURCE_UNKNOWN, it is detected with ZitatespuckerSourceDetect().
+	SQLite databases are not read before the first query.
+	NULL on error.
+
+	The returned object must be freed with ZitatespuckerAuthorIndexFree().
+*/
+ZitatespuckerAuthorIndex *ZitatespuckerAuthorIndexFromFile(const char *filename, ZitatespuckerSource source);
+
+/*
+	Build index now if it was not built yet (queries on other threads wait for it).
+	Calling this up front moves the time building an index of an SQLite database takes away from the first query.
+	false on error; the next query (or call) tries again.
+*/
+bool ZitatespuckerAuthorIndexBuild(ZitatespuckerAuthorIndex *index);
+
+/*
+	Returns the number of distinct authors within index (building it first if needed); 0 on error.
+*/
+size_t ZitatespuckerAuthorIndexGetAmount(ZitatespuckerAuthorIndex *index);
+
+/*
+	Find the authors with a word starting with prefix. An empty prefix finds every author.
+	Up to max of them are stored in matches (which may be NULL if max is 0), ordered by name (bytewise).
+	Returns the number of authors found, which may be larger than max; 0 on error.
+*/
+size_t ZitatespuckerAuthorIndexPrefix(ZitatespuckerAuthorIndex *index, const char *prefix, ZitatespuckerAuthorMatch *matches, size_t max);
+
+/*
+	Find the authors with a word starting with something at most maxDistance edits (insertions, deletions or substitutions)
+	away from query (at most ZITATESPUCKER_AUTHORS_MAX_DISTANCE). With maxDistance 0, this is the same as a prefix query.
+	Up to max of them are stored in matches (which may be NULL if max is 0), the closest first, then ordered by name.
+	Returns the number of authors found, which may be larger than max; 0 on error.
+*/
+size_t ZitatespuckerAuthorIndexFuzzy(ZitatespuckerAuthorIndex *index, const char *query, unsigned int maxDistance, ZitatespuckerAuthorMatch *matches, size_t max);
+
+/*
+	free index and the names it holds.
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerAuthorIndexFree(ZitatespuckerAuthorIndex *index);
+
+
+#endif
@@ -0,0 +1,93 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Process-wide cache of parsed sources (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_CACHE_H
+#define ZITATESPUCKER_CACHE_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_source.h"
+
+
+/* Counters of the cache, as returned by ZitatespuckerCacheGetStats() */
+typedef struct ZitatespuckerCacheStats {
+	uint64_t hits; /* Lookups answered from the cache */
+	uint64_t misses; /* Lookups that had to read the file */
+	uint64_t evictions; /* Entries dropped to stay within the limit, or because their file changed */
+	size_t entries; /* Entries currently held */
+	size_t bytes; /* Approximate memory used by the held entries */
+	size_t limit; /* The current limit as set by ZitatespuckerCacheSetLimit() */
+} ZitatespuckerCacheStats;
+
+
+/* Externally callable */
+
+/*
+	Set the maximum amount of memory (in bytes, approximately) the cache may hold on to.
+
+	The cache starts out with a limit of 0, meaning it is switched off:
+	every lookup reads the file and the result is freed again on ZitatespuckerCacheRelease().
+	Lowering the limit evicts unreferenced entries immediately.
+*/
+void ZitatespuckerCacheSetLimit(size_t maxBytes);
+
+/*
+	Returns a pointer to the first element in a linked list, read from filename using the backend for source
+	(see ZitatespuckerSourceGetZitatAllFromFile()), or a shared copy from the cache.
+	An entry is only reused if the file still has the same path, inode, modification time and size.
+	NULL on error.
+
+	The returned list is shared between callers and must not be modified.
+	Each non-NULL return must be handed back with ZitatespuckerCacheRelease(), never with ZitatespuckerZitatFree().
+
+	This function is thread-safe.
+*/
+const ZitatespuckerZitat *ZitatespuckerCacheGetZitatAllFromFile(const char *filename, ZitatespuckerSource source);
+
+/*
+	Drop a reference obtained from ZitatespuckerCacheGetZitatAllFromFile().
+	Passing NULL is a no-op.
+
+	This function is thread-safe.
+*/
+void ZitatespuckerCacheRelease(const ZitatespuckerZitat *ZitatList);
+
+/*
+	Evict every unreferenced entry. Referenced entries are freed once their last reference is released.
+
+	This function is thread-safe.
+*/
+void ZitatespuckerCacheClear(void);
+
+/*
+	Copy the current counters into stats.
+
+	This function is thread-safe.
+*/
+void ZitatespuckerCacheGetStats(ZitatespuckerCacheStats *stats);
+
+
+#endif
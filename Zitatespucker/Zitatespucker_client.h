@@ -0,0 +1,142 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Client for the zitatespuckerd quote server (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_CLIENT_H
+#define ZITATESPUCKER_CLIENT_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+
+
+/*
+	Wire protocol
+
+	All integers are little-endian. A string is a u32 length followed by that many bytes (no terminator);
+	a length of 0 stands for NULL, just like backends never hand out empty strings.
+
+	Request:  u32 length of what follows, u8 opcode, payload
+		ZITATESPUCKER_OP_COUNT       (nothing)
+		ZITATESPUCKER_OP_RANDOM      (nothing)
+		ZITATESPUCKER_OP_RANGE       u32 start, u32 amount
+		ZITATESPUCKER_OP_BYAUTHOR    u32 maxAmount, string authorname
+		ZITATESPUCKER_OP_BYDATE      u32 maxAmount, u8 annodomini, u16 year, u8 month, u8 day
+		ZITATESPUCKER_OP_SEARCH      u32 maxAmount, string text (matched against author, zitat and comment)
+
+	Response: u32 length of what follows, u8 status, u32 amount, then amount records of
+		u8 day, u8 month, u16 year, u8 annodomini, string author, string zitat, string comment
+	For ZITATESPUCKER_OP_COUNT, amount is the number of elements held by the server and no records follow.
+*/
+#define ZITATESPUCKER_PROTOCOL_MAXFRAME		(16u * 1024u * 1024u) /* Neither side accepts frames larger than this */
+
+#define ZITATESPUCKER_OP_COUNT				1
+#define ZITATESPUCKER_OP_RANDOM				2
+#define ZITATESPUCKER_OP_RANGE				3
+#define ZITATESPUCKER_OP_BYAUTHOR			4
+#define ZITATESPUCKER_OP_BYDATE				5
+#define ZITATESPUCKER_OP_SEARCH				6
+
+#define ZITATESPUCKER_STATUS_OK				0
+#define ZITATESPUCKER_STATUS_BADREQUEST		1
+#define ZITATESPUCKER_STATUS_SERVERERROR	2
+
+/* Where zitatespuckerd listens unless told otherwise */
+#define ZITATESPUCKER_DEFAULT_SOCKET		"/tmp/zitatespuckerd.sock"
+
+
+/*
+	A connection to zitatespuckerd; one connection must not be used by two threads at the same time.
+	Once a request or its response goes through only partly (the server went away, sent a malformed frame, memory ran out),
+	every later call on the connection fails as well; close it and connect again.
+*/
+typedef struct ZitatespuckerClient ZitatespuckerClient;
+
+
+/* Externally callable */
+
+/*
+	Connect to the server listening on socketpath (ZITATESPUCKER_DEFAULT_SOCKET if NULL).
+	NULL on error.
+
+	The returned connection must be closed with ZitatespuckerClientClose().
+*/
+ZitatespuckerClient *ZitatespuckerClientConnect(const char *socketpath);
+
+/*
+	Close a connection obtained from ZitatespuckerClientConnect().
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerClientClose(ZitatespuckerClient *client);
+
+/*
+	Returns the number of elements held by the server.
+	0 if none or an error occured.
+*/
+size_t ZitatespuckerClientGetAmount(ZitatespuckerClient *client);
+
+/*
+	Returns a pointer to a single, randomly chosen ZitatespuckerZitat.
+	NULL on error or if the server holds nothing.
+
+	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerClientGetZitatRandom(ZitatespuckerClient *client);
+
+/*
+	Returns a pointer to the first element in a linked list of (at most) amount elements, starting at index start.
+	NULL on error or if the range is empty.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerClientGetZitatRange(ZitatespuckerClient *client, uint32_t start, uint32_t amount);
+
+/*
+	Returns a pointer to the first element in a linked list of (at most maxAmount) elements by the author given in authorname.
+	NULL on error or if nothing matched. authorname is not optional.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerClientGetZitatAllByAuthor(ZitatespuckerClient *client, const char *authorname, uint32_t maxAmount);
+
+/*
+	Returns a pointer to the first element in a linked list of (at most maxAmount) elements matching the given date information.
+	NULL on error or if nothing matched.
+	The date information is interpreted like it is by ZitatespuckerSQLGetZitatAllFromFileByDate().
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerClientGetZitatAllByDate(ZitatespuckerClient *client, bool annodomini, uint16_t year, uint8_t month, uint8_t day, uint32_t maxAmount);
+
+/*
+	Returns a pointer to the first element in a linked list of (at most maxAmount) elements whose author, zitat or comment contains text.
+	NULL on error or if nothing matched. text is not optional.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerClientGetZitatAllBySearch(ZitatespuckerClient *client, const char *text, uint32_t maxAmount);
+
+
+#endif
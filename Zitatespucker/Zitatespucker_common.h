@@ -50,8 +50,51 @@ typedef struct ZitatespuckerZitat {
 	bool annodomini; /* true --> AD; false --> BC */
 	struct ZitatespuckerZitat *nextZitat; /* Points to the next ZitatespuckerZitat (linked list behavior) */
 	struct ZitatespuckerZitat *prevZitat; /* Points to the previous ZitatespuckerZitat (doubly linked list behavior) */
+
+	/*
+		Filled in by the backends from what they know while reading the strings anyway, so nothing has to measure them again.
+		0 means not known (as for elements built by hand), see ZitatespuckerZitatSetLengths() and ZitatespuckerZitatGetAuthorLen().
+	*/
+	size_t authorLen; /* strlen(author) */
+	size_t zitatLen; /* strlen(zitat) */
+	size_t commentLen; /* strlen(comment) */
+	uint64_t authorHash; /* ZitatespuckerAuthorHash() of author */
 } ZitatespuckerZitat;
 
+/*
+	A set of fields of ZitatespuckerZitat, for loading only the ones that are needed (see the *Fields() functions).
+	Fields that are not asked for are left as ZitatespuckerZitatInit() sets them, and are never read from the source.
+*/
+typedef unsigned int ZitatespuckerFields;
+
+#define ZITATESPUCKER_FIELD_AUTHOR		(1u << 0) /* author */
+#define ZITATESPUCKER_FIELD_ZITAT		(1u << 1) /* zitat */
+#define ZITATESPUCKER_FIELD_COMMENT		(1u << 2) /* comment */
+#define ZITATESPUCKER_FIELD_DATE		(1u << 3) /* day, month, year and annodomini */
+#define ZITATESPUCKER_FIELD_ALL			(ZITATESPUCKER_FIELD_AUTHOR | ZITATESPUCKER_FIELD_ZITAT | ZITATESPUCKER_FIELD_COMMENT | ZITATESPUCKER_FIELD_DATE)
+
+
+/*
+	Compares two elements for the sort functions, like strcmp() does:
+	less than, equal to or greater than 0 if a is to go before, next to or after b.
+	userdata is what was passed to ZitatespuckerZitatSort().
+*/
+typedef int (*ZitatespuckerZitatCompare)(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b, void *userdata);
+
+/* Which of several duplicates ZitatespuckerZitatDedup() keeps */
+typedef enum ZitatespuckerDuplicates {
+	ZITATESPUCKER_DUPLICATES_KEEP_FIRST = 0, /* Keep the first one within the list, free the others */
+	ZITATESPUCKER_DUPLICATES_KEEP_LAST, /* Keep the last one within the list, free the others */
+	ZITATESPUCKER_DUPLICATES_REPORT /* Keep all of them, only report them */
+} ZitatespuckerDuplicates;
+
+/*
+	Called by ZitatespuckerZitatDedup() for every duplicate it finds.
+	kept is the element that stays (when only reporting, the first one of its kind),
+	duplicate the one that goes; unless only reporting, it is freed right after the call returns.
+*/
+typedef void (*ZitatespuckerZitatDuplicate)(const ZitatespuckerZitat *kept, const ZitatespuckerZitat *duplicate, void *userdata);
+
 
 /* Common functions */
 
@@ -72,6 +115,39 @@ void ZitatespuckerGetVersion(uint8_t *major, uint8_t *minor, uint8_t *patch);
 */
 void ZitatespuckerZitatInit(ZitatespuckerZitat *ZitatToInit);
 
+/*
+	Set authorLen, zitatLen, commentLen and authorHash of Zitat (only this element) from its strings.
+	Call this after building an element by hand or changing one of its strings;
+	the library copes with them being 0, but has to measure the strings again then.
+*/
+void ZitatespuckerZitatSetLengths(ZitatespuckerZitat *Zitat);
+
+/*
+	Return the length of the author, quote or comment of Zitat (0 if there is none),
+	taken from authorLen, zitatLen or commentLen if known.
+*/
+size_t ZitatespuckerZitatGetAuthorLen(const ZitatespuckerZitat *Zitat);
+size_t ZitatespuckerZitatGetZitatLen(const ZitatespuckerZitat *Zitat);
+size_t ZitatespuckerZitatGetCommentLen(const ZitatespuckerZitat *Zitat);
+
+/*
+	Returns the hash of the author of Zitat (see ZitatespuckerAuthorHash()), taken from authorHash if known.
+*/
+uint64_t ZitatespuckerZitatGetAuthorHash(const ZitatespuckerZitat *Zitat);
+
+/*
+	Returns a 64-bit hash of the len bytes of author, as stored in authorHash.
+	0 if author is NULL, never 0 otherwise.
+*/
+uint64_t ZitatespuckerAuthorHash(const char *author, size_t len);
+
+/*
+	Returns whether the author of Zitat is exactly authorname, which is len bytes long and hashes to hash
+	(see ZitatespuckerAuthorHash(); hash it once, then compare any number of elements).
+	Elements whose authorHash is known are told apart by it, and only compared byte by byte on a match.
+*/
+bool ZitatespuckerZitatIsByAuthor(const ZitatespuckerZitat *Zitat, const char *authorname, size_t len, uint64_t hash);
+
 /*
 	free a ZitatespuckerZitat linked list
 	This function doesn't care for the length of the list and will work even on just one element.
@@ -99,4 +175,57 @@ void ZitatespuckerZitatFreePrevOnly(ZitatespuckerZitat *ZitatToFree);
 size_t ZitatespuckerZitatListLen(ZitatespuckerZitat *ZitatList);
 
 
+/*
+	Sort the whole list ZitatList is part of (both directions are followed), using compare.
+	The sort is stable, and works by relinking the elements in place; nothing is allocated or copied.
+	Returns the new first element (NULL if passed a NULL pointer).
+*/
+ZitatespuckerZitat *ZitatespuckerZitatSort(ZitatespuckerZitat *ZitatList, ZitatespuckerZitatCompare compare, void *userdata);
+
+/*
+	Same as ZitatespuckerZitatSort() with ZitatespuckerZitatCompareByDate(), i.e. oldest first,
+	but through a radix sort on the date, which is a lot faster for long lists.
+*/
+ZitatespuckerZitat *ZitatespuckerZitatSortByDate(ZitatespuckerZitat *ZitatList);
+
+/*
+	Same as ZitatespuckerZitatSort() with ZitatespuckerZitatCompareByAuthor().
+*/
+ZitatespuckerZitat *ZitatespuckerZitatSortByAuthor(ZitatespuckerZitat *ZitatList);
+
+/*
+	Compare the dates of a and b, taking annodomini into account (so 10 BC is before 1 BC, which is before 1 AD).
+	Elements with an invalid date (year 0 BC) go first. A month or day of 0 (unknown) goes before the known ones;
+	months above 12 and days above 31 are treated as 12 and 31 respectively.
+	userdata is ignored.
+*/
+int ZitatespuckerZitatCompareByDate(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b, void *userdata);
+
+/*
+	Compare the authors of a and b byte by byte (like strcmp()); elements without an author go first.
+	userdata is ignored.
+*/
+int ZitatespuckerZitatCompareByAuthor(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b, void *userdata);
+
+
+/*
+	Find the elements of the whole list ZitatList is part of (both directions are followed) that are the same quote:
+	same author, quote and date (day, month, year and annodomini), with author and quote compared after normalizing
+	their whitespace (leading and trailing whitespace is dropped, any other run of it counts as a single space).
+	Comments are not compared.
+
+	keep decides which duplicate stays; it stays at its position within the list.
+	callback (may be NULL) is called for every duplicate found, and their number is stored in duplicates (may be NULL).
+	Elements are hashed (see ZitatespuckerZitatHash()), so this takes linear time.
+	Returns the new first element; NULL if passed a NULL pointer or on error, in which case the list is left alone.
+*/
+ZitatespuckerZitat *ZitatespuckerZitatDedup(ZitatespuckerZitat *ZitatList, ZitatespuckerDuplicates keep, ZitatespuckerZitatDuplicate callback, void *userdata, size_t *duplicates);
+
+/*
+	Returns a 64-bit hash over what ZitatespuckerZitatDedup() compares (author and quote with normalized whitespace, and the date),
+	so equal quotes hash equal even when their whitespace is not.
+*/
+uint64_t ZitatespuckerZitatHash(const ZitatespuckerZitat *Zitat);
+
+
 #endif
@@ -0,0 +1,129 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Compressed read-only quote lists (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_COMPACT_H
+#define ZITATESPUCKER_COMPACT_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_source.h"
+
+
+/* Returned by the text getters when the element has no such text or idx is out of range */
+#define ZITATESPUCKER_COMPACT_NONE		SIZE_MAX
+
+
+/*
+	A read-only copy of a ZitatespuckerZitat list that takes as little memory as possible.
+
+	Quote and comment text is Huffman coded with a code trained on the list it was created from
+	and only decompressed when asked for, into a buffer provided by the caller.
+	Authors are stored once per distinct name and are not compressed.
+
+	Nothing within a compact list changes after it has been created,
+	so any number of threads may read from it at the same time without locking.
+*/
+typedef struct ZitatespuckerCompact ZitatespuckerCompact;
+
+/* Memory use of a compact list, see ZitatespuckerCompactGetStats() */
+typedef struct ZitatespuckerCompactStats {
+	size_t entries; /* Number of elements */
+	size_t textBytes; /* Quote and comment text as plain strings (including the terminating '\0') */
+	size_t packedBytes; /* The same text, compressed */
+	size_t listBytes; /* What the elements would take as a ZitatespuckerZitat list (not counting malloc() overhead) */
+	size_t totalBytes; /* Everything the compact list takes, including the decoding table, authors and dates */
+	size_t bytesPerZitat; /* totalBytes / entries, rounded up */
+} ZitatespuckerCompactStats;
+
+
+/* Externally callable */
+
+/*
+	Create a compact copy of the whole list ZitatList is part of (both directions are followed).
+	The list itself is not modified and may be freed afterwards.
+	NULL on error or if ZitatList is NULL.
+
+	The returned object must be freed with ZitatespuckerCompactFree().
+*/
+ZitatespuckerCompact *ZitatespuckerCompactFromList(const ZitatespuckerZitat *ZitatList);
+
+/*
+	Create a compact copy of all elements within filename, read using the backend for source
+	(see ZitatespuckerSourceGetZitatAllFromFile()).
+	NULL on error.
+
+	The returned object must be freed with ZitatespuckerCompactFree().
+*/
+ZitatespuckerCompact *ZitatespuckerCompactFromFile(const char *filename, ZitatespuckerSource source);
+
+/*
+	free a compact list.
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerCompactFree(ZitatespuckerCompact *compact);
+
+/*
+	Returns the number of elements within compact.
+	0 if passed a NULL pointer.
+*/
+size_t ZitatespuckerCompactLen(const ZitatespuckerCompact *compact);
+
+/*
+	Decompress the quote of the element at idx into buf, which has room for buflen chars.
+	Like snprintf(), the result is always '\0'-terminated (if buflen is not 0) and truncated if it does not fit;
+	the return value is the full length of the quote (without the '\0'), so buf was large enough if it is less than buflen.
+	ZITATESPUCKER_COMPACT_NONE if the element has no quote or idx is out of range (buf then holds "").
+*/
+size_t ZitatespuckerCompactGetZitat(const ZitatespuckerCompact *compact, size_t idx, char *buf, size_t buflen);
+
+/*
+	Same as ZitatespuckerCompactGetZitat(), but for the comment.
+*/
+size_t ZitatespuckerCompactGetComment(const ZitatespuckerCompact *compact, size_t idx, char *buf, size_t buflen);
+
+/*
+	Returns the author of the element at idx.
+	NULL if the element has none or idx is out of range.
+
+	The returned string belongs to compact and stays valid until it is freed.
+*/
+const char *ZitatespuckerCompactGetAuthor(const ZitatespuckerCompact *compact, size_t idx);
+
+/*
+	Store the date information of the element at idx in the passed pointers, each of which may be NULL.
+	false if idx is out of range.
+*/
+bool ZitatespuckerCompactGetDate(const ZitatespuckerCompact *compact, size_t idx, bool *annodomini, uint16_t *year, uint8_t *month, uint8_t *day);
+
+/*
+	Fill stats with the memory use of compact, to budget for it.
+	All zero if compact is NULL.
+*/
+void ZitatespuckerCompactGetStats(const ZitatespuckerCompact *compact, ZitatespuckerCompactStats *stats);
+
+
+#endif
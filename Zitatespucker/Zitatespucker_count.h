@@ -0,0 +1,144 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Counting quotes by author and date (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_COUNT_H
+#define ZITATESPUCKER_COUNT_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+
+
+/* What elements are grouped by when counting them */
+typedef enum ZitatespuckerGroup {
+	ZITATESPUCKER_GROUP_NONE = 0, /* No groups, only the total */
+	ZITATESPUCKER_GROUP_AUTHOR, /* One group per author */
+	ZITATESPUCKER_GROUP_YEAR, /* One group per year */
+	ZITATESPUCKER_GROUP_DECADE, /* One group per ten years (e.g. 1990 to 1999) */
+	ZITATESPUCKER_GROUP_CENTURY, /* One group per hundred years (e.g. 1900 to 1999) */
+	ZITATESPUCKER_GROUP_ERA /* One group for BC, one for AD */
+} ZitatespuckerGroup;
+
+/*
+	Which elements to count; members that are not used are ignored.
+
+	Years are given as a single signed number: years AD as they are, years BC negated (so 1 BC is -1 and AD 0 is 0).
+	Elements with an invalid date (year 0 BC) never match a range.
+*/
+typedef struct ZitatespuckerCountFilter {
+	const char *author; /* Only count elements by this author; NULL for any author */
+	bool byYear; /* Only count elements dated from firstYear up to and including lastYear */
+	int32_t firstYear;
+	int32_t lastYear;
+} ZitatespuckerCountFilter;
+
+/* A single group, see ZitatespuckerCounts */
+typedef struct ZitatespuckerCount {
+	const char *author; /* ZITATESPUCKER_GROUP_AUTHOR: the author, NULL for elements without one */
+	bool annodomini; /* Groups by date: the era */
+	uint16_t year; /* YEAR: the year; DECADE and CENTURY: the year divisible by 10/100 within it (1990 for 1999 BC to 1990 BC); ERA: 0 */
+	size_t amount; /* Number of elements within this group */
+} ZitatespuckerCount;
+
+/*
+	The result of counting.
+
+	Groups by author are ordered by name (bytewise, the group without an author first),
+	groups by date from the earliest to the latest.
+	Groups that would be empty are left out.
+*/
+typedef struct ZitatespuckerCounts {
+	ZitatespuckerGroup group;
+	size_t total; /* Number of elements that matched the filter, grouped or not */
+	size_t undated; /* Of those, the ones left out of groups by date because of an invalid date (year 0 BC) */
+	size_t len; /* Number of groups */
+	ZitatespuckerCount *counts; /* The groups, len of them */
+} ZitatespuckerCounts;
+
+/*
+	Counts in the making.
+	See ZitatespuckerCountBegin().
+*/
+typedef struct ZitatespuckerCounter ZitatespuckerCounter;
+
+
+/* Externally callable */
+
+/*
+	Start counting elements that match filter (NULL to count all of them) grouped by group.
+	filter is copied, so it does not have to stay around.
+	NULL on error.
+
+	The returned counter must be finished with ZitatespuckerCountEnd().
+*/
+ZitatespuckerCounter *ZitatespuckerCountBegin(ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter);
+
+/*
+	Count Zitat (only this element, the list it might be part of is not followed) if it matches the filter.
+	Only author, year and annodomini are looked at, and nothing is kept of Zitat, so its strings may be borrowed.
+	false on error; once adding failed, ZitatespuckerCountEnd() fails as well.
+*/
+bool ZitatespuckerCountAdd(ZitatespuckerCounter *counter, const ZitatespuckerZitat *Zitat);
+
+/*
+	Count amount elements that all fall into the same group as Zitat, without looking at the filter.
+	For backends that did the filtering (and possibly a finer grouping) themselves.
+	false on error.
+*/
+bool ZitatespuckerCountAddAmount(ZitatespuckerCounter *counter, const ZitatespuckerZitat *Zitat, size_t amount);
+
+/*
+	Same as ZitatespuckerCountAdd(), with counter passed as userdata, returning false to stop on error;
+	so it can be passed to ZitatespuckerJSONForEachFromFile() and the like.
+*/
+bool ZitatespuckerCountCallback(const ZitatespuckerZitat *Zitat, void *counter);
+
+/*
+	Finish counting and free counter.
+	NULL on error (including any earlier ZitatespuckerCountAdd() having failed).
+
+	The returned object must be freed with ZitatespuckerCountsFree().
+*/
+ZitatespuckerCounts *ZitatespuckerCountEnd(ZitatespuckerCounter *counter);
+
+/*
+	Count the whole list ZitatList is part of (both directions are followed),
+	as if by ZitatespuckerCountBegin(), ZitatespuckerCountAdd() for every element and ZitatespuckerCountEnd().
+	A NULL ZitatList counts as an empty list.
+	NULL on error.
+
+	The returned object must be freed with ZitatespuckerCountsFree().
+*/
+ZitatespuckerCounts *ZitatespuckerCountFromList(const ZitatespuckerZitat *ZitatList, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter);
+
+/*
+	free the result of counting.
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerCountsFree(ZitatespuckerCounts *counts);
+
+
+#endif
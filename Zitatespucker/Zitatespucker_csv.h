@@ -0,0 +1,147 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	CSV and TSV backend (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_CSV_H
+#define ZITATESPUCKER_CSV_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_count.h"
+
+
+/*
+	How a .csv (or .tsv) file is laid out. Members that are 0 or NULL take their defaults,
+	so passing NULL instead of the whole struct reads files the way spreadsheets usually write them.
+
+	The first row has to name the columns; the names are compared without regard to case or surrounding whitespace.
+	Columns that are not named below are ignored, and fields without a column stay NULL (or 0).
+*/
+typedef struct ZitatespuckerCSVOptions {
+	char delimiter; /* Between fields; 0 --> '\t' for files ending in .tsv or .tab, ',' otherwise */
+	const char *author; /* Name of the column holding the author; NULL --> ZITATESPUCKERZITATAUTHOR ("author") */
+	const char *zitat; /* ... the quote; NULL --> ZITATESPUCKERZITATZITAT */
+	const char *comment; /* ... the comment; NULL --> ZITATESPUCKERZITATCOMMENT */
+	const char *day; /* ... the day; NULL --> ZITATESPUCKERZITATDAY */
+	const char *month; /* ... the month; NULL --> ZITATESPUCKERZITATMONTH */
+	const char *year; /* ... the year; NULL --> ZITATESPUCKERZITATYEAR */
+	const char *annodomini; /* ... the era; NULL --> ZITATESPUCKERZITATANNODOMINI */
+} ZitatespuckerCSVOptions;
+
+/*
+	Called by ZitatespuckerCSVForEachFromFile() for every element, in the order of the rows.
+	Zitat (a single element, not linked to others) only lives until the call returns, so copy what you want to keep.
+	Return false to stop.
+*/
+typedef bool (*ZitatespuckerCSVCallback)(const ZitatespuckerZitat *Zitat, void *userdata);
+
+
+/*
+	Fields are read as RFC 4180 has them: a field within double quotes may hold delimiters, line breaks
+	and doubled double quotes (standing for one); rows end with "\n" or "\r\n". A UTF-8 byte order mark is skipped.
+	Empty rows are skipped, and rows with fewer fields than there are columns have the missing ones empty.
+
+	Empty strings are NULL. day, month and year are read as decimal numbers (anything else is 0) and clamped
+	like the JSON backends do; annodomini is true for "true", "yes", "1", "AD" and "CE" (in any case), false otherwise.
+
+	Unquoted fields are scanned for the delimiter and line breaks eight bytes at a time, quoted ones with memchr().
+*/
+
+
+/* Externally callable */
+
+/*
+	Returns the number of ZitatespuckerZitat elements within a given filename (aka non-empty rows below the header).
+	options may be NULL (see ZitatespuckerCSVOptions).
+	0 if none or an error occured.
+*/
+size_t ZitatespuckerCSVGetAmountFromFile(const char *filename, const ZitatespuckerCSVOptions *options);
+
+/*
+	Returns a pointer to single populated ZitatespuckerZitat.
+	idx refers to the idx-th non-empty row below the header, counting from 0.
+	NULL on error.
+
+	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatSingleFromFile(const char *filename, const ZitatespuckerCSVOptions *options, const size_t idx);
+
+/*
+	Returns a pointer to the first element in a linked list.
+	NULL on error or if the file holds no rows.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFile(const char *filename, const ZitatespuckerCSVOptions *options);
+
+/*
+	Returns a pointer to the first element in a linked list, filtered by the author given in authorname.
+	NULL on error or if nothing matched.
+	authorname is not optional, and it being NULL results in a NULL return.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileByAuthor(const char *filename, const ZitatespuckerCSVOptions *options, const char *authorname);
+
+/*
+	Returns a pointer to the first element in a linked list, filtered by the given date information.
+	NULL on error or if nothing matched.
+	The date information is interpreted like it is by ZitatespuckerSQLGetZitatAllFromFileByDate():
+	month and day are optional, year and annodomini are not. (if day is non-zero, month is not optional!)
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileByDate(const char *filename, const ZitatespuckerCSVOptions *options, bool annodomini, uint16_t year, uint8_t month, uint8_t day);
+
+/*
+	Same as ZitatespuckerCSVGetZitatSingleFromFile(), ZitatespuckerCSVGetZitatAllFromFile(),
+	ZitatespuckerCSVGetZitatAllFromFileByAuthor() and ZitatespuckerCSVGetZitatAllFromFileByDate() respectively,
+	but only the fields within fields are populated (see ZitatespuckerFields); the others are not copied.
+	Filtering by author or date works regardless of whether those fields are asked for.
+*/
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatSingleFromFileFields(const char *filename, const ZitatespuckerCSVOptions *options, const size_t idx, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileFields(const char *filename, const ZitatespuckerCSVOptions *options, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileByAuthorFields(const char *filename, const ZitatespuckerCSVOptions *options, const char *authorname, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileByDateFields(const char *filename, const ZitatespuckerCSVOptions *options, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields);
+
+/*
+	Pass every element within filename to callback, one at a time, without building a list.
+	userdata is passed on to callback as-is.
+	Returns the number of elements passed to callback; 0 on error.
+*/
+size_t ZitatespuckerCSVForEachFromFile(const char *filename, const ZitatespuckerCSVOptions *options, ZitatespuckerCSVCallback callback, void *userdata);
+
+/*
+	Count the elements within filename that match filter (NULL to count all of them), grouped by group.
+	NULL on error.
+
+	No quote or comment text is copied.
+	The returned object must be freed with ZitatespuckerCountsFree().
+*/
+ZitatespuckerCounts *ZitatespuckerCSVCountFromFile(const char *filename, const ZitatespuckerCSVOptions *options, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter);
+
+
+#endif
@@ -0,0 +1,198 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Diagnostics: errors, warning counters and where messages go (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_DIAG_H
+#define ZITATESPUCKER_DIAG_H
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stddef.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+
+
+/* What kind of error the last failed call on a thread ran into */
+typedef enum ZitatespuckerError {
+	ZITATESPUCKER_ERROR_NONE = 0, /* No error (since the last ZitatespuckerDiagClear()) */
+	ZITATESPUCKER_ERROR_ARGUMENT, /* An argument was NULL or cannot be used */
+	ZITATESPUCKER_ERROR_MEMORY, /* An allocation failed */
+	ZITATESPUCKER_ERROR_IO, /* Opening, reading or writing a file failed */
+	ZITATESPUCKER_ERROR_FORMAT, /* A source (or server response) is not laid out as expected */
+	ZITATESPUCKER_ERROR_RANGE, /* An index was out of range */
+	ZITATESPUCKER_ERROR_LIMIT, /* Something is too large for the library to handle */
+	ZITATESPUCKER_ERROR_UNSUPPORTED, /* The library was built without what is needed (e.g. a backend) */
+	ZITATESPUCKER_ERROR_BACKEND /* A library a backend uses (json-c, jansson, SQLite, pthreads, sockets) reported an error */
+} ZitatespuckerError;
+
+/* The keys of a record, for the warning counters */
+typedef enum ZitatespuckerKey {
+	ZITATESPUCKER_KEY_AUTHOR = 0,
+	ZITATESPUCKER_KEY_ZITAT,
+	ZITATESPUCKER_KEY_COMMENT,
+	ZITATESPUCKER_KEY_DAY,
+	ZITATESPUCKER_KEY_MONTH,
+	ZITATESPUCKER_KEY_YEAR,
+	ZITATESPUCKER_KEY_ANNODOMINI,
+	ZITATESPUCKER_KEY_MAX /* Number of keys, not a key */
+} ZitatespuckerKey;
+
+/* What a warning is about; a warning never makes a call fail */
+typedef enum ZitatespuckerWarningKind {
+	ZITATESPUCKER_WARNING_MISSING = 0, /* A record lacks a key (which is then left as ZitatespuckerZitatInit() sets it) */
+	ZITATESPUCKER_WARNING_INVALID, /* A key holds a value that cannot be converted (it is read as 0) */
+	ZITATESPUCKER_WARNING_MALFORMED /* A record (e.g. a line of a .ndjson) cannot be read at all and is skipped */
+} ZitatespuckerWarningKind;
+
+/*
+	Warnings counted on a thread since the last ZitatespuckerDiagResetWarnings() there.
+	Only the JSON backends count missing and invalid keys (the others have no way to leave a key out),
+	the JSON Lines backend counts skipped lines.
+*/
+typedef struct ZitatespuckerWarnings {
+	size_t missing[ZITATESPUCKER_KEY_MAX]; /* Records without the key, indexed by ZitatespuckerKey */
+	size_t invalid[ZITATESPUCKER_KEY_MAX]; /* Records with an unconvertible value for the key, likewise */
+	size_t malformed; /* Records skipped as a whole */
+} ZitatespuckerWarnings;
+
+/* Whether a ZitatespuckerDiag is an error or a warning */
+typedef enum ZitatespuckerDiagLevel {
+	ZITATESPUCKER_LEVEL_ERROR = 0,
+	ZITATESPUCKER_LEVEL_WARNING
+} ZitatespuckerDiagLevel;
+
+/*
+	A single error or warning, as handed to a ZitatespuckerDiagSink.
+	All pointers are only valid during the call. Built with ZITATESPUCKER_NOPRINT,
+	file and function are NULL, line is 0 and message is empty.
+*/
+typedef struct ZitatespuckerDiag {
+	ZitatespuckerDiagLevel level;
+	ZitatespuckerError error; /* ZITATESPUCKER_LEVEL_ERROR: what kind of error */
+	ZitatespuckerWarningKind warning; /* ZITATESPUCKER_LEVEL_WARNING: what kind of warning */
+	ZitatespuckerKey key; /* ZITATESPUCKER_LEVEL_WARNING: the key concerned, ZITATESPUCKER_KEY_MAX for whole records */
+	const char *file; /* Source file of the library that reported it */
+	int line;
+	const char *function; /* Function of the library that was called */
+	const char *message;
+} ZitatespuckerDiag;
+
+/*
+	Receives every error and warning the library reports, on the thread that reports it
+	(which may be one the library started, see the JSON Lines and async modules).
+*/
+typedef void (*ZitatespuckerDiagSink)(const ZitatespuckerDiag *diag, void *userdata);
+
+
+/* Reporting, for use by the library; the messages are compiled out with ZITATESPUCKER_NOPRINT */
+#ifndef ZITATESPUCKER_NOPRINT
+	#define ZITATESPUCKER_REPORT_ERROR(error, caller, ...)				ZitatespuckerDiagError((error), __FILE__, __LINE__, (caller), __VA_ARGS__)
+	#define ZITATESPUCKER_REPORT_WARNING(warning, keyName, caller, ...)	ZitatespuckerDiagWarning((warning), (keyName), __FILE__, __LINE__, (caller), __VA_ARGS__)
+#else
+	// caller and the message arguments are still evaluated, just never printed, so parameters that only end up in a report don't turn unused
+	static inline void ZitatespuckerDiagDiscard(const char *format, ...) { (void) format; return; }
+	#define ZITATESPUCKER_REPORT_ERROR(error, caller, ...)				((void) (caller), ZitatespuckerDiagDiscard(__VA_ARGS__), ZitatespuckerDiagError((error), NULL, 0, NULL, NULL))
+	#define ZITATESPUCKER_REPORT_WARNING(warning, keyName, caller, ...)	((void) (caller), ZitatespuckerDiagDiscard(__VA_ARGS__), ZitatespuckerDiagWarning((warning), (keyName), NULL, 0, NULL, NULL))
+#endif
+
+
+/* Externally callable */
+
+/*
+	Returns the kind of error the last failed call on this thread ran into.
+	Successful calls leave it alone, so only check it right after a call failed
+	(or call ZitatespuckerDiagClear() before).
+*/
+ZitatespuckerError ZitatespuckerDiagGetLastError(void);
+
+/*
+	Returns a description of the last error on this thread, without a trailing newline
+	("" if there is none, or the library was built with ZITATESPUCKER_NOPRINT).
+	The string belongs to the thread and is overwritten by the next error.
+*/
+const char *ZitatespuckerDiagGetLastMessage(void);
+
+/*
+	Forget the last error on this thread.
+*/
+void ZitatespuckerDiagClear(void);
+
+/*
+	Store the warnings counted on this thread in warnings.
+	Counting is cheap (nothing is formatted unless a sink is set), so it is always done;
+	call ZitatespuckerDiagResetWarnings() before a load to get the counts for that load alone.
+*/
+void ZitatespuckerDiagGetWarnings(ZitatespuckerWarnings *warnings);
+
+/*
+	Set the warnings counted on this thread back to 0.
+*/
+void ZitatespuckerDiagResetWarnings(void);
+
+/*
+	Add warnings (e.g. counted on another thread) to the ones of this thread.
+*/
+void ZitatespuckerDiagAddWarnings(const ZitatespuckerWarnings *warnings);
+
+/*
+	Write every warning count of warnings that is not 0 to file, one per line,
+	e.g. "records missing comment: 12034".
+	Returns the number of lines written.
+*/
+size_t ZitatespuckerDiagPrintWarnings(const ZitatespuckerWarnings *warnings, FILE *file);
+
+/*
+	Returns the name of key within a source (see ZITATESPUCKERZITATAUTHOR and friends),
+	NULL for ZITATESPUCKER_KEY_MAX and anything beyond.
+*/
+const char *ZitatespuckerDiagKeyName(ZitatespuckerKey key);
+
+/*
+	Returns a short description of error, e.g. "out of memory".
+*/
+const char *ZitatespuckerDiagErrorName(ZitatespuckerError error);
+
+/*
+	Hand every error and warning to sink from now on (NULL to stop doing so, which is the default).
+	By default the library writes nothing to stderr; pass ZitatespuckerDiagStderr for the messages it used to print.
+	The sink is process-wide: set it before other threads use the library.
+*/
+void ZitatespuckerDiagSetSink(ZitatespuckerDiagSink sink, void *userdata);
+
+/*
+	A ZitatespuckerDiagSink that writes a line per error or warning to stderr,
+	as "file:line:function: message". userdata is ignored.
+*/
+void ZitatespuckerDiagStderr(const ZitatespuckerDiag *diag, void *userdata);
+
+/*
+	Record an error on this thread and hand it to the sink, or count a warning and hand it to the sink.
+	format is a printf() format for the message, and may be NULL for none.
+	The library calls these through ZITATESPUCKER_REPORT_ERROR() and ZITATESPUCKER_REPORT_WARNING();
+	keyName is matched against ZITATESPUCKERZITATAUTHOR and friends (warnings about other names are only handed to the sink),
+	and ignored for ZITATESPUCKER_WARNING_MALFORMED.
+*/
+void ZitatespuckerDiagError(ZitatespuckerError error, const char *file, int line, const char *function, const char *format, ...);
+void ZitatespuckerDiagWarning(ZitatespuckerWarningKind warning, const char *keyName, const char *file, int line, const char *function, const char *format, ...);
+
+
+#endif
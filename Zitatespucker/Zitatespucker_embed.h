@@ -0,0 +1,144 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Sources compiled into the program (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_EMBED_H
+#define ZITATESPUCKER_EMBED_H
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+
+
+/* Returned by the Find functions when there is no (further) match */
+#define ZITATESPUCKER_EMBED_NONE		SIZE_MAX
+
+/* Offset of a string that is NULL within the source */
+#define ZITATESPUCKER_EMBED_NOSTRING	UINT32_MAX
+
+
+/*
+	An element of an embedded source.
+	Strings are offsets into the string data of the source instead of pointers,
+	so the generated arrays need no relocations and can stay in read-only memory (or ROM) as they are.
+*/
+typedef struct ZitatespuckerEmbedZitat {
+	uint32_t author; /* Offset of the author, ZITATESPUCKER_EMBED_NOSTRING if there is none */
+	uint32_t zitat; /* Offset of the quote, likewise */
+	uint32_t comment; /* Offset of the comment, likewise */
+	uint16_t year;
+	uint8_t month;
+	uint8_t day;
+	bool annodomini;
+} ZitatespuckerEmbedZitat;
+
+/*
+	A source turned into constant C data by ZitatespuckerEmbedWrite() (or the zitatespucker-embed program),
+	to be compiled into the program that uses it. Nothing is parsed or allocated to query it.
+
+	The generated code fills this in; its members are only described for that purpose,
+	use the functions below to read from it.
+*/
+typedef struct ZitatespuckerEmbed {
+	size_t len; /* Number of elements */
+	const ZitatespuckerEmbedZitat *Zitate; /* The elements, in the order of the source */
+	const char *strings; /* Every distinct string, '\0'-terminated, one after the other */
+	const uint32_t *byAuthor; /* Indexes of all elements, ordered by author (NULL first, then like strcmp()), then by index */
+	const uint32_t *byDate; /* Indexes of all elements, ordered by annodomini (BC first), then by year, then by index */
+} ZitatespuckerEmbed;
+
+
+/* Externally callable */
+
+/*
+	Write ZitatList (the whole list it is part of, both directions are followed) as C code:
+	a source file defining "const ZitatespuckerEmbed name" to csource,
+	and a header declaring it to header (may be NULL to leave it out).
+	name has to be a valid C identifier. Both files stay owned by the caller.
+	false on error (including ZitatList being NULL, or holding more elements than fit into a uint32_t).
+*/
+bool ZitatespuckerEmbedWrite(const ZitatespuckerZitat *ZitatList, const char *name, FILE *csource, FILE *header);
+
+/*
+	Returns the number of elements within embed.
+	0 if passed a NULL pointer.
+*/
+size_t ZitatespuckerEmbedGetAmount(const ZitatespuckerEmbed *embed);
+
+/*
+	Return the author, quote or comment of the element at idx.
+	NULL if the element has none or idx is out of range.
+	The returned strings are part of embed itself.
+*/
+const char *ZitatespuckerEmbedGetAuthor(const ZitatespuckerEmbed *embed, size_t idx);
+const char *ZitatespuckerEmbedGetZitatText(const ZitatespuckerEmbed *embed, size_t idx);
+const char *ZitatespuckerEmbedGetComment(const ZitatespuckerEmbed *embed, size_t idx);
+
+/*
+	Store the date information of the element at idx in the passed pointers, each of which may be NULL.
+	false if idx is out of range.
+*/
+bool ZitatespuckerEmbedGetDate(const ZitatespuckerEmbed *embed, size_t idx, bool *annodomini, uint16_t *year, uint8_t *month, uint8_t *day);
+
+/*
+	Returns the index of the first element at or after from whose author is exactly authorname.
+	ZITATESPUCKER_EMBED_NONE if there is none, or authorname is NULL.
+	Takes logarithmic time.
+*/
+size_t ZitatespuckerEmbedFindByAuthor(const ZitatespuckerEmbed *embed, const char *authorname, size_t from);
+
+/*
+	Returns the index of the first element at or after from that matches the given date information.
+	ZITATESPUCKER_EMBED_NONE if there is none.
+	The date information is interpreted like it is by ZitatespuckerSnapshotFindByDate():
+	month and day are optional (0), year and annodomini are not.
+	Takes logarithmic time, plus the elements of that year skipped for not matching month or day.
+*/
+size_t ZitatespuckerEmbedFindByDate(const ZitatespuckerEmbed *embed, bool annodomini, uint16_t year, uint8_t month, uint8_t day, size_t from);
+
+/*
+	Returns the number of elements by authorname, or from the given date (interpreted as above).
+	Logarithmic time, except for dates with a month, which count the elements of that year.
+	Dates that ZitatespuckerEmbedGetZitatAllByDate() refuses count 0.
+*/
+size_t ZitatespuckerEmbedGetAmountByAuthor(const ZitatespuckerEmbed *embed, const char *authorname);
+size_t ZitatespuckerEmbedGetAmountByDate(const ZitatespuckerEmbed *embed, bool annodomini, uint16_t year, uint8_t month, uint8_t day);
+
+/*
+	Copies of the elements of embed as a regular ZitatespuckerZitat list, in the order of the source,
+	for code written against the functions of the backends (e.g. ZitatespuckerSourceGetZitatAllFromFile()).
+	NULL on error or if there is no match.
+	Like the backends, ZitatespuckerEmbedGetZitatAllByDate() refuses year 0 with annodomini false, and a day without a month.
+
+	The returned list must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerEmbedGetZitatAll(const ZitatespuckerEmbed *embed);
+ZitatespuckerZitat *ZitatespuckerEmbedGetZitatSingle(const ZitatespuckerEmbed *embed, size_t idx);
+ZitatespuckerZitat *ZitatespuckerEmbedGetZitatAllByAuthor(const ZitatespuckerEmbed *embed, const char *authorname);
+ZitatespuckerZitat *ZitatespuckerEmbedGetZitatAllByDate(const ZitatespuckerEmbed *embed, bool annodomini, uint16_t year, uint8_t month, uint8_t day);
+
+
+#endif
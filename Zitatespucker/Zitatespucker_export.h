@@ -0,0 +1,121 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Writing quotes as .json (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_EXPORT_H
+#define ZITATESPUCKER_EXPORT_H
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_snapshot.h"
+
+
+/* Size of the buffer output to a FILE * or file descriptor is collected in before it is written */
+#define ZITATESPUCKER_EXPORT_BUFSIZE	(64 * 1024)
+
+
+/*
+	A .json document in the {"ZitatespuckerZitat": [...]} layout the JSON backends read, being written.
+
+	Elements are escaped and appended to a buffer as they are added, so no JSON library (or DOM) is involved;
+	when writing to a FILE * or file descriptor, memory use does not depend on the number of elements.
+	Fields that are NULL are left out.
+
+	Exporters started by the *Lines*() functions write JSON Lines instead (see Zitatespucker_ndjson.h).
+*/
+typedef struct ZitatespuckerExport ZitatespuckerExport;
+
+
+/* Externally callable */
+
+/*
+	Start a document written to file, which has to be open for writing and stays owned by the caller.
+	NULL on error.
+
+	The returned object must be finished with ZitatespuckerExportFinish().
+*/
+ZitatespuckerExport *ZitatespuckerExportToFile(FILE *file);
+
+/*
+	Start a document written to the file descriptor fd, which stays owned by the caller.
+	NULL on error.
+
+	The returned object must be finished with ZitatespuckerExportFinish().
+*/
+ZitatespuckerExport *ZitatespuckerExportToFd(int fd);
+
+/*
+	Start a document that is kept in memory and handed over by ZitatespuckerExportFinish().
+	NULL on error.
+
+	The returned object must be finished with ZitatespuckerExportFinish().
+*/
+ZitatespuckerExport *ZitatespuckerExportToBuffer(void);
+
+/*
+	Same as ZitatespuckerExportToFile(), ZitatespuckerExportToFd() and ZitatespuckerExportToBuffer() respectively,
+	but every element is written as a compact JSON object on a line of its own, with nothing around them.
+	Such output can be appended to an existing .ndjson file as it is.
+*/
+ZitatespuckerExport *ZitatespuckerExportLinesToFile(FILE *file);
+ZitatespuckerExport *ZitatespuckerExportLinesToFd(int fd);
+ZitatespuckerExport *ZitatespuckerExportLinesToBuffer(void);
+
+/*
+	Append Zitat (only this element, the list it might be part of is not followed).
+	false on error; once a write failed, everything after it fails as well.
+*/
+bool ZitatespuckerExportAdd(ZitatespuckerExport *exporter, const ZitatespuckerZitat *Zitat);
+
+/*
+	Append the whole list ZitatList is part of (both directions are followed).
+	false on error.
+*/
+bool ZitatespuckerExportAddList(ZitatespuckerExport *exporter, const ZitatespuckerZitat *ZitatList);
+
+/*
+	Append every element of snapshot.
+	false on error.
+*/
+bool ZitatespuckerExportAddSnapshot(ZitatespuckerExport *exporter, const ZitatespuckerSnapshot *snapshot);
+
+/*
+	Same as ZitatespuckerExportAdd(), with exporter passed as userdata, returning false to stop on error;
+	so it can be passed to ZitatespuckerJSONForEachFromFile() and the like.
+*/
+bool ZitatespuckerExportCallback(const ZitatespuckerZitat *Zitat, void *exporter);
+
+/*
+	Close the document, write out what is still buffered and free exporter.
+	For a document started with ZitatespuckerExportToBuffer(), the '\0'-terminated document is stored in buffer
+	and its length (without the '\0') in len; buffer must then be freed with free().
+	Otherwise (or if the document could not be written) buffer and len are left alone, and may be NULL.
+	false if any part of the document could not be written.
+*/
+bool ZitatespuckerExportFinish(ZitatespuckerExport *exporter, char **buffer, size_t *len);
+
+
+#endif
@@ -24,10 +24,24 @@
 
 /* Standard headers */
 #include <stddef.h>
+#include <stdbool.h>
 
 
 /* Internal headers */
 #include "Zitatespucker_common.h"
+#include "Zitatespucker_count.h"
+
+
+/* Appended to the name of a .json file for the name of its index (see ZitatespuckerJSONIndexBuild()) */
+#define ZITATESPUCKER_JSON_INDEX_SUFFIX ".zsidx"
+
+
+/*
+	Called by ZitatespuckerJSONForEachFromFile() for every element, in the order of the array.
+	Zitat (a single element, not linked to others) is freed after the call returns, so copy what you want to keep.
+	Return false to stop.
+*/
+typedef bool (*ZitatespuckerJSONCallback)(const ZitatespuckerZitat *Zitat, void *userdata);
 
 
 /* Externally callable */
@@ -57,9 +71,88 @@ ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingleFromFile(const char *filename
 */
 ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFile(const char *filename);
 
+/*
+	Returns a pointer to the first element in a linked list, filtered by the author given in authorname.
+	NULL on error or if nothing matched.
+	authorname is not optional, and it being NULL results in a NULL return.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByAuthor(const char *filename, const char *authorname);
+
+/*
+	Returns a pointer to the first element in a linked list, filtered by the given date information.
+	NULL on error or if nothing matched.
+	The date information is interpreted like it is by ZitatespuckerSQLGetZitatAllFromFileByDate():
+	month and day are optional, year and annodomini are not. (if day is non-zero, month is not optional!)
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByDate(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day);
+
+/*
+	Same as ZitatespuckerJSONGetZitatSingleFromFile(), ZitatespuckerJSONGetZitatAllFromFile(),
+	ZitatespuckerJSONGetZitatAllFromFileByAuthor() and ZitatespuckerJSONGetZitatAllFromFileByDate() respectively,
+	but only the fields within fields are populated (see ZitatespuckerFields); the others are neither read nor copied.
+	Filtering by author or date works regardless of whether those fields are asked for.
+*/
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingleFromFileFields(const char *filename, const size_t idx, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileFields(const char *filename, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByAuthorFields(const char *filename, const char *authorname, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByDateFields(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields);
+
+/*
+	Pass every element within filename to callback, one at a time, without building a list of all of them.
+	Elements that cannot be populated are skipped. userdata is passed on to callback as-is.
+	Returns the number of elements passed to callback; 0 on error.
+
+	Use this for large files where holding every element at once would be a waste, e.g. when converting them.
+*/
+size_t ZitatespuckerJSONForEachFromFile(const char *filename, ZitatespuckerJSONCallback callback, void *userdata);
+
+/*
+	Count the elements within filename that match filter (NULL to count all of them), grouped by group.
+	NULL on error.
+
+	This is done in a single pass over the parsed file; only the author and the date of each element are looked at,
+	and no quote or comment text is copied.
+	The returned object must be freed with ZitatespuckerCountsFree().
+*/
+ZitatespuckerCounts *ZitatespuckerJSONCountFromFile(const char *filename, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter);
+
+/*
+	Write an index of filename to filename + ZITATESPUCKER_JSON_INDEX_SUFFIX (replacing an existing one):
+	the byte span of every element of its array, along with the size and modification time of filename.
+	Returns false on error.
+
+	As long as the index is up to date, ZitatespuckerJSONGetAmountFromFile() only reads the index, and
+	ZitatespuckerJSONGetZitatSingleFromFile*() only read and parse the one element asked for, instead of all of filename.
+	Once filename changes (its size or modification time differ), the index is ignored and the whole file parsed again,
+	until the index is built anew. Files without an index are parsed as a whole, as before.
+
+	Only the array is looked at, not whether the elements are valid JSON; the backends parse those when reading them.
+*/
+bool ZitatespuckerJSONIndexBuild(const char *filename);
+
+/*
+	Store the number of elements recorded by the index of filename in amount.
+	false (without an error being reported) if filename has no index, or it is not up to date.
+*/
+bool ZitatespuckerJSONIndexGetAmount(const char *filename, size_t *amount);
+
+/*
+	Read the bytes of element idx of filename, as recorded by its index, into a newly allocated, '\0'-terminated buffer
+	stored in element (its length, without the '\0', in len).
+	false (without an error being reported) if filename has no index, it is not up to date or reading failed;
+	parse the whole file then. true if the index was used: element is NULL if idx is out of range.
+
+	The stored (non-NULL) buffer must be freed using free().
+*/
+bool ZitatespuckerJSONIndexGetElement(const char *filename, const size_t idx, char **element, size_t *len);
+
 // TODO:
 // Filter functions:
-// ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllBy* where * is Author, Year, etc
+// ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllBy* for the remaining fields
 // function for retrieving from a series of .json files? (link lists together)
 // fprintf calls: check for error (perror)
 
@@ -0,0 +1,160 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Newline-delimited JSON (JSON Lines) backend (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_NDJSON_H
+#define ZITATESPUCKER_NDJSON_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_count.h"
+
+
+/*
+	Files are only split among several threads if every one of them gets at least this many bytes;
+	smaller files are parsed on the calling thread.
+*/
+#define ZITATESPUCKER_NDJSON_CHUNK_MIN		(256 * 1024)
+
+/* Upper limit for the number of threads a single file is parsed with */
+#define ZITATESPUCKER_NDJSON_MAX_THREADS	64
+
+
+/*
+	Called by ZitatespuckerNDJSONForEachFromFile() for every element, in the order of the lines.
+	Zitat (a single element, not linked to others) only lives until the call returns, so copy what you want to keep.
+	Return false to stop.
+*/
+typedef bool (*ZitatespuckerNDJSONCallback)(const ZitatespuckerZitat *Zitat, void *userdata);
+
+
+/*
+	A .ndjson (or .jsonl) file holds one element per line, as a JSON object with the same keys an element of
+	the ZitatespuckerZitat array of a .json file has:
+
+		{"author": "TestAuthor", "zitat": "TestZitat", "day": 1, "month": 2, "year": 2024, "annodomini": true}
+
+	Lines are parsed by the backend itself, no JSON library is needed. Keys that are not known are skipped,
+	strings that are empty, missing or not strings at all are NULL, missing or non-numeric numbers are 0,
+	and annodomini is only true if it is the literal true.
+	Empty lines are skipped, and so are lines that are not a JSON object (with a diagnostic), so a line torn by
+	an interrupted append does not make the rest of the file unreadable.
+
+	Files are read as a whole and, if they are large enough, split at line boundaries into one chunk per
+	processor, which are parsed in parallel; the order of the elements is kept either way.
+*/
+
+
+/* Externally callable */
+
+/*
+	Returns the number of ZitatespuckerZitat elements within a given filename (aka non-empty lines).
+	0 if none or an error occured.
+
+	Note that the returned number may differ from the number of usable elements (i.e. malformed lines are counted, too).
+*/
+size_t ZitatespuckerNDJSONGetAmountFromFile(const char *filename);
+
+/*
+	Returns a pointer to single populated ZitatespuckerZitat.
+	idx refers to the idx-th non-empty line within filename, counting from 0.
+	NULL on error.
+
+	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatSingleFromFile(const char *filename, const size_t idx);
+
+/*
+	Returns a pointer to the first element in a linked list.
+	NULL on error or if the file holds no usable element.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFile(const char *filename);
+
+/*
+	Returns a pointer to the first element in a linked list, filtered by the author given in authorname.
+	NULL on error or if nothing matched.
+	authorname is not optional, and it being NULL results in a NULL return.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileByAuthor(const char *filename, const char *authorname);
+
+/*
+	Returns a pointer to the first element in a linked list, filtered by the given date information.
+	NULL on error or if nothing matched.
+	The date information is interpreted like it is by ZitatespuckerSQLGetZitatAllFromFileByDate():
+	month and day are optional, year and annodomini are not. (if day is non-zero, month is not optional!)
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileByDate(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day);
+
+/*
+	Same as ZitatespuckerNDJSONGetZitatSingleFromFile(), ZitatespuckerNDJSONGetZitatAllFromFile(),
+	ZitatespuckerNDJSONGetZitatAllFromFileByAuthor() and ZitatespuckerNDJSONGetZitatAllFromFileByDate() respectively,
+	but only the fields within fields are populated (see ZitatespuckerFields); the others are not copied.
+	Filtering by author or date works regardless of whether those fields are asked for.
+*/
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatSingleFromFileFields(const char *filename, const size_t idx, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileFields(const char *filename, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileByAuthorFields(const char *filename, const char *authorname, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileByDateFields(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields);
+
+/*
+	Same as ZitatespuckerNDJSONGetZitatAllFromFileFields(), but the file is split among exactly threads threads
+	(at most ZITATESPUCKER_NDJSON_MAX_THREADS), regardless of its size. 0 picks the number like the other functions do.
+	Like with a single thread, the lines skipped as malformed are counted on the calling thread (see Zitatespucker_diag.h).
+*/
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileThreads(const char *filename, ZitatespuckerFields fields, size_t threads);
+
+/*
+	Pass every element within filename to callback, one at a time, on the calling thread and without building a list.
+	Malformed lines are skipped. userdata is passed on to callback as-is.
+	Returns the number of elements passed to callback; 0 on error.
+*/
+size_t ZitatespuckerNDJSONForEachFromFile(const char *filename, ZitatespuckerNDJSONCallback callback, void *userdata);
+
+/*
+	Count the elements within filename that match filter (NULL to count all of them), grouped by group.
+	NULL on error.
+
+	No quote or comment text is copied.
+	The returned object must be freed with ZitatespuckerCountsFree().
+*/
+ZitatespuckerCounts *ZitatespuckerNDJSONCountFromFile(const char *filename, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter);
+
+/*
+	Append the whole list ZitatList is part of (both directions are followed) to filename, one line per element,
+	creating the file if it does not exist. Nothing that is already within filename is read or rewritten;
+	if its last line was torn (does not end with a newline), it is ended first, so the new lines stay intact.
+	false on error.
+*/
+bool ZitatespuckerNDJSONAppend(const char *filename, const ZitatespuckerZitat *ZitatList);
+
+
+#endif
@@ -0,0 +1,134 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Finding quotes that are almost the same (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_NEARDUP_H
+#define ZITATESPUCKER_NEARDUP_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_source.h"
+
+
+/* Defaults for the members of ZitatespuckerNearDupOptions left 0 */
+#define ZITATESPUCKER_NEARDUP_SHINGLE	5
+#define ZITATESPUCKER_NEARDUP_BANDS		30
+#define ZITATESPUCKER_NEARDUP_ROWS		5
+#define ZITATESPUCKER_NEARDUP_THRESHOLD	0.7
+
+/* Upper limits for shingle and for bands * rows */
+#define ZITATESPUCKER_NEARDUP_MAX_SHINGLE	32
+#define ZITATESPUCKER_NEARDUP_MAX_HASHES	1024
+
+
+/*
+	An index of the quote texts of a list, for finding the ones that are almost the same as a text (or as each other),
+	like a quote that was copied with a word changed, punctuation fixed or a sentence left out.
+
+	Texts are compared by their shingles: every run of shingle characters of the text with case (ASCII only),
+	punctuation and whitespace evened out. How alike two texts are is the Jaccard similarity of their shingles
+	(shared shingles / all shingles of both), estimated from a MinHash signature of bands * rows values per text.
+	Texts are only compared if all rows of at least one band of their signatures are the same (locality-sensitive hashing),
+	which the index finds by binary search, so neither building nor querying compares each text with every other one.
+
+	The chance of two texts with a similarity of s being compared at all is 1 - (1 - s^rows)^bands:
+	more bands (or fewer rows) find more of the less similar pairs, at the cost of a larger index and more comparisons.
+	The defaults compare more than 99 % of the pairs with a similarity of 0.7, about 60 % of the ones with 0.5 and 7 % of the ones with 0.3.
+
+	Once built, nothing within an index changes, so any number of threads may query it at the same time.
+*/
+typedef struct ZitatespuckerNearDupIndex ZitatespuckerNearDupIndex;
+
+/* How an index is built; members left 0 take the defaults above */
+typedef struct ZitatespuckerNearDupOptions {
+	unsigned int shingle; /* Characters (bytes) per shingle; texts shorter than this are a single shingle */
+	unsigned int bands; /* Bands of the signature */
+	unsigned int rows; /* Values per band */
+	double threshold; /* Similarity used by queries passing 0, between 0 and 1 */
+} ZitatespuckerNearDupOptions;
+
+/* A text found by a query */
+typedef struct ZitatespuckerNearDupMatch {
+	size_t idx; /* Index of the element within the list the index was built from */
+	double similarity; /* Estimated similarity to the query, between 0 and 1 */
+} ZitatespuckerNearDupMatch;
+
+
+/* Externally callable */
+
+/*
+	Create an index of the quote texts of the whole list ZitatList is part of (both directions are followed),
+	built as set by options (NULL for the defaults). Elements without a quote text are in the index, but never found.
+	Nothing of the list is referenced afterwards.
+	NULL on error (an empty list yields an empty index).
+
+	The returned object must be freed with ZitatespuckerNearDupIndexFree().
+*/
+ZitatespuckerNearDupIndex *ZitatespuckerNearDupIndexFromList(const ZitatespuckerZitat *ZitatList, const ZitatespuckerNearDupOptions *options);
+
+/*
+	Create an index of the quote texts within filename, read using the backend for source (only loading the quote texts).
+	If source is ZITATESPUCKER_SOURCE_UNKNOWN, it is detected with ZitatespuckerSourceDetect().
+	The indexes of matches are those of ZitatespuckerSourceGetZitatAllFromFile().
+	NULL on error.
+
+	The returned object must be freed with ZitatespuckerNearDupIndexFree().
+*/
+ZitatespuckerNearDupIndex *ZitatespuckerNearDupIndexFromFile(const char *filename, ZitatespuckerSource source, const ZitatespuckerNearDupOptions *options);
+
+/*
+	Returns the number of elements within index.
+	0 if passed a NULL pointer.
+*/
+size_t ZitatespuckerNearDupIndexGetAmount(const ZitatespuckerNearDupIndex *index);
+
+/*
+	Find the elements whose quote text has a similarity of at least threshold to text
+	(0 for the threshold index was built with). A text that is in the index finds itself, too.
+	Up to max of them are stored in matches (which may be NULL if max is 0), the most similar first, then ordered by idx.
+	Returns the number of elements found, which may be larger than max; 0 on error.
+*/
+size_t ZitatespuckerNearDupFind(const ZitatespuckerNearDupIndex *index, const char *text, double threshold, ZitatespuckerNearDupMatch *matches, size_t max);
+
+/*
+	Group the elements of index into clusters of near duplicates: elements with a similarity of at least threshold
+	(0 for the threshold index was built with) end up in the same cluster, as do the ones linked through other elements;
+	the clusters are the same as linking every element with everything ZitatespuckerNearDupFind() finds for its text.
+	clusters has to hold ZitatespuckerNearDupIndexGetAmount() entries; each is set to the index of the first element
+	of the cluster it belongs to (its own index if it has no near duplicates).
+	The number of clusters with more than one element is stored in amount (may be NULL).
+	false on error.
+*/
+bool ZitatespuckerNearDupClusters(const ZitatespuckerNearDupIndex *index, double threshold, size_t *clusters, size_t *amount);
+
+/*
+	free index.
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerNearDupIndexFree(ZitatespuckerNearDupIndex *index);
+
+
+#endif
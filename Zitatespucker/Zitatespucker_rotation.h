@@ -0,0 +1,115 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Shuffled rotation through a source (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_ROTATION_H
+#define ZITATESPUCKER_ROTATION_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_source.h"
+#include "Zitatespucker_snapshot.h"
+
+
+/*
+	Where a rotation stands. This is all there is to it, so storing these two numbers
+	(and passing them to ZitatespuckerRotationOpen() again later) resumes a rotation after a restart.
+*/
+typedef struct ZitatespuckerRotationState {
+	uint64_t seed; /* Picks the order; each round through the source is shuffled differently */
+	uint64_t position; /* Number of elements drawn so far, over all rounds (for SQLite databases, rowids passed over count, too) */
+} ZitatespuckerRotationState;
+
+/*
+	Draws every element of a source once, in a shuffled order, before starting the next round in another order.
+
+	No shuffled array is kept: the position within the round is mapped to an element by a keyed permutation
+	(a small Feistel network over the next power of four, walking its cycles until it lands within the source),
+	which takes constant time per draw on average.
+
+	SQLite databases are kept open, and the permutation runs over the rowids from the first to the last row:
+	a draw is a lookup of one rowid (see ZitatespuckerSQLReaderGetZitatByRowid()), passing over those of deleted rows,
+	so it takes the same time however large the table is. A round then spans the rowids of the rows there were on opening.
+	Tables where fewer than one in four rowids in between is left, and other sources,
+	are loaded into a snapshot.
+	A rotation must only be used by one thread at a time.
+*/
+typedef struct ZitatespuckerRotation ZitatespuckerRotation;
+
+
+/* Externally callable */
+
+/*
+	Returns the index drawn at state->position by a rotation through len elements with state->seed,
+	for those that keep the elements themselves. The len draws of every round
+	(positions round * len to round * len + len - 1) yield each index from 0 to len - 1 once.
+	0 if len is 0.
+*/
+size_t ZitatespuckerRotationAt(const ZitatespuckerRotationState *state, size_t len);
+
+/*
+	Start (or resume) a rotation through filename, read using the backend for source.
+	If source is ZITATESPUCKER_SOURCE_UNKNOWN, it is detected with ZitatespuckerSourceDetect().
+	state may be NULL to start at position 0 with a seed taken from the current time.
+	NULL on error (including filename holding no elements).
+
+	The returned rotation must be closed with ZitatespuckerRotationClose().
+*/
+ZitatespuckerRotation *ZitatespuckerRotationOpen(const char *filename, ZitatespuckerSource source, const ZitatespuckerRotationState *state);
+
+/*
+	Same as ZitatespuckerRotationOpen(), but through snapshot, of which the rotation takes a reference of its own.
+*/
+ZitatespuckerRotation *ZitatespuckerRotationFromSnapshot(ZitatespuckerSnapshot *snapshot, const ZitatespuckerRotationState *state);
+
+/*
+	Returns the number of elements rotation draws from per round.
+	0 if passed a NULL pointer.
+*/
+size_t ZitatespuckerRotationLen(const ZitatespuckerRotation *rotation);
+
+/*
+	Draw the next element.
+	NULL on error, in which case the position is not advanced, so the next call tries the same element again.
+
+	The returned element belongs to rotation and stays valid until the next draw or ZitatespuckerRotationClose().
+	Only the element itself counts; do not follow its nextZitat or prevZitat.
+*/
+const ZitatespuckerZitat *ZitatespuckerRotationNext(ZitatespuckerRotation *rotation);
+
+/*
+	Store where rotation stands in state.
+*/
+void ZitatespuckerRotationGetState(const ZitatespuckerRotation *rotation, ZitatespuckerRotationState *state);
+
+/*
+	Close rotation, freeing what it holds.
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerRotationClose(ZitatespuckerRotation *rotation);
+
+
+#endif
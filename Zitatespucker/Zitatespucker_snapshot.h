@@ -0,0 +1,111 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Immutable, shareable snapshots of a ZitatespuckerZitat list (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_SNAPSHOT_H
+#define ZITATESPUCKER_SNAPSHOT_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_source.h"
+
+
+/* Returned by the find functions when nothing (more) matched */
+#define ZITATESPUCKER_SNAPSHOT_NONE		SIZE_MAX
+
+
+/*
+	A read-only copy of a ZitatespuckerZitat list, stored in one block of memory.
+
+	Nothing within a snapshot changes after it has been created,
+	so any number of threads may read from the same snapshot at the same time without locking.
+	Lifetime is managed through a reference count (see ZitatespuckerSnapshotRetain() and ZitatespuckerSnapshotRelease()).
+*/
+typedef struct ZitatespuckerSnapshot ZitatespuckerSnapshot;
+
+
+/* Externally callable */
+
+/*
+	Create a snapshot of the whole list ZitatList is part of (both directions are followed).
+	The list itself is not modified and may be freed afterwards.
+	NULL on error or if ZitatList is NULL.
+
+	The returned snapshot starts with a reference count of 1 and must be released with ZitatespuckerSnapshotRelease().
+*/
+ZitatespuckerSnapshot *ZitatespuckerSnapshotFromList(const ZitatespuckerZitat *ZitatList);
+
+/*
+	Create a snapshot of all elements within filename, read using the backend for source
+	(see ZitatespuckerSourceGetZitatAllFromFile()).
+	NULL on error.
+
+	The returned snapshot starts with a reference count of 1 and must be released with ZitatespuckerSnapshotRelease().
+*/
+ZitatespuckerSnapshot *ZitatespuckerSnapshotFromFile(const char *filename, ZitatespuckerSource source);
+
+/*
+	Take another reference to snapshot and return it.
+*/
+ZitatespuckerSnapshot *ZitatespuckerSnapshotRetain(ZitatespuckerSnapshot *snapshot);
+
+/*
+	Drop a reference to snapshot, freeing it when it was the last one.
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerSnapshotRelease(ZitatespuckerSnapshot *snapshot);
+
+/*
+	Returns the number of elements within snapshot.
+	0 if passed a NULL pointer.
+*/
+size_t ZitatespuckerSnapshotLen(const ZitatespuckerSnapshot *snapshot);
+
+/*
+	Returns the element at idx.
+	The elements are linked through nextZitat/prevZitat like a regular list, so the one at index 0 can be walked as such.
+	NULL if idx is out of range.
+
+	The returned element belongs to snapshot and stays valid for as long as a reference is held.
+*/
+const ZitatespuckerZitat *ZitatespuckerSnapshotGet(const ZitatespuckerSnapshot *snapshot, size_t idx);
+
+/*
+	Returns the index of the first element at or after from whose author is exactly authorname.
+	ZITATESPUCKER_SNAPSHOT_NONE if there is none, or authorname is NULL.
+*/
+size_t ZitatespuckerSnapshotFindByAuthor(const ZitatespuckerSnapshot *snapshot, const char *authorname, size_t from);
+
+/*
+	Returns the index of the first element at or after from that matches the given date information.
+	ZITATESPUCKER_SNAPSHOT_NONE if there is none.
+	The date information is interpreted like it is by ZitatespuckerSQLGetZitatAllFromFileByDate():
+	month and day are optional (0), year and annodomini are not.
+*/
+size_t ZitatespuckerSnapshotFindByDate(const ZitatespuckerSnapshot *snapshot, bool annodomini, uint16_t year, uint8_t month, uint8_t day, size_t from);
+
+
+#endif
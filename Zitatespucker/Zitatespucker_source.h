@@ -0,0 +1,147 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Backend-independent access to quote sources (header)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+#ifndef ZITATESPUCKER_SOURCE_H
+#define ZITATESPUCKER_SOURCE_H
+
+
+/* Standard headers */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/* Internal headers */
+#include "Zitatespucker_common.h"
+#include "Zitatespucker_count.h"
+
+#ifdef ZITATESPUCKER_SQL
+	#include "Zitatespucker_sqlite.h"
+#endif
+
+
+/* The kind of file a quote source is stored in */
+typedef enum ZitatespuckerSource {
+	ZITATESPUCKER_SOURCE_UNKNOWN = 0, /* Not (yet) known; passing this to a function means "detect it" */
+	ZITATESPUCKER_SOURCE_JSON, /* A .json file with a ZitatespuckerZitat array */
+	ZITATESPUCKER_SOURCE_SQL, /* An SQLite database with a ZitatespuckerZitat table */
+	ZITATESPUCKER_SOURCE_NDJSON, /* A .ndjson (or .jsonl) file with one element per line */
+	ZITATESPUCKER_SOURCE_CSV /* A .csv (or .tsv) file with a header row, read with the default ZitatespuckerCSVOptions */
+} ZitatespuckerSource;
+
+
+/* Externally callable */
+
+/*
+	Guess the kind of source filename is.
+	SQLite databases are recognized by their file header, everything else by its extension or first character.
+	ZITATESPUCKER_SOURCE_UNKNOWN if the file could not be read or recognized.
+
+	This does not check whether the library was built with a backend for the returned kind.
+*/
+ZitatespuckerSource ZitatespuckerSourceDetect(const char *filename);
+
+/*
+	Returns the number of ZitatespuckerZitat elements within filename, using the backend for source.
+	If source is ZITATESPUCKER_SOURCE_UNKNOWN, it is detected with ZitatespuckerSourceDetect().
+	0 if none or an error occured (including the backend not being built).
+*/
+size_t ZitatespuckerSourceGetAmountFromFile(const char *filename, ZitatespuckerSource source);
+
+/*
+	Returns a pointer to the first element in a linked list, read from filename using the backend for source.
+	If source is ZITATESPUCKER_SOURCE_UNKNOWN, it is detected with ZitatespuckerSourceDetect().
+	NULL on error (including the backend not being built).
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFile(const char *filename, ZitatespuckerSource source);
+
+/*
+	Returns a pointer to the first element in a linked list of all elements within the amount files in filenames,
+	in that order. The kind of each file is detected with ZitatespuckerSourceDetect().
+	Duplicates across (and within) the files are handled by ZitatespuckerZitatDedup(), passing on keep, callback and userdata.
+	NULL on error, including any of the files not yielding elements.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFiles(const char *const *filenames, size_t amount, ZitatespuckerDuplicates keep, ZitatespuckerZitatDuplicate callback, void *userdata);
+
+/*
+	Returns a pointer to single populated ZitatespuckerZitat; idx refers to its position within filename.
+	If source is ZITATESPUCKER_SOURCE_UNKNOWN, it is detected with ZitatespuckerSourceDetect().
+	NULL on error (including the backend not being built).
+
+	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatSingleFromFile(const char *filename, ZitatespuckerSource source, const size_t idx);
+
+/*
+	Returns a pointer to the first element in a linked list, filtered by the author given in authorname.
+	If source is ZITATESPUCKER_SOURCE_UNKNOWN, it is detected with ZitatespuckerSourceDetect().
+	NULL on error or if nothing matched. authorname is not optional.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileByAuthor(const char *filename, ZitatespuckerSource source, const char *authorname);
+
+/*
+	Returns a pointer to the first element in a linked list, filtered by the given date information.
+	If source is ZITATESPUCKER_SOURCE_UNKNOWN, it is detected with ZitatespuckerSourceDetect().
+	NULL on error or if nothing matched.
+	The date information is interpreted like it is by ZitatespuckerSQLGetZitatAllFromFileByDate().
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileByDate(const char *filename, ZitatespuckerSource source, bool annodomini, uint16_t year, uint8_t month, uint8_t day);
+
+/*
+	Same as ZitatespuckerSourceGetZitatAllFromFile(), ZitatespuckerSourceGetZitatSingleFromFile(),
+	ZitatespuckerSourceGetZitatAllFromFileByAuthor() and ZitatespuckerSourceGetZitatAllFromFileByDate() respectively,
+	but only the fields within fields are populated (see ZitatespuckerFields).
+*/
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileFields(const char *filename, ZitatespuckerSource source, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatSingleFromFileFields(const char *filename, ZitatespuckerSource source, const size_t idx, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileByAuthorFields(const char *filename, ZitatespuckerSource source, const char *authorname, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileByDateFields(const char *filename, ZitatespuckerSource source, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields);
+
+/*
+	Count the elements within filename that match filter (NULL to count all of them), grouped by group,
+	without loading them (see ZitatespuckerSQLCountFromFile() and ZitatespuckerJSONCountFromFile()).
+	If source is ZITATESPUCKER_SOURCE_UNKNOWN, it is detected with ZitatespuckerSourceDetect().
+	NULL on error (including the backend not being built).
+
+	The returned object must be freed with ZitatespuckerCountsFree().
+*/
+ZitatespuckerCounts *ZitatespuckerSourceCountFromFile(const char *filename, ZitatespuckerSource source, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter);
+
+
+#ifdef ZITATESPUCKER_SQL
+/*
+	Import all elements within filename into the ZitatespuckerZitat table of the database dbname
+	(see ZitatespuckerSQLImportBegin()).
+	.json, .ndjson and .csv sources are streamed element by element, so the whole list is never held in memory at once.
+	false on error (also if any element could not be inserted); stats may be NULL.
+*/
+bool ZitatespuckerSourceImportToSQL(const char *filename, ZitatespuckerSource source, const char *dbname, ZitatespuckerSQLImportStats *stats);
+#endif
+
+
+#endif
@@ -24,11 +24,69 @@
 
 /* Standard headers */
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 
 /* Internal headers */
 #include "Zitatespucker_common.h"
+#include "Zitatespucker_count.h"
+
+
+/* Rows inserted per transaction during an import */
+#define ZITATESPUCKER_SQL_IMPORT_BATCH		100000
+
+/*
+	Tables are only split among several threads if every one of them gets at least this many rows;
+	smaller tables are read on the calling thread.
+*/
+#define ZITATESPUCKER_SQL_SHARD_MIN			50000
+
+/* Upper limit for the number of threads a single table is read with */
+#define ZITATESPUCKER_SQL_MAX_THREADS		64
+
+/* Bytes of the database file each reader of an immutable pool maps into memory */
+#define ZITATESPUCKER_SQL_POOL_MMAP_SIZE	(256 * 1024 * 1024)
+
+
+/*
+	An import into the ZitatespuckerZitat table of a database that is in progress.
+	See ZitatespuckerSQLImportBegin().
+*/
+typedef struct ZitatespuckerSQLImporter ZitatespuckerSQLImporter;
+
+/*
+	A set of read-only connections to one database, for handing each thread a reader of its own.
+	See ZitatespuckerSQLPoolOpen().
+*/
+typedef struct ZitatespuckerSQLPool ZitatespuckerSQLPool;
+
+/*
+	One connection of a ZitatespuckerSQLPool; used by one thread at a time.
+	See ZitatespuckerSQLPoolAcquire().
+*/
+typedef struct ZitatespuckerSQLReader ZitatespuckerSQLReader;
+
+/*
+	One read-only connection with a number of databases attached to it, queried as if they were one.
+	See ZitatespuckerSQLFederationOpen().
+*/
+typedef struct ZitatespuckerSQLFederation ZitatespuckerSQLFederation;
+
+/*
+	Called by ZitatespuckerSQLFederationForEach() for every matching row.
+	Zitat (and the strings it points to) is only valid during the call; copy what you want to keep.
+	Return false to stop early.
+*/
+typedef bool (*ZitatespuckerSQLCallback)(const ZitatespuckerZitat *Zitat, void *userdata);
+
+/* The outcome of an import, see ZitatespuckerSQLImportEnd() */
+typedef struct ZitatespuckerSQLImportStats {
+	size_t rows; /* Rows inserted and committed */
+	size_t failed; /* Elements that could not be inserted, including those of batches that failed to commit */
+	double seconds; /* Time from ZitatespuckerSQLImportBegin() up to and including the creation of the indexes */
+	double rowsPerSecond; /* rows / seconds */
+} ZitatespuckerSQLImportStats;
 
 
 /* Externally callable */
@@ -41,6 +99,15 @@
 */
 size_t ZitatespuckerSQLGetAmountFromFile(const char *filename);
 
+/*
+    Returns a pointer to single populated ZitatespuckerZitat.
+    idx refers to the position of the row within the ZitatespuckerZitat table (in rowid order, starting at 0).
+    NULL on error.
+
+    This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatSingleFromFile(const char *filename, const size_t idx);
+
 /*
     Returns a pointer to the first element in a linked list.
     NULL on error. (Only finding one element in the file is not considered an error.)
@@ -71,5 +138,179 @@ ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByAuthor(const char *file
 */
 ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByDate(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day);
 
+/*
+	Same as ZitatespuckerSQLGetZitatSingleFromFile(), ZitatespuckerSQLGetZitatAllFromFile(),
+	ZitatespuckerSQLGetZitatAllFromFileByAuthor() and ZitatespuckerSQLGetZitatAllFromFileByDate() respectively,
+	but only the fields within fields are populated (see ZitatespuckerFields); the others are neither read nor copied.
+	Only the columns for those fields are selected.
+	Filtering by author or date works regardless of whether those fields are asked for.
+*/
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatSingleFromFileFields(const char *filename, const size_t idx, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileFields(const char *filename, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByAuthorFields(const char *filename, const char *authorname, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByDateFields(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields);
+
+/*
+	Same as ZitatespuckerSQLGetZitatAllFromFileFields(), but the table is split into threads equal ranges of rowids
+	(at most ZITATESPUCKER_SQL_MAX_THREADS), each read on a connection and thread of its own,
+	and the pieces are linked in rowid order. 0 picks as many threads as there are processors,
+	but no more than leave every one of them ZITATESPUCKER_SQL_SHARD_MIN rows.
+*/
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileThreads(const char *filename, ZitatespuckerFields fields, size_t threads);
+
+/*
+	Count the rows that match filter (NULL to count all of them), grouped by group.
+	NULL on error.
+
+	The counting is left to SQLite (GROUP BY and COUNT()), so no row is ever loaded;
+	dates are interpreted the same way as when rows are loaded.
+	The returned object must be freed with ZitatespuckerCountsFree().
+*/
+ZitatespuckerCounts *ZitatespuckerSQLCountFromFile(const char *filename, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter);
+
+
+/*
+	Start a bulk import into the ZitatespuckerZitat table of filename.
+	The database and the table are created if they do not exist yet; existing rows are kept.
+	NULL on error.
+
+	Rows are inserted through a single prepared statement, in transactions of ZITATESPUCKER_SQL_IMPORT_BATCH rows.
+	The indexes on author and date are dropped for the duration of the import and rebuilt once at its end
+	(also if the import fails, for the rows committed until then).
+	The returned importer must be finished with ZitatespuckerSQLImportEnd().
+*/
+ZitatespuckerSQLImporter *ZitatespuckerSQLImportBegin(const char *filename);
+
+/*
+	Insert a copy of Zitat (only this element, the list it might be part of is not followed).
+	false if the row could not be inserted, or it completed a batch that could not be committed; the import can go on regardless.
+*/
+bool ZitatespuckerSQLImportAdd(ZitatespuckerSQLImporter *importer, const ZitatespuckerZitat *Zitat);
+
+/*
+	Same as ZitatespuckerSQLImportAdd(), with importer passed as userdata and always returning true,
+	so it can be passed to ZitatespuckerJSONForEachFromFile() to stream a .json into a database.
+*/
+bool ZitatespuckerSQLImportCallback(const ZitatespuckerZitat *Zitat, void *importer);
+
+/*
+	Commit what is left, build the indexes and close the database. importer is freed in any case.
+	If stats is not NULL, the outcome of the import is stored in it.
+	false if committing or building the indexes failed.
+*/
+bool ZitatespuckerSQLImportEnd(ZitatespuckerSQLImporter *importer, ZitatespuckerSQLImportStats *stats);
+
+/*
+	Import the whole list ZitatList is part of (both directions are followed) into filename,
+	as if by ZitatespuckerSQLImportBegin(), ZitatespuckerSQLImportAdd() for every element and ZitatespuckerSQLImportEnd().
+	false on error (also if any element could not be inserted); stats may be NULL.
+*/
+bool ZitatespuckerSQLImportList(const char *filename, const ZitatespuckerZitat *ZitatList, ZitatespuckerSQLImportStats *stats);
+
+
+/*
+	Open a pool of readers on filename. One reader is opened right away, so a missing or broken database fails here.
+	NULL on error.
+
+	If immutable is true, the file is promised not to change while the pool is open:
+	readers open it with SQLite's immutable flag, which skips all locking and change detection,
+	and map up to ZITATESPUCKER_SQL_POOL_MMAP_SIZE bytes of it into memory instead of reading it through the page cache.
+	Otherwise readers open it like the *FromFile() functions do.
+
+	The returned pool must be closed with ZitatespuckerSQLPoolClose().
+*/
+ZitatespuckerSQLPool *ZitatespuckerSQLPoolOpen(const char *filename, bool immutable);
+
+/*
+	Hand out a reader of pool, reusing an idle one or opening another.
+	Readers do no locking of their own; a reader must only be used by one thread at a time.
+	NULL on error.
+
+	This function is thread-safe. The returned reader must be handed back with ZitatespuckerSQLPoolRelease().
+*/
+ZitatespuckerSQLReader *ZitatespuckerSQLPoolAcquire(ZitatespuckerSQLPool *pool);
+
+/*
+	Hand reader back to its pool, which keeps it open for the next ZitatespuckerSQLPoolAcquire().
+	Passing NULL is a no-op.
+
+	This function is thread-safe.
+*/
+void ZitatespuckerSQLPoolRelease(ZitatespuckerSQLReader *reader);
+
+/*
+	Close pool and its idle readers. Readers that are still acquired are closed as they are released,
+	and the pool is freed along with the last of them.
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerSQLPoolClose(ZitatespuckerSQLPool *pool);
+
+/*
+	Same as ZitatespuckerSQLGetAmountFromFile(), ZitatespuckerSQLGetZitatSingleFromFileFields(), ZitatespuckerSQLGetZitatAllFromFileFields(),
+	ZitatespuckerSQLGetZitatAllFromFileByAuthorFields() and ZitatespuckerSQLGetZitatAllFromFileByDateFields() respectively,
+	but run on the connection of reader instead of opening the file.
+*/
+size_t ZitatespuckerSQLReaderGetAmount(ZitatespuckerSQLReader *reader);
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatSingle(ZitatespuckerSQLReader *reader, const size_t idx, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatAll(ZitatespuckerSQLReader *reader, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatAllByAuthor(ZitatespuckerSQLReader *reader, const char *authorname, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatAllByDate(ZitatespuckerSQLReader *reader, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields);
+
+/*
+	Store the number of rows of the ZitatespuckerZitat table in amount, and their smallest and largest rowid in first and last
+	(which are left as they are if there are no rows).
+	false on error.
+*/
+bool ZitatespuckerSQLReaderGetRowids(ZitatespuckerSQLReader *reader, int64_t *first, int64_t *last, size_t *amount);
+
+/*
+	Returns the row of the ZitatespuckerZitat table with the given rowid, with only the fields within fields populated.
+	NULL on error or if there is no such row, in which case missing (if not NULL) is set to true.
+
+	Unlike ZitatespuckerSQLReaderGetZitatSingle(), which steps over idx rows, this looks up a single rowid,
+	through a statement reader prepares on the first call and keeps for the following ones with the same fields.
+	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
+*/
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatByRowid(ZitatespuckerSQLReader *reader, int64_t rowid, ZitatespuckerFields fields, bool *missing);
+
+
+/*
+	Open the amount databases in filenames read-only and attach them all to a single connection,
+	so each query below is one statement (a UNION ALL over the ZitatespuckerZitat tables of all of them)
+	instead of an open and a statement per file.
+	Every file has to exist and have a ZitatespuckerZitat table.
+	NULL on error, including more files than SQLite can attach to one connection (usually 10, see SQLITE_MAX_ATTACHED).
+
+	Like a reader, a federation must only be used by one thread at a time.
+	The returned federation must be closed with ZitatespuckerSQLFederationClose().
+*/
+ZitatespuckerSQLFederation *ZitatespuckerSQLFederationOpen(const char *const *filenames, size_t amount);
+
+/*
+	Close federation and the databases attached to it.
+	Passing NULL is a no-op.
+*/
+void ZitatespuckerSQLFederationClose(ZitatespuckerSQLFederation *federation);
+
+/*
+	Same as ZitatespuckerSQLReaderGetAmount(), ZitatespuckerSQLReaderGetZitatSingle(), ZitatespuckerSQLReaderGetZitatAll(),
+	ZitatespuckerSQLReaderGetZitatAllByAuthor() and ZitatespuckerSQLReaderGetZitatAllByDate() respectively,
+	but across all databases of federation: the rows of the first file come first, then those of the second and so on,
+	each file in the order a query on it alone would return them. idx counts across files in the same way.
+*/
+size_t ZitatespuckerSQLFederationGetAmount(ZitatespuckerSQLFederation *federation);
+ZitatespuckerZitat *ZitatespuckerSQLFederationGetZitatSingle(ZitatespuckerSQLFederation *federation, const size_t idx, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSQLFederationGetZitatAll(ZitatespuckerSQLFederation *federation, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSQLFederationGetZitatAllByAuthor(ZitatespuckerSQLFederation *federation, const char *authorname, ZitatespuckerFields fields);
+ZitatespuckerZitat *ZitatespuckerSQLFederationGetZitatAllByDate(ZitatespuckerSQLFederation *federation, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields);
+
+/*
+	Hand the rows of federation by authorname (all of them if authorname is NULL) to callback one at a time,
+	in the order ZitatespuckerSQLFederationGetZitatAllByAuthor() would list them, without building a list.
+	Only the fields within fields are populated.
+	Returns the number of rows callback was called for.
+*/
+size_t ZitatespuckerSQLFederationForEach(ZitatespuckerSQLFederation *federation, const char *authorname, ZitatespuckerFields fields, ZitatespuckerSQLCallback callback, void *userdata);
+
 
 #endif
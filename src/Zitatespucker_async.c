@@ -0,0 +1,319 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Loading sources in the background
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_async.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/*
+	Shared between the caller and the thread doing the load; whoever lets go of it last frees it.
+	Everything below lock is guarded by it, the members above are only written before the thread starts.
+*/
+struct ZitatespuckerAsync {
+	bool snapshot; /* true --> load into snapshot, false --> into ZitatList */
+	ZitatespuckerSource source;
+	ZitatespuckerFields fields;
+
+	pthread_mutex_t lock;
+	pthread_cond_t finished;
+	ZitatespuckerAsyncState state;
+	bool cancelled; /* true --> the caller let go; the thread throws away what it loads */
+	unsigned int refcount;
+	ZitatespuckerZitat *ZitatList;
+	ZitatespuckerSnapshot *snapshotResult;
+	ZitatespuckerWarnings warnings; /* Counted by the thread, handed to whoever takes the result */
+	ZitatespuckerError error; /* Why the thread failed, likewise */
+
+	char filename[]; /* the copy of the filename, allocated along with the handle */
+};
+
+
+/* Static function declarations */
+
+/*
+	Allocate a handle for filename and start the thread loading it.
+	NULL on error.
+*/
+static ZitatespuckerAsync *ZitatespuckerAsyncStart(const char *filename, ZitatespuckerSource source, ZitatespuckerFields fields, bool snapshot);
+
+/*
+	What the thread runs; arg is the handle.
+*/
+static void *ZitatespuckerAsyncWorker(void *arg);
+
+/*
+	Returns true if the thread should stop because the caller let go of handle.
+*/
+static bool ZitatespuckerAsyncIsCancelled(ZitatespuckerAsync *handle);
+
+/*
+	Drop one reference to handle, freeing it (and any result nobody took) if it was the last one.
+	Caller must hold the lock, which is released.
+*/
+static void ZitatespuckerAsyncUnref(ZitatespuckerAsync *handle);
+
+
+/* Externally callable */
+
+ZitatespuckerAsync *ZitatespuckerAsyncLoad(const char *filename, ZitatespuckerSource source, ZitatespuckerFields fields)
+{
+	return ZitatespuckerAsyncStart(filename, source, fields, false);
+}
+
+ZitatespuckerAsync *ZitatespuckerAsyncLoadSnapshot(const char *filename, ZitatespuckerSource source)
+{
+	return ZitatespuckerAsyncStart(filename, source, ZITATESPUCKER_FIELD_ALL, true);
+}
+
+ZitatespuckerAsyncState ZitatespuckerAsyncPoll(ZitatespuckerAsync *handle)
+{
+	return ZitatespuckerAsyncWait(handle, 0);
+}
+
+ZitatespuckerAsyncState ZitatespuckerAsyncWait(ZitatespuckerAsync *handle, long timeoutMs)
+{
+	if (handle == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL handle!");
+		return ZITATESPUCKER_ASYNC_FAILED;
+	}
+
+	// pthread_cond_timedwait() wants an absolute time on CLOCK_REALTIME
+	struct timespec deadline;
+	if (timeoutMs > 0) {
+		(void) clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += timeoutMs / 1000;
+		deadline.tv_nsec += (timeoutMs % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L) {
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+	}
+
+	(void) pthread_mutex_lock(&handle->lock);
+	while (handle->state == ZITATESPUCKER_ASYNC_RUNNING && timeoutMs != 0) {
+		if (timeoutMs < 0)
+			(void) pthread_cond_wait(&handle->finished, &handle->lock);
+		else if (pthread_cond_timedwait(&handle->finished, &handle->lock, &deadline) == ETIMEDOUT)
+			break;
+	}
+	ZitatespuckerAsyncState state = handle->state;
+	(void) pthread_mutex_unlock(&handle->lock);
+
+	return state;
+}
+
+ZitatespuckerZitat *ZitatespuckerAsyncTakeList(ZitatespuckerAsync *handle)
+{
+	if (handle == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL handle!");
+		return NULL;
+	}
+	if (handle->snapshot) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "handle loads a snapshot, not a list.");
+		ZitatespuckerAsyncCancel(handle);
+		return NULL;
+	}
+
+	(void) ZitatespuckerAsyncWait(handle, -1);
+
+	(void) pthread_mutex_lock(&handle->lock);
+	ZitatespuckerZitat *ret = handle->ZitatList;
+	handle->ZitatList = NULL;
+	ZitatespuckerWarnings warnings = handle->warnings;
+	ZitatespuckerError error = handle->error;
+	ZitatespuckerAsyncUnref(handle);
+
+	ZitatespuckerDiagAddWarnings(&warnings);
+	if (ret == NULL && error != ZITATESPUCKER_ERROR_NONE)
+		ZITATESPUCKER_REPORT_ERROR(error, __func__, "Loading in the background failed.");
+
+	return ret;
+}
+
+ZitatespuckerSnapshot *ZitatespuckerAsyncTakeSnapshot(ZitatespuckerAsync *handle)
+{
+	if (handle == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL handle!");
+		return NULL;
+	}
+	if (!handle->snapshot) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "handle loads a list, not a snapshot.");
+		ZitatespuckerAsyncCancel(handle);
+		return NULL;
+	}
+
+	(void) ZitatespuckerAsyncWait(handle, -1);
+
+	(void) pthread_mutex_lock(&handle->lock);
+	ZitatespuckerSnapshot *ret = handle->snapshotResult;
+	handle->snapshotResult = NULL;
+	ZitatespuckerWarnings warnings = handle->warnings;
+	ZitatespuckerError error = handle->error;
+	ZitatespuckerAsyncUnref(handle);
+
+	ZitatespuckerDiagAddWarnings(&warnings);
+	if (ret == NULL && error != ZITATESPUCKER_ERROR_NONE)
+		ZITATESPUCKER_REPORT_ERROR(error, __func__, "Loading in the background failed.");
+
+	return ret;
+}
+
+void ZitatespuckerAsyncCancel(ZitatespuckerAsync *handle)
+{
+	if (handle == NULL)
+		return;
+
+	(void) pthread_mutex_lock(&handle->lock);
+	handle->cancelled = true;
+	ZitatespuckerAsyncUnref(handle);
+
+	return;
+}
+
+
+/* Static function definitions */
+
+static ZitatespuckerAsync *ZitatespuckerAsyncStart(const char *filename, ZitatespuckerSource source, ZitatespuckerFields fields, bool snapshot)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	size_t namelen = strlen(filename) + 1;
+	ZitatespuckerAsync *handle;
+	if ((handle = (ZitatespuckerAsync *) malloc(sizeof(ZitatespuckerAsync) + namelen)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	handle->snapshot = snapshot;
+	handle->source = source;
+	handle->fields = fields;
+	handle->state = ZITATESPUCKER_ASYNC_RUNNING;
+	handle->cancelled = false;
+	(void) memset(&handle->warnings, 0, sizeof(handle->warnings));
+	handle->error = ZITATESPUCKER_ERROR_NONE;
+	handle->refcount = 2; // the caller and the thread
+	handle->ZitatList = NULL;
+	handle->snapshotResult = NULL;
+	(void) memcpy(handle->filename, filename, namelen);
+
+	if (pthread_mutex_init(&handle->lock, NULL) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "pthread_mutex_init() failed.");
+		free((void *) handle);
+		return NULL;
+	}
+	if (pthread_cond_init(&handle->finished, NULL) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "pthread_cond_init() failed.");
+		(void) pthread_mutex_destroy(&handle->lock);
+		free((void *) handle);
+		return NULL;
+	}
+
+	// nobody joins the thread; the handle is how the caller learns about it finishing
+	pthread_attr_t attr;
+	pthread_t thread;
+	bool started = false;
+	if (pthread_attr_init(&attr) == 0) {
+		if (pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) == 0)
+			started = (pthread_create(&thread, &attr, ZitatespuckerAsyncWorker, (void *) handle) == 0);
+		(void) pthread_attr_destroy(&attr);
+	}
+	if (!started) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "Could not start a thread.");
+		(void) pthread_cond_destroy(&handle->finished);
+		(void) pthread_mutex_destroy(&handle->lock);
+		free((void *) handle);
+		return NULL;
+	}
+
+	return handle;
+}
+
+static void *ZitatespuckerAsyncWorker(void *arg)
+{
+	ZitatespuckerAsync *handle = (ZitatespuckerAsync *) arg;
+	ZitatespuckerZitat *ZitatList = NULL;
+	ZitatespuckerSnapshot *snapshot = NULL;
+
+	if (!ZitatespuckerAsyncIsCancelled(handle)) {
+		ZitatList = ZitatespuckerSourceGetZitatAllFromFileFields(handle->filename, handle->source, handle->fields);
+
+		// the list is copied into the snapshot, so one more chance to skip that work
+		if (handle->snapshot && ZitatList != NULL) {
+			if (!ZitatespuckerAsyncIsCancelled(handle))
+				snapshot = ZitatespuckerSnapshotFromList(ZitatList);
+			ZitatespuckerZitatFree(ZitatList);
+			ZitatList = NULL;
+		}
+	}
+
+	(void) pthread_mutex_lock(&handle->lock);
+	handle->ZitatList = ZitatList;
+	handle->snapshotResult = snapshot;
+	handle->state = (ZitatList != NULL || snapshot != NULL ? ZITATESPUCKER_ASYNC_DONE : ZITATESPUCKER_ASYNC_FAILED);
+	ZitatespuckerDiagGetWarnings(&handle->warnings);
+	if (handle->state == ZITATESPUCKER_ASYNC_FAILED)
+		handle->error = ZitatespuckerDiagGetLastError();
+	(void) pthread_cond_broadcast(&handle->finished);
+	ZitatespuckerAsyncUnref(handle);
+
+	return NULL;
+}
+
+static bool ZitatespuckerAsyncIsCancelled(ZitatespuckerAsync *handle)
+{
+	(void) pthread_mutex_lock(&handle->lock);
+	bool cancelled = handle->cancelled;
+	(void) pthread_mutex_unlock(&handle->lock);
+
+	return cancelled;
+}
+
+static void ZitatespuckerAsyncUnref(ZitatespuckerAsync *handle)
+{
+	bool last = (--handle->refcount == 0);
+	(void) pthread_mutex_unlock(&handle->lock);
+
+	if (last) {
+		ZitatespuckerZitatFree(handle->ZitatList);
+		ZitatespuckerSnapshotRelease(handle->snapshotResult);
+		(void) pthread_cond_destroy(&handle->finished);
+		(void) pthread_mutex_destroy(&handle->lock);
+		free((void *) handle);
+	}
+
+	return;
+}
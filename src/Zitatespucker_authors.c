@@ -0,0 +1,568 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Prefix and fuzzy author lookup
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+
+#ifdef ZITATESPUCKER_SQL
+/* SQLite headers */
+#include <sqlite3.h>
+#endif
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_authors.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* A word start within the folded names */
+typedef struct ZitatespuckerAuthorKey {
+	const char *word; /* The folded name from the word on */
+	uint32_t author; /* Index of the group within counts */
+} ZitatespuckerAuthorKey;
+
+/* An author found by a fuzzy query */
+typedef struct ZitatespuckerAuthorHit {
+	uint32_t author;
+	unsigned int distance;
+} ZitatespuckerAuthorHit;
+
+struct ZitatespuckerAuthorIndex {
+	char *filename; /* Owned; kept for building lazily */
+	ZitatespuckerSource source;
+	#ifdef ZITATESPUCKER_SQL
+	sqlite3_mutex *lock; /* Guards building an index that is built lazily; NULL for the others */
+	#endif
+	ZitatespuckerCounts *counts; /* The authors grouped and ordered by name; NULL until built */
+	size_t first; /* Index of the first group with an author (the one without comes first) */
+	char *folded; /* Every name case-folded, '\0'-terminated one after the other */
+	size_t longest; /* Length of the longest folded name */
+	size_t keyLen;
+	ZitatespuckerAuthorKey *keys; /* Every word start, ordered by the folded text from there on */
+};
+
+
+/* Static function declarations */
+
+/*
+	Build index from counts (grouped by author), which it takes over (and frees on error).
+	false on error.
+*/
+static bool ZitatespuckerAuthorsLoad(ZitatespuckerAuthorIndex *index, ZitatespuckerCounts *counts);
+
+/*
+	Returns true if the byte c ends a word.
+*/
+static inline bool ZitatespuckerAuthorsIsSeparator(unsigned char c);
+
+/*
+	Returns a case-folded copy of str, reporting errors on behalf of caller.
+	NULL on error.
+*/
+static char *ZitatespuckerAuthorsFold(const char *str, const char *caller);
+
+/*
+	Returns the index of the first key after the idx-th one that does not share its first len bytes.
+*/
+static size_t ZitatespuckerAuthorsRangeEnd(const ZitatespuckerAuthorIndex *index, size_t idx, size_t len);
+
+/*
+	Fill match with the group author of index, found distance edits away.
+*/
+static inline void ZitatespuckerAuthorsMatch(const ZitatespuckerAuthorIndex *index, uint32_t author, unsigned int distance, ZitatespuckerAuthorMatch *match);
+
+/*
+	Append a hit for author to hits (of which len are used and size allocated), growing it as needed.
+	false on error.
+*/
+static bool ZitatespuckerAuthorsHit(ZitatespuckerAuthorHit **hits, size_t *len, size_t *size, uint32_t author, unsigned int distance);
+
+/*
+	qsort() comparators for keys, author indexes and fuzzy hits.
+*/
+static int ZitatespuckerAuthorsCompareKey(const void *a, const void *b);
+static int ZitatespuckerAuthorsCompareId(const void *a, const void *b);
+static int ZitatespuckerAuthorsCompareHit(const void *a, const void *b);
+static int ZitatespuckerAuthorsCompareHitDistance(const void *a, const void *b);
+
+
+/* Externally callable */
+
+ZitatespuckerAuthorIndex *ZitatespuckerAuthorIndexFromList(const ZitatespuckerZitat *ZitatList)
+{
+	ZitatespuckerAuthorIndex *index;
+	if ((index = (ZitatespuckerAuthorIndex *) calloc(1, sizeof(ZitatespuckerAuthorIndex))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "calloc() returned NULL.");
+		return NULL;
+	}
+
+	ZitatespuckerCounts *counts;
+	if ((counts = ZitatespuckerCountFromList(ZitatList, ZITATESPUCKER_GROUP_AUTHOR, NULL)) == NULL || !ZitatespuckerAuthorsLoad(index, counts)) {
+		free((void *) index);
+		return NULL;
+	}
+
+	return index;
+}
+
+ZitatespuckerAuthorIndex *ZitatespuckerAuthorIndexFromFile(const char *filename, ZitatespuckerSource source)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN && (source = ZitatespuckerSourceDetect(filename)) == ZITATESPUCKER_SOURCE_UNKNOWN)
+		return NULL;
+
+	ZitatespuckerAuthorIndex *index;
+	if ((index = (ZitatespuckerAuthorIndex *) calloc(1, sizeof(ZitatespuckerAuthorIndex))) == NULL
+	|| (index->filename = (char *) malloc(strlen(filename) + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "Allocating the index failed.");
+		free((void *) index);
+		return NULL;
+	}
+	(void) strcpy(index->filename, filename);
+	index->source = source;
+
+	// a database answers GROUP BY author without being read as a whole, but there is no need to until asked;
+	// the first queries may come from several threads at once, so building it is done under a lock
+	#ifdef ZITATESPUCKER_SQL
+	if (source == ZITATESPUCKER_SOURCE_SQL) {
+		if ((index->lock = sqlite3_mutex_alloc(SQLITE_MUTEX_FAST)) == NULL) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "sqlite3_mutex_alloc() returned NULL.");
+			ZitatespuckerAuthorIndexFree(index);
+			return NULL;
+		}
+		return index;
+	}
+	#endif
+
+	if (!ZitatespuckerAuthorIndexBuild(index)) {
+		ZitatespuckerAuthorIndexFree(index);
+		return NULL;
+	}
+
+	return index;
+}
+
+bool ZitatespuckerAuthorIndexBuild(ZitatespuckerAuthorIndex *index)
+{
+	if (index == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL index!");
+		return false;
+	}
+
+	// only indexes built lazily have a lock; the others were built before anyone got hold of them
+	#ifdef ZITATESPUCKER_SQL
+	sqlite3_mutex_enter(index->lock);
+	#endif
+	bool ret = (index->counts != NULL);
+	if (!ret) {
+		ZitatespuckerCounts *counts;
+		if ((counts = ZitatespuckerSourceCountFromFile(index->filename, index->source, ZITATESPUCKER_GROUP_AUTHOR, NULL)) != NULL)
+			ret = ZitatespuckerAuthorsLoad(index, counts);
+	}
+	#ifdef ZITATESPUCKER_SQL
+	sqlite3_mutex_leave(index->lock);
+	#endif
+
+	return ret;
+}
+
+size_t ZitatespuckerAuthorIndexGetAmount(ZitatespuckerAuthorIndex *index)
+{
+	if (!ZitatespuckerAuthorIndexBuild(index))
+		return 0;
+
+	return index->counts->len - index->first;
+}
+
+size_t ZitatespuckerAuthorIndexPrefix(ZitatespuckerAuthorIndex *index, const char *prefix, ZitatespuckerAuthorMatch *matches, size_t max)
+{
+	if (prefix == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL prefix!");
+		return 0;
+	} else if (!ZitatespuckerAuthorIndexBuild(index)) {
+		return 0;
+	}
+
+	char *folded;
+	if ((folded = ZitatespuckerAuthorsFold(prefix, __func__)) == NULL)
+		return 0;
+	size_t len = strlen(folded);
+
+	// the keys starting with prefix are a range, beginning with the first key not below prefix
+	size_t lo = 0;
+	size_t hi = index->keyLen;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (strcmp(index->keys[mid].word, folded) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	hi = lo;
+	while (hi < index->keyLen && strncmp(index->keys[hi].word, folded, len) == 0)
+		hi++;
+	free((void *) folded);
+	if (hi == lo)
+		return 0;
+
+	// an author shows up once per matching word
+	uint32_t *ids;
+	if ((ids = (uint32_t *) malloc((hi - lo) * sizeof(uint32_t))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return 0;
+	}
+	for (size_t i = lo; i < hi; i++)
+		ids[i - lo] = index->keys[i].author;
+	qsort(ids, hi - lo, sizeof(uint32_t), ZitatespuckerAuthorsCompareId);
+
+	size_t ret = 0;
+	for (size_t i = 0; i < hi - lo; i++) {
+		if (i > 0 && ids[i] == ids[i - 1])
+			continue;
+		if (ret < max)
+			ZitatespuckerAuthorsMatch(index, ids[i], 0, &matches[ret]);
+		ret++;
+	}
+	free((void *) ids);
+
+	return ret;
+}
+
+size_t ZitatespuckerAuthorIndexFuzzy(ZitatespuckerAuthorIndex *index, const char *query, unsigned int maxDistance, ZitatespuckerAuthorMatch *matches, size_t max)
+{
+	if (query == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL query!");
+		return 0;
+	} else if (maxDistance > ZITATESPUCKER_AUTHORS_MAX_DISTANCE) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "maxDistance %u is larger than %d.", maxDistance, ZITATESPUCKER_AUTHORS_MAX_DISTANCE);
+		return 0;
+	} else if (maxDistance == 0) {
+		return ZitatespuckerAuthorIndexPrefix(index, query, matches, max);
+	} else if (!ZitatespuckerAuthorIndexBuild(index)) {
+		return 0;
+	}
+
+	char *folded;
+	if ((folded = ZitatespuckerAuthorsFold(query, __func__)) == NULL)
+		return 0;
+	size_t len = strlen(folded);
+
+	/*
+		rows[depth] is the row of the edit distance table for the first depth bytes of the current key;
+		rowMin[depth] is its smallest cell, which no deeper row goes below,
+		and best[depth] the smallest distance of the whole query to any of the first 0 to depth bytes.
+	*/
+	size_t width = len + 1;
+	unsigned int *rows = (unsigned int *) malloc((index->longest + 1) * width * sizeof(unsigned int));
+	unsigned int *rowMin = (unsigned int *) malloc((index->longest + 1) * sizeof(unsigned int));
+	unsigned int *best = (unsigned int *) malloc((index->longest + 1) * sizeof(unsigned int));
+	if (rows == NULL || rowMin == NULL || best == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		free((void *) best);
+		free((void *) rowMin);
+		free((void *) rows);
+		free((void *) folded);
+		return 0;
+	}
+	for (size_t j = 0; j < width; j++)
+		rows[j] = (unsigned int) j;
+	rowMin[0] = 0;
+	best[0] = (unsigned int) len;
+
+	ZitatespuckerAuthorHit *hits = NULL;
+	size_t hitLen = 0;
+	size_t hitSize = 0;
+	bool failed = false;
+	const char *prev = "";
+	size_t valid = 0; // rows up to this depth belong to prev
+	for (size_t i = 0; i < index->keyLen && !failed; i++) {
+		const char *key = index->keys[i].word;
+
+		// keys are sorted, so the rows of the beginning shared with the previous key are still there
+		size_t depth = 0;
+		while (depth < valid && key[depth] == prev[depth])
+			depth++;
+
+		while (key[depth] != '\0' && rowMin[depth] <= maxDistance && rowMin[depth] < best[depth]) {
+			const unsigned int *up = &rows[depth * width];
+			unsigned int *row = &rows[(depth + 1) * width];
+			unsigned int min = row[0] = (unsigned int) depth + 1;
+			for (size_t j = 1; j < width; j++) {
+				unsigned int cell = up[j - 1] + (folded[j - 1] != key[depth]);
+				if (up[j] + 1 < cell)
+					cell = up[j] + 1;
+				if (row[j - 1] + 1 < cell)
+					cell = row[j - 1] + 1;
+				row[j] = cell;
+				if (cell < min)
+					min = cell;
+			}
+			rowMin[depth + 1] = min;
+			best[depth + 1] = (row[len] < best[depth] ? row[len] : best[depth]);
+			depth++;
+		}
+		prev = key;
+		valid = depth;
+
+		if (best[depth] <= maxDistance)
+			failed = !ZitatespuckerAuthorsHit(&hits, &hitLen, &hitSize, index->keys[i].author, best[depth]);
+
+		// if going deeper cannot change the outcome, it is the same for every key sharing this beginning
+		if (key[depth] != '\0' && (rowMin[depth] > maxDistance || rowMin[depth] >= best[depth])) {
+			size_t end = ZitatespuckerAuthorsRangeEnd(index, i, depth);
+			if (best[depth] <= maxDistance) {
+				while (!failed && i + 1 < end)
+					failed = !ZitatespuckerAuthorsHit(&hits, &hitLen, &hitSize, index->keys[++i].author, best[depth]);
+			} else {
+				i = end - 1;
+			}
+		}
+	}
+	free((void *) best);
+	free((void *) rowMin);
+	free((void *) rows);
+	free((void *) folded);
+	if (failed || hitLen == 0) {
+		free((void *) hits);
+		return 0;
+	}
+
+	// keep the closest hit per author, then order by distance
+	qsort(hits, hitLen, sizeof(ZitatespuckerAuthorHit), ZitatespuckerAuthorsCompareHit);
+	size_t ret = 0;
+	for (size_t i = 0; i < hitLen; i++) {
+		if (ret > 0 && hits[ret - 1].author == hits[i].author)
+			continue;
+		hits[ret++] = hits[i];
+	}
+	qsort(hits, ret, sizeof(ZitatespuckerAuthorHit), ZitatespuckerAuthorsCompareHitDistance);
+	for (size_t i = 0; i < ret && i < max; i++)
+		ZitatespuckerAuthorsMatch(index, hits[i].author, hits[i].distance, &matches[i]);
+	free((void *) hits);
+
+	return ret;
+}
+
+void ZitatespuckerAuthorIndexFree(ZitatespuckerAuthorIndex *index)
+{
+	if (index == NULL)
+		return;
+
+	free((void *) index->keys);
+	free((void *) index->folded);
+	ZitatespuckerCountsFree(index->counts);
+	free((void *) index->filename);
+	#ifdef ZITATESPUCKER_SQL
+	sqlite3_mutex_free(index->lock);
+	#endif
+	free((void *) index);
+
+	return;
+}
+
+
+/* Static function definitions */
+
+static bool ZitatespuckerAuthorsLoad(ZitatespuckerAuthorIndex *index, ZitatespuckerCounts *counts)
+{
+	size_t first = 0;
+	while (first < counts->len && counts->counts[first].author == NULL)
+		first++;
+
+	size_t bytes = 0;
+	size_t keyLen = 0;
+	for (size_t i = first; i < counts->len; i++) {
+		const unsigned char *author = (const unsigned char *) counts->counts[i].author;
+		bytes += strlen((const char *) author) + 1;
+		for (size_t j = 0; author[j] != '\0'; j++)
+			keyLen += (!ZitatespuckerAuthorsIsSeparator(author[j]) && (j == 0 || ZitatespuckerAuthorsIsSeparator(author[j - 1])));
+	}
+	if (counts->len > UINT32_MAX) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_LIMIT, __func__, "Too many authors.");
+		ZitatespuckerCountsFree(counts);
+		return false;
+	}
+
+	char *folded = (char *) malloc(bytes + 1);
+	ZitatespuckerAuthorKey *keys = (ZitatespuckerAuthorKey *) malloc((keyLen + 1) * sizeof(ZitatespuckerAuthorKey));
+	if (folded == NULL || keys == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		free((void *) keys);
+		free((void *) folded);
+		ZitatespuckerCountsFree(counts);
+		return false;
+	}
+
+	size_t longest = 0;
+	size_t n = 0;
+	char *cur = folded;
+	for (size_t i = first; i < counts->len; i++) {
+		const unsigned char *author = (const unsigned char *) counts->counts[i].author;
+		size_t j = 0;
+		for (; author[j] != '\0'; j++) {
+			cur[j] = (char) tolower(author[j]);
+			if (!ZitatespuckerAuthorsIsSeparator(author[j]) && (j == 0 || ZitatespuckerAuthorsIsSeparator(author[j - 1]))) {
+				keys[n].word = &cur[j];
+				keys[n].author = (uint32_t) i;
+				n++;
+			}
+		}
+		cur[j] = '\0';
+		cur += j + 1;
+		if (j > longest)
+			longest = j;
+	}
+	qsort(keys, keyLen, sizeof(ZitatespuckerAuthorKey), ZitatespuckerAuthorsCompareKey);
+
+	index->counts = counts;
+	index->first = first;
+	index->folded = folded;
+	index->longest = longest;
+	index->keyLen = keyLen;
+	index->keys = keys;
+
+	return true;
+}
+
+static inline bool ZitatespuckerAuthorsIsSeparator(unsigned char c)
+{
+	// bytes of UTF-8 sequences are never separators
+	return (c < 0x80 && (isspace(c) || ispunct(c)));
+}
+
+static char *ZitatespuckerAuthorsFold(const char *str, const char *caller)
+{
+	size_t len = strlen(str);
+	char *ret;
+	if ((ret = (char *) malloc(len + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "malloc() returned NULL.");
+		return NULL;
+	}
+
+	for (size_t i = 0; i <= len; i++)
+		ret[i] = (char) tolower((unsigned char) str[i]);
+
+	return ret;
+}
+
+static size_t ZitatespuckerAuthorsRangeEnd(const ZitatespuckerAuthorIndex *index, size_t idx, size_t len)
+{
+	const char *key = index->keys[idx].word;
+
+	// gallop to a key past the range, then search between the last two steps
+	size_t lo = idx + 1;
+	size_t step = 1;
+	while (lo < index->keyLen && strncmp(index->keys[lo].word, key, len) == 0) {
+		lo += step;
+		step *= 2;
+	}
+	size_t hi = (lo < index->keyLen ? lo : index->keyLen);
+	lo = (step > 1 ? lo - step / 2 + 1 : lo);
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (strncmp(index->keys[mid].word, key, len) == 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+static inline void ZitatespuckerAuthorsMatch(const ZitatespuckerAuthorIndex *index, uint32_t author, unsigned int distance, ZitatespuckerAuthorMatch *match)
+{
+	match->author = index->counts->counts[author].author;
+	match->amount = index->counts->counts[author].amount;
+	match->distance = distance;
+
+	return;
+}
+
+static bool ZitatespuckerAuthorsHit(ZitatespuckerAuthorHit **hits, size_t *len, size_t *size, uint32_t author, unsigned int distance)
+{
+	if (*len == *size) {
+		size_t tmpSize = (*size == 0 ? 64 : *size * 2);
+		ZitatespuckerAuthorHit *tmpHits;
+		if ((tmpHits = (ZitatespuckerAuthorHit *) realloc(*hits, tmpSize * sizeof(ZitatespuckerAuthorHit))) == NULL) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "realloc() returned NULL.");
+			return false;
+		}
+		*hits = tmpHits;
+		*size = tmpSize;
+	}
+
+	(*hits)[*len].author = author;
+	(*hits)[*len].distance = distance;
+	(*len)++;
+
+	return true;
+}
+
+static int ZitatespuckerAuthorsCompareKey(const void *a, const void *b)
+{
+	const ZitatespuckerAuthorKey *keyA = (const ZitatespuckerAuthorKey *) a;
+	const ZitatespuckerAuthorKey *keyB = (const ZitatespuckerAuthorKey *) b;
+
+	int ret = strcmp(keyA->word, keyB->word);
+	if (ret == 0)
+		ret = (keyA->author > keyB->author) - (keyA->author < keyB->author);
+
+	return ret;
+}
+
+static int ZitatespuckerAuthorsCompareId(const void *a, const void *b)
+{
+	uint32_t idA = *(const uint32_t *) a;
+	uint32_t idB = *(const uint32_t *) b;
+
+	return (idA > idB) - (idA < idB);
+}
+
+static int ZitatespuckerAuthorsCompareHit(const void *a, const void *b)
+{
+	const ZitatespuckerAuthorHit *hitA = (const ZitatespuckerAuthorHit *) a;
+	const ZitatespuckerAuthorHit *hitB = (const ZitatespuckerAuthorHit *) b;
+
+	if (hitA->author != hitB->author)
+		return (hitA->author > hitB->author) - (hitA->author < hitB->author);
+
+	return (hitA->distance > hitB->distance) - (hitA->distance < hitB->distance);
+}
+
+static int ZitatespuckerAuthorsCompareHitDistance(const void *a, const void *b)
+{
+	const ZitatespuckerAuthorHit *hitA = (const ZitatespuckerAuthorHit *) a;
+	const ZitatespuckerAuthorHit *hitB = (const ZitatespuckerAuthorHit *) b;
+
+	if (hitA->distance != hitB->distance)
+		return (hitA->distance > hitB->distance) - (hitA->distance < hitB->distance);
+
+	return (hitA->author > hitB->author) - (hitA->author < hitB->author);
+}
@@ -0,0 +1,394 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Process-wide cache of parsed sources
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* st_mtim */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_cache.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* What makes a file "the same file" */
+typedef struct ZitatespuckerCacheIdentity {
+	dev_t dev;
+	ino_t ino;
+	off_t size;
+	time_t mtime;
+	long mtimensec;
+} ZitatespuckerCacheIdentity;
+
+/* A cached (or, if stale, merely still referenced) list */
+typedef struct ZitatespuckerCacheEntry {
+	char *filename;
+	ZitatespuckerSource source;
+	ZitatespuckerCacheIdentity identity;
+	ZitatespuckerZitat *ZitatList;
+	size_t bytes;
+	size_t refcount;
+	bool stale; /* true --> not handed out anymore, freed when refcount drops to 0 */
+	struct ZitatespuckerCacheEntry *nextEntry; /* towards least recently used */
+	struct ZitatespuckerCacheEntry *prevEntry; /* towards most recently used */
+} ZitatespuckerCacheEntry;
+
+
+/* Global state, guarded by ZitatespuckerCacheLock */
+static pthread_mutex_t ZitatespuckerCacheLock = PTHREAD_MUTEX_INITIALIZER;
+static ZitatespuckerCacheEntry *ZitatespuckerCacheHead = NULL; /* most recently used */
+static ZitatespuckerCacheEntry *ZitatespuckerCacheTail = NULL; /* least recently used */
+static ZitatespuckerCacheStats ZitatespuckerCacheCounters = {0};
+
+
+/* Static function declarations */
+
+/*
+	stat() filename into identity.
+	Returns false on error.
+*/
+static bool ZitatespuckerCacheGetIdentity(const char *filename, ZitatespuckerCacheIdentity *identity);
+
+/*
+	Returns true if both identities describe the same file contents.
+*/
+static inline bool ZitatespuckerCacheIdentityEqual(const ZitatespuckerCacheIdentity *a, const ZitatespuckerCacheIdentity *b);
+
+/*
+	Approximate the memory held by ZitatList.
+*/
+static size_t ZitatespuckerCacheListBytes(const ZitatespuckerZitat *ZitatList);
+
+/*
+	Unlink entry from the LRU list. Caller must hold the lock.
+*/
+static void ZitatespuckerCacheUnlink(ZitatespuckerCacheEntry *entry);
+
+/*
+	Link entry in as the most recently used one. Caller must hold the lock.
+*/
+static void ZitatespuckerCacheLinkFront(ZitatespuckerCacheEntry *entry);
+
+/*
+	Take entry out of circulation; frees it right away if it is unreferenced. Caller must hold the lock.
+*/
+static void ZitatespuckerCacheRetire(ZitatespuckerCacheEntry *entry);
+
+/*
+	Free entry and everything it holds. The entry must not be linked anymore.
+*/
+static void ZitatespuckerCacheEntryFree(ZitatespuckerCacheEntry *entry);
+
+/*
+	Evict unreferenced entries (least recently used first) until the limit is met. Caller must hold the lock.
+*/
+static void ZitatespuckerCacheTrim(void);
+
+
+/* Externally callable */
+
+void ZitatespuckerCacheSetLimit(size_t maxBytes)
+{
+	(void) pthread_mutex_lock(&ZitatespuckerCacheLock);
+	ZitatespuckerCacheCounters.limit = maxBytes;
+	ZitatespuckerCacheTrim();
+	(void) pthread_mutex_unlock(&ZitatespuckerCacheLock);
+
+	return;
+}
+
+const ZitatespuckerZitat *ZitatespuckerCacheGetZitatAllFromFile(const char *filename, ZitatespuckerSource source)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	ZitatespuckerCacheIdentity identity;
+	if (!ZitatespuckerCacheGetIdentity(filename, &identity))
+		return NULL;
+
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN)
+		source = ZitatespuckerSourceDetect(filename);
+
+	// fast path: unchanged file
+	(void) pthread_mutex_lock(&ZitatespuckerCacheLock);
+	ZitatespuckerCacheEntry *entry = ZitatespuckerCacheHead;
+	while (entry != NULL) {
+		if (!entry->stale && entry->source == source && strcmp(entry->filename, filename) == 0)
+			break;
+		entry = entry->nextEntry;
+	}
+	if (entry != NULL) {
+		if (ZitatespuckerCacheIdentityEqual(&entry->identity, &identity)) {
+			entry->refcount++;
+			ZitatespuckerCacheCounters.hits++;
+			ZitatespuckerCacheUnlink(entry);
+			ZitatespuckerCacheLinkFront(entry);
+			(void) pthread_mutex_unlock(&ZitatespuckerCacheLock);
+			return entry->ZitatList;
+		} else {
+			// file changed underneath us
+			ZitatespuckerCacheCounters.evictions++;
+			ZitatespuckerCacheRetire(entry);
+		}
+	}
+	ZitatespuckerCacheCounters.misses++;
+	(void) pthread_mutex_unlock(&ZitatespuckerCacheLock);
+
+	// slow path: parse without holding the lock
+	ZitatespuckerZitat *ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filename, source);
+	if (ZitatList == NULL)
+		return NULL;
+
+	if ((entry = (ZitatespuckerCacheEntry *) malloc(sizeof(ZitatespuckerCacheEntry))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		ZitatespuckerZitatFree(ZitatList);
+		return NULL;
+	}
+	entry->filename = NULL;
+	entry->source = source;
+	entry->identity = identity;
+	entry->ZitatList = ZitatList;
+	entry->bytes = ZitatespuckerCacheListBytes(ZitatList);
+	entry->refcount = 1;
+	entry->stale = true;
+	entry->nextEntry = NULL;
+	entry->prevEntry = NULL;
+
+	// only keep it around if the file did not change while we were reading it
+	ZitatespuckerCacheIdentity after;
+	bool cacheable = (ZitatespuckerCacheGetIdentity(filename, &after) && ZitatespuckerCacheIdentityEqual(&identity, &after));
+	if (cacheable) {
+		size_t namelen = strlen(filename) + 1;
+		if ((entry->filename = (char *) malloc(namelen)) != NULL)
+			(void) memcpy(entry->filename, filename, namelen);
+		else
+			cacheable = false;
+	}
+
+	(void) pthread_mutex_lock(&ZitatespuckerCacheLock);
+	if (cacheable && entry->bytes <= ZitatespuckerCacheCounters.limit) {
+		// someone else may have loaded the same file in the meantime; the newer one wins
+		ZitatespuckerCacheEntry *other = ZitatespuckerCacheHead;
+		while (other != NULL) {
+			ZitatespuckerCacheEntry *next = other->nextEntry;
+			if (!other->stale && other->source == source && strcmp(other->filename, filename) == 0)
+				ZitatespuckerCacheRetire(other);
+			other = next;
+		}
+		entry->stale = false;
+		ZitatespuckerCacheCounters.entries++;
+		ZitatespuckerCacheCounters.bytes += entry->bytes;
+		ZitatespuckerCacheTrim();
+	}
+	ZitatespuckerCacheLinkFront(entry);
+	(void) pthread_mutex_unlock(&ZitatespuckerCacheLock);
+
+	return ZitatList;
+}
+
+void ZitatespuckerCacheRelease(const ZitatespuckerZitat *ZitatList)
+{
+	if (ZitatList == NULL)
+		return;
+
+	(void) pthread_mutex_lock(&ZitatespuckerCacheLock);
+	ZitatespuckerCacheEntry *entry = ZitatespuckerCacheHead;
+	while (entry != NULL && entry->ZitatList != ZitatList)
+		entry = entry->nextEntry;
+
+	if (entry == NULL) {
+		(void) pthread_mutex_unlock(&ZitatespuckerCacheLock);
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "list was not obtained from the cache.");
+		return;
+	}
+
+	entry->refcount--;
+	if (entry->refcount == 0 && entry->stale) {
+		ZitatespuckerCacheUnlink(entry);
+		(void) pthread_mutex_unlock(&ZitatespuckerCacheLock);
+		ZitatespuckerCacheEntryFree(entry);
+		return;
+	} else if (entry->refcount == 0) {
+		// the limit may have been lowered while this one was in use
+		ZitatespuckerCacheTrim();
+	}
+	(void) pthread_mutex_unlock(&ZitatespuckerCacheLock);
+
+	return;
+}
+
+void ZitatespuckerCacheClear(void)
+{
+	(void) pthread_mutex_lock(&ZitatespuckerCacheLock);
+	ZitatespuckerCacheEntry *entry = ZitatespuckerCacheHead;
+	while (entry != NULL) {
+		ZitatespuckerCacheEntry *next = entry->nextEntry;
+		if (!entry->stale) {
+			ZitatespuckerCacheCounters.evictions++;
+			ZitatespuckerCacheRetire(entry);
+		}
+		entry = next;
+	}
+	(void) pthread_mutex_unlock(&ZitatespuckerCacheLock);
+
+	return;
+}
+
+void ZitatespuckerCacheGetStats(ZitatespuckerCacheStats *stats)
+{
+	if (stats == NULL)
+		return;
+
+	(void) pthread_mutex_lock(&ZitatespuckerCacheLock);
+	*stats = ZitatespuckerCacheCounters;
+	(void) pthread_mutex_unlock(&ZitatespuckerCacheLock);
+
+	return;
+}
+
+
+/* Static function definitions */
+
+static bool ZitatespuckerCacheGetIdentity(const char *filename, ZitatespuckerCacheIdentity *identity)
+{
+	struct stat st;
+	if (stat(filename, &st) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "stat() failed for \"%s\".", filename);
+		return false;
+	}
+
+	identity->dev = st.st_dev;
+	identity->ino = st.st_ino;
+	identity->size = st.st_size;
+	#ifdef _WIN32
+	identity->mtime = st.st_mtime;
+	identity->mtimensec = 0;
+	#else
+	identity->mtime = st.st_mtim.tv_sec;
+	identity->mtimensec = st.st_mtim.tv_nsec;
+	#endif
+
+	return true;
+}
+
+static inline bool ZitatespuckerCacheIdentityEqual(const ZitatespuckerCacheIdentity *a, const ZitatespuckerCacheIdentity *b)
+{
+	return (a->dev == b->dev && a->ino == b->ino && a->size == b->size && a->mtime == b->mtime && a->mtimensec == b->mtimensec);
+}
+
+static size_t ZitatespuckerCacheListBytes(const ZitatespuckerZitat *ZitatList)
+{
+	size_t ret = 0;
+
+	for ( ; ZitatList != NULL; ZitatList = ZitatList->nextZitat) {
+		ret += sizeof(ZitatespuckerZitat);
+		if (ZitatList->author != NULL)
+			ret += ZitatespuckerZitatGetAuthorLen(ZitatList) + 1;
+		if (ZitatList->zitat != NULL)
+			ret += ZitatespuckerZitatGetZitatLen(ZitatList) + 1;
+		if (ZitatList->comment != NULL)
+			ret += ZitatespuckerZitatGetCommentLen(ZitatList) + 1;
+	}
+
+	return ret;
+}
+
+static void ZitatespuckerCacheUnlink(ZitatespuckerCacheEntry *entry)
+{
+	if (entry->prevEntry != NULL)
+		entry->prevEntry->nextEntry = entry->nextEntry;
+	else if (ZitatespuckerCacheHead == entry)
+		ZitatespuckerCacheHead = entry->nextEntry;
+
+	if (entry->nextEntry != NULL)
+		entry->nextEntry->prevEntry = entry->prevEntry;
+	else if (ZitatespuckerCacheTail == entry)
+		ZitatespuckerCacheTail = entry->prevEntry;
+
+	entry->nextEntry = NULL;
+	entry->prevEntry = NULL;
+
+	return;
+}
+
+static void ZitatespuckerCacheLinkFront(ZitatespuckerCacheEntry *entry)
+{
+	entry->prevEntry = NULL;
+	entry->nextEntry = ZitatespuckerCacheHead;
+	if (ZitatespuckerCacheHead != NULL)
+		ZitatespuckerCacheHead->prevEntry = entry;
+	ZitatespuckerCacheHead = entry;
+	if (ZitatespuckerCacheTail == NULL)
+		ZitatespuckerCacheTail = entry;
+
+	return;
+}
+
+static void ZitatespuckerCacheRetire(ZitatespuckerCacheEntry *entry)
+{
+	if (!entry->stale) {
+		entry->stale = true;
+		ZitatespuckerCacheCounters.entries--;
+		ZitatespuckerCacheCounters.bytes -= entry->bytes;
+	}
+
+	if (entry->refcount == 0) {
+		ZitatespuckerCacheUnlink(entry);
+		ZitatespuckerCacheEntryFree(entry);
+	}
+
+	return;
+}
+
+static void ZitatespuckerCacheEntryFree(ZitatespuckerCacheEntry *entry)
+{
+	ZitatespuckerZitatFree(entry->ZitatList);
+	if (entry->filename != NULL)
+		free((void *) entry->filename);
+	free((void *) entry);
+
+	return;
+}
+
+static void ZitatespuckerCacheTrim(void)
+{
+	ZitatespuckerCacheEntry *entry = ZitatespuckerCacheTail;
+	while (entry != NULL && ZitatespuckerCacheCounters.bytes > ZitatespuckerCacheCounters.limit) {
+		ZitatespuckerCacheEntry *prev = entry->prevEntry;
+		if (!entry->stale && entry->refcount == 0) {
+			ZitatespuckerCacheCounters.evictions++;
+			ZitatespuckerCacheRetire(entry);
+		}
+		entry = prev;
+	}
+
+	return;
+}
@@ -0,0 +1,437 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Client for the zitatespuckerd quote server
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* sockets */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_client.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* Every frame starts with its u32 length */
+#define ZITATESPUCKER_CLIENT_HEADER		4
+
+
+struct ZitatespuckerClient {
+	int fd;
+	uint8_t *buf; /* used for requests and responses alike */
+	size_t bufsize;
+	bool broken; /* a request or response went through only partly, so the stream is out of step */
+};
+
+
+/* Static function declarations */
+
+/*
+	Make sure client->buf can hold at least size bytes.
+	Returns false on error.
+*/
+static bool ZitatespuckerClientReserve(ZitatespuckerClient *client, size_t size);
+
+/*
+	Send the request in client->buf (len bytes, including the length header, which is filled in here)
+	and receive the response into client->buf.
+	Returns the length of the response payload (after the length header), or 0 on error.
+	Errors on the connection mark the client as broken, which every later call fails on.
+*/
+static size_t ZitatespuckerClientTransact(ZitatespuckerClient *client, size_t len);
+
+/*
+	Turn the records of a response payload of len bytes into a linked list.
+	NULL on error or if the response holds no records.
+
+	This function allocates, and the given object/objects must be freed with ZitatespuckerZitatFree().
+*/
+static ZitatespuckerZitat *ZitatespuckerClientParseZitate(const uint8_t *payload, size_t len);
+
+/*
+	Read a protocol string at *pos (bounded by end) into a newly allocated '\0'-terminated string, storing its length in outLen.
+	Returns false if the payload is malformed; *out is NULL for empty strings.
+*/
+static bool ZitatespuckerClientGetString(const uint8_t **pos, const uint8_t *end, char **out, size_t *outLen);
+
+static inline void ZitatespuckerPutU16(uint8_t *dst, uint16_t val);
+static inline void ZitatespuckerPutU32(uint8_t *dst, uint32_t val);
+static inline uint16_t ZitatespuckerGetU16(const uint8_t *src);
+static inline uint32_t ZitatespuckerGetU32(const uint8_t *src);
+
+
+/* Externally callable */
+
+ZitatespuckerClient *ZitatespuckerClientConnect(const char *socketpath)
+{
+	if (socketpath == NULL)
+		socketpath = ZITATESPUCKER_DEFAULT_SOCKET;
+
+	struct sockaddr_un addr;
+	if (strlen(socketpath) >= sizeof(addr.sun_path)) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "socket path \"%s\" is too long.", socketpath);
+		return NULL;
+	}
+	(void) memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	(void) strcpy(addr.sun_path, socketpath);
+
+	ZitatespuckerClient *client;
+	if ((client = (ZitatespuckerClient *) malloc(sizeof(ZitatespuckerClient))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	client->buf = NULL;
+	client->bufsize = 0;
+	client->broken = false;
+
+	if ((client->fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "socket() failed: %s", strerror(errno));
+		free((void *) client);
+		return NULL;
+	}
+
+	if (connect(client->fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "connect() to \"%s\" failed: %s", socketpath, strerror(errno));
+		(void) close(client->fd);
+		free((void *) client);
+		return NULL;
+	}
+
+	if (!ZitatespuckerClientReserve(client, 4096)) {
+		ZitatespuckerClientClose(client);
+		return NULL;
+	}
+
+	return client;
+}
+
+void ZitatespuckerClientClose(ZitatespuckerClient *client)
+{
+	if (client == NULL)
+		return;
+
+	(void) close(client->fd);
+	if (client->buf != NULL)
+		free((void *) client->buf);
+	free((void *) client);
+
+	return;
+}
+
+size_t ZitatespuckerClientGetAmount(ZitatespuckerClient *client)
+{
+	if (client == NULL)
+		return 0;
+
+	client->buf[ZITATESPUCKER_CLIENT_HEADER] = ZITATESPUCKER_OP_COUNT;
+	size_t len;
+	if ((len = ZitatespuckerClientTransact(client, ZITATESPUCKER_CLIENT_HEADER + 1)) < 5 || client->buf[ZITATESPUCKER_CLIENT_HEADER] != ZITATESPUCKER_STATUS_OK)
+		return 0;
+
+	return ZitatespuckerGetU32(client->buf + ZITATESPUCKER_CLIENT_HEADER + 1);
+}
+
+ZitatespuckerZitat *ZitatespuckerClientGetZitatRandom(ZitatespuckerClient *client)
+{
+	if (client == NULL)
+		return NULL;
+
+	client->buf[ZITATESPUCKER_CLIENT_HEADER] = ZITATESPUCKER_OP_RANDOM;
+	size_t len;
+	if ((len = ZitatespuckerClientTransact(client, ZITATESPUCKER_CLIENT_HEADER + 1)) == 0)
+		return NULL;
+
+	return ZitatespuckerClientParseZitate(client->buf + ZITATESPUCKER_CLIENT_HEADER, len);
+}
+
+ZitatespuckerZitat *ZitatespuckerClientGetZitatRange(ZitatespuckerClient *client, uint32_t start, uint32_t amount)
+{
+	if (client == NULL)
+		return NULL;
+
+	uint8_t *req = client->buf + ZITATESPUCKER_CLIENT_HEADER;
+	req[0] = ZITATESPUCKER_OP_RANGE;
+	ZitatespuckerPutU32(req + 1, start);
+	ZitatespuckerPutU32(req + 5, amount);
+	size_t len;
+	if ((len = ZitatespuckerClientTransact(client, ZITATESPUCKER_CLIENT_HEADER + 9)) == 0)
+		return NULL;
+
+	return ZitatespuckerClientParseZitate(client->buf + ZITATESPUCKER_CLIENT_HEADER, len);
+}
+
+ZitatespuckerZitat *ZitatespuckerClientGetZitatAllByAuthor(ZitatespuckerClient *client, const char *authorname, uint32_t maxAmount)
+{
+	if (client == NULL)
+		return NULL;
+	else if (authorname == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL authorname!");
+		return NULL;
+	}
+
+	size_t namelen = strlen(authorname);
+	if (namelen > ZITATESPUCKER_PROTOCOL_MAXFRAME - 16 || !ZitatespuckerClientReserve(client, ZITATESPUCKER_CLIENT_HEADER + 9 + namelen))
+		return NULL;
+
+	uint8_t *req = client->buf + ZITATESPUCKER_CLIENT_HEADER;
+	req[0] = ZITATESPUCKER_OP_BYAUTHOR;
+	ZitatespuckerPutU32(req + 1, maxAmount);
+	ZitatespuckerPutU32(req + 5, (uint32_t) namelen);
+	(void) memcpy(req + 9, authorname, namelen);
+	size_t len;
+	if ((len = ZitatespuckerClientTransact(client, ZITATESPUCKER_CLIENT_HEADER + 9 + namelen)) == 0)
+		return NULL;
+
+	return ZitatespuckerClientParseZitate(client->buf + ZITATESPUCKER_CLIENT_HEADER, len);
+}
+
+ZitatespuckerZitat *ZitatespuckerClientGetZitatAllByDate(ZitatespuckerClient *client, bool annodomini, uint16_t year, uint8_t month, uint8_t day, uint32_t maxAmount)
+{
+	if (client == NULL)
+		return NULL;
+
+	uint8_t *req = client->buf + ZITATESPUCKER_CLIENT_HEADER;
+	req[0] = ZITATESPUCKER_OP_BYDATE;
+	ZitatespuckerPutU32(req + 1, maxAmount);
+	req[5] = (annodomini ? 1 : 0);
+	ZitatespuckerPutU16(req + 6, year);
+	req[8] = month;
+	req[9] = day;
+	size_t len;
+	if ((len = ZitatespuckerClientTransact(client, ZITATESPUCKER_CLIENT_HEADER + 10)) == 0)
+		return NULL;
+
+	return ZitatespuckerClientParseZitate(client->buf + ZITATESPUCKER_CLIENT_HEADER, len);
+}
+
+ZitatespuckerZitat *ZitatespuckerClientGetZitatAllBySearch(ZitatespuckerClient *client, const char *text, uint32_t maxAmount)
+{
+	if (client == NULL)
+		return NULL;
+	else if (text == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL text!");
+		return NULL;
+	}
+
+	size_t textlen = strlen(text);
+	if (textlen > ZITATESPUCKER_PROTOCOL_MAXFRAME - 16 || !ZitatespuckerClientReserve(client, ZITATESPUCKER_CLIENT_HEADER + 9 + textlen))
+		return NULL;
+
+	uint8_t *req = client->buf + ZITATESPUCKER_CLIENT_HEADER;
+	req[0] = ZITATESPUCKER_OP_SEARCH;
+	ZitatespuckerPutU32(req + 1, maxAmount);
+	ZitatespuckerPutU32(req + 5, (uint32_t) textlen);
+	(void) memcpy(req + 9, text, textlen);
+	size_t len;
+	if ((len = ZitatespuckerClientTransact(client, ZITATESPUCKER_CLIENT_HEADER + 9 + textlen)) == 0)
+		return NULL;
+
+	return ZitatespuckerClientParseZitate(client->buf + ZITATESPUCKER_CLIENT_HEADER, len);
+}
+
+
+/* Static function definitions */
+
+static bool ZitatespuckerClientReserve(ZitatespuckerClient *client, size_t size)
+{
+	if (size <= client->bufsize)
+		return true;
+
+	uint8_t *tmp;
+	if ((tmp = (uint8_t *) realloc(client->buf, size)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "realloc() returned NULL.");
+		return false;
+	}
+	client->buf = tmp;
+	client->bufsize = size;
+
+	return true;
+}
+
+static size_t ZitatespuckerClientTransact(ZitatespuckerClient *client, size_t len)
+{
+	if (client->broken) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "connection broke on an earlier request.");
+		return 0;
+	}
+
+	ZitatespuckerPutU32(client->buf, (uint32_t) (len - ZITATESPUCKER_CLIENT_HEADER));
+
+	size_t done = 0;
+	while (done < len) {
+		ssize_t ret = send(client->fd, client->buf + done, len - done, MSG_NOSIGNAL);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		else if (ret <= 0) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "send() failed: %s", strerror(errno));
+			client->broken = true;
+			return 0;
+		}
+		done += (size_t) ret;
+	}
+
+	// header first, then as much as it announced
+	size_t want = ZITATESPUCKER_CLIENT_HEADER;
+	bool haveHeader = false;
+	done = 0;
+	while (done < want) {
+		ssize_t ret = recv(client->fd, client->buf + done, want - done, 0);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		else if (ret <= 0) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "recv() failed or connection closed.");
+			client->broken = true;
+			return 0;
+		}
+		done += (size_t) ret;
+
+		if (!haveHeader && done == ZITATESPUCKER_CLIENT_HEADER) {
+			uint32_t payload = ZitatespuckerGetU32(client->buf);
+			if (payload == 0 || payload > ZITATESPUCKER_PROTOCOL_MAXFRAME) {
+				ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "server sent a malformed response.");
+				client->broken = true;
+				return 0;
+			}
+			want += payload;
+			haveHeader = true;
+			if (!ZitatespuckerClientReserve(client, want)) {
+				client->broken = true;
+				return 0;
+			}
+		}
+	}
+
+	return want - ZITATESPUCKER_CLIENT_HEADER;
+}
+
+static ZitatespuckerZitat *ZitatespuckerClientParseZitate(const uint8_t *payload, size_t len)
+{
+	if (len < 5 || payload[0] != ZITATESPUCKER_STATUS_OK) {
+		if (len >= 1 && payload[0] != ZITATESPUCKER_STATUS_OK)
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "server reported status %u.", (unsigned int) payload[0]);
+		return NULL;
+	}
+
+	uint32_t amount = ZitatespuckerGetU32(payload + 1);
+	const uint8_t *pos = payload + 5;
+	const uint8_t *end = payload + len;
+
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *cur = NULL;
+	for (uint32_t i = 0; i < amount; i++) {
+		if (end - pos < 5) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "server sent a truncated record.");
+			ZitatespuckerZitatFree(ret);
+			return NULL;
+		}
+
+		ZitatespuckerZitat *Zitat;
+		if ((Zitat = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat))) == NULL) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+			ZitatespuckerZitatFree(ret);
+			return NULL;
+		}
+		ZitatespuckerZitatInit(Zitat);
+		if (cur != NULL) {
+			cur->nextZitat = Zitat;
+			Zitat->prevZitat = cur;
+		} else
+			ret = Zitat;
+		cur = Zitat;
+
+		Zitat->day = pos[0];
+		Zitat->month = pos[1];
+		Zitat->year = ZitatespuckerGetU16(pos + 2);
+		Zitat->annodomini = (pos[4] != 0);
+		pos += 5;
+
+		if (!ZitatespuckerClientGetString(&pos, end, &Zitat->author, &Zitat->authorLen)
+		|| !ZitatespuckerClientGetString(&pos, end, &Zitat->zitat, &Zitat->zitatLen)
+		|| !ZitatespuckerClientGetString(&pos, end, &Zitat->comment, &Zitat->commentLen)) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "server sent a truncated record.");
+			ZitatespuckerZitatFree(ret);
+			return NULL;
+		}
+		Zitat->authorHash = ZitatespuckerAuthorHash(Zitat->author, Zitat->authorLen);
+	}
+
+	return ret;
+}
+
+static bool ZitatespuckerClientGetString(const uint8_t **pos, const uint8_t *end, char **out, size_t *outLen)
+{
+	*out = NULL;
+	*outLen = 0;
+	if (end - *pos < 4)
+		return false;
+
+	uint32_t len = ZitatespuckerGetU32(*pos);
+	*pos += 4;
+	if ((size_t) (end - *pos) < len)
+		return false;
+	if (len == 0)
+		return true;
+
+	if ((*out = (char *) malloc((size_t) len + 1)) == NULL)
+		return false;
+	(void) memcpy(*out, *pos, len);
+	(*out)[len] = '\0';
+	*pos += len;
+	// the protocol does not rule out a '\0' within the string, which ends it for everyone else
+	const char *nul = (const char *) memchr(*out, '\0', len);
+	*outLen = (nul != NULL ? (size_t) (nul - *out) : len);
+
+	return true;
+}
+
+static inline void ZitatespuckerPutU16(uint8_t *dst, uint16_t val)
+{
+	dst[0] = (uint8_t) val;
+	dst[1] = (uint8_t) (val >> 8);
+}
+
+static inline void ZitatespuckerPutU32(uint8_t *dst, uint32_t val)
+{
+	dst[0] = (uint8_t) val;
+	dst[1] = (uint8_t) (val >> 8);
+	dst[2] = (uint8_t) (val >> 16);
+	dst[3] = (uint8_t) (val >> 24);
+}
+
+static inline uint16_t ZitatespuckerGetU16(const uint8_t *src)
+{
+	return (uint16_t) (src[0] | (src[1] << 8));
+}
+
+static inline uint32_t ZitatespuckerGetU32(const uint8_t *src)
+{
+	return (uint32_t) src[0] | ((uint32_t) src[1] << 8) | ((uint32_t) src[2] << 16) | ((uint32_t) src[3] << 24);
+}
@@ -27,11 +27,69 @@
 
 
 /* Standard headers */
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 /* Internal headers */
 #include "../Zitatespucker/Zitatespucker_common.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/*
+	Bits sorted per pass by ZitatespuckerZitatSortByDate(); it keeps two arrays of 1 << ZITATESPUCKER_SORT_RADIXBITS pointers on the stack.
+	Smaller on 32-bit targets, which tend to have little stack (like the DS).
+*/
+#ifndef ZITATESPUCKER_SORT_RADIXBITS
+	#if UINTPTR_MAX > 0xFFFFFFFFu
+		#define ZITATESPUCKER_SORT_RADIXBITS	11
+	#else
+		#define ZITATESPUCKER_SORT_RADIXBITS	8
+	#endif
+#endif
+
+
+/* A slot of the hash table of ZitatespuckerZitatDedup() */
+typedef struct ZitatespuckerZitatDedupSlot {
+	uint64_t hash;
+	ZitatespuckerZitat *Zitat; /* The element currently kept; NULL if the slot is free */
+} ZitatespuckerZitatDedupSlot;
+
+
+/* Static function declarations */
+
+/*
+	Returns the date of Zitat as a single number that orders like ZitatespuckerZitatCompareByDate() does.
+	Only the lower 26 bits are used: 17 for era and year, 4 for the month and 5 for the day.
+*/
+static inline uint32_t ZitatespuckerZitatDateKey(const ZitatespuckerZitat *Zitat);
+
+/*
+	Set the prevZitat pointers along the nextZitat pointers, starting at ZitatList (which becomes the first element).
+*/
+static void ZitatespuckerZitatRelink(ZitatespuckerZitat *ZitatList);
+
+/*
+	Returns the next char of the whitespace-normalized string *cur points into, -1 at its end.
+	*cur must have been advanced past leading whitespace first (see ZitatespuckerZitatNormStart()).
+*/
+static inline int ZitatespuckerZitatNormNext(const unsigned char **cur);
+
+/*
+	Returns where the whitespace-normalized version of str starts; NULL counts as an empty string.
+*/
+static inline const unsigned char *ZitatespuckerZitatNormStart(const char *str);
+
+/*
+	Returns whether a and b are duplicates in the sense of ZitatespuckerZitatDedup().
+*/
+static bool ZitatespuckerZitatSame(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b);
+
+/*
+	Take Zitat out of its list and free it, updating *first if it was the first element.
+*/
+static void ZitatespuckerZitatDrop(ZitatespuckerZitat **first, ZitatespuckerZitat *Zitat);
 
 
 /* Common functions */
@@ -61,10 +119,84 @@ void ZitatespuckerZitatInit(ZitatespuckerZitat *ZitatToInit)
 	ZitatToInit->annodomini = false;
 	ZitatToInit->nextZitat = NULL;
 	ZitatToInit->prevZitat = NULL;
+	ZitatToInit->authorLen = 0;
+	ZitatToInit->zitatLen = 0;
+	ZitatToInit->commentLen = 0;
+	ZitatToInit->authorHash = 0;
+
+	return;
+}
+
+void ZitatespuckerZitatSetLengths(ZitatespuckerZitat *Zitat)
+{
+	if (Zitat == NULL)
+		return;
+
+	Zitat->authorLen = (Zitat->author != NULL ? strlen(Zitat->author) : 0);
+	Zitat->zitatLen = (Zitat->zitat != NULL ? strlen(Zitat->zitat) : 0);
+	Zitat->commentLen = (Zitat->comment != NULL ? strlen(Zitat->comment) : 0);
+	Zitat->authorHash = ZitatespuckerAuthorHash(Zitat->author, Zitat->authorLen);
 
 	return;
 }
 
+size_t ZitatespuckerZitatGetAuthorLen(const ZitatespuckerZitat *Zitat)
+{
+	if (Zitat->authorLen != 0 || Zitat->author == NULL)
+		return Zitat->authorLen;
+
+	return strlen(Zitat->author);
+}
+
+size_t ZitatespuckerZitatGetZitatLen(const ZitatespuckerZitat *Zitat)
+{
+	if (Zitat->zitatLen != 0 || Zitat->zitat == NULL)
+		return Zitat->zitatLen;
+
+	return strlen(Zitat->zitat);
+}
+
+size_t ZitatespuckerZitatGetCommentLen(const ZitatespuckerZitat *Zitat)
+{
+	if (Zitat->commentLen != 0 || Zitat->comment == NULL)
+		return Zitat->commentLen;
+
+	return strlen(Zitat->comment);
+}
+
+uint64_t ZitatespuckerZitatGetAuthorHash(const ZitatespuckerZitat *Zitat)
+{
+	if (Zitat->authorHash != 0 || Zitat->author == NULL)
+		return Zitat->authorHash;
+
+	return ZitatespuckerAuthorHash(Zitat->author, ZitatespuckerZitatGetAuthorLen(Zitat));
+}
+
+uint64_t ZitatespuckerAuthorHash(const char *author, size_t len)
+{
+	if (author == NULL)
+		return 0;
+
+	// FNV-1a, like ZitatespuckerZitatHash(), but over the bytes as they are
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < len; i++)
+		hash = (hash ^ (unsigned char) author[i]) * 1099511628211ULL;
+
+	// 0 is kept for "not known"
+	return (hash != 0 ? hash : 1);
+}
+
+bool ZitatespuckerZitatIsByAuthor(const ZitatespuckerZitat *Zitat, const char *authorname, size_t len, uint64_t hash)
+{
+	if (Zitat->author == NULL || authorname == NULL)
+		return false;
+
+	if (Zitat->authorHash != 0 && hash != 0 && Zitat->authorHash != hash)
+		return false;
+
+	return (ZitatespuckerZitatGetAuthorLen(Zitat) == len && memcmp(Zitat->author, authorname, len) == 0);
+}
+
 void ZitatespuckerZitatFree(ZitatespuckerZitat *ZitatToFree)
 {
 	if (ZitatToFree == NULL)
@@ -92,12 +224,9 @@ void ZitatespuckerZitatFreeNextOnly(ZitatespuckerZitat *ZitatToFree)
 		if (ZitatToFree->comment != NULL)
 			free((void *) ZitatToFree->comment);
 		
-		if (ZitatToFree->nextZitat != NULL) {
-			next = ZitatToFree->nextZitat;
-			free((void *) ZitatToFree);
-			ZitatToFree = next;
-		} else
-			break;
+		next = ZitatToFree->nextZitat;
+		free((void *) ZitatToFree);
+		ZitatToFree = next;
 	}
 
 	return;
@@ -117,12 +246,9 @@ void ZitatespuckerZitatFreePrevOnly(ZitatespuckerZitat *ZitatToFree)
 		if (ZitatToFree->comment != NULL)
 			free((void *) ZitatToFree->comment);
 		
-		if (ZitatToFree->prevZitat != NULL) {
-			prev = ZitatToFree->prevZitat;
-			free((void *) ZitatToFree);
-			ZitatToFree = prev;
-		} else
-			break;
+		prev = ZitatToFree->prevZitat;
+		free((void *) ZitatToFree);
+		ZitatToFree = prev;
 	}
 
 	return;
@@ -144,3 +270,342 @@ size_t ZitatespuckerZitatListLen(ZitatespuckerZitat *ZitatList)
 	
 	return ret;
 }
+
+ZitatespuckerZitat *ZitatespuckerZitatSort(ZitatespuckerZitat *ZitatList, ZitatespuckerZitatCompare compare, void *userdata)
+{
+	if (ZitatList == NULL)
+		return NULL;
+
+	while (ZitatList->prevZitat != NULL)
+		ZitatList = ZitatList->prevZitat;
+
+	if (compare == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL compare!");
+		return ZitatList;
+	}
+
+	// bottom-up merge sort over the nextZitat pointers: runs of insize elements are merged pairwise, doubling insize each time
+	ZitatespuckerZitat *head = ZitatList;
+	for (size_t insize = 1; ; insize *= 2) {
+		ZitatespuckerZitat *p = head;
+		ZitatespuckerZitat *tail = NULL;
+		size_t merges = 0;
+		head = NULL;
+
+		while (p != NULL) {
+			merges++;
+			ZitatespuckerZitat *q = p;
+			size_t psize = 0;
+			for (size_t i = 0; i < insize && q != NULL; i++) {
+				psize++;
+				q = q->nextZitat;
+			}
+			size_t qsize = insize;
+
+			while (psize > 0 || (qsize > 0 && q != NULL)) {
+				ZitatespuckerZitat *e;
+				// taking from p on equality is what makes this stable
+				if (psize == 0) {
+					e = q;
+					q = q->nextZitat;
+					qsize--;
+				} else if (qsize == 0 || q == NULL || compare(p, q, userdata) <= 0) {
+					e = p;
+					p = p->nextZitat;
+					psize--;
+				} else {
+					e = q;
+					q = q->nextZitat;
+					qsize--;
+				}
+
+				if (tail != NULL)
+					tail->nextZitat = e;
+				else
+					head = e;
+				tail = e;
+			}
+			p = q;
+		}
+		tail->nextZitat = NULL;
+
+		if (merges <= 1)
+			break;
+	}
+
+	ZitatespuckerZitatRelink(head);
+
+	return head;
+}
+
+ZitatespuckerZitat *ZitatespuckerZitatSortByDate(ZitatespuckerZitat *ZitatList)
+{
+	if (ZitatList == NULL)
+		return NULL;
+
+	while (ZitatList->prevZitat != NULL)
+		ZitatList = ZitatList->prevZitat;
+
+	// only the range of keys that actually occurs needs sorting, which usually saves a pass or two
+	uint32_t minKey = UINT32_MAX;
+	uint32_t maxKey = 0;
+	for (ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat) {
+		uint32_t key = ZitatespuckerZitatDateKey(cur);
+		if (key < minKey)
+			minKey = key;
+		if (key > maxKey)
+			maxKey = key;
+	}
+	unsigned int bits = 0;
+	while (bits < 32 && ((maxKey - minKey) >> bits) != 0)
+		bits++;
+	if (bits == 0)
+		return ZitatList;
+
+	// LSD radix sort in as few passes as possible (each one walks the whole list); appending to the buckets keeps it stable
+	unsigned int passes = (bits + ZITATESPUCKER_SORT_RADIXBITS - 1) / ZITATESPUCKER_SORT_RADIXBITS;
+	unsigned int width = (bits + passes - 1) / passes;
+	uint32_t mask = (1u << width) - 1;
+	ZitatespuckerZitat *bucketHead[1u << ZITATESPUCKER_SORT_RADIXBITS];
+	ZitatespuckerZitat *bucketTail[1u << ZITATESPUCKER_SORT_RADIXBITS];
+	ZitatespuckerZitat *head = ZitatList;
+	for (unsigned int shift = 0; shift < passes * width; shift += width) {
+		(void) memset(bucketHead, 0, (mask + 1) * sizeof(ZitatespuckerZitat *));
+		for (ZitatespuckerZitat *cur = head, *next; cur != NULL; cur = next) {
+			next = cur->nextZitat;
+			uint32_t digit = ((ZitatespuckerZitatDateKey(cur) - minKey) >> shift) & mask;
+			if (bucketHead[digit] != NULL)
+				bucketTail[digit]->nextZitat = cur;
+			else
+				bucketHead[digit] = cur;
+			bucketTail[digit] = cur;
+		}
+
+		ZitatespuckerZitat *tail = NULL;
+		for (uint32_t digit = 0; digit <= mask; digit++) {
+			if (bucketHead[digit] == NULL)
+				continue;
+			if (tail != NULL)
+				tail->nextZitat = bucketHead[digit];
+			else
+				head = bucketHead[digit];
+			tail = bucketTail[digit];
+		}
+		tail->nextZitat = NULL;
+	}
+
+	ZitatespuckerZitatRelink(head);
+
+	return head;
+}
+
+ZitatespuckerZitat *ZitatespuckerZitatSortByAuthor(ZitatespuckerZitat *ZitatList)
+{
+	return ZitatespuckerZitatSort(ZitatList, ZitatespuckerZitatCompareByAuthor, NULL);
+}
+
+int ZitatespuckerZitatCompareByDate(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b, void *userdata)
+{
+	uint32_t keyA = ZitatespuckerZitatDateKey(a);
+	uint32_t keyB = ZitatespuckerZitatDateKey(b);
+
+	return (keyA > keyB) - (keyA < keyB);
+}
+
+int ZitatespuckerZitatCompareByAuthor(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b, void *userdata)
+{
+	if (a->author == NULL || b->author == NULL)
+		return (a->author != NULL) - (b->author != NULL);
+
+	// orders like strcmp(), as the strings hold no '\0' before their end
+	size_t lenA = ZitatespuckerZitatGetAuthorLen(a);
+	size_t lenB = ZitatespuckerZitatGetAuthorLen(b);
+	int ret = memcmp(a->author, b->author, (lenA < lenB ? lenA : lenB));
+	if (ret != 0)
+		return ret;
+
+	return (lenA > lenB) - (lenA < lenB);
+}
+
+
+ZitatespuckerZitat *ZitatespuckerZitatDedup(ZitatespuckerZitat *ZitatList, ZitatespuckerDuplicates keep, ZitatespuckerZitatDuplicate callback, void *userdata, size_t *duplicates)
+{
+	if (ZitatList == NULL) {
+		if (duplicates != NULL)
+			*duplicates = 0;
+		return NULL;
+	}
+
+	while (ZitatList->prevZitat != NULL)
+		ZitatList = ZitatList->prevZitat;
+
+	// open addressing, at most half full; a slot holds the element that is currently kept
+	size_t len = ZitatespuckerZitatListLen(ZitatList);
+	size_t size = 16;
+	while (size < len * 2)
+		size *= 2;
+
+	ZitatespuckerZitatDedupSlot *slots;
+	if ((slots = (ZitatespuckerZitatDedupSlot *) calloc(size, sizeof(ZitatespuckerZitatDedupSlot))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "calloc() returned NULL.");
+		return NULL;
+	}
+
+	size_t found = 0;
+	ZitatespuckerZitat *next;
+	for (ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = next) {
+		next = cur->nextZitat;
+
+		uint64_t hash = ZitatespuckerZitatHash(cur);
+		size_t i = (size_t) hash & (size - 1);
+		while (slots[i].Zitat != NULL && (slots[i].hash != hash || !ZitatespuckerZitatSame(slots[i].Zitat, cur)))
+			i = (i + 1) & (size - 1);
+
+		if (slots[i].Zitat == NULL) {
+			slots[i].hash = hash;
+			slots[i].Zitat = cur;
+			continue;
+		}
+
+		found++;
+		switch (keep) {
+			case ZITATESPUCKER_DUPLICATES_KEEP_LAST:
+				if (callback != NULL)
+					callback(cur, slots[i].Zitat, userdata);
+				ZitatespuckerZitatDrop(&ZitatList, slots[i].Zitat);
+				slots[i].Zitat = cur;
+				break;
+			case ZITATESPUCKER_DUPLICATES_REPORT:
+				if (callback != NULL)
+					callback(slots[i].Zitat, cur, userdata);
+				break;
+			default:
+				if (callback != NULL)
+					callback(slots[i].Zitat, cur, userdata);
+				ZitatespuckerZitatDrop(&ZitatList, cur);
+				break;
+		}
+	}
+	free((void *) slots);
+
+	if (duplicates != NULL)
+		*duplicates = found;
+
+	return ZitatList;
+}
+
+uint64_t ZitatespuckerZitatHash(const ZitatespuckerZitat *Zitat)
+{
+	// FNV-1a over the normalized author, a separator, the normalized quote and the date
+	uint64_t hash = 14695981039346656037ULL;
+	const char *strings[2] = {Zitat->author, Zitat->zitat};
+	for (int i = 0; i < 2; i++) {
+		const unsigned char *cur = ZitatespuckerZitatNormStart(strings[i]);
+		int c;
+		while ((c = ZitatespuckerZitatNormNext(&cur)) >= 0)
+			hash = (hash ^ (uint64_t) c) * 1099511628211ULL;
+		hash = (hash ^ 0xFFu) * 1099511628211ULL;
+	}
+
+	uint64_t date = ((uint64_t) Zitat->year << 24) | ((uint64_t) Zitat->month << 16) | ((uint64_t) Zitat->day << 8) | (Zitat->annodomini ? 1u : 0u);
+	for (int i = 0; i < 5; i++, date >>= 8)
+		hash = (hash ^ (date & 0xFFu)) * 1099511628211ULL;
+
+	return hash;
+}
+
+
+/* Static function definitions */
+
+static inline uint32_t ZitatespuckerZitatDateKey(const ZitatespuckerZitat *Zitat)
+{
+	// 0 for invalid dates, 1 to 0xFFFF for 65535 BC to 1 BC, 0x10000 and up for AD
+	uint32_t era;
+	if (Zitat->annodomini)
+		era = 0x10000u + Zitat->year;
+	else if (Zitat->year == 0)
+		era = 0;
+	else
+		era = 0x10000u - Zitat->year;
+
+	uint32_t month = (Zitat->month > 12 ? 12 : Zitat->month);
+	uint32_t day = (Zitat->day > 31 ? 31 : Zitat->day);
+
+	return (era << 9) | (month << 5) | day;
+}
+
+static void ZitatespuckerZitatRelink(ZitatespuckerZitat *ZitatList)
+{
+	ZitatespuckerZitat *prev = NULL;
+	for (ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat) {
+		cur->prevZitat = prev;
+		prev = cur;
+	}
+
+	return;
+}
+
+static inline int ZitatespuckerZitatNormNext(const unsigned char **cur)
+{
+	const unsigned char *c = *cur;
+	if (*c == '\0')
+		return -1;
+
+	if (*c == ' ' || (*c >= '\t' && *c <= '\r')) {
+		// a run of whitespace becomes a single space, unless it is trailing
+		while (*c == ' ' || (*c >= '\t' && *c <= '\r'))
+			c++;
+		*cur = c;
+		return (*c == '\0' ? -1 : ' ');
+	}
+
+	*cur = c + 1;
+
+	return *c;
+}
+
+static inline const unsigned char *ZitatespuckerZitatNormStart(const char *str)
+{
+	const unsigned char *c = (const unsigned char *) (str != NULL ? str : "");
+	while (*c == ' ' || (*c >= '\t' && *c <= '\r'))
+		c++;
+
+	return c;
+}
+
+static bool ZitatespuckerZitatSame(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b)
+{
+	if (a->year != b->year || a->month != b->month || a->day != b->day || a->annodomini != b->annodomini)
+		return false;
+
+	const char *stringsA[2] = {a->author, a->zitat};
+	const char *stringsB[2] = {b->author, b->zitat};
+	for (int i = 0; i < 2; i++) {
+		const unsigned char *curA = ZitatespuckerZitatNormStart(stringsA[i]);
+		const unsigned char *curB = ZitatespuckerZitatNormStart(stringsB[i]);
+		int c;
+		do {
+			c = ZitatespuckerZitatNormNext(&curA);
+			if (c != ZitatespuckerZitatNormNext(&curB))
+				return false;
+		} while (c >= 0);
+	}
+
+	return true;
+}
+
+static void ZitatespuckerZitatDrop(ZitatespuckerZitat **first, ZitatespuckerZitat *Zitat)
+{
+	if (Zitat->prevZitat != NULL)
+		Zitat->prevZitat->nextZitat = Zitat->nextZitat;
+	else
+		*first = Zitat->nextZitat;
+	if (Zitat->nextZitat != NULL)
+		Zitat->nextZitat->prevZitat = Zitat->prevZitat;
+
+	Zitat->prevZitat = NULL;
+	Zitat->nextZitat = NULL;
+	ZitatespuckerZitatFreeNextOnly(Zitat);
+
+	return;
+}
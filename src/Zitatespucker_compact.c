@@ -0,0 +1,499 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Compressed read-only quote lists
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_compact.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/*
+	No code is longer than this many bits, so a single lookup in a table of 1 << ZITATESPUCKER_COMPACT_MAXBITS
+	entries decodes one byte. 11 bits keep the table at 4 KiB, which matters on the DS.
+*/
+#define ZITATESPUCKER_COMPACT_MAXBITS	11
+#define ZITATESPUCKER_COMPACT_TABLESIZE	(1u << ZITATESPUCKER_COMPACT_MAXBITS)
+
+/* Marks an absent string within ZitatespuckerCompactEntry */
+#define ZITATESPUCKER_COMPACT_ABSENT	UINT32_MAX
+
+/* The bit stream is followed by this many zero bytes, so the decoder may always read a whole uint64_t ahead */
+#define ZITATESPUCKER_COMPACT_PADDING	8
+
+
+typedef struct ZitatespuckerCompactEntry {
+	uint32_t zitatBit; /* Position of the quote within the bit stream */
+	uint32_t zitatLen; /* Decoded length of the quote, or ZITATESPUCKER_COMPACT_ABSENT */
+	uint32_t commentBit;
+	uint32_t commentLen;
+	uint32_t author; /* Offset into the author pool, or ZITATESPUCKER_COMPACT_ABSENT */
+	uint16_t year;
+	uint8_t day;
+	uint8_t month;
+	bool annodomini;
+} ZitatespuckerCompactEntry;
+
+/*
+	Layout: this struct, followed by len ZitatespuckerCompactEntry, the decoding table,
+	the author pool and finally the bit stream.
+*/
+struct ZitatespuckerCompact {
+	size_t len;
+	size_t size; /* Of the whole allocation */
+	size_t textBytes;
+	size_t packedBytes;
+	size_t listBytes;
+	const ZitatespuckerCompactEntry *entries;
+	const uint16_t *table; /* (byte << 4) | code length, indexed by the next ZITATESPUCKER_COMPACT_MAXBITS bits */
+	const char *authors;
+	const uint8_t *stream;
+};
+
+/* Used while building only */
+typedef struct ZitatespuckerCompactWriter {
+	uint8_t *out;
+	size_t pos; /* In bits */
+} ZitatespuckerCompactWriter;
+
+
+/* Static function declarations */
+
+/*
+	Compute code lengths for the byte frequencies in freq, none longer than ZITATESPUCKER_COMPACT_MAXBITS.
+	Bytes that do not occur get length 0.
+*/
+static void ZitatespuckerCompactBuildLengths(const size_t freq[256], uint8_t lens[256]);
+
+/*
+	Assign canonical codes to lens and fill table with them.
+*/
+static void ZitatespuckerCompactBuildCodes(const uint8_t lens[256], uint16_t codes[256], uint16_t *table);
+
+/*
+	Append str (len bytes) to the bit stream.
+*/
+static void ZitatespuckerCompactWrite(ZitatespuckerCompactWriter *writer, const uint8_t lens[256], const uint16_t codes[256], const char *str, size_t len);
+
+/*
+	Decode len bytes starting at bit into buf, following the ZitatespuckerCompactGetZitat() conventions.
+*/
+static size_t ZitatespuckerCompactDecode(const ZitatespuckerCompact *compact, uint32_t bit, uint32_t len, char *buf, size_t buflen);
+
+/*
+	Returns the offset of the author of Zitat (which has one) within the author pool, adding it if it is not there yet.
+	hash has hashsize (a power of two) slots of pool offsets, ZITATESPUCKER_COMPACT_ABSENT when empty.
+*/
+static uint32_t ZitatespuckerCompactAuthor(char *pool, size_t *poolused, uint32_t *hash, size_t hashsize, const ZitatespuckerZitat *Zitat);
+
+
+/* Externally callable */
+
+ZitatespuckerCompact *ZitatespuckerCompactFromList(const ZitatespuckerZitat *ZitatList)
+{
+	if (ZitatList == NULL)
+		return NULL;
+
+	while (ZitatList->prevZitat != NULL)
+		ZitatList = ZitatList->prevZitat;
+
+	// first pass: train the code and size everything
+	size_t freq[256] = {0};
+	size_t len = 0;
+	size_t textBytes = 0;
+	size_t authorBytes = 0;
+	size_t listBytes = 0;
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat) {
+		len++;
+		listBytes += sizeof(ZitatespuckerZitat);
+		const char *texts[2] = {cur->zitat, cur->comment};
+		for (int t = 0; t < 2; t++) {
+			if (texts[t] == NULL)
+				continue;
+			const unsigned char *c = (const unsigned char *) texts[t];
+			for (; *c != '\0'; c++)
+				freq[*c]++;
+			textBytes += (size_t) ((const char *) c - texts[t]) + 1;
+		}
+		if (cur->author != NULL)
+			authorBytes += ZitatespuckerZitatGetAuthorLen(cur) + 1;
+	}
+	listBytes += textBytes + authorBytes;
+
+	uint8_t lens[256];
+	uint16_t codes[256];
+	uint16_t table[ZITATESPUCKER_COMPACT_TABLESIZE];
+	ZitatespuckerCompactBuildLengths(freq, lens);
+	ZitatespuckerCompactBuildCodes(lens, codes, table);
+
+	size_t bits = 0;
+	for (int i = 0; i < 256; i++)
+		bits += freq[i] * lens[i];
+	size_t packedBytes = (bits + 7) / 8;
+	if (bits > UINT32_MAX || textBytes > UINT32_MAX || authorBytes > UINT32_MAX) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_LIMIT, __func__, "List is too large to be compacted.");
+		return NULL;
+	}
+
+	// the author pool is deduplicated through a temporary hash table, so it ends up being at most authorBytes
+	size_t hashsize = 16;
+	while (hashsize < len * 2)
+		hashsize *= 2;
+	uint32_t *hash;
+	char *pool;
+	if ((hash = (uint32_t *) malloc(hashsize * sizeof(uint32_t))) == NULL || (pool = (char *) malloc(authorBytes + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		free((void *) hash);
+		return NULL;
+	}
+	(void) memset(hash, 0xFF, hashsize * sizeof(uint32_t));
+	size_t poolused = 0;
+
+	size_t size = sizeof(ZitatespuckerCompact) + len * sizeof(ZitatespuckerCompactEntry) + sizeof(table) + authorBytes + packedBytes + ZITATESPUCKER_COMPACT_PADDING;
+	ZitatespuckerCompact *compact;
+	if ((compact = (ZitatespuckerCompact *) malloc(size)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		free((void *) pool);
+		free((void *) hash);
+		return NULL;
+	}
+	ZitatespuckerCompactEntry *entries = (ZitatespuckerCompactEntry *) (compact + 1);
+
+	// second pass: encode
+	ZitatespuckerCompactWriter writer;
+	writer.out = (uint8_t *) (entries + len) + sizeof(table) + authorBytes;
+	writer.pos = 0;
+	(void) memset(writer.out, 0, packedBytes + ZITATESPUCKER_COMPACT_PADDING);
+
+	size_t i = 0;
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat, i++) {
+		ZitatespuckerCompactEntry *entry = &entries[i];
+		entry->zitatBit = (uint32_t) writer.pos;
+		entry->zitatLen = ZITATESPUCKER_COMPACT_ABSENT;
+		if (cur->zitat != NULL) {
+			size_t textlen = ZitatespuckerZitatGetZitatLen(cur);
+			entry->zitatLen = (uint32_t) textlen;
+			ZitatespuckerCompactWrite(&writer, lens, codes, cur->zitat, textlen);
+		}
+		entry->commentBit = (uint32_t) writer.pos;
+		entry->commentLen = ZITATESPUCKER_COMPACT_ABSENT;
+		if (cur->comment != NULL) {
+			size_t textlen = ZitatespuckerZitatGetCommentLen(cur);
+			entry->commentLen = (uint32_t) textlen;
+			ZitatespuckerCompactWrite(&writer, lens, codes, cur->comment, textlen);
+		}
+		entry->author = (cur->author != NULL ? ZitatespuckerCompactAuthor(pool, &poolused, hash, hashsize, cur) : ZITATESPUCKER_COMPACT_ABSENT);
+		entry->year = cur->year;
+		entry->month = cur->month;
+		entry->day = cur->day;
+		entry->annodomini = cur->annodomini;
+	}
+
+	// the author pool shrank through deduplication, so move the stream down behind it
+	uint16_t *ctable = (uint16_t *) (entries + len);
+	char *cauthors = (char *) (ctable + ZITATESPUCKER_COMPACT_TABLESIZE);
+	uint8_t *cstream = (uint8_t *) cauthors + poolused;
+	(void) memcpy(ctable, table, sizeof(table));
+	(void) memcpy(cauthors, pool, poolused);
+	(void) memmove(cstream, writer.out, packedBytes + ZITATESPUCKER_COMPACT_PADDING);
+	free((void *) pool);
+	free((void *) hash);
+
+	size = (size_t) (cstream - (uint8_t *) compact) + packedBytes + ZITATESPUCKER_COMPACT_PADDING;
+	ZitatespuckerCompact *shrunk;
+	if ((shrunk = (ZitatespuckerCompact *) realloc(compact, size)) != NULL)
+		compact = shrunk;
+
+	compact->len = len;
+	compact->size = size;
+	compact->textBytes = textBytes;
+	compact->packedBytes = packedBytes;
+	compact->listBytes = listBytes;
+	compact->entries = (const ZitatespuckerCompactEntry *) (compact + 1);
+	compact->table = (const uint16_t *) (compact->entries + len);
+	compact->authors = (const char *) (compact->table + ZITATESPUCKER_COMPACT_TABLESIZE);
+	compact->stream = (const uint8_t *) compact->authors + poolused;
+
+	return compact;
+}
+
+ZitatespuckerCompact *ZitatespuckerCompactFromFile(const char *filename, ZitatespuckerSource source)
+{
+	ZitatespuckerZitat *ZitatList;
+	if ((ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filename, source)) == NULL)
+		return NULL;
+
+	ZitatespuckerCompact *compact = ZitatespuckerCompactFromList(ZitatList);
+	ZitatespuckerZitatFree(ZitatList);
+
+	return compact;
+}
+
+void ZitatespuckerCompactFree(ZitatespuckerCompact *compact)
+{
+	free((void *) compact);
+
+	return;
+}
+
+size_t ZitatespuckerCompactLen(const ZitatespuckerCompact *compact)
+{
+	return (compact != NULL ? compact->len : 0);
+}
+
+size_t ZitatespuckerCompactGetZitat(const ZitatespuckerCompact *compact, size_t idx, char *buf, size_t buflen)
+{
+	if (compact == NULL || idx >= compact->len) {
+		if (buflen != 0)
+			buf[0] = '\0';
+		return ZITATESPUCKER_COMPACT_NONE;
+	}
+
+	return ZitatespuckerCompactDecode(compact, compact->entries[idx].zitatBit, compact->entries[idx].zitatLen, buf, buflen);
+}
+
+size_t ZitatespuckerCompactGetComment(const ZitatespuckerCompact *compact, size_t idx, char *buf, size_t buflen)
+{
+	if (compact == NULL || idx >= compact->len) {
+		if (buflen != 0)
+			buf[0] = '\0';
+		return ZITATESPUCKER_COMPACT_NONE;
+	}
+
+	return ZitatespuckerCompactDecode(compact, compact->entries[idx].commentBit, compact->entries[idx].commentLen, buf, buflen);
+}
+
+const char *ZitatespuckerCompactGetAuthor(const ZitatespuckerCompact *compact, size_t idx)
+{
+	if (compact == NULL || idx >= compact->len || compact->entries[idx].author == ZITATESPUCKER_COMPACT_ABSENT)
+		return NULL;
+
+	return compact->authors + compact->entries[idx].author;
+}
+
+bool ZitatespuckerCompactGetDate(const ZitatespuckerCompact *compact, size_t idx, bool *annodomini, uint16_t *year, uint8_t *month, uint8_t *day)
+{
+	if (compact == NULL || idx >= compact->len)
+		return false;
+
+	const ZitatespuckerCompactEntry *entry = &compact->entries[idx];
+	if (annodomini != NULL)
+		*annodomini = entry->annodomini;
+	if (year != NULL)
+		*year = entry->year;
+	if (month != NULL)
+		*month = entry->month;
+	if (day != NULL)
+		*day = entry->day;
+
+	return true;
+}
+
+void ZitatespuckerCompactGetStats(const ZitatespuckerCompact *compact, ZitatespuckerCompactStats *stats)
+{
+	if (stats == NULL)
+		return;
+
+	(void) memset(stats, 0, sizeof(ZitatespuckerCompactStats));
+	if (compact == NULL)
+		return;
+
+	stats->entries = compact->len;
+	stats->textBytes = compact->textBytes;
+	stats->packedBytes = compact->packedBytes;
+	stats->listBytes = compact->listBytes;
+	stats->totalBytes = compact->size;
+	stats->bytesPerZitat = (compact->len != 0 ? (compact->size + compact->len - 1) / compact->len : 0);
+
+	return;
+}
+
+
+/* Static function definitions */
+
+static void ZitatespuckerCompactBuildLengths(const size_t freq[256], uint8_t lens[256])
+{
+	size_t weight[511];
+	int parent[511];
+	(void) memset(lens, 0, 256);
+
+	int used = 0;
+	for (int i = 0; i < 256; i++)
+		used += (freq[i] != 0);
+	if (used == 0)
+		return;
+	if (used == 1) {
+		for (int i = 0; i < 256; i++)
+			lens[i] = (freq[i] != 0);
+		return;
+	}
+
+	for (int i = 0; i < 256; i++)
+		weight[i] = freq[i];
+
+	// a plain Huffman tree; if it is too deep, flatten the frequencies and try again
+	for (;;) {
+		int nodes = 256;
+		for (int i = 0; i < 511; i++)
+			parent[i] = -1;
+
+		for (int merged = 1; merged < used; merged++) {
+			int a = -1;
+			int b = -1;
+			for (int i = 0; i < nodes; i++) {
+				if (parent[i] != -1 || weight[i] == 0)
+					continue;
+				if (a == -1 || weight[i] < weight[a]) {
+					b = a;
+					a = i;
+				} else if (b == -1 || weight[i] < weight[b]) {
+					b = i;
+				}
+			}
+			weight[nodes] = weight[a] + weight[b];
+			parent[a] = parent[b] = nodes;
+			nodes++;
+		}
+
+		int maxlen = 0;
+		for (int i = 0; i < 256; i++) {
+			if (weight[i] == 0)
+				continue;
+			int depth = 0;
+			for (int n = i; parent[n] != -1; n = parent[n])
+				depth++;
+			lens[i] = (uint8_t) depth;
+			if (depth > maxlen)
+				maxlen = depth;
+		}
+		if (maxlen <= ZITATESPUCKER_COMPACT_MAXBITS)
+			return;
+
+		for (int i = 0; i < 256; i++) {
+			if (weight[i] != 0)
+				weight[i] = (weight[i] + 1) / 2;
+		}
+	}
+}
+
+static void ZitatespuckerCompactBuildCodes(const uint8_t lens[256], uint16_t codes[256], uint16_t *table)
+{
+	uint16_t count[ZITATESPUCKER_COMPACT_MAXBITS + 1] = {0};
+	uint16_t next[ZITATESPUCKER_COMPACT_MAXBITS + 1];
+	for (int i = 0; i < 256; i++)
+		count[lens[i]]++;
+	count[0] = 0;
+
+	uint16_t code = 0;
+	for (int l = 1; l <= ZITATESPUCKER_COMPACT_MAXBITS; l++) {
+		code = (uint16_t) ((code + count[l - 1]) << 1);
+		next[l] = code;
+	}
+
+	(void) memset(table, 0, ZITATESPUCKER_COMPACT_TABLESIZE * sizeof(uint16_t));
+	for (int i = 0; i < 256; i++) {
+		if (lens[i] == 0)
+			continue;
+		codes[i] = next[lens[i]]++;
+		unsigned int shift = ZITATESPUCKER_COMPACT_MAXBITS - lens[i];
+		for (unsigned int j = (unsigned int) codes[i] << shift; j < ((unsigned int) codes[i] + 1) << shift; j++)
+			table[j] = (uint16_t) ((i << 4) | lens[i]);
+	}
+}
+
+static void ZitatespuckerCompactWrite(ZitatespuckerCompactWriter *writer, const uint8_t lens[256], const uint16_t codes[256], const char *str, size_t len)
+{
+	const unsigned char *c = (const unsigned char *) str;
+	for (size_t i = 0; i < len; i++) {
+		uint16_t code = codes[c[i]];
+		for (int b = lens[c[i]] - 1; b >= 0; b--) {
+			if ((code >> b) & 1)
+				writer->out[writer->pos >> 3] |= (uint8_t) (0x80 >> (writer->pos & 7));
+			writer->pos++;
+		}
+	}
+}
+
+static size_t ZitatespuckerCompactDecode(const ZitatespuckerCompact *compact, uint32_t bit, uint32_t len, char *buf, size_t buflen)
+{
+	if (len == ZITATESPUCKER_COMPACT_ABSENT) {
+		if (buflen != 0)
+			buf[0] = '\0';
+		return ZITATESPUCKER_COMPACT_NONE;
+	}
+	if (buflen == 0)
+		return len;
+
+	size_t out = (len < buflen ? len : buflen - 1);
+	const uint8_t *in = compact->stream + (bit >> 3);
+	const uint16_t *table = compact->table;
+
+	// MSB-first bit buffer; acc holds avail valid bits at its top
+	uint64_t acc = 0;
+	unsigned int avail = 0;
+	while (avail <= 56) {
+		acc |= (uint64_t) *in++ << (56 - avail);
+		avail += 8;
+	}
+	acc <<= (bit & 7);
+	avail -= (bit & 7);
+
+	for (size_t i = 0; i < out; i++) {
+		if (avail < ZITATESPUCKER_COMPACT_MAXBITS) {
+			while (avail <= 56) {
+				acc |= (uint64_t) *in++ << (56 - avail);
+				avail += 8;
+			}
+		}
+		uint16_t e = table[acc >> (64 - ZITATESPUCKER_COMPACT_MAXBITS)];
+		buf[i] = (char) (e >> 4);
+		acc <<= (e & 0xF);
+		avail -= (e & 0xF);
+	}
+	buf[out] = '\0';
+
+	return len;
+}
+
+static uint32_t ZitatespuckerCompactAuthor(char *pool, size_t *poolused, uint32_t *hash, size_t hashsize, const ZitatespuckerZitat *Zitat)
+{
+	const char *name = Zitat->author;
+	size_t namelen = ZitatespuckerZitatGetAuthorLen(Zitat);
+	uint64_t h = ZitatespuckerZitatGetAuthorHash(Zitat);
+
+	for (size_t slot = (size_t) (h ^ (h >> 32)) & (hashsize - 1);; slot = (slot + 1) & (hashsize - 1)) {
+		if (hash[slot] == ZITATESPUCKER_COMPACT_ABSENT) {
+			(void) memcpy(pool + *poolused, name, namelen);
+			pool[*poolused + namelen] = '\0';
+			hash[slot] = (uint32_t) *poolused;
+			*poolused += namelen + 1;
+			return hash[slot];
+		}
+		// strncmp() stops at the end of shorter pool entries, which then cannot be followed by '\0' at namelen
+		if (strncmp(pool + hash[slot], name, namelen) == 0 && pool[hash[slot] + namelen] == '\0')
+			return hash[slot];
+	}
+}
@@ -0,0 +1,405 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Counting quotes by author and date
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_count.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* Slots the group table starts out with; a power of two */
+#define ZITATESPUCKER_COUNT_INITSLOTS	64
+
+
+typedef struct ZitatespuckerCountSlot {
+	char *author; /* Owned; only for ZITATESPUCKER_GROUP_AUTHOR */
+	uint32_t hash;
+	uint32_t date; /* (annodomini << 16) | year of the group */
+	size_t amount; /* 0 marks a free slot */
+} ZitatespuckerCountSlot;
+
+struct ZitatespuckerCounter {
+	ZitatespuckerGroup group;
+	ZitatespuckerCountFilter filter;
+	char *filterAuthor; /* Owned copy of filter.author */
+	size_t filterAuthorLen;
+	uint64_t filterAuthorHash; /* ZitatespuckerAuthorHash() of filterAuthor */
+	size_t total;
+	size_t undated;
+	size_t noAuthor; /* The group without an author lives outside of the table */
+	size_t used;
+	size_t size; /* A power of two */
+	ZitatespuckerCountSlot *slots;
+	bool failed;
+};
+
+
+/* Static function declarations */
+
+/*
+	Returns whether Zitat has a valid date and stores its signed year (see ZitatespuckerCountFilter) in signedYear.
+*/
+static inline bool ZitatespuckerCountSignedYear(const ZitatespuckerZitat *Zitat, int32_t *signedYear);
+
+/*
+	Returns the slot for the group with the given hash and key (author or date), which may still be free.
+*/
+static ZitatespuckerCountSlot *ZitatespuckerCountFind(ZitatespuckerCounter *counter, uint32_t hash, const char *author, uint32_t date);
+
+/*
+	Double the size of the group table.
+	false on error.
+*/
+static bool ZitatespuckerCountGrow(ZitatespuckerCounter *counter);
+
+/*
+	qsort() comparators for the groups of ZitatespuckerCounts.
+*/
+static int ZitatespuckerCountCompareAuthor(const void *a, const void *b);
+static int ZitatespuckerCountCompareDate(const void *a, const void *b);
+
+
+/* Externally callable */
+
+ZitatespuckerCounter *ZitatespuckerCountBegin(ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter)
+{
+	if ((int) group < (int) ZITATESPUCKER_GROUP_NONE || (int) group > (int) ZITATESPUCKER_GROUP_ERA) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "Unknown group %d.", (int) group);
+		return NULL;
+	}
+
+	ZitatespuckerCounter *counter;
+	if ((counter = (ZitatespuckerCounter *) calloc(1, sizeof(ZitatespuckerCounter))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "calloc() returned NULL.");
+		return NULL;
+	}
+	counter->group = group;
+	if (filter != NULL)
+		counter->filter = *filter;
+
+	if (counter->filter.author != NULL) {
+		counter->filterAuthorLen = strlen(counter->filter.author);
+		if ((counter->filterAuthor = (char *) malloc(counter->filterAuthorLen + 1)) == NULL) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+			free((void *) counter);
+			return NULL;
+		}
+		(void) memcpy(counter->filterAuthor, counter->filter.author, counter->filterAuthorLen + 1);
+		counter->filter.author = counter->filterAuthor;
+		counter->filterAuthorHash = ZitatespuckerAuthorHash(counter->filterAuthor, counter->filterAuthorLen);
+	}
+
+	if (group != ZITATESPUCKER_GROUP_NONE) {
+		counter->size = ZITATESPUCKER_COUNT_INITSLOTS;
+		if ((counter->slots = (ZitatespuckerCountSlot *) calloc(counter->size, sizeof(ZitatespuckerCountSlot))) == NULL) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "calloc() returned NULL.");
+			free((void *) counter->filterAuthor);
+			free((void *) counter);
+			return NULL;
+		}
+	}
+
+	return counter;
+}
+
+bool ZitatespuckerCountAdd(ZitatespuckerCounter *counter, const ZitatespuckerZitat *Zitat)
+{
+	if (counter == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL counter!");
+		return false;
+	} else if (Zitat == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL Zitat!");
+		return false;
+	}
+
+	if (counter->filter.author != NULL && !ZitatespuckerZitatIsByAuthor(Zitat, counter->filterAuthor, counter->filterAuthorLen, counter->filterAuthorHash))
+		return true;
+
+	if (counter->filter.byYear) {
+		int32_t signedYear;
+		if (!ZitatespuckerCountSignedYear(Zitat, &signedYear) || signedYear < counter->filter.firstYear || signedYear > counter->filter.lastYear)
+			return true;
+	}
+
+	return ZitatespuckerCountAddAmount(counter, Zitat, 1);
+}
+
+bool ZitatespuckerCountAddAmount(ZitatespuckerCounter *counter, const ZitatespuckerZitat *Zitat, size_t amount)
+{
+	if (counter == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL counter!");
+		return false;
+	} else if (Zitat == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL Zitat!");
+		return false;
+	} else if (counter->failed) {
+		return false;
+	} else if (amount == 0) {
+		return true;
+	}
+
+	counter->total += amount;
+
+	uint32_t hash;
+	const char *author = NULL;
+	uint32_t date = 0;
+	switch (counter->group) {
+		case ZITATESPUCKER_GROUP_NONE:
+			return true;
+		case ZITATESPUCKER_GROUP_AUTHOR:
+			// the backends do not tell an empty author from none
+			if (Zitat->author == NULL || Zitat->author[0] == '\0') {
+				counter->noAuthor += amount;
+				return true;
+			}
+			author = Zitat->author;
+			// usually known from loading the element already
+			uint64_t authorHash = ZitatespuckerZitatGetAuthorHash(Zitat);
+			hash = (uint32_t) (authorHash ^ (authorHash >> 32));
+			break;
+		default: {
+			int32_t signedYear;
+			if (!ZitatespuckerCountSignedYear(Zitat, &signedYear)) {
+				counter->undated += amount;
+				return true;
+			}
+			uint32_t year = Zitat->year;
+			if (counter->group == ZITATESPUCKER_GROUP_DECADE)
+				year -= year % 10;
+			else if (counter->group == ZITATESPUCKER_GROUP_CENTURY)
+				year -= year % 100;
+			else if (counter->group == ZITATESPUCKER_GROUP_ERA)
+				year = 0;
+			date = ((uint32_t) Zitat->annodomini << 16) | year;
+			hash = date * 2654435761u;
+			break;
+		}
+	}
+
+	ZitatespuckerCountSlot *slot = ZitatespuckerCountFind(counter, hash, author, date);
+	if (slot->amount == 0) {
+		// keep the table at most half full
+		if ((counter->used + 1) * 2 > counter->size) {
+			if (!ZitatespuckerCountGrow(counter)) {
+				counter->failed = true;
+				return false;
+			}
+			slot = ZitatespuckerCountFind(counter, hash, author, date);
+		}
+		if (author != NULL) {
+			size_t authorLen = ZitatespuckerZitatGetAuthorLen(Zitat);
+			if ((slot->author = (char *) malloc(authorLen + 1)) == NULL) {
+				ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+				counter->failed = true;
+				return false;
+			}
+			(void) memcpy(slot->author, author, authorLen);
+			slot->author[authorLen] = '\0';
+		}
+		slot->hash = hash;
+		slot->date = date;
+		counter->used++;
+	}
+	slot->amount += amount;
+
+	return true;
+}
+
+bool ZitatespuckerCountCallback(const ZitatespuckerZitat *Zitat, void *counter)
+{
+	return ZitatespuckerCountAdd((ZitatespuckerCounter *) counter, Zitat);
+}
+
+ZitatespuckerCounts *ZitatespuckerCountEnd(ZitatespuckerCounter *counter)
+{
+	if (counter == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL counter!");
+		return NULL;
+	}
+
+	// one allocation: the struct, the groups and the author names
+	size_t len = counter->used + (counter->noAuthor != 0 ? 1 : 0);
+	size_t authorBytes = 0;
+	for (size_t i = 0; i < counter->size; i++) {
+		if (counter->slots[i].amount != 0 && counter->slots[i].author != NULL)
+			authorBytes += strlen(counter->slots[i].author) + 1;
+	}
+
+	ZitatespuckerCounts *ret = NULL;
+	if (!counter->failed) {
+		if ((ret = (ZitatespuckerCounts *) malloc(sizeof(ZitatespuckerCounts) + len * sizeof(ZitatespuckerCount) + authorBytes)) == NULL) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		}
+	}
+
+	if (ret != NULL) {
+		ret->group = counter->group;
+		ret->total = counter->total;
+		ret->undated = counter->undated;
+		ret->len = len;
+		ret->counts = (ZitatespuckerCount *) (ret + 1);
+		char *pool = (char *) (ret->counts + len);
+
+		size_t n = 0;
+		if (counter->noAuthor != 0) {
+			ret->counts[n].author = NULL;
+			ret->counts[n].annodomini = false;
+			ret->counts[n].year = 0;
+			ret->counts[n].amount = counter->noAuthor;
+			n++;
+		}
+		for (size_t i = 0; i < counter->size; i++) {
+			const ZitatespuckerCountSlot *slot = &counter->slots[i];
+			if (slot->amount == 0)
+				continue;
+			ret->counts[n].author = NULL;
+			if (slot->author != NULL) {
+				(void) strcpy(pool, slot->author);
+				ret->counts[n].author = pool;
+				pool += strlen(pool) + 1;
+			}
+			ret->counts[n].annodomini = ((slot->date >> 16) != 0);
+			ret->counts[n].year = (uint16_t) (slot->date & 0xFFFF);
+			ret->counts[n].amount = slot->amount;
+			n++;
+		}
+
+		if (ret->group == ZITATESPUCKER_GROUP_AUTHOR)
+			qsort(ret->counts, len, sizeof(ZitatespuckerCount), ZitatespuckerCountCompareAuthor);
+		else if (len > 1)
+			qsort(ret->counts, len, sizeof(ZitatespuckerCount), ZitatespuckerCountCompareDate);
+	}
+
+	for (size_t i = 0; i < counter->size; i++)
+		free((void *) counter->slots[i].author);
+	free((void *) counter->slots);
+	free((void *) counter->filterAuthor);
+	free((void *) counter);
+
+	return ret;
+}
+
+ZitatespuckerCounts *ZitatespuckerCountFromList(const ZitatespuckerZitat *ZitatList, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter)
+{
+	ZitatespuckerCounter *counter;
+	if ((counter = ZitatespuckerCountBegin(group, filter)) == NULL)
+		return NULL;
+
+	if (ZitatList != NULL) {
+		while (ZitatList->prevZitat != NULL)
+			ZitatList = ZitatList->prevZitat;
+	}
+
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat) {
+		if (!ZitatespuckerCountAdd(counter, cur))
+			break;
+	}
+
+	return ZitatespuckerCountEnd(counter);
+}
+
+void ZitatespuckerCountsFree(ZitatespuckerCounts *counts)
+{
+	free((void *) counts);
+}
+
+
+/* Static function definitions */
+
+static inline bool ZitatespuckerCountSignedYear(const ZitatespuckerZitat *Zitat, int32_t *signedYear)
+{
+	if (!Zitat->annodomini && Zitat->year == 0)
+		return false;
+
+	*signedYear = (Zitat->annodomini ? (int32_t) Zitat->year : -(int32_t) Zitat->year);
+
+	return true;
+}
+
+static ZitatespuckerCountSlot *ZitatespuckerCountFind(ZitatespuckerCounter *counter, uint32_t hash, const char *author, uint32_t date)
+{
+	size_t mask = counter->size - 1;
+	for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+		ZitatespuckerCountSlot *slot = &counter->slots[i];
+		if (slot->amount == 0)
+			return slot;
+		if (slot->hash != hash)
+			continue;
+		if (author != NULL ? strcmp(slot->author, author) == 0 : slot->date == date)
+			return slot;
+	}
+}
+
+static bool ZitatespuckerCountGrow(ZitatespuckerCounter *counter)
+{
+	size_t size = counter->size * 2;
+	ZitatespuckerCountSlot *slots;
+	if ((slots = (ZitatespuckerCountSlot *) calloc(size, sizeof(ZitatespuckerCountSlot))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "calloc() returned NULL.");
+		return false;
+	}
+
+	// hashes are kept, so nothing needs to be rehashed
+	for (size_t i = 0; i < counter->size; i++) {
+		if (counter->slots[i].amount == 0)
+			continue;
+		size_t j = counter->slots[i].hash & (size - 1);
+		while (slots[j].amount != 0)
+			j = (j + 1) & (size - 1);
+		slots[j] = counter->slots[i];
+	}
+
+	free((void *) counter->slots);
+	counter->slots = slots;
+	counter->size = size;
+
+	return true;
+}
+
+static int ZitatespuckerCountCompareAuthor(const void *a, const void *b)
+{
+	const ZitatespuckerCount *countA = (const ZitatespuckerCount *) a;
+	const ZitatespuckerCount *countB = (const ZitatespuckerCount *) b;
+	if (countA->author == NULL || countB->author == NULL)
+		return (countA->author != NULL) - (countB->author != NULL);
+
+	return strcmp(countA->author, countB->author);
+}
+
+static int ZitatespuckerCountCompareDate(const void *a, const void *b)
+{
+	const ZitatespuckerCount *countA = (const ZitatespuckerCount *) a;
+	const ZitatespuckerCount *countB = (const ZitatespuckerCount *) b;
+	if (countA->annodomini != countB->annodomini)
+		return (countA->annodomini ? 1 : -1);
+
+	// BC counts backwards
+	if (countA->annodomini)
+		return (countA->year > countB->year) - (countA->year < countB->year);
+	else
+		return (countA->year < countB->year) - (countA->year > countB->year);
+}
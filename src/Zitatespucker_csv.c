@@ -0,0 +1,737 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	CSV and TSV backend
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_csv.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* Column of a field that the header does not name */
+#define ZITATESPUCKER_CSV_NONE		SIZE_MAX
+
+/* A byte of 0x01 / 0x80 in every position of a 64 bit word, for scanning eight bytes at a time */
+#define ZITATESPUCKER_CSV_ONES		UINT64_C(0x0101010101010101)
+#define ZITATESPUCKER_CSV_HIGHS		UINT64_C(0x8080808080808080)
+
+/* Non-zero if any byte of the 64 bit word x is zero (and never if none is) */
+#define ZITATESPUCKER_CSV_HASZERO(x)	(((x) - ZITATESPUCKER_CSV_ONES) & ~(x) & ZITATESPUCKER_CSV_HIGHS)
+
+
+/* The fields a column can be mapped onto, in the order of ZitatespuckerCSVOptions */
+typedef enum ZitatespuckerCSVField {
+	ZITATESPUCKER_CSV_AUTHOR = 0,
+	ZITATESPUCKER_CSV_ZITAT,
+	ZITATESPUCKER_CSV_COMMENT,
+	ZITATESPUCKER_CSV_DAY,
+	ZITATESPUCKER_CSV_MONTH,
+	ZITATESPUCKER_CSV_YEAR,
+	ZITATESPUCKER_CSV_ANNODOMINI,
+	ZITATESPUCKER_CSV_FIELDS /* Number of fields */
+} ZitatespuckerCSVField;
+
+/* What elements are kept when loading a list */
+typedef struct ZitatespuckerCSVFilter {
+	const char *authorname; /* non-NULL --> only elements by this author */
+	size_t authorLen; /* of authorname */
+	bool byDate; /* true --> only elements matching the date below */
+	bool annodomini;
+	uint16_t year;
+	uint8_t month; /* 0 --> any */
+	uint8_t day; /* 0 --> any */
+} ZitatespuckerCSVFilter;
+
+/* A file being parsed, read into memory as a whole */
+typedef struct ZitatespuckerCSVFile {
+	char *buf; /* The file, '\0'-terminated; fields are unquoted and terminated in place */
+	char *cur; /* Start of the next row */
+	char *end; /* The '\0' at the end of buf */
+	char delimiter;
+	char **row; /* Fields of the current row, capacity of them */
+	size_t *rowLen; /* Length of each of them */
+	size_t capacity;
+	size_t columns; /* Number of columns the header names */
+	size_t map[ZITATESPUCKER_CSV_FIELDS]; /* Column of each field; ZITATESPUCKER_CSV_NONE --> none */
+	bool failed; /* true --> the header could not be stored */
+	bool hasNul; /* true --> the file holds a '\0', so rowLen may be more than strlen() of a field */
+} ZitatespuckerCSVFile;
+
+
+/* Static function declarations */
+
+/*
+	Read filename into file, work out the delimiter and map the columns named by the header onto fields,
+	reporting errors on behalf of caller.
+	false on error (including none of the columns being known); file must be closed otherwise.
+*/
+static bool ZitatespuckerCSVOpen(ZitatespuckerCSVFile *file, const char *filename, const ZitatespuckerCSVOptions *options, const char *caller);
+
+/*
+	Free what file holds.
+*/
+static void ZitatespuckerCSVClose(ZitatespuckerCSVFile *file);
+
+/*
+	Parse the next row of file into file->row, unquoting and '\0'-terminating its fields in place.
+	Fields past file->capacity are dropped, unless grow is true, in which case file->row grows to hold them.
+	Returns the number of fields the row has; 0 at the end of the file (or if growing failed).
+*/
+static size_t ZitatespuckerCSVNextRow(ZitatespuckerCSVFile *file, bool grow);
+
+/*
+	Parse the next row of file that is not empty into Zitat, which is initialized first and points into file.
+	false at the end of the file.
+*/
+static bool ZitatespuckerCSVNextZitat(ZitatespuckerCSVFile *file, ZitatespuckerZitat *Zitat);
+
+/*
+	Returns a pointer to the first delimiter, '\n' or '\r' from cur on; end if there is none.
+*/
+static char *ZitatespuckerCSVFindSpecial(char *cur, char *end, char delimiter);
+
+/*
+	Returns the value of the current row of file in the column of field; NULL if there is none or it is empty.
+*/
+static const char *ZitatespuckerCSVValue(const ZitatespuckerCSVFile *file, ZitatespuckerCSVField field);
+
+/*
+	Returns the length of the value ZitatespuckerCSVValue() returns for field; 0 if it is NULL or not known.
+*/
+static size_t ZitatespuckerCSVValueLen(const ZitatespuckerCSVFile *file, ZitatespuckerCSVField field);
+
+/*
+	Returns the decimal number in str (NULL is fine) cut off to an integer between 0 and max; 0 if it is not a number.
+*/
+static unsigned int ZitatespuckerCSVNumber(const char *str, unsigned int max);
+
+/*
+	Returns true if str (NULL is fine) stands for a year AD.
+*/
+static bool ZitatespuckerCSVIsAnnoDomini(const char *str);
+
+/*
+	Returns true if str equals name, ignoring case and any whitespace around str.
+*/
+static bool ZitatespuckerCSVNameEquals(const char *str, const char *name);
+
+/*
+	Returns true if filename ends with ext (case-insensitive).
+*/
+static bool ZitatespuckerCSVHasExtension(const char *filename, const char *ext);
+
+/*
+	Returns true if Zitat is kept by filter.
+*/
+static bool ZitatespuckerCSVMatches(const ZitatespuckerZitat *Zitat, const ZitatespuckerCSVFilter *filter);
+
+/*
+	Returns a copy of the fields within fields of Zitat, not linked to anything.
+	NULL on error; the copy must be freed with ZitatespuckerZitatFree().
+*/
+static ZitatespuckerZitat *ZitatespuckerCSVCopy(const ZitatespuckerZitat *Zitat, ZitatespuckerFields fields);
+
+/*
+	Returns a copy of str, which is len characters long.
+	NULL on error.
+*/
+static char *ZitatespuckerCSVCopyString(const char *str, size_t len);
+
+/*
+	Build a list of the elements within filename kept by filter, with the fields within fields,
+	reporting errors on behalf of caller.
+	NULL on error or if nothing was kept.
+*/
+static ZitatespuckerZitat *ZitatespuckerCSVLoad(const char *filename, const ZitatespuckerCSVOptions *options, const ZitatespuckerCSVFilter *filter, ZitatespuckerFields fields, const char *caller);
+
+/*
+	Pass every element within filename to callback, adding their number to passed.
+	false on error.
+*/
+static bool ZitatespuckerCSVEach(const char *filename, const ZitatespuckerCSVOptions *options, ZitatespuckerCSVCallback callback, void *userdata, size_t *passed, const char *caller);
+
+
+/* Externally callable */
+
+size_t ZitatespuckerCSVGetAmountFromFile(const char *filename, const ZitatespuckerCSVOptions *options)
+{
+	ZitatespuckerCSVFile file;
+	if (!ZitatespuckerCSVOpen(&file, filename, options, __func__))
+		return 0;
+
+	size_t ret = 0;
+	ZitatespuckerZitat Zitat;
+	while (ZitatespuckerCSVNextZitat(&file, &Zitat))
+		ret++;
+	ZitatespuckerCSVClose(&file);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatSingleFromFile(const char *filename, const ZitatespuckerCSVOptions *options, const size_t idx)
+{
+	return ZitatespuckerCSVGetZitatSingleFromFileFields(filename, options, idx, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatSingleFromFileFields(const char *filename, const ZitatespuckerCSVOptions *options, const size_t idx, ZitatespuckerFields fields)
+{
+	ZitatespuckerCSVFile file;
+	if (!ZitatespuckerCSVOpen(&file, filename, options, __func__))
+		return NULL;
+
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat Zitat;
+	size_t i = 0;
+	for (; ZitatespuckerCSVNextZitat(&file, &Zitat); i++) {
+		if (i == idx) {
+			ret = ZitatespuckerCSVCopy(&Zitat, fields);
+			break;
+		}
+	}
+	ZitatespuckerCSVClose(&file);
+
+	if (i < idx)
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "idx %zu is out of range for \"%s\".", idx, filename);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFile(const char *filename, const ZitatespuckerCSVOptions *options)
+{
+	return ZitatespuckerCSVGetZitatAllFromFileFields(filename, options, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileFields(const char *filename, const ZitatespuckerCSVOptions *options, ZitatespuckerFields fields)
+{
+	return ZitatespuckerCSVLoad(filename, options, NULL, fields, __func__);
+}
+
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileByAuthor(const char *filename, const ZitatespuckerCSVOptions *options, const char *authorname)
+{
+	return ZitatespuckerCSVGetZitatAllFromFileByAuthorFields(filename, options, authorname, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileByAuthorFields(const char *filename, const ZitatespuckerCSVOptions *options, const char *authorname, ZitatespuckerFields fields)
+{
+	if (authorname == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL authorname!");
+		return NULL;
+	}
+
+	ZitatespuckerCSVFilter filter = {.authorname = authorname, .authorLen = strlen(authorname)};
+
+	return ZitatespuckerCSVLoad(filename, options, &filter, fields, __func__);
+}
+
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileByDate(const char *filename, const ZitatespuckerCSVOptions *options, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	return ZitatespuckerCSVGetZitatAllFromFileByDateFields(filename, options, annodomini, year, month, day, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerCSVGetZitatAllFromFileByDateFields(const char *filename, const ZitatespuckerCSVOptions *options, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields)
+{
+	if (year == 0 && annodomini == false) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "annodomini cannot be false when year is 0.");
+		return NULL;
+	} else if (day != 0 && month == 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "month cannot be 0 when day is not 0.");
+		return NULL;
+	}
+
+	ZitatespuckerCSVFilter filter = {.byDate = true, .annodomini = annodomini, .year = year, .month = month, .day = day};
+
+	return ZitatespuckerCSVLoad(filename, options, &filter, fields, __func__);
+}
+
+size_t ZitatespuckerCSVForEachFromFile(const char *filename, const ZitatespuckerCSVOptions *options, ZitatespuckerCSVCallback callback, void *userdata)
+{
+	size_t ret = 0;
+	if (!ZitatespuckerCSVEach(filename, options, callback, userdata, &ret, __func__))
+		return 0;
+
+	return ret;
+}
+
+ZitatespuckerCounts *ZitatespuckerCSVCountFromFile(const char *filename, const ZitatespuckerCSVOptions *options, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter)
+{
+	ZitatespuckerCounter *counter;
+	if ((counter = ZitatespuckerCountBegin(group, filter)) == NULL)
+		return NULL;
+
+	size_t passed = 0;
+	bool ok = ZitatespuckerCSVEach(filename, options, ZitatespuckerCountCallback, counter, &passed, __func__);
+	ZitatespuckerCounts *ret = ZitatespuckerCountEnd(counter);
+	if (!ok) {
+		ZitatespuckerCountsFree(ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+
+/* Static function definitions */
+
+static bool ZitatespuckerCSVOpen(ZitatespuckerCSVFile *file, const char *filename, const ZitatespuckerCSVOptions *options, const char *caller)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, caller, "recieved NULL filename!");
+		return false;
+	}
+
+	ZitatespuckerCSVOptions defaults = {0};
+	if (options == NULL)
+		options = &defaults;
+	file->delimiter = options->delimiter;
+	if (file->delimiter == 0)
+		file->delimiter = (ZitatespuckerCSVHasExtension(filename, ".tsv") || ZitatespuckerCSVHasExtension(filename, ".tab") ? '\t' : ',');
+	if (file->delimiter == '"' || file->delimiter == '\n' || file->delimiter == '\r') {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, caller, "Double quotes and line breaks cannot be used as delimiter.");
+		return false;
+	}
+
+	FILE *in;
+	if ((in = fopen(filename, "rb")) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, caller, "fopen() failed for \"%s\".", filename);
+		return false;
+	}
+
+	long size;
+	if (fseek(in, 0, SEEK_END) != 0 || (size = ftell(in)) < 0 || fseek(in, 0, SEEK_SET) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, caller, "Could not determine the size of \"%s\".", filename);
+		(void) fclose(in);
+		return false;
+	}
+	if ((file->buf = (char *) malloc((size_t) size + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "malloc() returned NULL.");
+		(void) fclose(in);
+		return false;
+	}
+	if (fread(file->buf, 1, (size_t) size, in) != (size_t) size) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, caller, "fread() failed for \"%s\".", filename);
+		free((void *) file->buf);
+		(void) fclose(in);
+		return false;
+	}
+	(void) fclose(in);
+	file->buf[size] = '\0';
+	file->cur = file->buf;
+	file->end = file->buf + size;
+	file->row = NULL;
+	file->rowLen = NULL;
+	file->capacity = 0;
+	file->failed = false;
+	// rare enough to not be worth telling apart in the hot loop, so checked for once here
+	file->hasNul = (memchr(file->buf, '\0', (size_t) size) != NULL);
+
+	// spreadsheets like to start UTF-8 files with a byte order mark
+	if (size >= 3 && memcmp(file->buf, "\xEF\xBB\xBF", 3) == 0)
+		file->cur += 3;
+
+	file->columns = ZitatespuckerCSVNextRow(file, true);
+	if (file->failed || file->columns == 0) {
+		if (!file->failed)
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, caller, "\"%s\" has no header.", filename);
+		ZitatespuckerCSVClose(file);
+		return false;
+	}
+
+	const char *names[ZITATESPUCKER_CSV_FIELDS] = {
+		(options->author != NULL ? options->author : ZITATESPUCKERZITATAUTHOR),
+		(options->zitat != NULL ? options->zitat : ZITATESPUCKERZITATZITAT),
+		(options->comment != NULL ? options->comment : ZITATESPUCKERZITATCOMMENT),
+		(options->day != NULL ? options->day : ZITATESPUCKERZITATDAY),
+		(options->month != NULL ? options->month : ZITATESPUCKERZITATMONTH),
+		(options->year != NULL ? options->year : ZITATESPUCKERZITATYEAR),
+		(options->annodomini != NULL ? options->annodomini : ZITATESPUCKERZITATANNODOMINI)
+	};
+	bool known = false;
+	for (size_t f = 0; f < ZITATESPUCKER_CSV_FIELDS; f++) {
+		file->map[f] = ZITATESPUCKER_CSV_NONE;
+		for (size_t c = 0; c < file->columns; c++) {
+			if (ZitatespuckerCSVNameEquals(file->row[c], names[f])) {
+				file->map[f] = c;
+				known = true;
+				break;
+			}
+		}
+	}
+	if (!known) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, caller, "None of the columns of \"%s\" is known.", filename);
+		ZitatespuckerCSVClose(file);
+		return false;
+	}
+
+	return true;
+}
+
+static void ZitatespuckerCSVClose(ZitatespuckerCSVFile *file)
+{
+	free((void *) file->row);
+	free((void *) file->rowLen);
+	free((void *) file->buf);
+
+	return;
+}
+
+static size_t ZitatespuckerCSVNextRow(ZitatespuckerCSVFile *file, bool grow)
+{
+	char *end = file->end;
+	if (file->cur >= end)
+		return 0;
+
+	size_t count = 0;
+	for (;;) {
+		char *cur = file->cur;
+		char *field = cur;
+		char *w; // where the unquoted field ends; never ahead of the input, as quotes are only ever dropped
+		char *p;
+		if (*cur == '"') {
+			w = cur++;
+			for (;;) {
+				char *q = (char *) memchr(cur, '"', (size_t) (end - cur));
+				if (q == NULL)
+					q = end;
+				(void) memmove(w, cur, (size_t) (q - cur));
+				w += q - cur;
+				if (q == end) {
+					cur = end;
+					break;
+				} else if (q[1] == '"') {
+					*w++ = '"';
+					cur = q + 2;
+				} else {
+					cur = q + 1;
+					break;
+				}
+			}
+			// whatever follows the closing quote is kept as it is
+			p = ZitatespuckerCSVFindSpecial(cur, end, file->delimiter);
+			(void) memmove(w, cur, (size_t) (p - cur));
+			w += p - cur;
+		} else {
+			p = ZitatespuckerCSVFindSpecial(cur, end, file->delimiter);
+			w = p;
+		}
+		char term = (p < end ? *p : '\0');
+		*w = '\0';
+
+		if (count == file->capacity && grow) {
+			size_t capacity = (file->capacity == 0 ? 16 : file->capacity * 2);
+			char **tmpRow;
+			size_t *tmpRowLen;
+			if ((tmpRow = (char **) realloc(file->row, capacity * sizeof(char *))) == NULL) {
+				ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "realloc() returned NULL.");
+				file->failed = true;
+				return 0;
+			}
+			file->row = tmpRow;
+			if ((tmpRowLen = (size_t *) realloc(file->rowLen, capacity * sizeof(size_t))) == NULL) {
+				ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "realloc() returned NULL.");
+				file->failed = true;
+				return 0;
+			}
+			file->rowLen = tmpRowLen;
+			file->capacity = capacity;
+		}
+		if (count < file->capacity) {
+			file->row[count] = field;
+			file->rowLen[count] = (size_t) (w - field);
+		}
+		count++;
+
+		if (p < end && term == file->delimiter) {
+			file->cur = p + 1;
+			continue;
+		}
+		if (term == '\r' && p + 1 < end && p[1] == '\n')
+			p++;
+		file->cur = (p < end ? p + 1 : end);
+
+		return count;
+	}
+}
+
+static bool ZitatespuckerCSVNextZitat(ZitatespuckerCSVFile *file, ZitatespuckerZitat *Zitat)
+{
+	size_t count;
+	while ((count = ZitatespuckerCSVNextRow(file, false)) != 0) {
+		if (count == 1 && file->row[0][0] == '\0')
+			continue;
+		for (size_t i = count; i < file->columns; i++) {
+			file->row[i] = (char *) "";
+			file->rowLen[i] = 0;
+		}
+
+		ZitatespuckerZitatInit(Zitat);
+		Zitat->author = (char *) ZitatespuckerCSVValue(file, ZITATESPUCKER_CSV_AUTHOR);
+		Zitat->zitat = (char *) ZitatespuckerCSVValue(file, ZITATESPUCKER_CSV_ZITAT);
+		Zitat->comment = (char *) ZitatespuckerCSVValue(file, ZITATESPUCKER_CSV_COMMENT);
+		Zitat->authorLen = ZitatespuckerCSVValueLen(file, ZITATESPUCKER_CSV_AUTHOR);
+		Zitat->zitatLen = ZitatespuckerCSVValueLen(file, ZITATESPUCKER_CSV_ZITAT);
+		Zitat->commentLen = ZitatespuckerCSVValueLen(file, ZITATESPUCKER_CSV_COMMENT);
+		Zitat->day = (uint8_t) ZitatespuckerCSVNumber(ZitatespuckerCSVValue(file, ZITATESPUCKER_CSV_DAY), UINT8_MAX);
+		Zitat->month = (uint8_t) ZitatespuckerCSVNumber(ZitatespuckerCSVValue(file, ZITATESPUCKER_CSV_MONTH), UINT8_MAX);
+		Zitat->year = (uint16_t) ZitatespuckerCSVNumber(ZitatespuckerCSVValue(file, ZITATESPUCKER_CSV_YEAR), UINT16_MAX);
+		Zitat->annodomini = ZitatespuckerCSVIsAnnoDomini(ZitatespuckerCSVValue(file, ZITATESPUCKER_CSV_ANNODOMINI));
+
+		return true;
+	}
+
+	return false;
+}
+
+static char *ZitatespuckerCSVFindSpecial(char *cur, char *end, char delimiter)
+{
+	// skip words that hold none of the three, then find which byte it was
+	const uint64_t delimiters = ZITATESPUCKER_CSV_ONES * (unsigned char) delimiter;
+	const uint64_t newlines = ZITATESPUCKER_CSV_ONES * (unsigned char) '\n';
+	const uint64_t returns = ZITATESPUCKER_CSV_ONES * (unsigned char) '\r';
+	while (end - cur >= 8) {
+		uint64_t word;
+		(void) memcpy(&word, cur, sizeof(word));
+		if (ZITATESPUCKER_CSV_HASZERO(word ^ delimiters) | ZITATESPUCKER_CSV_HASZERO(word ^ newlines) | ZITATESPUCKER_CSV_HASZERO(word ^ returns))
+			break;
+		cur += 8;
+	}
+
+	for (; cur < end; cur++) {
+		if (*cur == delimiter || *cur == '\n' || *cur == '\r')
+			return cur;
+	}
+
+	return end;
+}
+
+static const char *ZitatespuckerCSVValue(const ZitatespuckerCSVFile *file, ZitatespuckerCSVField field)
+{
+	size_t column = file->map[field];
+	if (column == ZITATESPUCKER_CSV_NONE || file->row[column][0] == '\0')
+		return NULL;
+
+	return file->row[column];
+}
+
+static size_t ZitatespuckerCSVValueLen(const ZitatespuckerCSVFile *file, ZitatespuckerCSVField field)
+{
+	size_t column = file->map[field];
+	if (column == ZITATESPUCKER_CSV_NONE || file->hasNul)
+		return 0;
+
+	return file->rowLen[column];
+}
+
+static unsigned int ZitatespuckerCSVNumber(const char *str, unsigned int max)
+{
+	if (str == NULL)
+		return 0;
+
+	while (isspace((unsigned char) *str))
+		str++;
+	bool negative = (*str == '-');
+	if (*str == '-' || *str == '+')
+		str++;
+	if (!isdigit((unsigned char) *str))
+		return 0;
+
+	unsigned int ret = 0;
+	for (; isdigit((unsigned char) *str); str++) {
+		if (ret <= max)
+			ret = ret * 10 + (unsigned int) (*str - '0');
+	}
+	// fractions are cut off, as they are by the JSON backends
+	if (*str == '.') {
+		for (str++; isdigit((unsigned char) *str); str++)
+			;
+	}
+	while (isspace((unsigned char) *str))
+		str++;
+
+	if (*str != '\0' || negative)
+		return 0;
+
+	return (ret > max ? max : ret);
+}
+
+static bool ZitatespuckerCSVIsAnnoDomini(const char *str)
+{
+	static const char *const yes[] = {"true", "yes", "1", "ad", "ce"};
+
+	if (str == NULL)
+		return false;
+
+	for (size_t i = 0; i < sizeof(yes) / sizeof(yes[0]); i++) {
+		if (ZitatespuckerCSVNameEquals(str, yes[i]))
+			return true;
+	}
+
+	return false;
+}
+
+static bool ZitatespuckerCSVNameEquals(const char *str, const char *name)
+{
+	while (isspace((unsigned char) *str))
+		str++;
+	for (; *name != '\0'; str++, name++) {
+		if (tolower((unsigned char) *str) != tolower((unsigned char) *name))
+			return false;
+	}
+	while (isspace((unsigned char) *str))
+		str++;
+
+	return (*str == '\0');
+}
+
+static bool ZitatespuckerCSVHasExtension(const char *filename, const char *ext)
+{
+	size_t namelen = strlen(filename);
+	size_t extlen = strlen(ext);
+	if (namelen < extlen)
+		return false;
+
+	return ZitatespuckerCSVNameEquals(filename + (namelen - extlen), ext);
+}
+
+static bool ZitatespuckerCSVMatches(const ZitatespuckerZitat *Zitat, const ZitatespuckerCSVFilter *filter)
+{
+	if (filter == NULL)
+		return true;
+
+	if (filter->authorname != NULL && !ZitatespuckerZitatIsByAuthor(Zitat, filter->authorname, filter->authorLen, 0))
+		return false;
+
+	if (filter->byDate) {
+		if (Zitat->annodomini != filter->annodomini || Zitat->year != filter->year)
+			return false;
+		if (filter->month != 0 && Zitat->month != filter->month)
+			return false;
+		if (filter->day != 0 && Zitat->day != filter->day)
+			return false;
+	}
+
+	return true;
+}
+
+static ZitatespuckerZitat *ZitatespuckerCSVCopy(const ZitatespuckerZitat *Zitat, ZitatespuckerFields fields)
+{
+	ZitatespuckerZitat *ret;
+	if ((ret = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	ZitatespuckerZitatInit(ret);
+
+	// measured again only for files holding a '\0', the copies end at it
+	if (fields & ZITATESPUCKER_FIELD_AUTHOR)
+		ret->authorLen = ZitatespuckerZitatGetAuthorLen(Zitat);
+	if (fields & ZITATESPUCKER_FIELD_ZITAT)
+		ret->zitatLen = ZitatespuckerZitatGetZitatLen(Zitat);
+	if (fields & ZITATESPUCKER_FIELD_COMMENT)
+		ret->commentLen = ZitatespuckerZitatGetCommentLen(Zitat);
+
+	if (((fields & ZITATESPUCKER_FIELD_AUTHOR) && Zitat->author != NULL && (ret->author = ZitatespuckerCSVCopyString(Zitat->author, ret->authorLen)) == NULL)
+	|| ((fields & ZITATESPUCKER_FIELD_ZITAT) && Zitat->zitat != NULL && (ret->zitat = ZitatespuckerCSVCopyString(Zitat->zitat, ret->zitatLen)) == NULL)
+	|| ((fields & ZITATESPUCKER_FIELD_COMMENT) && Zitat->comment != NULL && (ret->comment = ZitatespuckerCSVCopyString(Zitat->comment, ret->commentLen)) == NULL)) {
+		ZitatespuckerZitatFree(ret);
+		return NULL;
+	}
+	ret->authorHash = ZitatespuckerAuthorHash(ret->author, ret->authorLen);
+
+	if (fields & ZITATESPUCKER_FIELD_DATE) {
+		ret->day = Zitat->day;
+		ret->month = Zitat->month;
+		ret->year = Zitat->year;
+		ret->annodomini = Zitat->annodomini;
+	}
+
+	return ret;
+}
+
+static char *ZitatespuckerCSVCopyString(const char *str, size_t len)
+{
+	char *ret;
+	if ((ret = (char *) malloc(len + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	ret[len] = '\0';
+
+	return (char *) memcpy(ret, str, len);
+}
+
+static ZitatespuckerZitat *ZitatespuckerCSVLoad(const char *filename, const ZitatespuckerCSVOptions *options, const ZitatespuckerCSVFilter *filter, ZitatespuckerFields fields, const char *caller)
+{
+	ZitatespuckerCSVFile file;
+	if (!ZitatespuckerCSVOpen(&file, filename, options, caller))
+		return NULL;
+
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *last = NULL;
+	ZitatespuckerZitat Zitat;
+	while (ZitatespuckerCSVNextZitat(&file, &Zitat)) {
+		if (!ZitatespuckerCSVMatches(&Zitat, filter))
+			continue;
+
+		ZitatespuckerZitat *copy;
+		if ((copy = ZitatespuckerCSVCopy(&Zitat, fields)) == NULL) {
+			ZitatespuckerZitatFree(ret);
+			ret = NULL;
+			break;
+		}
+		if (last != NULL) {
+			last->nextZitat = copy;
+			copy->prevZitat = last;
+		} else
+			ret = copy;
+		last = copy;
+	}
+	ZitatespuckerCSVClose(&file);
+
+	return ret;
+}
+
+static bool ZitatespuckerCSVEach(const char *filename, const ZitatespuckerCSVOptions *options, ZitatespuckerCSVCallback callback, void *userdata, size_t *passed, const char *caller)
+{
+	if (callback == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, caller, "recieved NULL callback!");
+		return false;
+	}
+
+	ZitatespuckerCSVFile file;
+	if (!ZitatespuckerCSVOpen(&file, filename, options, caller))
+		return false;
+
+	ZitatespuckerZitat Zitat;
+	while (ZitatespuckerCSVNextZitat(&file, &Zitat)) {
+		(*passed)++;
+		if (!callback(&Zitat, userdata))
+			break;
+	}
+	ZitatespuckerCSVClose(&file);
+
+	return true;
+}
@@ -0,0 +1,267 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Diagnostics: errors, warning counters and where messages go
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* Storage that every thread has its own copy of; C11 has a keyword for it, C99 only compiler extensions */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+	#define ZITATESPUCKER_THREAD_LOCAL	_Thread_local
+#elif defined(_MSC_VER)
+	#define ZITATESPUCKER_THREAD_LOCAL	__declspec(thread)
+#else
+	#define ZITATESPUCKER_THREAD_LOCAL	__thread
+#endif
+
+/* Longest message kept for ZitatespuckerDiagGetLastMessage(), including the '\0' */
+#define ZITATESPUCKER_DIAG_MESSAGE_MAX	256
+
+
+static ZITATESPUCKER_THREAD_LOCAL ZitatespuckerError lastError = ZITATESPUCKER_ERROR_NONE;
+static ZITATESPUCKER_THREAD_LOCAL char lastMessage[ZITATESPUCKER_DIAG_MESSAGE_MAX];
+static ZITATESPUCKER_THREAD_LOCAL ZitatespuckerWarnings warningCounts;
+
+static ZitatespuckerDiagSink diagSink = NULL;
+static void *diagSinkUserdata = NULL;
+
+/* Indexed by ZitatespuckerKey */
+static const char *const keyNames[ZITATESPUCKER_KEY_MAX] = {
+	ZITATESPUCKERZITATAUTHOR,
+	ZITATESPUCKERZITATZITAT,
+	ZITATESPUCKERZITATCOMMENT,
+	ZITATESPUCKERZITATDAY,
+	ZITATESPUCKERZITATMONTH,
+	ZITATESPUCKERZITATYEAR,
+	ZITATESPUCKERZITATANNODOMINI
+};
+
+
+/* Static function declarations */
+
+/*
+	Returns the ZitatespuckerKey called keyName, ZITATESPUCKER_KEY_MAX if there is none (or keyName is NULL).
+*/
+static ZitatespuckerKey ZitatespuckerDiagKeyFromName(const char *keyName);
+
+
+/* Externally callable */
+
+ZitatespuckerError ZitatespuckerDiagGetLastError(void)
+{
+	return lastError;
+}
+
+const char *ZitatespuckerDiagGetLastMessage(void)
+{
+	return lastMessage;
+}
+
+void ZitatespuckerDiagClear(void)
+{
+	lastError = ZITATESPUCKER_ERROR_NONE;
+	lastMessage[0] = '\0';
+
+	return;
+}
+
+void ZitatespuckerDiagGetWarnings(ZitatespuckerWarnings *warnings)
+{
+	if (warnings != NULL)
+		*warnings = warningCounts;
+
+	return;
+}
+
+void ZitatespuckerDiagResetWarnings(void)
+{
+	(void) memset(&warningCounts, 0, sizeof(warningCounts));
+
+	return;
+}
+
+void ZitatespuckerDiagAddWarnings(const ZitatespuckerWarnings *warnings)
+{
+	if (warnings == NULL)
+		return;
+
+	for (size_t i = 0; i < ZITATESPUCKER_KEY_MAX; i++) {
+		warningCounts.missing[i] += warnings->missing[i];
+		warningCounts.invalid[i] += warnings->invalid[i];
+	}
+	warningCounts.malformed += warnings->malformed;
+
+	return;
+}
+
+size_t ZitatespuckerDiagPrintWarnings(const ZitatespuckerWarnings *warnings, FILE *file)
+{
+	if (warnings == NULL || file == NULL)
+		return 0;
+
+	size_t lines = 0;
+	for (size_t i = 0; i < ZITATESPUCKER_KEY_MAX; i++) {
+		if (warnings->missing[i] != 0 && fprintf(file, "records missing %s: %zu\n", keyNames[i], warnings->missing[i]) > 0)
+			lines++;
+	}
+	for (size_t i = 0; i < ZITATESPUCKER_KEY_MAX; i++) {
+		if (warnings->invalid[i] != 0 && fprintf(file, "records with an invalid %s: %zu\n", keyNames[i], warnings->invalid[i]) > 0)
+			lines++;
+	}
+	if (warnings->malformed != 0 && fprintf(file, "malformed records skipped: %zu\n", warnings->malformed) > 0)
+		lines++;
+
+	return lines;
+}
+
+const char *ZitatespuckerDiagKeyName(ZitatespuckerKey key)
+{
+	return ((unsigned int) key < ZITATESPUCKER_KEY_MAX ? keyNames[key] : NULL);
+}
+
+const char *ZitatespuckerDiagErrorName(ZitatespuckerError error)
+{
+	switch (error) {
+		case ZITATESPUCKER_ERROR_NONE:
+			return "no error";
+		case ZITATESPUCKER_ERROR_ARGUMENT:
+			return "invalid argument";
+		case ZITATESPUCKER_ERROR_MEMORY:
+			return "out of memory";
+		case ZITATESPUCKER_ERROR_IO:
+			return "input/output error";
+		case ZITATESPUCKER_ERROR_FORMAT:
+			return "malformed data";
+		case ZITATESPUCKER_ERROR_RANGE:
+			return "out of range";
+		case ZITATESPUCKER_ERROR_LIMIT:
+			return "too large";
+		case ZITATESPUCKER_ERROR_UNSUPPORTED:
+			return "not supported by this build";
+		case ZITATESPUCKER_ERROR_BACKEND:
+			return "backend error";
+		default:
+			return "unknown error";
+	}
+}
+
+void ZitatespuckerDiagSetSink(ZitatespuckerDiagSink sink, void *userdata)
+{
+	diagSink = sink;
+	diagSinkUserdata = userdata;
+
+	return;
+}
+
+void ZitatespuckerDiagStderr(const ZitatespuckerDiag *diag, void *userdata)
+{
+	(void) userdata;
+
+	if (diag == NULL)
+		return;
+
+	if (diag->file != NULL)
+		(void) fprintf(stderr, "%s:%d:%s: %s\n", diag->file, diag->line, (diag->function != NULL ? diag->function : "?"), diag->message);
+	else if (diag->level == ZITATESPUCKER_LEVEL_ERROR)
+		(void) fprintf(stderr, "Zitatespucker: %s\n", ZitatespuckerDiagErrorName(diag->error));
+	else
+		(void) fprintf(stderr, "Zitatespucker: warning\n");
+
+	return;
+}
+
+void ZitatespuckerDiagError(ZitatespuckerError error, const char *file, int line, const char *function, const char *format, ...)
+{
+	lastError = error;
+	lastMessage[0] = '\0';
+	if (format != NULL) {
+		va_list args;
+		va_start(args, format);
+		(void) vsnprintf(lastMessage, sizeof(lastMessage), format, args);
+		va_end(args);
+	}
+
+	if (diagSink != NULL) {
+		ZitatespuckerDiag diag = {ZITATESPUCKER_LEVEL_ERROR, error, ZITATESPUCKER_WARNING_MISSING, ZITATESPUCKER_KEY_MAX, file, line, function, lastMessage};
+		diagSink(&diag, diagSinkUserdata);
+	}
+
+	return;
+}
+
+void ZitatespuckerDiagWarning(ZitatespuckerWarningKind warning, const char *keyName, const char *file, int line, const char *function, const char *format, ...)
+{
+	ZitatespuckerKey key = ZITATESPUCKER_KEY_MAX;
+	switch (warning) {
+		case ZITATESPUCKER_WARNING_MISSING:
+			if ((key = ZitatespuckerDiagKeyFromName(keyName)) != ZITATESPUCKER_KEY_MAX)
+				warningCounts.missing[key]++;
+			break;
+		case ZITATESPUCKER_WARNING_INVALID:
+			if ((key = ZitatespuckerDiagKeyFromName(keyName)) != ZITATESPUCKER_KEY_MAX)
+				warningCounts.invalid[key]++;
+			break;
+		case ZITATESPUCKER_WARNING_MALFORMED:
+			warningCounts.malformed++;
+			break;
+	}
+
+	// this is per record, so the message is only formatted for someone to read it
+	if (diagSink == NULL)
+		return;
+
+	char message[ZITATESPUCKER_DIAG_MESSAGE_MAX];
+	message[0] = '\0';
+	if (format != NULL) {
+		va_list args;
+		va_start(args, format);
+		(void) vsnprintf(message, sizeof(message), format, args);
+		va_end(args);
+	}
+
+	ZitatespuckerDiag diag = {ZITATESPUCKER_LEVEL_WARNING, ZITATESPUCKER_ERROR_NONE, warning, key, file, line, function, message};
+	diagSink(&diag, diagSinkUserdata);
+
+	return;
+}
+
+
+/* Static function definitions */
+
+static ZitatespuckerKey ZitatespuckerDiagKeyFromName(const char *keyName)
+{
+	if (keyName == NULL)
+		return ZITATESPUCKER_KEY_MAX;
+
+	for (size_t i = 0; i < ZITATESPUCKER_KEY_MAX; i++) {
+		if (strcmp(keyName, keyNames[i]) == 0)
+			return (ZitatespuckerKey) i;
+	}
+
+	return ZITATESPUCKER_KEY_MAX;
+}
@@ -0,0 +1,696 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Sources compiled into the program
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_embed.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* Indexes written per line of the generated arrays */
+#define ZITATESPUCKER_EMBED_PERLINE		16
+
+
+/* The distinct strings of a list being written, one after the other */
+typedef struct ZitatespuckerEmbedPool {
+	char *data;
+	size_t len;
+	size_t cap;
+	uint32_t *table; /* Open addressing, offsets into data; ZITATESPUCKER_EMBED_NOSTRING for free slots */
+	size_t tableCap; /* A power of two */
+} ZitatespuckerEmbedPool;
+
+/* An element to sort by author */
+typedef struct ZitatespuckerEmbedAuthorKey {
+	const char *author;
+	uint32_t idx;
+} ZitatespuckerEmbedAuthorKey;
+
+
+/* Static function declarations */
+
+/*
+	Returns the string at offset within embed, NULL for ZITATESPUCKER_EMBED_NOSTRING.
+*/
+static inline const char *ZitatespuckerEmbedString(const ZitatespuckerEmbed *embed, uint32_t offset);
+
+/*
+	Like strcmp(), with NULL going before any string.
+*/
+static inline int ZitatespuckerEmbedCompareAuthor(const char *a, const char *b);
+
+/*
+	Returns the date key the byDate index is ordered by (BC before AD, then the year).
+*/
+static inline uint32_t ZitatespuckerEmbedDateKey(bool annodomini, uint16_t year);
+
+/*
+	Store the range of byAuthor holding the elements by authorname in *lo and *hi (hi exclusive).
+*/
+static void ZitatespuckerEmbedAuthorRange(const ZitatespuckerEmbed *embed, const char *authorname, size_t *lo, size_t *hi);
+
+/*
+	Store the range of byDate holding the elements from year in *lo and *hi (hi exclusive).
+*/
+static void ZitatespuckerEmbedDateRange(const ZitatespuckerEmbed *embed, bool annodomini, uint16_t year, size_t *lo, size_t *hi);
+
+/*
+	Returns the first position within index[lo, hi) (which is ordered) holding an index of at least from; hi if there is none.
+*/
+static size_t ZitatespuckerEmbedSkipTo(const uint32_t *index, size_t lo, size_t hi, size_t from);
+
+/*
+	Returns true if the element matches the optional month and day.
+*/
+static inline bool ZitatespuckerEmbedMatchesDay(const ZitatespuckerEmbedZitat *Zitat, uint8_t month, uint8_t day);
+
+/*
+	Returns a newly allocated copy of the element at idx, linked after *last (which is updated), or NULL on error.
+*/
+static ZitatespuckerZitat *ZitatespuckerEmbedCopy(const ZitatespuckerEmbed *embed, size_t idx, ZitatespuckerZitat **last, const char *caller);
+
+/*
+	Returns a newly allocated copy of str, NULL if str is NULL (in which case *failed is left alone) or on error (*failed is set).
+	The length of str is stored in len (0 for NULL).
+*/
+static char *ZitatespuckerEmbedCopyString(const char *str, size_t *len, bool *failed, const char *caller);
+
+/*
+	Returns the offset of str within pool, adding it if it is not in there yet.
+	ZITATESPUCKER_EMBED_NOSTRING for NULL; false is stored in *ok on error.
+*/
+static uint32_t ZitatespuckerEmbedPoolAdd(ZitatespuckerEmbedPool *pool, const char *str, bool *ok, const char *caller);
+
+/*
+	Returns true if name is a valid C identifier.
+*/
+static bool ZitatespuckerEmbedIsIdentifier(const char *name);
+
+/*
+	Write str as a C string literal (without the quotes), escaping all but printable ASCII.
+*/
+static void ZitatespuckerEmbedWriteString(FILE *file, const char *str);
+
+/*
+	Write the generated source of a list (see ZitatespuckerEmbedWrite()).
+*/
+static void ZitatespuckerEmbedWriteSource(FILE *file, const char *name, const ZitatespuckerEmbedPool *pool, const ZitatespuckerEmbedZitat *Zitate, const uint32_t *byAuthor, const uint32_t *byDate, size_t len);
+
+/*
+	Write the array index of len elements, called name_suffix.
+*/
+static void ZitatespuckerEmbedWriteIndex(FILE *file, const char *name, const char *suffix, const uint32_t *index, size_t len);
+
+/*
+	qsort() callbacks.
+*/
+static int ZitatespuckerEmbedSortAuthor(const void *a, const void *b);
+static int ZitatespuckerEmbedSortDate(const void *a, const void *b);
+
+
+/* Externally callable */
+
+bool ZitatespuckerEmbedWrite(const ZitatespuckerZitat *ZitatList, const char *name, FILE *csource, FILE *header)
+{
+	if (ZitatList == NULL || name == NULL || csource == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL ZitatList, name or csource!");
+		return false;
+	} else if (!ZitatespuckerEmbedIsIdentifier(name)) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "\"%s\" is not a valid C identifier.", name);
+		return false;
+	}
+
+	while (ZitatList->prevZitat != NULL)
+		ZitatList = ZitatList->prevZitat;
+	size_t len = 0;
+	for (const ZitatespuckerZitat *tmp = ZitatList; tmp != NULL; tmp = tmp->nextZitat)
+		len++;
+	if (len >= UINT32_MAX) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_LIMIT, __func__, "too many elements (%zu).", len);
+		return false;
+	}
+
+	ZitatespuckerEmbedPool pool = {NULL, 0, 0, NULL, 64};
+	while (pool.tableCap < len * 4)
+		pool.tableCap *= 2;
+	ZitatespuckerEmbedZitat *Zitate = (ZitatespuckerEmbedZitat *) malloc(len * sizeof(ZitatespuckerEmbedZitat));
+	ZitatespuckerEmbedAuthorKey *authorKeys = (ZitatespuckerEmbedAuthorKey *) malloc(len * sizeof(ZitatespuckerEmbedAuthorKey));
+	uint64_t *dateKeys = (uint64_t *) malloc(len * sizeof(uint64_t));
+	uint32_t *byAuthor = (uint32_t *) malloc(len * sizeof(uint32_t));
+	uint32_t *byDate = (uint32_t *) malloc(len * sizeof(uint32_t));
+	pool.table = (uint32_t *) malloc(pool.tableCap * sizeof(uint32_t));
+	bool ok = (Zitate != NULL && authorKeys != NULL && dateKeys != NULL && byAuthor != NULL && byDate != NULL && pool.table != NULL);
+	if (!ok) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+	} else {
+		(void) memset(pool.table, 0xFF, pool.tableCap * sizeof(uint32_t));
+
+		size_t i = 0;
+		for (const ZitatespuckerZitat *tmp = ZitatList; tmp != NULL && ok; tmp = tmp->nextZitat, i++) {
+			Zitate[i].author = ZitatespuckerEmbedPoolAdd(&pool, tmp->author, &ok, __func__);
+			Zitate[i].zitat = ZitatespuckerEmbedPoolAdd(&pool, tmp->zitat, &ok, __func__);
+			Zitate[i].comment = ZitatespuckerEmbedPoolAdd(&pool, tmp->comment, &ok, __func__);
+			Zitate[i].year = tmp->year;
+			Zitate[i].month = tmp->month;
+			Zitate[i].day = tmp->day;
+			Zitate[i].annodomini = tmp->annodomini;
+			authorKeys[i].author = tmp->author;
+			authorKeys[i].idx = (uint32_t) i;
+			dateKeys[i] = ((uint64_t) ZitatespuckerEmbedDateKey(tmp->annodomini, tmp->year) << 32) | (uint64_t) i;
+		}
+	}
+
+	if (ok) {
+		qsort(authorKeys, len, sizeof(ZitatespuckerEmbedAuthorKey), ZitatespuckerEmbedSortAuthor);
+		qsort(dateKeys, len, sizeof(uint64_t), ZitatespuckerEmbedSortDate);
+		for (size_t i = 0; i < len; i++) {
+			byAuthor[i] = authorKeys[i].idx;
+			byDate[i] = (uint32_t) dateKeys[i];
+		}
+
+		ZitatespuckerEmbedWriteSource(csource, name, &pool, Zitate, byAuthor, byDate, len);
+		if (header != NULL) {
+			(void) fputs("/* Generated by ZitatespuckerEmbedWrite(), do not edit */\n", header);
+			(void) fputs("#ifndef ZITATESPUCKER_EMBED_", header);
+			for (const char *cur = name; *cur != '\0'; cur++)
+				(void) fputc((*cur >= 'a' && *cur <= 'z' ? *cur - 'a' + 'A' : *cur), header);
+			(void) fputs("_H\n#define ZITATESPUCKER_EMBED_", header);
+			for (const char *cur = name; *cur != '\0'; cur++)
+				(void) fputc((*cur >= 'a' && *cur <= 'z' ? *cur - 'a' + 'A' : *cur), header);
+			(void) fprintf(header, "_H\n\n#include \"Zitatespucker/Zitatespucker_embed.h\"\n\nextern const ZitatespuckerEmbed %s;\n\n#endif\n", name);
+		}
+
+		if (ferror(csource) || (header != NULL && ferror(header))) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "could not write the generated code.");
+			ok = false;
+		}
+	}
+
+	free((void *) pool.table);
+	free((void *) pool.data);
+	free((void *) byDate);
+	free((void *) byAuthor);
+	free((void *) dateKeys);
+	free((void *) authorKeys);
+	free((void *) Zitate);
+
+	return ok;
+}
+
+size_t ZitatespuckerEmbedGetAmount(const ZitatespuckerEmbed *embed)
+{
+	return (embed != NULL ? embed->len : 0);
+}
+
+const char *ZitatespuckerEmbedGetAuthor(const ZitatespuckerEmbed *embed, size_t idx)
+{
+	return (embed != NULL && idx < embed->len ? ZitatespuckerEmbedString(embed, embed->Zitate[idx].author) : NULL);
+}
+
+const char *ZitatespuckerEmbedGetZitatText(const ZitatespuckerEmbed *embed, size_t idx)
+{
+	return (embed != NULL && idx < embed->len ? ZitatespuckerEmbedString(embed, embed->Zitate[idx].zitat) : NULL);
+}
+
+const char *ZitatespuckerEmbedGetComment(const ZitatespuckerEmbed *embed, size_t idx)
+{
+	return (embed != NULL && idx < embed->len ? ZitatespuckerEmbedString(embed, embed->Zitate[idx].comment) : NULL);
+}
+
+bool ZitatespuckerEmbedGetDate(const ZitatespuckerEmbed *embed, size_t idx, bool *annodomini, uint16_t *year, uint8_t *month, uint8_t *day)
+{
+	if (embed == NULL || idx >= embed->len)
+		return false;
+
+	const ZitatespuckerEmbedZitat *Zitat = &embed->Zitate[idx];
+	if (annodomini != NULL)
+		*annodomini = Zitat->annodomini;
+	if (year != NULL)
+		*year = Zitat->year;
+	if (month != NULL)
+		*month = Zitat->month;
+	if (day != NULL)
+		*day = Zitat->day;
+
+	return true;
+}
+
+size_t ZitatespuckerEmbedFindByAuthor(const ZitatespuckerEmbed *embed, const char *authorname, size_t from)
+{
+	if (embed == NULL || authorname == NULL)
+		return ZITATESPUCKER_EMBED_NONE;
+
+	size_t lo, hi;
+	ZitatespuckerEmbedAuthorRange(embed, authorname, &lo, &hi);
+	size_t pos = ZitatespuckerEmbedSkipTo(embed->byAuthor, lo, hi, from);
+
+	return (pos < hi ? (size_t) embed->byAuthor[pos] : ZITATESPUCKER_EMBED_NONE);
+}
+
+size_t ZitatespuckerEmbedFindByDate(const ZitatespuckerEmbed *embed, bool annodomini, uint16_t year, uint8_t month, uint8_t day, size_t from)
+{
+	if (embed == NULL)
+		return ZITATESPUCKER_EMBED_NONE;
+
+	size_t lo, hi;
+	ZitatespuckerEmbedDateRange(embed, annodomini, year, &lo, &hi);
+	for (size_t pos = ZitatespuckerEmbedSkipTo(embed->byDate, lo, hi, from); pos < hi; pos++) {
+		if (ZitatespuckerEmbedMatchesDay(&embed->Zitate[embed->byDate[pos]], month, day))
+			return (size_t) embed->byDate[pos];
+	}
+
+	return ZITATESPUCKER_EMBED_NONE;
+}
+
+size_t ZitatespuckerEmbedGetAmountByAuthor(const ZitatespuckerEmbed *embed, const char *authorname)
+{
+	if (embed == NULL || authorname == NULL)
+		return 0;
+
+	size_t lo, hi;
+	ZitatespuckerEmbedAuthorRange(embed, authorname, &lo, &hi);
+
+	return hi - lo;
+}
+
+size_t ZitatespuckerEmbedGetAmountByDate(const ZitatespuckerEmbed *embed, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	// the same dates ZitatespuckerEmbedGetZitatAllByDate() refuses
+	if (embed == NULL || (year == 0 && annodomini == false) || (day != 0 && month == 0))
+		return 0;
+
+	size_t lo, hi;
+	ZitatespuckerEmbedDateRange(embed, annodomini, year, &lo, &hi);
+	if (month == 0 && day == 0)
+		return hi - lo;
+
+	size_t ret = 0;
+	for (size_t pos = lo; pos < hi; pos++)
+		ret += ZitatespuckerEmbedMatchesDay(&embed->Zitate[embed->byDate[pos]], month, day);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerEmbedGetZitatAll(const ZitatespuckerEmbed *embed)
+{
+	if (embed == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL embed!");
+		return NULL;
+	}
+
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *last = NULL;
+	for (size_t idx = 0; idx < embed->len; idx++) {
+		ZitatespuckerZitat *tmp;
+		if ((tmp = ZitatespuckerEmbedCopy(embed, idx, &last, __func__)) == NULL) {
+			ZitatespuckerZitatFree(ret);
+			return NULL;
+		}
+		if (ret == NULL)
+			ret = tmp;
+	}
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerEmbedGetZitatSingle(const ZitatespuckerEmbed *embed, size_t idx)
+{
+	if (embed == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL embed!");
+		return NULL;
+	} else if (idx >= embed->len) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "index %zu is out of range (%zu elements).", idx, embed->len);
+		return NULL;
+	}
+
+	ZitatespuckerZitat *last = NULL;
+
+	return ZitatespuckerEmbedCopy(embed, idx, &last, __func__);
+}
+
+ZitatespuckerZitat *ZitatespuckerEmbedGetZitatAllByAuthor(const ZitatespuckerEmbed *embed, const char *authorname)
+{
+	if (embed == NULL || authorname == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL embed or authorname!");
+		return NULL;
+	}
+
+	size_t lo, hi;
+	ZitatespuckerEmbedAuthorRange(embed, authorname, &lo, &hi);
+
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *last = NULL;
+	for (size_t pos = lo; pos < hi; pos++) {
+		ZitatespuckerZitat *tmp;
+		if ((tmp = ZitatespuckerEmbedCopy(embed, embed->byAuthor[pos], &last, __func__)) == NULL) {
+			ZitatespuckerZitatFree(ret);
+			return NULL;
+		}
+		if (ret == NULL)
+			ret = tmp;
+	}
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerEmbedGetZitatAllByDate(const ZitatespuckerEmbed *embed, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	if (embed == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL embed!");
+		return NULL;
+	} else if (year == 0 && annodomini == false) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "annodomini cannot be false when year is 0.");
+		return NULL;
+	} else if (day != 0 && month == 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "month cannot be 0 when day is not 0.");
+		return NULL;
+	}
+
+	size_t lo, hi;
+	ZitatespuckerEmbedDateRange(embed, annodomini, year, &lo, &hi);
+
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *last = NULL;
+	for (size_t pos = lo; pos < hi; pos++) {
+		if (!ZitatespuckerEmbedMatchesDay(&embed->Zitate[embed->byDate[pos]], month, day))
+			continue;
+		ZitatespuckerZitat *tmp;
+		if ((tmp = ZitatespuckerEmbedCopy(embed, embed->byDate[pos], &last, __func__)) == NULL) {
+			ZitatespuckerZitatFree(ret);
+			return NULL;
+		}
+		if (ret == NULL)
+			ret = tmp;
+	}
+
+	return ret;
+}
+
+
+/* Static function definitions */
+
+static inline const char *ZitatespuckerEmbedString(const ZitatespuckerEmbed *embed, uint32_t offset)
+{
+	return (offset != ZITATESPUCKER_EMBED_NOSTRING ? embed->strings + offset : NULL);
+}
+
+static inline int ZitatespuckerEmbedCompareAuthor(const char *a, const char *b)
+{
+	if (a == NULL || b == NULL)
+		return (b == NULL) - (a == NULL);
+
+	return strcmp(a, b);
+}
+
+static inline uint32_t ZitatespuckerEmbedDateKey(bool annodomini, uint16_t year)
+{
+	return ((uint32_t) annodomini << 16) | (uint32_t) year;
+}
+
+static void ZitatespuckerEmbedAuthorRange(const ZitatespuckerEmbed *embed, const char *authorname, size_t *lo, size_t *hi)
+{
+	// first element not before authorname
+	size_t left = 0, right = embed->len;
+	while (left < right) {
+		size_t mid = left + (right - left) / 2;
+		if (ZitatespuckerEmbedCompareAuthor(ZitatespuckerEmbedString(embed, embed->Zitate[embed->byAuthor[mid]].author), authorname) < 0)
+			left = mid + 1;
+		else
+			right = mid;
+	}
+	*lo = left;
+
+	// first element after it
+	right = embed->len;
+	while (left < right) {
+		size_t mid = left + (right - left) / 2;
+		if (ZitatespuckerEmbedCompareAuthor(ZitatespuckerEmbedString(embed, embed->Zitate[embed->byAuthor[mid]].author), authorname) <= 0)
+			left = mid + 1;
+		else
+			right = mid;
+	}
+	*hi = left;
+
+	return;
+}
+
+static void ZitatespuckerEmbedDateRange(const ZitatespuckerEmbed *embed, bool annodomini, uint16_t year, size_t *lo, size_t *hi)
+{
+	uint32_t key = ZitatespuckerEmbedDateKey(annodomini, year);
+
+	size_t left = 0, right = embed->len;
+	while (left < right) {
+		size_t mid = left + (right - left) / 2;
+		const ZitatespuckerEmbedZitat *Zitat = &embed->Zitate[embed->byDate[mid]];
+		if (ZitatespuckerEmbedDateKey(Zitat->annodomini, Zitat->year) < key)
+			left = mid + 1;
+		else
+			right = mid;
+	}
+	*lo = left;
+
+	right = embed->len;
+	while (left < right) {
+		size_t mid = left + (right - left) / 2;
+		const ZitatespuckerEmbedZitat *Zitat = &embed->Zitate[embed->byDate[mid]];
+		if (ZitatespuckerEmbedDateKey(Zitat->annodomini, Zitat->year) <= key)
+			left = mid + 1;
+		else
+			right = mid;
+	}
+	*hi = left;
+
+	return;
+}
+
+static size_t ZitatespuckerEmbedSkipTo(const uint32_t *index, size_t lo, size_t hi, size_t from)
+{
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if ((size_t) index[mid] < from)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+static inline bool ZitatespuckerEmbedMatchesDay(const ZitatespuckerEmbedZitat *Zitat, uint8_t month, uint8_t day)
+{
+	return ((month == 0 || Zitat->month == month) && (day == 0 || Zitat->day == day));
+}
+
+static ZitatespuckerZitat *ZitatespuckerEmbedCopy(const ZitatespuckerEmbed *embed, size_t idx, ZitatespuckerZitat **last, const char *caller)
+{
+	ZitatespuckerZitat *ret;
+	if ((ret = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "malloc() returned NULL.");
+		return NULL;
+	}
+	ZitatespuckerZitatInit(ret);
+
+	const ZitatespuckerEmbedZitat *Zitat = &embed->Zitate[idx];
+	bool failed = false;
+	ret->author = ZitatespuckerEmbedCopyString(ZitatespuckerEmbedString(embed, Zitat->author), &ret->authorLen, &failed, caller);
+	ret->zitat = ZitatespuckerEmbedCopyString(ZitatespuckerEmbedString(embed, Zitat->zitat), &ret->zitatLen, &failed, caller);
+	ret->comment = ZitatespuckerEmbedCopyString(ZitatespuckerEmbedString(embed, Zitat->comment), &ret->commentLen, &failed, caller);
+	ret->authorHash = ZitatespuckerAuthorHash(ret->author, ret->authorLen);
+	ret->year = Zitat->year;
+	ret->month = Zitat->month;
+	ret->day = Zitat->day;
+	ret->annodomini = Zitat->annodomini;
+	if (failed) {
+		ZitatespuckerZitatFree(ret);
+		return NULL;
+	}
+
+	if (*last != NULL) {
+		(*last)->nextZitat = ret;
+		ret->prevZitat = *last;
+	}
+	*last = ret;
+
+	return ret;
+}
+
+static char *ZitatespuckerEmbedCopyString(const char *str, size_t *len, bool *failed, const char *caller)
+{
+	*len = 0;
+	if (str == NULL)
+		return NULL;
+
+	size_t tmpLen = strlen(str);
+	char *ret;
+	if ((ret = (char *) malloc(tmpLen + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "malloc() returned NULL.");
+		*failed = true;
+		return NULL;
+	}
+	*len = tmpLen;
+
+	return (char *) memcpy(ret, str, tmpLen + 1);
+}
+
+static uint32_t ZitatespuckerEmbedPoolAdd(ZitatespuckerEmbedPool *pool, const char *str, bool *ok, const char *caller)
+{
+	if (str == NULL || !*ok)
+		return ZITATESPUCKER_EMBED_NOSTRING;
+
+	// FNV-1a
+	uint64_t hash = UINT64_C(0xCBF29CE484222325);
+	size_t len = 0;
+	for (; str[len] != '\0'; len++)
+		hash = (hash ^ (unsigned char) str[len]) * UINT64_C(0x100000001B3);
+
+	size_t slot = (size_t) hash & (pool->tableCap - 1);
+	while (pool->table[slot] != ZITATESPUCKER_EMBED_NOSTRING) {
+		if (strcmp(pool->data + pool->table[slot], str) == 0)
+			return pool->table[slot];
+		slot = (slot + 1) & (pool->tableCap - 1);
+	}
+
+	if (pool->len + len + 1 >= UINT32_MAX) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_LIMIT, caller, "the strings take more than 4 GiB.");
+		*ok = false;
+		return ZITATESPUCKER_EMBED_NOSTRING;
+	}
+	if (pool->len + len + 1 > pool->cap) {
+		size_t cap = (pool->cap != 0 ? pool->cap * 2 : 4096);
+		while (cap < pool->len + len + 1)
+			cap *= 2;
+		char *tmp;
+		if ((tmp = (char *) realloc(pool->data, cap)) == NULL) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "realloc() returned NULL.");
+			*ok = false;
+			return ZITATESPUCKER_EMBED_NOSTRING;
+		}
+		pool->data = tmp;
+		pool->cap = cap;
+	}
+
+	uint32_t ret = (uint32_t) pool->len;
+	(void) memcpy(pool->data + pool->len, str, len + 1);
+	pool->len += len + 1;
+	pool->table[slot] = ret;
+
+	return ret;
+}
+
+static bool ZitatespuckerEmbedIsIdentifier(const char *name)
+{
+	if (!((*name >= 'a' && *name <= 'z') || (*name >= 'A' && *name <= 'Z') || *name == '_'))
+		return false;
+
+	for (name++; *name != '\0'; name++) {
+		if (!((*name >= 'a' && *name <= 'z') || (*name >= 'A' && *name <= 'Z') || (*name >= '0' && *name <= '9') || *name == '_'))
+			return false;
+	}
+
+	return true;
+}
+
+static void ZitatespuckerEmbedWriteString(FILE *file, const char *str)
+{
+	for (const unsigned char *cur = (const unsigned char *) str; *cur != '\0'; cur++) {
+		// '?' is escaped as well so no trigraphs come about; octal escapes take at most three digits, so they cannot swallow what follows
+		if (*cur == '"' || *cur == '\\' || *cur == '?')
+			(void) fprintf(file, "\\%c", *cur);
+		else if (*cur >= 0x20 && *cur < 0x7F)
+			(void) fputc(*cur, file);
+		else
+			(void) fprintf(file, "\\%03o", (unsigned int) *cur);
+	}
+
+	return;
+}
+
+static void ZitatespuckerEmbedWriteSource(FILE *file, const char *name, const ZitatespuckerEmbedPool *pool, const ZitatespuckerEmbedZitat *Zitate, const uint32_t *byAuthor, const uint32_t *byDate, size_t len)
+{
+	(void) fprintf(file, "/* Generated by ZitatespuckerEmbedWrite(), do not edit */\n\n#include \"Zitatespucker/Zitatespucker_embed.h\"\n\n\n");
+
+	(void) fprintf(file, "static const char %s_strings[] =\n", name);
+	if (pool->len == 0)
+		(void) fputs("\t\"\"", file);
+	for (size_t offset = 0; offset < pool->len; offset += strlen(pool->data + offset) + 1) {
+		(void) fputs((offset == 0 ? "\t\"" : "\n\t\""), file);
+		ZitatespuckerEmbedWriteString(file, pool->data + offset);
+		(void) fputs("\\0\"", file);
+	}
+	(void) fputs(";\n\n", file);
+
+	(void) fprintf(file, "static const ZitatespuckerEmbedZitat %s_Zitate[] = {\n", name);
+	for (size_t i = 0; i < len; i++) {
+		const uint32_t offsets[3] = {Zitate[i].author, Zitate[i].zitat, Zitate[i].comment};
+		(void) fputs("\t{", file);
+		for (int j = 0; j < 3; j++) {
+			if (offsets[j] == ZITATESPUCKER_EMBED_NOSTRING)
+				(void) fputs("ZITATESPUCKER_EMBED_NOSTRING, ", file);
+			else
+				(void) fprintf(file, "%lu, ", (unsigned long) offsets[j]);
+		}
+		(void) fprintf(file, "%u, %u, %u, %s}%s\n", (unsigned int) Zitate[i].year, (unsigned int) Zitate[i].month, (unsigned int) Zitate[i].day, (Zitate[i].annodomini ? "true" : "false"), (i + 1 < len ? "," : ""));
+	}
+	(void) fputs("};\n\n", file);
+
+	ZitatespuckerEmbedWriteIndex(file, name, "byAuthor", byAuthor, len);
+	ZitatespuckerEmbedWriteIndex(file, name, "byDate", byDate, len);
+
+	(void) fprintf(file, "const ZitatespuckerEmbed %s = {%zu, %s_Zitate, %s_strings, %s_byAuthor, %s_byDate};\n", name, len, name, name, name, name);
+
+	return;
+}
+
+static void ZitatespuckerEmbedWriteIndex(FILE *file, const char *name, const char *suffix, const uint32_t *index, size_t len)
+{
+	(void) fprintf(file, "static const uint32_t %s_%s[] = {", name, suffix);
+	for (size_t i = 0; i < len; i++)
+		(void) fprintf(file, "%s%lu%s", (i % ZITATESPUCKER_EMBED_PERLINE == 0 ? "\n\t" : " "), (unsigned long) index[i], (i + 1 < len ? "," : ""));
+	(void) fputs("\n};\n\n", file);
+
+	return;
+}
+
+static int ZitatespuckerEmbedSortAuthor(const void *a, const void *b)
+{
+	const ZitatespuckerEmbedAuthorKey *keyA = (const ZitatespuckerEmbedAuthorKey *) a;
+	const ZitatespuckerEmbedAuthorKey *keyB = (const ZitatespuckerEmbedAuthorKey *) b;
+
+	int cmp = ZitatespuckerEmbedCompareAuthor(keyA->author, keyB->author);
+	if (cmp != 0)
+		return cmp;
+
+	return (keyA->idx > keyB->idx) - (keyA->idx < keyB->idx);
+}
+
+static int ZitatespuckerEmbedSortDate(const void *a, const void *b)
+{
+	uint64_t keyA = *(const uint64_t *) a;
+	uint64_t keyB = *(const uint64_t *) b;
+
+	return (keyA > keyB) - (keyA < keyB);
+}
@@ -0,0 +1,412 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Writing quotes as .json
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_export.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* Initial size of an in-memory document; it doubles whenever it runs full */
+#define ZITATESPUCKER_EXPORT_INITIAL	4096
+
+/* Written as a string literal, so strlen() can be done at compile time */
+#define ZITATESPUCKER_EXPORT_LITERAL(exporter, s)	ZitatespuckerExportWrite((exporter), (s), sizeof(s) - 1)
+
+
+typedef enum ZitatespuckerExportTarget {
+	ZITATESPUCKER_EXPORT_FILE,
+	ZITATESPUCKER_EXPORT_FD,
+	ZITATESPUCKER_EXPORT_BUFFER
+} ZitatespuckerExportTarget;
+
+struct ZitatespuckerExport {
+	ZitatespuckerExportTarget target;
+	FILE *file;
+	int fd;
+	char *buf;
+	size_t used;
+	size_t size;
+	size_t count; /* Elements written so far */
+	bool lines; /* true --> JSON Lines, false --> a whole document */
+	bool failed;
+};
+
+
+/*
+	What a byte turns into within a JSON string: 0 if it is copied as it is,
+	'u' for a \u00XX escape, or the character that follows the backslash otherwise.
+*/
+static const char ZitatespuckerExportEscape[256] = {
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't', 'n', 'u', 'f', 'r', 'u', 'u',
+	'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+	['"'] = '"',
+	['\\'] = '\\'
+};
+
+
+/* Static function declarations */
+
+/*
+	Create an exporter for target and write the start of the document (unless it writes lines).
+	NULL on error.
+*/
+static ZitatespuckerExport *ZitatespuckerExportCreate(ZitatespuckerExportTarget target, FILE *file, int fd, bool lines);
+
+/*
+	Append Zitat as a single line, for exporters writing JSON Lines.
+	false on error.
+*/
+static bool ZitatespuckerExportLine(ZitatespuckerExport *exporter, const ZitatespuckerZitat *Zitat);
+
+/*
+	Append len bytes of data, flushing or growing the buffer as needed.
+	false on error.
+*/
+static bool ZitatespuckerExportWrite(ZitatespuckerExport *exporter, const char *data, size_t len);
+
+/*
+	Hand everything buffered to the FILE * or file descriptor (or make room, for in-memory documents).
+	false on error.
+*/
+static bool ZitatespuckerExportFlush(ZitatespuckerExport *exporter);
+
+/*
+	Append str as an escaped JSON string (including the quotes).
+	false on error.
+*/
+static bool ZitatespuckerExportString(ZitatespuckerExport *exporter, const char *str);
+
+/*
+	Append val in decimal.
+	false on error.
+*/
+static bool ZitatespuckerExportNumber(ZitatespuckerExport *exporter, unsigned int val);
+
+
+/* Externally callable */
+
+ZitatespuckerExport *ZitatespuckerExportToFile(FILE *file)
+{
+	if (file == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL file!");
+		return NULL;
+	}
+
+	return ZitatespuckerExportCreate(ZITATESPUCKER_EXPORT_FILE, file, -1, false);
+}
+
+ZitatespuckerExport *ZitatespuckerExportToFd(int fd)
+{
+	if (fd < 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved invalid file descriptor!");
+		return NULL;
+	}
+
+	return ZitatespuckerExportCreate(ZITATESPUCKER_EXPORT_FD, NULL, fd, false);
+}
+
+ZitatespuckerExport *ZitatespuckerExportToBuffer(void)
+{
+	return ZitatespuckerExportCreate(ZITATESPUCKER_EXPORT_BUFFER, NULL, -1, false);
+}
+
+ZitatespuckerExport *ZitatespuckerExportLinesToFile(FILE *file)
+{
+	if (file == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL file!");
+		return NULL;
+	}
+
+	return ZitatespuckerExportCreate(ZITATESPUCKER_EXPORT_FILE, file, -1, true);
+}
+
+ZitatespuckerExport *ZitatespuckerExportLinesToFd(int fd)
+{
+	if (fd < 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved invalid file descriptor!");
+		return NULL;
+	}
+
+	return ZitatespuckerExportCreate(ZITATESPUCKER_EXPORT_FD, NULL, fd, true);
+}
+
+ZitatespuckerExport *ZitatespuckerExportLinesToBuffer(void)
+{
+	return ZitatespuckerExportCreate(ZITATESPUCKER_EXPORT_BUFFER, NULL, -1, true);
+}
+
+bool ZitatespuckerExportAdd(ZitatespuckerExport *exporter, const ZitatespuckerZitat *Zitat)
+{
+	if (exporter == NULL || Zitat == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL exporter or Zitat!");
+		return false;
+	}
+
+	if (exporter->lines)
+		return ZitatespuckerExportLine(exporter, Zitat);
+
+	bool ok = (exporter->count == 0 ? ZITATESPUCKER_EXPORT_LITERAL(exporter, "\n\t\t{") : ZITATESPUCKER_EXPORT_LITERAL(exporter, ",\n\t\t{"));
+	if (Zitat->author != NULL)
+		ok = ok && ZITATESPUCKER_EXPORT_LITERAL(exporter, "\n\t\t\t\"" ZITATESPUCKERZITATAUTHOR "\": ") && ZitatespuckerExportString(exporter, Zitat->author) && ZITATESPUCKER_EXPORT_LITERAL(exporter, ",");
+	if (Zitat->zitat != NULL)
+		ok = ok && ZITATESPUCKER_EXPORT_LITERAL(exporter, "\n\t\t\t\"" ZITATESPUCKERZITATZITAT "\": ") && ZitatespuckerExportString(exporter, Zitat->zitat) && ZITATESPUCKER_EXPORT_LITERAL(exporter, ",");
+	if (Zitat->comment != NULL)
+		ok = ok && ZITATESPUCKER_EXPORT_LITERAL(exporter, "\n\t\t\t\"" ZITATESPUCKERZITATCOMMENT "\": ") && ZitatespuckerExportString(exporter, Zitat->comment) && ZITATESPUCKER_EXPORT_LITERAL(exporter, ",");
+	ok = ok && ZITATESPUCKER_EXPORT_LITERAL(exporter, "\n\t\t\t\"" ZITATESPUCKERZITATDAY "\": ") && ZitatespuckerExportNumber(exporter, Zitat->day)
+		&& ZITATESPUCKER_EXPORT_LITERAL(exporter, ",\n\t\t\t\"" ZITATESPUCKERZITATMONTH "\": ") && ZitatespuckerExportNumber(exporter, Zitat->month)
+		&& ZITATESPUCKER_EXPORT_LITERAL(exporter, ",\n\t\t\t\"" ZITATESPUCKERZITATYEAR "\": ") && ZitatespuckerExportNumber(exporter, Zitat->year)
+		&& (Zitat->annodomini ? ZITATESPUCKER_EXPORT_LITERAL(exporter, ",\n\t\t\t\"" ZITATESPUCKERZITATANNODOMINI "\": true\n\t\t}")
+			: ZITATESPUCKER_EXPORT_LITERAL(exporter, ",\n\t\t\t\"" ZITATESPUCKERZITATANNODOMINI "\": false\n\t\t}"));
+	exporter->count++;
+
+	return ok;
+}
+
+bool ZitatespuckerExportAddList(ZitatespuckerExport *exporter, const ZitatespuckerZitat *ZitatList)
+{
+	if (ZitatList == NULL)
+		return (exporter != NULL && !exporter->failed);
+
+	while (ZitatList->prevZitat != NULL)
+		ZitatList = ZitatList->prevZitat;
+
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat) {
+		if (!ZitatespuckerExportAdd(exporter, cur))
+			return false;
+	}
+
+	return true;
+}
+
+bool ZitatespuckerExportAddSnapshot(ZitatespuckerExport *exporter, const ZitatespuckerSnapshot *snapshot)
+{
+	size_t len = ZitatespuckerSnapshotLen(snapshot);
+	for (size_t i = 0; i < len; i++) {
+		if (!ZitatespuckerExportAdd(exporter, ZitatespuckerSnapshotGet(snapshot, i)))
+			return false;
+	}
+
+	return (exporter != NULL && !exporter->failed);
+}
+
+bool ZitatespuckerExportCallback(const ZitatespuckerZitat *Zitat, void *exporter)
+{
+	return ZitatespuckerExportAdd((ZitatespuckerExport *) exporter, Zitat);
+}
+
+bool ZitatespuckerExportFinish(ZitatespuckerExport *exporter, char **buffer, size_t *len)
+{
+	if (exporter == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL exporter!");
+		return false;
+	}
+
+	// the '\0' is only needed (and only counted) for in-memory documents
+	bool ok = (exporter->lines || ZITATESPUCKER_EXPORT_LITERAL(exporter, "\n\t]\n}\n"));
+	if (exporter->target == ZITATESPUCKER_EXPORT_BUFFER)
+		ok = ok && ZitatespuckerExportWrite(exporter, "", 1);
+	else
+		ok = ok && ZitatespuckerExportFlush(exporter);
+
+	if (exporter->target == ZITATESPUCKER_EXPORT_FILE && fflush(exporter->file) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "fflush() failed.");
+		ok = false;
+	}
+
+	if (ok && exporter->target == ZITATESPUCKER_EXPORT_BUFFER && buffer != NULL) {
+		*buffer = exporter->buf;
+		if (len != NULL)
+			*len = exporter->used - 1;
+	} else
+		free((void *) exporter->buf);
+	free((void *) exporter);
+
+	return ok;
+}
+
+
+/* Static function definitions */
+
+static ZitatespuckerExport *ZitatespuckerExportCreate(ZitatespuckerExportTarget target, FILE *file, int fd, bool lines)
+{
+	ZitatespuckerExport *exporter;
+	if ((exporter = (ZitatespuckerExport *) malloc(sizeof(ZitatespuckerExport))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	exporter->target = target;
+	exporter->file = file;
+	exporter->fd = fd;
+	exporter->used = 0;
+	exporter->size = (target == ZITATESPUCKER_EXPORT_BUFFER ? ZITATESPUCKER_EXPORT_INITIAL : ZITATESPUCKER_EXPORT_BUFSIZE);
+	exporter->count = 0;
+	exporter->lines = lines;
+	exporter->failed = false;
+	if ((exporter->buf = (char *) malloc(exporter->size)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		free((void *) exporter);
+		return NULL;
+	}
+
+	if (!lines)
+		(void) ZITATESPUCKER_EXPORT_LITERAL(exporter, "{\n\t\"" ZITATESPUCKERZITATKEYNAME "\": [");
+
+	return exporter;
+}
+
+static bool ZitatespuckerExportLine(ZitatespuckerExport *exporter, const ZitatespuckerZitat *Zitat)
+{
+	// same fields as ZitatespuckerExportAdd(), but without any whitespace
+	bool ok = ZITATESPUCKER_EXPORT_LITERAL(exporter, "{");
+	if (Zitat->author != NULL)
+		ok = ok && ZITATESPUCKER_EXPORT_LITERAL(exporter, "\"" ZITATESPUCKERZITATAUTHOR "\":") && ZitatespuckerExportString(exporter, Zitat->author) && ZITATESPUCKER_EXPORT_LITERAL(exporter, ",");
+	if (Zitat->zitat != NULL)
+		ok = ok && ZITATESPUCKER_EXPORT_LITERAL(exporter, "\"" ZITATESPUCKERZITATZITAT "\":") && ZitatespuckerExportString(exporter, Zitat->zitat) && ZITATESPUCKER_EXPORT_LITERAL(exporter, ",");
+	if (Zitat->comment != NULL)
+		ok = ok && ZITATESPUCKER_EXPORT_LITERAL(exporter, "\"" ZITATESPUCKERZITATCOMMENT "\":") && ZitatespuckerExportString(exporter, Zitat->comment) && ZITATESPUCKER_EXPORT_LITERAL(exporter, ",");
+	ok = ok && ZITATESPUCKER_EXPORT_LITERAL(exporter, "\"" ZITATESPUCKERZITATDAY "\":") && ZitatespuckerExportNumber(exporter, Zitat->day)
+		&& ZITATESPUCKER_EXPORT_LITERAL(exporter, ",\"" ZITATESPUCKERZITATMONTH "\":") && ZitatespuckerExportNumber(exporter, Zitat->month)
+		&& ZITATESPUCKER_EXPORT_LITERAL(exporter, ",\"" ZITATESPUCKERZITATYEAR "\":") && ZitatespuckerExportNumber(exporter, Zitat->year)
+		&& (Zitat->annodomini ? ZITATESPUCKER_EXPORT_LITERAL(exporter, ",\"" ZITATESPUCKERZITATANNODOMINI "\":true}\n")
+			: ZITATESPUCKER_EXPORT_LITERAL(exporter, ",\"" ZITATESPUCKERZITATANNODOMINI "\":false}\n"));
+	exporter->count++;
+
+	return ok;
+}
+
+static bool ZitatespuckerExportWrite(ZitatespuckerExport *exporter, const char *data, size_t len)
+{
+	if (exporter->failed)
+		return false;
+
+	while (len > 0) {
+		if (exporter->used == exporter->size && !ZitatespuckerExportFlush(exporter))
+			return false;
+
+		size_t n = exporter->size - exporter->used;
+		if (n > len)
+			n = len;
+		(void) memcpy(exporter->buf + exporter->used, data, n);
+		exporter->used += n;
+		data += n;
+		len -= n;
+	}
+
+	return true;
+}
+
+static bool ZitatespuckerExportFlush(ZitatespuckerExport *exporter)
+{
+	if (exporter->failed)
+		return false;
+
+	switch (exporter->target) {
+		case ZITATESPUCKER_EXPORT_BUFFER: {
+			char *tmpBuf;
+			if ((tmpBuf = (char *) realloc(exporter->buf, exporter->size * 2)) == NULL) {
+				ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "realloc() returned NULL.");
+				exporter->failed = true;
+				return false;
+			}
+			exporter->buf = tmpBuf;
+			exporter->size *= 2;
+			return true;
+		}
+		case ZITATESPUCKER_EXPORT_FILE:
+			if (fwrite(exporter->buf, 1, exporter->used, exporter->file) != exporter->used) {
+				ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "fwrite() failed.");
+				exporter->failed = true;
+				return false;
+			}
+			break;
+		case ZITATESPUCKER_EXPORT_FD: {
+			size_t done = 0;
+			while (done < exporter->used) {
+				ssize_t n = write(exporter->fd, exporter->buf + done, exporter->used - done);
+				if (n < 0 && errno == EINTR)
+					continue;
+				if (n <= 0) {
+					ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "write() failed.");
+					exporter->failed = true;
+					return false;
+				}
+				done += (size_t) n;
+			}
+			break;
+		}
+	}
+	exporter->used = 0;
+
+	return true;
+}
+
+static bool ZitatespuckerExportString(ZitatespuckerExport *exporter, const char *str)
+{
+	static const char hex[] = "0123456789abcdef";
+
+	if (!ZITATESPUCKER_EXPORT_LITERAL(exporter, "\""))
+		return false;
+
+	// copy runs of bytes that need no escaping in one go
+	const unsigned char *run = (const unsigned char *) str;
+	const unsigned char *c = run;
+	for (; *c != '\0'; c++) {
+		char esc = ZitatespuckerExportEscape[*c];
+		if (esc == 0)
+			continue;
+
+		if (!ZitatespuckerExportWrite(exporter, (const char *) run, (size_t) (c - run)))
+			return false;
+		if (esc == 'u') {
+			char seq[6] = {'\\', 'u', '0', '0', hex[*c >> 4], hex[*c & 0xF]};
+			if (!ZitatespuckerExportWrite(exporter, seq, sizeof(seq)))
+				return false;
+		} else {
+			char seq[2] = {'\\', esc};
+			if (!ZitatespuckerExportWrite(exporter, seq, sizeof(seq)))
+				return false;
+		}
+		run = c + 1;
+	}
+
+	return (ZitatespuckerExportWrite(exporter, (const char *) run, (size_t) (c - run)) && ZITATESPUCKER_EXPORT_LITERAL(exporter, "\""));
+}
+
+static bool ZitatespuckerExportNumber(ZitatespuckerExport *exporter, unsigned int val)
+{
+	char digits[12];
+	size_t pos = sizeof(digits);
+	do {
+		digits[--pos] = (char) ('0' + val % 10);
+		val /= 10;
+	} while (val != 0);
+
+	return ZitatespuckerExportWrite(exporter, digits + pos, sizeof(digits) - pos);
+}
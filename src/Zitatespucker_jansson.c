@@ -21,6 +21,7 @@
 
 
 /* Standard headers */
+#include <stdlib.h>
 #include <string.h>
 
 
@@ -30,6 +31,7 @@
 
 /* Internal headers */
 #include "../Zitatespucker/Zitatespucker_json.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
 
 
 /* Static function declarations */
@@ -43,28 +45,48 @@
 static json_t *ZitatespuckerJSONGetZitatArrayFromFile(const char *filename);
 
 /*
-	Returns a pointer to single populated ZitatespuckerZitat.
+	Returns a pointer to single ZitatespuckerZitat, populated with the fields within fields.
 	idx refers to the array index within ZitatArray.
 	NULL on error.
 
 	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
 */
-static ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingle(json_t *ZitatArray, const size_t idx);
+static ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingle(json_t *ZitatArray, const size_t idx, ZitatespuckerFields fields);
 
 /*
-	Populate a ZitatespuckerZitat struct with the information within ZitatObj and return it.
+	Parse element (len bytes, read through the index of a file) and store a ZitatespuckerZitat populated with the fields within fields
+	in Zitat (NULL on error).
+	false (without an error being reported) if element cannot be parsed; the whole file should be parsed then.
+
+	The stored object must be freed with ZitatespuckerZitatFree().
+*/
+static bool ZitatespuckerJSONGetZitatFromElement(const char *element, size_t len, ZitatespuckerFields fields, ZitatespuckerZitat **Zitat);
+
+/*
+	Populate a ZitatespuckerZitat struct with the fields within fields from the information within ZitatObj and return it.
 	NULL on error.
 	
 	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
 */
-static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_t *ZitatObj);
+static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_t *ZitatObj, ZitatespuckerFields fields);
 
 /*
-	Return the string content of key keyName within json object Parent.
+	Store the date information within ZitatObj in Zitat, clamped to the ranges of its members.
+*/
+static void ZitatespuckerJSONGetDate(json_t *ZitatObj, ZitatespuckerZitat *Zitat);
+
+/*
+	Returns true if the date information within ZitatObj matches the given one
+	(see ZitatespuckerJSONGetZitatAllFromFileByDate()).
+*/
+static bool ZitatespuckerJSONMatchesDate(json_t *ZitatObj, bool annodomini, uint16_t year, uint8_t month, uint8_t day);
+
+/*
+	Return the string content of key keyName within json object Parent, storing its length in len.
 
 	NULL on error.
 */
-static inline char *ZitatespuckerJSONGetStringAllocated(json_t *Parent, const char *keyName);
+static inline char *ZitatespuckerJSONGetStringAllocated(json_t *Parent, const char *keyName, size_t *len);
 
 /*
 	Return the integer content of key keyName within json object Parent.
@@ -76,6 +98,11 @@ static inline json_int_t ZitatespuckerJSONGetInt(json_t *Parent, const char *key
 
 size_t ZitatespuckerJSONGetAmountFromFile(const char *filename)
 {
+	// an up to date index knows without parsing anything
+	size_t amount;
+	if (ZitatespuckerJSONIndexGetAmount(filename, &amount))
+		return amount;
+
 	json_t *zitatscope = ZitatespuckerJSONGetZitatArrayFromFile(filename);
 
 	size_t ret = 0;
@@ -89,17 +116,38 @@ size_t ZitatespuckerJSONGetAmountFromFile(const char *filename)
 
 ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingleFromFile(const char *filename, const size_t idx)
 {
+	return ZitatespuckerJSONGetZitatSingleFromFileFields(filename, idx, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingleFromFileFields(const char *filename, const size_t idx, ZitatespuckerFields fields)
+{
+	// with an up to date index, only the element asked for is read and parsed
+	char *element;
+	size_t elementLen;
+	if (ZitatespuckerJSONIndexGetElement(filename, idx, &element, &elementLen)) {
+		ZitatespuckerZitat *ret = NULL;
+		bool parsed = (element == NULL || ZitatespuckerJSONGetZitatFromElement(element, elementLen, fields, &ret));
+		free((void *) element);
+		if (parsed)
+			return ret;
+	}
+
 	json_t *ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename);
 	if (ZitatArray == NULL)
 		return NULL;
 	else {
-		ZitatespuckerZitat *ret = ZitatespuckerJSONGetZitatSingle(ZitatArray, idx);
+		ZitatespuckerZitat *ret = ZitatespuckerJSONGetZitatSingle(ZitatArray, idx, fields);
 		json_decref(ZitatArray);
 		return ret;
 	}
 }
 
 ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFile(const char *filename)
+{
+	return ZitatespuckerJSONGetZitatAllFromFileFields(filename, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileFields(const char *filename, ZitatespuckerFields fields)
 {
 	json_t *ZitatArray;
 	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
@@ -107,13 +155,13 @@ ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFile(const char *filename)
 	else {
 		size_t len = json_array_size(ZitatArray);
 		
-		ZitatespuckerZitat *ret = ZitatespuckerJSONGetZitatSingle(ZitatArray, 0);
+		ZitatespuckerZitat *ret = ZitatespuckerJSONGetZitatSingle(ZitatArray, 0, fields);
 		if (ret != NULL) {
 			size_t i = 1;
 			ZitatespuckerZitat *cur = ret;
 			ZitatespuckerZitat *prev;
 			for ( ; i < len; i++) {
-				cur->nextZitat = ZitatespuckerJSONGetZitatSingle(ZitatArray, i);
+				cur->nextZitat = ZitatespuckerJSONGetZitatSingle(ZitatArray, i, fields);
 				if (cur->nextZitat != NULL) {
 					prev = cur;
 					cur = cur->nextZitat;
@@ -127,6 +175,155 @@ ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFile(const char *filename)
 	}
 }
 
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByAuthor(const char *filename, const char *authorname)
+{
+	return ZitatespuckerJSONGetZitatAllFromFileByAuthorFields(filename, authorname, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByAuthorFields(const char *filename, const char *authorname, ZitatespuckerFields fields)
+{
+	if (authorname == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL authorname!");
+		return NULL;
+	}
+
+	json_t *ZitatArray;
+	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
+		return NULL;
+
+	size_t authorlen = strlen(authorname);
+	size_t len = json_array_size(ZitatArray);
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *cur = NULL;
+	for (size_t i = 0; i < len; i++) {
+		// only look at the author before copying anything; jansson knows its length, which rules out most of them
+		json_t *ZitatObj = json_array_get(ZitatArray, i);
+		json_t *tmpObj;
+		const char *tmpS;
+		if (ZitatObj == NULL || (tmpObj = json_object_get(ZitatObj, ZITATESPUCKERZITATAUTHOR)) == NULL || json_string_length(tmpObj) != authorlen
+		|| (tmpS = json_string_value(tmpObj)) == NULL || memcmp(tmpS, authorname, authorlen) != 0)
+			continue;
+
+		ZitatespuckerZitat *Zitat = ZitatespuckerJSONGetPopulatedStruct(ZitatObj, fields);
+		if (Zitat == NULL)
+			break;
+		if (cur != NULL) {
+			cur->nextZitat = Zitat;
+			Zitat->prevZitat = cur;
+		} else
+			ret = Zitat;
+		cur = Zitat;
+	}
+	json_decref(ZitatArray);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByDate(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	return ZitatespuckerJSONGetZitatAllFromFileByDateFields(filename, annodomini, year, month, day, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByDateFields(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields)
+{
+	if (year == 0 && annodomini == false) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "annodomini cannot be false when year is 0.");
+		return NULL;
+	} else if (day != 0 && month == 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "month cannot be 0 when day is not 0.");
+		return NULL;
+	}
+
+	json_t *ZitatArray;
+	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
+		return NULL;
+
+	size_t len = json_array_size(ZitatArray);
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *cur = NULL;
+	for (size_t i = 0; i < len; i++) {
+		json_t *ZitatObj = json_array_get(ZitatArray, i);
+		if (ZitatObj == NULL || !ZitatespuckerJSONMatchesDate(ZitatObj, annodomini, year, month, day))
+			continue;
+
+		ZitatespuckerZitat *Zitat = ZitatespuckerJSONGetPopulatedStruct(ZitatObj, fields);
+		if (Zitat == NULL)
+			break;
+		if (cur != NULL) {
+			cur->nextZitat = Zitat;
+			Zitat->prevZitat = cur;
+		} else
+			ret = Zitat;
+		cur = Zitat;
+	}
+	json_decref(ZitatArray);
+
+	return ret;
+}
+
+size_t ZitatespuckerJSONForEachFromFile(const char *filename, ZitatespuckerJSONCallback callback, void *userdata)
+{
+	if (callback == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL callback!");
+		return 0;
+	}
+
+	json_t *ZitatArray;
+	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
+		return 0;
+
+	size_t len = json_array_size(ZitatArray);
+	size_t ret = 0;
+	for (size_t i = 0; i < len; i++) {
+		ZitatespuckerZitat *Zitat = ZitatespuckerJSONGetZitatSingle(ZitatArray, i, ZITATESPUCKER_FIELD_ALL);
+		if (Zitat == NULL)
+			continue;
+
+		bool more = callback(Zitat, userdata);
+		ZitatespuckerZitatFree(Zitat);
+		ret++;
+		if (!more)
+			break;
+	}
+	json_decref(ZitatArray);
+
+	return ret;
+}
+
+ZitatespuckerCounts *ZitatespuckerJSONCountFromFile(const char *filename, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter)
+{
+	ZitatespuckerCounter *counter;
+	if ((counter = ZitatespuckerCountBegin(group, filter)) == NULL)
+		return NULL;
+
+	json_t *ZitatArray;
+	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL) {
+		ZitatespuckerCountsFree(ZitatespuckerCountEnd(counter));
+		return NULL;
+	}
+
+	size_t len = json_array_size(ZitatArray);
+	for (size_t i = 0; i < len; i++) {
+		json_t *ZitatObj = json_array_get(ZitatArray, i);
+		if (ZitatObj == NULL)
+			continue;
+
+		// the author is borrowed from the parsed file, the text is not needed at all
+		ZitatespuckerZitat Zitat;
+		ZitatespuckerZitatInit(&Zitat);
+		json_t *tmpObj = json_object_get(ZitatObj, ZITATESPUCKERZITATAUTHOR);
+		if (tmpObj != NULL && (Zitat.authorLen = json_string_length(tmpObj)) >= 1)
+			Zitat.author = (char *) json_string_value(tmpObj);
+		ZitatespuckerJSONGetDate(ZitatObj, &Zitat);
+
+		if (!ZitatespuckerCountAdd(counter, &Zitat))
+			break;
+	}
+	json_decref(ZitatArray);
+
+	return ZitatespuckerCountEnd(counter);
+}
+
 
 /* Static function definitions */
 
@@ -135,18 +332,14 @@ static json_t *ZitatespuckerJSONGetZitatArrayFromFile(const char *filename)
 	json_error_t err;
 	json_t *globalscope = json_load_file(filename, 0, &err); // remember: reference count
 	if (globalscope == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: json_load_file() failed:\n%s", __FILE__, __LINE__, __func__, err.text);
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "json_load_file() failed: %s", err.text);
 		return NULL;
 	}
 
 	json_t *zitatscope = json_object_get(globalscope, ZITATESPUCKERZITATKEYNAME);
 	if (zitatscope == NULL) {
 		json_decref(globalscope);
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: json_object_get() failed:\nMaybe the key %s does not exist?", __FILE__, __LINE__, __func__, ZITATESPUCKERZITATKEYNAME);
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "json_object_get() failed: Maybe the key %s does not exist?", ZITATESPUCKERZITATKEYNAME);
 		return NULL;
 	}
 
@@ -156,50 +349,72 @@ static json_t *ZitatespuckerJSONGetZitatArrayFromFile(const char *filename)
 	// json_array_size() also checks this, but the return value does not tell us if it was the case on error
 	if (!json_is_array(zitatscope)) {
 		json_decref(zitatscope);
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: Key %s is not an array!\n", __FILE__, __LINE__, __func__, ZITATESPUCKERZITATKEYNAME);
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "Key %s is not an array!", ZITATESPUCKERZITATKEYNAME);
 		return NULL;
 	}
 
 	return zitatscope;
 }
 
-static ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingle(json_t *ZitatArray, const size_t idx)
+static ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingle(json_t *ZitatArray, const size_t idx, ZitatespuckerFields fields)
 {
 	json_t *ZitatObj = json_array_get(ZitatArray, idx);
 	if (ZitatObj != NULL) {
-		ZitatespuckerZitat *ret = ZitatespuckerJSONGetPopulatedStruct(ZitatObj);
+		ZitatespuckerZitat *ret = ZitatespuckerJSONGetPopulatedStruct(ZitatObj, fields);
 		return ret;
 	} else {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: json_array_get() returned NULL, wrong index?\n", __FILE__, __LINE__, __func__);
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "json_array_get() returned NULL, wrong index?");
 		return NULL;
 	}
 }
 
-static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_t *ZitatObj)
+static bool ZitatespuckerJSONGetZitatFromElement(const char *element, size_t len, ZitatespuckerFields fields, ZitatespuckerZitat **Zitat)
+{
+	// elements need not be objects, so do not insist on one
+	json_error_t err;
+	json_t *ZitatObj;
+	if ((ZitatObj = json_loadb(element, len, JSON_DECODE_ANY, &err)) == NULL)
+		return false;
+
+	*Zitat = ZitatespuckerJSONGetPopulatedStruct(ZitatObj, fields);
+	json_decref(ZitatObj);
+
+	return true;
+}
+
+static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_t *ZitatObj, ZitatespuckerFields fields)
 {
 	ZitatespuckerZitat *Zitat;
 	if ((Zitat = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat))) == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: malloc() returned NULL.\n", __FILE__, __LINE__, __func__);
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
 		return NULL;
 	}
 	// init
 	ZitatespuckerZitatInit(Zitat);
 
 	// author
-	Zitat->author = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATAUTHOR);
+	if (fields & ZITATESPUCKER_FIELD_AUTHOR) {
+		Zitat->author = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATAUTHOR, &Zitat->authorLen);
+		Zitat->authorHash = ZitatespuckerAuthorHash(Zitat->author, Zitat->authorLen);
+	}
 
 	// zitat
-	Zitat->zitat = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATZITAT);
+	if (fields & ZITATESPUCKER_FIELD_ZITAT)
+		Zitat->zitat = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATZITAT, &Zitat->zitatLen);
 
 	// comment
-	Zitat->comment = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATCOMMENT);
+	if (fields & ZITATESPUCKER_FIELD_COMMENT)
+		Zitat->comment = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATCOMMENT, &Zitat->commentLen);
 
+	// day, month, year, annodomini
+	if (fields & ZITATESPUCKER_FIELD_DATE)
+		ZitatespuckerJSONGetDate(ZitatObj, Zitat);
+
+	return Zitat;
+}
+
+static void ZitatespuckerJSONGetDate(json_t *ZitatObj, ZitatespuckerZitat *Zitat)
+{
 	// day
 	json_int_t tmpInt = ZitatespuckerJSONGetInt(ZitatObj, ZITATESPUCKERZITATDAY);
 	if (tmpInt < 0)
@@ -228,27 +443,54 @@ static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_t *ZitatObj)
 	json_t *tmpBool = json_object_get(ZitatObj, ZITATESPUCKERZITATANNODOMINI);
 	if (tmpBool != NULL) {
 		Zitat->annodomini = (json_is_true(tmpBool) ? true : false);
+	} else
+		ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_MISSING, ZITATESPUCKERZITATANNODOMINI, __func__, "Key \"%s\" not found.", ZITATESPUCKERZITATANNODOMINI);
+}
+
+static bool ZitatespuckerJSONMatchesDate(json_t *ZitatObj, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	// same clamping as in ZitatespuckerJSONGetDate()
+	if ((json_is_true(json_object_get(ZitatObj, ZITATESPUCKERZITATANNODOMINI)) ? true : false) != annodomini)
+		return false;
+
+	json_int_t tmpInt = ZitatespuckerJSONGetInt(ZitatObj, ZITATESPUCKERZITATYEAR);
+	if ((tmpInt < 0 ? 0 : (tmpInt > UINT16_MAX ? UINT16_MAX : tmpInt)) != year)
+		return false;
+
+	if (month != 0) {
+		tmpInt = ZitatespuckerJSONGetInt(ZitatObj, ZITATESPUCKERZITATMONTH);
+		if ((tmpInt < 0 ? 0 : (tmpInt > UINT8_MAX ? UINT8_MAX : tmpInt)) != month)
+			return false;
 	}
 
-	return Zitat;
+	if (day != 0) {
+		tmpInt = ZitatespuckerJSONGetInt(ZitatObj, ZITATESPUCKERZITATDAY);
+		if ((tmpInt < 0 ? 0 : (tmpInt > UINT8_MAX ? UINT8_MAX : tmpInt)) != day)
+			return false;
+	}
+
+	return true;
 }
 
-static inline char *ZitatespuckerJSONGetStringAllocated(json_t *Parent, const char *keyName)
+static inline char *ZitatespuckerJSONGetStringAllocated(json_t *Parent, const char *keyName, size_t *len)
 {
+	*len = 0;
 	json_t *child = json_object_get(Parent, keyName);
 	if (child != NULL) {
-		size_t len;
-		if ((len = json_string_length(child)) >= 1) {
-			char *tmpS = malloc(len);
-			if (tmpS != NULL)
-				strcpy(tmpS, json_string_value(child));
+		size_t tmpLen;
+		if ((tmpLen = json_string_length(child)) >= 1) {
+			char *tmpS = malloc(tmpLen + 1);
+			if (tmpS != NULL) {
+				(void) memcpy(tmpS, json_string_value(child), tmpLen + 1);
+				// a "\u0000" within the string (if the file was read with JSON_ALLOW_NUL) ends it early
+				const char *nul = (const char *) memchr(tmpS, '\0', tmpLen);
+				*len = (nul != NULL ? (size_t) (nul - tmpS) : tmpLen);
+			}
 			return tmpS;
 		} else
 			return NULL;
 	} else {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: Key \"%s\" not found.\n", __FILE__, __LINE__, __func__, keyName);
-		#endif
+		ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_MISSING, keyName, __func__, "Key \"%s\" not found.", keyName);
 		return NULL;
 	}
 }
@@ -257,12 +499,12 @@ static inline json_int_t ZitatespuckerJSONGetInt(json_t *Parent, const char *key
 {
 	json_t *child = json_object_get(Parent, keyName);
 	if (child != NULL) {
+		if (!json_is_integer(child))
+			ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_INVALID, keyName, __func__, "No valid conversion for key \"%s\".", keyName);
 		json_int_t tmpInt = json_integer_value(child);
 		return tmpInt;
 	} else {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: Key \"%s\" not found.\n", __FILE__, __LINE__, __func__, keyName);
-		#endif
+		ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_MISSING, keyName, __func__, "Key \"%s\" not found.", keyName);
 		return 0;
 	}
 }
@@ -23,7 +23,6 @@
 /* Standard headers */
 #include <stdio.h>
 #include <stdlib.h>
-#include <errno.h>
 #include <limits.h>
 #include <string.h>
 
@@ -34,6 +33,7 @@
 
 /* Internal headers */
 #include "../Zitatespucker/Zitatespucker_json.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
 
 
 /* Static function declarations */
@@ -47,28 +47,56 @@
 static json_object *ZitatespuckerJSONGetZitatArrayFromFile(const char *filename);
 
 /*
-	Returns a pointer to single populated ZitatespuckerZitat.
+	Read all of filename into a newly allocated, '\0'-terminated buffer and store its length (without the '\0') in len.
+	Returns NULL on error.
+
+	The returned (non-NULL) buffer must be freed using free().
+*/
+static char *ZitatespuckerJSONReadFile(const char *filename, size_t *len);
+
+/*
+	Returns a pointer to single ZitatespuckerZitat, populated with the fields within fields.
 	idx refers to the array index within ZitatArray.
 	NULL on error.
 
 	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
 */
-static ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingle(json_object *ZitatArray, const size_t idx);
+static ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingle(json_object *ZitatArray, const size_t idx, ZitatespuckerFields fields);
+
+/*
+	Parse element (len bytes, read through the index of a file) and store a ZitatespuckerZitat populated with the fields within fields
+	in Zitat (NULL on error).
+	false (without an error being reported) if element cannot be parsed; the whole file should be parsed then.
+
+	The stored object must be freed with ZitatespuckerZitatFree().
+*/
+static bool ZitatespuckerJSONGetZitatFromElement(const char *element, size_t len, ZitatespuckerFields fields, ZitatespuckerZitat **Zitat);
 
 /*
-	Populate a ZitatespuckerZitat struct with the information within ZitatObj and return it.
+	Populate a ZitatespuckerZitat struct with the fields within fields from the information within ZitatObj and return it.
 	NULL on error.
 	
 	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
 */
-static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_object *ZitatObj);
+static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_object *ZitatObj, ZitatespuckerFields fields);
+
+/*
+	Store the date information within ZitatObj in Zitat, clamped to the ranges of its members.
+*/
+static void ZitatespuckerJSONGetDate(json_object *ZitatObj, ZitatespuckerZitat *Zitat);
 
 /*
-	Get child object of name keyName from Parent, returning its string content.
+	Returns true if the date information within ZitatObj matches the given one
+	(see ZitatespuckerJSONGetZitatAllFromFileByDate()).
+*/
+static bool ZitatespuckerJSONMatchesDate(json_object *ZitatObj, bool annodomini, uint16_t year, uint8_t month, uint8_t day);
+
+/*
+	Get child object of name keyName from Parent, returning its string content and storing its length in len.
 
 	NULL on error.
 */
-static inline char *ZitatespuckerJSONGetStringAllocated(json_object *Parent, const char *keyName, json_object *child);
+static inline char *ZitatespuckerJSONGetStringAllocated(json_object *Parent, const char *keyName, json_object *child, size_t *len);
 
 /*
 	Get child object of name keyName from Parent, returning its integer content.
@@ -80,6 +108,11 @@ static inline int32_t ZitatespuckerJSONGetInt(json_object *Parent, const char *k
 
 size_t ZitatespuckerJSONGetAmountFromFile(const char *filename)
 {
+	// an up to date index knows without parsing anything
+	size_t amount;
+	if (ZitatespuckerJSONIndexGetAmount(filename, &amount))
+		return amount;
+
 	json_object *ZitatArray;
 	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
 		return 0;
@@ -92,17 +125,38 @@ size_t ZitatespuckerJSONGetAmountFromFile(const char *filename)
 
 ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingleFromFile(const char *filename, const size_t idx)
 {
+	return ZitatespuckerJSONGetZitatSingleFromFileFields(filename, idx, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingleFromFileFields(const char *filename, const size_t idx, ZitatespuckerFields fields)
+{
+	// with an up to date index, only the element asked for is read and parsed
+	char *element;
+	size_t elementLen;
+	if (ZitatespuckerJSONIndexGetElement(filename, idx, &element, &elementLen)) {
+		ZitatespuckerZitat *ret = NULL;
+		bool parsed = (element == NULL || ZitatespuckerJSONGetZitatFromElement(element, elementLen, fields, &ret));
+		free((void *) element);
+		if (parsed)
+			return ret;
+	}
+
 	json_object *ZitatArray;
 	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
 		return NULL;
 	else {
-		ZitatespuckerZitat *ret = ZitatespuckerJSONGetZitatSingle(ZitatArray, idx);
+		ZitatespuckerZitat *ret = ZitatespuckerJSONGetZitatSingle(ZitatArray, idx, fields);
 		json_object_put(ZitatArray);
 		return ret;
 	}
 }
 
 ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFile(const char *filename)
+{
+	return ZitatespuckerJSONGetZitatAllFromFileFields(filename, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileFields(const char *filename, ZitatespuckerFields fields)
 {
 	json_object *ZitatArray;
 	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
@@ -110,13 +164,13 @@ ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFile(const char *filename)
 	else {
 		size_t len = json_object_array_length(ZitatArray);
 		
-		ZitatespuckerZitat *ret = ZitatespuckerJSONGetZitatSingle(ZitatArray, 0);
+		ZitatespuckerZitat *ret = ZitatespuckerJSONGetZitatSingle(ZitatArray, 0, fields);
 		if (ret != NULL) {
 			size_t i = 1;
 			ZitatespuckerZitat *cur = ret;
 			ZitatespuckerZitat *prev;
 			for ( ; i < len; i++) {
-				cur->nextZitat = ZitatespuckerJSONGetZitatSingle(ZitatArray, i);
+				cur->nextZitat = ZitatespuckerJSONGetZitatSingle(ZitatArray, i, fields);
 				if (cur->nextZitat != NULL) {
 					prev = cur;
 					cur = cur->nextZitat;
@@ -130,24 +184,193 @@ ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFile(const char *filename)
 	}
 }
 
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByAuthor(const char *filename, const char *authorname)
+{
+	return ZitatespuckerJSONGetZitatAllFromFileByAuthorFields(filename, authorname, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByAuthorFields(const char *filename, const char *authorname, ZitatespuckerFields fields)
+{
+	if (authorname == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL authorname!");
+		return NULL;
+	}
+
+	json_object *ZitatArray;
+	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
+		return NULL;
+
+	size_t authorlen = strlen(authorname);
+	size_t len = json_object_array_length(ZitatArray);
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *cur = NULL;
+	for (size_t i = 0; i < len; i++) {
+		// only look at the author before copying anything; json-c knows its length, which rules out most of them
+		json_object *ZitatObj = json_object_array_get_idx(ZitatArray, i);
+		json_object *tmpObj;
+		const char *tmpS;
+		if (ZitatObj == NULL || !json_object_object_get_ex(ZitatObj, ZITATESPUCKERZITATAUTHOR, &tmpObj)
+		|| !json_object_is_type(tmpObj, json_type_string) || (size_t) json_object_get_string_len(tmpObj) != authorlen
+		|| (tmpS = json_object_get_string(tmpObj)) == NULL || memcmp(tmpS, authorname, authorlen) != 0)
+			continue;
+
+		ZitatespuckerZitat *Zitat = ZitatespuckerJSONGetPopulatedStruct(ZitatObj, fields);
+		if (Zitat == NULL)
+			break;
+		if (cur != NULL) {
+			cur->nextZitat = Zitat;
+			Zitat->prevZitat = cur;
+		} else
+			ret = Zitat;
+		cur = Zitat;
+	}
+	json_object_put(ZitatArray);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByDate(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	return ZitatespuckerJSONGetZitatAllFromFileByDateFields(filename, annodomini, year, month, day, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerJSONGetZitatAllFromFileByDateFields(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields)
+{
+	if (year == 0 && annodomini == false) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "annodomini cannot be false when year is 0.");
+		return NULL;
+	} else if (day != 0 && month == 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "month cannot be 0 when day is not 0.");
+		return NULL;
+	}
+
+	json_object *ZitatArray;
+	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
+		return NULL;
+
+	size_t len = json_object_array_length(ZitatArray);
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *cur = NULL;
+	for (size_t i = 0; i < len; i++) {
+		json_object *ZitatObj = json_object_array_get_idx(ZitatArray, i);
+		if (ZitatObj == NULL || !ZitatespuckerJSONMatchesDate(ZitatObj, annodomini, year, month, day))
+			continue;
+
+		ZitatespuckerZitat *Zitat = ZitatespuckerJSONGetPopulatedStruct(ZitatObj, fields);
+		if (Zitat == NULL)
+			break;
+		if (cur != NULL) {
+			cur->nextZitat = Zitat;
+			Zitat->prevZitat = cur;
+		} else
+			ret = Zitat;
+		cur = Zitat;
+	}
+	json_object_put(ZitatArray);
+
+	return ret;
+}
+
+size_t ZitatespuckerJSONForEachFromFile(const char *filename, ZitatespuckerJSONCallback callback, void *userdata)
+{
+	if (callback == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL callback!");
+		return 0;
+	}
+
+	json_object *ZitatArray;
+	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL)
+		return 0;
+
+	size_t len = json_object_array_length(ZitatArray);
+	size_t ret = 0;
+	for (size_t i = 0; i < len; i++) {
+		ZitatespuckerZitat *Zitat = ZitatespuckerJSONGetZitatSingle(ZitatArray, i, ZITATESPUCKER_FIELD_ALL);
+		if (Zitat == NULL)
+			continue;
+
+		bool more = callback(Zitat, userdata);
+		ZitatespuckerZitatFree(Zitat);
+		ret++;
+		if (!more)
+			break;
+	}
+	json_object_put(ZitatArray);
+
+	return ret;
+}
+
+ZitatespuckerCounts *ZitatespuckerJSONCountFromFile(const char *filename, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter)
+{
+	ZitatespuckerCounter *counter;
+	if ((counter = ZitatespuckerCountBegin(group, filter)) == NULL)
+		return NULL;
+
+	json_object *ZitatArray;
+	if ((ZitatArray = ZitatespuckerJSONGetZitatArrayFromFile(filename)) == NULL) {
+		ZitatespuckerCountsFree(ZitatespuckerCountEnd(counter));
+		return NULL;
+	}
+
+	size_t len = json_object_array_length(ZitatArray);
+	for (size_t i = 0; i < len; i++) {
+		json_object *ZitatObj = json_object_array_get_idx(ZitatArray, i);
+		if (ZitatObj == NULL)
+			continue;
+
+		// the author is borrowed from the parsed file, the text is not needed at all
+		ZitatespuckerZitat Zitat;
+		ZitatespuckerZitatInit(&Zitat);
+		json_object *tmpObj;
+		if (json_object_object_get_ex(ZitatObj, ZITATESPUCKERZITATAUTHOR, &tmpObj) && (Zitat.authorLen = json_object_get_string_len(tmpObj)) >= 1)
+			Zitat.author = (char *) json_object_get_string(tmpObj);
+		ZitatespuckerJSONGetDate(ZitatObj, &Zitat);
+
+		if (!ZitatespuckerCountAdd(counter, &Zitat))
+			break;
+	}
+	json_object_put(ZitatArray);
+
+	return ZitatespuckerCountEnd(counter);
+}
+
 
 /* Static function definitions */
 
 static json_object *ZitatespuckerJSONGetZitatArrayFromFile(const char *filename)
 {
-	json_object *globalscope;
-	if ((globalscope = json_object_from_file(filename)) == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: json_object_from_file() failed:\n%s", __FILE__, __LINE__, __func__, json_util_get_last_err());
-		#endif
+	// json_object_from_file() reports failure through json_util_get_last_err(), which is one buffer for the whole process,
+	// so do the reading ourselves and let a json_tokener (whose error state is local) do the parsing
+	char *buf;
+	size_t buflen;
+	if ((buf = ZitatespuckerJSONReadFile(filename, &buflen)) == NULL)
+		return NULL;
+
+	if (buflen > INT_MAX) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_LIMIT, __func__, "\"%s\" is too large for json-c.", filename);
+		free((void *) buf);
+		return NULL;
+	}
+
+	json_tokener *tok;
+	if ((tok = json_tokener_new()) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "json_tokener_new() returned NULL.");
+		free((void *) buf);
 		return NULL;
 	}
 
+	json_object *globalscope = json_tokener_parse_ex(tok, buf, (int) buflen);
+	if (globalscope == NULL)
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "json_tokener_parse_ex() failed: %s", json_tokener_error_desc(json_tokener_get_error(tok)));
+	json_tokener_free(tok);
+	free((void *) buf);
+
+	if (globalscope == NULL)
+		return NULL;
+
 	json_object *ZitatArray;
 	if (!json_object_object_get_ex(globalscope, ZITATESPUCKERZITATKEYNAME, &ZitatArray)) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: json_object_object_get_ex() failed:\nKey does not exist.\n", __FILE__, __LINE__, __func__);
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "json_object_object_get_ex() failed: Key does not exist.");
 		json_object_put(globalscope);
 		return NULL;
 	} else {
@@ -157,27 +380,83 @@ static json_object *ZitatespuckerJSONGetZitatArrayFromFile(const char *filename)
 	}
 }
 
-static ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingle(json_object *ZitatArray, const size_t idx)
+static char *ZitatespuckerJSONReadFile(const char *filename, size_t *len)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	FILE *file;
+	if ((file = fopen(filename, "rb")) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "fopen() failed for \"%s\".", filename);
+		return NULL;
+	}
+
+	long filelen;
+	if (fseek(file, 0, SEEK_END) != 0 || (filelen = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "Could not determine the size of \"%s\".", filename);
+		(void) fclose(file);
+		return NULL;
+	}
+
+	char *buf;
+	if ((buf = (char *) malloc((size_t) filelen + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		(void) fclose(file);
+		return NULL;
+	}
+
+	*len = fread(buf, 1, (size_t) filelen, file);
+	if (ferror(file)) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "fread() failed for \"%s\".", filename);
+		free((void *) buf);
+		(void) fclose(file);
+		return NULL;
+	}
+	buf[*len] = '\0';
+	(void) fclose(file);
+
+	return buf;
+}
+
+static ZitatespuckerZitat *ZitatespuckerJSONGetZitatSingle(json_object *ZitatArray, const size_t idx, ZitatespuckerFields fields)
 {
 	json_object *ZitatObj = json_object_array_get_idx(ZitatArray, idx);
 	if (ZitatObj != NULL) {
-		ZitatespuckerZitat *ret = ZitatespuckerJSONGetPopulatedStruct(ZitatObj);
+		ZitatespuckerZitat *ret = ZitatespuckerJSONGetPopulatedStruct(ZitatObj, fields);
 		return ret;
 	} else {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: json_object_array_get_idx() returned NULL, wrong index?\n", __FILE__, __LINE__, __func__);
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "json_object_array_get_idx() returned NULL, wrong index?");
 		return NULL;
 	}
 }
 
-static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_object *ZitatObj)
+static bool ZitatespuckerJSONGetZitatFromElement(const char *element, size_t len, ZitatespuckerFields fields, ZitatespuckerZitat **Zitat)
+{
+	if (len >= INT_MAX)
+		return false;
+
+	json_tokener *tok;
+	if ((tok = json_tokener_new()) == NULL)
+		return false;
+	// passing the '\0' as well ends numbers and literals, which could go on otherwise
+	json_object *ZitatObj = json_tokener_parse_ex(tok, element, (int) len + 1);
+	bool ret = (ZitatObj != NULL && json_tokener_get_error(tok) == json_tokener_success);
+	json_tokener_free(tok);
+
+	if (ret)
+		*Zitat = ZitatespuckerJSONGetPopulatedStruct(ZitatObj, fields);
+	json_object_put(ZitatObj);
+
+	return ret;
+}
+
+static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_object *ZitatObj, ZitatespuckerFields fields)
 {
 	ZitatespuckerZitat *Zitat;
 	if ((Zitat = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat))) == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: malloc() returned NULL.\n", __FILE__, __LINE__, __func__);
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
 		return NULL;
 	}
 	// init
@@ -186,13 +465,29 @@ static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_object *Zita
 	json_object *tmpObj = NULL;
 
 	// author
-	Zitat->author = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATAUTHOR, tmpObj);
+	if (fields & ZITATESPUCKER_FIELD_AUTHOR) {
+		Zitat->author = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATAUTHOR, tmpObj, &Zitat->authorLen);
+		Zitat->authorHash = ZitatespuckerAuthorHash(Zitat->author, Zitat->authorLen);
+	}
 
 	// zitat
-	Zitat->zitat = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATZITAT, tmpObj);
+	if (fields & ZITATESPUCKER_FIELD_ZITAT)
+		Zitat->zitat = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATZITAT, tmpObj, &Zitat->zitatLen);
 
 	// comment
-	Zitat->comment = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATCOMMENT, tmpObj);
+	if (fields & ZITATESPUCKER_FIELD_COMMENT)
+		Zitat->comment = ZitatespuckerJSONGetStringAllocated(ZitatObj, ZITATESPUCKERZITATCOMMENT, tmpObj, &Zitat->commentLen);
+
+	// day, month, year, annodomini
+	if (fields & ZITATESPUCKER_FIELD_DATE)
+		ZitatespuckerJSONGetDate(ZitatObj, Zitat);
+
+	return Zitat;
+}
+
+static void ZitatespuckerJSONGetDate(json_object *ZitatObj, ZitatespuckerZitat *Zitat)
+{
+	json_object *tmpObj = NULL;
 
 	// day
 	int32_t tmpInt = ZitatespuckerJSONGetInt(ZitatObj, ZITATESPUCKERZITATDAY, tmpObj);
@@ -221,26 +516,58 @@ static ZitatespuckerZitat *ZitatespuckerJSONGetPopulatedStruct(json_object *Zita
 	// annodomini
 	if (json_object_object_get_ex(ZitatObj, ZITATESPUCKERZITATANNODOMINI, &tmpObj)) {
 		Zitat->annodomini = json_object_get_boolean(tmpObj);
+	} else
+		ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_MISSING, ZITATESPUCKERZITATANNODOMINI, __func__, "Key \"%s\" not found.", ZITATESPUCKERZITATANNODOMINI);
+}
+
+static bool ZitatespuckerJSONMatchesDate(json_object *ZitatObj, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	json_object *tmpObj = NULL;
+
+	// same clamping as in ZitatespuckerJSONGetDate()
+	bool tmpBool = false;
+	if (json_object_object_get_ex(ZitatObj, ZITATESPUCKERZITATANNODOMINI, &tmpObj))
+		tmpBool = json_object_get_boolean(tmpObj);
+	if (tmpBool != annodomini)
+		return false;
+
+	int32_t tmpInt = ZitatespuckerJSONGetInt(ZitatObj, ZITATESPUCKERZITATYEAR, tmpObj);
+	if ((tmpInt < 0 ? 0 : (tmpInt > UINT16_MAX ? UINT16_MAX : tmpInt)) != year)
+		return false;
+
+	if (month != 0) {
+		tmpInt = ZitatespuckerJSONGetInt(ZitatObj, ZITATESPUCKERZITATMONTH, tmpObj);
+		if ((tmpInt < 0 ? 0 : (tmpInt > UINT8_MAX ? UINT8_MAX : tmpInt)) != month)
+			return false;
 	}
 
-	return Zitat;
+	if (day != 0) {
+		tmpInt = ZitatespuckerJSONGetInt(ZitatObj, ZITATESPUCKERZITATDAY, tmpObj);
+		if ((tmpInt < 0 ? 0 : (tmpInt > UINT8_MAX ? UINT8_MAX : tmpInt)) != day)
+			return false;
+	}
+
+	return true;
 }
 
-static inline char *ZitatespuckerJSONGetStringAllocated(json_object *Parent, const char *keyName, json_object *child)
+static inline char *ZitatespuckerJSONGetStringAllocated(json_object *Parent, const char *keyName, json_object *child, size_t *len)
 {
+	*len = 0;
 	if (json_object_object_get_ex(Parent, keyName, &child)) {
-		size_t len;
-		if ((len = json_object_get_string_len(child)) >= 1) {
-			char *tmpS = malloc(len);
-			if (tmpS != NULL)
-				strcpy(tmpS, json_object_get_string(child));
+		size_t tmpLen;
+		if ((tmpLen = json_object_get_string_len(child)) >= 1) {
+			char *tmpS = malloc(tmpLen + 1);
+			if (tmpS != NULL) {
+				(void) memcpy(tmpS, json_object_get_string(child), tmpLen + 1);
+				// a "\u0000" within the string ends it early
+				const char *nul = (const char *) memchr(tmpS, '\0', tmpLen);
+				*len = (nul != NULL ? (size_t) (nul - tmpS) : tmpLen);
+			}
 			return tmpS;
 		} else
 			return NULL;
 	} else {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: Key \"%s\" not found.\n", __FILE__, __LINE__, __func__, keyName);
-		#endif
+		ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_MISSING, keyName, __func__, "Key \"%s\" not found.", keyName);
 		return NULL;
 	}
 }
@@ -248,19 +575,39 @@ static inline char *ZitatespuckerJSONGetStringAllocated(json_object *Parent, con
 static inline int32_t ZitatespuckerJSONGetInt(json_object *Parent, const char *keyName, json_object *child)
 {
 	if (json_object_object_get_ex(Parent, keyName, &child)) {
-		errno = 0; // reset errno to prevent false positive
-		int32_t tmpInt = json_object_get_int(child);
-		if (errno == EINVAL) {
-			#ifndef ZITATESPUCKER_NOPRINT
-			(void) fprintf(stderr, "%s:%d:%s: No valid conversion for key \"%s\".\n", __FILE__, __LINE__, __func__, keyName);
-			#endif
-			errno = 0; // and reset again, to prevent false positives down the line
+		// json_object_get_int() signals failed conversions through errno only,
+		// so decide by type instead of clobbering the caller's errno
+		switch (json_object_get_type(child)) {
+			case json_type_int:
+			case json_type_double:
+			case json_type_boolean:
+			case json_type_null:
+				return json_object_get_int(child);
+			case json_type_string: {
+				// numeric strings used to be accepted, so keep doing that
+				const char *tmpS = json_object_get_string(child);
+				bool negative = (*tmpS == '-');
+				if (*tmpS == '-' || *tmpS == '+')
+					tmpS++;
+				int64_t tmpInt = 0;
+				const char *digits = tmpS;
+				for ( ; *tmpS >= '0' && *tmpS <= '9'; tmpS++) {
+					if (tmpInt <= INT32_MAX)
+						tmpInt = tmpInt * 10 + (*tmpS - '0');
+				}
+				if (*tmpS == '\0' && tmpS != digits) {
+					if (tmpInt > INT32_MAX)
+						tmpInt = INT32_MAX;
+					return (int32_t) (negative ? -tmpInt : tmpInt);
+				}
+			}
+			/* fall through */
+			default:
+				ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_INVALID, keyName, __func__, "No valid conversion for key \"%s\".", keyName);
+				return 0;
 		}
-		return tmpInt;
 	} else {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: Key \"%s\" not found.\n", __FILE__, __LINE__, __func__, keyName);
-		#endif
+		ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_MISSING, keyName, __func__, "Key \"%s\" not found.", keyName);
 		return 0;
 	}
 }
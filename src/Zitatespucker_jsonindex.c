@@ -0,0 +1,607 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Index files for reading single elements of .json files
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* st_mtim */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_json.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/*
+	Layout of an index; every number is stored in 8 bytes, least significant byte first:
+	the magic, the size, modification time (seconds and nanoseconds) of the .json file and the number of elements,
+	followed by the offset and length of every element
+*/
+#define ZITATESPUCKER_JSON_INDEX_HEADER	40
+#define ZITATESPUCKER_JSON_INDEX_ENTRY	16
+
+static const unsigned char ZitatespuckerJSONIndexMagic[8] = {'Z', 'S', 'I', 'D', 'X', 0, 0, 1};
+
+/* What an index records about the file it was built from */
+typedef struct ZitatespuckerJSONIndexIdentity {
+	uint64_t size;
+	uint64_t mtime;
+	uint64_t mtimensec;
+} ZitatespuckerJSONIndexIdentity;
+
+
+/* Static function declarations */
+
+/*
+	stat() filename into identity.
+	Returns false on error (which is not reported).
+*/
+static bool ZitatespuckerJSONIndexGetIdentity(const char *filename, ZitatespuckerJSONIndexIdentity *identity);
+
+/*
+	Returns a newly allocated string of filename followed by suffix.
+	NULL on error.
+*/
+static char *ZitatespuckerJSONIndexGetName(const char *filename, const char *suffix);
+
+/*
+	Open the index of filename, if it is up to date, storing the number of elements in amount
+	and the size of filename in size.
+	NULL (without an error being reported) if there is no index or it cannot be used.
+
+	The returned (non-NULL) FILE must be closed using fclose().
+*/
+static FILE *ZitatespuckerJSONIndexOpen(const char *filename, uint64_t *amount, uint64_t *size);
+
+/*
+	Read all of filename into a newly allocated buffer and store its length in len.
+	Returns NULL on error.
+
+	The returned (non-NULL) buffer must be freed using free().
+*/
+static char *ZitatespuckerJSONIndexReadFile(const char *filename, size_t *len);
+
+/*
+	Find the array of elements within buf (len bytes, read from filename) and store the offset and length of each of them,
+	one after the other, in a newly allocated array stored in spans (amount of them).
+	Returns false on error.
+*/
+static bool ZitatespuckerJSONIndexScan(const char *buf, size_t len, const char *filename, uint64_t **spans, size_t *amount);
+
+/*
+	Write the index of filename, built from identity and spans (amount of them), to filename + ZITATESPUCKER_JSON_INDEX_SUFFIX.
+	Returns false on error.
+*/
+static bool ZitatespuckerJSONIndexWrite(const char *filename, const ZitatespuckerJSONIndexIdentity *identity, const uint64_t *spans, size_t amount);
+
+/*
+	Returns the position of the first character at or after pos within buf (len bytes) that is neither whitespace
+	nor part of a comment (which json-c accepts).
+*/
+static size_t ZitatespuckerJSONIndexSkipSpace(const char *buf, size_t len, size_t pos);
+
+/*
+	Returns the position right after the string starting at pos within buf (len bytes).
+	SIZE_MAX if the string does not end.
+*/
+static size_t ZitatespuckerJSONIndexSkipString(const char *buf, size_t len, size_t pos);
+
+/*
+	Returns the position right after the value (object, array, string, number or literal) starting at pos within buf (len bytes).
+	SIZE_MAX if there is no value at pos, or it does not end.
+*/
+static size_t ZitatespuckerJSONIndexSkipValue(const char *buf, size_t len, size_t pos);
+
+/*
+	Store val in dst, least significant byte first.
+*/
+static inline void ZitatespuckerJSONIndexStore(unsigned char *dst, uint64_t val);
+
+/*
+	Returns the value stored in src by ZitatespuckerJSONIndexStore().
+*/
+static inline uint64_t ZitatespuckerJSONIndexLoad(const unsigned char *src);
+
+
+/* Externally callable */
+
+bool ZitatespuckerJSONIndexBuild(const char *filename)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return false;
+	}
+
+	ZitatespuckerJSONIndexIdentity identity;
+	if (!ZitatespuckerJSONIndexGetIdentity(filename, &identity)) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "stat() failed for \"%s\".", filename);
+		return false;
+	}
+
+	char *buf;
+	size_t buflen;
+	if ((buf = ZitatespuckerJSONIndexReadFile(filename, &buflen)) == NULL)
+		return false;
+
+	uint64_t *spans;
+	size_t amount;
+	bool ret = ZitatespuckerJSONIndexScan(buf, buflen, filename, &spans, &amount);
+	free((void *) buf);
+	if (!ret)
+		return false;
+
+	// spans of a file that changed while it was read would be recorded as matching its new size and modification time
+	ZitatespuckerJSONIndexIdentity after;
+	if (!ZitatespuckerJSONIndexGetIdentity(filename, &after) || after.size != identity.size || after.mtime != identity.mtime
+	|| after.mtimensec != identity.mtimensec || (uint64_t) buflen != identity.size) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "\"%s\" changed while it was indexed.", filename);
+		free((void *) spans);
+		return false;
+	}
+
+	ret = ZitatespuckerJSONIndexWrite(filename, &identity, spans, amount);
+	free((void *) spans);
+
+	return ret;
+}
+
+bool ZitatespuckerJSONIndexGetAmount(const char *filename, size_t *amount)
+{
+	if (filename == NULL || amount == NULL)
+		return false;
+
+	FILE *index;
+	uint64_t tmpAmount;
+	uint64_t size;
+	if ((index = ZitatespuckerJSONIndexOpen(filename, &tmpAmount, &size)) == NULL)
+		return false;
+	(void) fclose(index);
+
+	if (tmpAmount > SIZE_MAX)
+		return false;
+	*amount = (size_t) tmpAmount;
+
+	return true;
+}
+
+bool ZitatespuckerJSONIndexGetElement(const char *filename, const size_t idx, char **element, size_t *len)
+{
+	if (filename == NULL || element == NULL || len == NULL)
+		return false;
+
+	FILE *index;
+	uint64_t amount;
+	uint64_t size;
+	if ((index = ZitatespuckerJSONIndexOpen(filename, &amount, &size)) == NULL)
+		return false;
+
+	if ((uint64_t) idx >= amount) {
+		(void) fclose(index);
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "Index %zu is out of range for \"%s\" (%zu elements).", idx, filename, (size_t) amount);
+		*element = NULL;
+		*len = 0;
+		return true;
+	}
+
+	// the size of the index was checked to fit in a long and hold amount entries, so the position does, too
+	unsigned char entry[ZITATESPUCKER_JSON_INDEX_ENTRY];
+	bool ok = (fseek(index, (long) (ZITATESPUCKER_JSON_INDEX_HEADER + (uint64_t) idx * ZITATESPUCKER_JSON_INDEX_ENTRY), SEEK_SET) == 0
+	&& fread(entry, 1, ZITATESPUCKER_JSON_INDEX_ENTRY, index) == ZITATESPUCKER_JSON_INDEX_ENTRY);
+	(void) fclose(index);
+	if (!ok)
+		return false;
+
+	uint64_t offset = ZitatespuckerJSONIndexLoad(entry);
+	uint64_t length = ZitatespuckerJSONIndexLoad(entry + 8);
+	if (offset > size || length > size - offset || offset > LONG_MAX || length >= SIZE_MAX)
+		return false;
+
+	FILE *file;
+	if ((file = fopen(filename, "rb")) == NULL)
+		return false;
+
+	char *buf;
+	if (fseek(file, (long) offset, SEEK_SET) != 0 || (buf = (char *) malloc((size_t) length + 1)) == NULL) {
+		(void) fclose(file);
+		return false;
+	}
+	if (fread(buf, 1, (size_t) length, file) != (size_t) length) {
+		free((void *) buf);
+		(void) fclose(file);
+		return false;
+	}
+	(void) fclose(file);
+	buf[length] = '\0';
+
+	*element = buf;
+	*len = (size_t) length;
+
+	return true;
+}
+
+
+/* Static function definitions */
+
+static bool ZitatespuckerJSONIndexGetIdentity(const char *filename, ZitatespuckerJSONIndexIdentity *identity)
+{
+	struct stat st;
+	if (stat(filename, &st) != 0 || st.st_size < 0)
+		return false;
+
+	identity->size = (uint64_t) st.st_size;
+	#ifdef _WIN32
+	identity->mtime = (uint64_t) st.st_mtime;
+	identity->mtimensec = 0;
+	#else
+	identity->mtime = (uint64_t) st.st_mtim.tv_sec;
+	identity->mtimensec = (uint64_t) st.st_mtim.tv_nsec;
+	#endif
+
+	return true;
+}
+
+static char *ZitatespuckerJSONIndexGetName(const char *filename, const char *suffix)
+{
+	size_t filenameLen = strlen(filename);
+	size_t suffixLen = strlen(suffix);
+
+	char *ret;
+	if ((ret = (char *) malloc(filenameLen + suffixLen + 1)) == NULL)
+		return NULL;
+	(void) memcpy(ret, filename, filenameLen);
+	(void) memcpy(ret + filenameLen, suffix, suffixLen + 1);
+
+	return ret;
+}
+
+static FILE *ZitatespuckerJSONIndexOpen(const char *filename, uint64_t *amount, uint64_t *size)
+{
+	ZitatespuckerJSONIndexIdentity identity;
+	if (!ZitatespuckerJSONIndexGetIdentity(filename, &identity))
+		return NULL;
+
+	char *indexname;
+	if ((indexname = ZitatespuckerJSONIndexGetName(filename, ZITATESPUCKER_JSON_INDEX_SUFFIX)) == NULL)
+		return NULL;
+	FILE *index = fopen(indexname, "rb");
+	free((void *) indexname);
+	if (index == NULL)
+		return NULL;
+
+	unsigned char header[ZITATESPUCKER_JSON_INDEX_HEADER];
+	long indexlen;
+	if (fread(header, 1, ZITATESPUCKER_JSON_INDEX_HEADER, index) != ZITATESPUCKER_JSON_INDEX_HEADER
+	|| memcmp(header, ZitatespuckerJSONIndexMagic, sizeof(ZitatespuckerJSONIndexMagic)) != 0
+	|| ZitatespuckerJSONIndexLoad(header + 8) != identity.size
+	|| ZitatespuckerJSONIndexLoad(header + 16) != identity.mtime
+	|| ZitatespuckerJSONIndexLoad(header + 24) != identity.mtimensec
+	|| fseek(index, 0, SEEK_END) != 0 || (indexlen = ftell(index)) < ZITATESPUCKER_JSON_INDEX_HEADER) {
+		(void) fclose(index);
+		return NULL;
+	}
+
+	// an index cut short (e.g. by a full disk) records more elements than it holds
+	uint64_t tmpAmount = ZitatespuckerJSONIndexLoad(header + 32);
+	if (tmpAmount != ((uint64_t) indexlen - ZITATESPUCKER_JSON_INDEX_HEADER) / ZITATESPUCKER_JSON_INDEX_ENTRY
+	|| ((uint64_t) indexlen - ZITATESPUCKER_JSON_INDEX_HEADER) % ZITATESPUCKER_JSON_INDEX_ENTRY != 0) {
+		(void) fclose(index);
+		return NULL;
+	}
+
+	*amount = tmpAmount;
+	*size = identity.size;
+
+	return index;
+}
+
+static char *ZitatespuckerJSONIndexReadFile(const char *filename, size_t *len)
+{
+	FILE *file;
+	if ((file = fopen(filename, "rb")) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "fopen() failed for \"%s\".", filename);
+		return NULL;
+	}
+
+	long filelen;
+	if (fseek(file, 0, SEEK_END) != 0 || (filelen = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "Could not determine the size of \"%s\".", filename);
+		(void) fclose(file);
+		return NULL;
+	}
+
+	char *buf;
+	if ((buf = (char *) malloc((size_t) filelen + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		(void) fclose(file);
+		return NULL;
+	}
+
+	*len = fread(buf, 1, (size_t) filelen, file);
+	if (ferror(file)) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "fread() failed for \"%s\".", filename);
+		free((void *) buf);
+		(void) fclose(file);
+		return NULL;
+	}
+	(void) fclose(file);
+
+	return buf;
+}
+
+static bool ZitatespuckerJSONIndexScan(const char *buf, size_t len, const char *filename, uint64_t **spans, size_t *amount)
+{
+	size_t keyLen = strlen(ZITATESPUCKERZITATKEYNAME);
+	uint64_t *ret = NULL;
+	size_t retLen = 0;
+	size_t retSize = 0;
+	bool found = false;
+
+	size_t pos = ZitatespuckerJSONIndexSkipSpace(buf, len, 0);
+	if (pos >= len || buf[pos] != '{') {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "\"%s\" does not hold a JSON object.", filename);
+		return false;
+	}
+	pos = ZitatespuckerJSONIndexSkipSpace(buf, len, pos + 1);
+	if (pos < len && buf[pos] == '}')
+		pos = len + 1;
+
+	// walk the members of the outermost object; like the JSON libraries, the last one named ZITATESPUCKERZITATKEYNAME counts
+	while (pos < len) {
+		size_t keyStart = pos + 1;
+		size_t keyEnd;
+		if (buf[pos] != '"' || (keyEnd = ZitatespuckerJSONIndexSkipString(buf, len, pos)) == SIZE_MAX)
+			break;
+		pos = ZitatespuckerJSONIndexSkipSpace(buf, len, keyEnd);
+		if (pos >= len || buf[pos] != ':')
+			break;
+		pos = ZitatespuckerJSONIndexSkipSpace(buf, len, pos + 1);
+
+		if (keyEnd - 1 - keyStart == keyLen && memcmp(buf + keyStart, ZITATESPUCKERZITATKEYNAME, keyLen) == 0) {
+			if (pos >= len || buf[pos] != '[') {
+				ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "Key %s is not an array!", ZITATESPUCKERZITATKEYNAME);
+				free((void *) ret);
+				return false;
+			}
+			found = true;
+			retLen = 0;
+
+			pos = ZitatespuckerJSONIndexSkipSpace(buf, len, pos + 1);
+			if (pos < len && buf[pos] == ']')
+				pos++;
+			else {
+				while (pos < len) {
+					size_t end;
+					if ((end = ZitatespuckerJSONIndexSkipValue(buf, len, pos)) == SIZE_MAX) {
+						pos = len;
+						break;
+					}
+
+					if (retLen == retSize) {
+						size_t newSize = (retSize == 0 ? 64 : retSize * 2);
+						uint64_t *tmpRet;
+						if (newSize > SIZE_MAX / (2 * sizeof(uint64_t)) || (tmpRet = (uint64_t *) realloc(ret, newSize * 2 * sizeof(uint64_t))) == NULL) {
+							ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "realloc() returned NULL.");
+							free((void *) ret);
+							return false;
+						}
+						ret = tmpRet;
+						retSize = newSize;
+					}
+					ret[2 * retLen] = (uint64_t) pos;
+					ret[2 * retLen + 1] = (uint64_t) (end - pos);
+					retLen++;
+
+					pos = ZitatespuckerJSONIndexSkipSpace(buf, len, end);
+					if (pos < len && buf[pos] == ',')
+						pos = ZitatespuckerJSONIndexSkipSpace(buf, len, pos + 1);
+					else if (pos < len && buf[pos] == ']') {
+						pos++;
+						break;
+					} else
+						pos = len;
+				}
+				if (pos >= len)
+					break;
+			}
+		} else if ((pos = ZitatespuckerJSONIndexSkipValue(buf, len, pos)) == SIZE_MAX)
+			break;
+
+		pos = ZitatespuckerJSONIndexSkipSpace(buf, len, pos);
+		if (pos < len && buf[pos] == ',')
+			pos = ZitatespuckerJSONIndexSkipSpace(buf, len, pos + 1);
+		else if (pos < len && buf[pos] == '}')
+			pos = len + 1;
+		else
+			break;
+	}
+
+	// the loop is only left with pos past len once the outermost object ended
+	if (pos <= len || pos == SIZE_MAX) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "\"%s\" is not valid JSON.", filename);
+		free((void *) ret);
+		return false;
+	} else if (!found) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "Key %s does not exist.", ZITATESPUCKERZITATKEYNAME);
+		free((void *) ret);
+		return false;
+	}
+
+	*spans = ret;
+	*amount = retLen;
+
+	return true;
+}
+
+static bool ZitatespuckerJSONIndexWrite(const char *filename, const ZitatespuckerJSONIndexIdentity *identity, const uint64_t *spans, size_t amount)
+{
+	char *indexname;
+	char *tmpname = NULL;
+	if ((indexname = ZitatespuckerJSONIndexGetName(filename, ZITATESPUCKER_JSON_INDEX_SUFFIX)) == NULL
+	|| (tmpname = ZitatespuckerJSONIndexGetName(indexname, ".tmp")) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		free((void *) indexname);
+		return false;
+	}
+
+	// written next to the index and renamed over it, so readers never see half of one
+	FILE *index;
+	if ((index = fopen(tmpname, "wb")) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "fopen() failed for \"%s\".", tmpname);
+		free((void *) tmpname);
+		free((void *) indexname);
+		return false;
+	}
+
+	unsigned char header[ZITATESPUCKER_JSON_INDEX_HEADER];
+	(void) memcpy(header, ZitatespuckerJSONIndexMagic, sizeof(ZitatespuckerJSONIndexMagic));
+	ZitatespuckerJSONIndexStore(header + 8, identity->size);
+	ZitatespuckerJSONIndexStore(header + 16, identity->mtime);
+	ZitatespuckerJSONIndexStore(header + 24, identity->mtimensec);
+	ZitatespuckerJSONIndexStore(header + 32, (uint64_t) amount);
+	bool ret = (fwrite(header, 1, ZITATESPUCKER_JSON_INDEX_HEADER, index) == ZITATESPUCKER_JSON_INDEX_HEADER);
+	for (size_t i = 0; i < amount && ret; i++) {
+		unsigned char entry[ZITATESPUCKER_JSON_INDEX_ENTRY];
+		ZitatespuckerJSONIndexStore(entry, spans[2 * i]);
+		ZitatespuckerJSONIndexStore(entry + 8, spans[2 * i + 1]);
+		ret = (fwrite(entry, 1, ZITATESPUCKER_JSON_INDEX_ENTRY, index) == ZITATESPUCKER_JSON_INDEX_ENTRY);
+	}
+	if (fclose(index) != 0)
+		ret = false;
+
+	if (!ret)
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "Could not write \"%s\".", tmpname);
+	// rename() does not replace existing files everywhere (e.g. on Windows)
+	else if (rename(tmpname, indexname) != 0 && (remove(indexname) != 0 || rename(tmpname, indexname) != 0)) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "rename() failed for \"%s\".", indexname);
+		ret = false;
+	}
+	if (!ret)
+		(void) remove(tmpname);
+	free((void *) tmpname);
+	free((void *) indexname);
+
+	return ret;
+}
+
+static size_t ZitatespuckerJSONIndexSkipSpace(const char *buf, size_t len, size_t pos)
+{
+	while (pos < len) {
+		if (buf[pos] == ' ' || buf[pos] == '\t' || buf[pos] == '\n' || buf[pos] == '\r')
+			pos++;
+		else if (buf[pos] == '/' && pos + 1 < len && buf[pos + 1] == '/') {
+			while (pos < len && buf[pos] != '\n')
+				pos++;
+		} else if (buf[pos] == '/' && pos + 1 < len && buf[pos + 1] == '*') {
+			for (pos += 2; pos < len && !(buf[pos] == '*' && pos + 1 < len && buf[pos + 1] == '/'); pos++)
+				;
+			pos = (pos < len ? pos + 2 : len);
+		} else
+			break;
+	}
+
+	return pos;
+}
+
+static size_t ZitatespuckerJSONIndexSkipString(const char *buf, size_t len, size_t pos)
+{
+	for (pos++; pos < len; pos++) {
+		if (buf[pos] == '\\')
+			pos++;
+		else if (buf[pos] == '"')
+			return pos + 1;
+	}
+
+	return SIZE_MAX;
+}
+
+static size_t ZitatespuckerJSONIndexSkipValue(const char *buf, size_t len, size_t pos)
+{
+	if (pos >= len)
+		return SIZE_MAX;
+
+	if (buf[pos] == '"')
+		return ZitatespuckerJSONIndexSkipString(buf, len, pos);
+
+	if (buf[pos] != '{' && buf[pos] != '[') {
+		// numbers and literals; the backends find out whether they are valid
+		size_t start = pos;
+		while (pos < len && buf[pos] != ',' && buf[pos] != ']' && buf[pos] != '}' && buf[pos] != '/'
+		&& buf[pos] != ' ' && buf[pos] != '\t' && buf[pos] != '\n' && buf[pos] != '\r')
+			pos++;
+		return (pos != start ? pos : SIZE_MAX);
+	}
+
+	// objects and arrays: only brackets outside of strings and comments count
+	size_t depth = 0;
+	while (pos < len) {
+		switch (buf[pos]) {
+			case '"':
+				if ((pos = ZitatespuckerJSONIndexSkipString(buf, len, pos)) == SIZE_MAX)
+					return SIZE_MAX;
+				continue;
+			case '/':
+				if (pos + 1 < len && (buf[pos + 1] == '/' || buf[pos + 1] == '*')) {
+					pos = ZitatespuckerJSONIndexSkipSpace(buf, len, pos);
+					continue;
+				}
+				break;
+			case '{':
+			case '[':
+				depth++;
+				break;
+			case '}':
+			case ']':
+				if (--depth == 0)
+					return pos + 1;
+				break;
+			default:
+				break;
+		}
+		pos++;
+	}
+
+	return SIZE_MAX;
+}
+
+static inline void ZitatespuckerJSONIndexStore(unsigned char *dst, uint64_t val)
+{
+	for (int i = 0; i < 8; i++)
+		dst[i] = (unsigned char) (val >> (8 * i));
+
+	return;
+}
+
+static inline uint64_t ZitatespuckerJSONIndexLoad(const unsigned char *src)
+{
+	uint64_t ret = 0;
+	for (int i = 0; i < 8; i++)
+		ret |= (uint64_t) src[i] << (8 * i);
+
+	return ret;
+}
@@ -0,0 +1,922 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Newline-delimited JSON (JSON Lines) backend
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* sysconf(), pread() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_ndjson.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+#include "../Zitatespucker/Zitatespucker_export.h"
+
+
+/* Nesting depth up to which the values of unknown keys are skipped; lines nesting deeper are malformed */
+#define ZITATESPUCKER_NDJSON_MAX_DEPTH	32
+
+
+/* What elements are kept when loading a list */
+typedef struct ZitatespuckerNDJSONFilter {
+	const char *authorname; /* non-NULL --> only elements by this author */
+	size_t authorLen; /* of authorname */
+	uint64_t authorHash; /* of authorname, see ZitatespuckerAuthorHash() */
+	bool byDate; /* true --> only elements matching the date below */
+	bool annodomini;
+	uint16_t year;
+	uint8_t month; /* 0 --> any */
+	uint8_t day; /* 0 --> any */
+} ZitatespuckerNDJSONFilter;
+
+/* A part of a file, split at line boundaries, and the list of what was parsed from it */
+typedef struct ZitatespuckerNDJSONChunk {
+	pthread_t thread;
+	bool started; /* true --> thread has to be joined */
+	const char *filename; /* for diagnostics */
+	const char *base; /* start of the whole file, for diagnostics */
+	char *start;
+	char *end;
+	const ZitatespuckerNDJSONFilter *filter;
+	ZitatespuckerFields fields;
+	ZitatespuckerZitat *first;
+	ZitatespuckerZitat *last;
+	bool failed; /* true --> an element could not be allocated */
+	ZitatespuckerWarnings warnings; /* Counted by the thread of the chunk, for the calling thread to add to its own */
+	ZitatespuckerError error; /* Why the thread of the chunk failed */
+} ZitatespuckerNDJSONChunk;
+
+
+/* Static function declarations */
+
+/*
+	Read all of filename into a '\0'-terminated buffer, storing its length (without the '\0') in len,
+	reporting errors on behalf of caller.
+	NULL on error; the returned buffer must be freed with free().
+*/
+static char *ZitatespuckerNDJSONReadFile(const char *filename, size_t *len, const char *caller);
+
+/*
+	Terminate the line starting at cur (which ends at the next '\n' or at end) with a '\0',
+	store where the line after it starts in next and return cur.
+*/
+static char *ZitatespuckerNDJSONNextLine(char *cur, char *end, char **next);
+
+/*
+	Returns true if line holds nothing but whitespace.
+*/
+static bool ZitatespuckerNDJSONIsBlank(const char *line);
+
+/*
+	Parse the '\0'-terminated line into Zitat, which is initialized first.
+	Strings are unescaped in place, and Zitat points into line; nothing is allocated.
+	false if line is not a single JSON object.
+*/
+static bool ZitatespuckerNDJSONParseLine(char *line, ZitatespuckerZitat *Zitat);
+
+/*
+	Returns cur advanced past any whitespace.
+*/
+static char *ZitatespuckerNDJSONSkipSpace(char *cur);
+
+/*
+	Unescape the JSON string starting at the '"' at cur in place, '\0'-terminate it and store where it starts in out.
+	If len is not NULL, the length of the result (up to a "\u0000" within it) is stored there.
+	Returns a pointer past the closing '"'; NULL if the string is malformed.
+*/
+static char *ZitatespuckerNDJSONParseString(char *cur, char **out, size_t *len);
+
+/*
+	Parse the JSON number at cur into val.
+	Returns a pointer past the number; NULL if there is none.
+*/
+static char *ZitatespuckerNDJSONParseNumber(char *cur, double *val);
+
+/*
+	Skip the JSON value (of any type) at cur, which is nested depth levels deep.
+	Returns a pointer past the value; NULL if it is malformed.
+*/
+static char *ZitatespuckerNDJSONSkipValue(char *cur, unsigned int depth);
+
+/*
+	Returns the value of the four hex digits at cur; -1 if they are not.
+*/
+static long ZitatespuckerNDJSONHex4(const char *cur);
+
+/*
+	Returns val cut off to an integer between 0 and max.
+*/
+static unsigned int ZitatespuckerNDJSONClamp(double val, unsigned int max);
+
+/*
+	Returns true if Zitat is kept by filter.
+*/
+static bool ZitatespuckerNDJSONMatches(const ZitatespuckerZitat *Zitat, const ZitatespuckerNDJSONFilter *filter);
+
+/*
+	Returns a copy of the fields within fields of Zitat, not linked to anything.
+	NULL on error; the copy must be freed with ZitatespuckerZitatFree().
+*/
+static ZitatespuckerZitat *ZitatespuckerNDJSONCopy(const ZitatespuckerZitat *Zitat, ZitatespuckerFields fields);
+
+/*
+	Returns a copy of str, which is len characters long.
+	NULL on error.
+*/
+static char *ZitatespuckerNDJSONCopyString(const char *str, size_t len);
+
+/*
+	Parse every line of chunk into its list.
+*/
+static void ZitatespuckerNDJSONParseChunk(ZitatespuckerNDJSONChunk *chunk);
+
+/*
+	ZitatespuckerNDJSONParseChunk() on a thread of its own; arg is the chunk.
+	The warnings counted there are stored in the chunk, as the thread takes them with it.
+*/
+static void *ZitatespuckerNDJSONParseChunkThread(void *arg);
+
+/*
+	Read filename and build a list of the elements kept by filter, with the fields within fields,
+	splitting the file among threads threads (0 --> as many as make sense), reporting errors on behalf of caller.
+	NULL on error or if nothing was kept.
+*/
+static ZitatespuckerZitat *ZitatespuckerNDJSONLoad(const char *filename, const ZitatespuckerNDJSONFilter *filter, ZitatespuckerFields fields, size_t threads, const char *caller);
+
+/*
+	Pass every element within filename to callback, adding their number to passed.
+	false on error.
+*/
+static bool ZitatespuckerNDJSONEach(const char *filename, ZitatespuckerNDJSONCallback callback, void *userdata, size_t *passed, const char *caller);
+
+
+/* Externally callable */
+
+size_t ZitatespuckerNDJSONGetAmountFromFile(const char *filename)
+{
+	size_t len;
+	char *buf;
+	if ((buf = ZitatespuckerNDJSONReadFile(filename, &len, __func__)) == NULL)
+		return 0;
+
+	size_t ret = 0;
+	char *end = buf + len;
+	for (char *cur = buf; cur < end; ) {
+		if (!ZitatespuckerNDJSONIsBlank(ZitatespuckerNDJSONNextLine(cur, end, &cur)))
+			ret++;
+	}
+	free((void *) buf);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatSingleFromFile(const char *filename, const size_t idx)
+{
+	return ZitatespuckerNDJSONGetZitatSingleFromFileFields(filename, idx, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatSingleFromFileFields(const char *filename, const size_t idx, ZitatespuckerFields fields)
+{
+	size_t len;
+	char *buf;
+	if ((buf = ZitatespuckerNDJSONReadFile(filename, &len, __func__)) == NULL)
+		return NULL;
+
+	ZitatespuckerZitat *ret = NULL;
+	size_t i = 0;
+	char *end = buf + len;
+	for (char *cur = buf; cur < end; ) {
+		char *line = ZitatespuckerNDJSONNextLine(cur, end, &cur);
+		if (ZitatespuckerNDJSONIsBlank(line) || i++ != idx)
+			continue;
+
+		ZitatespuckerZitat Zitat;
+		if (ZitatespuckerNDJSONParseLine(line, &Zitat))
+			ret = ZitatespuckerNDJSONCopy(&Zitat, fields);
+		else
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_FORMAT, __func__, "Line at offset %zu within \"%s\" is malformed.", (size_t) (line - buf), filename);
+		break;
+	}
+	free((void *) buf);
+
+	if (i <= idx)
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "idx %zu is out of range for \"%s\".", idx, filename);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFile(const char *filename)
+{
+	return ZitatespuckerNDJSONGetZitatAllFromFileFields(filename, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileFields(const char *filename, ZitatespuckerFields fields)
+{
+	return ZitatespuckerNDJSONLoad(filename, NULL, fields, 0, __func__);
+}
+
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileThreads(const char *filename, ZitatespuckerFields fields, size_t threads)
+{
+	return ZitatespuckerNDJSONLoad(filename, NULL, fields, threads, __func__);
+}
+
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileByAuthor(const char *filename, const char *authorname)
+{
+	return ZitatespuckerNDJSONGetZitatAllFromFileByAuthorFields(filename, authorname, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileByAuthorFields(const char *filename, const char *authorname, ZitatespuckerFields fields)
+{
+	if (authorname == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL authorname!");
+		return NULL;
+	}
+
+	size_t authorLen = strlen(authorname);
+	ZitatespuckerNDJSONFilter filter = {.authorname = authorname, .authorLen = authorLen, .authorHash = ZitatespuckerAuthorHash(authorname, authorLen)};
+
+	return ZitatespuckerNDJSONLoad(filename, &filter, fields, 0, __func__);
+}
+
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileByDate(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	return ZitatespuckerNDJSONGetZitatAllFromFileByDateFields(filename, annodomini, year, month, day, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerNDJSONGetZitatAllFromFileByDateFields(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields)
+{
+	if (year == 0 && annodomini == false) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "annodomini cannot be false when year is 0.");
+		return NULL;
+	} else if (day != 0 && month == 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "month cannot be 0 when day is not 0.");
+		return NULL;
+	}
+
+	ZitatespuckerNDJSONFilter filter = {.byDate = true, .annodomini = annodomini, .year = year, .month = month, .day = day};
+
+	return ZitatespuckerNDJSONLoad(filename, &filter, fields, 0, __func__);
+}
+
+size_t ZitatespuckerNDJSONForEachFromFile(const char *filename, ZitatespuckerNDJSONCallback callback, void *userdata)
+{
+	size_t ret = 0;
+	if (!ZitatespuckerNDJSONEach(filename, callback, userdata, &ret, __func__))
+		return 0;
+
+	return ret;
+}
+
+ZitatespuckerCounts *ZitatespuckerNDJSONCountFromFile(const char *filename, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter)
+{
+	ZitatespuckerCounter *counter;
+	if ((counter = ZitatespuckerCountBegin(group, filter)) == NULL)
+		return NULL;
+
+	size_t passed = 0;
+	bool ok = ZitatespuckerNDJSONEach(filename, ZitatespuckerCountCallback, counter, &passed, __func__);
+	ZitatespuckerCounts *ret = ZitatespuckerCountEnd(counter);
+	if (!ok) {
+		ZitatespuckerCountsFree(ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+bool ZitatespuckerNDJSONAppend(const char *filename, const ZitatespuckerZitat *ZitatList)
+{
+	if (filename == NULL || ZitatList == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename or ZitatList!");
+		return false;
+	}
+
+	int fd;
+	if ((fd = open(filename, O_RDWR | O_APPEND | O_CREAT, 0644)) < 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "open() failed for \"%s\".", filename);
+		return false;
+	}
+
+	// a line torn by an earlier append would swallow the first new one
+	bool ok = true;
+	off_t size = lseek(fd, 0, SEEK_END);
+	char last = '\n';
+	if (size > 0 && pread(fd, &last, 1, size - 1) == 1 && last != '\n')
+		ok = (write(fd, "\n", 1) == 1);
+	if (!ok) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "write() failed for \"%s\".", filename);
+		(void) close(fd);
+		return false;
+	}
+
+	ZitatespuckerExport *exporter;
+	if ((exporter = ZitatespuckerExportLinesToFd(fd)) == NULL) {
+		(void) close(fd);
+		return false;
+	}
+	ok = ZitatespuckerExportAddList(exporter, ZitatList);
+	ok &= ZitatespuckerExportFinish(exporter, NULL, NULL);
+
+	if (close(fd) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "close() failed for \"%s\".", filename);
+		ok = false;
+	}
+
+	return ok;
+}
+
+
+/* Static function definitions */
+
+static char *ZitatespuckerNDJSONReadFile(const char *filename, size_t *len, const char *caller)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, caller, "recieved NULL filename!");
+		return NULL;
+	}
+
+	FILE *file;
+	if ((file = fopen(filename, "rb")) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, caller, "fopen() failed for \"%s\".", filename);
+		return NULL;
+	}
+
+	long size;
+	if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, caller, "Could not determine the size of \"%s\".", filename);
+		(void) fclose(file);
+		return NULL;
+	}
+
+	char *buf;
+	if ((buf = (char *) malloc((size_t) size + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "malloc() returned NULL.");
+		(void) fclose(file);
+		return NULL;
+	}
+	if (fread(buf, 1, (size_t) size, file) != (size_t) size) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, caller, "fread() failed for \"%s\".", filename);
+		free((void *) buf);
+		(void) fclose(file);
+		return NULL;
+	}
+	(void) fclose(file);
+
+	buf[size] = '\0';
+	*len = (size_t) size;
+
+	return buf;
+}
+
+static char *ZitatespuckerNDJSONNextLine(char *cur, char *end, char **next)
+{
+	char *nl = (char *) memchr(cur, '\n', (size_t) (end - cur));
+	if (nl != NULL) {
+		*nl = '\0';
+		*next = nl + 1;
+	} else {
+		*end = '\0';
+		*next = end;
+	}
+
+	return cur;
+}
+
+static bool ZitatespuckerNDJSONIsBlank(const char *line)
+{
+	return (*ZitatespuckerNDJSONSkipSpace((char *) line) == '\0');
+}
+
+static bool ZitatespuckerNDJSONParseLine(char *line, ZitatespuckerZitat *Zitat)
+{
+	ZitatespuckerZitatInit(Zitat);
+
+	char *cur = ZitatespuckerNDJSONSkipSpace(line);
+	if (*cur != '{')
+		return false;
+	cur = ZitatespuckerNDJSONSkipSpace(cur + 1);
+
+	if (*cur == '}')
+		cur++;
+	else for (;;) {
+		char *key;
+		if (*cur != '"' || (cur = ZitatespuckerNDJSONParseString(cur, &key, NULL)) == NULL)
+			return false;
+		cur = ZitatespuckerNDJSONSkipSpace(cur);
+		if (*cur != ':')
+			return false;
+		cur = ZitatespuckerNDJSONSkipSpace(cur + 1);
+
+		// the last of duplicate keys wins, as it does with the JSON libraries
+		char **string = NULL;
+		size_t *stringLen = NULL;
+		if (strcmp(key, ZITATESPUCKERZITATAUTHOR) == 0) {
+			string = &Zitat->author;
+			stringLen = &Zitat->authorLen;
+		} else if (strcmp(key, ZITATESPUCKERZITATZITAT) == 0) {
+			string = &Zitat->zitat;
+			stringLen = &Zitat->zitatLen;
+		} else if (strcmp(key, ZITATESPUCKERZITATCOMMENT) == 0) {
+			string = &Zitat->comment;
+			stringLen = &Zitat->commentLen;
+		}
+
+		uint8_t *small = NULL;
+		uint16_t *large = NULL;
+		if (strcmp(key, ZITATESPUCKERZITATDAY) == 0)
+			small = &Zitat->day;
+		else if (strcmp(key, ZITATESPUCKERZITATMONTH) == 0)
+			small = &Zitat->month;
+		else if (strcmp(key, ZITATESPUCKERZITATYEAR) == 0)
+			large = &Zitat->year;
+
+		if (string != NULL && *cur == '"') {
+			if ((cur = ZitatespuckerNDJSONParseString(cur, string, stringLen)) == NULL)
+				return false;
+			if (*stringLen == 0)
+				*string = NULL;
+		} else if ((small != NULL || large != NULL) && (*cur == '-' || (*cur >= '0' && *cur <= '9'))) {
+			double val;
+			if ((cur = ZitatespuckerNDJSONParseNumber(cur, &val)) == NULL)
+				return false;
+			if (small != NULL)
+				*small = (uint8_t) ZitatespuckerNDJSONClamp(val, UINT8_MAX);
+			else
+				*large = (uint16_t) ZitatespuckerNDJSONClamp(val, UINT16_MAX);
+		} else {
+			if (string != NULL) {
+				*string = NULL;
+				*stringLen = 0;
+			} else if (small != NULL)
+				*small = 0;
+			else if (large != NULL)
+				*large = 0;
+			else if (strcmp(key, ZITATESPUCKERZITATANNODOMINI) == 0)
+				Zitat->annodomini = (strncmp(cur, "true", 4) == 0);
+			if ((cur = ZitatespuckerNDJSONSkipValue(cur, 1)) == NULL)
+				return false;
+		}
+
+		cur = ZitatespuckerNDJSONSkipSpace(cur);
+		if (*cur == '}') {
+			cur++;
+			break;
+		} else if (*cur != ',')
+			return false;
+		cur = ZitatespuckerNDJSONSkipSpace(cur + 1);
+	}
+
+	return (*ZitatespuckerNDJSONSkipSpace(cur) == '\0');
+}
+
+static char *ZitatespuckerNDJSONSkipSpace(char *cur)
+{
+	while (*cur == ' ' || *cur == '\t' || *cur == '\r' || *cur == '\n')
+		cur++;
+
+	return cur;
+}
+
+static char *ZitatespuckerNDJSONParseString(char *cur, char **out, size_t *len)
+{
+	char *r = cur + 1;
+	char *w = r; // never ahead of r, as no escape sequence is shorter than what it stands for
+	char *nul = NULL; // first "\u0000", where the string ends for everything but this parser
+	*out = w;
+
+	for (;;) {
+		char c = *r++;
+		if (c == '"')
+			break;
+		else if (c == '\0')
+			return NULL;
+		else if (c != '\\') {
+			*w++ = c;
+			continue;
+		}
+
+		long cp;
+		switch (*r++) {
+			case '"': *w++ = '"'; continue;
+			case '\\': *w++ = '\\'; continue;
+			case '/': *w++ = '/'; continue;
+			case 'b': *w++ = '\b'; continue;
+			case 'f': *w++ = '\f'; continue;
+			case 'n': *w++ = '\n'; continue;
+			case 'r': *w++ = '\r'; continue;
+			case 't': *w++ = '\t'; continue;
+			case 'u':
+				if ((cp = ZitatespuckerNDJSONHex4(r)) < 0)
+					return NULL;
+				r += 4;
+				break;
+			default:
+				return NULL;
+		}
+
+		// characters outside the BMP come as a surrogate pair; one without the other becomes U+FFFD
+		if (cp >= 0xD800 && cp <= 0xDBFF) {
+			long low;
+			if (r[0] == '\\' && r[1] == 'u' && (low = ZitatespuckerNDJSONHex4(r + 2)) >= 0xDC00 && low <= 0xDFFF) {
+				cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				r += 6;
+			} else
+				cp = 0xFFFD;
+		} else if (cp >= 0xDC00 && cp <= 0xDFFF)
+			cp = 0xFFFD;
+
+		if (cp < 0x80) {
+			if (cp == 0 && nul == NULL)
+				nul = w;
+			*w++ = (char) cp;
+		} else if (cp < 0x800) {
+			*w++ = (char) (0xC0 | (cp >> 6));
+			*w++ = (char) (0x80 | (cp & 0x3F));
+		} else if (cp < 0x10000) {
+			*w++ = (char) (0xE0 | (cp >> 12));
+			*w++ = (char) (0x80 | ((cp >> 6) & 0x3F));
+			*w++ = (char) (0x80 | (cp & 0x3F));
+		} else {
+			*w++ = (char) (0xF0 | (cp >> 18));
+			*w++ = (char) (0x80 | ((cp >> 12) & 0x3F));
+			*w++ = (char) (0x80 | ((cp >> 6) & 0x3F));
+			*w++ = (char) (0x80 | (cp & 0x3F));
+		}
+	}
+	*w = '\0';
+	if (len != NULL)
+		*len = (size_t) ((nul != NULL ? nul : w) - *out);
+
+	return r;
+}
+
+static char *ZitatespuckerNDJSONParseNumber(char *cur, double *val)
+{
+	// done by hand rather than by strtod(), which depends on the locale
+	bool negative = (*cur == '-');
+	if (negative)
+		cur++;
+	if (*cur < '0' || *cur > '9')
+		return NULL;
+
+	double ret = 0;
+	while (*cur >= '0' && *cur <= '9')
+		ret = ret * 10 + (*cur++ - '0');
+
+	if (*cur == '.') {
+		cur++;
+		if (*cur < '0' || *cur > '9')
+			return NULL;
+		double scale = 0.1;
+		for (; *cur >= '0' && *cur <= '9'; cur++, scale /= 10)
+			ret += (*cur - '0') * scale;
+	}
+
+	if (*cur == 'e' || *cur == 'E') {
+		cur++;
+		bool small = (*cur == '-');
+		if (*cur == '-' || *cur == '+')
+			cur++;
+		if (*cur < '0' || *cur > '9')
+			return NULL;
+		unsigned int exponent = 0;
+		for (; *cur >= '0' && *cur <= '9'; cur++) {
+			if (exponent < 1000)
+				exponent = exponent * 10 + (unsigned int) (*cur - '0');
+		}
+		for (; exponent > 0 && ret != 0 && ret < 1e300; exponent--)
+			ret = (small ? ret / 10 : ret * 10);
+	}
+
+	*val = (negative ? -ret : ret);
+
+	return cur;
+}
+
+static char *ZitatespuckerNDJSONSkipValue(char *cur, unsigned int depth)
+{
+	if (depth > ZITATESPUCKER_NDJSON_MAX_DEPTH)
+		return NULL;
+
+	char *dummy;
+	switch (*cur) {
+		case '"':
+			return ZitatespuckerNDJSONParseString(cur, &dummy, NULL);
+		case '{':
+		case '[': {
+			char close = (*cur == '{' ? '}' : ']');
+			cur = ZitatespuckerNDJSONSkipSpace(cur + 1);
+			if (*cur == close)
+				return cur + 1;
+			for (;;) {
+				if (close == '}') {
+					if (*cur != '"' || (cur = ZitatespuckerNDJSONParseString(cur, &dummy, NULL)) == NULL)
+						return NULL;
+					cur = ZitatespuckerNDJSONSkipSpace(cur);
+					if (*cur != ':')
+						return NULL;
+					cur = ZitatespuckerNDJSONSkipSpace(cur + 1);
+				}
+				if ((cur = ZitatespuckerNDJSONSkipValue(cur, depth + 1)) == NULL)
+					return NULL;
+				cur = ZitatespuckerNDJSONSkipSpace(cur);
+				if (*cur == close)
+					return cur + 1;
+				else if (*cur != ',')
+					return NULL;
+				cur = ZitatespuckerNDJSONSkipSpace(cur + 1);
+			}
+		}
+		case 't':
+			return (strncmp(cur, "true", 4) == 0 ? cur + 4 : NULL);
+		case 'f':
+			return (strncmp(cur, "false", 5) == 0 ? cur + 5 : NULL);
+		case 'n':
+			return (strncmp(cur, "null", 4) == 0 ? cur + 4 : NULL);
+		default: {
+			double val;
+			return ZitatespuckerNDJSONParseNumber(cur, &val);
+		}
+	}
+}
+
+static long ZitatespuckerNDJSONHex4(const char *cur)
+{
+	long ret = 0;
+	for (int i = 0; i < 4; i++) {
+		char c = cur[i];
+		if (c >= '0' && c <= '9')
+			ret = ret * 16 + (c - '0');
+		else if (c >= 'a' && c <= 'f')
+			ret = ret * 16 + (c - 'a' + 10);
+		else if (c >= 'A' && c <= 'F')
+			ret = ret * 16 + (c - 'A' + 10);
+		else
+			return -1; // this includes the '\0' at the end of the line, so nothing past it is read
+	}
+
+	return ret;
+}
+
+static unsigned int ZitatespuckerNDJSONClamp(double val, unsigned int max)
+{
+	if (!(val >= 0)) // NaN, too
+		return 0;
+	else if (val >= max)
+		return max;
+	else
+		return (unsigned int) val;
+}
+
+static bool ZitatespuckerNDJSONMatches(const ZitatespuckerZitat *Zitat, const ZitatespuckerNDJSONFilter *filter)
+{
+	if (filter == NULL)
+		return true;
+
+	if (filter->authorname != NULL && !ZitatespuckerZitatIsByAuthor(Zitat, filter->authorname, filter->authorLen, filter->authorHash))
+		return false;
+
+	if (filter->byDate) {
+		if (Zitat->annodomini != filter->annodomini || Zitat->year != filter->year)
+			return false;
+		if (filter->month != 0 && Zitat->month != filter->month)
+			return false;
+		if (filter->day != 0 && Zitat->day != filter->day)
+			return false;
+	}
+
+	return true;
+}
+
+static ZitatespuckerZitat *ZitatespuckerNDJSONCopy(const ZitatespuckerZitat *Zitat, ZitatespuckerFields fields)
+{
+	ZitatespuckerZitat *ret;
+	if ((ret = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	ZitatespuckerZitatInit(ret);
+
+	if (((fields & ZITATESPUCKER_FIELD_AUTHOR) && Zitat->author != NULL && (ret->author = ZitatespuckerNDJSONCopyString(Zitat->author, Zitat->authorLen)) == NULL)
+	|| ((fields & ZITATESPUCKER_FIELD_ZITAT) && Zitat->zitat != NULL && (ret->zitat = ZitatespuckerNDJSONCopyString(Zitat->zitat, Zitat->zitatLen)) == NULL)
+	|| ((fields & ZITATESPUCKER_FIELD_COMMENT) && Zitat->comment != NULL && (ret->comment = ZitatespuckerNDJSONCopyString(Zitat->comment, Zitat->commentLen)) == NULL)) {
+		ZitatespuckerZitatFree(ret);
+		return NULL;
+	}
+	// only hashed once kept, the filter gets by with the length
+	if (ret->author != NULL) {
+		ret->authorLen = Zitat->authorLen;
+		ret->authorHash = ZitatespuckerAuthorHash(ret->author, ret->authorLen);
+	}
+	if (ret->zitat != NULL)
+		ret->zitatLen = Zitat->zitatLen;
+	if (ret->comment != NULL)
+		ret->commentLen = Zitat->commentLen;
+
+	if (fields & ZITATESPUCKER_FIELD_DATE) {
+		ret->day = Zitat->day;
+		ret->month = Zitat->month;
+		ret->year = Zitat->year;
+		ret->annodomini = Zitat->annodomini;
+	}
+
+	return ret;
+}
+
+static char *ZitatespuckerNDJSONCopyString(const char *str, size_t len)
+{
+	char *ret;
+	if ((ret = (char *) malloc(len + 1)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	ret[len] = '\0';
+
+	return (char *) memcpy(ret, str, len);
+}
+
+static void ZitatespuckerNDJSONParseChunk(ZitatespuckerNDJSONChunk *chunk)
+{
+	for (char *cur = chunk->start; cur < chunk->end; ) {
+		char *line = ZitatespuckerNDJSONNextLine(cur, chunk->end, &cur);
+		if (ZitatespuckerNDJSONIsBlank(line))
+			continue;
+
+		ZitatespuckerZitat Zitat;
+		if (!ZitatespuckerNDJSONParseLine(line, &Zitat)) {
+			ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_MALFORMED, NULL, __func__, "Skipping malformed line at offset %zu within \"%s\".", (size_t) (line - chunk->base), chunk->filename);
+			continue;
+		}
+		if (!ZitatespuckerNDJSONMatches(&Zitat, chunk->filter))
+			continue;
+
+		ZitatespuckerZitat *copy;
+		if ((copy = ZitatespuckerNDJSONCopy(&Zitat, chunk->fields)) == NULL) {
+			chunk->failed = true;
+			break;
+		}
+		if (chunk->last != NULL) {
+			chunk->last->nextZitat = copy;
+			copy->prevZitat = chunk->last;
+		} else
+			chunk->first = copy;
+		chunk->last = copy;
+	}
+
+	return;
+}
+
+static void *ZitatespuckerNDJSONParseChunkThread(void *arg)
+{
+	ZitatespuckerNDJSONChunk *chunk = (ZitatespuckerNDJSONChunk *) arg;
+
+	ZitatespuckerNDJSONParseChunk(chunk);
+	ZitatespuckerDiagGetWarnings(&chunk->warnings);
+	if (chunk->failed)
+		chunk->error = ZitatespuckerDiagGetLastError();
+
+	return NULL;
+}
+
+static ZitatespuckerZitat *ZitatespuckerNDJSONLoad(const char *filename, const ZitatespuckerNDJSONFilter *filter, ZitatespuckerFields fields, size_t threads, const char *caller)
+{
+	size_t len;
+	char *buf;
+	if ((buf = ZitatespuckerNDJSONReadFile(filename, &len, caller)) == NULL)
+		return NULL;
+
+	// unless asked for a number, only use as many threads as there are processors and chunks worth the effort
+	if (threads == 0) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (online > 1 ? (size_t) online : 1);
+		if (threads > len / ZITATESPUCKER_NDJSON_CHUNK_MIN)
+			threads = (len / ZITATESPUCKER_NDJSON_CHUNK_MIN > 1 ? len / ZITATESPUCKER_NDJSON_CHUNK_MIN : 1);
+	}
+	if (threads > ZITATESPUCKER_NDJSON_MAX_THREADS)
+		threads = ZITATESPUCKER_NDJSON_MAX_THREADS;
+
+	// every chunk but the first starts right after a '\n', so no line is split
+	ZitatespuckerNDJSONChunk chunks[ZITATESPUCKER_NDJSON_MAX_THREADS];
+	char *end = buf + len;
+	for (size_t i = 0; i < threads; i++) {
+		char *start = buf + (len / threads) * i;
+		if (i > 0 && start < chunks[i - 1].start)
+			start = chunks[i - 1].start;
+		if (start > buf && start[-1] != '\n') {
+			char *nl = (char *) memchr(start, '\n', (size_t) (end - start));
+			start = (nl != NULL ? nl + 1 : end);
+		}
+		if (i > 0)
+			chunks[i - 1].end = start;
+
+		chunks[i].started = false;
+		chunks[i].filename = filename;
+		chunks[i].base = buf;
+		chunks[i].start = start;
+		chunks[i].filter = filter;
+		chunks[i].fields = fields;
+		chunks[i].first = NULL;
+		chunks[i].last = NULL;
+		chunks[i].failed = false;
+	}
+	chunks[threads - 1].end = end;
+
+	// the first chunk is parsed on this thread; so is any other one a thread could not be started for
+	for (size_t i = 1; i < threads; i++) {
+		if (chunks[i].start < chunks[i].end)
+			chunks[i].started = (pthread_create(&chunks[i].thread, NULL, ZitatespuckerNDJSONParseChunkThread, &chunks[i]) == 0);
+	}
+	for (size_t i = 0; i < threads; i++) {
+		if (!chunks[i].started)
+			ZitatespuckerNDJSONParseChunk(&chunks[i]);
+	}
+
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *last = NULL;
+	bool failed = false;
+	for (size_t i = 0; i < threads; i++) {
+		if (chunks[i].started) {
+			(void) pthread_join(chunks[i].thread, NULL);
+			ZitatespuckerDiagAddWarnings(&chunks[i].warnings);
+			if (chunks[i].failed)
+				ZITATESPUCKER_REPORT_ERROR(chunks[i].error, caller, "Parsing part of \"%s\" on another thread failed.", filename);
+		}
+		failed |= chunks[i].failed;
+
+		if (chunks[i].first == NULL)
+			continue;
+		if (last != NULL) {
+			last->nextZitat = chunks[i].first;
+			chunks[i].first->prevZitat = last;
+		} else
+			ret = chunks[i].first;
+		last = chunks[i].last;
+	}
+	free((void *) buf);
+
+	if (failed) {
+		ZitatespuckerZitatFree(ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+static bool ZitatespuckerNDJSONEach(const char *filename, ZitatespuckerNDJSONCallback callback, void *userdata, size_t *passed, const char *caller)
+{
+	if (callback == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, caller, "recieved NULL callback!");
+		return false;
+	}
+
+	size_t len;
+	char *buf;
+	if ((buf = ZitatespuckerNDJSONReadFile(filename, &len, caller)) == NULL)
+		return false;
+
+	char *end = buf + len;
+	for (char *cur = buf; cur < end; ) {
+		char *line = ZitatespuckerNDJSONNextLine(cur, end, &cur);
+		if (ZitatespuckerNDJSONIsBlank(line))
+			continue;
+
+		ZitatespuckerZitat Zitat;
+		if (!ZitatespuckerNDJSONParseLine(line, &Zitat)) {
+			ZITATESPUCKER_REPORT_WARNING(ZITATESPUCKER_WARNING_MALFORMED, NULL, caller, "Skipping malformed line at offset %zu within \"%s\".", (size_t) (line - buf), filename);
+			continue;
+		}
+
+		(*passed)++;
+		if (!callback(&Zitat, userdata))
+			break;
+	}
+	free((void *) buf);
+
+	return true;
+}
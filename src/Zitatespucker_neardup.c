@@ -0,0 +1,608 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Finding quotes that are almost the same
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_neardup.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* Seed the hash functions of every index are derived from, so that signatures can be compared between builds */
+#define ZITATESPUCKER_NEARDUP_SEED	UINT64_C(0x5A69746174657370)
+
+
+/* The key of one band of the signature of an element */
+typedef struct ZitatespuckerNearDupEntry {
+	uint64_t key;
+	uint32_t idx;
+} ZitatespuckerNearDupEntry;
+
+struct ZitatespuckerNearDupIndex {
+	size_t len; /* Number of elements, including the ones without a signature */
+	size_t count; /* Number of elements with a signature, i.e. of entries used per band */
+	unsigned int shingle;
+	unsigned int bands;
+	unsigned int rows;
+	double threshold;
+	uint64_t *hashes; /* Multiplier and addend of each of the bands * rows hash functions */
+	uint16_t *signatures; /* The low bits of the bands * rows MinHash values of each element; enough to estimate similarity */
+	ZitatespuckerNearDupEntry *entries; /* len entries per band, the first count of them ordered by key, then by idx */
+};
+
+/* What building and querying work on */
+typedef struct ZitatespuckerNearDupScratch {
+	char *text; /* The normalized text */
+	size_t size; /* Allocated for text */
+	uint32_t *signature; /* The full MinHash values */
+} ZitatespuckerNearDupScratch;
+
+
+/* Static function declarations */
+
+/*
+	Returns a new, empty index with the settings of options (NULL for the defaults) for len elements,
+	reporting errors on behalf of caller.
+	NULL on error.
+*/
+static ZitatespuckerNearDupIndex *ZitatespuckerNearDupNew(const ZitatespuckerNearDupOptions *options, size_t len, const char *caller);
+
+/*
+	Work out the MinHash values of text, which is len bytes long, into scratch->signature.
+	false if text has no shingles (nothing but punctuation and whitespace), or on error (reported on behalf of caller).
+*/
+static bool ZitatespuckerNearDupSign(const ZitatespuckerNearDupIndex *index, ZitatespuckerNearDupScratch *scratch, const char *text, size_t len, bool *failed, const char *caller);
+
+/*
+	Returns the key of band of signature.
+*/
+static uint64_t ZitatespuckerNearDupBandKey(const ZitatespuckerNearDupIndex *index, const uint32_t *signature, unsigned int band);
+
+/*
+	Returns the estimated similarity between the stored signature of idx and signature (low bits, as stored).
+*/
+static double ZitatespuckerNearDupSimilarity(const ZitatespuckerNearDupIndex *index, size_t idx, const uint16_t *signature);
+
+/*
+	Returns the index of the first entry of band whose key is not below key.
+*/
+static size_t ZitatespuckerNearDupLowerBound(const ZitatespuckerNearDupIndex *index, unsigned int band, uint64_t key);
+
+/*
+	Returns threshold, or the one of index if it is 0; a negative value if threshold is out of range (reported on behalf of caller).
+*/
+static double ZitatespuckerNearDupThreshold(const ZitatespuckerNearDupIndex *index, double threshold, const char *caller);
+
+/*
+	Union-find over parents, where every element points to one with a lower index (or itself, for the first of a cluster).
+*/
+static size_t ZitatespuckerNearDupRoot(size_t *parents, size_t idx);
+static void ZitatespuckerNearDupJoin(size_t *parents, size_t a, size_t b);
+
+/*
+	Returns x scrambled (the finalizer of SplitMix64).
+*/
+static inline uint64_t ZitatespuckerNearDupMix(uint64_t x);
+
+/*
+	qsort() comparators for entries, candidate indexes and matches.
+*/
+static int ZitatespuckerNearDupCompareEntry(const void *a, const void *b);
+static int ZitatespuckerNearDupCompareIdx(const void *a, const void *b);
+static int ZitatespuckerNearDupCompareMatch(const void *a, const void *b);
+
+
+/* Externally callable */
+
+ZitatespuckerNearDupIndex *ZitatespuckerNearDupIndexFromList(const ZitatespuckerZitat *ZitatList, const ZitatespuckerNearDupOptions *options)
+{
+	if (ZitatList != NULL) {
+		while (ZitatList->prevZitat != NULL)
+			ZitatList = ZitatList->prevZitat;
+	}
+
+	size_t len = 0;
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat)
+		len++;
+
+	ZitatespuckerNearDupIndex *index;
+	if ((index = ZitatespuckerNearDupNew(options, len, __func__)) == NULL)
+		return NULL;
+
+	unsigned int hashes = index->bands * index->rows;
+	ZitatespuckerNearDupScratch scratch = {NULL, 0, NULL};
+	if ((scratch.signature = (uint32_t *) malloc(hashes * sizeof(uint32_t))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		ZitatespuckerNearDupIndexFree(index);
+		return NULL;
+	}
+
+	size_t i = 0;
+	bool failed = false;
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat, i++) {
+		if (cur->zitat == NULL || !ZitatespuckerNearDupSign(index, &scratch, cur->zitat, ZitatespuckerZitatGetZitatLen(cur), &failed, __func__)) {
+			if (failed)
+				break;
+			continue;
+		}
+
+		uint16_t *signature = &index->signatures[i * hashes];
+		for (unsigned int h = 0; h < hashes; h++)
+			signature[h] = (uint16_t) scratch.signature[h];
+		for (unsigned int b = 0; b < index->bands; b++) {
+			ZitatespuckerNearDupEntry *entry = &index->entries[b * len + index->count];
+			entry->key = ZitatespuckerNearDupBandKey(index, scratch.signature, b);
+			entry->idx = (uint32_t) i;
+		}
+		index->count++;
+	}
+	free((void *) scratch.signature);
+	free((void *) scratch.text);
+	if (failed) {
+		ZitatespuckerNearDupIndexFree(index);
+		return NULL;
+	}
+
+	for (unsigned int b = 0; b < index->bands && index->count != 0; b++)
+		qsort(&index->entries[b * len], index->count, sizeof(ZitatespuckerNearDupEntry), ZitatespuckerNearDupCompareEntry);
+
+	return index;
+}
+
+ZitatespuckerNearDupIndex *ZitatespuckerNearDupIndexFromFile(const char *filename, ZitatespuckerSource source, const ZitatespuckerNearDupOptions *options)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	ZitatespuckerZitat *ZitatList;
+	if ((ZitatList = ZitatespuckerSourceGetZitatAllFromFileFields(filename, source, ZITATESPUCKER_FIELD_ZITAT)) == NULL)
+		return NULL;
+
+	ZitatespuckerNearDupIndex *index = ZitatespuckerNearDupIndexFromList(ZitatList, options);
+	ZitatespuckerZitatFree(ZitatList);
+
+	return index;
+}
+
+size_t ZitatespuckerNearDupIndexGetAmount(const ZitatespuckerNearDupIndex *index)
+{
+	return (index != NULL ? index->len : 0);
+}
+
+size_t ZitatespuckerNearDupFind(const ZitatespuckerNearDupIndex *index, const char *text, double threshold, ZitatespuckerNearDupMatch *matches, size_t max)
+{
+	if (index == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL index!");
+		return 0;
+	} else if (text == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL text!");
+		return 0;
+	} else if (matches == NULL && max != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL matches!");
+		return 0;
+	}
+
+	if ((threshold = ZitatespuckerNearDupThreshold(index, threshold, __func__)) < 0)
+		return 0;
+
+	unsigned int hashes = index->bands * index->rows;
+	ZitatespuckerNearDupScratch scratch = {NULL, 0, NULL};
+	uint16_t *signature = NULL;
+	if ((scratch.signature = (uint32_t *) malloc(hashes * sizeof(uint32_t))) == NULL
+	|| (signature = (uint16_t *) malloc(hashes * sizeof(uint16_t))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		free((void *) scratch.signature);
+		return 0;
+	}
+
+	bool failed = false;
+	bool found = ZitatespuckerNearDupSign(index, &scratch, text, strlen(text), &failed, __func__);
+	free((void *) scratch.text);
+	if (!found) {
+		free((void *) signature);
+		free((void *) scratch.signature);
+		return 0;
+	}
+	for (unsigned int h = 0; h < hashes; h++)
+		signature[h] = (uint16_t) scratch.signature[h];
+
+	// gather every element sharing a band, then drop the ones found through several bands
+	uint32_t *candidates = NULL;
+	size_t candidateLen = 0;
+	size_t candidateSize = 0;
+	for (unsigned int b = 0; b < index->bands && !failed; b++) {
+		uint64_t key = ZitatespuckerNearDupBandKey(index, scratch.signature, b);
+		const ZitatespuckerNearDupEntry *entries = &index->entries[b * index->len];
+		for (size_t e = ZitatespuckerNearDupLowerBound(index, b, key); e < index->count && entries[e].key == key; e++) {
+			if (candidateLen == candidateSize) {
+				size_t size = (candidateSize == 0 ? 64 : candidateSize * 2);
+				uint32_t *tmpCandidates;
+				if ((tmpCandidates = (uint32_t *) realloc(candidates, size * sizeof(uint32_t))) == NULL) {
+					ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "realloc() returned NULL.");
+					failed = true;
+					break;
+				}
+				candidates = tmpCandidates;
+				candidateSize = size;
+			}
+			candidates[candidateLen++] = entries[e].idx;
+		}
+	}
+	free((void *) scratch.signature);
+	if (failed) {
+		free((void *) candidates);
+		free((void *) signature);
+		return 0;
+	}
+	if (candidateLen != 0)
+		qsort(candidates, candidateLen, sizeof(uint32_t), ZitatespuckerNearDupCompareIdx);
+
+	// all of them have to be ordered before the first max can be handed out
+	ZitatespuckerNearDupMatch *hits = NULL;
+	size_t hitLen = 0;
+	if (candidateLen != 0 && (hits = (ZitatespuckerNearDupMatch *) malloc(candidateLen * sizeof(ZitatespuckerNearDupMatch))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		free((void *) candidates);
+		free((void *) signature);
+		return 0;
+	}
+	for (size_t c = 0; c < candidateLen; c++) {
+		if (c > 0 && candidates[c] == candidates[c - 1])
+			continue;
+		double similarity = ZitatespuckerNearDupSimilarity(index, candidates[c], signature);
+		if (similarity >= threshold) {
+			hits[hitLen].idx = candidates[c];
+			hits[hitLen].similarity = similarity;
+			hitLen++;
+		}
+	}
+	free((void *) candidates);
+	free((void *) signature);
+
+	if (hitLen != 0)
+		qsort(hits, hitLen, sizeof(ZitatespuckerNearDupMatch), ZitatespuckerNearDupCompareMatch);
+	for (size_t m = 0; m < hitLen && m < max; m++)
+		matches[m] = hits[m];
+	free((void *) hits);
+
+	return hitLen;
+}
+
+bool ZitatespuckerNearDupClusters(const ZitatespuckerNearDupIndex *index, double threshold, size_t *clusters, size_t *amount)
+{
+	if (index == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL index!");
+		return false;
+	} else if (clusters == NULL && index->len != 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL clusters!");
+		return false;
+	}
+
+	if ((threshold = ZitatespuckerNearDupThreshold(index, threshold, __func__)) < 0)
+		return false;
+
+	size_t len = index->len;
+	uint32_t *distinct = NULL;
+	if (len != 0 && (distinct = (uint32_t *) malloc(len * sizeof(uint32_t))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return false;
+	}
+
+	for (size_t i = 0; i < len; i++)
+		clusters[i] = i;
+
+	/*
+		Within a run of entries sharing a key, every pair of elements is a candidate, so each element is compared with
+		every earlier one of the run, except for those with the same signature as an even earlier one:
+		whatever such a copy is similar to, the element it is a copy of is just as similar to,
+		so a run of copies of the same quote takes linear time, not quadratic.
+	*/
+	unsigned int hashes = index->bands * index->rows;
+	for (unsigned int b = 0; b < index->bands; b++) {
+		const ZitatespuckerNearDupEntry *entries = &index->entries[b * len];
+		for (size_t start = 0, end; start < index->count; start = end) {
+			for (end = start + 1; end < index->count && entries[end].key == entries[start].key; end++)
+				;
+			if (end - start == 1)
+				continue;
+
+			size_t distinctLen = 0;
+			for (size_t e = start; e < end; e++) {
+				size_t idx = entries[e].idx;
+				bool copy = false;
+				for (size_t d = 0; d < distinctLen && !copy; d++) {
+					double similarity = ZitatespuckerNearDupSimilarity(index, idx, &index->signatures[(size_t) distinct[d] * hashes]);
+					if (similarity >= threshold)
+						ZitatespuckerNearDupJoin(clusters, idx, distinct[d]);
+					copy = (similarity == 1.0);
+				}
+				if (!copy)
+					distinct[distinctLen++] = (uint32_t) idx;
+			}
+		}
+	}
+
+	// every element points to a lower index, so going up resolves each one from an already resolved one
+	size_t multiple = 0;
+	for (size_t i = 0; i < len; i++) {
+		clusters[i] = clusters[clusters[i]];
+		distinct[i] = 0;
+	}
+	for (size_t i = 0; i < len; i++) {
+		if (clusters[i] != i && distinct[clusters[i]] == 0) {
+			distinct[clusters[i]] = 1;
+			multiple++;
+		}
+	}
+	free((void *) distinct);
+
+	if (amount != NULL)
+		*amount = multiple;
+
+	return true;
+}
+
+void ZitatespuckerNearDupIndexFree(ZitatespuckerNearDupIndex *index)
+{
+	if (index == NULL)
+		return;
+
+	free((void *) index->hashes);
+	free((void *) index->signatures);
+	free((void *) index->entries);
+	free((void *) index);
+
+	return;
+}
+
+
+/* Static function definitions */
+
+static ZitatespuckerNearDupIndex *ZitatespuckerNearDupNew(const ZitatespuckerNearDupOptions *options, size_t len, const char *caller)
+{
+	ZitatespuckerNearDupOptions defaults = {0, 0, 0, 0};
+	if (options == NULL)
+		options = &defaults;
+
+	unsigned int shingle = (options->shingle != 0 ? options->shingle : ZITATESPUCKER_NEARDUP_SHINGLE);
+	unsigned int bands = (options->bands != 0 ? options->bands : ZITATESPUCKER_NEARDUP_BANDS);
+	unsigned int rows = (options->rows != 0 ? options->rows : ZITATESPUCKER_NEARDUP_ROWS);
+	double threshold = (options->threshold != 0 ? options->threshold : ZITATESPUCKER_NEARDUP_THRESHOLD);
+	if (shingle > ZITATESPUCKER_NEARDUP_MAX_SHINGLE) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, caller, "shingle cannot be larger than %d.", ZITATESPUCKER_NEARDUP_MAX_SHINGLE);
+		return NULL;
+	} else if (bands > ZITATESPUCKER_NEARDUP_MAX_HASHES || rows > ZITATESPUCKER_NEARDUP_MAX_HASHES / bands) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, caller, "bands * rows cannot be larger than %d.", ZITATESPUCKER_NEARDUP_MAX_HASHES);
+		return NULL;
+	} else if (!(threshold > 0 && threshold <= 1)) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, caller, "threshold has to be between 0 and 1.");
+		return NULL;
+	} else if (len > UINT32_MAX) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_LIMIT, caller, "List is too large to be indexed.");
+		return NULL;
+	}
+
+	ZitatespuckerNearDupIndex *index;
+	if ((index = (ZitatespuckerNearDupIndex *) calloc(1, sizeof(ZitatespuckerNearDupIndex))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "calloc() returned NULL.");
+		return NULL;
+	}
+	index->len = len;
+	index->shingle = shingle;
+	index->bands = bands;
+	index->rows = rows;
+	index->threshold = threshold;
+
+	unsigned int hashes = bands * rows;
+	if ((index->hashes = (uint64_t *) malloc(2 * hashes * sizeof(uint64_t))) == NULL
+	|| (len != 0 && ((index->signatures = (uint16_t *) malloc(len * hashes * sizeof(uint16_t))) == NULL
+		|| (index->entries = (ZitatespuckerNearDupEntry *) malloc(len * bands * sizeof(ZitatespuckerNearDupEntry))) == NULL))) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "malloc() returned NULL.");
+		ZitatespuckerNearDupIndexFree(index);
+		return NULL;
+	}
+
+	// (a * x + b) >> 32 with an odd a and random b is as good a hash function as MinHash needs, and much cheaper than mixing anew
+	uint64_t state = ZITATESPUCKER_NEARDUP_SEED;
+	for (unsigned int h = 0; h < hashes; h++) {
+		index->hashes[2 * h] = ZitatespuckerNearDupMix(state += UINT64_C(0x9E3779B97F4A7C15)) | 1;
+		index->hashes[2 * h + 1] = ZitatespuckerNearDupMix(state += UINT64_C(0x9E3779B97F4A7C15));
+	}
+
+	return index;
+}
+
+static bool ZitatespuckerNearDupSign(const ZitatespuckerNearDupIndex *index, ZitatespuckerNearDupScratch *scratch, const char *text, size_t len, bool *failed, const char *caller)
+{
+	if (len + 1 > scratch->size) {
+		char *tmpText;
+		if ((tmpText = (char *) realloc(scratch->text, len + 1)) == NULL) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "realloc() returned NULL.");
+			*failed = true;
+			return false;
+		}
+		scratch->text = tmpText;
+		scratch->size = len + 1;
+	}
+
+	// lowercase ASCII letters, and turn every run of other ASCII characters into a single space; anything else is kept as it is
+	size_t normLen = 0;
+	bool space = true;
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = (unsigned char) text[i];
+		if (c >= 'A' && c <= 'Z')
+			c = (unsigned char) (c - 'A' + 'a');
+		else if (c < 0x80 && !(c >= 'a' && c <= 'z') && !(c >= '0' && c <= '9')) {
+			if (!space)
+				scratch->text[normLen++] = ' ';
+			space = true;
+			continue;
+		}
+		scratch->text[normLen++] = (char) c;
+		space = false;
+	}
+	if (normLen > 0 && scratch->text[normLen - 1] == ' ')
+		normLen--;
+	if (normLen == 0)
+		return false;
+
+	unsigned int hashes = index->bands * index->rows;
+	for (unsigned int h = 0; h < hashes; h++)
+		scratch->signature[h] = UINT32_MAX;
+
+	size_t shingle = (normLen < index->shingle ? normLen : index->shingle);
+	for (size_t start = 0; start + shingle <= normLen; start++) {
+		// FNV-1a
+		uint64_t x = UINT64_C(14695981039346656037);
+		for (size_t i = start; i < start + shingle; i++)
+			x = (x ^ (unsigned char) scratch->text[i]) * UINT64_C(1099511628211);
+		x = ZitatespuckerNearDupMix(x);
+
+		for (unsigned int h = 0; h < hashes; h++) {
+			uint32_t val = (uint32_t) ((index->hashes[2 * h] * x + index->hashes[2 * h + 1]) >> 32);
+			if (val < scratch->signature[h])
+				scratch->signature[h] = val;
+		}
+	}
+
+	return true;
+}
+
+static uint64_t ZitatespuckerNearDupBandKey(const ZitatespuckerNearDupIndex *index, const uint32_t *signature, unsigned int band)
+{
+	uint64_t key = band;
+	for (unsigned int r = 0; r < index->rows; r++)
+		key = ZitatespuckerNearDupMix(key ^ signature[band * index->rows + r]) + r;
+
+	return key;
+}
+
+static double ZitatespuckerNearDupSimilarity(const ZitatespuckerNearDupIndex *index, size_t idx, const uint16_t *signature)
+{
+	unsigned int hashes = index->bands * index->rows;
+	const uint16_t *other = &index->signatures[idx * hashes];
+
+	unsigned int same = 0;
+	for (unsigned int h = 0; h < hashes; h++)
+		same += (other[h] == signature[h]);
+
+	return (double) same / hashes;
+}
+
+static size_t ZitatespuckerNearDupLowerBound(const ZitatespuckerNearDupIndex *index, unsigned int band, uint64_t key)
+{
+	const ZitatespuckerNearDupEntry *entries = &index->entries[band * index->len];
+	size_t lo = 0;
+	size_t hi = index->count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (entries[mid].key < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+static double ZitatespuckerNearDupThreshold(const ZitatespuckerNearDupIndex *index, double threshold, const char *caller)
+{
+	if (threshold == 0)
+		return index->threshold;
+
+	if (!(threshold > 0 && threshold <= 1)) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, caller, "threshold has to be between 0 and 1.");
+		return -1;
+	}
+
+	return threshold;
+}
+
+static size_t ZitatespuckerNearDupRoot(size_t *parents, size_t idx)
+{
+	// path halving keeps every element pointing to a lower index
+	while (parents[idx] != idx) {
+		parents[idx] = parents[parents[idx]];
+		idx = parents[idx];
+	}
+
+	return idx;
+}
+
+static void ZitatespuckerNearDupJoin(size_t *parents, size_t a, size_t b)
+{
+	a = ZitatespuckerNearDupRoot(parents, a);
+	b = ZitatespuckerNearDupRoot(parents, b);
+	if (a < b)
+		parents[b] = a;
+	else if (b < a)
+		parents[a] = b;
+
+	return;
+}
+
+static inline uint64_t ZitatespuckerNearDupMix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= UINT64_C(0xBF58476D1CE4E5B9);
+	x ^= x >> 27;
+	x *= UINT64_C(0x94D049BB133111EB);
+	x ^= x >> 31;
+
+	return x;
+}
+
+static int ZitatespuckerNearDupCompareEntry(const void *a, const void *b)
+{
+	const ZitatespuckerNearDupEntry *entryA = (const ZitatespuckerNearDupEntry *) a;
+	const ZitatespuckerNearDupEntry *entryB = (const ZitatespuckerNearDupEntry *) b;
+
+	if (entryA->key != entryB->key)
+		return (entryA->key > entryB->key) - (entryA->key < entryB->key);
+
+	return (entryA->idx > entryB->idx) - (entryA->idx < entryB->idx);
+}
+
+static int ZitatespuckerNearDupCompareIdx(const void *a, const void *b)
+{
+	uint32_t idxA = *(const uint32_t *) a;
+	uint32_t idxB = *(const uint32_t *) b;
+
+	return (idxA > idxB) - (idxA < idxB);
+}
+
+static int ZitatespuckerNearDupCompareMatch(const void *a, const void *b)
+{
+	const ZitatespuckerNearDupMatch *matchA = (const ZitatespuckerNearDupMatch *) a;
+	const ZitatespuckerNearDupMatch *matchB = (const ZitatespuckerNearDupMatch *) b;
+
+	if (matchA->similarity != matchB->similarity)
+		return (matchA->similarity < matchB->similarity) - (matchA->similarity > matchB->similarity);
+
+	return (matchA->idx > matchB->idx) - (matchA->idx < matchB->idx);
+}
@@ -0,0 +1,300 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Shuffled rotation through a source
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_rotation.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* Rounds of the Feistel network; four make it look random enough for picking quotes */
+#define ZITATESPUCKER_ROTATION_ROUNDS	4
+
+/* Rowids per row a SQLite table may span and still be rotated through by rowid (missing ones cost a lookup each) */
+#define ZITATESPUCKER_ROTATION_MAX_SPAN	4
+
+
+struct ZitatespuckerRotation {
+	ZitatespuckerRotationState state;
+	size_t len;
+	ZitatespuckerSnapshot *snapshot; /* NULL for SQLite databases */
+	#ifdef ZITATESPUCKER_SQL
+	ZitatespuckerSQLPool *pool;
+	ZitatespuckerSQLReader *reader; /* Held for as long as the rotation is open */
+	ZitatespuckerZitat *current; /* The element fetched by the last draw */
+	int64_t firstRowid;
+	size_t span; /* Rowids from the first to the last row; what positions are mapped to instead of len */
+	#endif
+};
+
+
+/* Static function declarations */
+
+/*
+	Returns x scrambled (the finalizer of SplitMix64).
+*/
+static inline uint64_t ZitatespuckerRotationMix(uint64_t x);
+
+/*
+	Returns the image of x under the permutation of [0, 2^bits) keyed by seed and round (bits even, at most 64).
+*/
+static uint64_t ZitatespuckerRotationPermute(uint64_t x, unsigned int bits, uint64_t seed, uint64_t round);
+
+/*
+	Returns a rotation through len elements starting at state (or a new one if NULL), with nothing to draw from yet.
+	NULL on error.
+*/
+static ZitatespuckerRotation *ZitatespuckerRotationNew(size_t len, const ZitatespuckerRotationState *state, const char *caller);
+
+
+/* Externally callable */
+
+size_t ZitatespuckerRotationAt(const ZitatespuckerRotationState *state, size_t len)
+{
+	if (state == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL state!");
+		return 0;
+	} else if (len == 0) {
+		return 0;
+	}
+
+	// the smallest power of four holding len, so the two halves are of the same width and at most 3 of 4 tries miss
+	unsigned int bits = 2;
+	while (bits < 64 && ((uint64_t) len - 1) >> bits != 0)
+		bits += 2;
+
+	uint64_t round = state->position / len;
+	uint64_t x = state->position % len;
+	do {
+		x = ZitatespuckerRotationPermute(x, bits, state->seed, round);
+	} while (x >= len);
+
+	return (size_t) x;
+}
+
+ZitatespuckerRotation *ZitatespuckerRotationOpen(const char *filename, ZitatespuckerSource source, const ZitatespuckerRotationState *state)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN && (source = ZitatespuckerSourceDetect(filename)) == ZITATESPUCKER_SOURCE_UNKNOWN)
+		return NULL;
+
+	#ifdef ZITATESPUCKER_SQL
+	if (source == ZITATESPUCKER_SOURCE_SQL) {
+		ZitatespuckerSQLPool *pool;
+		if ((pool = ZitatespuckerSQLPoolOpen(filename, false)) == NULL)
+			return NULL;
+
+		ZitatespuckerSQLReader *reader;
+		int64_t first = 0;
+		int64_t last = 0;
+		size_t len = 0;
+		if ((reader = ZitatespuckerSQLPoolAcquire(pool)) == NULL || !ZitatespuckerSQLReaderGetRowids(reader, &first, &last, &len)) {
+			ZitatespuckerSQLPoolRelease(reader);
+			ZitatespuckerSQLPoolClose(pool);
+			return NULL;
+		} else if (len == 0) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "\"%s\" holds no elements.", filename);
+			ZitatespuckerSQLPoolRelease(reader);
+			ZitatespuckerSQLPoolClose(pool);
+			return NULL;
+		}
+
+		// tables with most rowids in between gone (deleted rows are not renumbered) are loaded into a snapshot below
+		uint64_t span = (uint64_t) last - (uint64_t) first + 1;
+		if (span != 0 && span <= SIZE_MAX && span / ZITATESPUCKER_ROTATION_MAX_SPAN <= len) {
+			ZitatespuckerRotation *rotation;
+			if ((rotation = ZitatespuckerRotationNew(len, state, __func__)) == NULL) {
+				ZitatespuckerSQLPoolRelease(reader);
+				ZitatespuckerSQLPoolClose(pool);
+				return NULL;
+			}
+			rotation->pool = pool;
+			rotation->reader = reader;
+			rotation->firstRowid = first;
+			rotation->span = (size_t) span;
+
+			return rotation;
+		}
+
+		ZitatespuckerSQLPoolRelease(reader);
+		ZitatespuckerSQLPoolClose(pool);
+	}
+	#endif
+
+	ZitatespuckerSnapshot *snapshot;
+	if ((snapshot = ZitatespuckerSnapshotFromFile(filename, source)) == NULL)
+		return NULL;
+
+	ZitatespuckerRotation *rotation = ZitatespuckerRotationFromSnapshot(snapshot, state);
+	ZitatespuckerSnapshotRelease(snapshot);
+
+	return rotation;
+}
+
+ZitatespuckerRotation *ZitatespuckerRotationFromSnapshot(ZitatespuckerSnapshot *snapshot, const ZitatespuckerRotationState *state)
+{
+	if (snapshot == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL snapshot!");
+		return NULL;
+	} else if (ZitatespuckerSnapshotLen(snapshot) == 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "snapshot holds no elements.");
+		return NULL;
+	}
+
+	ZitatespuckerRotation *rotation;
+	if ((rotation = ZitatespuckerRotationNew(ZitatespuckerSnapshotLen(snapshot), state, __func__)) == NULL)
+		return NULL;
+	rotation->snapshot = ZitatespuckerSnapshotRetain(snapshot);
+
+	return rotation;
+}
+
+size_t ZitatespuckerRotationLen(const ZitatespuckerRotation *rotation)
+{
+	return (rotation != NULL ? rotation->len : 0);
+}
+
+const ZitatespuckerZitat *ZitatespuckerRotationNext(ZitatespuckerRotation *rotation)
+{
+	if (rotation == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL rotation!");
+		return NULL;
+	}
+
+	const ZitatespuckerZitat *ret = NULL;
+	if (rotation->snapshot != NULL) {
+		ret = ZitatespuckerSnapshotGet(rotation->snapshot, ZitatespuckerRotationAt(&rotation->state, rotation->len));
+	} else {
+		#ifdef ZITATESPUCKER_SQL
+		ZitatespuckerZitatFree(rotation->current);
+		rotation->current = NULL;
+
+		// the positions of rowids without a row are passed over; a whole round of them means the table was emptied
+		bool missing = true;
+		for (size_t missed = 0; missing && missed < rotation->span; missed++) {
+			uint64_t idx = ZitatespuckerRotationAt(&rotation->state, rotation->span);
+			int64_t rowid = (int64_t) ((uint64_t) rotation->firstRowid + idx);
+			ret = rotation->current = ZitatespuckerSQLReaderGetZitatByRowid(rotation->reader, rowid, ZITATESPUCKER_FIELD_ALL, &missing);
+			if (missing)
+				rotation->state.position++;
+		}
+		if (missing) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "No row left to draw from.");
+		}
+		#endif
+	}
+
+	if (ret != NULL)
+		rotation->state.position++;
+
+	return ret;
+}
+
+void ZitatespuckerRotationGetState(const ZitatespuckerRotation *rotation, ZitatespuckerRotationState *state)
+{
+	if (rotation == NULL || state == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL rotation or state!");
+		return;
+	}
+
+	*state = rotation->state;
+
+	return;
+}
+
+void ZitatespuckerRotationClose(ZitatespuckerRotation *rotation)
+{
+	if (rotation == NULL)
+		return;
+
+	ZitatespuckerSnapshotRelease(rotation->snapshot);
+	#ifdef ZITATESPUCKER_SQL
+	ZitatespuckerZitatFree(rotation->current);
+	ZitatespuckerSQLPoolRelease(rotation->reader);
+	ZitatespuckerSQLPoolClose(rotation->pool);
+	#endif
+	free((void *) rotation);
+
+	return;
+}
+
+
+/* Static function definitions */
+
+static inline uint64_t ZitatespuckerRotationMix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= UINT64_C(0xBF58476D1CE4E5B9);
+	x ^= x >> 27;
+	x *= UINT64_C(0x94D049BB133111EB);
+	x ^= x >> 31;
+
+	return x;
+}
+
+static uint64_t ZitatespuckerRotationPermute(uint64_t x, unsigned int bits, uint64_t seed, uint64_t round)
+{
+	unsigned int half = bits / 2;
+	uint64_t mask = (half == 32 ? UINT64_C(0xFFFFFFFF) : (UINT64_C(1) << half) - 1);
+	uint64_t left = (x >> half) & mask;
+	uint64_t right = x & mask;
+
+	// every round through the source gets keys of its own
+	uint64_t key = ZitatespuckerRotationMix(seed ^ ZitatespuckerRotationMix(round + UINT64_C(0x9E3779B97F4A7C15)));
+	for (unsigned int i = 0; i < ZITATESPUCKER_ROTATION_ROUNDS; i++) {
+		uint64_t tmp = right;
+		right = left ^ (ZitatespuckerRotationMix(right ^ key ^ ((uint64_t) i << 56)) & mask);
+		left = tmp;
+	}
+
+	return (left << half) | right;
+}
+
+static ZitatespuckerRotation *ZitatespuckerRotationNew(size_t len, const ZitatespuckerRotationState *state, const char *caller)
+{
+	ZitatespuckerRotation *rotation;
+	if ((rotation = (ZitatespuckerRotation *) calloc(1, sizeof(ZitatespuckerRotation))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "calloc() returned NULL.");
+		return NULL;
+	}
+
+	rotation->len = len;
+	if (state != NULL) {
+		rotation->state = *state;
+	} else {
+		// the address tells apart rotations started within the same second
+		rotation->state.seed = ZitatespuckerRotationMix((uint64_t) time(NULL) ^ (uint64_t) (uintptr_t) rotation);
+		rotation->state.position = 0;
+	}
+
+	return rotation;
+}
@@ -0,0 +1,209 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Immutable, shareable snapshots of a ZitatespuckerZitat list
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_snapshot.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/*
+	Reference counting has to be atomic for snapshots to be shared between threads.
+	Targets without lock-free atomics (e.g. the Nintendo DS) are single-threaded anyway.
+*/
+#if defined(__GCC_ATOMIC_POINTER_LOCK_FREE) && __GCC_ATOMIC_POINTER_LOCK_FREE == 2
+	#define ZITATESPUCKER_REFCOUNT_INC(x)	((void) __atomic_add_fetch(&(x), 1, __ATOMIC_RELAXED))
+	#define ZITATESPUCKER_REFCOUNT_DEC(x)	(__atomic_sub_fetch(&(x), 1, __ATOMIC_ACQ_REL))
+#else
+	#define ZITATESPUCKER_REFCOUNT_INC(x)	((void) ++(x))
+	#define ZITATESPUCKER_REFCOUNT_DEC(x)	(--(x))
+#endif
+
+
+/* Layout: this struct, followed by len ZitatespuckerZitat, followed by the strings */
+struct ZitatespuckerSnapshot {
+	size_t refcount;
+	size_t len;
+	ZitatespuckerZitat *Zitate;
+};
+
+
+/* Static function declarations */
+
+/*
+	Copy src, which is len characters long, to *pool (with a '\0'), advance *pool past it, and return the copy.
+	NULL if src is NULL.
+*/
+static inline char *ZitatespuckerSnapshotPoolString(char **pool, const char *src, size_t len);
+
+
+/* Externally callable */
+
+ZitatespuckerSnapshot *ZitatespuckerSnapshotFromList(const ZitatespuckerZitat *ZitatList)
+{
+	if (ZitatList == NULL)
+		return NULL;
+
+	while (ZitatList->prevZitat != NULL)
+		ZitatList = ZitatList->prevZitat;
+
+	// first pass: how much do we need?
+	size_t len = 0;
+	size_t poolsize = 0;
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat) {
+		len++;
+		if (cur->author != NULL)
+			poolsize += ZitatespuckerZitatGetAuthorLen(cur) + 1;
+		if (cur->zitat != NULL)
+			poolsize += ZitatespuckerZitatGetZitatLen(cur) + 1;
+		if (cur->comment != NULL)
+			poolsize += ZitatespuckerZitatGetCommentLen(cur) + 1;
+	}
+
+	ZitatespuckerSnapshot *snapshot;
+	if ((snapshot = (ZitatespuckerSnapshot *) malloc(sizeof(ZitatespuckerSnapshot) + len * sizeof(ZitatespuckerZitat) + poolsize)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	snapshot->refcount = 1;
+	snapshot->len = len;
+	snapshot->Zitate = (ZitatespuckerZitat *) (snapshot + 1);
+
+	// second pass: copy
+	char *pool = (char *) (snapshot->Zitate + len);
+	size_t i = 0;
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat, i++) {
+		ZitatespuckerZitat *Zitat = &snapshot->Zitate[i];
+		*Zitat = *cur;
+		// a snapshot cannot be changed, so whatever is not known yet is worked out once here
+		Zitat->authorLen = ZitatespuckerZitatGetAuthorLen(cur);
+		Zitat->zitatLen = ZitatespuckerZitatGetZitatLen(cur);
+		Zitat->commentLen = ZitatespuckerZitatGetCommentLen(cur);
+		Zitat->authorHash = ZitatespuckerZitatGetAuthorHash(cur);
+		Zitat->author = ZitatespuckerSnapshotPoolString(&pool, cur->author, Zitat->authorLen);
+		Zitat->zitat = ZitatespuckerSnapshotPoolString(&pool, cur->zitat, Zitat->zitatLen);
+		Zitat->comment = ZitatespuckerSnapshotPoolString(&pool, cur->comment, Zitat->commentLen);
+		Zitat->prevZitat = (i > 0 ? Zitat - 1 : NULL);
+		Zitat->nextZitat = (i + 1 < len ? Zitat + 1 : NULL);
+	}
+
+	return snapshot;
+}
+
+ZitatespuckerSnapshot *ZitatespuckerSnapshotFromFile(const char *filename, ZitatespuckerSource source)
+{
+	ZitatespuckerZitat *ZitatList;
+	if ((ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filename, source)) == NULL)
+		return NULL;
+
+	ZitatespuckerSnapshot *snapshot = ZitatespuckerSnapshotFromList(ZitatList);
+	ZitatespuckerZitatFree(ZitatList);
+
+	return snapshot;
+}
+
+ZitatespuckerSnapshot *ZitatespuckerSnapshotRetain(ZitatespuckerSnapshot *snapshot)
+{
+	if (snapshot != NULL)
+		ZITATESPUCKER_REFCOUNT_INC(snapshot->refcount);
+
+	return snapshot;
+}
+
+void ZitatespuckerSnapshotRelease(ZitatespuckerSnapshot *snapshot)
+{
+	if (snapshot == NULL)
+		return;
+
+	if (ZITATESPUCKER_REFCOUNT_DEC(snapshot->refcount) == 0)
+		free((void *) snapshot);
+
+	return;
+}
+
+size_t ZitatespuckerSnapshotLen(const ZitatespuckerSnapshot *snapshot)
+{
+	return (snapshot != NULL ? snapshot->len : 0);
+}
+
+const ZitatespuckerZitat *ZitatespuckerSnapshotGet(const ZitatespuckerSnapshot *snapshot, size_t idx)
+{
+	if (snapshot == NULL || idx >= snapshot->len)
+		return NULL;
+
+	return &snapshot->Zitate[idx];
+}
+
+size_t ZitatespuckerSnapshotFindByAuthor(const ZitatespuckerSnapshot *snapshot, const char *authorname, size_t from)
+{
+	if (snapshot == NULL || authorname == NULL)
+		return ZITATESPUCKER_SNAPSHOT_NONE;
+
+	size_t len = strlen(authorname);
+	uint64_t hash = ZitatespuckerAuthorHash(authorname, len);
+	for (size_t i = from; i < snapshot->len; i++) {
+		if (ZitatespuckerZitatIsByAuthor(&snapshot->Zitate[i], authorname, len, hash))
+			return i;
+	}
+
+	return ZITATESPUCKER_SNAPSHOT_NONE;
+}
+
+size_t ZitatespuckerSnapshotFindByDate(const ZitatespuckerSnapshot *snapshot, bool annodomini, uint16_t year, uint8_t month, uint8_t day, size_t from)
+{
+	if (snapshot == NULL)
+		return ZITATESPUCKER_SNAPSHOT_NONE;
+
+	for (size_t i = from; i < snapshot->len; i++) {
+		const ZitatespuckerZitat *Zitat = &snapshot->Zitate[i];
+		if (Zitat->annodomini != annodomini || Zitat->year != year)
+			continue;
+		if (month != 0 && Zitat->month != month)
+			continue;
+		if (day != 0 && Zitat->day != day)
+			continue;
+		return i;
+	}
+
+	return ZITATESPUCKER_SNAPSHOT_NONE;
+}
+
+
+/* Static function definitions */
+
+static inline char *ZitatespuckerSnapshotPoolString(char **pool, const char *src, size_t len)
+{
+	if (src == NULL)
+		return NULL;
+
+	char *ret = *pool;
+	(void) memcpy(ret, src, len);
+	ret[len] = '\0';
+	*pool += len + 1;
+
+	return ret;
+}
@@ -0,0 +1,408 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Backend-independent access to quote sources
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_source.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+#ifdef ZITATESPUCKER_JSON
+	#include "../Zitatespucker/Zitatespucker_json.h"
+#endif
+
+#ifdef ZITATESPUCKER_SQL
+	#include "../Zitatespucker/Zitatespucker_sqlite.h"
+#endif
+
+#ifdef ZITATESPUCKER_NDJSON
+	#include "../Zitatespucker/Zitatespucker_ndjson.h"
+#endif
+
+#ifdef ZITATESPUCKER_CSV
+	#include "../Zitatespucker/Zitatespucker_csv.h"
+#endif
+
+
+/* Every SQLite 3 database starts with this (including the terminating '\0') */
+#define ZITATESPUCKER_SQLITE_MAGIC		"SQLite format 3"
+
+
+/* Static function declarations */
+
+/*
+	Returns true if filename ends with ext (case-insensitive).
+*/
+static bool ZitatespuckerSourceHasExtension(const char *filename, const char *ext);
+
+
+/* Externally callable */
+
+ZitatespuckerSource ZitatespuckerSourceDetect(const char *filename)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return ZITATESPUCKER_SOURCE_UNKNOWN;
+	}
+
+	FILE *file;
+	if ((file = fopen(filename, "rb")) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "fopen() failed for \"%s\".", filename);
+		return ZITATESPUCKER_SOURCE_UNKNOWN;
+	}
+
+	char head[sizeof(ZITATESPUCKER_SQLITE_MAGIC)];
+	size_t headlen = fread(head, 1, sizeof(head), file);
+	(void) fclose(file);
+
+	if (headlen == sizeof(head) && memcmp(head, ZITATESPUCKER_SQLITE_MAGIC, sizeof(head)) == 0)
+		return ZITATESPUCKER_SOURCE_SQL;
+
+	if (ZitatespuckerSourceHasExtension(filename, ".json"))
+		return ZITATESPUCKER_SOURCE_JSON;
+	if (ZitatespuckerSourceHasExtension(filename, ".ndjson") || ZitatespuckerSourceHasExtension(filename, ".jsonl"))
+		return ZITATESPUCKER_SOURCE_NDJSON;
+	if (ZitatespuckerSourceHasExtension(filename, ".csv") || ZitatespuckerSourceHasExtension(filename, ".tsv") || ZitatespuckerSourceHasExtension(filename, ".tab"))
+		return ZITATESPUCKER_SOURCE_CSV;
+
+	// no telling extension, so look at the first thing that is not whitespace
+	for (size_t i = 0; i < headlen; i++) {
+		if (isspace((unsigned char) head[i]))
+			continue;
+		else if (head[i] == '{')
+			return ZITATESPUCKER_SOURCE_JSON;
+		else
+			break;
+	}
+
+	return ZITATESPUCKER_SOURCE_UNKNOWN;
+}
+
+size_t ZitatespuckerSourceGetAmountFromFile(const char *filename, ZitatespuckerSource source)
+{
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN)
+		source = ZitatespuckerSourceDetect(filename);
+
+	switch (source) {
+		#ifdef ZITATESPUCKER_JSON
+		case ZITATESPUCKER_SOURCE_JSON:
+			return ZitatespuckerJSONGetAmountFromFile(filename);
+		#endif
+		#ifdef ZITATESPUCKER_SQL
+		case ZITATESPUCKER_SOURCE_SQL:
+			return ZitatespuckerSQLGetAmountFromFile(filename);
+		#endif
+		#ifdef ZITATESPUCKER_NDJSON
+		case ZITATESPUCKER_SOURCE_NDJSON:
+			return ZitatespuckerNDJSONGetAmountFromFile(filename);
+		#endif
+		#ifdef ZITATESPUCKER_CSV
+		case ZITATESPUCKER_SOURCE_CSV:
+			return ZitatespuckerCSVGetAmountFromFile(filename, NULL);
+		#endif
+		default:
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_UNSUPPORTED, __func__, "No backend available for \"%s\".", (filename != NULL ? filename : "(null)"));
+			return 0;
+	}
+}
+
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFile(const char *filename, ZitatespuckerSource source)
+{
+	return ZitatespuckerSourceGetZitatAllFromFileFields(filename, source, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileFields(const char *filename, ZitatespuckerSource source, ZitatespuckerFields fields)
+{
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN)
+		source = ZitatespuckerSourceDetect(filename);
+
+	switch (source) {
+		#ifdef ZITATESPUCKER_JSON
+		case ZITATESPUCKER_SOURCE_JSON:
+			return ZitatespuckerJSONGetZitatAllFromFileFields(filename, fields);
+		#endif
+		#ifdef ZITATESPUCKER_SQL
+		case ZITATESPUCKER_SOURCE_SQL:
+			return ZitatespuckerSQLGetZitatAllFromFileFields(filename, fields);
+		#endif
+		#ifdef ZITATESPUCKER_NDJSON
+		case ZITATESPUCKER_SOURCE_NDJSON:
+			return ZitatespuckerNDJSONGetZitatAllFromFileFields(filename, fields);
+		#endif
+		#ifdef ZITATESPUCKER_CSV
+		case ZITATESPUCKER_SOURCE_CSV:
+			return ZitatespuckerCSVGetZitatAllFromFileFields(filename, NULL, fields);
+		#endif
+		default:
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_UNSUPPORTED, __func__, "No backend available for \"%s\".", (filename != NULL ? filename : "(null)"));
+			return NULL;
+	}
+}
+
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFiles(const char *const *filenames, size_t amount, ZitatespuckerDuplicates keep, ZitatespuckerZitatDuplicate callback, void *userdata)
+{
+	if (filenames == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filenames!");
+		return NULL;
+	}
+
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *last = NULL;
+	for (size_t i = 0; i < amount; i++) {
+		ZitatespuckerZitat *ZitatList;
+		if ((ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filenames[i], ZITATESPUCKER_SOURCE_UNKNOWN)) == NULL) {
+			ZitatespuckerZitatFree(ret);
+			return NULL;
+		}
+
+		// append
+		if (last != NULL) {
+			last->nextZitat = ZitatList;
+			ZitatList->prevZitat = last;
+		} else {
+			ret = ZitatList;
+		}
+		for (last = ZitatList; last->nextZitat != NULL; last = last->nextZitat)
+			;
+	}
+
+	ZitatespuckerZitat *deduped;
+	if ((deduped = ZitatespuckerZitatDedup(ret, keep, callback, userdata, NULL)) == NULL)
+		ZitatespuckerZitatFree(ret);
+
+	return deduped;
+}
+
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatSingleFromFile(const char *filename, ZitatespuckerSource source, const size_t idx)
+{
+	return ZitatespuckerSourceGetZitatSingleFromFileFields(filename, source, idx, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatSingleFromFileFields(const char *filename, ZitatespuckerSource source, const size_t idx, ZitatespuckerFields fields)
+{
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN)
+		source = ZitatespuckerSourceDetect(filename);
+
+	switch (source) {
+		#ifdef ZITATESPUCKER_JSON
+		case ZITATESPUCKER_SOURCE_JSON:
+			return ZitatespuckerJSONGetZitatSingleFromFileFields(filename, idx, fields);
+		#endif
+		#ifdef ZITATESPUCKER_SQL
+		case ZITATESPUCKER_SOURCE_SQL:
+			return ZitatespuckerSQLGetZitatSingleFromFileFields(filename, idx, fields);
+		#endif
+		#ifdef ZITATESPUCKER_NDJSON
+		case ZITATESPUCKER_SOURCE_NDJSON:
+			return ZitatespuckerNDJSONGetZitatSingleFromFileFields(filename, idx, fields);
+		#endif
+		#ifdef ZITATESPUCKER_CSV
+		case ZITATESPUCKER_SOURCE_CSV:
+			return ZitatespuckerCSVGetZitatSingleFromFileFields(filename, NULL, idx, fields);
+		#endif
+		default:
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_UNSUPPORTED, __func__, "No backend available for \"%s\".", (filename != NULL ? filename : "(null)"));
+			return NULL;
+	}
+}
+
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileByAuthor(const char *filename, ZitatespuckerSource source, const char *authorname)
+{
+	return ZitatespuckerSourceGetZitatAllFromFileByAuthorFields(filename, source, authorname, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileByAuthorFields(const char *filename, ZitatespuckerSource source, const char *authorname, ZitatespuckerFields fields)
+{
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN)
+		source = ZitatespuckerSourceDetect(filename);
+
+	switch (source) {
+		#ifdef ZITATESPUCKER_JSON
+		case ZITATESPUCKER_SOURCE_JSON:
+			return ZitatespuckerJSONGetZitatAllFromFileByAuthorFields(filename, authorname, fields);
+		#endif
+		#ifdef ZITATESPUCKER_SQL
+		case ZITATESPUCKER_SOURCE_SQL:
+			return ZitatespuckerSQLGetZitatAllFromFileByAuthorFields(filename, authorname, fields);
+		#endif
+		#ifdef ZITATESPUCKER_NDJSON
+		case ZITATESPUCKER_SOURCE_NDJSON:
+			return ZitatespuckerNDJSONGetZitatAllFromFileByAuthorFields(filename, authorname, fields);
+		#endif
+		#ifdef ZITATESPUCKER_CSV
+		case ZITATESPUCKER_SOURCE_CSV:
+			return ZitatespuckerCSVGetZitatAllFromFileByAuthorFields(filename, NULL, authorname, fields);
+		#endif
+		default:
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_UNSUPPORTED, __func__, "No backend available for \"%s\".", (filename != NULL ? filename : "(null)"));
+			return NULL;
+	}
+}
+
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileByDate(const char *filename, ZitatespuckerSource source, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	return ZitatespuckerSourceGetZitatAllFromFileByDateFields(filename, source, annodomini, year, month, day, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerSourceGetZitatAllFromFileByDateFields(const char *filename, ZitatespuckerSource source, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields)
+{
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN)
+		source = ZitatespuckerSourceDetect(filename);
+
+	switch (source) {
+		#ifdef ZITATESPUCKER_JSON
+		case ZITATESPUCKER_SOURCE_JSON:
+			return ZitatespuckerJSONGetZitatAllFromFileByDateFields(filename, annodomini, year, month, day, fields);
+		#endif
+		#ifdef ZITATESPUCKER_SQL
+		case ZITATESPUCKER_SOURCE_SQL:
+			return ZitatespuckerSQLGetZitatAllFromFileByDateFields(filename, annodomini, year, month, day, fields);
+		#endif
+		#ifdef ZITATESPUCKER_NDJSON
+		case ZITATESPUCKER_SOURCE_NDJSON:
+			return ZitatespuckerNDJSONGetZitatAllFromFileByDateFields(filename, annodomini, year, month, day, fields);
+		#endif
+		#ifdef ZITATESPUCKER_CSV
+		case ZITATESPUCKER_SOURCE_CSV:
+			return ZitatespuckerCSVGetZitatAllFromFileByDateFields(filename, NULL, annodomini, year, month, day, fields);
+		#endif
+		default:
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_UNSUPPORTED, __func__, "No backend available for \"%s\".", (filename != NULL ? filename : "(null)"));
+			return NULL;
+	}
+}
+
+ZitatespuckerCounts *ZitatespuckerSourceCountFromFile(const char *filename, ZitatespuckerSource source, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter)
+{
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN)
+		source = ZitatespuckerSourceDetect(filename);
+
+	switch (source) {
+		#ifdef ZITATESPUCKER_JSON
+		case ZITATESPUCKER_SOURCE_JSON:
+			return ZitatespuckerJSONCountFromFile(filename, group, filter);
+		#endif
+		#ifdef ZITATESPUCKER_SQL
+		case ZITATESPUCKER_SOURCE_SQL:
+			return ZitatespuckerSQLCountFromFile(filename, group, filter);
+		#endif
+		#ifdef ZITATESPUCKER_NDJSON
+		case ZITATESPUCKER_SOURCE_NDJSON:
+			return ZitatespuckerNDJSONCountFromFile(filename, group, filter);
+		#endif
+		#ifdef ZITATESPUCKER_CSV
+		case ZITATESPUCKER_SOURCE_CSV:
+			return ZitatespuckerCSVCountFromFile(filename, NULL, group, filter);
+		#endif
+		default:
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_UNSUPPORTED, __func__, "No backend available for \"%s\".", (filename != NULL ? filename : "(null)"));
+			return NULL;
+	}
+}
+
+#ifdef ZITATESPUCKER_SQL
+bool ZitatespuckerSourceImportToSQL(const char *filename, ZitatespuckerSource source, const char *dbname, ZitatespuckerSQLImportStats *stats)
+{
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN)
+		source = ZitatespuckerSourceDetect(filename);
+
+	#ifdef ZITATESPUCKER_JSON
+	if (source == ZITATESPUCKER_SOURCE_JSON) {
+		ZitatespuckerSQLImporter *importer;
+		if ((importer = ZitatespuckerSQLImportBegin(dbname)) == NULL)
+			return false;
+
+		bool ret = (ZitatespuckerJSONForEachFromFile(filename, ZitatespuckerSQLImportCallback, importer) != 0);
+		ZitatespuckerSQLImportStats tmpStats;
+		ret &= ZitatespuckerSQLImportEnd(importer, &tmpStats);
+		if (stats != NULL)
+			*stats = tmpStats;
+
+		return (ret && tmpStats.failed == 0);
+	}
+	#endif
+
+	#ifdef ZITATESPUCKER_NDJSON
+	if (source == ZITATESPUCKER_SOURCE_NDJSON) {
+		ZitatespuckerSQLImporter *importer;
+		if ((importer = ZitatespuckerSQLImportBegin(dbname)) == NULL)
+			return false;
+
+		bool ret = (ZitatespuckerNDJSONForEachFromFile(filename, ZitatespuckerSQLImportCallback, importer) != 0);
+		ZitatespuckerSQLImportStats tmpStats;
+		ret &= ZitatespuckerSQLImportEnd(importer, &tmpStats);
+		if (stats != NULL)
+			*stats = tmpStats;
+
+		return (ret && tmpStats.failed == 0);
+	}
+	#endif
+
+	#ifdef ZITATESPUCKER_CSV
+	if (source == ZITATESPUCKER_SOURCE_CSV) {
+		ZitatespuckerSQLImporter *importer;
+		if ((importer = ZitatespuckerSQLImportBegin(dbname)) == NULL)
+			return false;
+
+		bool ret = (ZitatespuckerCSVForEachFromFile(filename, NULL, ZitatespuckerSQLImportCallback, importer) != 0);
+		ZitatespuckerSQLImportStats tmpStats;
+		ret &= ZitatespuckerSQLImportEnd(importer, &tmpStats);
+		if (stats != NULL)
+			*stats = tmpStats;
+
+		return (ret && tmpStats.failed == 0);
+	}
+	#endif
+
+	ZitatespuckerZitat *ZitatList;
+	if ((ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filename, source)) == NULL)
+		return false;
+
+	bool ret = ZitatespuckerSQLImportList(dbname, ZitatList, stats);
+	ZitatespuckerZitatFree(ZitatList);
+
+	return ret;
+}
+#endif
+
+
+/* Static function definitions */
+
+static bool ZitatespuckerSourceHasExtension(const char *filename, const char *ext)
+{
+	size_t namelen = strlen(filename);
+	size_t extlen = strlen(ext);
+	if (namelen < extlen)
+		return false;
+
+	const char *tail = filename + (namelen - extlen);
+	for (size_t i = 0; i < extlen; i++) {
+		if (tolower((unsigned char) tail[i]) != tolower((unsigned char) ext[i]))
+			return false;
+	}
+
+	return true;
+}
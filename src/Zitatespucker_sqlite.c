@@ -19,6 +19,9 @@
     along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+/* sysconf() */
+#define _POSIX_C_SOURCE 200809L
+
 
 /* Standard headers */
 #include <stdio.h>
@@ -26,111 +29,1524 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+
+
+/* SQLite headers */
+#include <sqlite3.h>
+
+
+/* Internal headers */
+#include "../Zitatespucker/Zitatespucker_sqlite.h"
+#include "../Zitatespucker/Zitatespucker_diag.h"
+
+
+/* Same layout as the table in the example databases, so the existing SELECTs work on imported ones */
+#define ZITATESPUCKER_SQL_CREATE_TABLE \
+	"CREATE TABLE IF NOT EXISTS ZitatespuckerZitat (author TEXT, zitat TEXT, comment TEXT, day INTEGER, month INTEGER, year INTEGER, annodomini TEXT)"
+
+#define ZITATESPUCKER_SQL_DROP_INDEXES \
+	"DROP INDEX IF EXISTS ZitatespuckerZitatByAuthor; DROP INDEX IF EXISTS ZitatespuckerZitatByDate"
+
+#define ZITATESPUCKER_SQL_CREATE_INDEXES \
+	"CREATE INDEX IF NOT EXISTS ZitatespuckerZitatByAuthor ON ZitatespuckerZitat (author); " \
+	"CREATE INDEX IF NOT EXISTS ZitatespuckerZitatByDate ON ZitatespuckerZitat (annodomini, year, month, day)"
+
+/* The year and era of a row, the way ZitatespuckerSQLGetPopulatedStruct() reads them */
+#define ZITATESPUCKER_SQL_YEAR		"MIN(MAX(IFNULL(CAST(year AS INTEGER), 0), 0), 65535)"
+#define ZITATESPUCKER_SQL_AD		"(annodomini IS 'true')"
+
+/* Enough for the longest column list ZitatespuckerSQLColumns() writes */
+#define ZITATESPUCKER_SQL_COLUMNS_LEN	64
+
+/* Matches rows with a valid date whose signed year (see ZitatespuckerCountFilter) lies within ?2 and ?3 */
+#define ZITATESPUCKER_SQL_YEAR_RANGE \
+	"(" ZITATESPUCKER_SQL_AD " OR " ZITATESPUCKER_SQL_YEAR " != 0) AND " \
+	"(CASE WHEN " ZITATESPUCKER_SQL_AD " THEN " ZITATESPUCKER_SQL_YEAR " ELSE -" ZITATESPUCKER_SQL_YEAR " END) BETWEEN ?2 AND ?3"
+
+
+struct ZitatespuckerSQLImporter {
+	sqlite3 *db;
+	sqlite3_stmt *insert;
+	size_t rows;
+	size_t failed;
+	size_t batch; /* Rows within the current transaction */
+	sqlite3_int64 start; /* In milliseconds */
+};
+
+struct ZitatespuckerSQLReader {
+	sqlite3 *db;
+	ZitatespuckerSQLPool *pool;
+	sqlite3_stmt *byRowid; /* Kept for ZitatespuckerSQLReaderGetZitatByRowid(), NULL until its first call */
+	ZitatespuckerFields byRowidFields; /* What byRowid selects */
+	struct ZitatespuckerSQLReader *nextReader; /* next idle reader of the pool */
+};
+
+/* Everything below lock is guarded by it */
+struct ZitatespuckerSQLPool {
+	char *path; /* what is passed to sqlite3_open_v2(): the filename, or a URI for immutable pools */
+	int flags;
+	bool immutable;
+
+	sqlite3_mutex *lock;
+	ZitatespuckerSQLReader *idle;
+	size_t busy; /* readers handed out */
+	bool closed; /* true --> readers are closed on release, the pool is freed with the last one */
+};
+
+/* A range of rowids, scanned on a connection of its own, and the list of what was read from it */
+typedef struct ZitatespuckerSQLShard {
+	pthread_t thread;
+	bool started; /* true --> thread has to be joined */
+	const char *filename;
+	sqlite3 *db; /* NULL --> the shard opens the file itself */
+	sqlite3_int64 from; /* first rowid */
+	sqlite3_int64 to; /* last rowid */
+	ZitatespuckerFields fields;
+	ZitatespuckerZitat *first;
+	ZitatespuckerZitat *last;
+	bool failed;
+	ZitatespuckerError error; /* Why the thread of the shard failed */
+} ZitatespuckerSQLShard;
+
+struct ZitatespuckerSQLFederation {
+	sqlite3 *db; /* an empty in-memory database, with the files attached as zs0 to zs<len - 1> */
+	size_t len;
+};
+
+
+/* Static function declarations */
+
+/*
+	Populate a ZitatespuckerZitat struct with the fields within fields from the prepared SQL statement ZitatStmt and return it.
+	ZitatStmt has to select the columns ZitatespuckerSQLColumns() lists for fields.
+	NULL on error.
+	
+	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
+*/
+static ZitatespuckerZitat *ZitatespuckerSQLGetPopulatedStruct(sqlite3_stmt *ZitatStmt, ZitatespuckerFields fields);
+
+/*
+	Write the list of columns to select for fields into buf, which has room for ZITATESPUCKER_SQL_COLUMNS_LEN chars.
+*/
+static void ZitatespuckerSQLColumns(ZitatespuckerFields fields, char *buf);
+
+/*
+	Get the string content of column iCol from prepared statement ZitatStmt, and store its length in len.
+
+	NULL may be a valid return.
+	This function duplicates the string and checks for proper NULL-termination.
+*/
+static inline char *ZitatespuckerSQLGetStringAllocated(sqlite3_stmt *ZitatStmt, int iCol, size_t *len);
+
+/*
+	Returns the length to bind str with: len if known (see ZitatespuckerZitat), -1 (up to the '\0') otherwise.
+*/
+static inline int ZitatespuckerSQLTextLen(const char *str, size_t len);
+
+/*
+	Run the ';'-separated statements in sql on db, reporting errors on behalf of caller.
+	false on error.
+*/
+static bool ZitatespuckerSQLExec(sqlite3 *db, const char *sql, const char *caller);
+
+/*
+	Returns the current time in milliseconds, as seen by SQLite (which works the same on every platform it runs on).
+*/
+static sqlite3_int64 ZitatespuckerSQLNow(void);
+
+/*
+	Run sql, which ends the current transaction of importer with a COMMIT.
+	The rows of that transaction count as inserted if this works; otherwise they are rolled back and count as failed.
+	Returns false on error.
+*/
+static bool ZitatespuckerSQLImportCommit(ZitatespuckerSQLImporter *importer, const char *sql, const char *caller);
+
+/*
+	Open a reader connected to the database of pool.
+	NULL on error.
+*/
+static ZitatespuckerSQLReader *ZitatespuckerSQLReaderOpen(ZitatespuckerSQLPool *pool);
+
+/*
+	Close reader and free it.
+*/
+static void ZitatespuckerSQLReaderClose(ZitatespuckerSQLReader *reader);
+
+/*
+	Returns the URI opening filename in immutable mode, with every byte outside the unreserved set percent-encoded.
+	NULL on error.
+
+	This function allocates, and the returned string must be freed with free().
+*/
+static char *ZitatespuckerSQLImmutableURI(const char *filename);
+
+/*
+	Free pool and its idle readers. Caller must make sure no reader is handed out anymore.
+*/
+static void ZitatespuckerSQLPoolFree(ZitatespuckerSQLPool *pool);
+
+/*
+	Open filename with flags, reporting errors on behalf of caller.
+	NULL on error.
+*/
+static sqlite3 *ZitatespuckerSQLOpen(const char *filename, int flags, const char *caller);
+
+/*
+	Run the query behind ZitatespuckerSQLGetAmountFromFile() on db.
+	db stays open.
+*/
+static size_t ZitatespuckerSQLQueryAmount(sqlite3 *db);
+
+/*
+	Run the query behind ZitatespuckerSQLGetZitatSingleFromFileFields() on db.
+	db stays open.
+*/
+static ZitatespuckerZitat *ZitatespuckerSQLQuerySingle(sqlite3 *db, const size_t idx, ZitatespuckerFields fields);
+
+/*
+	Run the query behind ZitatespuckerSQLGetZitatAllFromFileFields() on db.
+	db stays open.
+*/
+static ZitatespuckerZitat *ZitatespuckerSQLQueryAll(sqlite3 *db, ZitatespuckerFields fields);
+
+/*
+	Run the query behind ZitatespuckerSQLGetZitatAllFromFileByAuthorFields() on db.
+	db stays open.
+*/
+static ZitatespuckerZitat *ZitatespuckerSQLQueryByAuthor(sqlite3 *db, const char *authorname, ZitatespuckerFields fields);
+
+/*
+	Run the query behind ZitatespuckerSQLGetZitatAllFromFileByDateFields() on db.
+	db stays open.
+*/
+static ZitatespuckerZitat *ZitatespuckerSQLQueryByDate(sqlite3 *db, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields);
+
+/*
+	Read the rows within the rowid range of shard into its list, on the connection of the shard or one of its own.
+	Sets shard->failed on error.
+*/
+static void ZitatespuckerSQLScanShard(ZitatespuckerSQLShard *shard);
+
+/*
+	ZitatespuckerSQLScanShard() as a thread; arg is the ZitatespuckerSQLShard.
+*/
+static void *ZitatespuckerSQLScanShardThread(void *arg);
+
+/*
+	Prepare "SELECT select FROM <table>where" for the ZitatespuckerZitat table of every database of federation,
+	joined by UNION ALL (where is appended as it is, so it starts with a space or is empty).
+	Numbered parameters (?1, ?2, ...) mean the same in every part, so each has to be bound only once.
+	Errors are reported on behalf of caller.
+	NULL on error.
+*/
+static sqlite3_stmt *ZitatespuckerSQLFederationPrepare(ZitatespuckerSQLFederation *federation, const char *select, const char *where, const char *caller);
+
+/*
+	Link the rows statement returns into a list of ZitatespuckerZitat with the fields within fields.
+	statement has to select the columns ZitatespuckerSQLColumns() lists for fields, and is finalized.
+	NULL on error or if there are no rows.
+*/
+static ZitatespuckerZitat *ZitatespuckerSQLFederationCollect(ZitatespuckerSQLFederation *federation, sqlite3_stmt *statement, ZitatespuckerFields fields, const char *caller);
+
+
+/* Externally callable */
+
+size_t ZitatespuckerSQLGetAmountFromFile(const char *filename)
+{
+	// perhaps one could replace this using a SQL COUNT statement
+	// but as of now, this is on par with the JSON backend
+
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return 0;
+	}
+
+	sqlite3 *db;
+	if ((db = ZitatespuckerSQLOpen(filename, SQLITE_OPEN_READONLY, __func__)) == NULL)
+		return 0;
+
+	size_t ret = ZitatespuckerSQLQueryAmount(db);
+	(void) sqlite3_close(db);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatSingleFromFile(const char *filename, const size_t idx)
+{
+	return ZitatespuckerSQLGetZitatSingleFromFileFields(filename, idx, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatSingleFromFileFields(const char *filename, const size_t idx, ZitatespuckerFields fields)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	sqlite3 *db;
+	if ((db = ZitatespuckerSQLOpen(filename, SQLITE_OPEN_READONLY, __func__)) == NULL)
+		return NULL;
+
+	ZitatespuckerZitat *ret = ZitatespuckerSQLQuerySingle(db, idx, fields);
+	(void) sqlite3_close(db);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFile(const char *filename)
+{
+	return ZitatespuckerSQLGetZitatAllFromFileFields(filename, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileFields(const char *filename, ZitatespuckerFields fields)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	sqlite3 *db;
+	if ((db = ZitatespuckerSQLOpen(filename, SQLITE_OPEN_READONLY, __func__)) == NULL)
+		return NULL;
+
+	ZitatespuckerZitat *ret = ZitatespuckerSQLQueryAll(db, fields);
+	(void) sqlite3_close(db);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileThreads(const char *filename, ZitatespuckerFields fields, size_t threads)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	sqlite3 *db;
+	if ((db = ZitatespuckerSQLOpen(filename, SQLITE_OPEN_READONLY, __func__)) == NULL)
+		return NULL;
+
+	// the rowids to split, and how many rows there are to split them for
+	sqlite3_stmt *statement;
+	if (sqlite3_prepare_v2(db, "SELECT MIN(rowid), MAX(rowid), COUNT(*) FROM ZitatespuckerZitat", -1, &statement, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(db));
+		(void) sqlite3_close(db);
+		return NULL;
+	}
+	if (sqlite3_step(statement) != SQLITE_ROW) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_step() failed: %s", sqlite3_errmsg(db));
+		(void) sqlite3_finalize(statement);
+		(void) sqlite3_close(db);
+		return NULL;
+	}
+	sqlite3_int64 minRowid = sqlite3_column_int64(statement, 0);
+	sqlite3_int64 maxRowid = sqlite3_column_int64(statement, 1);
+	size_t rows = (size_t) sqlite3_column_int64(statement, 2);
+	(void) sqlite3_finalize(statement);
+
+	// like ZitatespuckerSQLGetZitatAllFromFile(), an empty table is not an error
+	if (rows == 0) {
+		(void) sqlite3_close(db);
+		return NULL;
+	}
+
+	// unless asked for a number, only use as many threads as there are processors and shards worth the effort
+	if (threads == 0) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (online > 1 ? (size_t) online : 1);
+		if (threads > rows / ZITATESPUCKER_SQL_SHARD_MIN)
+			threads = (rows / ZITATESPUCKER_SQL_SHARD_MIN > 1 ? rows / ZITATESPUCKER_SQL_SHARD_MIN : 1);
+	}
+	if (threads > ZITATESPUCKER_SQL_MAX_THREADS)
+		threads = ZITATESPUCKER_SQL_MAX_THREADS;
+	uint64_t span = (uint64_t) maxRowid - (uint64_t) minRowid + 1;
+	if (span != 0 && threads > span)
+		threads = (size_t) span;
+
+	// equal ranges of rowids, which are equal numbers of rows unless many rows were deleted
+	ZitatespuckerSQLShard shards[ZITATESPUCKER_SQL_MAX_THREADS];
+	uint64_t step = (span != 0 ? span / threads : UINT64_MAX / threads);
+	for (size_t i = 0; i < threads; i++) {
+		shards[i].started = false;
+		shards[i].filename = filename;
+		shards[i].db = (i == 0 ? db : NULL);
+		shards[i].from = (sqlite3_int64) ((uint64_t) minRowid + step * i);
+		shards[i].to = (i + 1 < threads ? (sqlite3_int64) ((uint64_t) minRowid + step * (i + 1) - 1) : maxRowid);
+		shards[i].fields = fields;
+		shards[i].first = NULL;
+		shards[i].last = NULL;
+		shards[i].failed = false;
+		shards[i].error = ZITATESPUCKER_ERROR_NONE;
+	}
+
+	// the first shard is scanned on this thread, on the connection opened above; so is any other one a thread could not be started for
+	for (size_t i = 1; i < threads; i++)
+		shards[i].started = (pthread_create(&shards[i].thread, NULL, ZitatespuckerSQLScanShardThread, &shards[i]) == 0);
+	for (size_t i = 0; i < threads; i++) {
+		if (!shards[i].started)
+			ZitatespuckerSQLScanShard(&shards[i]);
+	}
+
+	// link the pieces in rowid order
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *last = NULL;
+	bool failed = false;
+	for (size_t i = 0; i < threads; i++) {
+		if (shards[i].started) {
+			(void) pthread_join(shards[i].thread, NULL);
+			if (shards[i].failed)
+				ZITATESPUCKER_REPORT_ERROR(shards[i].error, __func__, "Reading part of \"%s\" on another thread failed.", filename);
+		}
+		failed |= shards[i].failed;
+
+		if (shards[i].first == NULL)
+			continue;
+		if (last != NULL) {
+			last->nextZitat = shards[i].first;
+			shards[i].first->prevZitat = last;
+		} else
+			ret = shards[i].first;
+		last = shards[i].last;
+	}
+	(void) sqlite3_close(db);
+
+	if (failed) {
+		ZitatespuckerZitatFree(ret);
+		return NULL;
+	}
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByAuthor(const char *filename, const char *authorname)
+{
+	return ZitatespuckerSQLGetZitatAllFromFileByAuthorFields(filename, authorname, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByAuthorFields(const char *filename, const char *authorname, ZitatespuckerFields fields)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	sqlite3 *db;
+	if ((db = ZitatespuckerSQLOpen(filename, SQLITE_OPEN_READONLY, __func__)) == NULL)
+		return NULL;
+
+	ZitatespuckerZitat *ret = ZitatespuckerSQLQueryByAuthor(db, authorname, fields);
+	(void) sqlite3_close(db);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByDate(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	return ZitatespuckerSQLGetZitatAllFromFileByDateFields(filename, annodomini, year, month, day, ZITATESPUCKER_FIELD_ALL);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByDateFields(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	sqlite3 *db;
+	if ((db = ZitatespuckerSQLOpen(filename, SQLITE_OPEN_READONLY, __func__)) == NULL)
+		return NULL;
+
+	ZitatespuckerZitat *ret = ZitatespuckerSQLQueryByDate(db, annodomini, year, month, day, fields);
+	(void) sqlite3_close(db);
+
+	return ret;
+}
+
+ZitatespuckerCounts *ZitatespuckerSQLCountFromFile(const char *filename, ZitatespuckerGroup group, const ZitatespuckerCountFilter *filter)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	ZitatespuckerCounter *counter;
+	if ((counter = ZitatespuckerCountBegin(group, filter)) == NULL)
+		return NULL;
+
+	const char *sSelect;
+	const char *sGroup;
+	switch (group) {
+		case ZITATESPUCKER_GROUP_NONE:
+			sSelect = "SELECT COUNT(*)";
+			sGroup = "";
+			break;
+		case ZITATESPUCKER_GROUP_AUTHOR:
+			sSelect = "SELECT COUNT(*), author";
+			sGroup = " GROUP BY author";
+			break;
+		default:
+			// decades, centuries and eras are merged from years by the counter
+			sSelect = "SELECT COUNT(*), " ZITATESPUCKER_SQL_AD ", " ZITATESPUCKER_SQL_YEAR;
+			sGroup = " GROUP BY 2, 3";
+			break;
+	}
+
+	// only mention what is filtered by: filtering by author can use its index, the year range cannot,
+	// as it has to clamp and cast each row's year the way ZitatespuckerSQLGetPopulatedStruct() does, so it is checked row by row
+	bool byAuthor = (filter != NULL && filter->author != NULL);
+	bool byYear = (filter != NULL && filter->byYear);
+	char sSQL[512];
+	(void) snprintf(sSQL, sizeof(sSQL), "%s FROM ZitatespuckerZitat%s%s%s%s%s", sSelect,
+		((byAuthor || byYear) ? " WHERE " : ""), (byAuthor ? "author = ?1" : ""), ((byAuthor && byYear) ? " AND " : ""),
+		(byYear ? ZITATESPUCKER_SQL_YEAR_RANGE : ""), sGroup);
+
+	sqlite3 *db;
+	if ((db = ZitatespuckerSQLOpen(filename, SQLITE_OPEN_READONLY, __func__)) == NULL) {
+		ZitatespuckerCountsFree(ZitatespuckerCountEnd(counter));
+		return NULL;
+	}
+
+	sqlite3_stmt *statement;
+	if (sqlite3_prepare_v2(db, sSQL, -1, &statement, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(db));
+		(void) sqlite3_close(db);
+		ZitatespuckerCountsFree(ZitatespuckerCountEnd(counter));
+		return NULL;
+	}
+
+	bool ok = true;
+	if (byAuthor)
+		ok &= (sqlite3_bind_text(statement, 1, filter->author, -1, SQLITE_STATIC) == SQLITE_OK);
+	if (byYear) {
+		ok &= (sqlite3_bind_int(statement, 2, filter->firstYear) == SQLITE_OK);
+		ok &= (sqlite3_bind_int(statement, 3, filter->lastYear) == SQLITE_OK);
+	}
+	if (!ok) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "binding the filter failed: %s", sqlite3_errmsg(db));
+	}
+
+	int rc = SQLITE_DONE;
+	while (ok && (rc = sqlite3_step(statement)) == SQLITE_ROW) {
+		sqlite3_int64 amount = sqlite3_column_int64(statement, 0);
+		if (amount <= 0)
+			continue;
+
+		ZitatespuckerZitat Zitat;
+		ZitatespuckerZitatInit(&Zitat);
+		if (group == ZITATESPUCKER_GROUP_AUTHOR)
+			Zitat.author = (char *) sqlite3_column_text(statement, 1);
+		else if (group != ZITATESPUCKER_GROUP_NONE) {
+			Zitat.annodomini = (sqlite3_column_int(statement, 1) != 0);
+			Zitat.year = (uint16_t) sqlite3_column_int(statement, 2);
+		}
+		ok = ZitatespuckerCountAddAmount(counter, &Zitat, (size_t) amount);
+	}
+	if (ok && rc != SQLITE_DONE) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_step() failed: %s", sqlite3_errmsg(db));
+		ok = false;
+	}
+
+	if (sqlite3_finalize(statement) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
+	}
+	(void) sqlite3_close(db);
+
+	ZitatespuckerCounts *ret = ZitatespuckerCountEnd(counter);
+	if (!ok) {
+		ZitatespuckerCountsFree(ret);
+		ret = NULL;
+	}
+
+	return ret;
+}
+
+ZitatespuckerSQLImporter *ZitatespuckerSQLImportBegin(const char *filename)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	ZitatespuckerSQLImporter *importer;
+	if ((importer = (ZitatespuckerSQLImporter *) calloc(1, sizeof(ZitatespuckerSQLImporter))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "calloc() returned NULL.");
+		return NULL;
+	}
+	importer->start = ZitatespuckerSQLNow();
+
+	if (sqlite3_open_v2(filename, &importer->db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_open_v2() failed: %s", sqlite3_errmsg(importer->db));
+		(void) sqlite3_close(importer->db);
+		free((void *) importer);
+		return NULL;
+	}
+
+	// a large page cache keeps the b-tree in memory while the batches go in;
+	// the indexes are dropped within the first batch, so they are still there if starting fails
+	if (!ZitatespuckerSQLExec(importer->db, "PRAGMA cache_size = -65536; " ZITATESPUCKER_SQL_CREATE_TABLE "; BEGIN; " ZITATESPUCKER_SQL_DROP_INDEXES, __func__)) {
+		(void) sqlite3_exec(importer->db, "ROLLBACK", NULL, NULL, NULL);
+		(void) sqlite3_close(importer->db);
+		free((void *) importer);
+		return NULL;
+	}
+
+	if (sqlite3_prepare_v2(importer->db, "INSERT INTO ZitatespuckerZitat (author, zitat, comment, day, month, year, annodomini) VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7)", -1, &importer->insert, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(importer->db));
+		(void) ZitatespuckerSQLExec(importer->db, "ROLLBACK", __func__);
+		(void) sqlite3_close(importer->db);
+		free((void *) importer);
+		return NULL;
+	}
+
+	return importer;
+}
+
+bool ZitatespuckerSQLImportAdd(ZitatespuckerSQLImporter *importer, const ZitatespuckerZitat *Zitat)
+{
+	if (importer == NULL || Zitat == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL importer or Zitat!");
+		if (importer != NULL)
+			importer->failed++;
+		return false;
+	}
+
+	// the strings only need to live until sqlite3_step() is done with them, so no copies (SQLITE_STATIC)
+	sqlite3_stmt *insert = importer->insert;
+	bool ret = (sqlite3_bind_text(insert, 1, Zitat->author, ZitatespuckerSQLTextLen(Zitat->author, Zitat->authorLen), SQLITE_STATIC) == SQLITE_OK
+		&& sqlite3_bind_text(insert, 2, Zitat->zitat, ZitatespuckerSQLTextLen(Zitat->zitat, Zitat->zitatLen), SQLITE_STATIC) == SQLITE_OK
+		&& sqlite3_bind_text(insert, 3, Zitat->comment, ZitatespuckerSQLTextLen(Zitat->comment, Zitat->commentLen), SQLITE_STATIC) == SQLITE_OK
+		&& sqlite3_bind_int(insert, 4, Zitat->day) == SQLITE_OK
+		&& sqlite3_bind_int(insert, 5, Zitat->month) == SQLITE_OK
+		&& sqlite3_bind_int(insert, 6, Zitat->year) == SQLITE_OK
+		&& sqlite3_bind_text(insert, 7, (Zitat->annodomini ? "true" : "false"), -1, SQLITE_STATIC) == SQLITE_OK
+		&& sqlite3_step(insert) == SQLITE_DONE);
+	if (!ret) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "Inserting a row failed: %s", sqlite3_errmsg(importer->db));
+	}
+	(void) sqlite3_reset(insert);
+	(void) sqlite3_clear_bindings(insert);
+
+	if (!ret) {
+		importer->failed++;
+		return false;
+	}
+
+	if (++importer->batch == ZITATESPUCKER_SQL_IMPORT_BATCH) {
+		bool committed = ZitatespuckerSQLImportCommit(importer, "COMMIT", __func__);
+		// the next batch gets a transaction of its own either way
+		if (!ZitatespuckerSQLExec(importer->db, "BEGIN", __func__) || !committed)
+			return false;
+	}
+
+	return true;
+}
+
+bool ZitatespuckerSQLImportCallback(const ZitatespuckerZitat *Zitat, void *importer)
+{
+	(void) ZitatespuckerSQLImportAdd((ZitatespuckerSQLImporter *) importer, Zitat);
+
+	return true;
+}
+
+bool ZitatespuckerSQLImportEnd(ZitatespuckerSQLImporter *importer, ZitatespuckerSQLImportStats *stats)
+{
+	if (importer == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL importer!");
+		return false;
+	}
+
+	if (sqlite3_finalize(importer->insert) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(importer->db));
+	}
+
+	// the indexes go into the last transaction, so a failure leaves the database as it was before that;
+	// the batches committed earlier went in without them though, so they are put back on their own then
+	bool ret = ZitatespuckerSQLImportCommit(importer, ZITATESPUCKER_SQL_CREATE_INDEXES "; COMMIT", __func__);
+	if (!ret)
+		(void) ZitatespuckerSQLExec(importer->db, ZITATESPUCKER_SQL_CREATE_INDEXES, __func__);
+	(void) sqlite3_close(importer->db);
+
+	if (stats != NULL) {
+		stats->rows = importer->rows;
+		stats->failed = importer->failed;
+		stats->seconds = (double) (ZitatespuckerSQLNow() - importer->start) / 1000.0;
+		stats->rowsPerSecond = (stats->seconds > 0 ? (double) importer->rows / stats->seconds : 0);
+	}
+	free((void *) importer);
+
+	return ret;
+}
+
+bool ZitatespuckerSQLImportList(const char *filename, const ZitatespuckerZitat *ZitatList, ZitatespuckerSQLImportStats *stats)
+{
+	if (ZitatList == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL ZitatList!");
+		return false;
+	}
+
+	ZitatespuckerSQLImporter *importer;
+	if ((importer = ZitatespuckerSQLImportBegin(filename)) == NULL)
+		return false;
+
+	while (ZitatList->prevZitat != NULL)
+		ZitatList = ZitatList->prevZitat;
+
+	bool ret = true;
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat)
+		ret &= ZitatespuckerSQLImportAdd(importer, cur);
+
+	return (ZitatespuckerSQLImportEnd(importer, stats) && ret);
+}
+
+ZitatespuckerSQLPool *ZitatespuckerSQLPoolOpen(const char *filename, bool immutable)
+{
+	if (filename == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename!");
+		return NULL;
+	}
+
+	ZitatespuckerSQLPool *pool;
+	if ((pool = (ZitatespuckerSQLPool *) calloc(1, sizeof(ZitatespuckerSQLPool))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "calloc() returned NULL.");
+		return NULL;
+	}
+	pool->immutable = immutable;
+
+	// every reader belongs to one thread at a time, so SQLite does not need to lock within a connection
+	if (immutable) {
+		pool->path = ZitatespuckerSQLImmutableURI(filename);
+		pool->flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_URI | SQLITE_OPEN_NOMUTEX;
+	} else if ((pool->path = (char *) malloc(strlen(filename) + 1)) != NULL) {
+		(void) strcpy(pool->path, filename);
+		pool->flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+	}
+	if (pool->path == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		free((void *) pool);
+		return NULL;
+	}
+
+	if ((pool->lock = sqlite3_mutex_alloc(SQLITE_MUTEX_FAST)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "sqlite3_mutex_alloc() returned NULL.");
+		free((void *) pool->path);
+		free((void *) pool);
+		return NULL;
+	}
+
+	if ((pool->idle = ZitatespuckerSQLReaderOpen(pool)) == NULL) {
+		ZitatespuckerSQLPoolFree(pool);
+		return NULL;
+	}
+
+	return pool;
+}
+
+ZitatespuckerSQLReader *ZitatespuckerSQLPoolAcquire(ZitatespuckerSQLPool *pool)
+{
+	if (pool == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL pool!");
+		return NULL;
+	}
+
+	sqlite3_mutex_enter(pool->lock);
+	ZitatespuckerSQLReader *reader = pool->idle;
+	if (reader != NULL)
+		pool->idle = reader->nextReader;
+	pool->busy++;
+	sqlite3_mutex_leave(pool->lock);
+
+	// opening takes a while, so it is done without holding the lock
+	if (reader == NULL && (reader = ZitatespuckerSQLReaderOpen(pool)) == NULL) {
+		sqlite3_mutex_enter(pool->lock);
+		pool->busy--;
+		sqlite3_mutex_leave(pool->lock);
+		return NULL;
+	}
+	reader->nextReader = NULL;
+
+	return reader;
+}
+
+void ZitatespuckerSQLPoolRelease(ZitatespuckerSQLReader *reader)
+{
+	if (reader == NULL)
+		return;
+
+	ZitatespuckerSQLPool *pool = reader->pool;
+	sqlite3_mutex_enter(pool->lock);
+	pool->busy--;
+	bool closed = pool->closed;
+	bool last = (closed && pool->busy == 0);
+	if (!closed) {
+		reader->nextReader = pool->idle;
+		pool->idle = reader;
+	}
+	sqlite3_mutex_leave(pool->lock);
+
+	if (closed)
+		ZitatespuckerSQLReaderClose(reader);
+	if (last)
+		ZitatespuckerSQLPoolFree(pool);
+
+	return;
+}
+
+void ZitatespuckerSQLPoolClose(ZitatespuckerSQLPool *pool)
+{
+	if (pool == NULL)
+		return;
+
+	sqlite3_mutex_enter(pool->lock);
+	pool->closed = true;
+	bool last = (pool->busy == 0);
+	sqlite3_mutex_leave(pool->lock);
+
+	// otherwise the last ZitatespuckerSQLPoolRelease() frees it
+	if (last)
+		ZitatespuckerSQLPoolFree(pool);
+
+	return;
+}
+
+size_t ZitatespuckerSQLReaderGetAmount(ZitatespuckerSQLReader *reader)
+{
+	if (reader == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL reader!");
+		return 0;
+	}
+
+	return ZitatespuckerSQLQueryAmount(reader->db);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatSingle(ZitatespuckerSQLReader *reader, const size_t idx, ZitatespuckerFields fields)
+{
+	if (reader == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL reader!");
+		return NULL;
+	}
+
+	return ZitatespuckerSQLQuerySingle(reader->db, idx, fields);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatAll(ZitatespuckerSQLReader *reader, ZitatespuckerFields fields)
+{
+	if (reader == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL reader!");
+		return NULL;
+	}
+
+	return ZitatespuckerSQLQueryAll(reader->db, fields);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatAllByAuthor(ZitatespuckerSQLReader *reader, const char *authorname, ZitatespuckerFields fields)
+{
+	if (reader == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL reader!");
+		return NULL;
+	}
+
+	return ZitatespuckerSQLQueryByAuthor(reader->db, authorname, fields);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatAllByDate(ZitatespuckerSQLReader *reader, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields)
+{
+	if (reader == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL reader!");
+		return NULL;
+	}
+
+	return ZitatespuckerSQLQueryByDate(reader->db, annodomini, year, month, day, fields);
+}
+
+bool ZitatespuckerSQLReaderGetRowids(ZitatespuckerSQLReader *reader, int64_t *first, int64_t *last, size_t *amount)
+{
+	if (reader == NULL || first == NULL || last == NULL || amount == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL reader, first, last or amount!");
+		return false;
+	}
+
+	sqlite3_stmt *statement;
+	if (sqlite3_prepare_v2(reader->db, "SELECT MIN(rowid), MAX(rowid), COUNT(*) FROM ZitatespuckerZitat", -1, &statement, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(reader->db));
+		return false;
+	}
+
+	bool ret = (sqlite3_step(statement) == SQLITE_ROW);
+	if (ret) {
+		*amount = (size_t) sqlite3_column_int64(statement, 2);
+		if (*amount != 0) {
+			*first = (int64_t) sqlite3_column_int64(statement, 0);
+			*last = (int64_t) sqlite3_column_int64(statement, 1);
+		}
+	} else {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_step() failed: %s", sqlite3_errmsg(reader->db));
+	}
+	(void) sqlite3_finalize(statement);
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLReaderGetZitatByRowid(ZitatespuckerSQLReader *reader, int64_t rowid, ZitatespuckerFields fields, bool *missing)
+{
+	if (missing != NULL)
+		*missing = false;
+	if (reader == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL reader!");
+		return NULL;
+	}
+
+	// prepared once, then only reset and bound anew for every lookup
+	if (reader->byRowid == NULL || reader->byRowidFields != fields) {
+		(void) sqlite3_finalize(reader->byRowid);
+		reader->byRowid = NULL;
+
+		char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+		char sSQL[128 + ZITATESPUCKER_SQL_COLUMNS_LEN];
+		ZitatespuckerSQLColumns(fields, sColumns);
+		(void) snprintf(sSQL, sizeof(sSQL), "SELECT %s FROM ZitatespuckerZitat WHERE rowid = ?1", sColumns);
+		if (sqlite3_prepare_v2(reader->db, sSQL, -1, &reader->byRowid, NULL) != SQLITE_OK) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(reader->db));
+			return NULL;
+		}
+		reader->byRowidFields = fields;
+	}
+
+	if (sqlite3_bind_int64(reader->byRowid, 1, (sqlite3_int64) rowid) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_int64() failed: %s", sqlite3_errmsg(reader->db));
+		return NULL;
+	}
+
+	ZitatespuckerZitat *ret = NULL;
+	int rc = sqlite3_step(reader->byRowid);
+	if (rc == SQLITE_ROW) {
+		ret = ZitatespuckerSQLGetPopulatedStruct(reader->byRowid, fields);
+	} else if (rc == SQLITE_DONE) {
+		if (missing != NULL)
+			*missing = true;
+	} else {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_step() failed: %s", sqlite3_errmsg(reader->db));
+	}
+	// ends the read transaction, so writers are not held up between lookups
+	(void) sqlite3_reset(reader->byRowid);
+
+	return ret;
+}
+
+
+ZitatespuckerSQLFederation *ZitatespuckerSQLFederationOpen(const char *const *filenames, size_t amount)
+{
+	if (filenames == NULL || amount == 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filenames or no file at all!");
+		return NULL;
+	}
+
+	ZitatespuckerSQLFederation *federation;
+	if ((federation = (ZitatespuckerSQLFederation *) malloc(sizeof(ZitatespuckerSQLFederation))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	federation->len = 0;
+
+	// attached databases are opened with the flags of the main one, so all of them are read-only
+	if ((federation->db = ZitatespuckerSQLOpen(":memory:", SQLITE_OPEN_READONLY, __func__)) == NULL) {
+		free((void *) federation);
+		return NULL;
+	}
+
+	int limit = sqlite3_limit(federation->db, SQLITE_LIMIT_ATTACHED, -1);
+	if (amount > (size_t) limit) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_LIMIT, __func__, "%zu files given, but SQLite attaches at most %d to a connection.", amount, limit);
+		ZitatespuckerSQLFederationClose(federation);
+		return NULL;
+	}
+
+	sqlite3_stmt *attach;
+	if (sqlite3_prepare_v2(federation->db, "ATTACH DATABASE ?1 AS ?2", -1, &attach, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(federation->db));
+		ZitatespuckerSQLFederationClose(federation);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < amount; i++) {
+		if (filenames[i] == NULL) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL filename at index %zu!", i);
+			break;
+		}
+
+		char schema[32];
+		(void) snprintf(schema, sizeof(schema), "zs%zu", i);
+		if (sqlite3_bind_text(attach, 1, filenames[i], -1, SQLITE_STATIC) != SQLITE_OK || sqlite3_bind_text(attach, 2, schema, -1, SQLITE_TRANSIENT) != SQLITE_OK) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_text() failed: %s", sqlite3_errmsg(federation->db));
+			break;
+		}
+		if (sqlite3_step(attach) != SQLITE_DONE) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_IO, __func__, "Attaching \"%s\" failed: %s", filenames[i], sqlite3_errmsg(federation->db));
+			break;
+		}
+		(void) sqlite3_reset(attach);
+		federation->len++;
+	}
+
+	if (sqlite3_finalize(attach) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(federation->db));
+	}
+	if (federation->len != amount) {
+		ZitatespuckerSQLFederationClose(federation);
+		return NULL;
+	}
+
+	// a file without the table would otherwise only show up at the first query; preparing is enough to find it
+	sqlite3_stmt *check = ZitatespuckerSQLFederationPrepare(federation, "NULL", "", __func__);
+	if (check == NULL) {
+		ZitatespuckerSQLFederationClose(federation);
+		return NULL;
+	}
+	(void) sqlite3_finalize(check);
+
+	return federation;
+}
+
+void ZitatespuckerSQLFederationClose(ZitatespuckerSQLFederation *federation)
+{
+	if (federation == NULL)
+		return;
+
+	(void) sqlite3_close(federation->db);
+	free((void *) federation);
+
+	return;
+}
+
+size_t ZitatespuckerSQLFederationGetAmount(ZitatespuckerSQLFederation *federation)
+{
+	if (federation == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL federation!");
+		return 0;
+	}
+
+	sqlite3_stmt *statement = ZitatespuckerSQLFederationPrepare(federation, "COUNT(*)", "", __func__);
+	if (statement == NULL)
+		return 0;
+
+	// one row per file
+	size_t ret = 0;
+	while (sqlite3_step(statement) == SQLITE_ROW)
+		ret += (size_t) sqlite3_column_int64(statement, 0);
+
+	if (sqlite3_finalize(statement) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(federation->db));
+		return 0;
+	}
+
+	return ret;
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLFederationGetZitatSingle(ZitatespuckerSQLFederation *federation, const size_t idx, ZitatespuckerFields fields)
+{
+	if (federation == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL federation!");
+		return NULL;
+	}
+
+	// find the file the row is in from the row counts of all of them, which SQLite takes from the b-trees without reading the rows
+	sqlite3_stmt *statement = ZitatespuckerSQLFederationPrepare(federation, "COUNT(*)", "", __func__);
+	if (statement == NULL)
+		return NULL;
+
+	size_t file = 0;
+	size_t offset = idx;
+	while (sqlite3_step(statement) == SQLITE_ROW) {
+		size_t rows = (size_t) sqlite3_column_int64(statement, 0);
+		if (offset < rows)
+			break;
+		offset -= rows;
+		file++;
+	}
+
+	if (sqlite3_finalize(statement) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(federation->db));
+		return NULL;
+	}
+	if (file >= federation->len) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "No row at index %zu, wrong index?", idx);
+		return NULL;
+	}
+
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	char sSQL[128 + ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(fields, sColumns);
+	(void) snprintf(sSQL, sizeof(sSQL), "SELECT %s FROM zs%zu.ZitatespuckerZitat ORDER BY rowid LIMIT 1 OFFSET ?1", sColumns, file);
+
+	if (sqlite3_prepare_v2(federation->db, sSQL, -1, &statement, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(federation->db));
+		return NULL;
+	}
+
+	// insert the offset into the query
+	if (sqlite3_bind_int64(statement, 1, (sqlite3_int64) offset) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_int64() failed: %s", sqlite3_errmsg(federation->db));
+		(void) sqlite3_finalize(statement);
+		return NULL;
+	}
+
+	return ZitatespuckerSQLFederationCollect(federation, statement, fields, __func__);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLFederationGetZitatAll(ZitatespuckerSQLFederation *federation, ZitatespuckerFields fields)
+{
+	if (federation == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL federation!");
+		return NULL;
+	}
+
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(fields, sColumns);
+	sqlite3_stmt *statement = ZitatespuckerSQLFederationPrepare(federation, sColumns, "", __func__);
+	if (statement == NULL)
+		return NULL;
+
+	return ZitatespuckerSQLFederationCollect(federation, statement, fields, __func__);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLFederationGetZitatAllByAuthor(ZitatespuckerSQLFederation *federation, const char *authorname, ZitatespuckerFields fields)
+{
+	if (federation == NULL || authorname == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL federation or authorname!");
+		return NULL;
+	}
+
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(fields, sColumns);
+	sqlite3_stmt *statement = ZitatespuckerSQLFederationPrepare(federation, sColumns, " WHERE author=?1", __func__);
+	if (statement == NULL)
+		return NULL;
+
+	// insert the author into the query, once for all files
+	if (sqlite3_bind_text(statement, 1, authorname, -1, SQLITE_STATIC) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_text() failed: %s", sqlite3_errmsg(federation->db));
+		(void) sqlite3_finalize(statement);
+		return NULL;
+	}
+
+	return ZitatespuckerSQLFederationCollect(federation, statement, fields, __func__);
+}
+
+ZitatespuckerZitat *ZitatespuckerSQLFederationGetZitatAllByDate(ZitatespuckerSQLFederation *federation, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields)
+{
+	if (federation == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL federation!");
+		return NULL;
+	} else if (year == 0 && annodomini == false) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "annodomini cannot be false when year is 0.");
+		return NULL;
+	} else if (day != 0 && month == 0) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "month cannot be 0 when day is not 0.");
+		return NULL;
+	}
+
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(fields, sColumns);
+	// same conditions as ZitatespuckerSQLQueryByDate()
+	const char *where;
+	if (day != 0)
+		where = " WHERE annodomini = ?1 AND year = ?2 AND month = ?3 AND day = ?4";
+	else if (month != 0)
+		where = " WHERE annodomini = ?1 AND year = ?2 AND month = ?3";
+	else
+		where = " WHERE annodomini = ?1 AND year = ?2";
+
+	sqlite3_stmt *statement = ZitatespuckerSQLFederationPrepare(federation, sColumns, where, __func__);
+	if (statement == NULL)
+		return NULL;
+
+	int rc = sqlite3_bind_text(statement, 1, (annodomini ? "true" : "false"), -1, SQLITE_STATIC);
+	if (rc == SQLITE_OK)
+		rc = sqlite3_bind_int(statement, 2, year);
+	if (rc == SQLITE_OK && month != 0)
+		rc = sqlite3_bind_int(statement, 3, month);
+	if (rc == SQLITE_OK && day != 0)
+		rc = sqlite3_bind_int(statement, 4, day);
+	if (rc != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "binding the date failed: %s", sqlite3_errmsg(federation->db));
+		(void) sqlite3_finalize(statement);
+		return NULL;
+	}
+
+	return ZitatespuckerSQLFederationCollect(federation, statement, fields, __func__);
+}
+
+size_t ZitatespuckerSQLFederationForEach(ZitatespuckerSQLFederation *federation, const char *authorname, ZitatespuckerFields fields, ZitatespuckerSQLCallback callback, void *userdata)
+{
+	if (federation == NULL || callback == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL federation or callback!");
+		return 0;
+	}
+
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(fields, sColumns);
+	sqlite3_stmt *statement = ZitatespuckerSQLFederationPrepare(federation, sColumns, (authorname != NULL ? " WHERE author=?1" : ""), __func__);
+	if (statement == NULL)
+		return 0;
+
+	if (authorname != NULL && sqlite3_bind_text(statement, 1, authorname, -1, SQLITE_STATIC) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_text() failed: %s", sqlite3_errmsg(federation->db));
+		(void) sqlite3_finalize(statement);
+		return 0;
+	}
+
+	size_t ret = 0;
+	int rc;
+	while ((rc = sqlite3_step(statement)) == SQLITE_ROW) {
+		ZitatespuckerZitat *Zitat = ZitatespuckerSQLGetPopulatedStruct(statement, fields);
+		if (Zitat == NULL)
+			continue;
+		ret++;
+		bool goOn = callback(Zitat, userdata);
+		ZitatespuckerZitatFree(Zitat);
+		if (!goOn) {
+			rc = SQLITE_DONE;
+			break;
+		}
+	}
+
+	if (rc != SQLITE_DONE) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_step() failed: %s", sqlite3_errmsg(federation->db));
+	}
+	(void) sqlite3_finalize(statement);
+
+	return ret;
+}
+
+
+/* Static function definitions */
+
+static ZitatespuckerZitat *ZitatespuckerSQLGetPopulatedStruct(sqlite3_stmt *ZitatStmt, ZitatespuckerFields fields)
+{
+	// mucho importante: SQLite type coercion table
+	ZitatespuckerZitat *Zitat;
+	if ((Zitat = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
+	}
+	// init
+	ZitatespuckerZitatInit(Zitat);
+
+	// the columns come in the order ZitatespuckerSQLColumns() lists them
+	int iCol = 0;
+
+	// author
+	if (fields & ZITATESPUCKER_FIELD_AUTHOR) {
+		Zitat->author = ZitatespuckerSQLGetStringAllocated(ZitatStmt, iCol++, &Zitat->authorLen);
+		Zitat->authorHash = ZitatespuckerAuthorHash(Zitat->author, Zitat->authorLen);
+	}
+
+	// zitat
+	if (fields & ZITATESPUCKER_FIELD_ZITAT)
+		Zitat->zitat = ZitatespuckerSQLGetStringAllocated(ZitatStmt, iCol++, &Zitat->zitatLen);
+
+	// comment
+	if (fields & ZITATESPUCKER_FIELD_COMMENT)
+		Zitat->comment = ZitatespuckerSQLGetStringAllocated(ZitatStmt, iCol++, &Zitat->commentLen);
+
+	if (!(fields & ZITATESPUCKER_FIELD_DATE))
+		return Zitat;
+
+	// day
+	int32_t tmpInt = sqlite3_column_int(ZitatStmt, iCol++);
+	if (tmpInt < 0)
+		tmpInt = 0;
+	else if (tmpInt > UINT8_MAX)
+		tmpInt = UINT8_MAX;
+	Zitat->day = (uint8_t) tmpInt;
 
+	// month
+	tmpInt = sqlite3_column_int(ZitatStmt, iCol++);
+	if (tmpInt < 0)
+		tmpInt = 0;
+	else if (tmpInt > UINT8_MAX)
+		tmpInt = UINT8_MAX;
+	Zitat->month = (uint8_t) tmpInt;
 
-/* SQLite headers */
-#include <sqlite3.h>
+	// year
+	tmpInt = sqlite3_column_int(ZitatStmt, iCol++);
+	if (tmpInt < 0)
+		tmpInt = 0;
+	else if (tmpInt > UINT16_MAX)
+		tmpInt = UINT16_MAX;
+	Zitat->year = (uint16_t) tmpInt;
 
+	// annodomini
+	size_t bytelen = sqlite3_column_bytes(ZitatStmt, iCol);
+	if (bytelen != 4) // strlen("true"); sqlite3_column_bytes() does not count the terminator
+		Zitat->annodomini = false;
+	else {
+		const char *tmpS = (char *) sqlite3_column_text(ZitatStmt, iCol);
+		if (tmpS == NULL) // only on OOM
+			Zitat->annodomini = false;
+		else if (strncmp(tmpS, "true", 5) == 0)
+			Zitat->annodomini = true;
+		else
+			Zitat->annodomini = false;
+	}
 
-/* Internal headers */
-#include "../Zitatespucker/Zitatespucker_sqlite.h"
+	return Zitat;
+}
 
+static void ZitatespuckerSQLColumns(ZitatespuckerFields fields, char *buf)
+{
+	buf[0] = '\0';
+	if (fields & ZITATESPUCKER_FIELD_AUTHOR)
+		(void) strcat(buf, ", author");
+	if (fields & ZITATESPUCKER_FIELD_ZITAT)
+		(void) strcat(buf, ", zitat");
+	if (fields & ZITATESPUCKER_FIELD_COMMENT)
+		(void) strcat(buf, ", comment");
+	if (fields & ZITATESPUCKER_FIELD_DATE)
+		(void) strcat(buf, ", day, month, year, annodomini");
 
-/* Static function declarations */
+	// no columns at all still has to select something, to get one row per element
+	if (buf[0] == '\0')
+		(void) strcpy(buf, "NULL");
+	else
+		(void) memmove(buf, buf + 2, strlen(buf + 2) + 1);
 
-/*
-	Populate a ZitatespuckerZitat struct the prepared SQL statement ZitatStmt and return it.
-	NULL on error.
+	return;
+}
+
+static inline char *ZitatespuckerSQLGetStringAllocated(sqlite3_stmt *ZitatStmt, int iCol, size_t *len)
+{
+	*len = 0;
+	size_t bytelen = sqlite3_column_bytes(ZitatStmt, iCol);
+	if (bytelen == 0)
+		return NULL;
 	
-	This function allocates, and the given object must be freed with ZitatespuckerZitatFree().
-*/
-static ZitatespuckerZitat *ZitatespuckerSQLGetPopulatedStruct(sqlite3_stmt *ZitatStmt);
+	const char *tmpS = (char *) sqlite3_column_text(ZitatStmt, iCol);
+	if (tmpS == NULL) // happens only on OOM, theoretically
+		return NULL;
+	
+	// sqlite3_column_bytes() does not count the terminator; a '\0' within the text (like when getting BLOB as TEXT) ends the string early
+	const char *nul = (const char *) memchr(tmpS, '\0', bytelen);
+	size_t textlen = (nul != NULL ? (size_t) (nul - tmpS) : bytelen);
+	char *ret = (char *) malloc((textlen + 1) * sizeof(char));
+	if (ret != NULL) {
+		(void) memcpy(ret, tmpS, textlen);
+		ret[textlen] = '\0';
+		*len = textlen;
+	}
+	return ret;
+}
 
-/*
-	Get the string content of column iCol from prepared statement ZitatStmt.
+static inline int ZitatespuckerSQLTextLen(const char *str, size_t len)
+{
+	return ((str != NULL && len != 0 && len <= INT_MAX) ? (int) len : -1);
+}
 
-	NULL may be a valid return.
-	This function duplicates the string and checks for proper NULL-termination.
-*/
-static inline char *ZitatespuckerSQLGetStringAllocated(sqlite3_stmt *ZitatStmt, int iCol);
+static bool ZitatespuckerSQLExec(sqlite3 *db, const char *sql, const char *caller)
+{
+	char *errmsg = NULL;
+	if (sqlite3_exec(db, sql, NULL, NULL, &errmsg) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, caller, "sqlite3_exec() failed: %s", (errmsg != NULL ? errmsg : sqlite3_errmsg(db)));
+		sqlite3_free(errmsg);
+		return false;
+	}
 
+	return true;
+}
 
-/* Externally callable */
+static sqlite3_int64 ZitatespuckerSQLNow(void)
+{
+	sqlite3_vfs *vfs = sqlite3_vfs_find(NULL);
+	sqlite3_int64 now = 0;
+	if (vfs != NULL && vfs->iVersion >= 2 && vfs->xCurrentTimeInt64 != NULL)
+		(void) vfs->xCurrentTimeInt64(vfs, &now);
 
-size_t ZitatespuckerSQLGetAmountFromFile(const char *filename)
+	return now;
+}
+
+static bool ZitatespuckerSQLImportCommit(ZitatespuckerSQLImporter *importer, const char *sql, const char *caller)
 {
-	// perhaps one could replace this using a SQL COUNT statement
-	// but as of now, this is on par with the JSON backend
+	bool ret = ZitatespuckerSQLExec(importer->db, sql, caller);
+	if (ret) {
+		importer->rows += importer->batch;
+	} else {
+		// SQLite may have rolled back on its own already, in which case this one fails; that is fine
+		(void) sqlite3_exec(importer->db, "ROLLBACK", NULL, NULL, NULL);
+		importer->failed += importer->batch;
+	}
+	importer->batch = 0;
 
-	if (filename == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: recieved NULL filename!\n", __FILE__, __LINE__, __func__);
-		#endif
-		return 0;
+	return ret;
+}
+
+static ZitatespuckerSQLReader *ZitatespuckerSQLReaderOpen(ZitatespuckerSQLPool *pool)
+{
+	ZitatespuckerSQLReader *reader;
+	if ((reader = (ZitatespuckerSQLReader *) malloc(sizeof(ZitatespuckerSQLReader))) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, __func__, "malloc() returned NULL.");
+		return NULL;
 	}
-	
-	sqlite3 *db;
-	size_t ret = 0;
+	reader->pool = pool;
+	reader->byRowid = NULL;
+	reader->byRowidFields = 0;
+	reader->nextReader = NULL;
 
-	if (sqlite3_open_v2(filename, &db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_open_v2() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
-		return ret;
+	if ((reader->db = ZitatespuckerSQLOpen(pool->path, pool->flags, __func__)) == NULL) {
+		free((void *) reader);
+		return NULL;
+	}
+
+	// reading through the mapping saves copying every page into the page cache
+	if (pool->immutable) {
+		char sSQL[64];
+		(void) snprintf(sSQL, sizeof(sSQL), "PRAGMA mmap_size = %lld", (long long) ZITATESPUCKER_SQL_POOL_MMAP_SIZE);
+		if (!ZitatespuckerSQLExec(reader->db, sSQL, __func__)) {
+			ZitatespuckerSQLReaderClose(reader);
+			return NULL;
+		}
+	}
+
+	return reader;
+}
+
+static void ZitatespuckerSQLReaderClose(ZitatespuckerSQLReader *reader)
+{
+	(void) sqlite3_finalize(reader->byRowid);
+	(void) sqlite3_close(reader->db);
+	free((void *) reader);
+
+	return;
+}
+
+static char *ZitatespuckerSQLImmutableURI(const char *filename)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	size_t len = strlen(filename);
+	char *ret;
+	// "file:" + at most three bytes per byte + "?immutable=1" + '\0'
+	if ((ret = (char *) malloc(5 + 3 * len + 12 + 1)) == NULL)
+		return NULL;
+
+	char *cur = ret;
+	(void) memcpy(cur, "file:", 5);
+	cur += 5;
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = (unsigned char) filename[i];
+		if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '/' || c == '.' || c == '-' || c == '_' || c == '~') {
+			*cur++ = (char) c;
+		} else {
+			*cur++ = '%';
+			*cur++ = hex[c >> 4];
+			*cur++ = hex[c & 0xF];
+		}
+	}
+	(void) strcpy(cur, "?immutable=1");
+
+	return ret;
+}
+
+static void ZitatespuckerSQLPoolFree(ZitatespuckerSQLPool *pool)
+{
+	while (pool->idle != NULL) {
+		ZitatespuckerSQLReader *next = pool->idle->nextReader;
+		ZitatespuckerSQLReaderClose(pool->idle);
+		pool->idle = next;
+	}
+	sqlite3_mutex_free(pool->lock);
+	free((void *) pool->path);
+	free((void *) pool);
+
+	return;
+}
+
+static sqlite3 *ZitatespuckerSQLOpen(const char *filename, int flags, const char *caller)
+{
+	sqlite3 *db;
+	if (sqlite3_open_v2(filename, &db, flags, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, caller, "sqlite3_open_v2() failed: %s", sqlite3_errmsg(db));
+		(void) sqlite3_close(db);
+		return NULL;
 	}
 
+	return db;
+}
+
+static size_t ZitatespuckerSQLQueryAmount(sqlite3 *db)
+{
+	size_t ret = 0;
+
 	sqlite3_stmt *statement;
 	if (sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM ZitatespuckerZitat", -1, &statement, NULL) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_prepare_v2() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
-		(void) sqlite3_close(db);
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(db));
 		return ret;
 	}
 
 	// finally, we can start counting
 	if (sqlite3_step(statement) != SQLITE_ROW) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_step() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_step() failed: %s", sqlite3_errmsg(db));
 	} else {
 		ret = sqlite3_column_int(statement, 0);
 	}
 	
 	if (sqlite3_finalize(statement) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_finalize() reported an error:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
 	}
-	(void) sqlite3_close(db);
 
 	return ret;
 }
 
-ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFile(const char *filename)
+static ZitatespuckerZitat *ZitatespuckerSQLQuerySingle(sqlite3 *db, const size_t idx, ZitatespuckerFields fields)
 {
-	if (filename == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: recieved NULL filename!\n", __FILE__, __LINE__, __func__);
-		#endif
+	if (idx > INT64_MAX) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "idx is out of range.");
+		return NULL;
+	}
+
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	char sSQL[128 + ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(fields, sColumns);
+	(void) snprintf(sSQL, sizeof(sSQL), "SELECT %s FROM ZitatespuckerZitat ORDER BY rowid LIMIT 1 OFFSET ?1", sColumns);
+
+	sqlite3_stmt *statement;
+	if (sqlite3_prepare_v2(db, sSQL, -1, &statement, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(db));
 		return NULL;
 	}
-	
-	sqlite3 *db;
 
-	if (sqlite3_open_v2(filename, &db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_open_v2() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+	// insert the offset into the query
+	if (sqlite3_bind_int64(statement, 1, (sqlite3_int64) idx) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_int64() failed: %s", sqlite3_errmsg(db));
+		if (sqlite3_finalize(statement) != SQLITE_OK) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
+		}
 		return NULL;
 	}
 
+	ZitatespuckerZitat *ret = NULL;
+	if (sqlite3_step(statement) == SQLITE_ROW)
+		ret = ZitatespuckerSQLGetPopulatedStruct(statement, fields);
+	else {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_RANGE, __func__, "No row at index %zu, wrong index?", idx);
+	}
+
+	if (sqlite3_finalize(statement) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
+	}
+
+	return ret;
+}
+
+static ZitatespuckerZitat *ZitatespuckerSQLQueryAll(sqlite3 *db, ZitatespuckerFields fields)
+{
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	char sSQL[128 + ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(fields, sColumns);
+	(void) snprintf(sSQL, sizeof(sSQL), "SELECT %s FROM ZitatespuckerZitat", sColumns);
+
 	sqlite3_stmt *statement;
-	if (sqlite3_prepare_v2(db, "SELECT * FROM ZitatespuckerZitat", -1, &statement, NULL) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_prepare_v2() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
-		(void) sqlite3_close(db);
+	if (sqlite3_prepare_v2(db, sSQL, -1, &statement, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(db));
 		return NULL;
 	}
 
@@ -139,70 +1555,48 @@ ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFile(const char *filename)
 	
 	while (sqlite3_step(statement) == SQLITE_ROW) {
 		if (ret != NULL) {
-			cur->nextZitat = ZitatespuckerSQLGetPopulatedStruct(statement);
+			cur->nextZitat = ZitatespuckerSQLGetPopulatedStruct(statement, fields);
 			if (cur->nextZitat != NULL) {
 				cur->nextZitat->prevZitat = cur;
 				cur = cur->nextZitat;
 			}
 		} else {
-			ret = ZitatespuckerSQLGetPopulatedStruct(statement);
+			ret = ZitatespuckerSQLGetPopulatedStruct(statement, fields);
 			cur = ret;
 		}
 	}
 
 	if (sqlite3_finalize(statement) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_finalize() reported an error:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
 	}
-	(void) sqlite3_close(db);
 
 	return ret;
 }
 
-ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByAuthor(const char *filename, const char *authorname)
+static ZitatespuckerZitat *ZitatespuckerSQLQueryByAuthor(sqlite3 *db, const char *authorname, ZitatespuckerFields fields)
 {
-	if (filename == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: recieved NULL filename!\n", __FILE__, __LINE__, __func__);
-		#endif
-		return NULL;
-	} else if (authorname == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: recieved NULL authorname!\n", __FILE__, __LINE__, __func__);
-		#endif
+	if (authorname == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "recieved NULL authorname!");
 		return NULL;
 	}
 
-	sqlite3 *db;
-
-	if (sqlite3_open_v2(filename, &db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_open_v2() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
-		return NULL;
-	}
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	char sSQL[128 + ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(fields, sColumns);
+	(void) snprintf(sSQL, sizeof(sSQL), "SELECT %s FROM ZitatespuckerZitat WHERE author=?1", sColumns);
 
 	sqlite3_stmt *statement;
-	if (sqlite3_prepare_v2(db, "SELECT * FROM ZitatespuckerZitat WHERE author=?1", -1, &statement, NULL) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_prepare_v2() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
-		(void) sqlite3_close(db);
+	if (sqlite3_prepare_v2(db, sSQL, -1, &statement, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(db));
 		return NULL;
 	}
 
 	// insert the author into the query
 	if (sqlite3_bind_text(statement, 1, authorname, -1, SQLITE_STATIC) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_bind_text() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_text() failed: %s", sqlite3_errmsg(db));
 		if (sqlite3_finalize(statement) != SQLITE_OK) {
-			#ifndef ZITATESPUCKER_NOPRINT
-			(void) fprintf(stderr, "%s:%d:%s: sqlite3_finalize() reported an error:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-			#endif
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
 		}
-		(void) sqlite3_close(db);
 		return NULL;
 	}
 
@@ -211,70 +1605,48 @@ ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByAuthor(const char *file
 	
 	while (sqlite3_step(statement) == SQLITE_ROW) {
 		if (ret != NULL) {
-			cur->nextZitat = ZitatespuckerSQLGetPopulatedStruct(statement);
+			cur->nextZitat = ZitatespuckerSQLGetPopulatedStruct(statement, fields);
 			if (cur->nextZitat != NULL) {
 				cur->nextZitat->prevZitat = cur;
 				cur = cur->nextZitat;
 			}
 		} else {
-			ret = ZitatespuckerSQLGetPopulatedStruct(statement);
+			ret = ZitatespuckerSQLGetPopulatedStruct(statement, fields);
 			cur = ret;
 		}
 	}
 
 	if (sqlite3_finalize(statement) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_finalize() reported an error:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
 	}
-	(void) sqlite3_close(db);
 
 	return ret;
 }
 
-ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByDate(const char *filename, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+static ZitatespuckerZitat *ZitatespuckerSQLQueryByDate(sqlite3 *db, bool annodomini, uint16_t year, uint8_t month, uint8_t day, ZitatespuckerFields fields)
 {
-	if (filename == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: recieved NULL filename!\n", __FILE__, __LINE__, __func__);
-		#endif
-		return NULL;
-	} else if (year == 0 && annodomini == false) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: annodomini cannot be false when year is 0.\n", __FILE__, __LINE__, __func__);
-		#endif
+	if (year == 0 && annodomini == false) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "annodomini cannot be false when year is 0.");
 		return NULL;
 	} else if (day != 0 && month == 0) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: month cannot be 0 when day is not 0.\n", __FILE__, __LINE__, __func__);
-		#endif
-		return NULL;
-	}
-	
-	sqlite3 *db;
-
-	if (sqlite3_open_v2(filename, &db, SQLITE_OPEN_READONLY, NULL) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_open_v2() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_ARGUMENT, __func__, "month cannot be 0 when day is not 0.");
 		return NULL;
 	}
 
-	char *sSQL;
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	char sSQL[128 + ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(fields, sColumns);
 	// determine what SQL query to use
 	if (day != 0)
-		sSQL = "SELECT * FROM ZitatespuckerZitat WHERE annodomini = ?1 AND year = ?2 AND month = ?3 AND day = ?4";
+		(void) snprintf(sSQL, sizeof(sSQL), "SELECT %s FROM ZitatespuckerZitat WHERE annodomini = ?1 AND year = ?2 AND month = ?3 AND day = ?4", sColumns);
 	else if (month != 0)
-		sSQL = "SELECT * FROM ZitatespuckerZitat WHERE annodomini = ?1 AND year = ?2 AND month = ?3";
+		(void) snprintf(sSQL, sizeof(sSQL), "SELECT %s FROM ZitatespuckerZitat WHERE annodomini = ?1 AND year = ?2 AND month = ?3", sColumns);
 	else
-		sSQL = "SELECT * FROM ZitatespuckerZitat WHERE annodomini = ?1 AND year = ?2";
+		(void) snprintf(sSQL, sizeof(sSQL), "SELECT %s FROM ZitatespuckerZitat WHERE annodomini = ?1 AND year = ?2", sColumns);
 	
 	sqlite3_stmt *statement;
 	if (sqlite3_prepare_v2(db, sSQL, -1, &statement, NULL) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_prepare_v2() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
-		(void) sqlite3_close(db);
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(db));
 		return NULL;
 	}
 
@@ -282,44 +1654,29 @@ ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByDate(const char *filena
 	// annodomini
 	// I am not actually sure if SQLITE_TRANSIENT is correct in this place
 	if (sqlite3_bind_text(statement, 1, (annodomini ? "true" : "false"), -1, SQLITE_TRANSIENT) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_bind_int() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_int() failed: %s", sqlite3_errmsg(db));
 		if (sqlite3_finalize(statement) != SQLITE_OK) {
-			#ifndef ZITATESPUCKER_NOPRINT
-			(void) fprintf(stderr, "%s:%d:%s: sqlite3_finalize() reported an error:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-			#endif
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
 		}
-		(void) sqlite3_close(db);
 		return NULL;
 	}
 
 	// year
 	if (sqlite3_bind_int(statement, 2, year) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_bind_int() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_int() failed: %s", sqlite3_errmsg(db));
 		if (sqlite3_finalize(statement) != SQLITE_OK) {
-			#ifndef ZITATESPUCKER_NOPRINT
-			(void) fprintf(stderr, "%s:%d:%s: sqlite3_finalize() reported an error:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-			#endif
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
 		}
-		(void) sqlite3_close(db);
 		return NULL;
 	}
 
 	// month
 	if (month != 0) {
 		if (sqlite3_bind_int(statement, 3, month) != SQLITE_OK) {
-			#ifndef ZITATESPUCKER_NOPRINT
-			(void) fprintf(stderr, "%s:%d:%s: sqlite3_bind_int() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-			#endif
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_int() failed: %s", sqlite3_errmsg(db));
 			if (sqlite3_finalize(statement) != SQLITE_OK) {
-				#ifndef ZITATESPUCKER_NOPRINT
-				(void) fprintf(stderr, "%s:%d:%s: sqlite3_finalize() reported an error:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-				#endif
+				ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
 			}
-			(void) sqlite3_close(db);
 			return NULL;
 		}
 	}
@@ -327,15 +1684,10 @@ ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByDate(const char *filena
 	// day
 	if (day != 0) {
 		if (sqlite3_bind_int(statement, 4, day) != SQLITE_OK) {
-			#ifndef ZITATESPUCKER_NOPRINT
-			(void) fprintf(stderr, "%s:%d:%s: sqlite3_bind_int() failed:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-			#endif
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_int() failed: %s", sqlite3_errmsg(db));
 			if (sqlite3_finalize(statement) != SQLITE_OK) {
-				#ifndef ZITATESPUCKER_NOPRINT
-				(void) fprintf(stderr, "%s:%d:%s: sqlite3_finalize() reported an error:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-				#endif
+				ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
 			}
-			(void) sqlite3_close(db);
 			return NULL;
 		}
 	}
@@ -345,116 +1697,147 @@ ZitatespuckerZitat *ZitatespuckerSQLGetZitatAllFromFileByDate(const char *filena
 	
 	while (sqlite3_step(statement) == SQLITE_ROW) {
 		if (ret != NULL) {
-			cur->nextZitat = ZitatespuckerSQLGetPopulatedStruct(statement);
+			cur->nextZitat = ZitatespuckerSQLGetPopulatedStruct(statement, fields);
 			if (cur->nextZitat != NULL) {
 				cur->nextZitat->prevZitat = cur;
 				cur = cur->nextZitat;
 			}
 		} else {
-			ret = ZitatespuckerSQLGetPopulatedStruct(statement);
+			ret = ZitatespuckerSQLGetPopulatedStruct(statement, fields);
 			cur = ret;
 		}
 	}
 
 	if (sqlite3_finalize(statement) != SQLITE_OK) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: sqlite3_finalize() reported an error:\n%s\n", __FILE__, __LINE__, __func__, sqlite3_errmsg(db));
-		#endif
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(db));
 	}
-	(void) sqlite3_close(db);
 
 	return ret;
 }
 
+static void ZitatespuckerSQLScanShard(ZitatespuckerSQLShard *shard)
+{
+	sqlite3 *db = shard->db;
+	// nothing but this thread uses the connection, so SQLite can leave out its locking
+	if (db == NULL && (db = ZitatespuckerSQLOpen(shard->filename, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, __func__)) == NULL) {
+		shard->failed = true;
+		return;
+	}
 
-/* Static function definitions */
+	char sColumns[ZITATESPUCKER_SQL_COLUMNS_LEN];
+	char sSQL[128 + ZITATESPUCKER_SQL_COLUMNS_LEN];
+	ZitatespuckerSQLColumns(shard->fields, sColumns);
+	(void) snprintf(sSQL, sizeof(sSQL), "SELECT %s FROM ZitatespuckerZitat WHERE rowid BETWEEN ?1 AND ?2 ORDER BY rowid", sColumns);
 
-static ZitatespuckerZitat *ZitatespuckerSQLGetPopulatedStruct(sqlite3_stmt *ZitatStmt)
-{
-	// mucho importante: SQLite type coercion table
-	ZitatespuckerZitat *Zitat;
-	if ((Zitat = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat))) == NULL) {
-		#ifndef ZITATESPUCKER_NOPRINT
-		(void) fprintf(stderr, "%s:%d:%s: malloc() returned NULL.\n", __FILE__, __LINE__, __func__);
-		#endif
-		return NULL;
+	sqlite3_stmt *statement;
+	if (sqlite3_prepare_v2(db, sSQL, -1, &statement, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(db));
+		shard->failed = true;
+	} else if (sqlite3_bind_int64(statement, 1, shard->from) != SQLITE_OK || sqlite3_bind_int64(statement, 2, shard->to) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_bind_int64() failed: %s", sqlite3_errmsg(db));
+		shard->failed = true;
+	} else {
+		int rc;
+		while ((rc = sqlite3_step(statement)) == SQLITE_ROW) {
+			ZitatespuckerZitat *Zitat;
+			if ((Zitat = ZitatespuckerSQLGetPopulatedStruct(statement, shard->fields)) == NULL) {
+				shard->failed = true;
+				break;
+			}
+			if (shard->last != NULL) {
+				shard->last->nextZitat = Zitat;
+				Zitat->prevZitat = shard->last;
+			} else
+				shard->first = Zitat;
+			shard->last = Zitat;
+		}
+		if (!shard->failed && rc != SQLITE_DONE) {
+			ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, __func__, "sqlite3_step() failed: %s", sqlite3_errmsg(db));
+			shard->failed = true;
+		}
 	}
-	// init
-	ZitatespuckerZitatInit(Zitat);
+	(void) sqlite3_finalize(statement);
 
-	// author
-	Zitat->author = ZitatespuckerSQLGetStringAllocated(ZitatStmt, 0);
+	if (shard->db == NULL)
+		(void) sqlite3_close(db);
 
-	// zitat
-	Zitat->zitat = ZitatespuckerSQLGetStringAllocated(ZitatStmt, 1);
+	return;
+}
 
-	// comment
-	Zitat->comment = ZitatespuckerSQLGetStringAllocated(ZitatStmt, 2);
+static void *ZitatespuckerSQLScanShardThread(void *arg)
+{
+	ZitatespuckerSQLShard *shard = (ZitatespuckerSQLShard *) arg;
 
-	// day
-	int32_t tmpInt = sqlite3_column_int(ZitatStmt, 3);
-	if (tmpInt < 0)
-		tmpInt = 0;
-	else if (tmpInt > UINT8_MAX)
-		tmpInt = UINT8_MAX;
-	Zitat->day = (uint8_t) tmpInt;
+	ZitatespuckerSQLScanShard(shard);
+	if (shard->failed)
+		shard->error = ZitatespuckerDiagGetLastError();
 
-	// month
-	tmpInt = sqlite3_column_int(ZitatStmt, 4);
-	if (tmpInt < 0)
-		tmpInt = 0;
-	else if (tmpInt > UINT8_MAX)
-		tmpInt = UINT8_MAX;
-	Zitat->month = (uint8_t) tmpInt;
+	return NULL;
+}
 
-	// year
-	tmpInt = sqlite3_column_int(ZitatStmt, 5);
-	if (tmpInt < 0)
-		tmpInt = 0;
-	else if (tmpInt > UINT16_MAX)
-		tmpInt = UINT16_MAX;
-	Zitat->year = (uint16_t) tmpInt;
+static sqlite3_stmt *ZitatespuckerSQLFederationPrepare(ZitatespuckerSQLFederation *federation, const char *select, const char *where, const char *caller)
+{
+	static const char unionAll[] = " UNION ALL ";
+	static const char format[] = "SELECT %s FROM zs%zu.ZitatespuckerZitat%s";
 
-	// annodomini
-	size_t bytelen = sqlite3_column_bytes(ZitatStmt, 6);
-	if (bytelen != 5)
-		Zitat->annodomini = false;
-	else {
-		const char *tmpS = (char *) sqlite3_column_text(ZitatStmt, 6);
-		if (tmpS == NULL) // only on OOM
-			Zitat->annodomini = false;
-		else if (strncmp(tmpS, "true", 5) == 0)
-			Zitat->annodomini = true;
-		else
-			Zitat->annodomini = false;
+	// the parts only differ in the number of the schema, so the last one is the longest
+	int partLen = snprintf(NULL, 0, format, select, federation->len - 1, where);
+	if (partLen < 0 || (size_t) partLen + sizeof(unionAll) > (SIZE_MAX - 1) / federation->len) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_LIMIT, caller, "the query is too long.");
+		return NULL;
 	}
 
-	return Zitat;
+	size_t size = federation->len * ((size_t) partLen + sizeof(unionAll)) + 1;
+	char *sSQL;
+	if ((sSQL = (char *) malloc(size)) == NULL) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_MEMORY, caller, "malloc() returned NULL.");
+		return NULL;
+	}
+
+	size_t len = 0;
+	for (size_t i = 0; i < federation->len; i++) {
+		if (i != 0) {
+			(void) memcpy(sSQL + len, unionAll, sizeof(unionAll) - 1);
+			len += sizeof(unionAll) - 1;
+		}
+		len += (size_t) snprintf(sSQL + len, size - len, format, select, i, where);
+	}
+
+	sqlite3_stmt *statement;
+	if (sqlite3_prepare_v2(federation->db, sSQL, (int) (len + 1), &statement, NULL) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, caller, "sqlite3_prepare_v2() failed: %s", sqlite3_errmsg(federation->db));
+		statement = NULL;
+	}
+	free((void *) sSQL);
+
+	return statement;
 }
 
-static inline char *ZitatespuckerSQLGetStringAllocated(sqlite3_stmt *ZitatStmt, int iCol)
+static ZitatespuckerZitat *ZitatespuckerSQLFederationCollect(ZitatespuckerSQLFederation *federation, sqlite3_stmt *statement, ZitatespuckerFields fields, const char *caller)
 {
-	size_t bytelen = sqlite3_column_bytes(ZitatStmt, iCol);
-	if (bytelen == 0)
-		return NULL;
-	
-	const char *tmpS = (char *) sqlite3_column_text(ZitatStmt, iCol);
-	if (tmpS == NULL) // happens only on OOM, theoretically
-		return NULL;
-	
-	if (tmpS[bytelen - 1] == '\0') {
-		// yay
-		char *ret = (char *) malloc(bytelen * sizeof(char));
-		if (ret != NULL)
-			(void) strcpy(ret, tmpS);
-		return ret;
-	} else {
-		// oof, can happen if you try to get BLOB as TEXT
-		char *ret = (char *) malloc((bytelen + 1) * sizeof(char));
+	ZitatespuckerZitat *ret = NULL;
+	ZitatespuckerZitat *cur = NULL;
+	int rc;
+
+	while ((rc = sqlite3_step(statement)) == SQLITE_ROW) {
+		ZitatespuckerZitat *Zitat = ZitatespuckerSQLGetPopulatedStruct(statement, fields);
+		if (Zitat == NULL)
+			continue;
 		if (ret != NULL) {
-			(void) strncpy(ret, tmpS, bytelen);
-			ret[bytelen] = '\0';
+			cur->nextZitat = Zitat;
+			Zitat->prevZitat = cur;
+		} else {
+			ret = Zitat;
 		}
-		return ret;
+		cur = Zitat;
+	}
+
+	if (rc != SQLITE_DONE) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, caller, "sqlite3_step() failed: %s", sqlite3_errmsg(federation->db));
 	}
+	if (sqlite3_finalize(statement) != SQLITE_OK) {
+		ZITATESPUCKER_REPORT_ERROR(ZITATESPUCKER_ERROR_BACKEND, caller, "sqlite3_finalize() reported an error: %s", sqlite3_errmsg(federation->db));
+	}
+
+	return ret;
 }
@@ -0,0 +1,151 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Loading sources in the background (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#define ZITATESPUCKER_ASYNC
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define LARGE_AMOUNT	200000
+#define LARGE_FILE		"async_tests.json"
+
+
+/* Write LARGE_AMOUNT elements to LARGE_FILE */
+static void WriteLargeFile(void)
+{
+	FILE *file = fopen(LARGE_FILE, "w");
+	assert(file != NULL);
+	ZitatespuckerExport *exporter = ZitatespuckerExportToFile(file);
+	assert(exporter != NULL);
+
+	char zitat[64];
+	ZitatespuckerZitat Zitat;
+	ZitatespuckerZitatInit(&Zitat);
+	Zitat.author = "Author";
+	Zitat.zitat = zitat;
+	Zitat.comment = "A comment that makes the file a bit larger than it would be otherwise";
+	Zitat.annodomini = true;
+	for (size_t i = 0; i < LARGE_AMOUNT; i++) {
+		(void) snprintf(zitat, sizeof(zitat), "Quote number %zu", i);
+		Zitat.year = (uint16_t) (i % 2024);
+		assert(ZitatespuckerExportAdd(exporter, &Zitat));
+	}
+
+	assert(ZitatespuckerExportFinish(exporter, NULL, NULL));
+	assert(fclose(file) == 0);
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerAsync *handle;
+	ZitatespuckerZitat *ZitatList;
+	ZitatespuckerSnapshot *snapshot;
+
+	printf("ZitatespuckerAsyncLoad:\n");
+	printf("Checking whether a NULL filename or handle is handled...\n");
+	assert(ZitatespuckerAsyncLoad(NULL, ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_FIELD_ALL) == NULL);
+	assert(ZitatespuckerAsyncPoll(NULL) == ZITATESPUCKER_ASYNC_FAILED);
+	assert(ZitatespuckerAsyncTakeList(NULL) == NULL);
+	ZitatespuckerAsyncCancel(NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether the example file is loaded...\n");
+	handle = ZitatespuckerAsyncLoad("../../examples/example.json", ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_FIELD_ALL);
+	assert(handle != NULL);
+	assert(ZitatespuckerAsyncWait(handle, -1) == ZITATESPUCKER_ASYNC_DONE);
+	assert(ZitatespuckerAsyncPoll(handle) == ZITATESPUCKER_ASYNC_DONE);
+	ZitatList = ZitatespuckerAsyncTakeList(handle);
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == 2 && strcmp(ZitatList->author, "TestAuthor") == 0);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether fields are passed on...\n");
+	handle = ZitatespuckerAsyncLoad("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_FIELD_DATE);
+	ZitatList = ZitatespuckerAsyncTakeList(handle);
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == ZitatespuckerSourceGetAmountFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN));
+	for (ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat)
+		assert(cur->author == NULL && cur->zitat == NULL && cur->comment == NULL);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether a missing file fails...\n");
+	handle = ZitatespuckerAsyncLoad("../doesnotexist.json", ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_FIELD_ALL);
+	assert(handle != NULL);
+	assert(ZitatespuckerAsyncWait(handle, 10000) == ZITATESPUCKER_ASYNC_FAILED);
+	assert(ZitatespuckerAsyncTakeList(handle) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether the caller does not block on a large file...\n");
+	WriteLargeFile();
+	handle = ZitatespuckerAsyncLoad(LARGE_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_FIELD_ALL);
+	assert(handle != NULL);
+	double start = Seconds();
+	ZitatespuckerAsyncState state = ZitatespuckerAsyncWait(handle, 1);
+	double waited = Seconds() - start;
+	size_t waits = 0;
+	while (ZitatespuckerAsyncWait(handle, 10) == ZITATESPUCKER_ASYNC_RUNNING)
+		waits++;
+	double loaded = Seconds() - start;
+	printf("waited %.1f ms (%s), loaded after %.0f ms and %zu more waits\n", waited * 1000, (state == ZITATESPUCKER_ASYNC_RUNNING ? "running" : "done"), loaded * 1000, waits);
+	assert(state != ZITATESPUCKER_ASYNC_FAILED && waited < 1.0);
+	ZitatList = ZitatespuckerAsyncTakeList(handle);
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == LARGE_AMOUNT);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerAsyncLoadSnapshot:\n");
+	printf("Checking whether a snapshot is created...\n");
+	handle = ZitatespuckerAsyncLoadSnapshot("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN);
+	snapshot = ZitatespuckerAsyncTakeSnapshot(handle);
+	assert(snapshot != NULL && ZitatespuckerSnapshotLen(snapshot) == ZitatespuckerSourceGetAmountFromFile("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN));
+	ZitatespuckerSnapshotRelease(snapshot);
+	printf("OKAY!\n\n");
+	printf("Checking whether taking the wrong kind of result fails...\n");
+	assert(ZitatespuckerAsyncTakeList(ZitatespuckerAsyncLoadSnapshot("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN)) == NULL);
+	assert(ZitatespuckerAsyncTakeSnapshot(ZitatespuckerAsyncLoad("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_FIELD_ALL)) == NULL);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerAsyncCancel:\n");
+	printf("Checking whether loads can be cancelled at any point...\n");
+	for (int i = 0; i < 8; i++) {
+		handle = (i % 2 == 0 ? ZitatespuckerAsyncLoad(LARGE_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_FIELD_ALL) : ZitatespuckerAsyncLoadSnapshot(LARGE_FILE, ZITATESPUCKER_SOURCE_UNKNOWN));
+		assert(handle != NULL);
+		if (i >= 4)
+			(void) ZitatespuckerAsyncWait(handle, 20 * (i - 3));
+		ZitatespuckerAsyncCancel(handle);
+	}
+	// the cancelled loads finish in the background; one more load and waiting for it lets most of them do so
+	handle = ZitatespuckerAsyncLoad(LARGE_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_FIELD_ALL);
+	ZitatList = ZitatespuckerAsyncTakeList(handle);
+	assert(ZitatespuckerZitatListLen(ZitatList) == LARGE_AMOUNT);
+	ZitatespuckerZitatFree(ZitatList);
+	(void) remove(LARGE_FILE);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
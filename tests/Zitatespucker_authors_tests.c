@@ -0,0 +1,225 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Prefix and fuzzy author lookup (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define LARGE_AMOUNT	20000
+#define NAME_LEN		64
+
+
+static const char *const handwritten[] = {
+	"Johann Wolfgang von Goethe", "Friedrich Schiller", "Johann Wolfgang von Goethe", "GOETHE-Institut",
+	"Mark Twain", "Oscar Wilde", NULL
+};
+
+/* Syllables the large list of names is made of */
+static const char *const syllables[] = {
+	"an", "ber", "chri", "da", "el", "fried", "ga", "hein", "in", "jo", "karl", "li", "ma", "nor", "o", "pe",
+	"qui", "ro", "sch", "to", "ul", "ve", "wil", "xa", "yo", "ze"
+};
+
+
+/* Link amount elements of Zitate into a list, by the given authors */
+static ZitatespuckerZitat *MakeList(ZitatespuckerZitat *Zitate, const char *const *authors, size_t amount)
+{
+	for (size_t i = 0; i < amount; i++) {
+		ZitatespuckerZitatInit(&Zitate[i]);
+		Zitate[i].author = (char *) authors[i];
+		Zitate[i].zitat = "Zitat";
+		Zitate[i].nextZitat = (i + 1 < amount ? &Zitate[i + 1] : NULL);
+		Zitate[i].prevZitat = (i > 0 ? &Zitate[i - 1] : NULL);
+	}
+
+	return Zitate;
+}
+
+/* The smallest edit distance between query and the beginning of any word of author, the slow way */
+static unsigned int Distance(const char *author, const char *query)
+{
+	size_t len = strlen(query);
+	unsigned int ret = (unsigned int) -1;
+	unsigned int up[NAME_LEN + 1];
+	unsigned int row[NAME_LEN + 1];
+	assert(len <= NAME_LEN);
+
+	for (size_t start = 0; author[start] != '\0'; start++) {
+		if (ispunct((unsigned char) author[start]) || isspace((unsigned char) author[start]))
+			continue;
+		if (start > 0 && !ispunct((unsigned char) author[start - 1]) && !isspace((unsigned char) author[start - 1]))
+			continue;
+		for (size_t j = 0; j <= len; j++)
+			up[j] = (unsigned int) j;
+		if (up[len] < ret)
+			ret = up[len];
+		for (size_t i = start; author[i] != '\0'; i++) {
+			row[0] = (unsigned int) (i - start + 1);
+			for (size_t j = 1; j <= len; j++) {
+				unsigned int cell = up[j - 1] + (tolower((unsigned char) author[i]) != tolower((unsigned char) query[j - 1]));
+				if (up[j] + 1 < cell)
+					cell = up[j] + 1;
+				if (row[j - 1] + 1 < cell)
+					cell = row[j - 1] + 1;
+				row[j] = cell;
+			}
+			(void) memcpy(up, row, sizeof(up));
+			if (up[len] < ret)
+				ret = up[len];
+		}
+	}
+
+	return ret;
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerZitat Zitate[sizeof(handwritten) / sizeof(handwritten[0])];
+	ZitatespuckerAuthorMatch matches[8];
+	ZitatespuckerAuthorIndex *index;
+
+	printf("ZitatespuckerAuthorIndexFromList:\n");
+	printf("Checking whether NULL arguments are refused...\n");
+	assert(ZitatespuckerAuthorIndexFromFile(NULL, ZITATESPUCKER_SOURCE_UNKNOWN) == NULL);
+	assert(ZitatespuckerAuthorIndexPrefix(NULL, "a", matches, 8) == 0);
+	assert(ZitatespuckerAuthorIndexGetAmount(NULL) == 0);
+	index = ZitatespuckerAuthorIndexFromList(NULL);
+	assert(index != NULL && ZitatespuckerAuthorIndexGetAmount(index) == 0 && ZitatespuckerAuthorIndexPrefix(index, "", matches, 8) == 0);
+	assert(ZitatespuckerAuthorIndexPrefix(index, NULL, matches, 8) == 0);
+	ZitatespuckerAuthorIndexFree(index);
+	ZitatespuckerAuthorIndexFree(NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether any word of a name is found by its beginning...\n");
+	index = ZitatespuckerAuthorIndexFromList(MakeList(Zitate, handwritten, sizeof(handwritten) / sizeof(handwritten[0])));
+	assert(index != NULL && ZitatespuckerAuthorIndexGetAmount(index) == 5);
+	assert(ZitatespuckerAuthorIndexPrefix(index, "Goe", matches, 8) == 2);
+	assert(strcmp(matches[0].author, "GOETHE-Institut") == 0 && matches[0].amount == 1 && matches[0].distance == 0);
+	assert(strcmp(matches[1].author, "Johann Wolfgang von Goethe") == 0 && matches[1].amount == 2);
+	assert(ZitatespuckerAuthorIndexPrefix(index, "INSTITUT", matches, 8) == 1 && strcmp(matches[0].author, "GOETHE-Institut") == 0);
+	assert(ZitatespuckerAuthorIndexPrefix(index, "johann wolfgang v", matches, 8) == 1);
+	assert(ZitatespuckerAuthorIndexPrefix(index, "olfgang", matches, 8) == 0);
+	assert(ZitatespuckerAuthorIndexPrefix(index, "zzz", matches, 8) == 0);
+	assert(ZitatespuckerAuthorIndexPrefix(index, "", NULL, 0) == 5);
+	assert(ZitatespuckerAuthorIndexPrefix(index, "", matches, 2) == 5 && strcmp(matches[1].author, "GOETHE-Institut") == 0);
+	printf("OKAY!\n\n");
+	printf("Checking whether typos are found, closest first...\n");
+	assert(ZitatespuckerAuthorIndexFuzzy(index, "gothe", 0, matches, 8) == 0);
+	assert(ZitatespuckerAuthorIndexFuzzy(index, "gothe", 1, matches, 8) == 2 && matches[0].distance == 1 && matches[1].distance == 1);
+	assert(ZitatespuckerAuthorIndexFuzzy(index, "Twian", 2, matches, 8) == 1 && strcmp(matches[0].author, "Mark Twain") == 0 && matches[0].distance == 2);
+	assert(ZitatespuckerAuthorIndexFuzzy(index, "schilerr", 2, matches, 8) == 1 && matches[0].distance == 2);
+	assert(ZitatespuckerAuthorIndexFuzzy(index, "wolfe", 2, matches, 8) == 2);
+	assert(strcmp(matches[0].author, "Johann Wolfgang von Goethe") == 0 && matches[0].distance == 1);
+	assert(strcmp(matches[1].author, "Oscar Wilde") == 0 && matches[1].distance == 2);
+	assert(ZitatespuckerAuthorIndexFuzzy(index, "x", 1, NULL, 0) == 5);
+	assert(ZitatespuckerAuthorIndexFuzzy(index, "x", ZITATESPUCKER_AUTHORS_MAX_DISTANCE + 1, matches, 8) == 0);
+	ZitatespuckerAuthorIndexFree(index);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerAuthorIndexFromFile:\n");
+	printf("Checking whether .json files and (lazily) SQLite databases are indexed (the latter lazily)...\n");
+	ZitatespuckerAuthorIndex *json = ZitatespuckerAuthorIndexFromFile("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN);
+	ZitatespuckerAuthorIndex *sql = ZitatespuckerAuthorIndexFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(json != NULL && sql != NULL);
+	assert(ZitatespuckerAuthorIndexPrefix(sql, "tor", matches, 8) == 1 && strcmp(matches[0].author, "Linus Torvalds") == 0);
+	// the database has the author 2 as a string, the .json file as a number (which is no author)
+	assert(ZitatespuckerAuthorIndexGetAmount(json) == 4 && ZitatespuckerAuthorIndexGetAmount(sql) == 5);
+	assert(ZitatespuckerAuthorIndexPrefix(json, "\xE6\x9D\xB1\xE6\x9D\xA1", matches, 8) == 1);
+	assert(ZitatespuckerAuthorIndexFuzzy(json, "Esl", 1, matches, 8) == 1 && strcmp(matches[0].author, "Ein Esel") == 0);
+	ZitatespuckerAuthorIndexFree(sql);
+	ZitatespuckerAuthorIndexFree(json);
+	assert(ZitatespuckerAuthorIndexFromFile("../doesnotexist.json", ZITATESPUCKER_SOURCE_UNKNOWN) == NULL);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerAuthorIndexFuzzy (%d authors):\n", LARGE_AMOUNT);
+	printf("Checking whether queries match checking every name...\n");
+	char (*names)[NAME_LEN] = (char (*)[NAME_LEN]) calloc(LARGE_AMOUNT, sizeof(*names));
+	const char **authors = (const char **) calloc(LARGE_AMOUNT, sizeof(char *));
+	ZitatespuckerZitat *large = (ZitatespuckerZitat *) calloc(LARGE_AMOUNT, sizeof(ZitatespuckerZitat));
+	assert(names != NULL && authors != NULL && large != NULL);
+	uint32_t state = 12345;
+	for (size_t n = 0; n < LARGE_AMOUNT; n++) {
+		size_t len = 0;
+		for (size_t word = 0; word < 3; word++) {
+			for (size_t syllable = 0; syllable < 2 + word % 2; syllable++) {
+				state = state * 1103515245u + 12345u;
+				const char *add = syllables[(state >> 16) % (sizeof(syllables) / sizeof(syllables[0]))];
+				(void) memcpy(&names[n][len], add, strlen(add));
+				len += strlen(add);
+			}
+			names[n][len++] = (word < 2 ? ' ' : '\0');
+		}
+		names[n][0] = (char) toupper((unsigned char) names[n][0]);
+		authors[n] = names[n];
+	}
+	index = ZitatespuckerAuthorIndexFromList(MakeList(large, authors, LARGE_AMOUNT));
+	assert(index != NULL);
+	size_t distinct = ZitatespuckerAuthorIndexGetAmount(index);
+	ZitatespuckerAuthorMatch *all = (ZitatespuckerAuthorMatch *) calloc(distinct, sizeof(ZitatespuckerAuthorMatch));
+	assert(all != NULL && ZitatespuckerAuthorIndexPrefix(index, "", all, distinct) == distinct);
+
+	static const char *const queries[] = {"karlma", "schro", "Heinfried", "jo", "xaze", "lima", "qqq"};
+	for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+		for (unsigned int maxDistance = 0; maxDistance <= 2; maxDistance++) {
+			double start = Seconds();
+			size_t found = ZitatespuckerAuthorIndexFuzzy(index, queries[q], maxDistance, NULL, 0);
+			double seconds = Seconds() - start;
+			ZitatespuckerAuthorMatch *got = (ZitatespuckerAuthorMatch *) calloc(found + 1, sizeof(ZitatespuckerAuthorMatch));
+			assert(got != NULL && ZitatespuckerAuthorIndexFuzzy(index, queries[q], maxDistance, got, found) == found);
+
+			size_t expected = 0;
+			for (size_t i = 0; i < distinct; i++) {
+				unsigned int distance = Distance(all[i].author, queries[q]);
+				if (distance > maxDistance)
+					continue;
+				expected++;
+				size_t j = 0;
+				while (j < found && got[j].author != all[i].author)
+					j++;
+				assert(j < found && got[j].distance == distance && got[j].amount == all[i].amount);
+			}
+			assert(expected == found);
+			for (size_t j = 1; j < found; j++)
+				assert(got[j - 1].distance <= got[j].distance);
+			printf("\"%s\" within %u: %zu authors in %.3f ms\n", queries[q], maxDistance, found, seconds * 1000);
+			free((void *) got);
+		}
+	}
+	free((void *) all);
+	ZitatespuckerAuthorIndexFree(index);
+	free((void *) large);
+	free((void *) authors);
+	free((void *) names);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,136 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Process-wide cache of parsed sources (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* stat(), utime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <utime.h>
+#include <sys/stat.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#define ZITATESPUCKER_CACHE
+#include "../Zitatespucker/Zitatespucker.h"
+
+
+#define REWRITTEN_FILE	"cache_tests.json"
+
+
+/* Replace REWRITTEN_FILE with an array of the given quotes, all by the same author */
+static void WriteQuotes(const char *const *zitate, size_t amount)
+{
+	FILE *file = fopen(REWRITTEN_FILE, "wb");
+	assert(file != NULL);
+	(void) fputs("{\"ZitatespuckerZitat\": [", file);
+	for (size_t i = 0; i < amount; i++)
+		(void) fprintf(file, "%s{\"author\": \"Author\", \"zitat\": \"%s\"}", (i > 0 ? ", " : ""), zitate[i]);
+	(void) fputs("]}\n", file);
+	assert(fclose(file) == 0);
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerCacheStats stats;
+	const ZitatespuckerZitat *first;
+	const ZitatespuckerZitat *second;
+
+	printf("ZitatespuckerSourceDetect:\n");
+	printf("Checking whether the test files are recognized...\n");
+	assert(ZitatespuckerSourceDetect("../testfile.json") == ZITATESPUCKER_SOURCE_JSON);
+	assert(ZitatespuckerSourceDetect("../testfile.sqlite") == ZITATESPUCKER_SOURCE_SQL);
+	assert(ZitatespuckerSourceDetect("wrongfilename.json") == ZITATESPUCKER_SOURCE_UNKNOWN);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerCacheGetZitatAllFromFile:\n");
+	printf("Checking whether an incorrect filename results in a NULL pointer...\n");
+	assert(ZitatespuckerCacheGetZitatAllFromFile("wrongfilename.json", ZITATESPUCKER_SOURCE_UNKNOWN) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether a disabled cache does not keep anything...\n");
+	first = ZitatespuckerCacheGetZitatAllFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(first != NULL);
+	ZitatespuckerCacheRelease(first);
+	ZitatespuckerCacheGetStats(&stats);
+	assert(stats.hits == 0 && stats.misses == 1 && stats.entries == 0);
+	printf("OKAY!\n\n");
+	printf("Checking whether a repeated load is a hit sharing the same list...\n");
+	ZitatespuckerCacheSetLimit(1024 * 1024);
+	first = ZitatespuckerCacheGetZitatAllFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_SQL);
+	second = ZitatespuckerCacheGetZitatAllFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_SQL);
+	assert(first != NULL && first == second);
+	ZitatespuckerCacheGetStats(&stats);
+	assert(stats.hits == 1 && stats.misses == 2 && stats.entries == 1 && stats.bytes > 0);
+	printf("OKAY!\n\n");
+	printf("Checking whether clearing keeps referenced lists alive...\n");
+	ZitatespuckerCacheClear();
+	ZitatespuckerCacheGetStats(&stats);
+	assert(stats.entries == 0 && stats.bytes == 0);
+	assert(ZitatespuckerZitatListLen((ZitatespuckerZitat *) first) == ZitatespuckerSQLGetAmountFromFile("../testfile.sqlite"));
+	ZitatespuckerCacheRelease(first);
+	ZitatespuckerCacheRelease(second);
+	printf("OKAY!\n\n");
+	printf("Checking whether rewriting a file to another size loads it anew...\n");
+	static const char *const before[] = {"First", "Second"};
+	static const char *const after[] = {"Third", "Fourth", "Fifth"};
+	WriteQuotes(before, 2);
+	first = ZitatespuckerCacheGetZitatAllFromFile(REWRITTEN_FILE, ZITATESPUCKER_SOURCE_JSON);
+	ZitatespuckerCacheGetStats(&stats);
+	uint64_t misses = stats.misses;
+	uint64_t evictions = stats.evictions;
+	WriteQuotes(after, 3);
+	second = ZitatespuckerCacheGetZitatAllFromFile(REWRITTEN_FILE, ZITATESPUCKER_SOURCE_JSON);
+	assert(first != NULL && second != NULL && first != second);
+	assert(ZitatespuckerZitatListLen((ZitatespuckerZitat *) second) == 3 && strcmp(second->zitat, "Third") == 0);
+	ZitatespuckerCacheGetStats(&stats);
+	assert(stats.misses == misses + 1 && stats.evictions == evictions + 1 && stats.entries == 1);
+	// the list loaded before stays as it was for as long as it is referenced
+	assert(ZitatespuckerZitatListLen((ZitatespuckerZitat *) first) == 2 && strcmp(first->zitat, "First") == 0);
+	ZitatespuckerCacheRelease(first);
+	printf("OKAY!\n\n");
+	printf("Checking whether rewriting a file to the same size, but a new modification time, loads it anew...\n");
+	static const char *const same[] = {"Hird!", "Fourth", "Fifth"};
+	struct stat st;
+	assert(stat(REWRITTEN_FILE, &st) == 0);
+	WriteQuotes(same, 3);
+	// a rewrite within the same tick of the file system clock would not show, so move the time on by hand
+	struct utimbuf times = {.actime = st.st_atime, .modtime = st.st_mtime + 10};
+	assert(utime(REWRITTEN_FILE, &times) == 0);
+	first = ZitatespuckerCacheGetZitatAllFromFile(REWRITTEN_FILE, ZITATESPUCKER_SOURCE_JSON);
+	assert(first != NULL && first != second && strcmp(first->zitat, "Hird!") == 0);
+	ZitatespuckerCacheGetStats(&stats);
+	assert(stats.misses == misses + 2 && stats.evictions == evictions + 2);
+	printf("OKAY!\n\n");
+	printf("Checking whether an unchanged file is still a hit afterwards...\n");
+	const ZitatespuckerZitat *third = ZitatespuckerCacheGetZitatAllFromFile(REWRITTEN_FILE, ZITATESPUCKER_SOURCE_JSON);
+	assert(third == first);
+	ZitatespuckerCacheRelease(first);
+	ZitatespuckerCacheRelease(second);
+	ZitatespuckerCacheRelease(third);
+	ZitatespuckerCacheClear();
+	(void) remove(REWRITTEN_FILE);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,168 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Compressed read-only quote lists (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+
+
+#define SYNTHETIC_AMOUNT	2000
+
+
+/* Check that every element of compact matches ZitatList */
+static void CheckRoundTrip(const ZitatespuckerCompact *compact, const ZitatespuckerZitat *ZitatList)
+{
+	static char buf[4096];
+	size_t i = 0;
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat, i++) {
+		size_t len = ZitatespuckerCompactGetZitat(compact, i, buf, sizeof(buf));
+		if (cur->zitat == NULL)
+			assert(len == ZITATESPUCKER_COMPACT_NONE && buf[0] == '\0');
+		else
+			assert(len == strlen(cur->zitat) && strcmp(buf, cur->zitat) == 0);
+
+		len = ZitatespuckerCompactGetComment(compact, i, buf, sizeof(buf));
+		if (cur->comment == NULL)
+			assert(len == ZITATESPUCKER_COMPACT_NONE);
+		else
+			assert(len == strlen(cur->comment) && strcmp(buf, cur->comment) == 0);
+
+		const char *author = ZitatespuckerCompactGetAuthor(compact, i);
+		assert((author == NULL && cur->author == NULL) || (author != NULL && cur->author != NULL && strcmp(author, cur->author) == 0));
+
+		bool annodomini;
+		uint16_t year;
+		uint8_t month, day;
+		assert(ZitatespuckerCompactGetDate(compact, i, &annodomini, &year, &month, &day));
+		assert(annodomini == cur->annodomini && year == cur->year && month == cur->month && day == cur->day);
+	}
+	assert(i == ZitatespuckerCompactLen(compact));
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerCompact *compact;
+	ZitatespuckerCompactStats stats;
+	ZitatespuckerZitat *ZitatList;
+	char buf[8];
+
+	printf("ZitatespuckerCompactFromList:\n");
+	printf("Checking whether a NULL list results in a NULL pointer...\n");
+	assert(ZitatespuckerCompactFromList(NULL) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether the test files survive the round trip...\n");
+	const char *files[] = {"../testfile.json", "../testfile.sqlite", "../../examples/example.json"};
+	for (size_t f = 0; f < sizeof(files) / sizeof(files[0]); f++) {
+		ZitatList = ZitatespuckerSourceGetZitatAllFromFile(files[f], ZITATESPUCKER_SOURCE_UNKNOWN);
+		assert(ZitatList != NULL);
+		compact = ZitatespuckerCompactFromList(ZitatList);
+		assert(compact != NULL);
+		CheckRoundTrip(compact, ZitatList);
+		ZitatespuckerCompactFree(compact);
+		ZitatespuckerZitatFree(ZitatList);
+	}
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerCompactGetZitat:\n");
+	printf("Checking whether small buffers are truncated like snprintf()...\n");
+	compact = ZitatespuckerCompactFromFile("../../examples/example.json", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(compact != NULL);
+	assert(ZitatespuckerCompactGetZitat(compact, 0, buf, 5) == strlen("TestZitat") && strcmp(buf, "Test") == 0);
+	assert(ZitatespuckerCompactGetZitat(compact, 0, NULL, 0) == strlen("TestZitat"));
+	printf("OKAY!\n\n");
+	printf("Checking whether an out-of-range idx results in ZITATESPUCKER_COMPACT_NONE...\n");
+	assert(ZitatespuckerCompactGetZitat(compact, 2, buf, sizeof(buf)) == ZITATESPUCKER_COMPACT_NONE && buf[0] == '\0');
+	assert(ZitatespuckerCompactGetAuthor(compact, 2) == NULL);
+	assert(!ZitatespuckerCompactGetDate(compact, 2, NULL, NULL, NULL, NULL));
+	ZitatespuckerCompactFree(compact);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerCompactFromList (synthetic corpus):\n");
+	printf("Checking whether all byte values and skewed frequencies survive the round trip...\n");
+	ZitatespuckerZitat *Zitate = (ZitatespuckerZitat *) calloc(SYNTHETIC_AMOUNT, sizeof(ZitatespuckerZitat));
+	assert(Zitate != NULL);
+	srand(42);
+	for (size_t i = 0; i < SYNTHETIC_AMOUNT; i++) {
+		size_t len = 20 + (size_t) (rand() % 200);
+		Zitate[i].zitat = (char *) malloc(len + 1);
+		assert(Zitate[i].zitat != NULL);
+		for (size_t j = 0; j < len; j++) {
+			// mostly lowercase text, with every other byte value showing up rarely (forcing long codes)
+			int r = rand() % 1000;
+			Zitate[i].zitat[j] = (char) (r < 900 ? 'a' + (r % 26) : 1 + (rand() % 255));
+		}
+		Zitate[i].zitat[len] = '\0';
+		if (i % 3 != 0) {
+			Zitate[i].comment = (char *) malloc(8);
+			assert(Zitate[i].comment != NULL);
+			(void) snprintf(Zitate[i].comment, 8, "c%u", (unsigned int) i);
+		}
+		Zitate[i].author = (char *) malloc(16);
+		assert(Zitate[i].author != NULL);
+		(void) snprintf(Zitate[i].author, 16, "Author %u", (unsigned int) (i % 37));
+		Zitate[i].year = (uint16_t) i;
+		Zitate[i].annodomini = (i % 2 == 0);
+		Zitate[i].nextZitat = (i + 1 < SYNTHETIC_AMOUNT ? &Zitate[i + 1] : NULL);
+		Zitate[i].prevZitat = (i > 0 ? &Zitate[i - 1] : NULL);
+	}
+	compact = ZitatespuckerCompactFromList(&Zitate[SYNTHETIC_AMOUNT / 2]);
+	assert(compact != NULL);
+	CheckRoundTrip(compact, Zitate);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether the compact list is smaller than the plain one...\n");
+	ZitatespuckerCompactGetStats(compact, &stats);
+	assert(stats.entries == SYNTHETIC_AMOUNT);
+	assert(stats.packedBytes < stats.textBytes && stats.totalBytes < stats.listBytes);
+	printf("%zu bytes per quote (%zu as a list), text packed to %.1f%%\n", stats.bytesPerZitat, stats.listBytes / stats.entries, 100.0 * (double) stats.packedBytes / (double) stats.textBytes);
+	printf("OKAY!\n\n");
+
+	// no assertion, just to keep an eye on it
+	static char textbuf[4096];
+	size_t decoded = 0;
+	clock_t start = clock();
+	for (int round = 0; round < 20; round++) {
+		for (size_t i = 0; i < SYNTHETIC_AMOUNT; i++)
+			decoded += ZitatespuckerCompactGetZitat(compact, i, textbuf, sizeof(textbuf));
+	}
+	double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+	if (seconds > 0)
+		printf("Decoding: %.0f MB/s\n\n\n", (double) decoded / seconds / 1e6);
+	else
+		printf("\n\n");
+
+	ZitatespuckerCompactFree(compact);
+	for (size_t i = 0; i < SYNTHETIC_AMOUNT; i++) {
+		free((void *) Zitate[i].zitat);
+		free((void *) Zitate[i].comment);
+		free((void *) Zitate[i].author);
+	}
+	free((void *) Zitate);
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
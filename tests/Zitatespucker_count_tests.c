@@ -0,0 +1,164 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Counting quotes by author and date (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define SYNTHETIC_AMOUNT	5000
+#define SYNTHETIC_FILE		"count_tests.sqlite"
+
+
+/* Check that a and b hold the same groups */
+static void CheckSame(const ZitatespuckerCounts *a, const ZitatespuckerCounts *b)
+{
+	assert(a != NULL && b != NULL);
+	assert(a->group == b->group && a->total == b->total && a->undated == b->undated && a->len == b->len);
+	for (size_t i = 0; i < a->len; i++) {
+		const ZitatespuckerCount *countA = &a->counts[i];
+		const ZitatespuckerCount *countB = &b->counts[i];
+		assert(countA->amount == countB->amount && countA->annodomini == countB->annodomini && countA->year == countB->year);
+		assert((countA->author == NULL && countB->author == NULL) || (countA->author != NULL && countB->author != NULL && strcmp(countA->author, countB->author) == 0));
+	}
+}
+
+/* Check that counting filename gives the same result as counting it after loading it, for every group and a few filters */
+static void CheckFile(const char *filename, const char *author)
+{
+	ZitatespuckerZitat *ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filename, ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(ZitatList != NULL);
+
+	ZitatespuckerCountFilter filters[4] = {0};
+	filters[1].author = author;
+	filters[2].byYear = true;
+	filters[2].firstYear = -3000;
+	filters[2].lastYear = 2000;
+	filters[3] = filters[2];
+	filters[3].author = author;
+
+	for (int group = ZITATESPUCKER_GROUP_NONE; group <= ZITATESPUCKER_GROUP_ERA; group++) {
+		for (int f = 0; f < 4; f++) {
+			ZitatespuckerCounts *fromFile = ZitatespuckerSourceCountFromFile(filename, ZITATESPUCKER_SOURCE_UNKNOWN, (ZitatespuckerGroup) group, &filters[f]);
+			ZitatespuckerCounts *fromList = ZitatespuckerCountFromList(ZitatList, (ZitatespuckerGroup) group, &filters[f]);
+			CheckSame(fromFile, fromList);
+			ZitatespuckerCountsFree(fromFile);
+			ZitatespuckerCountsFree(fromList);
+		}
+	}
+
+	ZitatespuckerZitatFree(ZitatList);
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerCounts *counts;
+	ZitatespuckerCountFilter filter = {0};
+
+	printf("ZitatespuckerSourceCountFromFile:\n");
+	printf("Checking whether a NULL filename results in a NULL pointer...\n");
+	assert(ZitatespuckerJSONCountFromFile(NULL, ZITATESPUCKER_GROUP_AUTHOR, NULL) == NULL);
+	assert(ZitatespuckerSQLCountFromFile(NULL, ZITATESPUCKER_GROUP_AUTHOR, NULL) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether a missing database results in a NULL pointer and a backend error...\n");
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerSQLCountFromFile("../doesnotexist.sqlite", ZITATESPUCKER_GROUP_AUTHOR, NULL) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_BACKEND);
+	printf("OKAY!\n\n");
+	printf("Checking whether an unknown group results in a NULL pointer...\n");
+	assert(ZitatespuckerCountBegin((ZitatespuckerGroup) 42, NULL) == NULL);
+	assert(ZitatespuckerSourceCountFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN, (ZitatespuckerGroup) 42, NULL) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether the example file is counted right...\n");
+	counts = ZitatespuckerSourceCountFromFile("../../examples/example.json", ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_GROUP_YEAR, NULL);
+	assert(counts != NULL && counts->total == 2 && counts->undated == 0 && counts->len == 2);
+	assert(!counts->counts[0].annodomini && counts->counts[0].year == 1 && counts->counts[0].amount == 1);
+	assert(counts->counts[1].annodomini && counts->counts[1].year == 2024 && counts->counts[1].amount == 1);
+	ZitatespuckerCountsFree(counts);
+	counts = ZitatespuckerSourceCountFromFile("../../examples/example.json", ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_GROUP_CENTURY, NULL);
+	assert(counts != NULL && counts->len == 2 && counts->counts[0].year == 0 && counts->counts[1].year == 2000);
+	ZitatespuckerCountsFree(counts);
+	printf("OKAY!\n\n");
+	printf("Checking whether filters are applied...\n");
+	filter.author = "TestAuthor2";
+	counts = ZitatespuckerSourceCountFromFile("../../examples/example.json", ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_GROUP_AUTHOR, &filter);
+	assert(counts != NULL && counts->total == 1 && counts->len == 1 && strcmp(counts->counts[0].author, "TestAuthor2") == 0);
+	ZitatespuckerCountsFree(counts);
+	filter.author = NULL;
+	filter.byYear = true;
+	filter.firstYear = 1;
+	filter.lastYear = 3000;
+	counts = ZitatespuckerSourceCountFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_GROUP_NONE, &filter);
+	assert(counts != NULL && counts->total == 2 && counts->len == 0);
+	ZitatespuckerCountsFree(counts);
+	printf("OKAY!\n\n");
+	printf("Checking whether the backends agree with counting loaded lists...\n");
+	CheckFile("../testfile.json", "Ein Esel");
+	CheckFile("../testfile.sqlite", "Ein Esel");
+	CheckFile("../../examples/example.json", "TestAuthor");
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerSQLCountFromFile (synthetic database):\n");
+	printf("Checking whether many groups, missing authors and invalid dates are counted like in the list...\n");
+	ZitatespuckerZitat *Zitate = SyntheticList(SYNTHETIC_AMOUNT, 1);
+	srand(42);
+	for (size_t i = 0; i < SYNTHETIC_AMOUNT; i++) {
+		(void) snprintf(Zitate[i].author, SYNTHETIC_TEXT_LEN, "Author %d", rand() % 700);
+		if (i % 50 == 0)
+			Zitate[i].author = NULL;
+		Zitate[i].year = (uint16_t) (rand() % 3000);
+		Zitate[i].annodomini = (rand() % 4 != 0);
+	}
+	Zitate[7].year = 0;
+	Zitate[7].annodomini = false;
+	(void) remove(SYNTHETIC_FILE);
+	assert(ZitatespuckerSQLImportList(SYNTHETIC_FILE, Zitate, NULL));
+	filter.firstYear = -1500;
+	filter.lastYear = 1500;
+	for (int group = ZITATESPUCKER_GROUP_NONE; group <= ZITATESPUCKER_GROUP_ERA; group++) {
+		for (int f = 0; f < 2; f++) {
+			ZitatespuckerCounts *fromFile = ZitatespuckerSQLCountFromFile(SYNTHETIC_FILE, (ZitatespuckerGroup) group, (f == 0 ? NULL : &filter));
+			ZitatespuckerCounts *fromList = ZitatespuckerCountFromList(Zitate, (ZitatespuckerGroup) group, (f == 0 ? NULL : &filter));
+			CheckSame(fromFile, fromList);
+			if (group == ZITATESPUCKER_GROUP_AUTHOR && f == 0)
+				assert(fromFile->len > 500 && fromFile->counts[0].author == NULL && fromFile->counts[0].amount == SYNTHETIC_AMOUNT / 50);
+			if (group != ZITATESPUCKER_GROUP_NONE && group != ZITATESPUCKER_GROUP_AUTHOR && f == 0)
+				assert(fromFile->undated >= 1);
+			ZitatespuckerCountsFree(fromFile);
+			ZitatespuckerCountsFree(fromList);
+		}
+	}
+	(void) remove(SYNTHETIC_FILE);
+	free((void *) Zitate);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,241 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	C++ interface (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cassert>
+#include <string_view>
+#include <utility>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.hpp"
+#include "Zitatespucker_tests.h"
+
+
+#define LARGE_AMOUNT	1000000
+#define RUNS			5
+#define SLACK			1.5 /* how much slower than C the C++ loops may be measured, as timings are noisy */
+
+
+static const char *const authors[] = {"Ein Esel", "Linus Torvalds", "Johann Wolfgang von Goethe", "Oscar Wilde"};
+
+
+static char *Duplicate(const char *str)
+{
+	char *ret = (char *) malloc(strlen(str) + 1);
+	assert(ret != NULL);
+	return strcpy(ret, str);
+}
+
+/* Returns a list of n elements allocated the way the backends do, so ZitatespuckerZitatFree() can free it */
+static ZitatespuckerZitat *MakeList(size_t n)
+{
+	ZitatespuckerZitat *first = NULL;
+	ZitatespuckerZitat *last = NULL;
+	for (size_t i = 0; i < n; i++) {
+		ZitatespuckerZitat *tmp = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat));
+		assert(tmp != NULL);
+		ZitatespuckerZitatInit(tmp);
+		char zitat[48];
+		(void) snprintf(zitat, sizeof(zitat), "Quote number %zu%s", i, (i % 3 == 0 ? " (a longer one)" : ""));
+		tmp->zitat = Duplicate(zitat);
+		tmp->author = (i % 7 == 0 ? NULL : Duplicate(authors[i % 4]));
+		tmp->year = (uint16_t) (i % 2000);
+		tmp->annodomini = (i % 5 != 0);
+		tmp->prevZitat = last;
+		if (last != NULL)
+			last->nextZitat = tmp;
+		else
+			first = tmp;
+		last = tmp;
+	}
+
+	return first;
+}
+
+/* The loop the C++ one is compared against, doing the same work: lengths from the accessors, then a compare of the bytes */
+static size_t SumC(const ZitatespuckerZitat *ZitatList)
+{
+	static const char wilde[] = "Oscar Wilde";
+	size_t sum = 0;
+	for (const ZitatespuckerZitat *tmp = ZitatList; tmp != NULL; tmp = tmp->nextZitat)
+		if (ZitatespuckerZitatGetAuthorLen(tmp) == sizeof(wilde) - 1 && memcmp(tmp->author, wilde, sizeof(wilde) - 1) == 0)
+			sum += ZitatespuckerZitatGetZitatLen(tmp);
+
+	return sum;
+}
+
+/* Unlink and free the elements without an author or from before the year 1000, as removeIf() is asked to below */
+static size_t RemoveC(ZitatespuckerZitat **ZitatList)
+{
+	size_t removed = 0;
+	for (ZitatespuckerZitat *tmp = *ZitatList, *next; tmp != NULL; tmp = next) {
+		next = tmp->nextZitat;
+		if (tmp->author == NULL || tmp->year < 1000) {
+			if (tmp->prevZitat != NULL)
+				tmp->prevZitat->nextZitat = next;
+			else
+				*ZitatList = next;
+			if (next != NULL)
+				next->prevZitat = tmp->prevZitat;
+			tmp->nextZitat = tmp->prevZitat = NULL;
+			ZitatespuckerZitatFree(tmp);
+			removed++;
+		}
+	}
+
+	return removed;
+}
+
+static size_t SumCpp(const Zitatespucker::List &list)
+{
+	size_t sum = 0;
+	for (Zitatespucker::Zitat Zitat : list)
+		if (Zitat.author() == "Oscar Wilde")
+			sum += Zitat.zitat().size();
+
+	return sum;
+}
+
+/* Fastest of RUNS calls of f, in seconds */
+template <typename F>
+static double Fastest(F f)
+{
+	double best = 0;
+	for (int i = 0; i < RUNS; i++) {
+		double start = Seconds();
+		f();
+		double seconds = Seconds() - start;
+		if (i == 0 || seconds < best)
+			best = seconds;
+	}
+
+	return best;
+}
+
+int main(int argc, char **argv)
+{
+	static const char *const files[] = {"../testfile.json", "../testfile.sqlite"};
+	for (size_t f = 0; f < sizeof(files) / sizeof(files[0]); f++) {
+		printf("Zitatespucker::List (%s):\n", files[f]);
+		printf("Checking whether iterating visits the same elements as the C list...\n");
+		ZitatespuckerZitat *ZitatList = ZitatespuckerSourceGetZitatAllFromFile(files[f], ZITATESPUCKER_SOURCE_UNKNOWN);
+		assert(ZitatList != NULL);
+		Zitatespucker::List list = Zitatespucker::List::fromFile(files[f]);
+		assert(list && !list.empty() && list.size() == ZitatespuckerZitatListLen(ZitatList));
+		const ZitatespuckerZitat *tmp = ZitatList;
+		for (Zitatespucker::Zitat Zitat : list) {
+			assert(tmp != NULL && Zitat.hash() == ZitatespuckerZitatHash(tmp));
+			assert(Zitat.hasAuthor() == (tmp->author != NULL));
+			assert(tmp->author == NULL || Zitat.author() == tmp->author);
+			assert(tmp->zitat == NULL || Zitat.zitat() == tmp->zitat);
+			assert(Zitat.year() == tmp->year && Zitat.annodomini() == tmp->annodomini);
+			tmp = tmp->nextZitat;
+		}
+		assert(tmp == NULL);
+		printf("OKAY!\n\n");
+		printf("Checking whether the string views point into the elements...\n");
+		assert(list.front().zitat().data() == list.get()->zitat);
+		assert(list.front().hasComment() || list.front().comment().empty());
+		printf("OKAY!\n\n");
+		printf("Checking whether filters match the C functions...\n");
+		size_t amount = list.size();
+		size_t byAuthor = ZitatespuckerZitatListLen(Zitatespucker::List::byAuthor(files[f], "Linus Torvalds").get());
+		assert(byAuthor > 0 && list.countIf([](Zitatespucker::Zitat Zitat) { return Zitat.author() == "Linus Torvalds"; }) == byAuthor);
+		assert(list.removeIf([](Zitatespucker::Zitat Zitat) { return Zitat.author() == "Linus Torvalds"; }) == byAuthor);
+		assert(list.size() == amount - byAuthor && list.get()->prevZitat == NULL);
+		for (Zitatespucker::Zitat Zitat : list)
+			assert(Zitat.author() != "Linus Torvalds");
+		assert(list.keepIf([](Zitatespucker::Zitat Zitat) { return false; }) == amount - byAuthor);
+		assert(!list && list.size() == 0 && list.begin() == list.end());
+		printf("OKAY!\n\n");
+		printf("Checking whether moving hands over the list...\n");
+		Zitatespucker::List moved(std::exchange(ZitatList, nullptr));
+		Zitatespucker::List other = std::move(moved);
+		assert(!moved && other.size() == amount);
+		moved = std::move(other);
+		assert(!other && moved.size() == amount);
+		moved.sort([](Zitatespucker::Zitat a, Zitatespucker::Zitat b) { return (int) b.year() - (int) a.year(); });
+		assert(moved.size() == amount && moved.get()->prevZitat == NULL);
+		for (auto it = moved.begin(), next = std::next(moved.begin()); next != moved.end(); ++it, ++next)
+			assert((*it).year() >= (*next).year());
+		printf("OKAY!\n\n");
+		printf("Checking the handles...\n");
+		Zitatespucker::Snapshot snapshot = Zitatespucker::Snapshot::fromList(moved);
+		assert(snapshot && snapshot.size() == amount);
+		Zitatespucker::Snapshot copy = snapshot;
+		assert(copy.get() == snapshot.get());
+		snapshot = Zitatespucker::Snapshot();
+		moved.reset();
+		assert(copy.size() == amount && copy[0].hash() != 0);
+		Zitatespucker::Rotation rotation(ZitatespuckerRotationFromSnapshot(copy.get(), NULL));
+		assert(rotation && ZitatespuckerRotationNext(rotation.get()) != NULL);
+		Zitatespucker::Compact compact(ZitatespuckerCompactFromFile(files[f], ZITATESPUCKER_SOURCE_UNKNOWN));
+		assert(compact && ZitatespuckerCompactLen(compact.get()) == amount);
+		Zitatespucker::Compact compactMoved = std::move(compact);
+		assert(!compact && compactMoved);
+		assert(!Zitatespucker::List::fromFile("../doesnotexist.json"));
+		printf("OKAY!\n\n\n");
+	}
+
+	printf("Zitatespucker::List (%d elements):\n", LARGE_AMOUNT);
+	printf("Checking whether range-for and string_view cost nothing over the C loop...\n");
+	Zitatespucker::List list(MakeList(LARGE_AMOUNT));
+	size_t sumC = 0;
+	size_t sumCpp = 0;
+	double secondsC = Fastest([&] { sumC = SumC(list.get()); });
+	double secondsCpp = Fastest([&] { sumCpp = SumCpp(list); });
+	assert(sumC == sumCpp && sumC > 0);
+	printf("C: %.2f ms, C++: %.2f ms\n", secondsC * 1e3, secondsCpp * 1e3);
+	assert(secondsCpp <= SLACK * secondsC + 0.001);
+	list.reset();
+	printf("OKAY!\n\n");
+
+	printf("Checking whether removeIf() costs nothing over unlinking in C...\n");
+	// every run removes from fresh lists, so only the removal is timed
+	for (int i = 0; i < RUNS; i++) {
+		ZitatespuckerZitat *ZitatList = MakeList(LARGE_AMOUNT);
+		list = Zitatespucker::List(MakeList(LARGE_AMOUNT));
+		double start = Seconds();
+		size_t removedC = RemoveC(&ZitatList);
+		double seconds = Seconds() - start;
+		if (i == 0 || seconds < secondsC)
+			secondsC = seconds;
+		start = Seconds();
+		size_t removedCpp = list.removeIf([](Zitatespucker::Zitat Zitat) { return !Zitat.hasAuthor() || Zitat.year() < 1000; });
+		seconds = Seconds() - start;
+		if (i == 0 || seconds < secondsCpp)
+			secondsCpp = seconds;
+		assert(removedC == removedCpp && removedC > 0 && list.size() == ZitatespuckerZitatListLen(ZitatList));
+		ZitatespuckerZitatFree(ZitatList);
+	}
+	printf("C: %.2f ms, C++: %.2f ms\n", secondsC * 1e3, secondsCpp * 1e3);
+	assert(secondsCpp <= SLACK * secondsC + 0.001);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
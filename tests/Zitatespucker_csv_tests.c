@@ -0,0 +1,260 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	CSV and TSV backend (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#define ZITATESPUCKER_CSV
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define HANDWRITTEN_FILE	"csv_tests_handwritten.csv"
+#define MAPPED_FILE			"csv_tests_mapped.tsv"
+#define ROUNDTRIP_FILE		"csv_tests_roundtrip.csv"
+#define ROUNDTRIP_DB		"csv_tests_roundtrip.sqlite"
+#define LARGE_FILE			"csv_tests_large.csv"
+#define LARGE_AMOUNT		100000
+
+
+/* Every quirk the parser has to deal with; it starts with a byte order mark and the last row has no line break */
+static const char handwritten[] =
+	"\xEF\xBB\xBF" " Author ,ZITAT,comment,day,month,year,annodomini,unknown\r\n"
+	"\"Quoted, with comma\",\"Line\r\nbreak and \"\"quotes\"\"\",,1,2,2024,yes,ignored\r\n"
+	"\r\n"
+	"\n"
+	"Plain,Text,,300,12.5,-5,BC\n"
+	"Short,\"\"\n"
+	"\"Unterminated,\n"
+	"Last,Quote,\"with \"\"a\"\" comment\",31,12,99999,ce";
+
+/* The same columns under other names and in another order, separated by tabs */
+static const char mapped[] =
+	"Era\tWho\tWhat\tWhen\n"
+	"AD\tFirst\tA\t1999\n"
+	"BC\tSecond\t\"B\tb\"\t500\n";
+
+
+static void WriteFile(const char *filename, const char *content)
+{
+	FILE *file = fopen(filename, "wb");
+	assert(file != NULL);
+	assert(fwrite(content, 1, strlen(content), file) == strlen(content));
+	assert(fclose(file) == 0);
+}
+
+/* Write str as a quoted field, doubling the quotes within */
+static void WriteField(FILE *file, const char *str)
+{
+	(void) fputc('"', file);
+	for (; str != NULL && *str != '\0'; str++) {
+		if (*str == '"')
+			(void) fputc('"', file);
+		(void) fputc(*str, file);
+	}
+	(void) fputc('"', file);
+}
+
+/* Write the whole list as CSV with the default column names */
+static void WriteList(const char *filename, const ZitatespuckerZitat *ZitatList)
+{
+	FILE *file = fopen(filename, "wb");
+	assert(file != NULL);
+	(void) fprintf(file, "author,zitat,comment,day,month,year,annodomini\r\n");
+	for (; ZitatList != NULL; ZitatList = ZitatList->nextZitat) {
+		WriteField(file, ZitatList->author);
+		(void) fputc(',', file);
+		WriteField(file, ZitatList->zitat);
+		(void) fputc(',', file);
+		WriteField(file, ZitatList->comment);
+		(void) fprintf(file, ",%u,%u,%u,%s\r\n", ZitatList->day, ZitatList->month, ZitatList->year, (ZitatList->annodomini ? "true" : "false"));
+	}
+	assert(fclose(file) == 0);
+}
+
+/* Check that both lists hold the same elements in the same order */
+static void CheckSame(ZitatespuckerZitat *a, ZitatespuckerZitat *b)
+{
+	assert(ZitatespuckerZitatListLen(a) == ZitatespuckerZitatListLen(b));
+	for (; a != NULL; a = a->nextZitat, b = b->nextZitat) {
+		assert(ZitatespuckerZitatHash(a) == ZitatespuckerZitatHash(b));
+		assert((a->comment == NULL) == (b->comment == NULL));
+		assert(a->comment == NULL || strcmp(a->comment, b->comment) == 0);
+	}
+}
+
+static bool CountCallback(const ZitatespuckerZitat *Zitat, void *userdata)
+{
+	(void) Zitat;
+	(*(size_t *) userdata)++;
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerZitat *ZitatList;
+	ZitatespuckerZitat *other;
+
+	printf("ZitatespuckerCSVGetZitatAllFromFile:\n");
+	printf("Checking whether a NULL or missing file results in a NULL pointer...\n");
+	assert(ZitatespuckerCSVGetZitatAllFromFile(NULL, NULL) == NULL);
+	assert(ZitatespuckerCSVGetZitatAllFromFile("../doesnotexist.csv", NULL) == NULL);
+	assert(ZitatespuckerCSVGetAmountFromFile("../doesnotexist.csv", NULL) == 0);
+	assert(ZitatespuckerCSVGetZitatAllFromFileByAuthor(HANDWRITTEN_FILE, NULL, NULL) == NULL);
+	assert(ZitatespuckerCSVForEachFromFile(HANDWRITTEN_FILE, NULL, NULL, NULL) == 0);
+	printf("OKAY!\n\n");
+	printf("Checking whether quoting, line breaks, numbers and short rows are handled...\n");
+	WriteFile(HANDWRITTEN_FILE, handwritten);
+	assert(ZitatespuckerSourceDetect(HANDWRITTEN_FILE) == ZITATESPUCKER_SOURCE_CSV);
+	assert(ZitatespuckerCSVGetAmountFromFile(HANDWRITTEN_FILE, NULL) == 4);
+	ZitatList = ZitatespuckerCSVGetZitatAllFromFile(HANDWRITTEN_FILE, NULL);
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == 4);
+	assert(strcmp(ZitatList->author, "Quoted, with comma") == 0 && strcmp(ZitatList->zitat, "Line\r\nbreak and \"quotes\"") == 0);
+	assert(ZitatList->comment == NULL && ZitatList->day == 1 && ZitatList->month == 2 && ZitatList->year == 2024 && ZitatList->annodomini);
+	other = ZitatList->nextZitat;
+	assert(strcmp(other->author, "Plain") == 0 && strcmp(other->zitat, "Text") == 0);
+	assert(other->day == 255 && other->month == 12 && other->year == 0 && !other->annodomini);
+	other = other->nextZitat;
+	assert(strcmp(other->author, "Short") == 0 && other->zitat == NULL && other->year == 0);
+	other = other->nextZitat;
+	// the quote left open runs up to the next one, taking the line break and the next row with it
+	assert(strncmp(other->author, "Unterminated,\nLast,Quote,", 25) == 0 && strcmp(other->zitat, "31") == 0 && other->nextZitat == NULL);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether single elements are found by row...\n");
+	ZitatList = ZitatespuckerCSVGetZitatSingleFromFile(HANDWRITTEN_FILE, NULL, 1);
+	assert(ZitatList != NULL && strcmp(ZitatList->author, "Plain") == 0);
+	ZitatespuckerZitatFree(ZitatList);
+	assert(ZitatespuckerCSVGetZitatSingleFromFile(HANDWRITTEN_FILE, NULL, 4) == NULL);
+	(void) remove(HANDWRITTEN_FILE);
+	WriteFile(HANDWRITTEN_FILE, "author,zitat\nFirst,\"a \"\"b\"\"\"\nLast,Quote,\"with \"\"a\"\" comment\",31,12,99999,ce");
+	ZitatList = ZitatespuckerCSVGetZitatSingleFromFile(HANDWRITTEN_FILE, NULL, 1);
+	assert(ZitatList != NULL && strcmp(ZitatList->author, "Last") == 0 && strcmp(ZitatList->zitat, "Quote") == 0 && ZitatList->comment == NULL);
+	ZitatespuckerZitatFree(ZitatList);
+	ZitatList = ZitatespuckerCSVGetZitatSingleFromFile(HANDWRITTEN_FILE, NULL, 0);
+	assert(ZitatList != NULL && strcmp(ZitatList->zitat, "a \"b\"") == 0);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether files without a known column are refused...\n");
+	WriteFile(HANDWRITTEN_FILE, "name,text\nSomeone,Something\n");
+	assert(ZitatespuckerCSVGetZitatAllFromFile(HANDWRITTEN_FILE, NULL) == NULL);
+	WriteFile(HANDWRITTEN_FILE, "");
+	assert(ZitatespuckerCSVGetZitatAllFromFile(HANDWRITTEN_FILE, NULL) == NULL);
+	WriteFile(HANDWRITTEN_FILE, "author,zitat\n");
+	assert(ZitatespuckerCSVGetZitatAllFromFile(HANDWRITTEN_FILE, NULL) == NULL && ZitatespuckerCSVGetAmountFromFile(HANDWRITTEN_FILE, NULL) == 0);
+	ZitatespuckerCSVOptions options = {.delimiter = '"'};
+	assert(ZitatespuckerCSVGetZitatAllFromFile(HANDWRITTEN_FILE, &options) == NULL);
+	(void) remove(HANDWRITTEN_FILE);
+	printf("OKAY!\n\n");
+	printf("Checking whether the header mapping and tabs are honoured...\n");
+	WriteFile(MAPPED_FILE, mapped);
+	options = (ZitatespuckerCSVOptions) {.author = "who", .zitat = "what", .year = "when", .annodomini = "era"};
+	ZitatList = ZitatespuckerCSVGetZitatAllFromFile(MAPPED_FILE, &options);
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == 2);
+	assert(strcmp(ZitatList->author, "First") == 0 && strcmp(ZitatList->zitat, "A") == 0 && ZitatList->year == 1999 && ZitatList->annodomini);
+	assert(strcmp(ZitatList->nextZitat->zitat, "B\tb") == 0 && ZitatList->nextZitat->year == 500 && !ZitatList->nextZitat->annodomini);
+	ZitatespuckerZitatFree(ZitatList);
+	ZitatList = ZitatespuckerCSVGetZitatAllFromFileByDate(MAPPED_FILE, &options, false, 500, 0, 0);
+	assert(ZitatList != NULL && ZitatList->nextZitat == NULL && strcmp(ZitatList->author, "Second") == 0);
+	ZitatespuckerZitatFree(ZitatList);
+	assert(ZitatespuckerCSVGetZitatAllFromFileByDate(MAPPED_FILE, &options, false, 0, 0, 0) == NULL);
+	assert(ZitatespuckerCSVGetZitatAllFromFileByDate(MAPPED_FILE, &options, true, 1999, 0, 1) == NULL);
+	options.delimiter = ',';
+	assert(ZitatespuckerCSVGetZitatAllFromFile(MAPPED_FILE, &options) == NULL);
+	(void) remove(MAPPED_FILE);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerSource functions on .csv:\n");
+	printf("Checking whether a written .csv file reads back like the .json file...\n");
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFile("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(ZitatList != NULL);
+	WriteList(ROUNDTRIP_FILE, ZitatList);
+	other = ZitatespuckerSourceGetZitatAllFromFile(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN);
+	CheckSame(ZitatList, other);
+	ZitatespuckerZitatFree(other);
+	printf("OKAY!\n\n");
+	printf("Checking whether the other source functions work on it...\n");
+	other = ZitatespuckerSourceGetZitatAllFromFileByAuthor(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, "Ein Esel");
+	ZitatespuckerZitat *expected = ZitatespuckerSourceGetZitatAllFromFileByAuthor("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN, "Ein Esel");
+	CheckSame(expected, other);
+	ZitatespuckerZitatFree(expected);
+	ZitatespuckerZitatFree(other);
+	other = ZitatespuckerSourceGetZitatSingleFromFileFields(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, 0, ZITATESPUCKER_FIELD_DATE);
+	assert(other != NULL && other->year == ZitatList->year && other->author == NULL && other->zitat == NULL);
+	ZitatespuckerZitatFree(other);
+	ZitatespuckerCounts *counts = ZitatespuckerSourceCountFromFile(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_GROUP_AUTHOR, NULL);
+	ZitatespuckerCounts *expectedCounts = ZitatespuckerCountFromList(ZitatList, ZITATESPUCKER_GROUP_AUTHOR, NULL);
+	assert(counts != NULL && expectedCounts != NULL && counts->len == expectedCounts->len && counts->total == expectedCounts->total);
+	ZitatespuckerCountsFree(expectedCounts);
+	ZitatespuckerCountsFree(counts);
+	(void) remove(ROUNDTRIP_DB);
+	ZitatespuckerSQLImportStats stats;
+	assert(ZitatespuckerSourceImportToSQL(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, ROUNDTRIP_DB, &stats));
+	assert(stats.rows == ZitatespuckerZitatListLen(ZitatList));
+	(void) remove(ROUNDTRIP_DB);
+	(void) remove(ROUNDTRIP_FILE);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerCSVForEachFromFile (%d elements):\n", LARGE_AMOUNT);
+	printf("Checking whether every row of a large file is passed on...\n");
+	ZitatespuckerZitat *Zitate = (ZitatespuckerZitat *) calloc(LARGE_AMOUNT, sizeof(ZitatespuckerZitat));
+	char (*zitate)[32] = (char (*)[32]) calloc(LARGE_AMOUNT, sizeof(*zitate));
+	assert(Zitate != NULL && zitate != NULL);
+	for (size_t n = 0; n < LARGE_AMOUNT; n++) {
+		ZitatespuckerZitatInit(&Zitate[n]);
+		(void) snprintf(zitate[n], sizeof(zitate[n]), "Quote, number %zu", n);
+		Zitate[n].author = (n % 3 == 0 ? "Author A" : "Author B");
+		Zitate[n].zitat = zitate[n];
+		Zitate[n].comment = "A comment that makes the file a bit larger than it would be otherwise";
+		Zitate[n].year = (uint16_t) (n % 2024);
+		Zitate[n].annodomini = true;
+		Zitate[n].nextZitat = (n + 1 < LARGE_AMOUNT ? &Zitate[n + 1] : NULL);
+	}
+	WriteList(LARGE_FILE, Zitate);
+	free((void *) zitate);
+	free((void *) Zitate);
+	size_t passed = 0;
+	double start = Seconds();
+	assert(ZitatespuckerCSVForEachFromFile(LARGE_FILE, NULL, CountCallback, &passed) == LARGE_AMOUNT);
+	double seconds = Seconds() - start;
+	assert(passed == LARGE_AMOUNT);
+	FILE *file = fopen(LARGE_FILE, "rb");
+	assert(file != NULL && fseek(file, 0, SEEK_END) == 0);
+	long size = ftell(file);
+	(void) fclose(file);
+	printf("%ld bytes in %.0f ms (%.0f MiB/s)\n", size, seconds * 1000, (double) size / (seconds > 0 ? seconds : 1e-9) / (1024 * 1024));
+	ZitatList = ZitatespuckerCSVGetZitatAllFromFileByAuthor(LARGE_FILE, NULL, "Author A");
+	assert(ZitatespuckerZitatListLen(ZitatList) == (LARGE_AMOUNT + 2) / 3);
+	ZitatespuckerZitatFree(ZitatList);
+	(void) remove(LARGE_FILE);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
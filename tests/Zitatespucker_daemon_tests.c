@@ -0,0 +1,490 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	zitatespuckerd and its client (Tests; forks ./zitatespuckerd, which 'make check' builds next to them)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* sockets, fork(), mkdtemp(), clock_gettime() (prctl() is Linux only, just like zitatespuckerd) */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_SQL
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_CLIENT
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define SMALL_FILE	"daemon_tests.sqlite"
+#define SMALL_LEN	3000
+#define SMALL_AUTHORS	10
+#define BIG_FILE	"daemon_tests.json"
+#define BIG_LEN		80
+#define BIG_ZITAT_LEN	(256 * 1024) /* BIG_LEN of them make more than ZITATESPUCKER_PROTOCOL_MAXFRAME */
+
+
+/* Write BIG_FILE: BIG_LEN quotes of BIG_ZITAT_LEN bytes by "Big", from 1 BC so they stay out of the way of the by-date checks */
+static void WriteBigFile(void)
+{
+	char *zitat = (char *) malloc(BIG_ZITAT_LEN + 1);
+	assert(zitat != NULL);
+	(void) memset(zitat, 'x', BIG_ZITAT_LEN);
+	zitat[BIG_ZITAT_LEN] = '\0';
+
+	FILE *file = fopen(BIG_FILE, "wb");
+	assert(file != NULL);
+	(void) fputs("{\"ZitatespuckerZitat\": [", file);
+	for (size_t i = 0; i < BIG_LEN; i++)
+		(void) fprintf(file, "%s{\"author\": \"Big\", \"zitat\": \"%s\", \"year\": 1, \"annodomini\": false}", (i > 0 ? ", " : ""), zitat);
+	(void) fputs("]}\n", file);
+	assert(fclose(file) == 0);
+	free((void *) zitat);
+}
+
+static void PutU32(uint8_t *dst, uint32_t val)
+{
+	dst[0] = (uint8_t) val;
+	dst[1] = (uint8_t) (val >> 8);
+	dst[2] = (uint8_t) (val >> 16);
+	dst[3] = (uint8_t) (val >> 24);
+}
+
+static uint32_t GetU32(const uint8_t *src)
+{
+	return (uint32_t) src[0] | ((uint32_t) src[1] << 8) | ((uint32_t) src[2] << 16) | ((uint32_t) src[3] << 24);
+}
+
+/* Connect to socketpath, -1 if nobody listens there */
+static int RawConnect(const char *socketpath)
+{
+	struct sockaddr_un addr;
+	(void) memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	(void) strcpy(addr.sun_path, socketpath);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	assert(fd >= 0);
+	if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+		(void) close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+static void RawSend(int fd, const uint8_t *data, size_t len)
+{
+	while (len != 0) {
+		ssize_t ret = send(fd, data, len, MSG_NOSIGNAL);
+		assert(ret > 0 || (ret < 0 && errno == EINTR));
+		if (ret > 0) {
+			data += ret;
+			len -= (size_t) ret;
+		}
+	}
+}
+
+/* Receive exactly len bytes; false if the connection was closed (or broke) before */
+static bool RawRecv(int fd, uint8_t *data, size_t len)
+{
+	while (len != 0) {
+		ssize_t ret = recv(fd, data, len, 0);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		else if (ret <= 0)
+			return false;
+		data += ret;
+		len -= (size_t) ret;
+	}
+
+	return true;
+}
+
+/* Receive a response frame, returning its status and storing its amount and payload length */
+static uint8_t RawResponse(int fd, uint32_t *amount, uint32_t *len)
+{
+	uint8_t head[9];
+	assert(RawRecv(fd, head, 9));
+	*len = GetU32(head);
+	*amount = GetU32(head + 5);
+	assert(*len >= 5 && *len <= ZITATESPUCKER_PROTOCOL_MAXFRAME);
+
+	uint8_t *rest = (uint8_t *) malloc(*len - 5 + 1);
+	assert(rest != NULL);
+	assert(RawRecv(fd, rest, *len - 5));
+	free((void *) rest);
+
+	return head[4];
+}
+
+/* Send the request payload req (reqlen bytes) and return the status of the response */
+static uint8_t RawRequest(int fd, const uint8_t *req, uint32_t reqlen, uint32_t *amount)
+{
+	uint8_t head[4];
+	PutU32(head, reqlen);
+	RawSend(fd, head, 4);
+	RawSend(fd, req, reqlen);
+
+	uint32_t len;
+	return RawResponse(fd, amount, &len);
+}
+
+/* Whether the daemon hung up on fd */
+static bool RawClosed(int fd)
+{
+	uint8_t byte;
+	return !RawRecv(fd, &byte, 1);
+}
+
+static void Sleep(long ms)
+{
+	struct timespec ts = {ms / 1000, (ms % 1000) * 1000000L};
+	(void) nanosleep(&ts, NULL);
+}
+
+/* Start ./zitatespuckerd on socketpath serving the given files; returns its pid once it accepts connections */
+static pid_t StartDaemon(const char *socketpath, const char *file1, const char *file2)
+{
+	pid_t pid = fork();
+	assert(pid >= 0);
+	if (pid == 0) {
+		// a failed check must not leave the daemon behind
+		(void) prctl(PR_SET_PDEATHSIG, SIGTERM);
+		(void) execl("./zitatespuckerd", "zitatespuckerd", "-s", socketpath, file1, file2, (char *) NULL);
+		_exit(127);
+	}
+
+	for (int i = 0; i < 3000; i++) {
+		int fd = RawConnect(socketpath);
+		if (fd >= 0) {
+			(void) close(fd);
+			return pid;
+		}
+		assert(waitpid(pid, NULL, WNOHANG) == 0);
+		Sleep(10);
+	}
+	assert(!"zitatespuckerd did not come up");
+
+	return -1;
+}
+
+/* Send SIGTERM to pid and return its exit status */
+static int StopDaemon(pid_t pid)
+{
+	int status;
+	assert(kill(pid, SIGTERM) == 0);
+	assert(waitpid(pid, &status, 0) == pid);
+	assert(WIFEXITED(status));
+
+	return WEXITSTATUS(status);
+}
+
+/* Resident memory of pid in KiB */
+static size_t ResidentKiB(pid_t pid)
+{
+	char path[64];
+	(void) snprintf(path, sizeof(path), "/proc/%ld/status", (long) pid);
+	FILE *file = fopen(path, "r");
+	assert(file != NULL);
+
+	char line[256];
+	size_t kib = 0;
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if (strncmp(line, "VmRSS:", 6) == 0)
+			kib = (size_t) strtoul(line + 6, NULL, 10);
+	}
+	(void) fclose(file);
+	assert(kib != 0);
+
+	return kib;
+}
+
+static bool PathExists(const char *path)
+{
+	struct stat st;
+	return (lstat(path, &st) == 0);
+}
+
+int main(int argc, char **argv)
+{
+	char dir[] = "/tmp/zitatespuckerd_tests.XXXXXX";
+	assert(mkdtemp(dir) != NULL);
+	char socketpath[64], otherpath[64], filepath[64];
+	(void) snprintf(socketpath, sizeof(socketpath), "%s/daemon.sock", dir);
+	(void) snprintf(otherpath, sizeof(otherpath), "%s/other.sock", dir);
+	(void) snprintf(filepath, sizeof(filepath), "%s/notasocket", dir);
+
+	SyntheticDatabase(SMALL_FILE, SMALL_LEN, SMALL_AUTHORS);
+	WriteBigFile();
+	pid_t pid = StartDaemon(socketpath, SMALL_FILE, BIG_FILE);
+
+	ZitatespuckerClient *client = ZitatespuckerClientConnect(socketpath);
+	assert(client != NULL);
+	ZitatespuckerZitat *ZitatList;
+
+	printf("ZitatespuckerClientGetAmount:\n");
+	printf("Checking whether the daemon holds the elements of both files...\n");
+	assert(ZitatespuckerClientGetAmount(client) == SMALL_LEN + BIG_LEN);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerClientGetZitatRandom:\n");
+	printf("Checking whether a random element comes back whole...\n");
+	for (int i = 0; i < 20; i++) {
+		ZitatList = ZitatespuckerClientGetZitatRandom(client);
+		assert(ZitatList != NULL && ZitatList->nextZitat == NULL && ZitatList->author != NULL && ZitatList->zitat != NULL);
+		ZitatespuckerZitatFree(ZitatList);
+	}
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerClientGetZitatRange:\n");
+	printf("Checking whether a range comes back in order...\n");
+	ZitatList = ZitatespuckerClientGetZitatRange(client, 10, 5);
+	assert(ZitatespuckerZitatListLen(ZitatList) == 5);
+	assert(strcmp(ZitatList->zitat, "Quote number 10") == 0 && strcmp(ZitatList->author, "Author 0") == 0 && ZitatList->year == 10);
+	assert(strcmp(ZitatList->nextZitat->nextZitat->nextZitat->nextZitat->zitat, "Quote number 14") == 0);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether a range past the end is empty, without an error...\n");
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerClientGetZitatRange(client, SMALL_LEN + BIG_LEN, 5) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_NONE);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerClientGetZitatAllByAuthor:\n");
+	printf("Checking whether every element of an author comes back, and no more than maxAmount...\n");
+	ZitatList = ZitatespuckerClientGetZitatAllByAuthor(client, "Author 3", 1000);
+	assert(ZitatespuckerZitatListLen(ZitatList) == SMALL_LEN / SMALL_AUTHORS);
+	for (ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat)
+		assert(strcmp(cur->author, "Author 3") == 0);
+	ZitatespuckerZitatFree(ZitatList);
+	ZitatList = ZitatespuckerClientGetZitatAllByAuthor(client, "Author 3", 7);
+	assert(ZitatespuckerZitatListLen(ZitatList) == 7);
+	ZitatespuckerZitatFree(ZitatList);
+	assert(ZitatespuckerClientGetZitatAllByAuthor(client, "Nobody", 10) == NULL);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerClientGetZitatAllByDate:\n");
+	printf("Checking whether the elements of a year come back...\n");
+	ZitatList = ZitatespuckerClientGetZitatAllByDate(client, true, 5, 0, 0, 10);
+	assert(ZitatespuckerZitatListLen(ZitatList) == 2);
+	assert(strcmp(ZitatList->zitat, "Quote number 5") == 0 && strcmp(ZitatList->nextZitat->zitat, "Quote number 2029") == 0);
+	ZitatespuckerZitatFree(ZitatList);
+	assert(ZitatespuckerClientGetZitatAllByDate(client, true, 5, 1, 0, 10) == NULL);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerClientGetZitatAllBySearch:\n");
+	printf("Checking whether a search finds every element containing the text...\n");
+	ZitatList = ZitatespuckerClientGetZitatAllBySearch(client, "number 12", 1000);
+	assert(ZitatespuckerZitatListLen(ZitatList) == 1 + 10 + 100);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n\n");
+
+	printf("Limits:\n");
+	printf("Checking whether a response larger than a frame is refused without breaking the connection...\n");
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerClientGetZitatRange(client, SMALL_LEN, BIG_LEN) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_BACKEND);
+	assert(ZitatespuckerClientGetZitatAllByAuthor(client, "Big", BIG_LEN) == NULL);
+	assert(ZitatespuckerClientGetZitatAllBySearch(client, "xxx", BIG_LEN) == NULL);
+	assert(ZitatespuckerClientGetAmount(client) == SMALL_LEN + BIG_LEN);
+	printf("OKAY!\n\n");
+
+	int fd = RawConnect(socketpath);
+	assert(fd >= 0);
+	uint8_t req[16];
+	uint32_t amount;
+
+	printf("Checking whether a request of the largest frame is answered...\n");
+	uint8_t *huge = (uint8_t *) malloc(ZITATESPUCKER_PROTOCOL_MAXFRAME);
+	assert(huge != NULL);
+	(void) memset(huge, 'y', ZITATESPUCKER_PROTOCOL_MAXFRAME);
+	huge[0] = ZITATESPUCKER_OP_BYAUTHOR;
+	PutU32(huge + 1, 10);
+	PutU32(huge + 5, ZITATESPUCKER_PROTOCOL_MAXFRAME - 9);
+	assert(RawRequest(fd, huge, ZITATESPUCKER_PROTOCOL_MAXFRAME, &amount) == ZITATESPUCKER_STATUS_OK && amount == 0);
+	free((void *) huge);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether a client that stops reading is no longer read from...\n");
+	int flood = RawConnect(socketpath);
+	assert(flood >= 0);
+	size_t before = ResidentKiB(pid);
+	// 64 answers of 4 MiB each, none of which is read for now
+	uint8_t floodreq[64 * 16];
+	for (int i = 0; i < 64; i++) {
+		PutU32(floodreq + i * 16, 12);
+		floodreq[i * 16 + 4] = ZITATESPUCKER_OP_BYAUTHOR;
+		PutU32(floodreq + i * 16 + 5, 16);
+		PutU32(floodreq + i * 16 + 9, 3);
+		(void) memcpy(floodreq + i * 16 + 13, "Big", 3);
+	}
+	RawSend(flood, floodreq, sizeof(floodreq));
+	Sleep(300);
+	assert(ResidentKiB(pid) < before + 64 * 1024);
+	// meanwhile, everyone else is still served
+	assert(ZitatespuckerClientGetAmount(client) == SMALL_LEN + BIG_LEN);
+	for (int i = 0; i < 64; i++) {
+		uint32_t len;
+		assert(RawResponse(flood, &amount, &len) == ZITATESPUCKER_STATUS_OK && amount == 16 && len > 16 * BIG_ZITAT_LEN);
+	}
+	(void) close(flood);
+	printf("OKAY!\n\n\n");
+
+	printf("Bad frames:\n");
+	printf("Checking whether an unknown opcode is a bad request...\n");
+	req[0] = 99;
+	assert(RawRequest(fd, req, 1, &amount) == ZITATESPUCKER_STATUS_BADREQUEST && amount == 0);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether payloads of the wrong length are bad requests...\n");
+	req[0] = ZITATESPUCKER_OP_RANGE;
+	assert(RawRequest(fd, req, 5, &amount) == ZITATESPUCKER_STATUS_BADREQUEST);
+	req[0] = ZITATESPUCKER_OP_BYAUTHOR;
+	PutU32(req + 1, 10);
+	PutU32(req + 5, 4);
+	(void) memcpy(req + 9, "Author", 6);
+	assert(RawRequest(fd, req, 15, &amount) == ZITATESPUCKER_STATUS_BADREQUEST);
+	req[0] = ZITATESPUCKER_OP_SEARCH;
+	assert(RawRequest(fd, req, 5, &amount) == ZITATESPUCKER_STATUS_BADREQUEST);
+	req[0] = ZITATESPUCKER_OP_BYDATE;
+	assert(RawRequest(fd, req, 9, &amount) == ZITATESPUCKER_STATUS_BADREQUEST);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether impossible dates are bad requests...\n");
+	req[0] = ZITATESPUCKER_OP_BYDATE;
+	PutU32(req + 1, 10);
+	(void) memset(req + 5, 0, 5);
+	assert(RawRequest(fd, req, 10, &amount) == ZITATESPUCKER_STATUS_BADREQUEST); // no year
+	req[5] = 1;
+	req[6] = 5;
+	req[9] = 1;
+	assert(RawRequest(fd, req, 10, &amount) == ZITATESPUCKER_STATUS_BADREQUEST); // day without month
+	req[0] = ZITATESPUCKER_OP_COUNT;
+	assert(RawRequest(fd, req, 1, &amount) == ZITATESPUCKER_STATUS_OK && amount == SMALL_LEN + BIG_LEN);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether an empty frame closes the connection...\n");
+	PutU32(req, 0);
+	RawSend(fd, req, 4);
+	assert(RawClosed(fd));
+	(void) close(fd);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether a frame larger than the largest closes the connection...\n");
+	fd = RawConnect(socketpath);
+	assert(fd >= 0);
+	PutU32(req, ZITATESPUCKER_PROTOCOL_MAXFRAME + 1);
+	req[4] = ZITATESPUCKER_OP_COUNT;
+	RawSend(fd, req, 5);
+	assert(RawClosed(fd));
+	(void) close(fd);
+	assert(ZitatespuckerClientGetAmount(client) == SMALL_LEN + BIG_LEN);
+	printf("OKAY!\n\n\n");
+
+	printf("Broken connections:\n");
+	printf("Checking whether a client fails every call after a malformed response...\n");
+	int listenfd = socket(AF_UNIX, SOCK_STREAM, 0);
+	struct sockaddr_un addr;
+	(void) memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	(void) strcpy(addr.sun_path, otherpath);
+	assert(listenfd >= 0 && bind(listenfd, (struct sockaddr *) &addr, sizeof(addr)) == 0 && listen(listenfd, 1) == 0);
+	ZitatespuckerClient *other = ZitatespuckerClientConnect(otherpath);
+	assert(other != NULL);
+	int peer = accept(listenfd, NULL, NULL);
+	assert(peer >= 0);
+	// an empty frame, then a well-formed answer that only a client out of step would take
+	uint8_t answers[4 + 4 + 5];
+	PutU32(answers, 0);
+	PutU32(answers + 4, 5);
+	answers[8] = ZITATESPUCKER_STATUS_OK;
+	PutU32(answers + 9, 7);
+	RawSend(peer, answers, sizeof(answers));
+	assert(ZitatespuckerClientGetAmount(other) == 0);
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerClientGetAmount(other) == 0);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_BACKEND);
+	assert(ZitatespuckerClientGetZitatRandom(other) == NULL);
+	ZitatespuckerClientClose(other);
+	(void) close(peer);
+	(void) close(listenfd);
+	(void) unlink(otherpath);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether a client fails every call after the daemon went away...\n");
+	ZitatespuckerClientClose(client);
+	client = ZitatespuckerClientConnect(socketpath);
+	assert(client != NULL);
+	assert(StopDaemon(pid) == EXIT_SUCCESS);
+	assert(ZitatespuckerClientGetAmount(client) == 0);
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerClientGetZitatRandom(client) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_BACKEND);
+	ZitatespuckerClientClose(client);
+	printf("OKAY!\n\n\n");
+
+	printf("Socket path:\n");
+	printf("Checking whether the daemon removes its socket when stopped...\n");
+	assert(!PathExists(socketpath));
+	printf("OKAY!\n\n");
+
+	printf("Checking whether the daemon refuses a path that is not a socket, and leaves it alone...\n");
+	FILE *file = fopen(filepath, "wb");
+	assert(file != NULL && fputs("keep me", file) >= 0 && fclose(file) == 0);
+	pid = fork();
+	assert(pid >= 0);
+	if (pid == 0) {
+		(void) execl("./zitatespuckerd", "zitatespuckerd", "-s", filepath, SMALL_FILE, (char *) NULL);
+		_exit(127);
+	}
+	int status;
+	assert(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_FAILURE);
+	struct stat st;
+	assert(lstat(filepath, &st) == 0 && S_ISREG(st.st_mode) && st.st_size == 7);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether the daemon leaves what replaced its socket alone when stopped...\n");
+	pid = StartDaemon(socketpath, SMALL_FILE, SMALL_FILE);
+	assert(unlink(socketpath) == 0 && rename(filepath, socketpath) == 0);
+	assert(StopDaemon(pid) == EXIT_SUCCESS);
+	assert(lstat(socketpath, &st) == 0 && S_ISREG(st.st_mode));
+	printf("OKAY!\n\n\n");
+
+	(void) unlink(socketpath);
+	(void) rmdir(dir);
+	(void) remove(SMALL_FILE);
+	(void) remove(BIG_FILE);
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,181 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Deduplication of lists (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#include "../Zitatespucker/Zitatespucker.h"
+
+
+#define LARGE_AMOUNT	1000000
+
+
+static char *CopyString(const char *str)
+{
+	if (str == NULL)
+		return NULL;
+	char *ret = (char *) malloc(strlen(str) + 1);
+	assert(ret != NULL);
+	return strcpy(ret, str);
+}
+
+/* Append a new element to the list ending in *last (NULL for a new list) */
+static ZitatespuckerZitat *Append(ZitatespuckerZitat **last, const char *author, const char *zitat, const char *comment, uint16_t year)
+{
+	ZitatespuckerZitat *Zitat = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat));
+	assert(Zitat != NULL);
+	ZitatespuckerZitatInit(Zitat);
+	Zitat->author = CopyString(author);
+	Zitat->zitat = CopyString(zitat);
+	Zitat->comment = CopyString(comment);
+	Zitat->year = year;
+	Zitat->annodomini = true;
+	if (*last != NULL) {
+		(*last)->nextZitat = Zitat;
+		Zitat->prevZitat = *last;
+	}
+	*last = Zitat;
+	return Zitat;
+}
+
+/* The test list: "a", "b", "c", "d" and "e" are one quote, "f" and "g" another, the rest are unique */
+static ZitatespuckerZitat *BuildList(void)
+{
+	ZitatespuckerZitat *last = NULL;
+	ZitatespuckerZitat *first = Append(&last, "Author", "Hello world", "a", 2000);
+	(void) Append(&last, "Other", "Hello world", "x", 2000);
+	(void) Append(&last, " Author", "  Hello   world ", "b", 2000);
+	(void) Append(&last, "Author", "Hello world", "y", 2001);
+	(void) Append(&last, "Author\t", "Hello\n\tworld", "c", 2000);
+	(void) Append(&last, NULL, "Nameless", "f", 0);
+	(void) Append(&last, "Author", "Hello world!", "z", 2000);
+	(void) Append(&last, "   ", " Nameless", "g", 0);
+	(void) Append(&last, "Author", "Hello world", "d", 2000);
+	(void) Append(&last, "Author", "Hello world", "e", 2000);
+	return first;
+}
+
+/* Check that the comments along ZitatList spell out expected */
+static void CheckComments(const ZitatespuckerZitat *ZitatList, const char *expected)
+{
+	assert(ZitatList->prevZitat == NULL);
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat, expected++) {
+		assert(cur->comment[0] == *expected);
+		assert(cur->nextZitat == NULL || cur->nextZitat->prevZitat == cur);
+	}
+	assert(*expected == '\0');
+}
+
+static void CountDuplicate(const ZitatespuckerZitat *kept, const ZitatespuckerZitat *duplicate, void *userdata)
+{
+	assert(ZitatespuckerZitatHash(kept) == ZitatespuckerZitatHash(duplicate));
+	(*(size_t *) userdata)++;
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerZitat *ZitatList;
+	size_t duplicates;
+	size_t reported;
+
+	printf("ZitatespuckerZitatDedup:\n");
+	printf("Checking whether a NULL list results in a NULL pointer...\n");
+	assert(ZitatespuckerZitatDedup(NULL, ZITATESPUCKER_DUPLICATES_KEEP_FIRST, NULL, NULL, &duplicates) == NULL && duplicates == 0);
+	printf("OKAY!\n\n");
+	printf("Checking whether whitespace differences are ignored and the first duplicate is kept...\n");
+	ZitatList = BuildList();
+	reported = 0;
+	ZitatList = ZitatespuckerZitatDedup(ZitatList->nextZitat->nextZitat, ZITATESPUCKER_DUPLICATES_KEEP_FIRST, CountDuplicate, &reported, &duplicates);
+	assert(duplicates == 5 && reported == 5);
+	CheckComments(ZitatList, "axyfz");
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether the last duplicate can be kept instead...\n");
+	ZitatList = ZitatespuckerZitatDedup(BuildList(), ZITATESPUCKER_DUPLICATES_KEEP_LAST, NULL, NULL, &duplicates);
+	assert(duplicates == 5);
+	CheckComments(ZitatList, "xyzge");
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether duplicates can only be reported...\n");
+	reported = 0;
+	ZitatList = ZitatespuckerZitatDedup(BuildList(), ZITATESPUCKER_DUPLICATES_REPORT, CountDuplicate, &reported, &duplicates);
+	assert(duplicates == 5 && reported == 5);
+	CheckComments(ZitatList, "axbycfzgde");
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerSourceGetZitatAllFromFiles:\n");
+	printf("Checking whether a file merged with itself comes out once...\n");
+	const char *files[] = {"../../examples/example.json", "../../examples/example.json", "../testfile.json", "../testfile.sqlite"};
+	reported = 0;
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFiles(files, 2, ZITATESPUCKER_DUPLICATES_KEEP_FIRST, CountDuplicate, &reported);
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == 2 && reported == 2);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether .json and SQLite sources are merged...\n");
+	reported = 0;
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFiles(files + 2, 2, ZITATESPUCKER_DUPLICATES_KEEP_FIRST, CountDuplicate, &reported);
+	assert(ZitatList != NULL && reported >= 4 && ZitatespuckerZitatListLen(ZitatList) == 12 - reported);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether a missing file results in a NULL pointer...\n");
+	const char *missing[] = {"../testfile.json", "../doesnotexist.json"};
+	assert(ZitatespuckerSourceGetZitatAllFromFiles(missing, 2, ZITATESPUCKER_DUPLICATES_KEEP_FIRST, NULL, NULL) == NULL);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerZitatDedup (large list):\n");
+	printf("Checking whether half of %d elements are found to be duplicates...\n", LARGE_AMOUNT);
+	static char texts[LARGE_AMOUNT / 2][24];
+	ZitatespuckerZitat *last = NULL;
+	ZitatList = NULL;
+	for (size_t i = 0; i < LARGE_AMOUNT; i++) {
+		size_t n = (i < LARGE_AMOUNT / 2 ? i : (i * 7919) % (LARGE_AMOUNT / 2));
+		if (i < LARGE_AMOUNT / 2)
+			(void) snprintf(texts[n], sizeof(texts[n]), "Quote number %zu", n);
+		ZitatespuckerZitat *Zitat = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat));
+		assert(Zitat != NULL);
+		ZitatespuckerZitatInit(Zitat);
+		// the second copy gets a trailing space, so it only matches after normalizing
+		Zitat->zitat = (char *) malloc(sizeof(texts[n]) + 1);
+		assert(Zitat->zitat != NULL);
+		(void) snprintf(Zitat->zitat, sizeof(texts[n]) + 1, (i < LARGE_AMOUNT / 2 ? "%s" : "%s "), texts[n]);
+		Zitat->year = (uint16_t) (n % 2024);
+		Zitat->prevZitat = last;
+		if (last != NULL)
+			last->nextZitat = Zitat;
+		else
+			ZitatList = Zitat;
+		last = Zitat;
+	}
+	clock_t start = clock();
+	ZitatList = ZitatespuckerZitatDedup(ZitatList, ZITATESPUCKER_DUPLICATES_KEEP_FIRST, NULL, NULL, &duplicates);
+	double seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+	assert(duplicates == LARGE_AMOUNT / 2 && ZitatespuckerZitatListLen(ZitatList) == LARGE_AMOUNT / 2);
+	printf("%.0f ms\n", seconds * 1000);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
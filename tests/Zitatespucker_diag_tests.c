@@ -0,0 +1,306 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Diagnostics (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime(), dup() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#define ZITATESPUCKER_NDJSON
+#define ZITATESPUCKER_ASYNC
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define NDJSON_FILE		"diag_tests.ndjson"
+#define STDERR_FILE		"diag_tests_stderr.txt"
+#define LARGE_FILE		"diag_tests_large.json"
+#define LARGE_AMOUNT	200000
+
+
+/* What the test sink has seen */
+typedef struct SinkLog {
+	size_t errors;
+	size_t warnings;
+	size_t missingComment;
+	ZitatespuckerError lastError;
+	char lastMessage[256];
+	char lastFunction[64];
+} SinkLog;
+
+
+static void LogSink(const ZitatespuckerDiag *diag, void *userdata)
+{
+	SinkLog *log = (SinkLog *) userdata;
+
+	assert(diag->file != NULL && diag->function != NULL && diag->message != NULL);
+	if (diag->level == ZITATESPUCKER_LEVEL_ERROR) {
+		log->errors++;
+		log->lastError = diag->error;
+		(void) snprintf(log->lastMessage, sizeof(log->lastMessage), "%s", diag->message);
+		(void) snprintf(log->lastFunction, sizeof(log->lastFunction), "%s", diag->function);
+	} else {
+		log->warnings++;
+		if (diag->warning == ZITATESPUCKER_WARNING_MISSING && diag->key == ZITATESPUCKER_KEY_COMMENT)
+			log->missingComment++;
+	}
+}
+
+/* Sum of all counters within warnings */
+static size_t WarningTotal(const ZitatespuckerWarnings *warnings)
+{
+	size_t total = warnings->malformed;
+	for (size_t i = 0; i < ZITATESPUCKER_KEY_MAX; i++)
+		total += warnings->missing[i] + warnings->invalid[i];
+	return total;
+}
+
+static void *FailOnThread(void *arg)
+{
+	(void) arg;
+
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_NONE);
+	assert(ZitatespuckerJSONGetZitatSingleFromFile("../testfile.json", 100) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_RANGE);
+
+	ZitatespuckerWarnings warnings;
+	ZitatespuckerDiagGetWarnings(&warnings);
+	assert(WarningTotal(&warnings) == 0);
+
+	return NULL;
+}
+
+/* LARGE_AMOUNT elements without a comment */
+static void WriteLargeFile(void)
+{
+	FILE *file = fopen(LARGE_FILE, "w");
+	assert(file != NULL);
+	(void) fprintf(file, "{\"%s\": [\n", ZITATESPUCKERZITATKEYNAME);
+	for (size_t i = 0; i < LARGE_AMOUNT; i++)
+		(void) fprintf(file, "{\"author\": \"Author %zu\", \"zitat\": \"Quote number %zu\", \"day\": 1, \"month\": 1, \"year\": %zu, \"annodomini\": true}%s\n", i % 100, i, i % 2024, (i + 1 < LARGE_AMOUNT ? "," : ""));
+	(void) fprintf(file, "]}\n");
+	assert(fclose(file) == 0);
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerZitat *ZitatList;
+	ZitatespuckerWarnings warnings;
+
+	printf("ZitatespuckerDiag:\n");
+	printf("Checking whether nothing is written to stderr without a sink...\n");
+	(void) fflush(stderr);
+	int savedStderr = dup(STDERR_FILENO);
+	int captured = open(STDERR_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	assert(savedStderr >= 0 && captured >= 0);
+	assert(dup2(captured, STDERR_FILENO) >= 0);
+	ZitatList = ZitatespuckerJSONGetZitatAllFromFile("../testfile.json");
+	assert(ZitatList != NULL);
+	ZitatespuckerZitatFree(ZitatList);
+	assert(ZitatespuckerJSONGetZitatAllFromFile("../doesnotexist.json") == NULL);
+	assert(ZitatespuckerSQLGetZitatAllFromFileByAuthor("../testfile.sqlite", NULL) == NULL);
+	(void) fflush(stderr);
+	assert(dup2(savedStderr, STDERR_FILENO) >= 0);
+	(void) close(savedStderr);
+	assert(lseek(captured, 0, SEEK_END) == 0);
+	(void) close(captured);
+	(void) remove(STDERR_FILE);
+	printf("OKAY!\n\n");
+
+	printf("Checking the last error...\n");
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_NONE);
+	assert(strcmp(ZitatespuckerDiagGetLastMessage(), "") == 0);
+	assert(ZitatespuckerJSONGetZitatAllFromFile("../doesnotexist.json") == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_IO);
+	assert(strstr(ZitatespuckerDiagGetLastMessage(), "../doesnotexist.json") != NULL);
+	assert(strchr(ZitatespuckerDiagGetLastMessage(), '\n') == NULL);
+	assert(ZitatespuckerJSONGetZitatAllFromFile(NULL) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_ARGUMENT);
+	assert(ZitatespuckerSQLGetZitatAllFromFileByDate("../testfile.sqlite", false, 0, 0, 0) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_ARGUMENT);
+	assert(ZitatespuckerSQLGetZitatSingleFromFile("../testfile.sqlite", 1000) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_RANGE);
+	printf("Last error: %s (%s)\n", ZitatespuckerDiagGetLastMessage(), ZitatespuckerDiagErrorName(ZitatespuckerDiagGetLastError()));
+	// successful calls leave it alone
+	ZitatList = ZitatespuckerSQLGetZitatAllFromFile("../testfile.sqlite");
+	assert(ZitatList != NULL);
+	ZitatespuckerZitatFree(ZitatList);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_RANGE);
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_NONE);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether the last error and the warnings belong to the thread...\n");
+	ZitatespuckerDiagResetWarnings();
+	assert(ZitatespuckerJSONGetZitatAllFromFile("../doesnotexist.json") == NULL);
+	ZitatList = ZitatespuckerJSONGetZitatAllFromFile("../testfile.json");
+	pthread_t thread;
+	assert(pthread_create(&thread, NULL, FailOnThread, NULL) == 0);
+	assert(pthread_join(thread, NULL) == 0);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_IO);
+	ZitatespuckerDiagGetWarnings(&warnings);
+	assert(WarningTotal(&warnings) > 0);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+
+	printf("Checking the warnings counted while loading testfile.json...\n");
+	ZitatespuckerDiagResetWarnings();
+	ZitatespuckerDiagGetWarnings(&warnings);
+	assert(WarningTotal(&warnings) == 0);
+	ZitatList = ZitatespuckerJSONGetZitatAllFromFile("../testfile.json");
+	assert(ZitatespuckerZitatListLen(ZitatList) == 6);
+	ZitatespuckerZitatFree(ZitatList);
+	ZitatespuckerDiagGetWarnings(&warnings);
+	// the empty element lacks every key, none of them has a comment
+	assert(warnings.missing[ZITATESPUCKER_KEY_COMMENT] == 6);
+	assert(warnings.missing[ZITATESPUCKER_KEY_AUTHOR] == 1 && warnings.missing[ZITATESPUCKER_KEY_ZITAT] == 1);
+	assert(warnings.missing[ZITATESPUCKER_KEY_DAY] == 1 && warnings.missing[ZITATESPUCKER_KEY_MONTH] == 1);
+	assert(warnings.missing[ZITATESPUCKER_KEY_YEAR] == 1 && warnings.missing[ZITATESPUCKER_KEY_ANNODOMINI] == 1);
+	// the last one has strings for day and month
+	assert(warnings.invalid[ZITATESPUCKER_KEY_DAY] == 1 && warnings.invalid[ZITATESPUCKER_KEY_MONTH] == 1);
+	assert(warnings.invalid[ZITATESPUCKER_KEY_YEAR] == 0 && warnings.malformed == 0);
+	FILE *printed = tmpfile();
+	assert(printed != NULL);
+	assert(ZitatespuckerDiagPrintWarnings(&warnings, printed) == 9);
+	rewind(printed);
+	char line[128];
+	bool foundComment = false;
+	while (fgets(line, sizeof(line), printed) != NULL)
+		foundComment |= (strcmp(line, "records missing comment: 6\n") == 0);
+	assert(foundComment);
+	(void) fclose(printed);
+	printf("OKAY!\n\n");
+	printf("Checking whether only the fields asked for are counted...\n");
+	ZitatespuckerDiagResetWarnings();
+	ZitatList = ZitatespuckerJSONGetZitatAllFromFileFields("../testfile.json", ZITATESPUCKER_FIELD_AUTHOR);
+	ZitatespuckerZitatFree(ZitatList);
+	ZitatespuckerDiagGetWarnings(&warnings);
+	assert(warnings.missing[ZITATESPUCKER_KEY_AUTHOR] == 1 && WarningTotal(&warnings) == 1);
+	printf("OKAY!\n\n");
+	printf("Checking whether warnings add up...\n");
+	ZitatespuckerWarnings more = warnings;
+	more.malformed = 3;
+	ZitatespuckerDiagAddWarnings(&more);
+	ZitatespuckerDiagGetWarnings(&warnings);
+	assert(warnings.missing[ZITATESPUCKER_KEY_AUTHOR] == 2 && warnings.malformed == 3 && WarningTotal(&warnings) == 5);
+	assert(strcmp(ZitatespuckerDiagKeyName(ZITATESPUCKER_KEY_COMMENT), ZITATESPUCKERZITATCOMMENT) == 0);
+	assert(ZitatespuckerDiagKeyName(ZITATESPUCKER_KEY_MAX) == NULL);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether the threads of the JSON Lines backend hand over their warnings...\n");
+	FILE *file = fopen(NDJSON_FILE, "w");
+	assert(file != NULL);
+	for (size_t i = 0; i < 10000; i++) {
+		if (i % 1000 == 999)
+			(void) fprintf(file, "{\"author\": \"Broken\", \"zit\n");
+		else
+			(void) fprintf(file, "{\"author\": \"Author\", \"zitat\": \"Quote %zu\", \"year\": 2000, \"annodomini\": true}\n", i);
+	}
+	assert(fclose(file) == 0);
+	for (size_t threads = 1; threads <= 4; threads *= 2) {
+		ZitatespuckerDiagResetWarnings();
+		ZitatList = ZitatespuckerNDJSONGetZitatAllFromFileThreads(NDJSON_FILE, ZITATESPUCKER_FIELD_ALL, threads);
+		assert(ZitatespuckerZitatListLen(ZitatList) == 9990);
+		ZitatespuckerZitatFree(ZitatList);
+		ZitatespuckerDiagGetWarnings(&warnings);
+		assert(warnings.malformed == 10 && WarningTotal(&warnings) == 10);
+	}
+	(void) remove(NDJSON_FILE);
+	printf("OKAY!\n\n");
+	printf("Checking whether background loads hand over their warnings and errors...\n");
+	ZitatespuckerDiagResetWarnings();
+	ZitatespuckerAsync *handle = ZitatespuckerAsyncLoad("../testfile.json", ZITATESPUCKER_SOURCE_JSON, ZITATESPUCKER_FIELD_ALL);
+	assert(handle != NULL);
+	ZitatList = ZitatespuckerAsyncTakeList(handle);
+	assert(ZitatespuckerZitatListLen(ZitatList) == 6);
+	ZitatespuckerZitatFree(ZitatList);
+	ZitatespuckerDiagGetWarnings(&warnings);
+	assert(warnings.missing[ZITATESPUCKER_KEY_COMMENT] == 6);
+	ZitatespuckerDiagClear();
+	handle = ZitatespuckerAsyncLoad("../doesnotexist.json", ZITATESPUCKER_SOURCE_JSON, ZITATESPUCKER_FIELD_ALL);
+	assert(handle != NULL);
+	assert(ZitatespuckerAsyncTakeList(handle) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_IO);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerDiagSetSink:\n");
+	printf("Checking whether the sink gets every error and warning...\n");
+	SinkLog log;
+	(void) memset(&log, 0, sizeof(log));
+	ZitatespuckerDiagSetSink(LogSink, &log);
+	ZitatespuckerDiagResetWarnings();
+	ZitatList = ZitatespuckerJSONGetZitatAllFromFile("../testfile.json");
+	ZitatespuckerZitatFree(ZitatList);
+	ZitatespuckerDiagGetWarnings(&warnings);
+	assert(log.errors == 0 && log.warnings == WarningTotal(&warnings) && log.missingComment == 6);
+	assert(ZitatespuckerSQLGetZitatAllFromFileByAuthor("../testfile.sqlite", NULL) == NULL);
+	assert(log.errors == 1 && log.lastError == ZITATESPUCKER_ERROR_ARGUMENT);
+	assert(strcmp(log.lastMessage, ZitatespuckerDiagGetLastMessage()) == 0);
+	assert(strncmp(log.lastFunction, "ZitatespuckerSQL", strlen("ZitatespuckerSQL")) == 0);
+	ZitatespuckerDiagSetSink(NULL, NULL);
+	assert(ZitatespuckerJSONGetZitatAllFromFile(NULL) == NULL);
+	assert(log.errors == 1);
+	printf("OKAY!\n\n\n");
+
+	printf("Loading %d elements without a comment:\n", LARGE_AMOUNT);
+	WriteLargeFile();
+	ZitatespuckerDiagResetWarnings();
+	double start = Seconds();
+	ZitatList = ZitatespuckerJSONGetZitatAllFromFile(LARGE_FILE);
+	double counted = Seconds() - start;
+	assert(ZitatespuckerZitatListLen(ZitatList) == LARGE_AMOUNT);
+	ZitatespuckerZitatFree(ZitatList);
+	ZitatespuckerDiagGetWarnings(&warnings);
+	assert(warnings.missing[ZITATESPUCKER_KEY_COMMENT] == LARGE_AMOUNT && WarningTotal(&warnings) == LARGE_AMOUNT);
+	(void) ZitatespuckerDiagPrintWarnings(&warnings, stdout);
+	// what every load used to cost: a line on stderr per missing comment (sent to /dev/null here)
+	(void) fflush(stderr);
+	savedStderr = dup(STDERR_FILENO);
+	int devnull = open("/dev/null", O_WRONLY);
+	assert(savedStderr >= 0 && devnull >= 0);
+	assert(dup2(devnull, STDERR_FILENO) >= 0);
+	ZitatespuckerDiagSetSink(ZitatespuckerDiagStderr, NULL);
+	start = Seconds();
+	ZitatList = ZitatespuckerJSONGetZitatAllFromFile(LARGE_FILE);
+	double printing = Seconds() - start;
+	ZitatespuckerDiagSetSink(NULL, NULL);
+	(void) fflush(stderr);
+	assert(dup2(savedStderr, STDERR_FILENO) >= 0);
+	(void) close(savedStderr);
+	(void) close(devnull);
+	assert(ZitatespuckerZitatListLen(ZitatList) == LARGE_AMOUNT);
+	ZitatespuckerZitatFree(ZitatList);
+	(void) remove(LARGE_FILE);
+	printf("Counting only: %.0f ms, printing to stderr: %.0f ms\n", counted * 1000, printing * 1000);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,200 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Sources compiled into the program (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+
+
+/* Generated by 'make check' from testfile.json and testfile.sqlite */
+#include "embedded_json.h"
+#include "embedded_sql.h"
+
+
+/* Returns true if both strings are NULL, or equal */
+static bool SameString(const char *a, const char *b)
+{
+	return (a == NULL ? b == NULL : (b != NULL && strcmp(a, b) == 0));
+}
+
+/* Returns true if both lists hold the same elements in the same order */
+static bool SameList(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b)
+{
+	for (; a != NULL && b != NULL; a = a->nextZitat, b = b->nextZitat) {
+		if (ZitatespuckerZitatHash(a) != ZitatespuckerZitatHash(b) || !SameString(a->comment, b->comment))
+			return false;
+		if (a->nextZitat != NULL && a->nextZitat->prevZitat != a)
+			return false;
+	}
+
+	return (a == NULL && b == NULL);
+}
+
+/*
+	Returns true if ZitatList holds the elements of snapshot ZitatespuckerSnapshotFindByDate() finds, in order.
+	The backends are not asked for these, as the SQLite one compares annodomini as it is stored,
+	so the malformed row of testfile.sqlite would not match the date it is read with.
+*/
+static bool SameAsFindByDate(const ZitatespuckerZitat *ZitatList, const ZitatespuckerSnapshot *snapshot, bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	size_t idx = 0;
+	while ((idx = ZitatespuckerSnapshotFindByDate(snapshot, annodomini, year, month, day, idx)) != ZITATESPUCKER_SNAPSHOT_NONE) {
+		if (ZitatList == NULL || ZitatespuckerZitatHash(ZitatList) != ZitatespuckerZitatHash(ZitatespuckerSnapshotGet(snapshot, idx)))
+			return false;
+		ZitatList = ZitatList->nextZitat;
+		idx++;
+	}
+
+	return (ZitatList == NULL);
+}
+
+/* Check embed against what the backend reads from filename */
+static void CheckAgainst(const ZitatespuckerEmbed *embed, const char *filename)
+{
+	ZitatespuckerZitat *ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filename, ZITATESPUCKER_SOURCE_UNKNOWN);
+	ZitatespuckerSnapshot *snapshot = ZitatespuckerSnapshotFromList(ZitatList);
+	assert(ZitatList != NULL && snapshot != NULL);
+	size_t len = ZitatespuckerSnapshotLen(snapshot);
+
+	printf("Checking whether count, index and the accessors match...\n");
+	assert(ZitatespuckerEmbedGetAmount(embed) == len && ZitatespuckerEmbedGetAmount(NULL) == 0);
+	for (size_t i = 0; i < len; i++) {
+		const ZitatespuckerZitat *Zitat = ZitatespuckerSnapshotGet(snapshot, i);
+		assert(SameString(ZitatespuckerEmbedGetAuthor(embed, i), Zitat->author));
+		assert(SameString(ZitatespuckerEmbedGetZitatText(embed, i), Zitat->zitat));
+		assert(SameString(ZitatespuckerEmbedGetComment(embed, i), Zitat->comment));
+		bool annodomini;
+		uint16_t year;
+		uint8_t month, day;
+		assert(ZitatespuckerEmbedGetDate(embed, i, &annodomini, &year, &month, &day));
+		assert(annodomini == Zitat->annodomini && year == Zitat->year && month == Zitat->month && day == Zitat->day);
+		ZitatespuckerZitat *single = ZitatespuckerEmbedGetZitatSingle(embed, i);
+		assert(single != NULL && single->nextZitat == NULL && ZitatespuckerZitatHash(single) == ZitatespuckerZitatHash(Zitat) && SameString(single->comment, Zitat->comment));
+		ZitatespuckerZitatFree(single);
+	}
+	assert(ZitatespuckerEmbedGetAuthor(embed, len) == NULL && !ZitatespuckerEmbedGetDate(embed, len, NULL, NULL, NULL, NULL));
+	assert(ZitatespuckerEmbedGetZitatSingle(embed, len) == NULL);
+	ZitatespuckerZitat *all = ZitatespuckerEmbedGetZitatAll(embed);
+	assert(SameList(all, ZitatList));
+	ZitatespuckerZitatFree(all);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether by-author queries match the backend...\n");
+	for (size_t i = 0; i < len; i++) {
+		const char *author = ZitatespuckerSnapshotGet(snapshot, i)->author;
+		if (author == NULL)
+			continue;
+		ZitatespuckerZitat *expected = ZitatespuckerSourceGetZitatAllFromFileByAuthor(filename, ZITATESPUCKER_SOURCE_UNKNOWN, author);
+		ZitatespuckerZitat *got = ZitatespuckerEmbedGetZitatAllByAuthor(embed, author);
+		assert(SameList(got, expected));
+		assert(ZitatespuckerEmbedGetAmountByAuthor(embed, author) == ZitatespuckerZitatListLen(expected));
+		for (size_t from = 0; from <= len; from++)
+			assert(ZitatespuckerEmbedFindByAuthor(embed, author, from) == ZitatespuckerSnapshotFindByAuthor(snapshot, author, from));
+		ZitatespuckerZitatFree(got);
+		ZitatespuckerZitatFree(expected);
+	}
+	assert(ZitatespuckerEmbedGetZitatAllByAuthor(embed, "Nobody at all") == NULL);
+	assert(ZitatespuckerEmbedGetAmountByAuthor(embed, "Nobody at all") == 0 && ZitatespuckerEmbedGetAmountByAuthor(embed, NULL) == 0);
+	assert(ZitatespuckerEmbedFindByAuthor(embed, "Nobody at all", 0) == ZITATESPUCKER_EMBED_NONE);
+	assert(ZitatespuckerEmbedFindByAuthor(embed, NULL, 0) == ZITATESPUCKER_EMBED_NONE);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether by-date queries match ZitatespuckerSnapshotFindByDate()...\n");
+	for (size_t i = 0; i < len; i++) {
+		const ZitatespuckerZitat *Zitat = ZitatespuckerSnapshotGet(snapshot, i);
+		// the full date, then with the day and the month left open
+		const uint8_t days[] = {Zitat->day, 0, 0};
+		const uint8_t months[] = {Zitat->month, Zitat->month, 0};
+		for (int j = 0; j < 3; j++) {
+			ZitatespuckerZitat *got = ZitatespuckerEmbedGetZitatAllByDate(embed, Zitat->annodomini, Zitat->year, months[j], days[j]);
+			if (Zitat->year == 0 && !Zitat->annodomini)
+				assert(got == NULL && ZitatespuckerEmbedGetAmountByDate(embed, false, 0, months[j], days[j]) == 0);
+			else
+				assert(SameAsFindByDate(got, snapshot, Zitat->annodomini, Zitat->year, months[j], days[j]));
+			assert(ZitatespuckerEmbedGetAmountByDate(embed, Zitat->annodomini, Zitat->year, months[j], days[j]) == ZitatespuckerZitatListLen(got));
+			for (size_t from = 0; from <= len; from++)
+				assert(ZitatespuckerEmbedFindByDate(embed, Zitat->annodomini, Zitat->year, months[j], days[j], from) == ZitatespuckerSnapshotFindByDate(snapshot, Zitat->annodomini, Zitat->year, months[j], days[j], from));
+			ZitatespuckerZitatFree(got);
+		}
+	}
+	ZitatespuckerZitat *expected = ZitatespuckerSourceGetZitatAllFromFileByDate(filename, ZITATESPUCKER_SOURCE_UNKNOWN, true, 2022, 3, 21);
+	ZitatespuckerZitat *got = ZitatespuckerEmbedGetZitatAllByDate(embed, true, 2022, 3, 21);
+	assert(expected != NULL && SameList(got, expected));
+	ZitatespuckerZitatFree(got);
+	ZitatespuckerZitatFree(expected);
+	assert(ZitatespuckerEmbedGetZitatAllByDate(embed, true, 2022, 0, 21) == NULL);
+	assert(ZitatespuckerEmbedGetZitatAllByDate(embed, true, 9999, 0, 0) == NULL);
+	assert(ZitatespuckerEmbedFindByDate(embed, true, 9999, 0, 0, 0) == ZITATESPUCKER_EMBED_NONE);
+	printf("OKAY!\n\n\n");
+
+	ZitatespuckerSnapshotRelease(snapshot);
+	ZitatespuckerZitatFree(ZitatList);
+}
+
+int main(int argc, char **argv)
+{
+	printf("ZitatespuckerEmbed (testfile.json):\n");
+	CheckAgainst(&ZitatespuckerTestJSON, "../testfile.json");
+	printf("ZitatespuckerEmbed (testfile.sqlite):\n");
+	CheckAgainst(&ZitatespuckerTestSQL, "../testfile.sqlite");
+
+	printf("ZitatespuckerEmbedWrite:\n");
+	printf("Checking whether bad arguments are refused...\n");
+	ZitatespuckerZitat Zitat;
+	ZitatespuckerZitatInit(&Zitat);
+	FILE *file = tmpfile();
+	assert(file != NULL);
+	assert(!ZitatespuckerEmbedWrite(NULL, "name", file, NULL));
+	assert(!ZitatespuckerEmbedWrite(&Zitat, NULL, file, NULL));
+	assert(!ZitatespuckerEmbedWrite(&Zitat, "name", NULL, NULL));
+	assert(!ZitatespuckerEmbedWrite(&Zitat, "1name", file, NULL));
+	assert(!ZitatespuckerEmbedWrite(&Zitat, "na-me", file, NULL));
+	assert(!ZitatespuckerEmbedWrite(&Zitat, "", file, NULL));
+	printf("OKAY!\n\n");
+	printf("Checking whether strings are escaped and written once...\n");
+	char author[] = "Quote \"Marks\" \\ ?? \xC3\xA4\n1";
+	char zitat[] = "Quote \"Marks\" \\ ?? \xC3\xA4\n1";
+	Zitat.author = author;
+	Zitat.zitat = zitat;
+	assert(ZitatespuckerEmbedWrite(&Zitat, "_Escaped1", file, NULL));
+	long size = ftell(file);
+	assert(size > 0);
+	rewind(file);
+	char *buf = (char *) malloc((size_t) size + 1);
+	assert(buf != NULL && fread(buf, 1, (size_t) size, file) == (size_t) size);
+	buf[size] = '\0';
+	const char *escaped = "\"Quote \\\"Marks\\\" \\\\ \\?\\? \\303\\244\\0121\\0\"";
+	char *first = strstr(buf, escaped);
+	assert(first != NULL && strstr(first + 1, escaped) == NULL);
+	assert(strstr(buf, "{0, 0, ZITATESPUCKER_EMBED_NOSTRING, 0, 0, 0, false}") != NULL);
+	assert(strstr(buf, "const ZitatespuckerEmbed _Escaped1 = {1, ") != NULL);
+	free((void *) buf);
+	(void) fclose(file);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,110 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Writing quotes as .json (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerExport *exporter;
+	ZitatespuckerZitat *ZitatList;
+	char *buffer;
+	size_t len;
+
+	printf("ZitatespuckerExportToBuffer:\n");
+	printf("Checking whether an empty document is well-formed...\n");
+	exporter = ZitatespuckerExportToBuffer();
+	assert(exporter != NULL);
+	assert(ZitatespuckerExportFinish(exporter, &buffer, &len));
+	assert(strcmp(buffer, "{\n\t\"ZitatespuckerZitat\": [\n\t]\n}\n") == 0 && len == strlen(buffer));
+	free((void *) buffer);
+	printf("OKAY!\n\n");
+	printf("Checking whether strings are escaped and NULL fields left out...\n");
+	ZitatespuckerZitat Zitat;
+	ZitatespuckerZitatInit(&Zitat);
+	Zitat.zitat = "\"Quote\"\\\n\t\x01 \xc3\x96";
+	Zitat.year = 44;
+	exporter = ZitatespuckerExportToBuffer();
+	assert(ZitatespuckerExportAdd(exporter, &Zitat));
+	assert(ZitatespuckerExportFinish(exporter, &buffer, NULL));
+	assert(strstr(buffer, "\"zitat\": \"\\\"Quote\\\"\\\\\\n\\t\\u0001 \xc3\x96\",") != NULL);
+	assert(strstr(buffer, "\"author\"") == NULL && strstr(buffer, "\"comment\"") == NULL);
+	assert(strstr(buffer, "\"year\": 44,\n\t\t\t\"annodomini\": false\n") != NULL);
+	free((void *) buffer);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerExportToFile:\n");
+	printf("Checking whether an exported list reads back the same...\n");
+	ZitatList = ZitatespuckerSQLGetZitatAllFromFile("../testfile.sqlite");
+	assert(ZitatList != NULL);
+	FILE *file = fopen("export.json", "wb");
+	assert(file != NULL);
+	exporter = ZitatespuckerExportToFile(file);
+	assert(ZitatespuckerExportAddList(exporter, ZitatList));
+	assert(ZitatespuckerExportFinish(exporter, NULL, NULL));
+	(void) fclose(file);
+	ZitatespuckerZitat *ZitatRead = ZitatespuckerJSONGetZitatAllFromFile("export.json");
+	assert(ZitatespuckerZitatListLen(ZitatRead) == ZitatespuckerZitatListLen(ZitatList));
+	for (ZitatespuckerZitat *a = ZitatList, *b = ZitatRead; a != NULL; a = a->nextZitat, b = b->nextZitat) {
+		assert((a->zitat == NULL && b->zitat == NULL) || strcmp(a->zitat, b->zitat) == 0);
+		assert((a->author == NULL && b->author == NULL) || strcmp(a->author, b->author) == 0);
+		assert(a->year == b->year && a->month == b->month && a->day == b->day && a->annodomini == b->annodomini);
+	}
+	ZitatespuckerZitatFree(ZitatRead);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerExportToFd:\n");
+	printf("Checking whether a snapshot large enough to need several flushes comes out whole...\n");
+	ZitatespuckerSnapshot *snapshot = ZitatespuckerSnapshotFromList(ZitatList);
+	exporter = ZitatespuckerExportToBuffer();
+	for (int i = 0; i < 2000; i++)
+		assert(ZitatespuckerExportAddSnapshot(exporter, snapshot));
+	assert(ZitatespuckerExportFinish(exporter, &buffer, &len));
+	file = fopen("export.json", "wb");
+	assert(file != NULL);
+	exporter = ZitatespuckerExportToFd(fileno(file));
+	for (int i = 0; i < 2000; i++)
+		assert(ZitatespuckerExportAddSnapshot(exporter, snapshot));
+	assert(ZitatespuckerExportFinish(exporter, NULL, NULL));
+	(void) fclose(file);
+	assert(len > ZITATESPUCKER_EXPORT_BUFSIZE);
+	file = fopen("export.json", "rb");
+	char *written = (char *) malloc(len + 1);
+	assert(file != NULL && written != NULL && fread(written, 1, len + 1, file) == len && memcmp(written, buffer, len) == 0);
+	(void) fclose(file);
+	assert(ZitatespuckerJSONGetAmountFromFile("export.json") == 2000 * ZitatespuckerSnapshotLen(snapshot));
+	free((void *) written);
+	free((void *) buffer);
+	ZitatespuckerSnapshotRelease(snapshot);
+	ZitatespuckerZitatFree(ZitatList);
+	(void) remove("export.json");
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
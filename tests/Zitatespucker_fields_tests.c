@@ -0,0 +1,126 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Loading only some fields (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+
+
+/* Check that string is full if field is within fields, and NULL otherwise */
+static void CheckString(const char *string, const char *full, ZitatespuckerFields fields, ZitatespuckerFields field)
+{
+	if (!(fields & field))
+		assert(string == NULL);
+	else if (full == NULL)
+		assert(string == NULL);
+	else
+		assert(string != NULL && strcmp(string, full) == 0);
+}
+
+/* Check that the list partial holds the fields within fields of the list full, and nothing else */
+static void CheckPartial(const ZitatespuckerZitat *partial, const ZitatespuckerZitat *full, ZitatespuckerFields fields)
+{
+	for (; full != NULL; full = full->nextZitat, partial = partial->nextZitat) {
+		assert(partial != NULL);
+		CheckString(partial->author, full->author, fields, ZITATESPUCKER_FIELD_AUTHOR);
+		CheckString(partial->zitat, full->zitat, fields, ZITATESPUCKER_FIELD_ZITAT);
+		CheckString(partial->comment, full->comment, fields, ZITATESPUCKER_FIELD_COMMENT);
+		if (fields & ZITATESPUCKER_FIELD_DATE)
+			assert(partial->day == full->day && partial->month == full->month && partial->year == full->year && partial->annodomini == full->annodomini);
+		else
+			assert(partial->day == 0 && partial->month == 0 && partial->year == 0 && !partial->annodomini);
+	}
+	assert(partial == NULL);
+}
+
+/* Check every combination of fields for every way of loading filename */
+static void CheckFile(const char *filename, const char *authorname)
+{
+	ZitatespuckerZitat *full = ZitatespuckerSourceGetZitatAllFromFile(filename, ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(full != NULL);
+	ZitatespuckerZitat *fullAuthor = ZitatespuckerSourceGetZitatAllFromFileByAuthor(filename, ZITATESPUCKER_SOURCE_UNKNOWN, authorname);
+	assert(fullAuthor != NULL);
+	ZitatespuckerZitat *fullDate = ZitatespuckerSourceGetZitatAllFromFileByDate(filename, ZITATESPUCKER_SOURCE_UNKNOWN, full->annodomini, full->year, 0, 0);
+	assert(fullDate != NULL);
+	ZitatespuckerZitat *fullSingle = ZitatespuckerSourceGetZitatSingleFromFile(filename, ZITATESPUCKER_SOURCE_UNKNOWN, 1);
+	assert(fullSingle != NULL);
+
+	for (ZitatespuckerFields fields = 0; fields <= ZITATESPUCKER_FIELD_ALL; fields++) {
+		ZitatespuckerZitat *partial;
+
+		partial = ZitatespuckerSourceGetZitatAllFromFileFields(filename, ZITATESPUCKER_SOURCE_UNKNOWN, fields);
+		CheckPartial(partial, full, fields);
+		ZitatespuckerZitatFree(partial);
+
+		partial = ZitatespuckerSourceGetZitatAllFromFileByAuthorFields(filename, ZITATESPUCKER_SOURCE_UNKNOWN, authorname, fields);
+		CheckPartial(partial, fullAuthor, fields);
+		ZitatespuckerZitatFree(partial);
+
+		partial = ZitatespuckerSourceGetZitatAllFromFileByDateFields(filename, ZITATESPUCKER_SOURCE_UNKNOWN, full->annodomini, full->year, 0, 0, fields);
+		CheckPartial(partial, fullDate, fields);
+		ZitatespuckerZitatFree(partial);
+
+		partial = ZitatespuckerSourceGetZitatSingleFromFileFields(filename, ZITATESPUCKER_SOURCE_UNKNOWN, 1, fields);
+		CheckPartial(partial, fullSingle, fields);
+		ZitatespuckerZitatFree(partial);
+	}
+
+	ZitatespuckerZitatFree(fullSingle);
+	ZitatespuckerZitatFree(fullDate);
+	ZitatespuckerZitatFree(fullAuthor);
+	ZitatespuckerZitatFree(full);
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerZitat *ZitatList;
+
+	printf("ZitatespuckerSourceGetZitatAllFromFileFields:\n");
+	printf("Checking whether a NULL filename results in a NULL pointer...\n");
+	assert(ZitatespuckerJSONGetZitatAllFromFileFields(NULL, ZITATESPUCKER_FIELD_ALL) == NULL);
+	assert(ZitatespuckerSQLGetZitatAllFromFileFields(NULL, ZITATESPUCKER_FIELD_ALL) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether loading only the author and date leaves the text out...\n");
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFileFields("../../examples/example.json", ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_FIELD_AUTHOR | ZITATESPUCKER_FIELD_DATE);
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == 2);
+	assert(strcmp(ZitatList->author, "TestAuthor") == 0 && ZitatList->year == 2024 && ZitatList->annodomini);
+	assert(ZitatList->zitat == NULL && ZitatList->comment == NULL);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether no fields at all still yields every element...\n");
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFileFields("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN, 0);
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == ZitatespuckerSourceGetAmountFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN));
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether every combination of fields matches loading everything...\n");
+	CheckFile("../testfile.json", "Ein Esel");
+	CheckFile("../testfile.sqlite", "Ein Esel");
+	CheckFile("../../examples/example.json", "TestAuthor2");
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
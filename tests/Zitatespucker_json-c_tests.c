@@ -20,6 +20,7 @@
 /* Standard headers */
 #include <stdio.h>
 #include <assert.h>
+#include <string.h>
 
 
 /* Zitatespucker */
@@ -27,6 +28,17 @@
 #include "../Zitatespucker/Zitatespucker.h"
 
 
+static bool CountCallback(const ZitatespuckerZitat *Zitat, void *userdata)
+{
+	(*(size_t *) userdata)++;
+	return (Zitat->nextZitat == NULL && Zitat->prevZitat == NULL);
+}
+
+static bool StopCallback(const ZitatespuckerZitat *Zitat, void *userdata)
+{
+	return false;
+}
+
 int main(int argc, char **argv)
 {
 	printf("ZitatespuckerJSONGetAmountFromFile:\n");
@@ -52,5 +64,29 @@ int main(int argc, char **argv)
 	assert(ZitatespuckerJSONGetZitatAllFromFile("../testfile_noarray.json") == NULL);
 	printf("OKAY!\n\n\n");
 
+	printf("ZitatespuckerJSONGetZitatAllFromFileByAuthor:\n");
+	printf("Checking whether a NULL authorname results in a NULL pointer...\n");
+	assert(ZitatespuckerJSONGetZitatAllFromFileByAuthor("../testfile.json", NULL) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether only matching entries are returned...\n");
+	ZitatespuckerZitat *ZitatList = ZitatespuckerJSONGetZitatAllFromFileByAuthor("../testfile.json", "Ein Esel");
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == 1 && strcmp(ZitatList->author, "Ein Esel") == 0);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerJSONGetZitatAllFromFileByDate:\n");
+	printf("Checking whether day != 0 && month == 0 results in a NULL pointer...\n");
+	assert(ZitatespuckerJSONGetZitatAllFromFileByDate("../testfile.json", true, 0, 0, 1) == NULL);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerJSONForEachFromFile:\n");
+	printf("Checking whether every element is passed on, one at a time...\n");
+	size_t calls = 0;
+	assert(ZitatespuckerJSONForEachFromFile("../../examples/example.json", CountCallback, &calls) == 2 && calls == 2);
+	printf("OKAY!\n\n");
+	printf("Checking whether returning false stops...\n");
+	assert(ZitatespuckerJSONForEachFromFile("../../examples/example.json", StopCallback, NULL) == 1);
+	printf("OKAY!\n\n\n");
+
 	printf("ALL CHECKS PASSED!\n\n\n\n\n");
 }
@@ -0,0 +1,263 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Index files for reading single elements of .json files (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* clock_gettime(), utime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define COPYNAME	"jsonindex_testfile.json"
+#define TRICKYNAME	"jsonindex_tricky.json"
+#define LARGENAME	"jsonindex_large.json"
+#define LARGE_AMOUNT	20000
+
+
+/* Brackets and quotes within strings, comments, other keys (holding arrays) around the array, and the array twice (the last one counts) */
+static const char tricky[] =
+	"// json-c reads comments, so the index has to skip them\n"
+	"{\n"
+	"\t\"ZitatespuckerZitat\": [{\"author\": \"Early\"}],\n"
+	"\t\"other\": {\"list\": [1, 2, [3]], \"text\": \"]}\"},\n"
+	"\t\"ZitatespuckerZitat\" /* here it comes */ : [\n"
+	"\t\t{\"author\": \"Brackets ] } [ {\", \"zitat\": \"A \\\"quoted\\\" \\\\ word\", \"year\": 1, \"annodomini\": true},\n"
+	"\t\t{\"author\": \"Nested\", \"zitat\": \"x\", \"comment\": \"c\", \"extra\": {\"a\": [{}, []]}, \"year\": 2, \"annodomini\": false},\n"
+	"\t\t{}\n"
+	"\t],\n"
+	"\t\"after\": [\"ZitatespuckerZitat\"]\n"
+	"}\n";
+
+
+static void WriteFile(const char *filename, const char *content, size_t len)
+{
+	FILE *file = fopen(filename, "wb");
+	assert(file != NULL);
+	assert(fwrite(content, 1, len, file) == len);
+	assert(fclose(file) == 0);
+}
+
+static char *ReadFile(const char *filename, size_t *len)
+{
+	FILE *file = fopen(filename, "rb");
+	assert(file != NULL);
+	assert(fseek(file, 0, SEEK_END) == 0);
+	long filelen = ftell(file);
+	assert(filelen >= 0 && fseek(file, 0, SEEK_SET) == 0);
+	char *ret = (char *) malloc((size_t) filelen + 1);
+	assert(ret != NULL);
+	*len = fread(ret, 1, (size_t) filelen, file);
+	ret[*len] = '\0';
+	(void) fclose(file);
+
+	return ret;
+}
+
+static bool SameString(const char *a, const char *b)
+{
+	return (a == NULL ? b == NULL : (b != NULL && strcmp(a, b) == 0));
+}
+
+static bool SameZitat(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b)
+{
+	return (SameString(a->author, b->author) && SameString(a->zitat, b->zitat) && SameString(a->comment, b->comment)
+	&& a->authorLen == b->authorLen && a->zitatLen == b->zitatLen && a->commentLen == b->commentLen && a->authorHash == b->authorHash
+	&& a->day == b->day && a->month == b->month && a->year == b->year && a->annodomini == b->annodomini);
+}
+
+/* Whether every element read on its own (through the index, if there is one) is the same as the one in the whole list */
+static bool SameAsList(const char *filename)
+{
+	ZitatespuckerZitat *ZitatList = ZitatespuckerJSONGetZitatAllFromFile(filename);
+	if (ZitatList == NULL || ZitatespuckerJSONGetAmountFromFile(filename) != ZitatespuckerZitatListLen(ZitatList))
+		return false;
+
+	bool ret = true;
+	size_t idx = 0;
+	for (ZitatespuckerZitat *cur = ZitatList; cur != NULL && ret; cur = cur->nextZitat, idx++) {
+		ZitatespuckerZitat *single = ZitatespuckerJSONGetZitatSingleFromFile(filename, idx);
+		ret = (single != NULL && SameZitat(single, cur));
+		ZitatespuckerZitatFree(single);
+	}
+	ZitatespuckerZitatFree(ZitatList);
+
+	return ret;
+}
+
+
+int main(void)
+{
+	size_t len;
+	char *content = ReadFile("../testfile.json", &len);
+	WriteFile(COPYNAME, content, len);
+	(void) remove(COPYNAME ZITATESPUCKER_JSON_INDEX_SUFFIX);
+
+	printf("ZitatespuckerJSONIndexBuild:\n");
+	printf("Checking whether files that cannot be indexed are refused...\n");
+	assert(!ZitatespuckerJSONIndexBuild(NULL) && ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_ARGUMENT);
+	assert(!ZitatespuckerJSONIndexBuild("wrongfilename.json") && ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_IO);
+	assert(!ZitatespuckerJSONIndexBuild("../testfile_noarray.json") && ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_FORMAT);
+	WriteFile("jsonindex_broken.json", content, len / 2);
+	assert(!ZitatespuckerJSONIndexBuild("jsonindex_broken.json") && ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_FORMAT);
+	WriteFile("jsonindex_broken.json", "{\"ZitatespuckerZitat\": {}}", strlen("{\"ZitatespuckerZitat\": {}}"));
+	assert(!ZitatespuckerJSONIndexBuild("jsonindex_broken.json") && ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_FORMAT);
+	FILE *file = fopen("jsonindex_broken.json" ZITATESPUCKER_JSON_INDEX_SUFFIX, "rb");
+	assert(file == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether files without an index are read as before...\n");
+	assert(!ZitatespuckerJSONIndexGetAmount(COPYNAME, &len));
+	char *element;
+	assert(!ZitatespuckerJSONIndexGetElement(COPYNAME, 0, &element, &len));
+	assert(SameAsList(COPYNAME));
+	printf("OKAY!\n\n");
+	printf("Checking whether the index records every element...\n");
+	assert(ZitatespuckerJSONIndexBuild(COPYNAME));
+	size_t amount;
+	assert(ZitatespuckerJSONIndexGetAmount(COPYNAME, &amount) && amount == ZitatespuckerJSONGetAmountFromFile("../testfile.json"));
+	for (size_t i = 0; i < amount; i++) {
+		assert(ZitatespuckerJSONIndexGetElement(COPYNAME, i, &element, &len) && element != NULL);
+		assert(len >= 2 && element[0] == '{' && element[len - 1] == '}' && strlen(element) == len);
+		free((void *) element);
+	}
+	printf("OKAY!\n\n");
+	printf("Checking whether elements read through the index are the same as the ones of the whole file...\n");
+	assert(SameAsList(COPYNAME));
+	ZitatespuckerZitat *single = ZitatespuckerJSONGetZitatSingleFromFileFields(COPYNAME, 0, ZITATESPUCKER_FIELD_AUTHOR);
+	assert(single != NULL && strcmp(single->author, "Linus Torvalds") == 0 && single->zitat == NULL && single->year == 0);
+	ZitatespuckerZitatFree(single);
+	printf("OKAY!\n\n");
+	printf("Checking whether an index out of range is still an error...\n");
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerJSONIndexGetElement(COPYNAME, amount, &element, &len) && element == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_RANGE);
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerJSONGetZitatSingleFromFile(COPYNAME, amount) == NULL && ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_RANGE);
+	printf("OKAY!\n\n");
+	printf("Checking whether strings, comments and other keys do not confuse it...\n");
+	WriteFile(TRICKYNAME, tricky, sizeof(tricky) - 1);
+	assert(ZitatespuckerJSONIndexBuild(TRICKYNAME));
+	assert(ZitatespuckerJSONIndexGetAmount(TRICKYNAME, &amount) && amount == 3);
+	assert(SameAsList(TRICKYNAME));
+	single = ZitatespuckerJSONGetZitatSingleFromFile(TRICKYNAME, 0);
+	assert(single != NULL && strcmp(single->author, "Brackets ] } [ {") == 0 && strcmp(single->zitat, "A \"quoted\" \\ word") == 0);
+	ZitatespuckerZitatFree(single);
+	assert(ZitatespuckerJSONIndexGetElement(TRICKYNAME, 2, &element, &len) && strcmp(element, "{}") == 0);
+	free((void *) element);
+	printf("OKAY!\n\n\n");
+
+	printf("Stale indexes:\n");
+	printf("Checking whether a file that grew is parsed as a whole...\n");
+	content = (char *) realloc(content, strlen(content) + 2);
+	assert(content != NULL);
+	(void) strcat(content, "\n");
+	WriteFile(COPYNAME, content, strlen(content));
+	assert(!ZitatespuckerJSONIndexGetAmount(COPYNAME, &amount));
+	assert(!ZitatespuckerJSONIndexGetElement(COPYNAME, 0, &element, &len));
+	assert(SameAsList(COPYNAME));
+	printf("OKAY!\n\n");
+	printf("Checking whether a file changed in place (same size, other modification time) is parsed as a whole...\n");
+	assert(ZitatespuckerJSONIndexBuild(COPYNAME) && ZitatespuckerJSONIndexGetAmount(COPYNAME, &amount));
+	// keep the size, so only the modification time tells
+	char *moved = strstr(content, "\"Linus Torvalds\"");
+	assert(moved != NULL);
+	(void) memcpy(moved, "\"Linus_Torvalds\"", 16);
+	WriteFile(COPYNAME, content, strlen(content));
+	struct stat st;
+	assert(stat(COPYNAME, &st) == 0);
+	struct utimbuf times = {st.st_atime, st.st_mtime + 10};
+	assert(utime(COPYNAME, &times) == 0);
+	assert(!ZitatespuckerJSONIndexGetAmount(COPYNAME, &amount));
+	single = ZitatespuckerJSONGetZitatSingleFromFile(COPYNAME, 0);
+	assert(single != NULL && strcmp(single->author, "Linus_Torvalds") == 0);
+	ZitatespuckerZitatFree(single);
+	printf("OKAY!\n\n");
+	printf("Checking whether a damaged index is ignored...\n");
+	assert(ZitatespuckerJSONIndexBuild(COPYNAME) && ZitatespuckerJSONIndexGetAmount(COPYNAME, &amount));
+	size_t indexLen;
+	char *index = ReadFile(COPYNAME ZITATESPUCKER_JSON_INDEX_SUFFIX, &indexLen);
+	WriteFile(COPYNAME ZITATESPUCKER_JSON_INDEX_SUFFIX, index, indexLen - 1);
+	assert(!ZitatespuckerJSONIndexGetAmount(COPYNAME, &amount));
+	assert(SameAsList(COPYNAME));
+	index[0] = 'X';
+	WriteFile(COPYNAME ZITATESPUCKER_JSON_INDEX_SUFFIX, index, indexLen);
+	assert(!ZitatespuckerJSONIndexGetAmount(COPYNAME, &amount));
+	free((void *) index);
+	printf("OKAY!\n\n");
+	printf("Checking whether building it again makes it count again...\n");
+	assert(ZitatespuckerJSONIndexBuild(COPYNAME) && ZitatespuckerJSONIndexGetAmount(COPYNAME, &amount));
+	assert(amount == ZitatespuckerSourceGetAmountFromFile(COPYNAME, ZITATESPUCKER_SOURCE_UNKNOWN));
+	printf("OKAY!\n\n\n");
+	free((void *) content);
+
+	printf("Reading single elements of a large file (%d elements):\n", LARGE_AMOUNT);
+	printf("Checking whether the index makes them faster...\n");
+	file = fopen(LARGENAME, "wb");
+	assert(file != NULL);
+	(void) fprintf(file, "{\"ZitatespuckerZitat\": [\n");
+	for (int i = 0; i < LARGE_AMOUNT; i++)
+		(void) fprintf(file, "\t{\"author\": \"Author %d\", \"zitat\": \"Quote number %d, which says nothing at all.\", \"comment\": \"\", \"day\": %d, \"month\": %d, \"year\": %d, \"annodomini\": true}%s\n",
+		i % 100, i, i % 28 + 1, i % 12 + 1, 1000 + i % 1000, (i + 1 < LARGE_AMOUNT ? "," : ""));
+	(void) fprintf(file, "]}\n");
+	assert(fclose(file) == 0);
+	(void) remove(LARGENAME ZITATESPUCKER_JSON_INDEX_SUFFIX);
+	double start = Seconds();
+	for (size_t i = 0; i < 5; i++) {
+		single = ZitatespuckerJSONGetZitatSingleFromFile(LARGENAME, i * (LARGE_AMOUNT / 5));
+		assert(single != NULL);
+		ZitatespuckerZitatFree(single);
+	}
+	double without = (Seconds() - start) / 5;
+	start = Seconds();
+	assert(ZitatespuckerJSONIndexBuild(LARGENAME));
+	double build = Seconds() - start;
+	start = Seconds();
+	for (size_t i = 0; i < 1000; i++) {
+		single = ZitatespuckerJSONGetZitatSingleFromFile(LARGENAME, (i * 7919) % LARGE_AMOUNT);
+		assert(single != NULL && single->year == 1000 + (i * 7919) % LARGE_AMOUNT % 1000);
+		ZitatespuckerZitatFree(single);
+	}
+	double with = (Seconds() - start) / 1000;
+	assert(ZitatespuckerJSONGetAmountFromFile(LARGENAME) == LARGE_AMOUNT);
+	printf("building the index: %.1f ms; a single element: %.3f ms without the index, %.3f ms with it\n", build * 1000, without * 1000, with * 1000);
+	assert(with < without);
+	printf("OKAY!\n\n\n");
+
+	(void) remove(COPYNAME);
+	(void) remove(COPYNAME ZITATESPUCKER_JSON_INDEX_SUFFIX);
+	(void) remove(TRICKYNAME);
+	(void) remove(TRICKYNAME ZITATESPUCKER_JSON_INDEX_SUFFIX);
+	(void) remove(LARGENAME);
+	(void) remove(LARGENAME ZITATESPUCKER_JSON_INDEX_SUFFIX);
+	(void) remove("jsonindex_broken.json");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,236 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Lengths and author hashes filled in by the backends (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#define ZITATESPUCKER_NDJSON
+#define ZITATESPUCKER_CSV
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define NDJSON_FILE		"lengths_tests.ndjson"
+#define CSV_FILE		"lengths_tests.csv"
+#define LARGE_AMOUNT	1000000
+#define LARGE_AUTHORS	64
+
+
+static const char ndjsonContent[] =
+	"{\"author\": \"Caf\\u00e9 Owner\", \"zitat\": \"Tab\\there\", \"comment\": \"\\ud83d\\ude00\", \"year\": 2000, \"annodomini\": true}\n"
+	"{\"author\": \"Nul\\u0000Byte\", \"zitat\": \"Before\\u0000After\", \"year\": 1, \"annodomini\": true}\n"
+	"{\"zitat\": \"No author\", \"comment\": \"\"}\n"
+	"{\"author\": \"Caf\\u00e9 Owner\", \"zitat\": \"Again\"}\n";
+
+static const char csvContent[] =
+	"author,zitat,comment,year,annodomini\n"
+	"\"Quoted, Author\",\"Said \"\"this\"\"\",,100,true\n"
+	"Plain,Text,A comment,200,false\n"
+	",No author,,300,true\n"
+	"\"Quoted, Author\",Twice,,400,true\n";
+
+
+static void WriteFile(const char *filename, const char *content)
+{
+	FILE *file = fopen(filename, "wb");
+	assert(file != NULL);
+	assert(fwrite(content, 1, strlen(content), file) == strlen(content));
+	assert(fclose(file) == 0);
+}
+
+/* Check that len is strlen(string), 0 for NULL */
+static void CheckLen(const char *string, size_t len)
+{
+	assert(len == (string != NULL ? strlen(string) : 0));
+}
+
+/* Check every element of ZitatList for lengths and author hashes that match its strings, and that are all known */
+static void CheckList(const ZitatespuckerZitat *ZitatList, size_t expected)
+{
+	size_t len = 0;
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat, len++) {
+		CheckLen(cur->author, cur->authorLen);
+		CheckLen(cur->zitat, cur->zitatLen);
+		CheckLen(cur->comment, cur->commentLen);
+		if (cur->author != NULL)
+			assert(cur->authorHash != 0 && cur->authorHash == ZitatespuckerAuthorHash(cur->author, strlen(cur->author)));
+		else
+			assert(cur->authorHash == 0);
+	}
+	assert(len == expected);
+}
+
+/* Check that filtering by every author of ZitatList yields as many elements as counting them by strcmp() */
+static void CheckByAuthor(const char *filename, const ZitatespuckerZitat *ZitatList)
+{
+	for (const ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat) {
+		if (cur->author == NULL)
+			continue;
+		size_t expected = 0;
+		for (const ZitatespuckerZitat *other = ZitatList; other != NULL; other = other->nextZitat)
+			expected += (other->author != NULL && strcmp(other->author, cur->author) == 0);
+
+		ZitatespuckerZitat *byAuthor = ZitatespuckerSourceGetZitatAllFromFileByAuthor(filename, ZITATESPUCKER_SOURCE_UNKNOWN, cur->author);
+		CheckList(byAuthor, expected);
+		ZitatespuckerZitatFree(byAuthor);
+	}
+}
+
+
+int main(void)
+{
+	ZitatespuckerZitat *ZitatList;
+
+	printf("ZitatespuckerAuthorHash:\n");
+	printf("Checking whether NULL hashes to 0 and strings never do...\n");
+	assert(ZitatespuckerAuthorHash(NULL, 0) == 0);
+	assert(ZitatespuckerAuthorHash("", 0) != 0);
+	assert(ZitatespuckerAuthorHash("Linus Torvalds", 14) != 0);
+	assert(ZitatespuckerAuthorHash("Linus Torvalds", 14) == ZitatespuckerAuthorHash("Linus Torvalds, again", 14));
+	assert(ZitatespuckerAuthorHash("Linus Torvalds", 14) != ZitatespuckerAuthorHash("Linus Torvalds", 13));
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerZitatSetLengths:\n");
+	printf("Checking whether elements built by hand work without and with their lengths set...\n");
+	char author[] = "Hand Made";
+	char zitat[] = "Built without a backend";
+	ZitatespuckerZitat hand;
+	ZitatespuckerZitatInit(&hand);
+	hand.author = author;
+	hand.zitat = zitat;
+	assert(hand.authorLen == 0 && hand.authorHash == 0);
+	assert(ZitatespuckerZitatGetAuthorLen(&hand) == strlen(author));
+	assert(ZitatespuckerZitatGetZitatLen(&hand) == strlen(zitat));
+	assert(ZitatespuckerZitatGetCommentLen(&hand) == 0);
+	assert(ZitatespuckerZitatGetAuthorHash(&hand) == ZitatespuckerAuthorHash(author, strlen(author)));
+	assert(ZitatespuckerZitatIsByAuthor(&hand, "Hand Made", 9, ZitatespuckerAuthorHash("Hand Made", 9)));
+	assert(ZitatespuckerZitatIsByAuthor(&hand, "Hand Made", 9, 0));
+	assert(!ZitatespuckerZitatIsByAuthor(&hand, "Hand", 4, ZitatespuckerAuthorHash("Hand", 4)));
+	assert(!ZitatespuckerZitatIsByAuthor(&hand, "Hand Made!", 10, 0));
+	ZitatespuckerZitatSetLengths(&hand);
+	CheckList(&hand, 1);
+	assert(ZitatespuckerZitatIsByAuthor(&hand, "Hand Made", 9, ZitatespuckerAuthorHash("Hand Made", 9)));
+	assert(!ZitatespuckerZitatIsByAuthor(&hand, "Hand Mad", 8, ZitatespuckerAuthorHash("Hand Mad", 8)));
+	printf("OKAY!\n\n");
+	printf("Checking whether ordering by author still orders like strcmp() with the lengths...\n");
+	ZitatespuckerZitat shorter;
+	ZitatespuckerZitatInit(&shorter);
+	shorter.author = (char *) "Hand";
+	ZitatespuckerZitatSetLengths(&shorter);
+	assert(ZitatespuckerZitatCompareByAuthor(&shorter, &hand, NULL) < 0);
+	assert(ZitatespuckerZitatCompareByAuthor(&hand, &shorter, NULL) > 0);
+	assert(ZitatespuckerZitatCompareByAuthor(&hand, &hand, NULL) == 0);
+	shorter.authorLen = 0; // unknown again
+	assert(ZitatespuckerZitatCompareByAuthor(&shorter, &hand, NULL) < 0);
+	printf("OKAY!\n\n\n");
+
+	printf("Backends:\n");
+	printf("Checking whether the .json backend fills in the lengths...\n");
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFile("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(ZitatList != NULL);
+	CheckList(ZitatList, ZitatespuckerZitatListLen(ZitatList));
+	CheckByAuthor("../testfile.json", ZitatList);
+	ZitatespuckerZitat *single = ZitatespuckerSourceGetZitatSingleFromFile("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN, 2);
+	CheckList(single, 1);
+	ZitatespuckerZitatFree(single);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether the SQLite backend fills in the lengths...\n");
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(ZitatList != NULL);
+	CheckList(ZitatList, ZitatespuckerZitatListLen(ZitatList));
+	CheckByAuthor("../testfile.sqlite", ZitatList);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether the JSON Lines backend fills in the lengths, ending strings at \"\\u0000\"...\n");
+	WriteFile(NDJSON_FILE, ndjsonContent);
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFile(NDJSON_FILE, ZITATESPUCKER_SOURCE_UNKNOWN);
+	CheckList(ZitatList, 4);
+	assert(ZitatList->authorLen == strlen("Caf\xC3\xA9 Owner") && ZitatList->commentLen == 4);
+	assert(strcmp(ZitatList->nextZitat->author, "Nul") == 0 && ZitatList->nextZitat->zitatLen == 6);
+	CheckByAuthor(NDJSON_FILE, ZitatList);
+	ZitatespuckerZitatFree(ZitatList);
+	(void) remove(NDJSON_FILE);
+	printf("OKAY!\n\n");
+	printf("Checking whether the CSV backend fills in the lengths of quoted fields...\n");
+	WriteFile(CSV_FILE, csvContent);
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFile(CSV_FILE, ZITATESPUCKER_SOURCE_UNKNOWN);
+	CheckList(ZitatList, 4);
+	assert(strcmp(ZitatList->zitat, "Said \"this\"") == 0 && ZitatList->zitatLen == 11);
+	CheckByAuthor(CSV_FILE, ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether snapshots keep the lengths, and work them out for elements built by hand...\n");
+	ZitatespuckerSnapshot *snapshot = ZitatespuckerSnapshotFromList(ZitatList);
+	assert(snapshot != NULL);
+	CheckList(ZitatespuckerSnapshotGet(snapshot, 0), 4);
+	assert(ZitatespuckerSnapshotFindByAuthor(snapshot, "Quoted, Author", 1) == 3);
+	assert(ZitatespuckerSnapshotFindByAuthor(snapshot, "Quoted", 0) == ZITATESPUCKER_SNAPSHOT_NONE);
+	ZitatespuckerSnapshotRelease(snapshot);
+	ZitatespuckerZitatInit(&hand);
+	hand.author = author;
+	snapshot = ZitatespuckerSnapshotFromList(&hand);
+	CheckList(ZitatespuckerSnapshotGet(snapshot, 0), 1);
+	ZitatespuckerSnapshotRelease(snapshot);
+	ZitatespuckerZitatFree(ZitatList);
+	(void) remove(CSV_FILE);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerZitatIsByAuthor (%d elements, %d authors sharing a long prefix):\n", LARGE_AMOUNT, LARGE_AUTHORS);
+	printf("Checking whether it agrees with strcmp()...\n");
+	static char names[LARGE_AUTHORS][64];
+	ZitatespuckerZitat *large = (ZitatespuckerZitat *) malloc(LARGE_AMOUNT * sizeof(ZitatespuckerZitat));
+	assert(large != NULL);
+	for (size_t i = 0; i < LARGE_AUTHORS; i++)
+		(void) snprintf(names[i], sizeof(names[i]), "A rather long author name shared by all, number %zu", i);
+	for (size_t i = 0; i < LARGE_AMOUNT; i++) {
+		ZitatespuckerZitatInit(&large[i]);
+		large[i].author = names[(i * 7) % LARGE_AUTHORS];
+		ZitatespuckerZitatSetLengths(&large[i]);
+	}
+	const char *wanted = names[LARGE_AUTHORS - 1];
+	size_t wantedLen = strlen(wanted);
+	uint64_t wantedHash = ZitatespuckerAuthorHash(wanted, wantedLen);
+	volatile size_t byStrcmp = 0;
+	volatile size_t byHash = 0;
+	double start = Seconds();
+	for (size_t i = 0; i < LARGE_AMOUNT; i++)
+		byStrcmp += (strcmp(large[i].author, wanted) == 0);
+	double strcmpTime = Seconds() - start;
+	start = Seconds();
+	for (size_t i = 0; i < LARGE_AMOUNT; i++)
+		byHash += ZitatespuckerZitatIsByAuthor(&large[i], wanted, wantedLen, wantedHash);
+	double hashTime = Seconds() - start;
+	printf("strcmp(): %.2f ms, ZitatespuckerZitatIsByAuthor(): %.2f ms\n", strcmpTime * 1000, hashTime * 1000);
+	assert(byStrcmp == byHash && byHash == LARGE_AMOUNT / LARGE_AUTHORS);
+	free((void *) large);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,239 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Newline-delimited JSON (JSON Lines) backend (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#define ZITATESPUCKER_NDJSON
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define HANDWRITTEN_FILE	"ndjson_tests_handwritten.ndjson"
+#define ROUNDTRIP_FILE		"ndjson_tests_roundtrip.jsonl"
+#define ROUNDTRIP_DB		"ndjson_tests_roundtrip.sqlite"
+#define LARGE_FILE			"ndjson_tests_large.ndjson"
+#define LARGE_AMOUNT		100000
+
+
+/* Every quirk the parser has to deal with, one line each; the last line is torn */
+static const char handwritten[] =
+	"{\"author\": \"Esc\\\"aped\\\\\", \"zitat\": \"\\u00e4\\ud83d\\ude00\\n\", \"day\": 300, \"month\": 2.9, \"year\": -5, \"annodomini\": true}\n"
+	"\n"
+	"   \t\r\n"
+	"{\"unknown\": {\"nested\": [1, 2.5e3, {\"deep\": null}], \"more\": \"x\"}, \"author\": \"Second\", \"year\": 1e3, \"annodomini\": false}\r\n"
+	"{\"author\": 42, \"zitat\": \"\", \"comment\": \"kept\", \"year\": \"1900\", \"annodomini\": 1}\n"
+	"[\"not\", \"an\", \"object\"]\n"
+	"{\"author\": \"Last\", \"zitat\": \"To\"} trailing\n"
+	"{\"author\": \"Torn\", \"zit";
+
+
+static void WriteFile(const char *filename, const char *content)
+{
+	FILE *file = fopen(filename, "wb");
+	assert(file != NULL);
+	assert(fwrite(content, 1, strlen(content), file) == strlen(content));
+	assert(fclose(file) == 0);
+}
+
+/* Check that both lists hold the same elements in the same order */
+static void CheckSame(ZitatespuckerZitat *a, ZitatespuckerZitat *b)
+{
+	assert(ZitatespuckerZitatListLen(a) == ZitatespuckerZitatListLen(b));
+	for (; a != NULL; a = a->nextZitat, b = b->nextZitat) {
+		assert(ZitatespuckerZitatHash(a) == ZitatespuckerZitatHash(b));
+		assert((a->comment == NULL) == (b->comment == NULL));
+		assert(a->comment == NULL || strcmp(a->comment, b->comment) == 0);
+	}
+}
+
+/* Write LARGE_AMOUNT elements to LARGE_FILE, appending in batches */
+static void WriteLargeFile(void)
+{
+	ZitatespuckerZitat *Zitate = (ZitatespuckerZitat *) calloc(1000, sizeof(ZitatespuckerZitat));
+	char (*zitate)[32] = (char (*)[32]) calloc(1000, sizeof(*zitate));
+	assert(Zitate != NULL && zitate != NULL);
+
+	(void) remove(LARGE_FILE);
+	for (size_t batch = 0; batch < LARGE_AMOUNT / 1000; batch++) {
+		for (size_t i = 0; i < 1000; i++) {
+			size_t n = batch * 1000 + i;
+			ZitatespuckerZitatInit(&Zitate[i]);
+			(void) snprintf(zitate[i], sizeof(zitate[i]), "Quote number %zu", n);
+			Zitate[i].author = (n % 3 == 0 ? "Author A" : "Author B");
+			Zitate[i].zitat = zitate[i];
+			Zitate[i].comment = "A comment that makes the file a bit larger than it would be otherwise";
+			Zitate[i].year = (uint16_t) (n % 2024);
+			Zitate[i].month = (uint8_t) (n % 12 + 1);
+			Zitate[i].annodomini = true;
+			Zitate[i].nextZitat = (i + 1 < 1000 ? &Zitate[i + 1] : NULL);
+			Zitate[i].prevZitat = (i > 0 ? &Zitate[i - 1] : NULL);
+		}
+		assert(ZitatespuckerNDJSONAppend(LARGE_FILE, Zitate));
+	}
+
+	free((void *) zitate);
+	free((void *) Zitate);
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerZitat *ZitatList;
+	ZitatespuckerZitat *other;
+
+	printf("ZitatespuckerNDJSONGetZitatAllFromFile:\n");
+	printf("Checking whether a NULL or missing file results in a NULL pointer...\n");
+	assert(ZitatespuckerNDJSONGetZitatAllFromFile(NULL) == NULL);
+	assert(ZitatespuckerNDJSONGetZitatAllFromFile("../doesnotexist.ndjson") == NULL);
+	assert(ZitatespuckerNDJSONGetAmountFromFile("../doesnotexist.ndjson") == 0);
+	assert(ZitatespuckerNDJSONGetZitatAllFromFileByAuthor(HANDWRITTEN_FILE, NULL) == NULL);
+	assert(!ZitatespuckerNDJSONAppend(NULL, NULL));
+	printf("OKAY!\n\n");
+	printf("Checking whether escapes, numbers, unknown keys and blank lines are handled...\n");
+	WriteFile(HANDWRITTEN_FILE, handwritten);
+	assert(ZitatespuckerSourceDetect(HANDWRITTEN_FILE) == ZITATESPUCKER_SOURCE_NDJSON);
+	assert(ZitatespuckerNDJSONGetAmountFromFile(HANDWRITTEN_FILE) == 6);
+	ZitatList = ZitatespuckerNDJSONGetZitatAllFromFile(HANDWRITTEN_FILE);
+	assert(ZitatList != NULL && ZitatespuckerZitatListLen(ZitatList) == 3);
+	assert(strcmp(ZitatList->author, "Esc\"aped\\") == 0 && strcmp(ZitatList->zitat, "\xC3\xA4\xF0\x9F\x98\x80\n") == 0);
+	assert(ZitatList->day == 255 && ZitatList->month == 2 && ZitatList->year == 0 && ZitatList->annodomini);
+	other = ZitatList->nextZitat;
+	assert(strcmp(other->author, "Second") == 0 && other->zitat == NULL && other->year == 1000 && !other->annodomini);
+	other = other->nextZitat;
+	assert(other->author == NULL && other->zitat == NULL && strcmp(other->comment, "kept") == 0 && other->year == 0 && !other->annodomini);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n");
+	printf("Checking whether single elements are found by line...\n");
+	ZitatList = ZitatespuckerNDJSONGetZitatSingleFromFile(HANDWRITTEN_FILE, 1);
+	assert(ZitatList != NULL && strcmp(ZitatList->author, "Second") == 0);
+	ZitatespuckerZitatFree(ZitatList);
+	assert(ZitatespuckerNDJSONGetZitatSingleFromFile(HANDWRITTEN_FILE, 3) == NULL); // not an object
+	assert(ZitatespuckerNDJSONGetZitatSingleFromFile(HANDWRITTEN_FILE, 6) == NULL); // out of range
+	printf("OKAY!\n\n");
+	printf("Checking whether appending after a torn line keeps the new lines intact...\n");
+	ZitatespuckerZitat appended;
+	ZitatespuckerZitatInit(&appended);
+	appended.author = "Appended";
+	appended.zitat = "Line\nbreak";
+	appended.year = 2024;
+	appended.annodomini = true;
+	assert(ZitatespuckerNDJSONAppend(HANDWRITTEN_FILE, &appended));
+	ZitatList = ZitatespuckerNDJSONGetZitatAllFromFileByAuthor(HANDWRITTEN_FILE, "Appended");
+	assert(ZitatList != NULL && ZitatList->nextZitat == NULL && ZitatespuckerZitatHash(ZitatList) == ZitatespuckerZitatHash(&appended));
+	ZitatespuckerZitatFree(ZitatList);
+	assert(ZitatespuckerNDJSONGetAmountFromFile(HANDWRITTEN_FILE) == 7);
+	(void) remove(HANDWRITTEN_FILE);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerExportLinesToFile:\n");
+	printf("Checking whether exported lines read back like the .json file...\n");
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFile("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(ZitatList != NULL);
+	FILE *file = fopen(ROUNDTRIP_FILE, "w");
+	assert(file != NULL);
+	ZitatespuckerExport *exporter = ZitatespuckerExportLinesToFile(file);
+	assert(exporter != NULL && ZitatespuckerExportAddList(exporter, ZitatList) && ZitatespuckerExportFinish(exporter, NULL, NULL));
+	assert(fclose(file) == 0);
+	other = ZitatespuckerSourceGetZitatAllFromFile(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN);
+	CheckSame(ZitatList, other);
+	ZitatespuckerZitatFree(other);
+	printf("OKAY!\n\n");
+	printf("Checking whether a buffer holds one line per element...\n");
+	char *buffer = NULL;
+	size_t len = 0;
+	exporter = ZitatespuckerExportLinesToBuffer();
+	assert(exporter != NULL && ZitatespuckerExportAddList(exporter, ZitatList) && ZitatespuckerExportFinish(exporter, &buffer, &len));
+	assert(buffer != NULL && len == strlen(buffer) && buffer[0] == '{' && buffer[len - 1] == '\n');
+	size_t lines = 0;
+	for (size_t i = 0; i < len; i++)
+		lines += (buffer[i] == '\n');
+	assert(lines == ZitatespuckerZitatListLen(ZitatList));
+	free((void *) buffer);
+	printf("OKAY!\n\n");
+	printf("Checking whether the other source functions work on the lines...\n");
+	other = ZitatespuckerSourceGetZitatAllFromFileByAuthor(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, "Ein Esel");
+	ZitatespuckerZitat *expected = ZitatespuckerSourceGetZitatAllFromFileByAuthor("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN, "Ein Esel");
+	CheckSame(expected, other);
+	ZitatespuckerZitatFree(expected);
+	ZitatespuckerZitatFree(other);
+	other = ZitatespuckerSourceGetZitatAllFromFileByDateFields(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, ZitatList->annodomini, ZitatList->year, 0, 0, ZITATESPUCKER_FIELD_DATE);
+	assert(other != NULL && other->year == ZitatList->year && other->author == NULL && other->zitat == NULL);
+	ZitatespuckerZitatFree(other);
+	ZitatespuckerCounts *counts = ZitatespuckerSourceCountFromFile(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, ZITATESPUCKER_GROUP_AUTHOR, NULL);
+	ZitatespuckerCounts *expectedCounts = ZitatespuckerCountFromList(ZitatList, ZITATESPUCKER_GROUP_AUTHOR, NULL);
+	assert(counts != NULL && expectedCounts != NULL && counts->len == expectedCounts->len && counts->total == expectedCounts->total);
+	ZitatespuckerCountsFree(expectedCounts);
+	ZitatespuckerCountsFree(counts);
+	(void) remove(ROUNDTRIP_DB);
+	ZitatespuckerSQLImportStats stats;
+	assert(ZitatespuckerSourceImportToSQL(ROUNDTRIP_FILE, ZITATESPUCKER_SOURCE_UNKNOWN, ROUNDTRIP_DB, &stats));
+	assert(stats.rows == ZitatespuckerZitatListLen(ZitatList));
+	(void) remove(ROUNDTRIP_DB);
+	(void) remove(ROUNDTRIP_FILE);
+	ZitatespuckerZitatFree(ZitatList);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerNDJSONGetZitatAllFromFileThreads (%d elements):\n", LARGE_AMOUNT);
+	printf("Checking whether any number of threads yields the same list...\n");
+	WriteLargeFile();
+	assert(ZitatespuckerNDJSONGetAmountFromFile(LARGE_FILE) == LARGE_AMOUNT);
+	double start = Seconds();
+	ZitatList = ZitatespuckerNDJSONGetZitatAllFromFileThreads(LARGE_FILE, ZITATESPUCKER_FIELD_ALL, 1);
+	double single = Seconds() - start;
+	assert(ZitatespuckerZitatListLen(ZitatList) == LARGE_AMOUNT);
+	for (size_t threads = 2; threads <= 8; threads *= 2) {
+		start = Seconds();
+		other = ZitatespuckerNDJSONGetZitatAllFromFileThreads(LARGE_FILE, ZITATESPUCKER_FIELD_ALL, threads);
+		double parallel = Seconds() - start;
+		printf("%zu thread(s): %.0f ms (1 thread: %.0f ms)\n", threads, parallel * 1000, single * 1000);
+		CheckSame(ZitatList, other);
+		for (ZitatespuckerZitat *cur = other; cur->nextZitat != NULL; cur = cur->nextZitat)
+			assert(cur->nextZitat->prevZitat == cur);
+		ZitatespuckerZitatFree(other);
+	}
+	other = ZitatespuckerNDJSONGetZitatAllFromFileThreads(LARGE_FILE, ZITATESPUCKER_FIELD_ALL, LARGE_AMOUNT);
+	CheckSame(ZitatList, other);
+	ZitatespuckerZitatFree(other);
+	printf("OKAY!\n\n");
+	printf("Checking whether filtering matches filtering the whole list...\n");
+	other = ZitatespuckerNDJSONGetZitatAllFromFileByAuthor(LARGE_FILE, "Author A");
+	assert(ZitatespuckerZitatListLen(other) == (LARGE_AMOUNT + 2) / 3);
+	ZitatespuckerZitatFree(other);
+	other = ZitatespuckerNDJSONGetZitatAllFromFileByDate(LARGE_FILE, true, 2000, 9, 0);
+	size_t matching = 0;
+	for (ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat)
+		matching += (cur->year == 2000 && cur->month == 9);
+	assert(matching > 0 && ZitatespuckerZitatListLen(other) == matching);
+	ZitatespuckerZitatFree(other);
+	ZitatespuckerZitatFree(ZitatList);
+	(void) remove(LARGE_FILE);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
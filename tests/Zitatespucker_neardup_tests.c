@@ -0,0 +1,336 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Finding quotes that are almost the same (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define LARGE_AMOUNT	20000
+#define LARGE_COPIES	500
+#define LARGE_WORDS		12
+#define VOCABULARY		400
+#define CHAINS			50
+#define CHAIN_STEPS		8
+#define CHAIN_WORDS		16
+
+
+/* Indexes 0 and 1, 2 and 3, as well as 2 and 4 are near duplicates; 5 to 7 are unlike anything, 8 and 9 have no text to speak of */
+static const char *texts[] = {
+	"Software is like sex: It's better when it's free.",
+	"software is like sex - it is better when it is free!",
+	"The only way to do great work is to love what you do.",
+	"The only way to do great work is to love what you are doing.",
+	"  THE ONLY WAY TO DO GREAT WORK IS TO LOVE WHAT YOU DO  ",
+	"Talk is cheap. Show me the code.",
+	"Given enough eyeballs, all bugs are shallow.",
+	"Premature optimization is the root of all evil.",
+	"?!...",
+	NULL
+};
+#define TEXTS	(sizeof(texts) / sizeof(texts[0]))
+
+
+/* A list of elements with the quote texts of texts, len of them */
+static ZitatespuckerZitat *BuildList(char **list, size_t len)
+{
+	ZitatespuckerZitat *ret = NULL;
+	for (size_t i = len; i-- > 0; ) {
+		ZitatespuckerZitat *Zitat = (ZitatespuckerZitat *) malloc(sizeof(ZitatespuckerZitat));
+		assert(Zitat != NULL);
+		ZitatespuckerZitatInit(Zitat);
+		if (list[i] != NULL) {
+			Zitat->zitat = (char *) malloc(strlen(list[i]) + 1);
+			assert(Zitat->zitat != NULL);
+			(void) strcpy(Zitat->zitat, list[i]);
+		}
+		Zitat->nextZitat = ret;
+		if (ret != NULL)
+			ret->prevZitat = Zitat;
+		ret = Zitat;
+	}
+
+	return ret;
+}
+
+/* Whether the matches hold idx */
+static bool Holds(const ZitatespuckerNearDupMatch *matches, size_t len, size_t idx)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (matches[i].idx == idx)
+			return true;
+	}
+
+	return false;
+}
+
+/* Returns the words of vocabulary at the indexes within words (len of them), separated by spaces */
+static char *Sentence(const size_t *words, size_t len, char (*vocabulary)[12])
+{
+	size_t size = 1;
+	for (size_t w = 0; w < len; w++)
+		size += strlen(vocabulary[words[w]]) + 1;
+	char *ret = (char *) malloc(size);
+	assert(ret != NULL);
+	ret[0] = '\0';
+	for (size_t w = 0; w < len; w++) {
+		if (w > 0)
+			(void) strcat(ret, " ");
+		(void) strcat(ret, vocabulary[words[w]]);
+	}
+
+	return ret;
+}
+
+static size_t Root(size_t *parents, size_t idx)
+{
+	while (parents[idx] != idx)
+		idx = parents[idx];
+	return idx;
+}
+
+static uint64_t Random(uint64_t *state)
+{
+	*state = *state * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+	return *state >> 33;
+}
+
+
+int main(void)
+{
+	ZitatespuckerNearDupIndex *index;
+	ZitatespuckerNearDupMatch matches[TEXTS];
+	size_t clusters[TEXTS];
+	size_t amount;
+
+	ZitatespuckerZitat *ZitatList = BuildList((char **) texts, TEXTS);
+
+	printf("ZitatespuckerNearDupIndexFromList:\n");
+	printf("Checking whether options out of range are refused...\n");
+	ZitatespuckerNearDupOptions options = {ZITATESPUCKER_NEARDUP_MAX_SHINGLE + 1, 0, 0, 0};
+	assert(ZitatespuckerNearDupIndexFromList(ZitatList, &options) == NULL && ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_ARGUMENT);
+	options = (ZitatespuckerNearDupOptions) {0, 64, 32, 0};
+	assert(ZitatespuckerNearDupIndexFromList(ZitatList, &options) == NULL);
+	options = (ZitatespuckerNearDupOptions) {0, 0, 0, 1.5};
+	assert(ZitatespuckerNearDupIndexFromList(ZitatList, &options) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether empty lists yield empty indexes...\n");
+	index = ZitatespuckerNearDupIndexFromList(NULL, NULL);
+	assert(index != NULL && ZitatespuckerNearDupIndexGetAmount(index) == 0);
+	assert(ZitatespuckerNearDupFind(index, texts[0], 0, matches, TEXTS) == 0);
+	assert(ZitatespuckerNearDupClusters(index, 0, NULL, &amount) && amount == 0);
+	ZitatespuckerNearDupIndexFree(index);
+	printf("OKAY!\n\n\n");
+
+	index = ZitatespuckerNearDupIndexFromList(ZitatList->nextZitat, NULL);
+	assert(index != NULL && ZitatespuckerNearDupIndexGetAmount(index) == TEXTS);
+
+	printf("ZitatespuckerNearDupFind:\n");
+	printf("Checking whether a text finds itself and its near duplicates, but nothing else...\n");
+	size_t found = ZitatespuckerNearDupFind(index, texts[0], 0, matches, TEXTS);
+	assert(found == 2 && matches[0].idx == 0 && matches[0].similarity == 1.0 && matches[1].idx == 1);
+	assert(matches[1].similarity >= ZITATESPUCKER_NEARDUP_THRESHOLD && matches[1].similarity < 1.0);
+	found = ZitatespuckerNearDupFind(index, "The only way to do great work is to love what you're doing", 0, matches, TEXTS);
+	assert(found == 3 && Holds(matches, found, 2) && Holds(matches, found, 3) && Holds(matches, found, 4));
+	for (size_t i = 1; i < found; i++)
+		assert(matches[i - 1].similarity > matches[i].similarity || (matches[i - 1].similarity == matches[i].similarity && matches[i - 1].idx < matches[i].idx));
+	found = ZitatespuckerNearDupFind(index, texts[5], 0, matches, TEXTS);
+	assert(found == 1 && matches[0].idx == 5);
+	printf("OKAY!\n\n");
+	printf("Checking whether case, punctuation and whitespace make no difference...\n");
+	found = ZitatespuckerNearDupFind(index, texts[2], 0, matches, TEXTS);
+	assert(found == 3 && matches[0].similarity == 1.0 && matches[1].similarity == 1.0);
+	assert(matches[0].idx == 2 && matches[1].idx == 4 && matches[2].idx == 3);
+	printf("OKAY!\n\n");
+	printf("Checking whether the threshold can be raised per query...\n");
+	assert(ZitatespuckerNearDupFind(index, texts[2], 1.0, matches, TEXTS) == 2);
+	assert(ZitatespuckerNearDupFind(index, texts[2], 1.5, matches, TEXTS) == 0 && ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_ARGUMENT);
+	printf("OKAY!\n\n");
+	printf("Checking whether max limits what is stored, not what is counted...\n");
+	assert(ZitatespuckerNearDupFind(index, texts[2], 0, NULL, 0) == 3);
+	matches[1].idx = SIZE_MAX;
+	assert(ZitatespuckerNearDupFind(index, texts[2], 0, matches, 1) == 3 && matches[0].idx == 2 && matches[1].idx == SIZE_MAX);
+	printf("OKAY!\n\n");
+	printf("Checking whether texts without words never match...\n");
+	assert(ZitatespuckerNearDupFind(index, texts[8], 0, matches, TEXTS) == 0);
+	assert(ZitatespuckerNearDupFind(index, "", 0, matches, TEXTS) == 0);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerNearDupClusters:\n");
+	printf("Checking whether near duplicates are grouped under the first of them...\n");
+	assert(ZitatespuckerNearDupClusters(index, 0, clusters, &amount));
+	assert(amount == 2);
+	const size_t expected[TEXTS] = {0, 0, 2, 2, 2, 5, 6, 7, 8, 9};
+	for (size_t i = 0; i < TEXTS; i++)
+		assert(clusters[i] == expected[i]);
+	printf("OKAY!\n\n");
+	printf("Checking whether a higher threshold splits them up...\n");
+	assert(ZitatespuckerNearDupClusters(index, 1.0, clusters, &amount));
+	assert(amount == 1 && clusters[4] == 2 && clusters[3] == 3 && clusters[1] == 1);
+	printf("OKAY!\n\n\n");
+	ZitatespuckerNearDupIndexFree(index);
+	ZitatespuckerZitatFree(ZitatList);
+
+	printf("ZitatespuckerNearDupIndexFromFile:\n");
+	printf("Checking whether every quote of a file finds itself...\n");
+	ZitatList = ZitatespuckerSourceGetZitatAllFromFile("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(ZitatList != NULL);
+	index = ZitatespuckerNearDupIndexFromFile("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN, NULL);
+	assert(index != NULL && ZitatespuckerNearDupIndexGetAmount(index) == ZitatespuckerZitatListLen(ZitatList));
+	size_t idx = 0;
+	for (ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat, idx++) {
+		if (cur->zitat == NULL)
+			continue;
+		ZitatespuckerNearDupMatch match;
+		assert(ZitatespuckerNearDupFind(index, cur->zitat, 0, &match, 1) >= 1 && match.similarity == 1.0);
+		ZitatespuckerZitat *single = ZitatespuckerSourceGetZitatSingleFromFile("../testfile.json", ZITATESPUCKER_SOURCE_UNKNOWN, match.idx);
+		assert(single != NULL && strcmp(single->zitat, cur->zitat) == 0);
+		ZitatespuckerZitatFree(single);
+	}
+	ZitatespuckerNearDupIndexFree(index);
+	ZitatespuckerZitatFree(ZitatList);
+	assert(ZitatespuckerNearDupIndexFromFile(NULL, ZITATESPUCKER_SOURCE_UNKNOWN, NULL) == NULL);
+	printf("OKAY!\n\n\n");
+
+	static char vocabulary[VOCABULARY][12];
+	uint64_t state = 42;
+	for (size_t w = 0; w < VOCABULARY; w++) {
+		size_t wordLen = 3 + Random(&state) % 7;
+		for (size_t c = 0; c < wordLen; c++)
+			vocabulary[w][c] = (char) ('a' + Random(&state) % 26);
+		vocabulary[w][wordLen] = '\0';
+	}
+
+	printf("ZitatespuckerNearDupClusters (%d chains of %d quotes, each with three words of the one before changed):\n", CHAINS, CHAIN_STEPS);
+	printf("Checking whether the clusters are the same as linking every quote with the ones it finds...\n");
+	char *chain[CHAINS * CHAIN_STEPS];
+	for (size_t c = 0; c < CHAINS; c++) {
+		size_t words[CHAIN_WORDS];
+		for (size_t w = 0; w < CHAIN_WORDS; w++)
+			words[w] = Random(&state) % VOCABULARY;
+		for (size_t step = 0; step < CHAIN_STEPS; step++) {
+			// the chains are interleaved, so the first quote of a chain is not always the lowest index of its cluster
+			chain[((step * 7) % CHAIN_STEPS) * CHAINS + c] = Sentence(words, CHAIN_WORDS, vocabulary);
+			for (size_t w = 0; w < 3; w++) {
+				size_t position = Random(&state) % CHAIN_WORDS;
+				words[position] = Random(&state) % VOCABULARY;
+			}
+		}
+	}
+	ZitatList = BuildList(chain, CHAINS * CHAIN_STEPS);
+	index = ZitatespuckerNearDupIndexFromList(ZitatList, NULL);
+	assert(index != NULL);
+	size_t chainClusters[CHAINS * CHAIN_STEPS];
+	assert(ZitatespuckerNearDupClusters(index, 0.5, chainClusters, &amount));
+	size_t linked[CHAINS * CHAIN_STEPS];
+	for (size_t i = 0; i < CHAINS * CHAIN_STEPS; i++)
+		linked[i] = i;
+	ZitatespuckerNearDupMatch chainMatches[CHAINS * CHAIN_STEPS];
+	size_t indirect = 0;
+	for (size_t i = 0; i < CHAINS * CHAIN_STEPS; i++) {
+		found = ZitatespuckerNearDupFind(index, chain[i], 0.5, chainMatches, CHAINS * CHAIN_STEPS);
+		for (size_t m = 0; m < found; m++) {
+			size_t a = Root(linked, i);
+			size_t b = Root(linked, chainMatches[m].idx);
+			linked[a > b ? a : b] = (a > b ? b : a);
+		}
+	}
+	for (size_t i = 0; i < CHAINS * CHAIN_STEPS; i++) {
+		assert(chainClusters[i] == Root(linked, i));
+		// count the quotes that only end up in a cluster through others
+		if (chainClusters[i] != i) {
+			found = ZitatespuckerNearDupFind(index, chain[i], 0.5, chainMatches, CHAINS * CHAIN_STEPS);
+			indirect += !Holds(chainMatches, found, chainClusters[i]);
+		}
+	}
+	printf("%zu clusters, %zu quotes not similar to the first of their cluster\n", amount, indirect);
+	assert(indirect > 0);
+	ZitatespuckerNearDupIndexFree(index);
+	ZitatespuckerZitatFree(ZitatList);
+	for (size_t i = 0; i < CHAINS * CHAIN_STEPS; i++)
+		free((void *) chain[i]);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerNearDupClusters (%d quotes of %d words, %d of them copied with a word changed):\n", LARGE_AMOUNT, LARGE_WORDS, LARGE_COPIES);
+	printf("Checking whether the copies are found, and little else...\n");
+	char **large = (char **) malloc(LARGE_AMOUNT * sizeof(char *));
+	assert(large != NULL);
+	size_t words[LARGE_WORDS];
+	for (size_t i = 0; i < LARGE_AMOUNT; i++) {
+		// the last LARGE_COPIES quotes are copies of the first ones, with one word changed
+		if (i >= LARGE_AMOUNT - LARGE_COPIES) {
+			large[i] = (char *) malloc(strlen(large[i - (LARGE_AMOUNT - LARGE_COPIES)]) + 16);
+			assert(large[i] != NULL);
+			char *src = large[i - (LARGE_AMOUNT - LARGE_COPIES)];
+			char *space = strchr(src, ' ');
+			(void) sprintf(large[i], "%s%s", vocabulary[Random(&state) % VOCABULARY], space);
+			continue;
+		}
+		for (size_t w = 0; w < LARGE_WORDS; w++)
+			words[w] = Random(&state) % VOCABULARY;
+		large[i] = Sentence(words, LARGE_WORDS, vocabulary);
+	}
+	ZitatList = BuildList(large, LARGE_AMOUNT);
+	double start = Seconds();
+	index = ZitatespuckerNearDupIndexFromList(ZitatList, NULL);
+	double buildTime = Seconds() - start;
+	assert(index != NULL);
+	size_t *largeClusters = (size_t *) malloc(LARGE_AMOUNT * sizeof(size_t));
+	assert(largeClusters != NULL);
+	start = Seconds();
+	assert(ZitatespuckerNearDupClusters(index, 0.6, largeClusters, &amount));
+	double clusterTime = Seconds() - start;
+	size_t paired = 0;
+	size_t grouped = 0;
+	for (size_t i = 0; i < LARGE_AMOUNT; i++) {
+		if (i >= LARGE_AMOUNT - LARGE_COPIES)
+			paired += (largeClusters[i] == i - (LARGE_AMOUNT - LARGE_COPIES));
+		else
+			grouped += (largeClusters[i] != i);
+	}
+	printf("building: %.0f ms, clustering: %.0f ms; %zu of %d copies found, %zu other quotes grouped\n", buildTime * 1000, clusterTime * 1000, paired, LARGE_COPIES, grouped);
+	assert(paired >= LARGE_COPIES * 95 / 100);
+	assert(grouped <= LARGE_AMOUNT / 1000);
+	start = Seconds();
+	for (size_t i = 0; i < 1000; i++)
+		(void) ZitatespuckerNearDupFind(index, large[i], 0.6, NULL, 0);
+	printf("1000 queries: %.0f ms\n", (Seconds() - start) * 1000);
+	free((void *) largeClusters);
+	ZitatespuckerNearDupIndexFree(index);
+	ZitatespuckerZitatFree(ZitatList);
+	for (size_t i = 0; i < LARGE_AMOUNT; i++)
+		free((void *) large[i]);
+	free((void *) large);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
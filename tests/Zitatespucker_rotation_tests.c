@@ -0,0 +1,250 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Shuffled rotation through a source (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* SQLite headers */
+#include <sqlite3.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_JSON
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define LARGE_AMOUNT	1000000
+#define SYNTHETIC_FILE	"rotation_tests.sqlite"
+#define SMALL_TABLE		1000
+#define LARGE_TABLE		200000
+#define TIMED_DRAWS		5000
+
+
+/* Check that every round of len draws with seed is a permutation, and returns the number of positions that differ from the first round */
+static size_t CheckRounds(uint64_t seed, size_t len, size_t rounds)
+{
+	bool *seen = (bool *) malloc(len * sizeof(bool));
+	size_t *first = (size_t *) malloc(len * sizeof(size_t));
+	assert(seen != NULL && first != NULL);
+
+	size_t differing = 0;
+	for (size_t round = 0; round < rounds; round++) {
+		(void) memset(seen, 0, len * sizeof(bool));
+		for (size_t i = 0; i < len; i++) {
+			ZitatespuckerRotationState state = {.seed = seed, .position = round * len + i};
+			size_t idx = ZitatespuckerRotationAt(&state, len);
+			assert(idx < len && !seen[idx]);
+			seen[idx] = true;
+			if (round == 0)
+				first[i] = idx;
+			else
+				differing += (first[i] != idx);
+		}
+	}
+
+	free((void *) first);
+	free((void *) seen);
+
+	return differing;
+}
+
+/* Delete the rows of SYNTHETIC_FILE matching where */
+static void DeleteRows(const char *where)
+{
+	char sSQL[128];
+	(void) snprintf(sSQL, sizeof(sSQL), "DELETE FROM ZitatespuckerZitat WHERE %s", where);
+	sqlite3 *db;
+	assert(sqlite3_open(SYNTHETIC_FILE, &db) == SQLITE_OK);
+	assert(sqlite3_exec(db, sSQL, NULL, NULL, NULL) == SQLITE_OK);
+	(void) sqlite3_close(db);
+}
+
+/* Check that two rounds of a rotation through SYNTHETIC_FILE draw each of its len rows once, where rows has those left marked */
+static void CheckSyntheticRounds(size_t len, const bool *rows, size_t amount)
+{
+	ZitatespuckerRotationState state = {.seed = 3, .position = 0};
+	ZitatespuckerRotation *rotation = ZitatespuckerRotationOpen(SYNTHETIC_FILE, ZITATESPUCKER_SOURCE_SQL, &state);
+	assert(rotation != NULL && ZitatespuckerRotationLen(rotation) == len);
+
+	bool *seen = (bool *) malloc(amount * sizeof(bool));
+	assert(seen != NULL);
+	for (size_t round = 0; round < 2; round++) {
+		(void) memset(seen, 0, amount * sizeof(bool));
+		for (size_t i = 0; i < len; i++) {
+			const ZitatespuckerZitat *Zitat = ZitatespuckerRotationNext(rotation);
+			size_t n;
+			assert(Zitat != NULL && sscanf(Zitat->zitat, "Quote number %zu", &n) == 1);
+			assert(n < amount && rows[n] && !seen[n]);
+			seen[n] = true;
+		}
+	}
+
+	free((void *) seen);
+	ZitatespuckerRotationClose(rotation);
+}
+
+/* Returns the shortest time in seconds one of TIMED_DRAWS draws took in a few runs through a table of amount synthetic rows */
+static double TimeDraws(size_t amount)
+{
+	SyntheticDatabase(SYNTHETIC_FILE, amount, 100);
+	ZitatespuckerRotation *rotation = ZitatespuckerRotationOpen(SYNTHETIC_FILE, ZITATESPUCKER_SOURCE_SQL, NULL);
+	assert(rotation != NULL);
+
+	double best = 0;
+	for (size_t run = 0; run < 3; run++) {
+		double start = Seconds();
+		for (size_t i = 0; i < TIMED_DRAWS; i++)
+			assert(ZitatespuckerRotationNext(rotation) != NULL);
+		double seconds = (Seconds() - start) / TIMED_DRAWS;
+		if (run == 0 || seconds < best)
+			best = seconds;
+	}
+
+	ZitatespuckerRotationClose(rotation);
+	(void) remove(SYNTHETIC_FILE);
+
+	return best;
+}
+
+/* Returns true if both elements hold the same */
+static bool Same(const ZitatespuckerZitat *a, const ZitatespuckerZitat *b)
+{
+	return (a != NULL && b != NULL && ZitatespuckerZitatHash(a) == ZitatespuckerZitatHash(b));
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerRotationState state = {.seed = 42, .position = 0};
+
+	printf("ZitatespuckerRotationAt:\n");
+	printf("Checking whether every round yields every index once, in a new order...\n");
+	assert(ZitatespuckerRotationAt(NULL, 10) == 0);
+	assert(ZitatespuckerRotationAt(&state, 0) == 0);
+	static const size_t lens[] = {1, 2, 3, 4, 5, 7, 16, 17, 100, 1000, 4097};
+	for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+		size_t differing = CheckRounds(42, lens[i], 4);
+		assert(lens[i] < 7 || differing > 0);
+	}
+	assert(CheckRounds(UINT64_MAX, 1000, 2) > 0);
+	printf("OKAY!\n\n");
+	printf("Checking whether other seeds yield other orders...\n");
+	size_t differing = 0;
+	for (uint64_t position = 0; position < 1000; position++) {
+		ZitatespuckerRotationState a = {.seed = 1, .position = position};
+		ZitatespuckerRotationState b = {.seed = 2, .position = position};
+		differing += (ZitatespuckerRotationAt(&a, 1000) != ZitatespuckerRotationAt(&b, 1000));
+	}
+	assert(differing > 900);
+	printf("OKAY!\n\n");
+	printf("Checking how long picking an index takes (%d elements, without fetching them)...\n", LARGE_AMOUNT);
+	size_t sum = 0;
+	double start = Seconds();
+	for (uint64_t position = 0; position < LARGE_AMOUNT; position++) {
+		state.position = position;
+		sum += ZitatespuckerRotationAt(&state, LARGE_AMOUNT);
+	}
+	double seconds = Seconds() - start;
+	// a whole round adds up every index once
+	assert(sum == (size_t) LARGE_AMOUNT * (LARGE_AMOUNT - 1) / 2);
+	printf("%.0f ns per index\n", seconds * 1e9 / LARGE_AMOUNT);
+	printf("OKAY!\n\n\n");
+
+	static const char *const files[] = {"../testfile.json", "../testfile.sqlite"};
+	for (size_t f = 0; f < sizeof(files) / sizeof(files[0]); f++) {
+		printf("ZitatespuckerRotationOpen (%s):\n", files[f]);
+		printf("Checking whether draws follow ZitatespuckerRotationAt()...\n");
+		assert(ZitatespuckerRotationOpen(NULL, ZITATESPUCKER_SOURCE_UNKNOWN, NULL) == NULL);
+		assert(ZitatespuckerRotationNext(NULL) == NULL && ZitatespuckerRotationLen(NULL) == 0);
+		ZitatespuckerZitat *ZitatList = ZitatespuckerSourceGetZitatAllFromFile(files[f], ZITATESPUCKER_SOURCE_UNKNOWN);
+		ZitatespuckerSnapshot *snapshot = ZitatespuckerSnapshotFromList(ZitatList);
+		assert(snapshot != NULL);
+		size_t len = ZitatespuckerSnapshotLen(snapshot);
+		state = (ZitatespuckerRotationState) {.seed = 7, .position = 0};
+		ZitatespuckerRotation *rotation = ZitatespuckerRotationOpen(files[f], ZITATESPUCKER_SOURCE_UNKNOWN, &state);
+		assert(rotation != NULL && ZitatespuckerRotationLen(rotation) == len);
+		for (size_t i = 0; i < 2 * len + 1; i++) {
+			ZitatespuckerRotationState expected = {.seed = 7, .position = i};
+			const ZitatespuckerZitat *Zitat = ZitatespuckerRotationNext(rotation);
+			assert(Same(Zitat, ZitatespuckerSnapshotGet(snapshot, ZitatespuckerRotationAt(&expected, len))));
+		}
+		printf("OKAY!\n\n");
+		printf("Checking whether a saved state resumes where it left off...\n");
+		ZitatespuckerRotationGetState(rotation, &state);
+		assert(state.seed == 7 && state.position == 2 * len + 1);
+		const ZitatespuckerZitat *tmp = ZitatespuckerRotationNext(rotation);
+		uint64_t expected = ZitatespuckerZitatHash(tmp);
+		ZitatespuckerRotationClose(rotation);
+		rotation = ZitatespuckerRotationOpen(files[f], ZITATESPUCKER_SOURCE_UNKNOWN, &state);
+		assert(rotation != NULL && ZitatespuckerZitatHash(ZitatespuckerRotationNext(rotation)) == expected);
+		ZitatespuckerRotationClose(rotation);
+		printf("OKAY!\n\n");
+		printf("Checking whether a rotation without a state gets a seed and starts at 0...\n");
+		rotation = ZitatespuckerRotationFromSnapshot(snapshot, NULL);
+		assert(rotation != NULL);
+		ZitatespuckerSnapshotRelease(snapshot); // the rotation holds a reference of its own
+		ZitatespuckerRotationGetState(rotation, &state);
+		assert(state.position == 0);
+		assert(ZitatespuckerRotationNext(rotation) != NULL);
+		ZitatespuckerRotationClose(rotation);
+		ZitatespuckerRotationClose(NULL);
+		ZitatespuckerZitatFree(ZitatList);
+		printf("OKAY!\n\n\n");
+	}
+
+	printf("ZitatespuckerRotationOpen (synthetic database):\n");
+	printf("Checking whether the rowids of deleted rows are passed over...\n");
+	bool *rows = (bool *) malloc(SMALL_TABLE * sizeof(bool));
+	assert(rows != NULL);
+	SyntheticDatabase(SYNTHETIC_FILE, SMALL_TABLE, 10);
+	// rowid i + 1 holds quote number i
+	DeleteRows("rowid % 3 = 0");
+	size_t left = 0;
+	for (size_t n = 0; n < SMALL_TABLE; n++)
+		left += (rows[n] = ((n + 1) % 3 != 0));
+	CheckSyntheticRounds(left, rows, SMALL_TABLE);
+	printf("OKAY!\n\n");
+	printf("Checking whether a table with few rows left in between still draws each once...\n");
+	SyntheticDatabase(SYNTHETIC_FILE, SMALL_TABLE, 10);
+	DeleteRows("rowid % 10 != 1");
+	left = 0;
+	for (size_t n = 0; n < SMALL_TABLE; n++)
+		left += (rows[n] = (n % 10 == 0));
+	CheckSyntheticRounds(left, rows, SMALL_TABLE);
+	free((void *) rows);
+	(void) remove(SYNTHETIC_FILE);
+	printf("OKAY!\n\n");
+	printf("Checking whether a draw takes as long for %d rows as for %d...\n", LARGE_TABLE, SMALL_TABLE);
+	double small = TimeDraws(SMALL_TABLE);
+	double large = TimeDraws(LARGE_TABLE);
+	printf("%.1f us per draw for %d rows, %.1f us for %d\n", small * 1e6, SMALL_TABLE, large * 1e6, LARGE_TABLE);
+	// stepping over rows would take about 200 times as long; a larger b-tree only adds a level or two
+	assert(large < 4 * small);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,119 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Sorting lists (Tests)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#include "../Zitatespucker/Zitatespucker.h"
+
+
+#define LARGE_AMOUNT	1000000
+
+
+/* Fill Zitate with n linked elements of random dates; comment keeps the original position */
+static void FillRandom(ZitatespuckerZitat *Zitate, size_t n, char (*positions)[12])
+{
+	for (size_t i = 0; i < n; i++) {
+		ZitatespuckerZitatInit(&Zitate[i]);
+		Zitate[i].year = (uint16_t) (rand() % 50);
+		Zitate[i].annodomini = (rand() % 2 == 0);
+		Zitate[i].month = (uint8_t) (rand() % 13);
+		Zitate[i].day = (uint8_t) (rand() % 3);
+		(void) snprintf(positions[i], sizeof(positions[i]), "%zu", i);
+		Zitate[i].comment = positions[i];
+		Zitate[i].author = (rand() % 5 == 0 ? NULL : positions[rand() % n]);
+		Zitate[i].nextZitat = (i + 1 < n ? &Zitate[i + 1] : NULL);
+		Zitate[i].prevZitat = (i > 0 ? &Zitate[i - 1] : NULL);
+	}
+}
+
+/* Check that ZitatList is linked both ways, ordered by compare and stable */
+static void CheckSorted(ZitatespuckerZitat *ZitatList, size_t n, ZitatespuckerZitatCompare compare)
+{
+	assert(ZitatList->prevZitat == NULL);
+	assert(ZitatespuckerZitatListLen(ZitatList) == n);
+	for (ZitatespuckerZitat *cur = ZitatList; cur->nextZitat != NULL; cur = cur->nextZitat) {
+		assert(cur->nextZitat->prevZitat == cur);
+		int cmp = compare(cur, cur->nextZitat, NULL);
+		assert(cmp < 0 || (cmp == 0 && atol(cur->comment) < atol(cur->nextZitat->comment)));
+	}
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerZitat Zitate[3];
+	char (*positions)[12];
+
+	printf("ZitatespuckerZitatCompareByDate:\n");
+	printf("Checking whether BC and AD are ordered properly...\n");
+	for (int i = 0; i < 3; i++)
+		ZitatespuckerZitatInit(&Zitate[i]);
+	Zitate[0].year = 10; // 10 BC
+	Zitate[1].year = 1; // 1 BC
+	Zitate[2].year = 1;
+	Zitate[2].annodomini = true; // 1 AD
+	assert(ZitatespuckerZitatCompareByDate(&Zitate[0], &Zitate[1], NULL) < 0);
+	assert(ZitatespuckerZitatCompareByDate(&Zitate[1], &Zitate[2], NULL) < 0);
+	assert(ZitatespuckerZitatCompareByDate(&Zitate[2], &Zitate[0], NULL) > 0);
+	Zitate[1].year = 0; // invalid
+	assert(ZitatespuckerZitatCompareByDate(&Zitate[1], &Zitate[0], NULL) < 0);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerZitatSortByDate / ZitatespuckerZitatSortByAuthor:\n");
+	printf("Checking whether small lists come out sorted and stable...\n");
+	positions = (char (*)[12]) malloc(LARGE_AMOUNT * sizeof(*positions));
+	ZitatespuckerZitat *Large = (ZitatespuckerZitat *) malloc(LARGE_AMOUNT * sizeof(ZitatespuckerZitat));
+	assert(positions != NULL && Large != NULL);
+	srand(1);
+	for (size_t n = 1; n < 300; n += 7) {
+		FillRandom(Large, n, positions);
+		CheckSorted(ZitatespuckerZitatSortByDate(&Large[n / 2]), n, ZitatespuckerZitatCompareByDate);
+		FillRandom(Large, n, positions);
+		CheckSorted(ZitatespuckerZitatSortByAuthor(&Large[n - 1]), n, ZitatespuckerZitatCompareByAuthor);
+		FillRandom(Large, n, positions);
+		CheckSorted(ZitatespuckerZitatSort(Large, ZitatespuckerZitatCompareByDate, NULL), n, ZitatespuckerZitatCompareByDate);
+	}
+	assert(ZitatespuckerZitatSortByDate(NULL) == NULL);
+	printf("OKAY!\n\n");
+
+	printf("Checking whether a million elements sort, and how fast...\n");
+	FillRandom(Large, LARGE_AMOUNT, positions);
+	clock_t start = clock();
+	ZitatespuckerZitat *sorted = ZitatespuckerZitatSortByDate(Large);
+	double radix = (double) (clock() - start) / CLOCKS_PER_SEC;
+	CheckSorted(sorted, LARGE_AMOUNT, ZitatespuckerZitatCompareByDate);
+	FillRandom(Large, LARGE_AMOUNT, positions);
+	start = clock();
+	sorted = ZitatespuckerZitatSort(Large, ZitatespuckerZitatCompareByDate, NULL);
+	double merge = (double) (clock() - start) / CLOCKS_PER_SEC;
+	CheckSorted(sorted, LARGE_AMOUNT, ZitatespuckerZitatCompareByDate);
+	printf("radix: %.1f ms, merge: %.1f ms\n", radix * 1e3, merge * 1e3);
+	printf("OKAY!\n\n\n");
+
+	free((void *) Large);
+	free((void *) positions);
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,249 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Federated SQLite databases (Tests and benchmark)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+/* One database per language, like the setup the federation is meant for */
+#define FILES				4
+#define ROWS_PER_FILE		5000
+#define AUTHORS				200
+#define QUERIES				200
+
+
+static const char *const files[FILES] = {
+	"sqlfederation tests de.sqlite",
+	"sqlfederation tests en.sqlite",
+	"sqlfederation tests fr.sqlite",
+	"sqlfederation tests es.sqlite"
+};
+
+
+/* Write ROWS_PER_FILE rows to every file; the rows of file f are by "Author <i % AUTHORS>" and from the year f * 100 + i % 100 */
+static void CreateFiles(void)
+{
+	ZitatespuckerZitat *Zitate = (ZitatespuckerZitat *) calloc(ROWS_PER_FILE, sizeof(ZitatespuckerZitat));
+	char (*names)[16] = (char (*)[16]) calloc(ROWS_PER_FILE, sizeof(*names));
+	char (*texts)[32] = (char (*)[32]) calloc(ROWS_PER_FILE, sizeof(*texts));
+	assert(Zitate != NULL && names != NULL && texts != NULL);
+
+	for (size_t f = 0; f < FILES; f++) {
+		for (size_t i = 0; i < ROWS_PER_FILE; i++) {
+			ZitatespuckerZitatInit(&Zitate[i]);
+			(void) snprintf(names[i], sizeof(names[i]), "Author %zu", i % AUTHORS);
+			(void) snprintf(texts[i], sizeof(texts[i]), "Quote %zu of file %zu", i, f);
+			Zitate[i].author = names[i];
+			Zitate[i].zitat = texts[i];
+			Zitate[i].year = (uint16_t) (f * 100 + i % 100);
+			Zitate[i].month = (uint8_t) (1 + i % 12);
+			Zitate[i].day = (uint8_t) (1 + i % 28);
+			Zitate[i].annodomini = true;
+			Zitate[i].nextZitat = (i + 1 < ROWS_PER_FILE ? &Zitate[i + 1] : NULL);
+			Zitate[i].prevZitat = (i > 0 ? &Zitate[i - 1] : NULL);
+		}
+		(void) remove(files[f]);
+		assert(ZitatespuckerSQLImportList(files[f], Zitate, NULL));
+	}
+
+	free((void *) texts);
+	free((void *) names);
+	free((void *) Zitate);
+}
+
+/* Append copies of list to the list ending at *last (or starting it, if *first is NULL) */
+static void Append(ZitatespuckerZitat **first, ZitatespuckerZitat **last, ZitatespuckerZitat *list)
+{
+	if (list == NULL)
+		return;
+	if (*first == NULL)
+		*first = list;
+	else {
+		(*last)->nextZitat = list;
+		list->prevZitat = *last;
+	}
+	for (*last = list; (*last)->nextZitat != NULL; *last = (*last)->nextZitat);
+}
+
+/* Check that a and b hold the same elements in the same order */
+static void CheckSame(ZitatespuckerZitat *a, ZitatespuckerZitat *b)
+{
+	assert(ZitatespuckerZitatListLen(a) == ZitatespuckerZitatListLen(b));
+	for (; a != NULL; a = a->nextZitat, b = b->nextZitat)
+		assert(ZitatespuckerZitatHash(a) == ZitatespuckerZitatHash(b));
+}
+
+static bool CountUpTo(const ZitatespuckerZitat *Zitat, void *userdata)
+{
+	size_t *left = (size_t *) userdata;
+	assert(Zitat != NULL && Zitat->author != NULL && Zitat->zitat == NULL);
+	return (--*left != 0);
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerSQLFederation *federation;
+	ZitatespuckerZitat *fromFederation;
+	ZitatespuckerZitat *fromFiles;
+	ZitatespuckerZitat *last;
+
+	printf("ZitatespuckerSQLFederationOpen:\n");
+	printf("Checking whether NULL, no, missing and broken files result in a NULL pointer...\n");
+	const char *const missing[2] = {"../testfile.sqlite", "../doesnotexist.sqlite"};
+	const char *const broken[2] = {"../testfile.sqlite", "../testfile.json"};
+	const char *const withNULL[2] = {"../testfile.sqlite", NULL};
+	assert(ZitatespuckerSQLFederationOpen(NULL, 1) == NULL);
+	assert(ZitatespuckerSQLFederationOpen(missing, 0) == NULL);
+	assert(ZitatespuckerSQLFederationOpen(missing, 2) == NULL);
+	assert(ZitatespuckerSQLFederationOpen(broken, 2) == NULL);
+	assert(ZitatespuckerSQLFederationOpen(withNULL, 2) == NULL);
+	assert(ZitatespuckerSQLFederationGetZitatAll(NULL, ZITATESPUCKER_FIELD_ALL) == NULL);
+	assert(ZitatespuckerSQLFederationGetAmount(NULL) == 0);
+	ZitatespuckerSQLFederationClose(NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether more files than SQLite can attach are refused...\n");
+	const char *many[128];
+	for (size_t i = 0; i < 128; i++)
+		many[i] = "../testfile.sqlite";
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerSQLFederationOpen(many, 128) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_LIMIT);
+	printf("OKAY!\n\n");
+	printf("Checking whether a single file is queried like on its own...\n");
+	federation = ZitatespuckerSQLFederationOpen(missing, 1);
+	assert(federation != NULL);
+	assert(ZitatespuckerSQLFederationGetAmount(federation) == ZitatespuckerSQLGetAmountFromFile("../testfile.sqlite"));
+	fromFederation = ZitatespuckerSQLFederationGetZitatAll(federation, ZITATESPUCKER_FIELD_ALL);
+	fromFiles = ZitatespuckerSQLGetZitatAllFromFile("../testfile.sqlite");
+	assert(fromFederation != NULL);
+	CheckSame(fromFederation, fromFiles);
+	ZitatespuckerZitatFree(fromFiles);
+	ZitatespuckerZitatFree(fromFederation);
+	ZitatespuckerSQLFederationClose(federation);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerSQLFederation (%d synthetic databases):\n", FILES);
+	CreateFiles();
+	federation = ZitatespuckerSQLFederationOpen(files, FILES);
+	assert(federation != NULL);
+	printf("Checking whether the amount is the sum of all files...\n");
+	assert(ZitatespuckerSQLFederationGetAmount(federation) == FILES * ROWS_PER_FILE);
+	printf("OKAY!\n\n");
+	printf("Checking whether all rows come in the order of the files...\n");
+	fromFiles = NULL;
+	for (size_t f = 0; f < FILES; f++)
+		Append(&fromFiles, &last, ZitatespuckerSQLGetZitatAllFromFile(files[f]));
+	fromFederation = ZitatespuckerSQLFederationGetZitatAll(federation, ZITATESPUCKER_FIELD_ALL);
+	CheckSame(fromFederation, fromFiles);
+	assert(strcmp(fromFederation->zitat, "Quote 0 of file 0") == 0);
+	ZitatespuckerZitatFree(fromFederation);
+	printf("OKAY!\n\n");
+	printf("Checking whether single rows are found across file boundaries...\n");
+	const size_t indexes[] = {0, ROWS_PER_FILE - 1, ROWS_PER_FILE, 2 * ROWS_PER_FILE + 17, FILES * ROWS_PER_FILE - 1};
+	for (size_t i = 0; i < sizeof(indexes) / sizeof(indexes[0]); i++) {
+		const ZitatespuckerZitat *expected = fromFiles;
+		for (size_t j = 0; j < indexes[i]; j++)
+			expected = expected->nextZitat;
+		ZitatespuckerZitat *single = ZitatespuckerSQLFederationGetZitatSingle(federation, indexes[i], ZITATESPUCKER_FIELD_ALL);
+		assert(single != NULL && single->nextZitat == NULL && ZitatespuckerZitatHash(single) == ZitatespuckerZitatHash(expected));
+		ZitatespuckerZitatFree(single);
+	}
+	ZitatespuckerDiagClear();
+	assert(ZitatespuckerSQLFederationGetZitatSingle(federation, FILES * ROWS_PER_FILE, ZITATESPUCKER_FIELD_ALL) == NULL);
+	assert(ZitatespuckerDiagGetLastError() == ZITATESPUCKER_ERROR_RANGE);
+	ZitatespuckerZitatFree(fromFiles);
+	printf("OKAY!\n\n");
+	printf("Checking whether filtering by author and date matches a query per file...\n");
+	fromFiles = NULL;
+	for (size_t f = 0; f < FILES; f++)
+		Append(&fromFiles, &last, ZitatespuckerSQLGetZitatAllFromFileByAuthorFields(files[f], "Author 42", ZITATESPUCKER_FIELD_AUTHOR | ZITATESPUCKER_FIELD_ZITAT));
+	fromFederation = ZitatespuckerSQLFederationGetZitatAllByAuthor(federation, "Author 42", ZITATESPUCKER_FIELD_AUTHOR | ZITATESPUCKER_FIELD_ZITAT);
+	assert(ZitatespuckerZitatListLen(fromFederation) == FILES * ROWS_PER_FILE / AUTHORS);
+	CheckSame(fromFederation, fromFiles);
+	ZitatespuckerZitatFree(fromFederation);
+	ZitatespuckerZitatFree(fromFiles);
+	assert(ZitatespuckerSQLFederationGetZitatAllByAuthor(federation, "Nobody", ZITATESPUCKER_FIELD_ALL) == NULL);
+	assert(ZitatespuckerSQLFederationGetZitatAllByAuthor(federation, NULL, ZITATESPUCKER_FIELD_ALL) == NULL);
+	fromFederation = ZitatespuckerSQLFederationGetZitatAllByDate(federation, true, 205, 0, 0, ZITATESPUCKER_FIELD_ALL);
+	fromFiles = ZitatespuckerSQLGetZitatAllFromFileByDate(files[2], true, 205, 0, 0);
+	assert(fromFederation != NULL);
+	CheckSame(fromFederation, fromFiles);
+	ZitatespuckerZitatFree(fromFederation);
+	ZitatespuckerZitatFree(fromFiles);
+	fromFederation = ZitatespuckerSQLFederationGetZitatAllByDate(federation, true, 5, 6, 6, ZITATESPUCKER_FIELD_DATE);
+	fromFiles = ZitatespuckerSQLGetZitatAllFromFileByDateFields(files[0], true, 5, 6, 6, ZITATESPUCKER_FIELD_DATE);
+	CheckSame(fromFederation, fromFiles);
+	ZitatespuckerZitatFree(fromFederation);
+	ZitatespuckerZitatFree(fromFiles);
+	assert(ZitatespuckerSQLFederationGetZitatAllByDate(federation, false, 0, 0, 0, ZITATESPUCKER_FIELD_ALL) == NULL);
+	assert(ZitatespuckerSQLFederationGetZitatAllByDate(federation, true, 5, 0, 6, ZITATESPUCKER_FIELD_ALL) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether ZitatespuckerSQLFederationForEach() visits every row and stops when asked to...\n");
+	size_t left = SIZE_MAX;
+	assert(ZitatespuckerSQLFederationForEach(federation, NULL, ZITATESPUCKER_FIELD_AUTHOR, CountUpTo, &left) == FILES * ROWS_PER_FILE);
+	left = SIZE_MAX;
+	assert(ZitatespuckerSQLFederationForEach(federation, "Author 7", ZITATESPUCKER_FIELD_AUTHOR, CountUpTo, &left) == FILES * ROWS_PER_FILE / AUTHORS);
+	left = 3;
+	assert(ZitatespuckerSQLFederationForEach(federation, NULL, ZITATESPUCKER_FIELD_AUTHOR, CountUpTo, &left) == 3 && left == 0);
+	assert(ZitatespuckerSQLFederationForEach(federation, NULL, ZITATESPUCKER_FIELD_AUTHOR, NULL, NULL) == 0);
+	printf("OKAY!\n\n");
+	printf("Checking the time of %d author queries, one per file against one federated...\n", QUERIES);
+	double start = Seconds();
+	size_t rowsPerFile = 0;
+	for (int q = 0; q < QUERIES; q++) {
+		char author[16];
+		(void) snprintf(author, sizeof(author), "Author %d", q % AUTHORS);
+		for (size_t f = 0; f < FILES; f++) {
+			ZitatespuckerZitat *ZitatList = ZitatespuckerSQLGetZitatAllFromFileByAuthor(files[f], author);
+			rowsPerFile += ZitatespuckerZitatListLen(ZitatList);
+			ZitatespuckerZitatFree(ZitatList);
+		}
+	}
+	double perFile = Seconds() - start;
+	start = Seconds();
+	size_t rowsFederated = 0;
+	for (int q = 0; q < QUERIES; q++) {
+		char author[16];
+		(void) snprintf(author, sizeof(author), "Author %d", q % AUTHORS);
+		ZitatespuckerZitat *ZitatList = ZitatespuckerSQLFederationGetZitatAllByAuthor(federation, author, ZITATESPUCKER_FIELD_ALL);
+		rowsFederated += ZitatespuckerZitatListLen(ZitatList);
+		ZitatespuckerZitatFree(ZitatList);
+	}
+	double federated = Seconds() - start;
+	assert(rowsPerFile == rowsFederated && rowsFederated == QUERIES * FILES * ROWS_PER_FILE / AUTHORS);
+	printf("%.1f ms per file, %.1f ms federated (%.2fx)\n", perFile * 1000, federated * 1000, perFile / federated);
+	ZitatespuckerSQLFederationClose(federation);
+	for (size_t f = 0; f < FILES; f++)
+		(void) remove(files[f]);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -22,6 +22,10 @@
 #include <assert.h>
 
 
+/* SQLite headers */
+#include <sqlite3.h>
+
+
 /* Zitatespucker */
 #define ZITATESPUCKER_SQL
 #include "../Zitatespucker/Zitatespucker.h"
@@ -34,6 +38,19 @@ int main(int argc, char **argv)
 	assert(ZitatespuckerSQLGetAmountFromFile("wrongfilename.json") == 0);
 	printf("OKAY!\n\n\n");
 
+	printf("ZitatespuckerSQLGetZitatSingleFromFile:\n");
+	printf("Checking whether an out-of-range idx results in a NULL pointer...\n");
+	assert(ZitatespuckerSQLGetZitatSingleFromFile("../testfile.sqlite", 800) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether idx selects the entry at that position...\n");
+	ZitatespuckerZitat *ZitatAll = ZitatespuckerSQLGetZitatAllFromFile("../testfile.sqlite");
+	ZitatespuckerZitat *ZitatSingle = ZitatespuckerSQLGetZitatSingleFromFile("../testfile.sqlite", 1);
+	assert(ZitatAll != NULL && ZitatAll->nextZitat != NULL && ZitatSingle != NULL);
+	assert(ZitatSingle->year == ZitatAll->nextZitat->year && ZitatSingle->annodomini == ZitatAll->nextZitat->annodomini);
+	ZitatespuckerZitatFree(ZitatSingle);
+	ZitatespuckerZitatFree(ZitatAll);
+	printf("OKAY!\n\n\n");
+
 	printf("ZitatespuckerSQLGetZitatAllFromFile:\n");
 	printf("Checking whether a NULL filename results in a NULL pointer...\n");
 	assert(ZitatespuckerSQLGetZitatAllFromFile(NULL) == NULL);
@@ -64,5 +81,34 @@ int main(int argc, char **argv)
 	assert(ZitatespuckerSQLGetZitatAllFromFileByDate("testfile.sqlite", true, 0, 0, 1) == NULL);
 	printf("OKAY!\n\n\n");
 
+	printf("ZitatespuckerSQLImportList:\n");
+	printf("Checking whether an imported list reads back the same...\n");
+	ZitatespuckerSQLImportStats stats;
+	ZitatAll = ZitatespuckerSQLGetZitatAllFromFile("../testfile.sqlite");
+	(void) remove("import.sqlite");
+	assert(ZitatespuckerSQLImportList("import.sqlite", ZitatAll, &stats));
+	assert(stats.rows == ZitatespuckerZitatListLen(ZitatAll) && stats.failed == 0);
+	assert(ZitatespuckerSQLImportList("import.sqlite", ZitatAll, NULL));
+	assert(ZitatespuckerSQLGetAmountFromFile("import.sqlite") == 2 * stats.rows);
+	ZitatSingle = ZitatespuckerSQLGetZitatAllFromFileByAuthor("import.sqlite", "Ein Esel");
+	assert(ZitatespuckerZitatListLen(ZitatSingle) == 2 && ZitatSingle->day == 21 && ZitatSingle->annodomini);
+	ZitatespuckerZitatFree(ZitatSingle);
+	(void) remove("import.sqlite");
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerSQLImportList:\n");
+	printf("Checking whether rows of a batch that fails to commit are counted as failed, not as inserted...\n");
+	// a table taking the name of an index makes building the indexes (and with it the last commit) fail
+	sqlite3 *db;
+	assert(sqlite3_open("import.sqlite", &db) == SQLITE_OK);
+	assert(sqlite3_exec(db, "CREATE TABLE ZitatespuckerZitatByAuthor (x)", NULL, NULL, NULL) == SQLITE_OK);
+	(void) sqlite3_close(db);
+	assert(!ZitatespuckerSQLImportList("import.sqlite", ZitatAll, &stats));
+	assert(stats.rows == 0 && stats.failed == ZitatespuckerZitatListLen(ZitatAll));
+	assert(ZitatespuckerSQLGetAmountFromFile("import.sqlite") == 0);
+	ZitatespuckerZitatFree(ZitatAll);
+	(void) remove("import.sqlite");
+	printf("OKAY!\n\n\n");
+
 	printf("ALL CHECKS PASSED!\n\n\n\n\n");
 }
@@ -0,0 +1,190 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Pools of SQLite readers (Tests and benchmark)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define SYNTHETIC_AMOUNT	20000
+/* Characters that have a meaning within URIs, to check that they are escaped */
+#define SYNTHETIC_FILE		"sqlpool tests %20?#&.sqlite"
+#define MAX_THREADS			8
+#define SCANS_PER_THREAD	10
+
+
+typedef struct BenchThread {
+	pthread_t thread;
+	ZitatespuckerSQLPool *pool; /* NULL --> open the file for every scan instead */
+	size_t rows;
+} BenchThread;
+
+
+static void *Scan(void *arg)
+{
+	BenchThread *bench = (BenchThread *) arg;
+	ZitatespuckerSQLReader *reader = NULL;
+	if (bench->pool != NULL) {
+		reader = ZitatespuckerSQLPoolAcquire(bench->pool);
+		assert(reader != NULL);
+	}
+
+	for (int i = 0; i < SCANS_PER_THREAD; i++) {
+		ZitatespuckerZitat *ZitatList;
+		if (reader != NULL)
+			ZitatList = ZitatespuckerSQLReaderGetZitatAll(reader, ZITATESPUCKER_FIELD_AUTHOR | ZITATESPUCKER_FIELD_DATE);
+		else
+			ZitatList = ZitatespuckerSQLGetZitatAllFromFileFields(SYNTHETIC_FILE, ZITATESPUCKER_FIELD_AUTHOR | ZITATESPUCKER_FIELD_DATE);
+		bench->rows += ZitatespuckerZitatListLen(ZitatList);
+		ZitatespuckerZitatFree(ZitatList);
+	}
+
+	ZitatespuckerSQLPoolRelease(reader);
+	return NULL;
+}
+
+/* Run threads threads scanning the synthetic database through pool and return the rows scanned per second */
+static double Bench(ZitatespuckerSQLPool *pool, size_t threads)
+{
+	BenchThread bench[MAX_THREADS];
+	double start = Seconds();
+	for (size_t i = 0; i < threads; i++) {
+		bench[i].pool = pool;
+		bench[i].rows = 0;
+		assert(pthread_create(&bench[i].thread, NULL, Scan, &bench[i]) == 0);
+	}
+	size_t rows = 0;
+	for (size_t i = 0; i < threads; i++) {
+		assert(pthread_join(bench[i].thread, NULL) == 0);
+		rows += bench[i].rows;
+	}
+	double seconds = Seconds() - start;
+
+	assert(rows == threads * SCANS_PER_THREAD * SYNTHETIC_AMOUNT);
+	return (double) rows / seconds;
+}
+
+/* Check that every kind of query on a reader of pool matches the same query on the file */
+static void CheckPool(ZitatespuckerSQLPool *pool, const char *filename)
+{
+	ZitatespuckerSQLReader *reader = ZitatespuckerSQLPoolAcquire(pool);
+	assert(reader != NULL);
+
+	assert(ZitatespuckerSQLReaderGetAmount(reader) == ZitatespuckerSQLGetAmountFromFile(filename));
+
+	ZitatespuckerZitat *fromReader = ZitatespuckerSQLReaderGetZitatAll(reader, ZITATESPUCKER_FIELD_ALL);
+	ZitatespuckerZitat *fromFile = ZitatespuckerSQLGetZitatAllFromFile(filename);
+	assert(fromReader != NULL && ZitatespuckerZitatListLen(fromReader) == ZitatespuckerZitatListLen(fromFile));
+	for (ZitatespuckerZitat *a = fromReader, *b = fromFile; a != NULL; a = a->nextZitat, b = b->nextZitat)
+		assert(ZitatespuckerZitatHash(a) == ZitatespuckerZitatHash(b));
+
+	ZitatespuckerZitat *single = ZitatespuckerSQLReaderGetZitatSingle(reader, 1, ZITATESPUCKER_FIELD_ALL);
+	assert(single != NULL && ZitatespuckerZitatHash(single) == ZitatespuckerZitatHash(fromFile->nextZitat));
+	ZitatespuckerZitatFree(single);
+
+	ZitatespuckerZitat *byAuthor = ZitatespuckerSQLReaderGetZitatAllByAuthor(reader, fromFile->author, ZITATESPUCKER_FIELD_ALL);
+	assert(byAuthor != NULL && strcmp(byAuthor->author, fromFile->author) == 0);
+	ZitatespuckerZitatFree(byAuthor);
+
+	ZitatespuckerZitat *byDate = ZitatespuckerSQLReaderGetZitatAllByDate(reader, fromFile->annodomini, fromFile->year, 0, 0, ZITATESPUCKER_FIELD_DATE);
+	assert(byDate != NULL && byDate->year == fromFile->year && byDate->author == NULL);
+	ZitatespuckerZitatFree(byDate);
+
+	ZitatespuckerZitatFree(fromFile);
+	ZitatespuckerZitatFree(fromReader);
+	ZitatespuckerSQLPoolRelease(reader);
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerSQLPool *pool;
+	ZitatespuckerSQLReader *reader;
+	ZitatespuckerSQLReader *other;
+
+	printf("ZitatespuckerSQLPoolOpen:\n");
+	printf("Checking whether a NULL or missing file results in a NULL pointer...\n");
+	assert(ZitatespuckerSQLPoolOpen(NULL, false) == NULL);
+	assert(ZitatespuckerSQLPoolOpen("../doesnotexist.sqlite", false) == NULL);
+	assert(ZitatespuckerSQLPoolOpen("../doesnotexist.sqlite", true) == NULL);
+	assert(ZitatespuckerSQLPoolAcquire(NULL) == NULL && ZitatespuckerSQLReaderGetZitatAll(NULL, ZITATESPUCKER_FIELD_ALL) == NULL);
+	ZitatespuckerSQLPoolRelease(NULL);
+	ZitatespuckerSQLPoolClose(NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether readers see the same as the *FromFile() functions...\n");
+	for (int immutable = 0; immutable < 2; immutable++) {
+		pool = ZitatespuckerSQLPoolOpen("../testfile.sqlite", immutable);
+		assert(pool != NULL);
+		CheckPool(pool, "../testfile.sqlite");
+		ZitatespuckerSQLPoolClose(pool);
+	}
+	printf("OKAY!\n\n");
+	printf("Checking whether readers are reused and kept apart...\n");
+	pool = ZitatespuckerSQLPoolOpen("../testfile.sqlite", true);
+	reader = ZitatespuckerSQLPoolAcquire(pool);
+	other = ZitatespuckerSQLPoolAcquire(pool);
+	assert(reader != NULL && other != NULL && reader != other);
+	ZitatespuckerSQLPoolRelease(other);
+	assert(ZitatespuckerSQLPoolAcquire(pool) == other);
+	ZitatespuckerSQLPoolRelease(other);
+	printf("OKAY!\n\n");
+	printf("Checking whether a reader outlives the pool being closed...\n");
+	ZitatespuckerSQLPoolClose(pool);
+	assert(ZitatespuckerSQLReaderGetAmount(reader) == ZitatespuckerSQLGetAmountFromFile("../testfile.sqlite"));
+	ZitatespuckerSQLPoolRelease(reader);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerSQLPool (synthetic database):\n");
+	printf("Checking whether file names that need escaping within URIs work...\n");
+	SyntheticDatabase(SYNTHETIC_FILE, SYNTHETIC_AMOUNT, 500);
+	pool = ZitatespuckerSQLPoolOpen(SYNTHETIC_FILE, true);
+	assert(pool != NULL);
+	CheckPool(pool, SYNTHETIC_FILE);
+	printf("OKAY!\n\n");
+	printf("Checking the scan throughput for 1 to %d threads...\n", MAX_THREADS);
+	ZitatespuckerSQLPool *mutable = ZitatespuckerSQLPoolOpen(SYNTHETIC_FILE, false);
+	assert(mutable != NULL);
+	double single = 0;
+	for (size_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+		double perFile = Bench(NULL, threads);
+		double perMutable = Bench(mutable, threads);
+		double perImmutable = Bench(pool, threads);
+		if (threads == 1)
+			single = perImmutable;
+		printf("%zu thread(s): %.0f rows/s opening the file, %.0f rows/s pooled, %.0f rows/s pooled immutable (%.2fx one thread)\n",
+			threads, perFile, perMutable, perImmutable, perImmutable / single);
+	}
+	ZitatespuckerSQLPoolClose(mutable);
+	ZitatespuckerSQLPoolClose(pool);
+	(void) remove(SYNTHETIC_FILE);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,107 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Reading SQLite tables on several threads (Tests and benchmark)
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime() */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+
+/* Zitatespucker */
+#define ZITATESPUCKER_SQL
+#include "../Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker_tests.h"
+
+
+#define SYNTHETIC_AMOUNT	400000
+#define SYNTHETIC_FILE		"sqlshard tests.sqlite"
+#define MAX_THREADS			8
+
+
+/* Check that a and b hold the same elements in the same order, linked both ways */
+static void CheckSame(ZitatespuckerZitat *a, ZitatespuckerZitat *b)
+{
+	assert(ZitatespuckerZitatListLen(a) == ZitatespuckerZitatListLen(b));
+	assert(a == NULL || a->prevZitat == NULL);
+	for (; a != NULL; a = a->nextZitat, b = b->nextZitat) {
+		assert(ZitatespuckerZitatHash(a) == ZitatespuckerZitatHash(b));
+		assert(a->nextZitat == NULL || a->nextZitat->prevZitat == a);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerZitat *sharded;
+	ZitatespuckerZitat *whole;
+
+	printf("ZitatespuckerSQLGetZitatAllFromFileThreads:\n");
+	printf("Checking whether a NULL or missing file results in a NULL pointer...\n");
+	assert(ZitatespuckerSQLGetZitatAllFromFileThreads(NULL, ZITATESPUCKER_FIELD_ALL, 0) == NULL);
+	assert(ZitatespuckerSQLGetZitatAllFromFileThreads("../doesnotexist.sqlite", ZITATESPUCKER_FIELD_ALL, 4) == NULL);
+	printf("OKAY!\n\n");
+	printf("Checking whether a small table is read the same with any number of threads...\n");
+	whole = ZitatespuckerSQLGetZitatAllFromFile("../testfile.sqlite");
+	assert(whole != NULL);
+	for (size_t threads = 0; threads <= 10; threads++) {
+		sharded = ZitatespuckerSQLGetZitatAllFromFileThreads("../testfile.sqlite", ZITATESPUCKER_FIELD_ALL, threads);
+		CheckSame(sharded, whole);
+		ZitatespuckerZitatFree(sharded);
+	}
+	ZitatespuckerZitatFree(whole);
+	printf("OKAY!\n\n\n");
+
+	printf("ZitatespuckerSQLGetZitatAllFromFileThreads (synthetic database):\n");
+	SyntheticDatabase(SYNTHETIC_FILE, SYNTHETIC_AMOUNT, 1);
+	printf("Checking whether the pieces are linked in rowid order...\n");
+	whole = ZitatespuckerSQLGetZitatAllFromFileFields(SYNTHETIC_FILE, ZITATESPUCKER_FIELD_ALL);
+	sharded = ZitatespuckerSQLGetZitatAllFromFileThreads(SYNTHETIC_FILE, ZITATESPUCKER_FIELD_ALL, 7);
+	CheckSame(sharded, whole);
+	ZitatespuckerZitatFree(sharded);
+	ZitatespuckerZitatFree(whole);
+	sharded = ZitatespuckerSQLGetZitatAllFromFileThreads(SYNTHETIC_FILE, ZITATESPUCKER_FIELD_ZITAT, 0);
+	assert(ZitatespuckerZitatListLen(sharded) == SYNTHETIC_AMOUNT && sharded->author == NULL && strcmp(sharded->zitat, "Quote number 0") == 0);
+	ZitatespuckerZitatFree(sharded);
+	printf("OKAY!\n\n");
+	printf("Checking the load throughput for 1 to %d threads...\n", MAX_THREADS);
+	double start = Seconds();
+	whole = ZitatespuckerSQLGetZitatAllFromFile(SYNTHETIC_FILE);
+	double single = Seconds() - start;
+	assert(ZitatespuckerZitatListLen(whole) == SYNTHETIC_AMOUNT);
+	ZitatespuckerZitatFree(whole);
+	printf("ZitatespuckerSQLGetZitatAllFromFile(): %.0f rows/s\n", SYNTHETIC_AMOUNT / single);
+	double one = 0;
+	for (size_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+		start = Seconds();
+		sharded = ZitatespuckerSQLGetZitatAllFromFileThreads(SYNTHETIC_FILE, ZITATESPUCKER_FIELD_ALL, threads);
+		double seconds = Seconds() - start;
+		assert(ZitatespuckerZitatListLen(sharded) == SYNTHETIC_AMOUNT);
+		ZitatespuckerZitatFree(sharded);
+		if (threads == 1)
+			one = seconds;
+		printf("%zu thread(s): %.0f rows/s (%.2fx one thread)\n", threads, SYNTHETIC_AMOUNT / seconds, one / seconds);
+	}
+	(void) remove(SYNTHETIC_FILE);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,92 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Helpers shared by the tests
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+#ifndef ZITATESPUCKER_TESTS_H
+#define ZITATESPUCKER_TESTS_H
+
+/*
+	Included after Zitatespucker.h, by tests that define _POSIX_C_SOURCE (for clock_gettime()) before any header.
+	SyntheticDatabase() is only there if ZITATESPUCKER_SQL is defined.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <assert.h>
+
+
+/* Size of the author and zitat buffers of each element returned by SyntheticList() */
+#define SYNTHETIC_TEXT_LEN	40
+
+
+/*
+	Returns the time of a monotonic clock in seconds, for timing what the tests measure.
+*/
+static inline double Seconds(void)
+{
+	struct timespec now;
+	(void) clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+/*
+	Returns amount elements in a single array, linked both ways in order.
+	Element i is "Quote number <i>" by "Author <i % authors>", from the year i % 2024 AD.
+	author and zitat point into buffers of SYNTHETIC_TEXT_LEN bytes behind the array, so they can be rewritten in place.
+
+	The array (buffers included) must be freed using free().
+*/
+static inline ZitatespuckerZitat *SyntheticList(size_t amount, size_t authors)
+{
+	ZitatespuckerZitat *Zitate = (ZitatespuckerZitat *) calloc(amount, sizeof(ZitatespuckerZitat) + 2 * SYNTHETIC_TEXT_LEN);
+	assert(Zitate != NULL);
+
+	char *texts = (char *) &Zitate[amount];
+	for (size_t i = 0; i < amount; i++) {
+		ZitatespuckerZitatInit(&Zitate[i]);
+		Zitate[i].author = &texts[2 * i * SYNTHETIC_TEXT_LEN];
+		Zitate[i].zitat = &texts[(2 * i + 1) * SYNTHETIC_TEXT_LEN];
+		(void) snprintf(Zitate[i].author, SYNTHETIC_TEXT_LEN, "Author %zu", i % authors);
+		(void) snprintf(Zitate[i].zitat, SYNTHETIC_TEXT_LEN, "Quote number %zu", i);
+		Zitate[i].year = (uint16_t) (i % 2024);
+		Zitate[i].annodomini = true;
+		Zitate[i].nextZitat = (i + 1 < amount ? &Zitate[i + 1] : NULL);
+		Zitate[i].prevZitat = (i > 0 ? &Zitate[i - 1] : NULL);
+	}
+
+	return Zitate;
+}
+
+#ifdef ZITATESPUCKER_SQL
+/*
+	Replace filename with a database holding SyntheticList(amount, authors).
+*/
+static inline void SyntheticDatabase(const char *filename, size_t amount, size_t authors)
+{
+	ZitatespuckerZitat *Zitate = SyntheticList(amount, authors);
+	(void) remove(filename);
+	assert(ZitatespuckerSQLImportList(filename, Zitate, NULL));
+	free((void *) Zitate);
+
+	return;
+}
+#endif
+
+
+#endif
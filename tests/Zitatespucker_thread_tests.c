@@ -0,0 +1,121 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	Concurrent loads and queries (Tests; meant to be run under ThreadSanitizer, see 'make check-tsan')
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <assert.h>
+#include <pthread.h>
+
+
+/* Zitatespucker; 'make check-tsan' passes these on the command line already */
+#ifndef ZITATESPUCKER_JSON
+	#define ZITATESPUCKER_JSON
+#endif
+#ifndef ZITATESPUCKER_SQL
+	#define ZITATESPUCKER_SQL
+#endif
+#ifndef ZITATESPUCKER_CACHE
+	#define ZITATESPUCKER_CACHE
+#endif
+#include "../Zitatespucker/Zitatespucker.h"
+
+
+#define THREADS		8
+#define ITERATIONS	200
+
+
+static ZitatespuckerSnapshot *shared;
+static ZitatespuckerAuthorIndex *authors; /* Not built until the first query, which all threads race for */
+static size_t jsonLen;
+static size_t sqlLen;
+
+
+static void *worker(void *arg)
+{
+	size_t id = (size_t) arg;
+
+	ZitatespuckerAuthorMatch match;
+	assert(ZitatespuckerAuthorIndexPrefix(authors, "tor", &match, 1) == 1 && match.amount == 1);
+
+	for (size_t i = 0; i < ITERATIONS; i++) {
+		// private loads
+		ZitatespuckerZitat *ZitatList = ZitatespuckerJSONGetZitatAllFromFile("../../examples/example.json");
+		assert(ZitatespuckerZitatListLen(ZitatList) == jsonLen);
+		ZitatespuckerZitatFree(ZitatList);
+
+		ZitatList = ZitatespuckerSQLGetZitatAllFromFileByAuthor("../testfile.sqlite", "Linus Torvalds");
+		assert(ZitatespuckerZitatListLen(ZitatList) == 1);
+		ZitatespuckerZitatFree(ZitatList);
+
+		// failing loads must not trample on each other either
+		if (i == 0)
+			assert(ZitatespuckerJSONGetZitatAllFromFile("../testfile_noarray.json") == NULL);
+
+		// shared loads
+		const ZitatespuckerZitat *cached = ZitatespuckerCacheGetZitatAllFromFile((id % 2 ? "../../examples/example.json" : "../testfile.sqlite"), ZITATESPUCKER_SOURCE_UNKNOWN);
+		assert(ZitatespuckerZitatListLen((ZitatespuckerZitat *) cached) == (id % 2 ? jsonLen : sqlLen));
+		ZitatespuckerCacheRelease(cached);
+
+		// shared snapshot
+		ZitatespuckerSnapshot *snapshot = ZitatespuckerSnapshotRetain(shared);
+		assert(ZitatespuckerSnapshotFindByAuthor(snapshot, "Ein Esel", 0) == 1);
+		assert(ZitatespuckerSnapshotFindByDate(snapshot, true, 1996, 0, 0, 0) == 0);
+		size_t n = 0;
+		for (const ZitatespuckerZitat *cur = ZitatespuckerSnapshotGet(snapshot, 0); cur != NULL; cur = cur->nextZitat)
+			n++;
+		assert(n == ZitatespuckerSnapshotLen(snapshot));
+		ZitatespuckerSnapshotRelease(snapshot);
+	}
+
+	return NULL;
+}
+
+
+int main(int argc, char **argv)
+{
+	pthread_t threads[THREADS];
+
+	jsonLen = ZitatespuckerJSONGetAmountFromFile("../../examples/example.json");
+	sqlLen = ZitatespuckerSQLGetAmountFromFile("../testfile.sqlite");
+
+	printf("ZitatespuckerSnapshotFromFile:\n");
+	printf("Checking whether a snapshot holds every element...\n");
+	shared = ZitatespuckerSnapshotFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(shared != NULL && ZitatespuckerSnapshotLen(shared) == sqlLen);
+	assert(ZitatespuckerSnapshotGet(shared, sqlLen) == NULL);
+	printf("OKAY!\n\n\n");
+
+	authors = ZitatespuckerAuthorIndexFromFile("../testfile.sqlite", ZITATESPUCKER_SOURCE_UNKNOWN);
+	assert(authors != NULL);
+
+	printf("Concurrency:\n");
+	printf("Checking whether %d threads can load and query at the same time...\n", THREADS);
+	ZitatespuckerCacheSetLimit(1024 * 1024);
+	for (size_t i = 0; i < THREADS; i++)
+		assert(pthread_create(&threads[i], NULL, worker, (void *) i) == 0);
+	for (size_t i = 0; i < THREADS; i++)
+		assert(pthread_join(threads[i], NULL) == 0);
+	ZitatespuckerSnapshotRelease(shared);
+	assert(ZitatespuckerAuthorIndexGetAmount(authors) == 5);
+	ZitatespuckerAuthorIndexFree(authors);
+	ZitatespuckerCacheSetLimit(0);
+	printf("OKAY!\n\n\n");
+
+	printf("ALL CHECKS PASSED!\n\n\n\n\n");
+}
@@ -0,0 +1,112 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	zitatespucker-embed: turn a quote source into C code to compile into a program
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Zitatespucker */
+#include "Zitatespucker/Zitatespucker.h"
+
+
+static void EmbedUsage(void)
+{
+	(void) fprintf(stderr,
+		"Usage: zitatespucker-embed [--type json|sql|ndjson|csv] [--name NAME] FILE OUTPUT\n"
+		"Writes every quote in FILE to OUTPUT.c as a constant ZitatespuckerEmbed called NAME,\n"
+		"declared in OUTPUT.h (see Zitatespucker_embed.h). NAME defaults to ZitatespuckerEmbedded.\n");
+}
+
+int main(int argc, char **argv)
+{
+	ZitatespuckerSource source = ZITATESPUCKER_SOURCE_UNKNOWN;
+	const char *name = "ZitatespuckerEmbedded";
+
+	int argi = 1;
+	for (; argi < argc && strncmp(argv[argi], "--", 2) == 0; argi++) {
+		if (strcmp(argv[argi], "--type") == 0 && argi + 1 < argc) {
+			argi++;
+			if (strcmp(argv[argi], "json") == 0) {
+				source = ZITATESPUCKER_SOURCE_JSON;
+			} else if (strcmp(argv[argi], "sql") == 0) {
+				source = ZITATESPUCKER_SOURCE_SQL;
+			} else if (strcmp(argv[argi], "ndjson") == 0) {
+				source = ZITATESPUCKER_SOURCE_NDJSON;
+			} else if (strcmp(argv[argi], "csv") == 0) {
+				source = ZITATESPUCKER_SOURCE_CSV;
+			} else {
+				EmbedUsage();
+				return EXIT_FAILURE;
+			}
+		} else if (strcmp(argv[argi], "--name") == 0 && argi + 1 < argc) {
+			name = argv[++argi];
+		} else if (strcmp(argv[argi], "--help") == 0) {
+			EmbedUsage();
+			return EXIT_SUCCESS;
+		} else if (strcmp(argv[argi], "--") == 0) {
+			argi++;
+			break;
+		} else {
+			EmbedUsage();
+			return EXIT_FAILURE;
+		}
+	}
+	if (argc - argi != 2) {
+		EmbedUsage();
+		return EXIT_FAILURE;
+	}
+	const char *filename = argv[argi];
+	const char *output = argv[argi + 1];
+
+	ZitatespuckerZitat *ZitatList;
+	if ((ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filename, source)) == NULL) {
+		(void) fprintf(stderr, "zitatespucker-embed: could not read any quotes from \"%s\"\n", filename);
+		return EXIT_FAILURE;
+	}
+
+	size_t outputLen = strlen(output);
+	char *path;
+	if ((path = (char *) malloc(outputLen + 3)) == NULL) {
+		ZitatespuckerZitatFree(ZitatList);
+		return EXIT_FAILURE;
+	}
+	(void) memcpy(path, output, outputLen);
+
+	(void) memcpy(path + outputLen, ".c", 3);
+	FILE *csource = fopen(path, "w");
+	(void) memcpy(path + outputLen, ".h", 3);
+	FILE *header = fopen(path, "w");
+
+	bool ok = false;
+	if (csource == NULL || header == NULL)
+		(void) fprintf(stderr, "zitatespucker-embed: cannot create \"%s.c\" and \"%s.h\"\n", output, output);
+	else
+		ok = ZitatespuckerEmbedWrite(ZitatList, name, csource, header);
+
+	if (csource != NULL && fclose(csource) != 0)
+		ok = false;
+	if (header != NULL && fclose(header) != 0)
+		ok = false;
+	free((void *) path);
+	ZitatespuckerZitatFree(ZitatList);
+
+	return (ok ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,188 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	zitatespucker-loadgen: measure throughput and latency of zitatespuckerd
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime, getopt */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+
+/* Zitatespucker */
+#include "Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker/Zitatespucker_client.h"
+
+
+typedef struct LoadgenWorker {
+	pthread_t thread;
+	const char *socketpath;
+	const char *query;
+	const char *argument;
+	size_t requests;
+	uint64_t *latencies; /* nanoseconds, one per completed request */
+	size_t completed;
+	size_t empty; /* completed, but nothing matched */
+	size_t failures;
+} LoadgenWorker;
+
+
+static inline uint64_t LoadgenNow(void)
+{
+	struct timespec ts;
+	(void) clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static int LoadgenCompare(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *) a;
+	uint64_t y = *(const uint64_t *) b;
+	return (x < y ? -1 : (x > y));
+}
+
+static void *LoadgenRun(void *arg)
+{
+	LoadgenWorker *worker = (LoadgenWorker *) arg;
+
+	ZitatespuckerClient *client;
+	if ((client = ZitatespuckerClientConnect(worker->socketpath)) == NULL) {
+		worker->failures = worker->requests;
+		return NULL;
+	}
+	size_t amount = ZitatespuckerClientGetAmount(client);
+
+	for (size_t i = 0; i < worker->requests; i++) {
+		ZitatespuckerDiagClear();
+		uint64_t start = LoadgenNow();
+		ZitatespuckerZitat *ZitatList;
+		if (strcmp(worker->query, "author") == 0)
+			ZitatList = ZitatespuckerClientGetZitatAllByAuthor(client, worker->argument, 100);
+		else if (strcmp(worker->query, "search") == 0)
+			ZitatList = ZitatespuckerClientGetZitatAllBySearch(client, worker->argument, 100);
+		else if (strcmp(worker->query, "date") == 0)
+			ZitatList = ZitatespuckerClientGetZitatAllByDate(client, true, (uint16_t) atoi(worker->argument), 0, 0, 100);
+		else if (strcmp(worker->query, "range") == 0)
+			ZitatList = ZitatespuckerClientGetZitatRange(client, (uint32_t) (amount != 0 ? i % amount : 0), 10);
+		else
+			ZitatList = ZitatespuckerClientGetZitatRandom(client);
+		uint64_t latency = LoadgenNow() - start;
+
+		// a NULL without an error is an answer as well, just an empty one
+		if (ZitatList == NULL && ZitatespuckerDiagGetLastError() != ZITATESPUCKER_ERROR_NONE) {
+			worker->failures++;
+			continue;
+		}
+		if (ZitatList == NULL)
+			worker->empty++;
+		worker->latencies[worker->completed++] = latency;
+		ZitatespuckerZitatFree(ZitatList);
+	}
+
+	ZitatespuckerClientClose(client);
+
+	return NULL;
+}
+
+static void LoadgenUsage(void)
+{
+	(void) fprintf(stderr,
+		"Usage: zitatespucker-loadgen [-s socketpath] [-c connections] [-n requests] [-q query] [-a argument]\n"
+		"query is one of random (default), range, author, date, search;\n"
+		"author and search take the text as argument, date the (AD) year.\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *socketpath = ZITATESPUCKER_DEFAULT_SOCKET;
+	const char *query = "random";
+	const char *argument = "";
+	size_t connections = 4;
+	size_t requests = 100000;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "s:c:n:q:a:h")) != -1) {
+		switch (opt) {
+			case 's': socketpath = optarg; break;
+			case 'c': connections = (size_t) strtoul(optarg, NULL, 10); break;
+			case 'n': requests = (size_t) strtoul(optarg, NULL, 10); break;
+			case 'q': query = optarg; break;
+			case 'a': argument = optarg; break;
+			default:
+				LoadgenUsage();
+				return (opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+	}
+	if (connections == 0 || requests == 0) {
+		LoadgenUsage();
+		return EXIT_FAILURE;
+	}
+
+	LoadgenWorker *workers;
+	uint64_t *latencies;
+	if ((workers = (LoadgenWorker *) calloc(connections, sizeof(LoadgenWorker))) == NULL
+	|| (latencies = (uint64_t *) malloc(connections * requests * sizeof(uint64_t))) == NULL) {
+		(void) fprintf(stderr, "zitatespucker-loadgen: out of memory\n");
+		return EXIT_FAILURE;
+	}
+
+	uint64_t start = LoadgenNow();
+	for (size_t i = 0; i < connections; i++) {
+		workers[i].socketpath = socketpath;
+		workers[i].query = query;
+		workers[i].argument = argument;
+		workers[i].requests = requests;
+		workers[i].latencies = latencies + i * requests;
+		if (pthread_create(&workers[i].thread, NULL, LoadgenRun, &workers[i]) != 0) {
+			(void) fprintf(stderr, "zitatespucker-loadgen: pthread_create() failed\n");
+			return EXIT_FAILURE;
+		}
+	}
+	// the latencies of completed requests, moved together
+	size_t completed = 0, empty = 0, failures = 0;
+	for (size_t i = 0; i < connections; i++) {
+		(void) pthread_join(workers[i].thread, NULL);
+		(void) memmove(latencies + completed, workers[i].latencies, workers[i].completed * sizeof(uint64_t));
+		completed += workers[i].completed;
+		empty += workers[i].empty;
+		failures += workers[i].failures;
+	}
+	double seconds = (double) (LoadgenNow() - start) / 1e9;
+
+	size_t total = connections * requests;
+	(void) printf("query:       %s\n", query);
+	(void) printf("connections: %zu\n", connections);
+	(void) printf("requests:    %zu (%zu completed, %zu of them empty, %zu failed)\n", total, completed, empty, failures);
+	if (completed != 0) {
+		qsort(latencies, completed, sizeof(uint64_t), LoadgenCompare);
+		(void) printf("throughput:  %.0f requests/s\n", (double) completed / seconds);
+		(void) printf("latency p50: %.1f us\n", (double) latencies[completed / 2] / 1e3);
+		(void) printf("latency p99: %.1f us\n", (double) latencies[(completed * 99) / 100] / 1e3);
+		(void) printf("latency max: %.1f us\n", (double) latencies[completed - 1] / 1e3);
+	}
+
+	free((void *) latencies);
+	free((void *) workers);
+
+	return (completed == 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
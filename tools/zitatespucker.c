@@ -0,0 +1,329 @@
+/*
+	SPDX-License-Identifier: 0BSD
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	zitatespucker: query any supported quote source from the command line
+
+	Copyright (C) 2024 by Sembo Sadur <labmailssadur@gmail.com>
+
+	Permission to use, copy, modify, and/or distribute this software
+	for any purpose with or without fee is hereby granted.
+
+	THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+	WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS.
+	IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES
+	OR ANY DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+	NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+
+/* clock_gettime, getrusage */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+
+/* Zitatespucker */
+#include "Zitatespucker/Zitatespucker.h"
+
+
+/* Phases that --stats reports on */
+enum CliPhase {
+	CLI_PHASE_DETECT = 0,
+	CLI_PHASE_LOAD,
+	CLI_PHASE_OUTPUT,
+	CLI_PHASE_MAX
+};
+
+static const char *CliPhaseNames[CLI_PHASE_MAX] = {"detect", "load", "output"};
+
+
+static inline uint64_t CliNow(void)
+{
+	struct timespec ts;
+	(void) clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void CliUsage(void)
+{
+	(void) fprintf(stderr,
+		"Usage: zitatespucker [--stats] [--verbose] [--type json|sql|ndjson|csv] FILE COMMAND [ARGS]\n"
+		"Commands:\n"
+		"  count                             number of quotes in FILE\n"
+		"  all                               every quote\n"
+		"  single IDX                        the quote at position IDX (counting from 0)\n"
+		"  author NAME                       every quote by NAME\n"
+		"  date ad|bc YEAR [MONTH [DAY]]     every quote from that date (0 matches anything)\n"
+		"  random                            one quote picked at random\n"
+		"  group author|year|decade|century|era\n"
+		"                                    number of quotes per author or period\n"
+		"  export                            every quote as Zitatespucker .json\n"
+		"  import DATABASE                   copy every quote into the SQLite DATABASE (created if need be)\n"
+		"  index                             write an index next to the .json FILE, for reading single quotes without parsing all of it\n"
+		"--stats prints per-phase timings, the record count, peak memory and the warnings counted while loading to stderr.\n"
+		"--verbose prints every error and warning of the library (e.g. each record missing a key) to stderr.\n");
+}
+
+/* Tell why the library failed, unless --verbose already did */
+static void CliReportFailure(bool verbose)
+{
+	if (!verbose && ZitatespuckerDiagGetLastError() != ZITATESPUCKER_ERROR_NONE)
+		(void) fprintf(stderr, "zitatespucker: %s\n", ZitatespuckerDiagGetLastMessage());
+}
+
+static bool CliParseNumber(const char *str, unsigned long max, unsigned long *out)
+{
+	char *end;
+	if (*str == '\0' || *str == '-')
+		return false;
+	unsigned long val = strtoul(str, &end, 10);
+	if (*end != '\0' || val > max)
+		return false;
+	*out = val;
+	return true;
+}
+
+static void CliPrintCounts(FILE *out, const ZitatespuckerCounts *counts)
+{
+	for (size_t i = 0; i < counts->len; i++) {
+		const ZitatespuckerCount *count = &counts->counts[i];
+		if (counts->group == ZITATESPUCKER_GROUP_AUTHOR)
+			(void) fprintf(out, "%zu\t%s\n", count->amount, (count->author != NULL ? count->author : "Unknown"));
+		else if (counts->group == ZITATESPUCKER_GROUP_ERA)
+			(void) fprintf(out, "%zu\t%s\n", count->amount, (count->annodomini ? "AD" : "BC"));
+		else
+			(void) fprintf(out, "%zu\t%u%s %s\n", count->amount, (unsigned int) count->year, (counts->group == ZITATESPUCKER_GROUP_YEAR ? "" : "s"), (count->annodomini ? "AD" : "BC"));
+	}
+	if (counts->undated != 0)
+		(void) fprintf(out, "%zu\tinvalid date\n", counts->undated);
+}
+
+static void CliPrintZitat(FILE *out, const ZitatespuckerZitat *Zitat)
+{
+	(void) fprintf(out, "%s\n\t-- %s", (Zitat->zitat != NULL ? Zitat->zitat : ""), (Zitat->author != NULL ? Zitat->author : "Unknown"));
+	if (Zitat->year != 0 || Zitat->annodomini) {
+		(void) fputs(", ", out);
+		if (Zitat->day != 0)
+			(void) fprintf(out, "%u.", (unsigned int) Zitat->day);
+		if (Zitat->month != 0)
+			(void) fprintf(out, "%u.", (unsigned int) Zitat->month);
+		(void) fprintf(out, "%u %s", (unsigned int) Zitat->year, (Zitat->annodomini ? "AD" : "BC"));
+	}
+	(void) fputc('\n', out);
+	if (Zitat->comment != NULL)
+		(void) fprintf(out, "\t(%s)\n", Zitat->comment);
+}
+
+int main(int argc, char **argv)
+{
+	bool stats = false;
+	bool verbose = false;
+	ZitatespuckerSource source = ZITATESPUCKER_SOURCE_UNKNOWN;
+
+	int argi = 1;
+	for (; argi < argc && strncmp(argv[argi], "--", 2) == 0; argi++) {
+		if (strcmp(argv[argi], "--stats") == 0) {
+			stats = true;
+		} else if (strcmp(argv[argi], "--verbose") == 0) {
+			verbose = true;
+		} else if (strcmp(argv[argi], "--type") == 0 && argi + 1 < argc) {
+			argi++;
+			if (strcmp(argv[argi], "json") == 0) {
+				source = ZITATESPUCKER_SOURCE_JSON;
+			} else if (strcmp(argv[argi], "sql") == 0) {
+				source = ZITATESPUCKER_SOURCE_SQL;
+			} else if (strcmp(argv[argi], "ndjson") == 0) {
+				source = ZITATESPUCKER_SOURCE_NDJSON;
+			} else if (strcmp(argv[argi], "csv") == 0) {
+				source = ZITATESPUCKER_SOURCE_CSV;
+			} else {
+				CliUsage();
+				return EXIT_FAILURE;
+			}
+		} else if (strcmp(argv[argi], "--help") == 0) {
+			CliUsage();
+			return EXIT_SUCCESS;
+		} else if (strcmp(argv[argi], "--") == 0) {
+			argi++;
+			break;
+		} else {
+			CliUsage();
+			return EXIT_FAILURE;
+		}
+	}
+	if (argc - argi < 2) {
+		CliUsage();
+		return EXIT_FAILURE;
+	}
+	const char *filename = argv[argi];
+	const char *command = argv[argi + 1];
+	char **args = argv + argi + 2;
+	int nargs = argc - argi - 2;
+
+	if (verbose)
+		ZitatespuckerDiagSetSink(ZitatespuckerDiagStderr, NULL);
+
+	uint64_t phase[CLI_PHASE_MAX] = {0};
+	uint64_t start = CliNow();
+
+	if (source == ZITATESPUCKER_SOURCE_UNKNOWN) {
+		source = ZitatespuckerSourceDetect(filename);
+		if (source == ZITATESPUCKER_SOURCE_UNKNOWN) {
+			(void) fprintf(stderr, "zitatespucker: cannot tell what kind of source \"%s\" is; try --type\n", filename);
+			return EXIT_FAILURE;
+		}
+	}
+	phase[CLI_PHASE_DETECT] = CliNow() - start;
+
+	size_t records = 0;
+	bool summary = false;
+	bool exporting = false;
+	ZitatespuckerZitat *ZitatList = NULL;
+	ZitatespuckerCounts *counts = NULL;
+	unsigned long num;
+
+	start = CliNow();
+	if (strcmp(command, "count") == 0 && nargs == 0) {
+		// 0 is also what an empty file counts, only the diagnostics tell a failure apart
+		ZitatespuckerDiagClear();
+		records = ZitatespuckerSourceGetAmountFromFile(filename, source);
+		if (records == 0 && ZitatespuckerDiagGetLastError() != ZITATESPUCKER_ERROR_NONE) {
+			CliReportFailure(verbose);
+			return EXIT_FAILURE;
+		}
+		summary = true;
+	} else if ((strcmp(command, "all") == 0 || strcmp(command, "export") == 0) && nargs == 0) {
+		ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filename, source);
+		exporting = (command[0] == 'e');
+	} else if (strcmp(command, "single") == 0 && nargs == 1 && CliParseNumber(args[0], SIZE_MAX, &num)) {
+		ZitatList = ZitatespuckerSourceGetZitatSingleFromFile(filename, source, (size_t) num);
+	} else if (strcmp(command, "author") == 0 && nargs == 1) {
+		ZitatList = ZitatespuckerSourceGetZitatAllFromFileByAuthor(filename, source, args[0]);
+	} else if (strcmp(command, "date") == 0 && nargs >= 2 && nargs <= 4
+	&& (strcmp(args[0], "ad") == 0 || strcmp(args[0], "bc") == 0)) {
+		unsigned long date[3] = {0, 0, 0};
+		static const unsigned long datemax[3] = {UINT16_MAX, 12, 31};
+		for (int i = 1; i < nargs; i++) {
+			if (!CliParseNumber(args[i], datemax[i - 1], &date[i - 1])) {
+				CliUsage();
+				return EXIT_FAILURE;
+			}
+		}
+		ZitatList = ZitatespuckerSourceGetZitatAllFromFileByDate(filename, source, (args[0][0] == 'a'), (uint16_t) date[0], (uint8_t) date[1], (uint8_t) date[2]);
+	} else if (strcmp(command, "random") == 0 && nargs == 0) {
+		size_t amount = ZitatespuckerSourceGetAmountFromFile(filename, source);
+		if (amount != 0) {
+			srand((unsigned int) time(NULL) ^ (unsigned int) getpid());
+			ZitatList = ZitatespuckerSourceGetZitatSingleFromFile(filename, source, (size_t) rand() % amount);
+		}
+	} else if (strcmp(command, "group") == 0 && nargs == 1) {
+		static const char *groupNames[] = {"author", "year", "decade", "century", "era"};
+		static const ZitatespuckerGroup groups[] = {ZITATESPUCKER_GROUP_AUTHOR, ZITATESPUCKER_GROUP_YEAR, ZITATESPUCKER_GROUP_DECADE, ZITATESPUCKER_GROUP_CENTURY, ZITATESPUCKER_GROUP_ERA};
+		size_t g = 0;
+		while (g < sizeof(groups) / sizeof(groups[0]) && strcmp(args[0], groupNames[g]) != 0)
+			g++;
+		if (g == sizeof(groups) / sizeof(groups[0])) {
+			CliUsage();
+			return EXIT_FAILURE;
+		}
+		if ((counts = ZitatespuckerSourceCountFromFile(filename, source, groups[g], NULL)) == NULL) {
+			CliReportFailure(verbose);
+			return EXIT_FAILURE;
+		}
+		records = counts->total;
+		summary = true;
+	#ifdef ZITATESPUCKER_SQL
+	} else if (strcmp(command, "import") == 0 && nargs == 1) {
+		ZitatespuckerSQLImportStats importStats = {0};
+		bool ok = ZitatespuckerSourceImportToSQL(filename, source, args[0], &importStats);
+		(void) printf("%zu rows imported (%zu failed) in %.3f s, %.0f rows/s\n", importStats.rows, importStats.failed, importStats.seconds, importStats.rowsPerSecond);
+		if (!ok) {
+			CliReportFailure(verbose);
+			return EXIT_FAILURE;
+		}
+		records = importStats.rows;
+		summary = true;
+	#endif
+	#ifdef ZITATESPUCKER_JSON
+	} else if (strcmp(command, "index") == 0 && nargs == 0 && source == ZITATESPUCKER_SOURCE_JSON) {
+		if (!ZitatespuckerJSONIndexBuild(filename)) {
+			CliReportFailure(verbose);
+			return EXIT_FAILURE;
+		}
+		records = ZitatespuckerJSONGetAmountFromFile(filename);
+		(void) printf("%zu elements indexed in %s%s\n", records, filename, ZITATESPUCKER_JSON_INDEX_SUFFIX);
+		summary = true;
+	#endif
+	} else {
+		CliUsage();
+		return EXIT_FAILURE;
+	}
+	phase[CLI_PHASE_LOAD] = CliNow() - start;
+
+	start = CliNow();
+	if (summary) {
+		if (command[0] == 'c')
+			(void) printf("%zu\n", records);
+		else if (counts != NULL)
+			CliPrintCounts(stdout, counts);
+	} else {
+		records = ZitatespuckerZitatListLen(ZitatList);
+		if (exporting) {
+			ZitatespuckerExport *exporter = ZitatespuckerExportToFile(stdout);
+			bool ok = (exporter != NULL && ZitatespuckerExportAddList(exporter, ZitatList));
+			if (exporter != NULL)
+				ok = ZitatespuckerExportFinish(exporter, NULL, NULL) && ok;
+			if (!ok) {
+				(void) fprintf(stderr, "zitatespucker: writing the export failed\n");
+				ZitatespuckerZitatFree(ZitatList);
+				return EXIT_FAILURE;
+			}
+		} else {
+			for (ZitatespuckerZitat *cur = ZitatList; cur != NULL; cur = cur->nextZitat) {
+				CliPrintZitat(stdout, cur);
+				if (cur->nextZitat != NULL)
+					(void) fputc('\n', stdout);
+			}
+		}
+	}
+	(void) fflush(stdout);
+	phase[CLI_PHASE_OUTPUT] = CliNow() - start;
+
+	ZitatespuckerZitatFree(ZitatList);
+	ZitatespuckerCountsFree(counts);
+
+	if (stats) {
+		struct rusage usage;
+		(void) getrusage(RUSAGE_SELF, &usage);
+		uint64_t total = 0;
+		for (int i = 0; i < CLI_PHASE_MAX; i++) {
+			(void) fprintf(stderr, "%-8s %10.3f ms\n", CliPhaseNames[i], (double) phase[i] / 1e6);
+			total += phase[i];
+		}
+		(void) fprintf(stderr, "%-8s %10.3f ms\n", "total", (double) total / 1e6);
+		(void) fprintf(stderr, "records  %10zu\n", records);
+		// ru_maxrss is in kilobytes on Linux and the BSDs, but in bytes on macOS
+		#ifdef __APPLE__
+		(void) fprintf(stderr, "peak rss %10ld KiB\n", (long) usage.ru_maxrss / 1024);
+		#else
+		(void) fprintf(stderr, "peak rss %10ld KiB\n", (long) usage.ru_maxrss);
+		#endif
+		ZitatespuckerWarnings warnings;
+		ZitatespuckerDiagGetWarnings(&warnings);
+		(void) ZitatespuckerDiagPrintWarnings(&warnings, stderr);
+	}
+
+	if (!summary && records == 0) {
+		CliReportFailure(verbose);
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
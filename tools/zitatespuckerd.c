@@ -0,0 +1,669 @@
+/*
+	SPDX-License-Identifier: LGPL-3.0-only
+
+	Zitatespucker: Library to spit out quotes (and relating information)
+	zitatespuckerd: serve quotes from memory over a Unix domain socket (Linux, epoll)
+
+	Copyright (C) 2024  Sembo Sadur <labmailssadur@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Lesser General Public License version 3,
+	as published by the Free Software Foundation.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/* sockets, getopt, sigaction, lstat */
+#define _POSIX_C_SOURCE 200809L
+
+
+/* Standard headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+
+
+/* Zitatespucker */
+#include "Zitatespucker/Zitatespucker.h"
+#include "Zitatespucker/Zitatespucker_client.h"
+
+
+#define ZITATESPUCKERD_MAXEVENTS	64
+#define ZITATESPUCKERD_READCHUNK	65536
+#define ZITATESPUCKERD_MAXREQUEST	(4 + (size_t) ZITATESPUCKER_PROTOCOL_MAXFRAME) /* length header plus the largest frame */
+#define ZITATESPUCKERD_HIGHWATER	(1024 * 1024) /* unsent output at which a connection is no longer read from */
+
+
+/* The preloaded quotes plus what is needed to answer queries without scanning */
+typedef struct ZitatespuckerdStore {
+	ZitatespuckerSnapshot *snapshot;
+	size_t len;
+	size_t *byDate; /* indices, ordered by ZitatespuckerdDateKey() */
+	size_t *authorHeads; /* hash bucket -> first index, SIZE_MAX if empty */
+	size_t *authorNext; /* index -> next index with an author in the same bucket */
+	size_t authorMask;
+	uint64_t rng;
+} ZitatespuckerdStore;
+
+typedef struct ZitatespuckerdBuffer {
+	uint8_t *data;
+	size_t len;
+	size_t size;
+} ZitatespuckerdBuffer;
+
+typedef struct ZitatespuckerdConn {
+	int fd;
+	uint32_t events; /* what epoll currently watches for */
+	ZitatespuckerdBuffer in;
+	ZitatespuckerdBuffer out;
+	size_t outSent;
+} ZitatespuckerdConn;
+
+
+static volatile sig_atomic_t ZitatespuckerdStop = 0;
+static ZitatespuckerdStore store;
+
+
+/* Store */
+
+static inline uint64_t ZitatespuckerdDateKey(bool annodomini, uint16_t year, uint8_t month, uint8_t day)
+{
+	return ((uint64_t) annodomini << 32) | ((uint64_t) year << 16) | ((uint64_t) month << 8) | day;
+}
+
+static inline uint64_t ZitatespuckerdZitatDateKey(const ZitatespuckerZitat *Zitat)
+{
+	return ZitatespuckerdDateKey(Zitat->annodomini, Zitat->year, Zitat->month, Zitat->day);
+}
+
+static inline size_t ZitatespuckerdHash(const char *s)
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ULL;
+	for ( ; *s != '\0'; s++)
+		hash = (hash ^ (unsigned char) *s) * 1099511628211ULL;
+	return (size_t) hash;
+}
+
+static int ZitatespuckerdCompareDate(const void *a, const void *b)
+{
+	size_t ia = *(const size_t *) a;
+	size_t ib = *(const size_t *) b;
+	uint64_t ka = ZitatespuckerdZitatDateKey(ZitatespuckerSnapshotGet(store.snapshot, ia));
+	uint64_t kb = ZitatespuckerdZitatDateKey(ZitatespuckerSnapshotGet(store.snapshot, ib));
+
+	if (ka != kb)
+		return (ka < kb ? -1 : 1);
+	return (ia < ib ? -1 : (ia > ib));
+}
+
+static bool ZitatespuckerdStoreLoad(char **filenames, int amount)
+{
+	ZitatespuckerZitat *all = NULL;
+	ZitatespuckerZitat *tail = NULL;
+
+	for (int i = 0; i < amount; i++) {
+		ZitatespuckerDiagClear();
+		ZitatespuckerZitat *ZitatList = ZitatespuckerSourceGetZitatAllFromFile(filenames[i], ZITATESPUCKER_SOURCE_UNKNOWN);
+		if (ZitatList == NULL) {
+			if (ZitatespuckerDiagGetLastError() != ZITATESPUCKER_ERROR_NONE)
+				(void) fprintf(stderr, "zitatespuckerd: could not load \"%s\": %s\n", filenames[i], ZitatespuckerDiagGetLastMessage());
+			else
+				(void) fprintf(stderr, "zitatespuckerd: could not load \"%s\"\n", filenames[i]);
+			ZitatespuckerZitatFree(all);
+			return false;
+		}
+		if (tail != NULL) {
+			tail->nextZitat = ZitatList;
+			ZitatList->prevZitat = tail;
+		} else
+			all = ZitatList;
+		for (tail = ZitatList; tail->nextZitat != NULL; tail = tail->nextZitat)
+			;
+	}
+
+	store.snapshot = ZitatespuckerSnapshotFromList(all);
+	ZitatespuckerZitatFree(all);
+	if (store.snapshot == NULL)
+		return false;
+	store.len = ZitatespuckerSnapshotLen(store.snapshot);
+
+	// date index
+	if ((store.byDate = (size_t *) malloc(store.len * sizeof(size_t))) == NULL)
+		return false;
+	for (size_t i = 0; i < store.len; i++)
+		store.byDate[i] = i;
+	qsort(store.byDate, store.len, sizeof(size_t), ZitatespuckerdCompareDate);
+
+	// author index; chains are built back to front so they come out in index order
+	size_t buckets = 16;
+	while (buckets < store.len)
+		buckets <<= 1;
+	store.authorMask = buckets - 1;
+	if ((store.authorHeads = (size_t *) malloc(buckets * sizeof(size_t))) == NULL
+	|| (store.authorNext = (size_t *) malloc((store.len + 1) * sizeof(size_t))) == NULL)
+		return false;
+	for (size_t i = 0; i < buckets; i++)
+		store.authorHeads[i] = SIZE_MAX;
+	for (size_t i = store.len; i-- > 0; ) {
+		const char *author = ZitatespuckerSnapshotGet(store.snapshot, i)->author;
+		if (author == NULL)
+			continue;
+		size_t bucket = ZitatespuckerdHash(author) & store.authorMask;
+		store.authorNext[i] = store.authorHeads[bucket];
+		store.authorHeads[bucket] = i;
+	}
+
+	store.rng = (uint64_t) time(NULL) ^ ((uint64_t) getpid() << 32) ^ 0x9E3779B97F4A7C15ULL;
+
+	return true;
+}
+
+static inline size_t ZitatespuckerdRandom(size_t bound)
+{
+	// xorshift64*
+	store.rng ^= store.rng >> 12;
+	store.rng ^= store.rng << 25;
+	store.rng ^= store.rng >> 27;
+	return (size_t) ((store.rng * 2685821657736338717ULL) % bound);
+}
+
+
+/* Buffers and encoding */
+
+static bool ZitatespuckerdReserve(ZitatespuckerdBuffer *buf, size_t extra)
+{
+	if (buf->len + extra <= buf->size)
+		return true;
+
+	size_t size = (buf->size != 0 ? buf->size : 4096);
+	while (size < buf->len + extra)
+		size *= 2;
+
+	uint8_t *tmp;
+	if ((tmp = (uint8_t *) realloc(buf->data, size)) == NULL)
+		return false;
+	buf->data = tmp;
+	buf->size = size;
+
+	return true;
+}
+
+static inline void ZitatespuckerdPutU32(uint8_t *dst, uint32_t val)
+{
+	dst[0] = (uint8_t) val;
+	dst[1] = (uint8_t) (val >> 8);
+	dst[2] = (uint8_t) (val >> 16);
+	dst[3] = (uint8_t) (val >> 24);
+}
+
+static inline uint32_t ZitatespuckerdGetU32(const uint8_t *src)
+{
+	return (uint32_t) src[0] | ((uint32_t) src[1] << 8) | ((uint32_t) src[2] << 16) | ((uint32_t) src[3] << 24);
+}
+
+static inline void ZitatespuckerdPutString(ZitatespuckerdBuffer *buf, const char *s, size_t len)
+{
+	ZitatespuckerdPutU32(buf->data + buf->len, (uint32_t) len);
+	if (len != 0)
+		(void) memcpy(buf->data + buf->len + 4, s, len);
+	buf->len += 4 + len;
+}
+
+/*
+	Append the record of Zitat to the response frame starting at frame.
+	Returns ZITATESPUCKER_STATUS_BADREQUEST if the frame would grow past ZITATESPUCKER_PROTOCOL_MAXFRAME
+	and ZITATESPUCKER_STATUS_SERVERERROR if buf could not be grown; nothing is appended then.
+*/
+static uint8_t ZitatespuckerdPutZitat(ZitatespuckerdBuffer *buf, size_t frame, const ZitatespuckerZitat *Zitat)
+{
+	size_t authorlen = (Zitat->author != NULL ? strlen(Zitat->author) : 0);
+	size_t zitatlen = (Zitat->zitat != NULL ? strlen(Zitat->zitat) : 0);
+	size_t commentlen = (Zitat->comment != NULL ? strlen(Zitat->comment) : 0);
+	size_t recordlen = 5 + 12 + authorlen + zitatlen + commentlen;
+	if (recordlen > ZITATESPUCKER_PROTOCOL_MAXFRAME - (buf->len - frame - 4))
+		return ZITATESPUCKER_STATUS_BADREQUEST;
+	if (!ZitatespuckerdReserve(buf, recordlen))
+		return ZITATESPUCKER_STATUS_SERVERERROR;
+
+	uint8_t *dst = buf->data + buf->len;
+	dst[0] = Zitat->day;
+	dst[1] = Zitat->month;
+	dst[2] = (uint8_t) Zitat->year;
+	dst[3] = (uint8_t) (Zitat->year >> 8);
+	dst[4] = (Zitat->annodomini ? 1 : 0);
+	buf->len += 5;
+	ZitatespuckerdPutString(buf, Zitat->author, authorlen);
+	ZitatespuckerdPutString(buf, Zitat->zitat, zitatlen);
+	ZitatespuckerdPutString(buf, Zitat->comment, commentlen);
+
+	return ZITATESPUCKER_STATUS_OK;
+}
+
+static inline bool ZitatespuckerdContains(const char *haystack, const char *needle)
+{
+	return (haystack != NULL && strstr(haystack, needle) != NULL);
+}
+
+/*
+	Answer the request payload req (reqlen bytes) by appending a full response frame to out.
+	A response that would not fit into ZITATESPUCKER_PROTOCOL_MAXFRAME is cut short as soon as it is known,
+	and answered with ZITATESPUCKER_STATUS_BADREQUEST.
+	Returns false if out could not be grown even for that.
+*/
+static bool ZitatespuckerdAnswer(const uint8_t *req, size_t reqlen, ZitatespuckerdBuffer *out)
+{
+	if (!ZitatespuckerdReserve(out, 9))
+		return false;
+	size_t frame = out->len;
+	out->len += 9;
+
+	uint8_t status = ZITATESPUCKER_STATUS_OK;
+	uint32_t amount = 0;
+
+	switch (reqlen >= 1 ? req[0] : 0) {
+		case ZITATESPUCKER_OP_COUNT:
+			amount = (uint32_t) store.len;
+			break;
+		case ZITATESPUCKER_OP_RANDOM:
+			if (store.len != 0) {
+				status = ZitatespuckerdPutZitat(out, frame, ZitatespuckerSnapshotGet(store.snapshot, ZitatespuckerdRandom(store.len)));
+				amount = 1;
+			}
+			break;
+		case ZITATESPUCKER_OP_RANGE: {
+			if (reqlen != 9) {
+				status = ZITATESPUCKER_STATUS_BADREQUEST;
+				break;
+			}
+			size_t start = ZitatespuckerdGetU32(req + 1);
+			size_t want = ZitatespuckerdGetU32(req + 5);
+			for (size_t i = start; i < store.len && amount < want && status == ZITATESPUCKER_STATUS_OK; i++, amount++)
+				status = ZitatespuckerdPutZitat(out, frame, ZitatespuckerSnapshotGet(store.snapshot, i));
+			break;
+		}
+		case ZITATESPUCKER_OP_BYAUTHOR:
+		case ZITATESPUCKER_OP_SEARCH: {
+			if (reqlen < 9 || ZitatespuckerdGetU32(req + 5) != reqlen - 9) {
+				status = ZITATESPUCKER_STATUS_BADREQUEST;
+				break;
+			}
+			uint32_t want = ZitatespuckerdGetU32(req + 1);
+			char *text;
+			if ((text = (char *) malloc(reqlen - 9 + 1)) == NULL) {
+				status = ZITATESPUCKER_STATUS_SERVERERROR;
+				break;
+			}
+			(void) memcpy(text, req + 9, reqlen - 9);
+			text[reqlen - 9] = '\0';
+
+			if (req[0] == ZITATESPUCKER_OP_BYAUTHOR) {
+				for (size_t i = store.authorHeads[ZitatespuckerdHash(text) & store.authorMask]; i != SIZE_MAX && amount < want && status == ZITATESPUCKER_STATUS_OK; i = store.authorNext[i]) {
+					const ZitatespuckerZitat *Zitat = ZitatespuckerSnapshotGet(store.snapshot, i);
+					if (strcmp(Zitat->author, text) != 0)
+						continue;
+					status = ZitatespuckerdPutZitat(out, frame, Zitat);
+					amount++;
+				}
+			} else {
+				for (size_t i = 0; i < store.len && amount < want && status == ZITATESPUCKER_STATUS_OK; i++) {
+					const ZitatespuckerZitat *Zitat = ZitatespuckerSnapshotGet(store.snapshot, i);
+					if (!ZitatespuckerdContains(Zitat->author, text) && !ZitatespuckerdContains(Zitat->zitat, text) && !ZitatespuckerdContains(Zitat->comment, text))
+						continue;
+					status = ZitatespuckerdPutZitat(out, frame, Zitat);
+					amount++;
+				}
+			}
+			free((void *) text);
+			break;
+		}
+		case ZITATESPUCKER_OP_BYDATE: {
+			if (reqlen != 10 || (req[5] == 0 && req[6] == 0 && req[7] == 0) || (req[9] != 0 && req[8] == 0)) {
+				status = ZITATESPUCKER_STATUS_BADREQUEST;
+				break;
+			}
+			uint32_t want = ZitatespuckerdGetU32(req + 1);
+			bool annodomini = (req[5] != 0);
+			uint16_t year = (uint16_t) (req[6] | (req[7] << 8));
+			uint64_t lo = ZitatespuckerdDateKey(annodomini, year, req[8], req[9]);
+			uint64_t hi = ZitatespuckerdDateKey(annodomini, year, (req[8] != 0 ? req[8] : UINT8_MAX), (req[9] != 0 ? req[9] : UINT8_MAX));
+
+			// lower bound
+			size_t left = 0, right = store.len;
+			while (left < right) {
+				size_t mid = left + (right - left) / 2;
+				if (ZitatespuckerdZitatDateKey(ZitatespuckerSnapshotGet(store.snapshot, store.byDate[mid])) < lo)
+					left = mid + 1;
+				else
+					right = mid;
+			}
+			for ( ; left < store.len && amount < want && status == ZITATESPUCKER_STATUS_OK; left++, amount++) {
+				const ZitatespuckerZitat *Zitat = ZitatespuckerSnapshotGet(store.snapshot, store.byDate[left]);
+				if (ZitatespuckerdZitatDateKey(Zitat) > hi)
+					break;
+				status = ZitatespuckerdPutZitat(out, frame, Zitat);
+			}
+			break;
+		}
+		default:
+			status = ZITATESPUCKER_STATUS_BADREQUEST;
+			break;
+	}
+
+	if (status != ZITATESPUCKER_STATUS_OK) {
+		// drop whatever was written and answer with just the status
+		out->len = frame + 9;
+		amount = 0;
+	}
+	ZitatespuckerdPutU32(out->data + frame, (uint32_t) (out->len - frame - 4));
+	out->data[frame + 4] = status;
+	ZitatespuckerdPutU32(out->data + frame + 5, amount);
+
+	return true;
+}
+
+
+/* Connections */
+
+static void ZitatespuckerdConnClose(int epfd, ZitatespuckerdConn *conn)
+{
+	(void) epoll_ctl(epfd, EPOLL_CTL_DEL, conn->fd, NULL);
+	(void) close(conn->fd);
+	free((void *) conn->in.data);
+	free((void *) conn->out.data);
+	free((void *) conn);
+}
+
+static inline size_t ZitatespuckerdConnPending(const ZitatespuckerdConn *conn)
+{
+	return conn->out.len - conn->outSent;
+}
+
+/*
+	Write out as much of conn->out as the socket takes, and watch for whatever the connection waits for now:
+	for room to write while output is pending, for requests only while that stays below ZITATESPUCKERD_HIGHWATER.
+	Returns false if the connection broke.
+*/
+static bool ZitatespuckerdConnFlush(int epfd, ZitatespuckerdConn *conn)
+{
+	while (conn->outSent < conn->out.len) {
+		ssize_t ret = send(conn->fd, conn->out.data + conn->outSent, conn->out.len - conn->outSent, MSG_NOSIGNAL);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		else if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		else if (ret <= 0)
+			return false;
+		conn->outSent += (size_t) ret;
+	}
+
+	if (conn->outSent == conn->out.len) {
+		conn->out.len = 0;
+		conn->outSent = 0;
+	}
+
+	size_t pending = ZitatespuckerdConnPending(conn);
+	uint32_t events = (pending < ZITATESPUCKERD_HIGHWATER ? EPOLLIN : 0) | (pending != 0 ? EPOLLOUT : 0);
+	if (events != conn->events) {
+		struct epoll_event ev;
+		ev.events = events;
+		ev.data.ptr = conn;
+		if (epoll_ctl(epfd, EPOLL_CTL_MOD, conn->fd, &ev) != 0)
+			return false;
+		conn->events = events;
+	}
+
+	return true;
+}
+
+/*
+	Answer the complete requests in conn->in until the output pending reaches ZITATESPUCKERD_HIGHWATER.
+	Returns false if the connection is done.
+*/
+static bool ZitatespuckerdConnAnswer(ZitatespuckerdConn *conn)
+{
+	// what has been sent already makes room for the answers
+	if (conn->outSent != 0) {
+		(void) memmove(conn->out.data, conn->out.data + conn->outSent, conn->out.len - conn->outSent);
+		conn->out.len -= conn->outSent;
+		conn->outSent = 0;
+	}
+
+	size_t pos = 0;
+	while (conn->in.len - pos >= 4 && ZitatespuckerdConnPending(conn) < ZITATESPUCKERD_HIGHWATER) {
+		uint32_t reqlen = ZitatespuckerdGetU32(conn->in.data + pos);
+		if (reqlen == 0 || reqlen > ZITATESPUCKER_PROTOCOL_MAXFRAME)
+			return false;
+		if (conn->in.len - pos - 4 < reqlen)
+			break;
+		if (!ZitatespuckerdAnswer(conn->in.data + pos + 4, reqlen, &conn->out))
+			return false;
+		pos += 4 + reqlen;
+	}
+	if (pos != 0) {
+		(void) memmove(conn->in.data, conn->in.data + pos, conn->in.len - pos);
+		conn->in.len -= pos;
+	}
+
+	return true;
+}
+
+/*
+	Read what is available and answer every complete request, for as long as the peer keeps up with the answers.
+	conn->in never holds more than one incomplete request, so it stays within ZITATESPUCKERD_MAXREQUEST.
+	Returns false if the connection is done.
+*/
+static bool ZitatespuckerdConnRead(int epfd, ZitatespuckerdConn *conn)
+{
+	for (;;) {
+		if (!ZitatespuckerdConnAnswer(conn))
+			return false;
+		if (ZitatespuckerdConnPending(conn) >= ZITATESPUCKERD_HIGHWATER) {
+			// the peer may take it all at once, and then no event would bring up the requests still held
+			if (!ZitatespuckerdConnFlush(epfd, conn))
+				return false;
+			if (ZitatespuckerdConnPending(conn) >= ZITATESPUCKERD_HIGHWATER)
+				return true;
+			continue;
+		}
+
+		size_t room = ZITATESPUCKERD_MAXREQUEST - conn->in.len;
+		if (room > ZITATESPUCKERD_READCHUNK)
+			room = ZITATESPUCKERD_READCHUNK;
+		if (!ZitatespuckerdReserve(&conn->in, room))
+			return false;
+		ssize_t ret = recv(conn->fd, conn->in.data + conn->in.len, room, 0);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		else if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		else if (ret <= 0)
+			return false;
+		conn->in.len += (size_t) ret;
+	}
+
+	return ZitatespuckerdConnFlush(epfd, conn);
+}
+
+static bool ZitatespuckerdSetNonblocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL, 0);
+	return (flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0);
+}
+
+static void ZitatespuckerdAccept(int epfd, int listenfd)
+{
+	for (;;) {
+		int fd = accept(listenfd, NULL, NULL);
+		if (fd < 0) {
+			if (errno == EINTR)
+				continue;
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				perror("zitatespuckerd: accept");
+			return;
+		}
+
+		ZitatespuckerdConn *conn;
+		if (!ZitatespuckerdSetNonblocking(fd) || (conn = (ZitatespuckerdConn *) calloc(1, sizeof(ZitatespuckerdConn))) == NULL) {
+			(void) close(fd);
+			continue;
+		}
+		conn->fd = fd;
+		conn->events = EPOLLIN;
+
+		struct epoll_event ev;
+		ev.events = conn->events;
+		ev.data.ptr = conn;
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+			(void) close(fd);
+			free((void *) conn);
+		}
+	}
+}
+
+
+/* Main */
+
+static void ZitatespuckerdOnSignal(int sig)
+{
+	(void) sig;
+	ZitatespuckerdStop = 1;
+}
+
+static void ZitatespuckerdUsage(void)
+{
+	(void) fprintf(stderr,
+		"Usage: zitatespuckerd [-s socketpath] file...\n"
+		"Preload every file (any supported source) and answer queries on socketpath\n"
+		"(default: " ZITATESPUCKER_DEFAULT_SOCKET ") until SIGINT or SIGTERM.\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *socketpath = ZITATESPUCKER_DEFAULT_SOCKET;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "s:h")) != -1) {
+		switch (opt) {
+			case 's':
+				socketpath = optarg;
+				break;
+			default:
+				ZitatespuckerdUsage();
+				return (opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE);
+		}
+	}
+	if (optind >= argc) {
+		ZitatespuckerdUsage();
+		return EXIT_FAILURE;
+	}
+
+	if (!ZitatespuckerdStoreLoad(argv + optind, argc - optind)) {
+		(void) fprintf(stderr, "zitatespuckerd: loading failed\n");
+		return EXIT_FAILURE;
+	}
+
+	struct sockaddr_un addr;
+	if (strlen(socketpath) >= sizeof(addr.sun_path)) {
+		(void) fprintf(stderr, "zitatespuckerd: socket path too long\n");
+		return EXIT_FAILURE;
+	}
+	(void) memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	(void) strcpy(addr.sun_path, socketpath);
+
+	// a stale socket from an earlier run may be replaced, anything else at that path is not ours to remove
+	struct stat st;
+	if (lstat(socketpath, &st) == 0) {
+		if (!S_ISSOCK(st.st_mode)) {
+			(void) fprintf(stderr, "zitatespuckerd: %s exists and is not a socket\n", socketpath);
+			return EXIT_FAILURE;
+		}
+		(void) unlink(socketpath);
+	}
+
+	int listenfd = socket(AF_UNIX, SOCK_STREAM, 0);
+	struct stat bound;
+	if (listenfd < 0 || bind(listenfd, (struct sockaddr *) &addr, sizeof(addr)) != 0 || lstat(socketpath, &bound) != 0
+	|| listen(listenfd, SOMAXCONN) != 0 || !ZitatespuckerdSetNonblocking(listenfd)) {
+		perror("zitatespuckerd: listening socket");
+		return EXIT_FAILURE;
+	}
+
+	int epfd = epoll_create1(0);
+	struct epoll_event ev;
+	ev.events = EPOLLIN;
+	ev.data.ptr = NULL; // NULL marks the listening socket
+	if (epfd < 0 || epoll_ctl(epfd, EPOLL_CTL_ADD, listenfd, &ev) != 0) {
+		perror("zitatespuckerd: epoll");
+		return EXIT_FAILURE;
+	}
+
+	struct sigaction sa;
+	(void) memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = ZitatespuckerdOnSignal;
+	(void) sigaction(SIGINT, &sa, NULL);
+	(void) sigaction(SIGTERM, &sa, NULL);
+	sa.sa_handler = SIG_IGN;
+	(void) sigaction(SIGPIPE, &sa, NULL);
+
+	(void) fprintf(stderr, "zitatespuckerd: %zu quotes from %d file(s), listening on %s\n", store.len, argc - optind, socketpath);
+
+	struct epoll_event events[ZITATESPUCKERD_MAXEVENTS];
+	while (!ZitatespuckerdStop) {
+		int n = epoll_wait(epfd, events, ZITATESPUCKERD_MAXEVENTS, -1);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			perror("zitatespuckerd: epoll_wait");
+			break;
+		}
+
+		for (int i = 0; i < n; i++) {
+			ZitatespuckerdConn *conn = (ZitatespuckerdConn *) events[i].data.ptr;
+			if (conn == NULL) {
+				ZitatespuckerdAccept(epfd, listenfd);
+				continue;
+			}
+
+			bool alive = !(events[i].events & (EPOLLERR | EPOLLHUP)) || (events[i].events & EPOLLIN);
+			if (alive && (events[i].events & EPOLLIN))
+				alive = ZitatespuckerdConnRead(epfd, conn);
+			if (alive && (events[i].events & EPOLLOUT)) {
+				alive = ZitatespuckerdConnFlush(epfd, conn);
+				// requests held back while the peer was not reading its answers
+				if (alive && conn->in.len != 0 && ZitatespuckerdConnPending(conn) < ZITATESPUCKERD_HIGHWATER)
+					alive = ZitatespuckerdConnRead(epfd, conn);
+			}
+			if (!alive)
+				ZitatespuckerdConnClose(epfd, conn);
+		}
+	}
+
+	(void) close(listenfd);
+	// only if nobody has put something else there in the meantime
+	if (lstat(socketpath, &st) == 0 && S_ISSOCK(st.st_mode) && st.st_dev == bound.st_dev && st.st_ino == bound.st_ino)
+		(void) unlink(socketpath);
+	ZitatespuckerSnapshotRelease(store.snapshot);
+	free((void *) store.byDate);
+	free((void *) store.authorHeads);
+	free((void *) store.authorNext);
+
+	return EXIT_SUCCESS;
+}